@@ -4,6 +4,11 @@ try:
 except ImportError:
     __version__ = "0.0.0"
 
+# Builds with FLOWCYPY_UNIFIED_MODULE hold every compiled component in FlowCyPy._flowcypy_core.
+from ._core_loader import install as _install_core_loader
+
+_install_core_loader()
+
 import FlowCyPy.units as _
 import FlowCyPy.opto_electronics.circuits as _
 import FlowCyPy.digital_processing.classifier as _
@@ -11,6 +16,7 @@ from .flow_cytometer import FlowCytometer
 from .fluidics import Fluidics
 from .opto_electronics import OptoElectronics
 from .digital_processing import DigitalProcessing
+from .utils import set_random_seed, set_threads  # noqa: F401
 
 
 debug_mode = False
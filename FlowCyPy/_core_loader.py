@@ -0,0 +1,77 @@
+"""
+Import hook of the unified ``_flowcypy_core`` extension.
+
+Built with ``FLOWCYPY_UNIFIED_MODULE``, FlowCyPy ships a single extension,
+``FlowCyPy._flowcypy_core``, instead of one extension per component. The finder
+installed here serves the usual import paths, e.g.
+``FlowCyPy.opto_electronics.source``, from that extension: each submodule is
+created with its bindings on first import, so importing FlowCyPy opens one
+shared object and registers only the components in use.
+"""
+
+import importlib.abc
+import importlib.machinery
+import sys
+
+
+class _CoreFinder(importlib.abc.MetaPathFinder, importlib.abc.Loader):
+    """Finder and loader of the submodules of ``_flowcypy_core``."""
+
+    def __init__(self, core) -> None:
+        self.core = core
+        self.names = frozenset(core.get_module_names())
+
+    def find_spec(self, fullname, path=None, target=None):
+        if fullname not in self.names:
+            return None
+
+        return importlib.machinery.ModuleSpec(fullname, self, origin=getattr(self.core, "__file__", None))
+
+    def create_module(self, spec):
+        return self.core.create_module(spec.name)
+
+    def exec_module(self, module) -> None:
+        # The bindings are registered by create_module.
+        pass
+
+
+def install(core=None) -> bool:
+    """
+    Serve the compiled components from ``_flowcypy_core`` when FlowCyPy was built unified.
+
+    The finder goes first on ``sys.meta_path``, so a unified extension wins
+    over stale per component extensions left in the package.
+
+    Parameters
+    ----------
+    core : module, optional
+        Unified extension, imported from ``FlowCyPy._flowcypy_core`` when omitted.
+
+    Returns
+    -------
+    bool
+        Whether the components are served by a unified extension.
+    """
+    if is_unified():
+        return True
+
+    if core is None:
+        try:
+            from FlowCyPy import _flowcypy_core as core
+
+        except ImportError:
+            return False
+
+    sys.meta_path.insert(0, _CoreFinder(core))
+
+    return True
+
+
+def uninstall() -> None:
+    """Remove the finder; submodules imported so far stay in ``sys.modules``."""
+    sys.meta_path[:] = [finder for finder in sys.meta_path if not isinstance(finder, _CoreFinder)]
+
+
+def is_unified() -> bool:
+    """Whether the compiled components come from the unified ``_flowcypy_core`` extension."""
+    return any(isinstance(finder, _CoreFinder) for finder in sys.meta_path)
@@ -0,0 +1,136 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+
+
+// Registration functions of the components, defined by their FLOWCYPY_MODULE bodies.
+void flowcypy_register_interface_pint(py::module_& module);
+void flowcypy_register_interface_utils(py::module_& module);
+void flowcypy_register_acquisition_buffer(py::module_& module);
+void flowcypy_register_distributions(py::module_& module);
+void flowcypy_register_populations(py::module_& module);
+void flowcypy_register_flow_cell(py::module_& module);
+void flowcypy_register_source(py::module_& module);
+void flowcypy_register_detector(py::module_& module);
+void flowcypy_register_amplifier(py::module_& module);
+void flowcypy_register_digitizer(py::module_& module);
+void flowcypy_register_circuits(py::module_& module);
+void flowcypy_register_opto_electronic_chain(py::module_& module);
+void flowcypy_register_coupling_cache(py::module_& module);
+void flowcypy_register_discriminator(py::module_& module);
+void flowcypy_register_peak_locator(py::module_& module);
+void flowcypy_register_classifier(py::module_& module);
+void flowcypy_register_acquisition_pipeline(py::module_& module);
+
+
+namespace {
+
+struct Component {
+    const char* name;   // import path of the standalone extension the submodule stands for
+    void (*register_bindings)(py::module_&);
+};
+
+const Component components[] = {
+    {"FlowCyPy.interface_pint", &flowcypy_register_interface_pint},
+    {"FlowCyPy.binary.utils", &flowcypy_register_interface_utils},
+    {"FlowCyPy.binary.acquisition_buffer", &flowcypy_register_acquisition_buffer},
+    {"FlowCyPy.fluidics.distributions", &flowcypy_register_distributions},
+    {"FlowCyPy.fluidics.populations", &flowcypy_register_populations},
+    {"FlowCyPy.fluidics.flow_cell", &flowcypy_register_flow_cell},
+    {"FlowCyPy.opto_electronics.source", &flowcypy_register_source},
+    {"FlowCyPy.opto_electronics.detector", &flowcypy_register_detector},
+    {"FlowCyPy.opto_electronics.amplifier", &flowcypy_register_amplifier},
+    {"FlowCyPy.opto_electronics.digitizer", &flowcypy_register_digitizer},
+    {"FlowCyPy.opto_electronics.circuits", &flowcypy_register_circuits},
+    {"FlowCyPy.opto_electronics.opto_electronic_chain", &flowcypy_register_opto_electronic_chain},
+    {"FlowCyPy.opto_electronics.coupling_cache", &flowcypy_register_coupling_cache},
+    {"FlowCyPy.digital_processing.discriminator", &flowcypy_register_discriminator},
+    {"FlowCyPy.digital_processing.peak_locator", &flowcypy_register_peak_locator},
+    {"FlowCyPy.digital_processing.classifier", &flowcypy_register_classifier},
+    {"FlowCyPy.acquisition_pipeline", &flowcypy_register_acquisition_pipeline},
+};
+
+}  // namespace
+
+
+PYBIND11_MODULE(_flowcypy_core, module) {
+    module.doc() = R"pbdoc(
+        Every compiled component of FlowCyPy in a single extension.
+
+        Built with ``FLOWCYPY_UNIFIED_MODULE``, this extension replaces the
+        per component extensions: the kernels are linked once, with link time
+        optimization across components, and share one set of random streams,
+        thread settings and profiling timers. Submodules are created on first
+        import by the finder of ``FlowCyPy._core_loader`` under their usual
+        import paths, e.g. ``FlowCyPy.opto_electronics.source``.
+    )pbdoc";
+
+    module.def(
+        "get_module_names",
+        []() {
+            std::vector<std::string> names;
+
+            for (const Component& component : components) {
+                names.emplace_back(component.name);
+            }
+
+            return names;
+        },
+        R"pbdoc(
+            Import paths of the submodules this extension provides.
+        )pbdoc"
+    );
+
+    module.def(
+        "create_module",
+        [module](const std::string& name) mutable -> py::module_ {
+            for (const Component& component : components) {
+                if (name != component.name) {
+                    continue;
+                }
+
+                const std::string attribute = name.substr(name.rfind('.') + 1);
+
+                // Types register once per process, so a submodule is created only once.
+                if (py::hasattr(module, attribute.c_str())) {
+                    return py::reinterpret_borrow<py::module_>(module.attr(attribute.c_str()));
+                }
+
+                py::module_ submodule = py::reinterpret_borrow<py::module_>(
+                    py::module_::import("types").attr("ModuleType")(name)
+                );
+
+                component.register_bindings(submodule);
+                module.attr(attribute.c_str()) = submodule;
+
+                return submodule;
+            }
+
+            throw py::import_error("_flowcypy_core has no submodule '" + name + "'.");
+        },
+        py::arg("name"),
+        R"pbdoc(
+            Create and fill the submodule standing for a component extension.
+
+            Parameters
+            ----------
+            name : str
+                Import path of the component, one of :func:`get_module_names`.
+
+            Returns
+            -------
+            module
+                The submodule, created with its bindings on the first call and
+                returned as is afterwards.
+
+            Raises
+            ------
+            ImportError
+                If no component has this import path.
+        )pbdoc"
+    );
+}
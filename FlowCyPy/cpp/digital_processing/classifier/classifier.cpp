@@ -1,95 +1,705 @@
 #include "classifier.h"
 
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <utility>
+
+#include <utils/profiler.h>
+#include <utils/threading.h>
+
+
+namespace {
+
+// Rows per chunk of the centroid update. Chunk sums are merged in order, so the
+// centroids do not depend on the number of threads.
+constexpr size_t centroid_update_chunk_size = 4096;
+
+inline double squared_distance(const double *point, const double *centroid, const size_t number_of_features)
+{
+    double distance = 0.0;
+
+    #pragma omp simd reduction(+:distance)
+    for (size_t f = 0; f < number_of_features; f++) {
+        const double difference = point[f] - centroid[f];
+        distance += difference * difference;
+    }
+
+    return distance;
+}
+
+struct NearestCentroids {
+    int label = 0;
+    double best_distance = std::numeric_limits<double>::max();
+    double second_distance = std::numeric_limits<double>::max();
+};
+
+// Squared distances to the nearest and second nearest centroids, ties going to the lowest index.
+inline NearestCentroids find_nearest_centroids(
+    const double *point,
+    const std::vector<double> &centroids,
+    const size_t number_of_cluster,
+    const size_t number_of_features
+) {
+    NearestCentroids nearest;
+
+    for (size_t k = 0; k < number_of_cluster; k++) {
+        const double distance = squared_distance(point, centroids.data() + k * number_of_features, number_of_features);
+
+        if (distance < nearest.best_distance) {
+            nearest.second_distance = nearest.best_distance;
+            nearest.best_distance = distance;
+            nearest.label = static_cast<int>(k);
+        }
+        else if (distance < nearest.second_distance) {
+            nearest.second_distance = distance;
+        }
+    }
+
+    return nearest;
+}
+
+void assign_nearest_centroids(
+    const double *data,
+    const size_t number_of_samples,
+    const size_t number_of_features,
+    const std::vector<double> &centroids,
+    const size_t number_of_cluster,
+    std::vector<int> &labels
+) {
+    #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(number_of_samples * number_of_features * number_of_cluster, utils::ParallelComponent::classifier))
+    for (long long i = 0; i < static_cast<long long>(number_of_samples); i++)
+        labels[i] = find_nearest_centroids(
+            data + static_cast<size_t>(i) * number_of_features,
+            centroids,
+            number_of_cluster,
+            number_of_features
+        ).label;
+}
+
+// Row-major copy of a matrix given as rows.
+std::vector<double> flatten_rows(const std::vector<std::vector<double>> &data_matrix)
+{
+    if (data_matrix.empty())
+        throw std::runtime_error("Input matrix has no samples");
+
+    const size_t number_of_features = data_matrix[0].size();
+
+    std::vector<double> data;
+    data.reserve(data_matrix.size() * number_of_features);
+
+    for (const auto &row : data_matrix) {
+        if (row.size() != number_of_features)
+            throw std::runtime_error("All rows must have the same number of features");
+
+        data.insert(data.end(), row.begin(), row.end());
+    }
+
+    return data;
+}
+
+}  // namespace
+
 
 std::vector<int> KmeansClassifier::run(const std::vector<std::vector<double>> &data_matrix, unsigned int random_state) const
 {
-    const size_t number_of_samples = data_matrix.size();
+    const std::vector<double> data = flatten_rows(data_matrix);
+
+    return this->run(data.data(), data_matrix.size(), data_matrix[0].size(), random_state);
+}
+
+
+std::vector<int> KmeansClassifier::run(
+    const double *data,
+    const size_t number_of_samples,
+    const size_t number_of_features,
+    unsigned int random_state
+) const
+{
+    std::vector<double> fitted_centroids;
+
+    return this->cluster(data, number_of_samples, number_of_features, random_state, fitted_centroids);
+}
+
+
+std::vector<int> KmeansClassifier::fit(
+    const double *data,
+    const size_t number_of_samples,
+    const size_t number_of_features,
+    unsigned int random_state
+)
+{
+    std::vector<int> labels = this->cluster(data, number_of_samples, number_of_features, random_state, this->centroids);
+
+    this->number_of_fitted_features = number_of_features;
+    this->cluster_counts.assign(number_of_cluster, 0);
+
+    for (const int label : labels)
+        this->cluster_counts[static_cast<size_t>(label)]++;
+
+    return labels;
+}
+
+
+void KmeansClassifier::check_fitted(const size_t number_of_features) const
+{
+    if (this->centroids.empty())
+        throw std::runtime_error("fit must be called before assigning events");
+
+    if (number_of_features != this->number_of_fitted_features)
+        throw std::runtime_error("Events must have the number of features the classifier was fitted on");
+}
+
+
+std::vector<int> KmeansClassifier::assign(const double *data, const size_t number_of_samples, const size_t number_of_features) const
+{
+    this->check_fitted(number_of_features);
+
+    std::vector<int> labels(number_of_samples);
+    assign_nearest_centroids(data, number_of_samples, number_of_features, this->centroids, number_of_cluster, labels);
+
+    return labels;
+}
+
+
+std::vector<int> KmeansClassifier::assign_and_update(const double *data, const size_t number_of_samples, const size_t number_of_features)
+{
+    this->check_fitted(number_of_features);
+
+    std::vector<int> labels(number_of_samples);
+
+    for (size_t i = 0; i < number_of_samples; i++) {
+        const double *point = data + i * number_of_features;
+        const int label = find_nearest_centroids(point, this->centroids, number_of_cluster, number_of_features).label;
+        const size_t c = static_cast<size_t>(label);
+
+        labels[i] = label;
+
+        // A row with a non finite feature is labeled but does not move its centroid.
+        if (!std::all_of(point, point + number_of_features, [](const double value) { return std::isfinite(value); }))
+            continue;
+
+        const double step = learning_rate > 0.0
+            ? learning_rate
+            : 1.0 / static_cast<double>(++this->cluster_counts[c]);
+
+        double *centroid = this->centroids.data() + c * number_of_features;
+
+        for (size_t f = 0; f < number_of_features; f++)
+            centroid[f] += step * (point[f] - centroid[f]);
+    }
+
+    return labels;
+}
+
+
+std::vector<int> KmeansClassifier::cluster(
+    const double *data,
+    const size_t number_of_samples,
+    const size_t number_of_features,
+    unsigned int random_state,
+    std::vector<double> &centroids
+) const
+{
+    FLOWCYPY_PROFILE_SCOPE("classifier.kmeans");
+    FLOWCYPY_PROFILE_COUNT("classifier.kmeans", "samples", number_of_samples);
+
     if (number_of_samples == 0)
         throw std::runtime_error("Input matrix has no samples");
 
-
-    const size_t number_of_features = data_matrix[0].size();
     if (number_of_features == 0)
         throw std::runtime_error("Input matrix has no features");
 
+    if (number_of_cluster == 0)
+        throw std::runtime_error("number_of_clusters must be at least one");
+
+    std::mt19937 generator(random_state);
+
+    centroids = this->seed_centroids(data, number_of_samples, number_of_features, generator);
+
+    if (batch_size > 0 && batch_size < number_of_samples)
+        return this->run_mini_batch(data, number_of_samples, number_of_features, centroids, generator);
+
+    return this->run_full_batch(data, number_of_samples, number_of_features, centroids, generator);
+}
+
+
+std::vector<double> KmeansClassifier::seed_centroids(
+    const double *data,
+    const size_t number_of_samples,
+    const size_t number_of_features,
+    std::mt19937 &generator
+) const
+{
+    // k-means++: each new centroid is a point drawn with probability proportional
+    // to its squared distance to the nearest centroid chosen so far.
+    std::vector<double> centroids(number_of_cluster * number_of_features);
+    std::vector<double> nearest_distances(number_of_samples, std::numeric_limits<double>::max());
+
+    std::uniform_int_distribution<size_t> choose(0, number_of_samples - 1);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    size_t chosen_index = choose(generator);
+
+    for (size_t k = 0; k < number_of_cluster; k++) {
+        const double *chosen_point = data + chosen_index * number_of_features;
+        double *centroid = centroids.data() + k * number_of_features;
+
+        std::copy(chosen_point, chosen_point + number_of_features, centroid);
+
+        if (k + 1 == number_of_cluster)
+            break;
+
+        #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(number_of_samples * number_of_features, utils::ParallelComponent::classifier))
+        for (long long i = 0; i < static_cast<long long>(number_of_samples); i++) {
+            const double distance = squared_distance(data + static_cast<size_t>(i) * number_of_features, centroid, number_of_features);
+
+            if (distance < nearest_distances[i])
+                nearest_distances[i] = distance;
+        }
+
+        // The total is summed serially, so the draw does not depend on the number of threads.
+        double total_distance = 0.0;
+        for (const double distance : nearest_distances)
+            if (std::isfinite(distance))
+                total_distance += distance;
+
+        if (!(total_distance > 0.0) || !std::isfinite(total_distance)) {
+            chosen_index = choose(generator);
+            continue;
+        }
+
+        const double target = uniform(generator) * total_distance;
+        double cumulative_distance = 0.0;
+
+        chosen_index = number_of_samples - 1;
+
+        for (size_t i = 0; i < number_of_samples; i++) {
+            if (!std::isfinite(nearest_distances[i]))
+                continue;
+
+            cumulative_distance += nearest_distances[i];
+
+            if (cumulative_distance > target) {
+                chosen_index = i;
+                break;
+            }
+        }
+    }
+
+    return centroids;
+}
+
+
+std::vector<int> KmeansClassifier::run_full_batch(
+    const double *data,
+    const size_t number_of_samples,
+    const size_t number_of_features,
+    std::vector<double> &centroids,
+    std::mt19937 &generator
+) const
+{
+    const size_t number_of_chunks = (number_of_samples + centroid_update_chunk_size - 1) / centroid_update_chunk_size;
 
-    // KMeans model outputs
-    std::vector<std::vector<double>> centroids(number_of_cluster, std::vector<double>(number_of_features));
     std::vector<int> labels(number_of_samples, 0);
 
-    // Initialise centroids by sampling random points
-    std::mt19937 generator(random_state);
+    // Hamerly bounds, as Euclidean distances: upper_bounds[i] bounds the distance to
+    // the assigned centroid from above, lower_bounds[i] that to any other from below.
+    std::vector<double> upper_bounds(number_of_samples);
+    std::vector<double> lower_bounds(number_of_samples);
+
+    std::vector<double> chunk_sums(number_of_chunks * number_of_cluster * number_of_features);
+    std::vector<size_t> chunk_sizes(number_of_chunks * number_of_cluster);
+    std::vector<double> new_centroids(number_of_cluster * number_of_features);
+    std::vector<size_t> cluster_sizes(number_of_cluster);
+    std::vector<double> centroid_shifts(number_of_cluster);
+    std::vector<double> half_separations(number_of_cluster);
+
     std::uniform_int_distribution<size_t> choose(0, number_of_samples - 1);
 
-    for (size_t k = 0; k < number_of_cluster; k++)
-        centroids[k] = data_matrix[choose(generator)];
+    #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(number_of_samples * number_of_features * number_of_cluster, utils::ParallelComponent::classifier))
+    for (long long i = 0; i < static_cast<long long>(number_of_samples); i++) {
+        const NearestCentroids nearest = find_nearest_centroids(
+            data + static_cast<size_t>(i) * number_of_features,
+            centroids,
+            number_of_cluster,
+            number_of_features
+        );
+
+        labels[i] = nearest.label;
+        upper_bounds[i] = std::sqrt(nearest.best_distance);
+        lower_bounds[i] = std::sqrt(nearest.second_distance);
+    }
 
     bool changed = true;
-    size_t max_iterations = 300;
     size_t iteration = 0;
 
     while (changed && iteration < max_iterations) {
-        changed = false;
+        // Recompute centroids
+        std::fill(chunk_sums.begin(), chunk_sums.end(), 0.0);
+        std::fill(chunk_sizes.begin(), chunk_sizes.end(), 0);
 
-        // Update labels
-        for (size_t i = 0; i < number_of_samples; i++) {
-            double best_distance = std::numeric_limits<double>::max();
-            int best_cluster = 0;
-
-            for (size_t k = 0; k < number_of_cluster; k++) {
-                double distance = 0.0;
-                for (size_t f = 0; f < number_of_features; f++) {
-                    double diff = data_matrix[i][f] - centroids[k][f];
-                    distance += diff * diff;
-                }
+        #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(number_of_samples * number_of_features, utils::ParallelComponent::classifier))
+        for (long long chunk = 0; chunk < static_cast<long long>(number_of_chunks); chunk++) {
+            double *sums = chunk_sums.data() + static_cast<size_t>(chunk) * number_of_cluster * number_of_features;
+            size_t *sizes = chunk_sizes.data() + static_cast<size_t>(chunk) * number_of_cluster;
 
-                if (distance < best_distance) {
-                    best_distance = distance;
-                    best_cluster = static_cast<int>(k);
-                }
-            }
+            const size_t begin = static_cast<size_t>(chunk) * centroid_update_chunk_size;
+            const size_t end = std::min(begin + centroid_update_chunk_size, number_of_samples);
 
-            if (labels[i] != best_cluster) {
-                labels[i] = best_cluster;
-                changed = true;
+            for (size_t i = begin; i < end; i++) {
+                const size_t c = static_cast<size_t>(labels[i]);
+                const double *point = data + i * number_of_features;
+                double *sum = sums + c * number_of_features;
+
+                sizes[c] += 1;
+
+                #pragma omp simd
+                for (size_t f = 0; f < number_of_features; f++)
+                    sum[f] += point[f];
             }
         }
 
-        // Recompute centroids
-        std::vector<std::vector<double>> new_centroids(number_of_cluster, std::vector<double>(number_of_features, 0.0));
-        std::vector<size_t> cluster_sizes(number_of_cluster, 0);
+        std::fill(new_centroids.begin(), new_centroids.end(), 0.0);
+        std::fill(cluster_sizes.begin(), cluster_sizes.end(), 0);
 
-        for (size_t i = 0; i < number_of_samples; i++) {
-            int c = labels[i];
-            cluster_sizes[c] += 1;
-            for (size_t f = 0; f < number_of_features; f++) {
-                new_centroids[c][f] += data_matrix[i][f];
+        for (size_t chunk = 0; chunk < number_of_chunks; chunk++) {
+            for (size_t c = 0; c < number_of_cluster; c++) {
+                cluster_sizes[c] += chunk_sizes[chunk * number_of_cluster + c];
+
+                for (size_t f = 0; f < number_of_features; f++)
+                    new_centroids[c * number_of_features + f] +=
+                        chunk_sums[(chunk * number_of_cluster + c) * number_of_features + f];
             }
         }
 
+        double maximum_shift = 0.0;
+
         for (size_t c = 0; c < number_of_cluster; c++) {
-            if (cluster_sizes[c] == 0) // Rechoose centroid if empty cluster
-                new_centroids[c] = data_matrix[choose(generator)];
+            double *new_centroid = new_centroids.data() + c * number_of_features;
 
+            if (cluster_sizes[c] == 0) { // Rechoose centroid if empty cluster
+                const double *point = data + choose(generator) * number_of_features;
+                std::copy(point, point + number_of_features, new_centroid);
+            }
             else
                 for (size_t f = 0; f < number_of_features; f++)
-                    new_centroids[c][f] /= static_cast<double>(cluster_sizes[c]);
-
+                    new_centroid[f] /= static_cast<double>(cluster_sizes[c]);
 
+            centroid_shifts[c] = std::sqrt(squared_distance(centroids.data() + c * number_of_features, new_centroid, number_of_features));
+            maximum_shift = std::max(maximum_shift, centroid_shifts[c]);
         }
 
-        centroids = new_centroids;
+        centroids.swap(new_centroids);
         iteration++;
+
+        // A point is kept without a scan when its assigned centroid is closer than half
+        // the distance to any other centroid, or than the lower bound.
+        for (size_t c = 0; c < number_of_cluster; c++) {
+            double minimum_separation = std::numeric_limits<double>::max();
+
+            for (size_t other = 0; other < number_of_cluster; other++)
+                if (other != c)
+                    minimum_separation = std::min(
+                        minimum_separation,
+                        squared_distance(centroids.data() + c * number_of_features, centroids.data() + other * number_of_features, number_of_features)
+                    );
+
+            half_separations[c] = 0.5 * std::sqrt(minimum_separation);
+        }
+
+        // Update labels. The bounds skip most distance computations, a point costs about one.
+        changed = false;
+
+        #pragma omp parallel for schedule(static) reduction(||:changed) num_threads(utils::get_team_size(number_of_samples * number_of_features, utils::ParallelComponent::classifier))
+        for (long long i = 0; i < static_cast<long long>(number_of_samples); i++) {
+            const double *point = data + static_cast<size_t>(i) * number_of_features;
+            const size_t label = static_cast<size_t>(labels[i]);
+
+            upper_bounds[i] += centroid_shifts[label];
+            lower_bounds[i] -= maximum_shift;
+
+            const double bound = std::max(half_separations[label], lower_bounds[i]);
+
+            if (upper_bounds[i] <= bound)
+                continue;
+
+            upper_bounds[i] = std::sqrt(squared_distance(point, centroids.data() + label * number_of_features, number_of_features));
+
+            if (upper_bounds[i] <= bound)
+                continue;
+
+            const NearestCentroids nearest = find_nearest_centroids(point, centroids, number_of_cluster, number_of_features);
+
+            if (nearest.label != labels[i]) {
+                labels[i] = nearest.label;
+                changed = true;
+            }
+
+            upper_bounds[i] = std::sqrt(nearest.best_distance);
+            lower_bounds[i] = std::sqrt(nearest.second_distance);
+        }
+    }
+
+    return labels;
+}
+
+
+std::vector<int> KmeansClassifier::run_mini_batch(
+    const double *data,
+    const size_t number_of_samples,
+    const size_t number_of_features,
+    std::vector<double> &centroids,
+    std::mt19937 &generator
+) const
+{
+    // Mini-batch k-means: each centroid moves toward the batch points assigned to it
+    // with a step of 1 / (number of points it has received so far).
+    std::uniform_int_distribution<size_t> choose(0, number_of_samples - 1);
+
+    std::vector<size_t> batch_indices(batch_size);
+    std::vector<int> batch_labels(batch_size);
+    std::vector<size_t> cluster_counts(number_of_cluster, 0);
+
+    for (size_t iteration = 0; iteration < max_iterations; iteration++) {
+        for (size_t &index : batch_indices)
+            index = choose(generator);
+
+        #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(batch_size * number_of_features * number_of_cluster, utils::ParallelComponent::classifier))
+        for (long long j = 0; j < static_cast<long long>(batch_size); j++)
+            batch_labels[j] = find_nearest_centroids(
+                data + batch_indices[j] * number_of_features,
+                centroids,
+                number_of_cluster,
+                number_of_features
+            ).label;
+
+        for (size_t j = 0; j < batch_size; j++) {
+            const size_t c = static_cast<size_t>(batch_labels[j]);
+            const double *point = data + batch_indices[j] * number_of_features;
+            double *centroid = centroids.data() + c * number_of_features;
+
+            const double learning_rate = 1.0 / static_cast<double>(++cluster_counts[c]);
+
+            for (size_t f = 0; f < number_of_features; f++)
+                centroid[f] += learning_rate * (point[f] - centroid[f]);
+        }
     }
 
+    std::vector<int> labels(number_of_samples);
+    assign_nearest_centroids(data, number_of_samples, number_of_features, centroids, number_of_cluster, labels);
+
     return labels;
 }
 
 
+namespace {
+
+// Summed in feature order, without reassociation, so that points exactly at
+// epsilon are classified the same way whichever index finds them.
+inline double ordered_squared_distance(const double *point_a, const double *point_b, const size_t number_of_features)
+{
+    double value = 0.0;
+
+    for (size_t f = 0; f < number_of_features; f++) {
+        const double difference = point_a[f] - point_b[f];
+        value += difference * difference;
+    }
+
+    return value;
+}
+
+// Root of a point in a union-find that only ever links a root under a smaller
+// one, so the root of a set is its lowest index whatever the order of the unions.
+size_t find_root(std::vector<std::atomic<size_t>> &parents, size_t index)
+{
+    while (true) {
+        size_t parent = parents[index].load(std::memory_order_relaxed);
+
+        if (parent == index)
+            return index;
+
+        const size_t grandparent = parents[parent].load(std::memory_order_relaxed);
+
+        // Path halving. The grandparent is in the same set, so a lost race is harmless.
+        if (grandparent != parent)
+            parents[index].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+
+        index = grandparent;
+    }
+}
+
+void unite(std::vector<std::atomic<size_t>> &parents, size_t index_a, size_t index_b)
+{
+    while (true) {
+        index_a = find_root(parents, index_a);
+        index_b = find_root(parents, index_b);
+
+        if (index_a == index_b)
+            return;
+
+        if (index_a < index_b)
+            std::swap(index_a, index_b);
+
+        size_t expected = index_a;
+
+        if (parents[index_a].compare_exchange_strong(expected, index_b, std::memory_order_relaxed))
+            return;
+    }
+}
+
+template <typename SpatialIndex>
+std::vector<int> label_points(
+    const SpatialIndex &spatial_index,
+    const double *data,
+    const size_t number_of_samples,
+    const size_t number_of_features,
+    const std::vector<size_t> &finite_indices,
+    const double epsilon_squared,
+    const size_t minimum_samples,
+    std::vector<char> &is_core
+) {
+    const long long number_of_finite = static_cast<long long>(finite_indices.size());
+
+    // A neighbourhood query compares a point with at least about minimum_samples others.
+    const int team_size = utils::get_team_size(
+        finite_indices.size() * minimum_samples * number_of_features,
+        utils::ParallelComponent::classifier
+    );
+
+    const auto is_neighbour = [&](const size_t index_a, const size_t index_b) {
+        return ordered_squared_distance(
+            data + index_a * number_of_features,
+            data + index_b * number_of_features,
+            number_of_features
+        ) <= epsilon_squared;
+    };
+
+    // Core points: at least minimum_samples points, themselves included, within epsilon.
+    is_core.assign(number_of_samples, 0);
+
+    #pragma omp parallel for schedule(dynamic, 256) num_threads(team_size)
+    for (long long position = 0; position < number_of_finite; position++) {
+        const size_t index = finite_indices[position];
+        size_t number_of_neighbours = 0;
+
+        spatial_index.for_each_candidate(data + index * number_of_features, [&](const size_t candidate) {
+            if (is_neighbour(index, candidate))
+                number_of_neighbours++;
+
+            return number_of_neighbours < minimum_samples;
+        });
+
+        is_core[index] = number_of_neighbours >= minimum_samples;
+    }
+
+    // Clusters: connected components of core points within epsilon of each other.
+    std::vector<std::atomic<size_t>> parents(number_of_samples);
+
+    for (size_t index = 0; index < number_of_samples; index++)
+        parents[index].store(index, std::memory_order_relaxed);
+
+    #pragma omp parallel for schedule(dynamic, 256) num_threads(team_size)
+    for (long long position = 0; position < number_of_finite; position++) {
+        const size_t index = finite_indices[position];
+
+        if (!is_core[index])
+            continue;
+
+        spatial_index.for_each_candidate(data + index * number_of_features, [&](const size_t candidate) {
+            if (candidate < index && is_core[candidate] && is_neighbour(index, candidate))
+                unite(parents, index, candidate);
+
+            return true;
+        });
+    }
+
+    std::vector<int> labels(number_of_samples, -1); // -1 means noise
+    int current_cluster_id = 0;
+
+    for (size_t index = 0; index < number_of_samples; index++) {
+        if (!is_core[index])
+            continue;
+
+        const size_t root = find_root(parents, index);
+
+        labels[index] = root == index ? current_cluster_id++ : labels[root];
+    }
+
+    // Border points: the lowest cluster among their core neighbours.
+    #pragma omp parallel for schedule(dynamic, 256) num_threads(team_size)
+    for (long long position = 0; position < number_of_finite; position++) {
+        const size_t index = finite_indices[position];
+
+        if (is_core[index])
+            continue;
+
+        int label = -1;
+
+        spatial_index.for_each_candidate(data + index * number_of_features, [&](const size_t candidate) {
+            if (is_core[candidate] && (label == -1 || labels[candidate] < label) && is_neighbour(index, candidate))
+                label = labels[candidate];
+
+            return true;
+        });
+
+        labels[index] = label;
+    }
+
+    return labels;
+}
+
+std::vector<int> cluster_points(
+    const double *data,
+    const size_t number_of_samples,
+    const size_t number_of_features,
+    const double epsilon,
+    const double epsilon_squared,
+    const size_t minimum_samples,
+    std::vector<char> &is_core
+) {
+    if (number_of_samples == 0)
+        throw std::runtime_error("Input matrix has no samples");
+
+    if (number_of_features == 0)
+        throw std::runtime_error("Input matrix has no features");
+
+    // A non finite feature gives NaN distances, so such a point has no neighbour, not even itself.
+    std::vector<size_t> finite_indices;
+    finite_indices.reserve(number_of_samples);
+
+    for (size_t index = 0; index < number_of_samples; index++) {
+        const double *point = data + index * number_of_features;
+
+        if (std::all_of(point, point + number_of_features, [](const double value) { return std::isfinite(value); }))
+            finite_indices.push_back(index);
+    }
+
+    if (finite_indices.empty()) {
+        is_core.assign(number_of_samples, 0);
+        return std::vector<int>(number_of_samples, -1);
+    }
+
+    if (number_of_features <= UniformGrid::maximum_dimension) {
+        UniformGrid grid;
+
+        if (grid.build(data, finite_indices, number_of_features, epsilon))
+            return label_points(grid, data, number_of_samples, number_of_features, finite_indices, epsilon_squared, minimum_samples, is_core);
+    }
+
+    KdTree tree;
+    tree.build(data, finite_indices, number_of_features, epsilon_squared);
+
+    return label_points(tree, data, number_of_samples, number_of_features, finite_indices, epsilon_squared, minimum_samples, is_core);
+}
+
+}  // namespace
+
+
 DbscanClassifier::DbscanClassifier(double epsilon, std::size_t minimum_samples)
     : epsilon(epsilon),
-      epsilon_squared(epsilon * epsilon),
-      minimum_samples(minimum_samples)
+      minimum_samples(minimum_samples),
+      epsilon_squared(epsilon * epsilon)
 {
     if (epsilon <= 0.0) {
         throw std::runtime_error("epsilon must be positive");
@@ -99,111 +709,94 @@ DbscanClassifier::DbscanClassifier(double epsilon, std::size_t minimum_samples)
     }
 }
 
-double DbscanClassifier::squared_euclidean_distance(const std::vector<double> &point_a, const std::vector<double> &point_b) const
+std::vector<int> DbscanClassifier::run(const std::vector<std::vector<double>> &data_matrix) const
 {
-    if (point_a.size() != point_b.size()) {
-        throw std::runtime_error("Points must have the same dimension");
-    }
+    const std::vector<double> data = flatten_rows(data_matrix);
 
-    double value = 0.0;
-    for (std::size_t i = 0; i < point_a.size(); i++) {
-        double difference = point_a[i] - point_b[i];
-        value += difference * difference;
-    }
-    return value;
+    return this->run(data.data(), data_matrix.size(), data_matrix[0].size());
+}
+
+std::vector<int> DbscanClassifier::run(const double *data, std::size_t number_of_samples, std::size_t number_of_features) const
+{
+    std::vector<char> is_core;
+
+    return cluster_points(data, number_of_samples, number_of_features, epsilon, epsilon_squared, minimum_samples, is_core);
 }
 
-std::vector<std::size_t> DbscanClassifier::region_query(const std::vector<std::vector<double>> &data_matrix, std::size_t index) const
+std::vector<int> DbscanClassifier::fit(const double *data, std::size_t number_of_samples, std::size_t number_of_features)
 {
-    std::vector<std::size_t> neighbors;
-    const std::vector<double> &point = data_matrix[index];
+    FLOWCYPY_PROFILE_SCOPE("classifier.dbscan");
+    FLOWCYPY_PROFILE_COUNT("classifier.dbscan", "samples", number_of_samples);
+
+    std::vector<char> is_core;
+    std::vector<int> labels = cluster_points(data, number_of_samples, number_of_features, epsilon, epsilon_squared, minimum_samples, is_core);
+
+    this->core_points.clear();
+    this->core_labels.clear();
 
-    for (std::size_t j = 0; j < data_matrix.size(); j++) {
-        double distance_squared = squared_euclidean_distance(point, data_matrix[j]);
-        if (distance_squared <= epsilon_squared) {
-            neighbors.push_back(j);
+    for (std::size_t index = 0; index < number_of_samples; index++) {
+        if (!is_core[index]) {
+            continue;
         }
+
+        this->core_points.insert(this->core_points.end(), data + index * number_of_features, data + (index + 1) * number_of_features);
+        this->core_labels.push_back(labels[index]);
     }
-    return neighbors;
-}
-
-void DbscanClassifier::expand_cluster(
-    const std::vector<std::vector<double>> &data_matrix,
-    std::size_t point_index,
-    std::vector<std::size_t> &neighbor_indices,
-    int cluster_id,
-    std::vector<int> &labels,
-    std::vector<bool> &visited
-) const {
-    labels[point_index] = cluster_id;
-
-    for (std::size_t i = 0; i < neighbor_indices.size(); i++) {
-        std::size_t neighbor_index = neighbor_indices[i];
-
-        if (!visited[neighbor_index]) {
-            visited[neighbor_index] = true;
-            std::vector<std::size_t> neighbor_neighbors =
-                region_query(data_matrix, neighbor_index);
-
-            if (neighbor_neighbors.size() >= minimum_samples) {
-                neighbor_indices.insert(
-                    neighbor_indices.end(),
-                    neighbor_neighbors.begin(),
-                    neighbor_neighbors.end()
-                );
-            }
-        }
 
-        if (labels[neighbor_index] == -1) {
-            labels[neighbor_index] = cluster_id;
-        }
+    std::vector<std::size_t> core_indices(this->core_labels.size());
+    std::iota(core_indices.begin(), core_indices.end(), 0);
+
+    this->number_of_fitted_features = number_of_features;
+    this->core_points_in_grid =
+        number_of_features <= UniformGrid::maximum_dimension &&
+        this->core_grid.build(this->core_points.data(), core_indices, number_of_features, epsilon);
+
+    if (!this->core_points_in_grid) {
+        this->core_tree.build(this->core_points.data(), core_indices, number_of_features, epsilon_squared);
     }
+
+    return labels;
 }
 
-std::vector<int> DbscanClassifier::run(const std::vector<std::vector<double>> &data_matrix) const
+std::vector<int> DbscanClassifier::assign(const double *data, std::size_t number_of_samples, std::size_t number_of_features) const
 {
-    std::size_t number_of_samples = data_matrix.size();
-    if (number_of_samples == 0) {
-        throw std::runtime_error("Input matrix has no samples");
+    if (this->number_of_fitted_features == 0) {
+        throw std::runtime_error("fit must be called before assigning events");
     }
 
-    std::size_t number_of_features = data_matrix[0].size();
-    if (number_of_features == 0) {
-        throw std::runtime_error("Input matrix has no features");
+    if (number_of_features != this->number_of_fitted_features) {
+        throw std::runtime_error("Events must have the number of features the classifier was fitted on");
     }
 
-    for (const auto &row : data_matrix) {
-        if (row.size() != number_of_features) {
-            throw std::runtime_error("All rows must have the same number of features");
-        }
-    }
+    std::vector<int> labels(number_of_samples, -1);
 
-    std::vector<int> labels(number_of_samples, -1); // -1 means noise
-    std::vector<bool> visited(number_of_samples, false);
+    const auto assign_with = [&](const auto &spatial_index) {
+        #pragma omp parallel for schedule(dynamic, 256) num_threads(utils::get_team_size(number_of_samples * this->minimum_samples * number_of_features, utils::ParallelComponent::classifier))
+        for (long long index = 0; index < static_cast<long long>(number_of_samples); index++) {
+            const double *point = data + static_cast<std::size_t>(index) * number_of_features;
+            int label = -1;
 
-    int current_cluster_id = 0;
+            spatial_index.for_each_candidate(point, [&](const std::size_t core) {
+                const int core_label = this->core_labels[core];
 
-    for (std::size_t i = 0; i < number_of_samples; i++) {
-        if (visited[i]) {
-            continue;
-        }
+                if (
+                    (label == -1 || core_label < label) &&
+                    ordered_squared_distance(point, this->core_points.data() + core * number_of_features, number_of_features) <= epsilon_squared
+                ) {
+                    label = core_label;
+                }
 
-        visited[i] = true;
-        std::vector<std::size_t> neighbor_indices = region_query(data_matrix, i);
-
-        if (neighbor_indices.size() < minimum_samples) {
-            labels[i] = -1;
-        } else {
-            expand_cluster(
-                data_matrix,
-                i,
-                neighbor_indices,
-                current_cluster_id,
-                labels,
-                visited
-            );
-            current_cluster_id += 1;
+                return true;
+            });
+
+            labels[index] = label;
         }
+    };
+
+    if (this->core_points_in_grid) {
+        assign_with(this->core_grid);
+    } else {
+        assign_with(this->core_tree);
     }
 
     return labels;
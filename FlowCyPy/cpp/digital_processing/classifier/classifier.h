@@ -6,22 +6,155 @@
 #include <cstddef>
 #include <stdexcept>
 
+#include "spatial_index.h"
+
+/*
+    @brief K-means clustering of a contiguous row-major feature matrix.
+
+    Centroids are seeded with k-means++. Full runs follow Lloyd iterations with
+    Hamerly bounds, so points whose nearest centroid provably did not change
+    skip the distance scan; the labels are those of plain Lloyd iterations.
+    With a positive batch_size, centroids are instead fitted on random
+    mini-batches and every point is labeled once at the end, for very large
+    event counts.
+*/
 class KmeansClassifier {
 public:
-    explicit KmeansClassifier(size_t number_of_cluster) : number_of_cluster(number_of_cluster) {}
+    explicit KmeansClassifier(size_t number_of_cluster, size_t max_iterations = 300, size_t batch_size = 0)
+        : number_of_cluster(number_of_cluster), max_iterations(max_iterations), batch_size(batch_size) {}
+
+    /*
+        @param data Row-major matrix of number_of_samples rows and number_of_features columns.
+        @return Cluster label of every row.
+    */
+    std::vector<int> run(
+        const double *data,
+        size_t number_of_samples,
+        size_t number_of_features,
+        unsigned int random_state = 42
+    ) const;
 
     std::vector<int> run(const std::vector<std::vector<double>> &data_matrix, unsigned int random_state = 42) const;
 
+    /*
+        @brief Cluster a warm-up batch, as run does, and keep its centroids for assign and assign_and_update.
+        @return Cluster label of every row.
+    */
+    std::vector<int> fit(
+        const double *data,
+        size_t number_of_samples,
+        size_t number_of_features,
+        unsigned int random_state = 42
+    );
+
+    /*
+        @brief Label rows with their nearest fitted centroid, which stay frozen.
+        @throws std::runtime_error If fit was not called or the number of features differs.
+    */
+    std::vector<int> assign(const double *data, size_t number_of_samples, size_t number_of_features) const;
+
+    /*
+        @brief Label rows one after the other, moving each nearest centroid toward its row (sequential k-means).
+
+        The step is learning_rate, or 1 / (rows assigned to the centroid so far,
+        warm-up included) when learning_rate is 0.
+        @throws std::runtime_error If fit was not called or the number of features differs.
+    */
+    std::vector<int> assign_and_update(const double *data, size_t number_of_samples, size_t number_of_features);
+
     size_t number_of_cluster;
+
+    /// Maximum number of Lloyd iterations, or of mini-batches.
+    size_t max_iterations;
+
+    /// Number of points per mini-batch. 0 runs full iterations.
+    size_t batch_size;
+
+    /// Step of the online centroid update. A constant step lets centroids follow drift; 0 averages all rows.
+    double learning_rate = 0.0;
+
+    /// Fitted centroids, row-major, number_of_cluster rows of number_of_fitted_features.
+    std::vector<double> centroids;
+
+    /// Rows assigned to each fitted centroid.
+    std::vector<size_t> cluster_counts;
+
+    size_t number_of_fitted_features = 0;
+
+private:
+    std::vector<int> cluster(
+        const double *data,
+        size_t number_of_samples,
+        size_t number_of_features,
+        unsigned int random_state,
+        std::vector<double> &centroids
+    ) const;
+
+    void check_fitted(size_t number_of_features) const;
+
+    std::vector<double> seed_centroids(
+        const double *data,
+        size_t number_of_samples,
+        size_t number_of_features,
+        std::mt19937 &generator
+    ) const;
+
+    std::vector<int> run_full_batch(
+        const double *data,
+        size_t number_of_samples,
+        size_t number_of_features,
+        std::vector<double> &centroids,
+        std::mt19937 &generator
+    ) const;
+
+    std::vector<int> run_mini_batch(
+        const double *data,
+        size_t number_of_samples,
+        size_t number_of_features,
+        std::vector<double> &centroids,
+        std::mt19937 &generator
+    ) const;
 };
 
 
+/*
+    @brief DBSCAN clustering of a contiguous row-major feature matrix.
+
+    Neighbourhoods are found through a uniform grid of cells about epsilon wide
+    when there are at most four features, and through a k-d tree otherwise.
+    Core points are found and joined with a concurrent union-find in parallel.
+    Clusters are numbered by their lowest core point index and a border point
+    takes the lowest cluster among its core neighbours, which are the labels of
+    a sequential DBSCAN visiting the points in order. Points with a non finite
+    feature are noise.
+*/
 class DbscanClassifier {
 public:
     DbscanClassifier(double epsilon, std::size_t minimum_samples);
 
+    /*
+        @param data Row-major matrix of number_of_samples rows and number_of_features columns.
+        @return Cluster label of every row, -1 for noise.
+    */
+    std::vector<int> run(const double *data, std::size_t number_of_samples, std::size_t number_of_features) const;
+
     std::vector<int> run(const std::vector<std::vector<double>> &data_matrix) const;
 
+    /*
+        @brief Cluster a warm-up batch, as run does, and index its core points for assign.
+        @return Cluster label of every row, -1 for noise.
+    */
+    std::vector<int> fit(const double *data, std::size_t number_of_samples, std::size_t number_of_features);
+
+    /*
+        @brief Label rows with the lowest cluster among the fitted core points within epsilon, -1 if none.
+
+        The fitted clusters are frozen: new rows never become core points. On the
+        warm-up batch itself this gives back the labels returned by fit.
+        @throws std::runtime_error If fit was not called or the number of features differs.
+    */
+    std::vector<int> assign(const double *data, std::size_t number_of_samples, std::size_t number_of_features) const;
+
 
     double epsilon;
     std::size_t minimum_samples;
@@ -29,16 +162,11 @@ public:
 private:
     double epsilon_squared;
 
-    double squared_euclidean_distance(const std::vector<double> &point_a, const std::vector<double> &point_b) const;
-
-    std::vector<std::size_t> region_query(const std::vector<std::vector<double>> &data_matrix, std::size_t index) const;
-
-    void expand_cluster(
-        const std::vector<std::vector<double>> &data_matrix,
-        std::size_t point_index,
-        std::vector<std::size_t> &neighbor_indices,
-        int cluster_id,
-        std::vector<int> &labels,
-        std::vector<bool> &visited
-    ) const;
+    // Fitted core points, row-major, with their cluster labels.
+    std::vector<double> core_points;
+    std::vector<int> core_labels;
+    std::size_t number_of_fitted_features = 0;
+    bool core_points_in_grid = false;
+    UniformGrid core_grid;
+    KdTree core_tree;
 };
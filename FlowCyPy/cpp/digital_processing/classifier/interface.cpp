@@ -2,10 +2,15 @@
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <stdexcept>
 
+#include <utils/module_binding.h>
+#include <utils/profiler_binding.h>
+#include <utils/threading_binding.h>
+
 #include "classifier.h"
 
 namespace py = pybind11;
@@ -46,35 +51,17 @@ namespace
         return dataframe;
     }
 
-    std::vector<std::vector<double>> dataframe_to_matrix(py::object dataframe)
-    {
-        py::array_t<double, py::array::c_style | py::array::forcecast> values =
-            dataframe.attr("to_numpy")().cast<py::array_t<double, py::array::c_style | py::array::forcecast>>();
+    using FeatureArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
 
-        py::buffer_info buffer = values.request();
+    FeatureArray dataframe_to_array(py::object dataframe)
+    {
+        FeatureArray values = dataframe.attr("to_numpy")().cast<FeatureArray>();
 
-        if (buffer.ndim != 2) {
+        if (values.ndim() != 2) {
             throw std::runtime_error("Filtered dataframe values must be a two dimensional array.");
         }
 
-        const std::size_t number_of_samples = static_cast<std::size_t>(buffer.shape[0]);
-        const std::size_t number_of_features = static_cast<std::size_t>(buffer.shape[1]);
-
-        const double* data_pointer = static_cast<double*>(buffer.ptr);
-
-        std::vector<std::vector<double>> data_matrix(
-            number_of_samples,
-            std::vector<double>(number_of_features)
-        );
-
-        for (std::size_t sample_index = 0; sample_index < number_of_samples; ++sample_index) {
-            for (std::size_t feature_index = 0; feature_index < number_of_features; ++feature_index) {
-                data_matrix[sample_index][feature_index] =
-                    data_pointer[sample_index * number_of_features + feature_index];
-            }
-        }
-
-        return data_matrix;
+        return values;
     }
 
     py::array_t<int> vector_to_numpy_array(const std::vector<int>& labels)
@@ -91,6 +78,38 @@ namespace
         return label_array;
     }
 
+    void check_event_array(const FeatureArray& data)
+    {
+        if (data.ndim() != 2) {
+            throw std::runtime_error("Event features must be a two dimensional array of shape (number_of_events, number_of_features).");
+        }
+    }
+
+    // Runs a classifier method on a (number_of_events, number_of_features) array.
+    // Only const methods release the GIL: methods changing the fitted state keep it,
+    // so two Python threads never mutate a classifier at the same time.
+    template <typename Method>
+    py::array_t<int> label_event_array(const FeatureArray& data, Method&& method, const bool release_gil)
+    {
+        check_event_array(data);
+
+        const double* data_pointer = data.data();
+        const std::size_t number_of_samples = static_cast<std::size_t>(data.shape(0));
+        const std::size_t number_of_features = static_cast<std::size_t>(data.shape(1));
+
+        std::vector<int> labels;
+
+        if (release_gil) {
+            py::gil_scoped_release release;
+            labels = method(data_pointer, number_of_samples, number_of_features);
+        }
+        else {
+            labels = method(data_pointer, number_of_samples, number_of_features);
+        }
+
+        return vector_to_numpy_array(labels);
+    }
+
     py::object prepare_feature_dataframe(
         py::object dataframe,
         py::object features,
@@ -133,22 +152,161 @@ namespace
     }
 }
 
-PYBIND11_MODULE(classifier, module)
+FLOWCYPY_MODULE(classifier, module)
 {
     py::class_<KmeansClassifier>(module, "KmeansClassifier")
         .def(
-            py::init<std::size_t>(),
-            py::arg("number_of_clusters")
+            py::init<std::size_t, std::size_t, std::size_t>(),
+            py::arg("number_of_clusters"),
+            py::arg("max_iterations") = 300,
+            py::arg("batch_size") = 0,
+            R"pbdoc(
+                KMeans classifier seeded with k-means++.
+
+                Parameters
+                ----------
+                number_of_clusters : int
+                    Number of clusters.
+                max_iterations : int, default=300
+                    Maximum number of Lloyd iterations, or of mini-batches when
+                    ``batch_size`` is positive.
+                batch_size : int, default=0
+                    Number of events drawn per mini-batch. With 0, or a value not
+                    below the number of events, full Lloyd iterations are run.
+            )pbdoc"
         )
         .def_readonly(
             "number_of_clusters",
             &KmeansClassifier::number_of_cluster
         )
+        .def_readonly(
+            "max_iterations",
+            &KmeansClassifier::max_iterations
+        )
+        .def_readonly(
+            "batch_size",
+            &KmeansClassifier::batch_size
+        )
+        .def_readwrite(
+            "learning_rate",
+            &KmeansClassifier::learning_rate,
+            R"pbdoc(
+                Step of the centroid update in ``assign_and_update``. A constant step
+                lets the centroids follow a slow drift of the populations; with 0
+                each centroid is the running mean of every event assigned to it.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "centroids",
+            [](const KmeansClassifier& self) {
+                py::array_t<double> centroid_array(
+                    {self.centroids.empty() ? std::size_t{0} : self.number_of_cluster, self.number_of_fitted_features}
+                );
+
+                std::copy(self.centroids.begin(), self.centroids.end(), centroid_array.mutable_data());
+
+                return centroid_array;
+            },
+            "Fitted centroids, of shape (number_of_clusters, number_of_features), empty before fit."
+        )
+        .def(
+            "fit",
+            [](KmeansClassifier& classifier, const FeatureArray& data, unsigned int random_state) {
+                return label_event_array(data, [&](const double* pointer, std::size_t number_of_samples, std::size_t number_of_features) {
+                    return classifier.fit(pointer, number_of_samples, number_of_features, random_state);
+                }, false);
+            },
+            py::arg("data"),
+            py::arg("random_state") = 42,
+            R"pbdoc(
+                Cluster a warm-up batch of events and keep the centroids for online labeling.
+
+                Parameters
+                ----------
+                data : numpy.ndarray
+                    Event features of shape ``(number_of_events, number_of_features)``.
+                    Later blocks must list the features in the same order.
+                random_state : int, default=42
+                    Seed used by the KMeans initialization procedure.
+
+                Returns
+                -------
+                numpy.ndarray
+                    Cluster label of every event.
+            )pbdoc"
+        )
+        .def(
+            "assign",
+            [](const KmeansClassifier& classifier, const FeatureArray& data) {
+                return label_event_array(data, [&](const double* pointer, std::size_t number_of_samples, std::size_t number_of_features) {
+                    return classifier.assign(pointer, number_of_samples, number_of_features);
+                }, true);
+            },
+            py::arg("data"),
+            R"pbdoc(
+                Label a block of events with their nearest fitted centroid.
+
+                The centroids are left unchanged, so blocks can be labeled in any order.
+                The GIL is released while labeling: do not call ``fit`` or
+                ``assign_and_update`` on the same classifier from another thread
+                meanwhile.
+
+                Parameters
+                ----------
+                data : numpy.ndarray
+                    Event features of shape ``(number_of_events, number_of_features)``.
+
+                Returns
+                -------
+                numpy.ndarray
+                    Cluster label of every event.
+
+                Raises
+                ------
+                RuntimeError
+                    If ``fit`` was not called or the number of features differs.
+            )pbdoc"
+        )
+        .def(
+            "assign_and_update",
+            [](KmeansClassifier& classifier, const FeatureArray& data) {
+                return label_event_array(data, [&](const double* pointer, std::size_t number_of_samples, std::size_t number_of_features) {
+                    return classifier.assign_and_update(pointer, number_of_samples, number_of_features);
+                }, false);
+            },
+            py::arg("data"),
+            R"pbdoc(
+                Label a block of events in order, moving each nearest centroid toward its event.
+
+                This is sequential k-means, with a step of ``learning_rate``, or of one
+                over the number of events assigned to the centroid so far when
+                ``learning_rate`` is 0.
+
+                Parameters
+                ----------
+                data : numpy.ndarray
+                    Event features of shape ``(number_of_events, number_of_features)``.
+
+                Returns
+                -------
+                numpy.ndarray
+                    Cluster label of every event.
+
+                Raises
+                ------
+                RuntimeError
+                    If ``fit`` was not called or the number of features differs.
+            )pbdoc"
+        )
         .def(
             "__repr__",
             [](const KmeansClassifier& self) {
                 return "KmeansClassifier(number_of_clusters=" +
-                    std::to_string(self.number_of_cluster) + ")";
+                    std::to_string(self.number_of_cluster) +
+                    ", max_iterations=" +
+                    std::to_string(self.max_iterations) +
+                    ", batch_size=" +
+                    std::to_string(self.batch_size) + ")";
             }
         )
         .def(
@@ -165,12 +323,16 @@ PYBIND11_MODULE(classifier, module)
                     detectors
                 );
 
-                std::vector<std::vector<double>> data_matrix = dataframe_to_matrix(filtered_dataframe);
+                FeatureArray values = dataframe_to_array(filtered_dataframe);
+
+                const double* data_pointer = values.data();
+                const std::size_t number_of_samples = static_cast<std::size_t>(values.shape(0));
+                const std::size_t number_of_features = static_cast<std::size_t>(values.shape(1));
 
                 std::vector<int> labels;
                 {
                     py::gil_scoped_release release;
-                    labels = classifier.run(data_matrix, random_state);
+                    labels = classifier.run(data_pointer, number_of_samples, number_of_features, random_state);
                 }
 
                 py::array_t<int> label_array = vector_to_numpy_array(labels);
@@ -245,6 +407,62 @@ PYBIND11_MODULE(classifier, module)
             "minimum_samples",
             &DbscanClassifier::minimum_samples
         )
+        .def(
+            "fit",
+            [](DbscanClassifier& classifier, const FeatureArray& data) {
+                return label_event_array(data, [&](const double* pointer, std::size_t number_of_samples, std::size_t number_of_features) {
+                    return classifier.fit(pointer, number_of_samples, number_of_features);
+                }, false);
+            },
+            py::arg("data"),
+            R"pbdoc(
+                Cluster a warm-up batch of events and index its core points for online labeling.
+
+                Parameters
+                ----------
+                data : numpy.ndarray
+                    Event features of shape ``(number_of_events, number_of_features)``.
+                    Later blocks must list the features in the same order.
+
+                Returns
+                -------
+                numpy.ndarray
+                    Cluster label of every event, -1 for noise.
+            )pbdoc"
+        )
+        .def(
+            "assign",
+            [](const DbscanClassifier& classifier, const FeatureArray& data) {
+                return label_event_array(data, [&](const double* pointer, std::size_t number_of_samples, std::size_t number_of_features) {
+                    return classifier.assign(pointer, number_of_samples, number_of_features);
+                }, true);
+            },
+            py::arg("data"),
+            R"pbdoc(
+                Label a block of events from the fitted core points.
+
+                An event takes the lowest cluster among the fitted core points within
+                ``epsilon``, and is noise when there is none. New events never become
+                core points, so the fitted clusters do not grow or merge.
+                The GIL is released while labeling: do not call ``fit`` on the
+                same classifier from another thread meanwhile.
+
+                Parameters
+                ----------
+                data : numpy.ndarray
+                    Event features of shape ``(number_of_events, number_of_features)``.
+
+                Returns
+                -------
+                numpy.ndarray
+                    Cluster label of every event, -1 for noise.
+
+                Raises
+                ------
+                RuntimeError
+                    If ``fit`` was not called or the number of features differs.
+            )pbdoc"
+        )
         .def(
             "__repr__",
             [](const DbscanClassifier& self) {
@@ -267,12 +485,16 @@ PYBIND11_MODULE(classifier, module)
                     detectors
                 );
 
-                std::vector<std::vector<double>> data_matrix = dataframe_to_matrix(filtered_dataframe);
+                FeatureArray values = dataframe_to_array(filtered_dataframe);
+
+                const double* data_pointer = values.data();
+                const std::size_t number_of_samples = static_cast<std::size_t>(values.shape(0));
+                const std::size_t number_of_features = static_cast<std::size_t>(values.shape(1));
 
                 std::vector<int> labels;
                 {
                     py::gil_scoped_release release;
-                    labels = classifier.run(data_matrix);
+                    labels = classifier.run(data_pointer, number_of_samples, number_of_features);
                 }
 
                 py::array_t<int> label_array = vector_to_numpy_array(labels);
@@ -319,4 +541,7 @@ PYBIND11_MODULE(classifier, module)
                     If the DataFrame does not expose the expected pandas interface.
             )pbdoc"
         );
+
+    register_profiling_functions(module);
+    register_threading_functions(module);
 }
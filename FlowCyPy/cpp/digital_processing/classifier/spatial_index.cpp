@@ -0,0 +1,191 @@
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <utility>
+
+
+namespace {
+
+// Largest number of grid cells along one feature, which keeps the rounding of
+// the cell coordinates well below the margin added to the cell size.
+constexpr double maximum_grid_extent = static_cast<double>(1LL << 31);
+
+}  // namespace
+
+
+bool UniformGrid::build(
+    const double *data,
+    const std::vector<size_t> &indices,
+    const size_t number_of_features,
+    const double epsilon
+) {
+    this->cell_size = epsilon * (1.0 + 1e-6);
+    this->minima.assign(number_of_features, std::numeric_limits<double>::infinity());
+    this->extents.assign(number_of_features, 0.0);
+    this->strides.assign(number_of_features, 0);
+
+    std::vector<double> maxima(number_of_features, -std::numeric_limits<double>::infinity());
+
+    for (const size_t index : indices)
+        for (size_t f = 0; f < number_of_features; f++) {
+            this->minima[f] = std::min(this->minima[f], data[index * number_of_features + f]);
+            maxima[f] = std::max(maxima[f], data[index * number_of_features + f]);
+        }
+
+    if (indices.empty())
+        std::fill(this->minima.begin(), this->minima.end(), 0.0);
+
+    // Padded by one cell on each side, so that the keys of the cells around an indexed point never wrap.
+    unsigned long long number_of_cells = 1;
+
+    for (size_t f = 0; f < number_of_features; f++) {
+        const double extent = indices.empty() ? 1.0 : std::floor((maxima[f] - this->minima[f]) / this->cell_size) + 1.0;
+
+        if (!(extent < maximum_grid_extent))
+            return false;
+
+        this->extents[f] = extent;
+        this->strides[f] = number_of_cells;
+
+        const unsigned long long padded_extent = static_cast<unsigned long long>(extent) + 2;
+
+        if (number_of_cells > (std::numeric_limits<unsigned long long>::max() >> 2) / padded_extent)
+            return false;
+
+        number_of_cells *= padded_extent;
+    }
+
+    std::vector<std::pair<unsigned long long, size_t>> keyed_indices;
+    keyed_indices.reserve(indices.size());
+
+    for (const size_t index : indices) {
+        unsigned long long key = 0;
+        this->find_key(data + index * number_of_features, key);
+        keyed_indices.emplace_back(key, index);
+    }
+
+    std::sort(keyed_indices.begin(), keyed_indices.end());
+
+    this->cell_start.clear();
+    this->sorted_indices.clear();
+    this->cells.clear();
+    this->cells.reserve(keyed_indices.size());
+
+    for (size_t position = 0; position < keyed_indices.size(); position++) {
+        const auto [key, index] = keyed_indices[position];
+
+        if (position == 0 || key != keyed_indices[position - 1].first) {
+            this->cells.emplace(key, this->cell_start.size());
+            this->cell_start.push_back(position);
+        }
+
+        this->sorted_indices.push_back(index);
+    }
+
+    this->cell_start.push_back(keyed_indices.size());
+
+    // Offsets wrap modulo 2^64, which the key arithmetic undoes.
+    this->neighbour_offsets.assign(1, 0);
+
+    for (size_t f = 0; f < number_of_features; f++) {
+        const size_t number_of_offsets = this->neighbour_offsets.size();
+
+        for (size_t o = 0; o < number_of_offsets; o++) {
+            this->neighbour_offsets.push_back(this->neighbour_offsets[o] - this->strides[f]);
+            this->neighbour_offsets.push_back(this->neighbour_offsets[o] + this->strides[f]);
+        }
+    }
+
+    return true;
+}
+
+
+bool UniformGrid::find_key(const double *point, unsigned long long &key) const
+{
+    key = 0;
+
+    for (size_t f = 0; f < this->minima.size(); f++) {
+        const double coordinate = std::floor((point[f] - this->minima[f]) / this->cell_size);
+
+        // A point more than one cell off the grid has no indexed neighbour. Queries
+        // on the padding may alias other cells, which only adds candidates.
+        if (!(coordinate >= -1.0 && coordinate <= this->extents[f]))
+            return false;
+
+        key += static_cast<unsigned long long>(coordinate + 1.0) * this->strides[f];
+    }
+
+    return true;
+}
+
+
+void KdTree::build(
+    const double *data,
+    const std::vector<size_t> &indices,
+    const size_t number_of_features,
+    const double epsilon_squared
+) {
+    this->epsilon_squared = epsilon_squared;
+    this->indices = indices;
+    this->nodes.clear();
+
+    if (!this->indices.empty())
+        this->build_node(data, number_of_features, 0, this->indices.size());
+}
+
+
+size_t KdTree::build_node(const double *data, const size_t number_of_features, const size_t begin, const size_t end)
+{
+    const size_t node_index = this->nodes.size();
+    this->nodes.push_back(Node{begin, end});
+
+    if (end - begin <= leaf_size)
+        return node_index;
+
+    const auto coordinate = [&](const size_t index, const size_t axis) {
+        return data[index * number_of_features + axis];
+    };
+
+    size_t axis = 0;
+    double widest_spread = -1.0;
+
+    for (size_t f = 0; f < number_of_features; f++) {
+        double minimum = std::numeric_limits<double>::infinity();
+        double maximum = -std::numeric_limits<double>::infinity();
+
+        for (size_t position = begin; position < end; position++) {
+            minimum = std::min(minimum, coordinate(this->indices[position], f));
+            maximum = std::max(maximum, coordinate(this->indices[position], f));
+        }
+
+        if (maximum - minimum > widest_spread) {
+            widest_spread = maximum - minimum;
+            axis = f;
+        }
+    }
+
+    // Identical points cannot be split further.
+    if (widest_spread <= 0.0)
+        return node_index;
+
+    const size_t middle = begin + (end - begin) / 2;
+
+    std::nth_element(
+        this->indices.begin() + static_cast<std::ptrdiff_t>(begin),
+        this->indices.begin() + static_cast<std::ptrdiff_t>(middle),
+        this->indices.begin() + static_cast<std::ptrdiff_t>(end),
+        [&](const size_t a, const size_t b) { return coordinate(a, axis) < coordinate(b, axis); }
+    );
+
+    const double split = coordinate(this->indices[middle], axis);
+    const size_t left = this->build_node(data, number_of_features, begin, middle);
+    const size_t right = this->build_node(data, number_of_features, middle, end);
+
+    Node &node = this->nodes[node_index];
+    node.axis = axis;
+    node.split = split;
+    node.left = left;
+    node.right = right;
+
+    return node_index;
+}
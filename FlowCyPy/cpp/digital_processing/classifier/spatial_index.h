@@ -0,0 +1,138 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+#include <unordered_map>
+
+/*
+    @brief Hash of the occupied cells of a uniform grid.
+
+    Cells are slightly wider than epsilon, so every point within epsilon of a
+    query lies in the query cell or in one of the 3^d cells around it despite
+    rounding of the cell coordinates. Indexed points must have finite features.
+*/
+class UniformGrid {
+public:
+    /// Features above which a grid is not worth its 3^d neighbour cells.
+    static constexpr size_t maximum_dimension = 4;
+
+    /*
+        @param data Row-major matrix the indices refer to.
+        @return false, leaving the grid unusable, when the cell coordinates would overflow.
+    */
+    bool build(
+        const double *data,
+        const std::vector<size_t> &indices,
+        size_t number_of_features,
+        double epsilon
+    );
+
+    /*
+        @brief Call visit on every indexed point in the cells around point, until it returns false.
+
+        Candidates are a superset of the points within epsilon. Queries need not be indexed points.
+    */
+    template <typename Visitor>
+    void for_each_candidate(const double *point, Visitor &&visit) const {
+        unsigned long long key = 0;
+
+        if (!this->find_key(point, key))
+            return;
+
+        for (const unsigned long long offset : this->neighbour_offsets) {
+            const auto cell = this->cells.find(key + offset);
+
+            if (cell == this->cells.end())
+                continue;
+
+            for (size_t position = this->cell_start[cell->second]; position < this->cell_start[cell->second + 1]; position++)
+                if (!visit(this->sorted_indices[position]))
+                    return;
+        }
+    }
+
+private:
+    double cell_size = 0.0;
+    std::vector<double> minima;
+    std::vector<double> extents;
+    std::vector<unsigned long long> strides;
+    std::vector<unsigned long long> neighbour_offsets;
+    std::unordered_map<unsigned long long, size_t> cells;
+    std::vector<size_t> cell_start;
+    std::vector<size_t> sorted_indices;
+
+    bool find_key(const double *point, unsigned long long &key) const;
+};
+
+/*
+    @brief k-d tree over points with finite features.
+
+    Nodes split at the median of their widest feature. A subtree is skipped only
+    when the squared distance along the split feature alone exceeds epsilon^2,
+    which bounds the summed squared distance from below in floating point too.
+*/
+class KdTree {
+public:
+    /*
+        @param data Row-major matrix the indices refer to.
+    */
+    void build(
+        const double *data,
+        const std::vector<size_t> &indices,
+        size_t number_of_features,
+        double epsilon_squared
+    );
+
+    /*
+        @brief Call visit on every indexed point in the leaves within reach of point, until it returns false.
+    */
+    template <typename Visitor>
+    void for_each_candidate(const double *point, Visitor &&visit) const {
+        if (this->nodes.empty())
+            return;
+
+        std::vector<size_t> stack = {0};
+
+        while (!stack.empty()) {
+            const Node &node = this->nodes[stack.back()];
+            stack.pop_back();
+
+            if (node.left == no_child) {
+                for (size_t position = node.begin; position < node.end; position++)
+                    if (!visit(this->indices[position]))
+                        return;
+
+                continue;
+            }
+
+            const double difference = point[node.axis] - node.split;
+            const bool within_reach = difference * difference <= this->epsilon_squared;
+
+            if (difference <= 0.0 || within_reach)
+                stack.push_back(node.left);
+
+            if (difference >= 0.0 || within_reach)
+                stack.push_back(node.right);
+        }
+    }
+
+private:
+    static constexpr size_t no_child = std::numeric_limits<size_t>::max();
+    static constexpr size_t leaf_size = 16;
+
+    struct Node {
+        size_t begin;
+        size_t end;
+        size_t axis = 0;
+        double split = 0.0;
+        size_t left = no_child;
+        size_t right = no_child;
+    };
+
+    double epsilon_squared = 0.0;
+    std::vector<size_t> indices;
+    std::vector<Node> nodes;
+
+    size_t build_node(const double *data, size_t number_of_features, size_t begin, size_t end);
+};
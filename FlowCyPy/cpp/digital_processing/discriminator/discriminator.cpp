@@ -1,10 +1,12 @@
 #include "discriminator.h"
+#include "threshold_crossing.h"
 
 #include <algorithm>
-#include <cctype>
 #include <cmath>
 #include <stdexcept>
 
+#include <utils/profiler.h>
+
 
 // =============================
 // BaseDiscriminator implementation
@@ -19,15 +21,39 @@ void BaseDiscriminator::add_time(const std::vector<double> &time) {
 }
 
 
+void BaseDiscriminator::add_time(const utils::TimeAxis &time_axis) {
+    if (time_axis.empty()) {
+        throw std::runtime_error("Time axis must not be empty.");
+    }
+
+    this->trigger.add_time(time_axis);
+}
+
+
 void BaseDiscriminator::add_signal(
     const std::string &detector_name,
-    const std::vector<double> &signal
+    std::vector<double> signal
 ) {
     if (signal.empty()) {
         throw std::runtime_error("Signal vector must not be empty.");
     }
 
-    this->trigger.add_signal(detector_name, signal);
+    this->trigger.add_signal(detector_name, std::move(signal));
+}
+
+
+void BaseDiscriminator::add_acquisition_buffer(
+    const std::shared_ptr<const utils::AcquisitionBuffer> &buffer
+) {
+    if (!buffer->contains("Time")) {
+        throw std::runtime_error("Acquisition buffer must contain a 'Time' channel.");
+    }
+
+    if (buffer->get_number_of_samples() == 0) {
+        throw std::runtime_error("Acquisition buffer must not be empty.");
+    }
+
+    this->trigger.add_acquisition_buffer(buffer);
 }
 
 
@@ -42,6 +68,21 @@ void BaseDiscriminator::validate_detector_existence(
 }
 
 
+void BaseDiscriminator::run() {
+    FLOWCYPY_PROFILE_SCOPE("discriminator.run");
+    FLOWCYPY_PROFILE_COUNT("discriminator.run", "samples", this->trigger.get_number_of_time_samples());
+
+    this->trigger.clear();
+
+    const std::vector<std::pair<int, int>> valid_triggers = this->find_event_windows();
+
+    FLOWCYPY_PROFILE_COUNT("discriminator.run", "events", valid_triggers.size());
+
+    this->trigger.run_segmentation(valid_triggers);
+    this->print_warning_if_no_signal_met_trigger_criteria();
+}
+
+
 double BaseDiscriminator::parse_threshold(const Threshold &threshold) const {
     if (!threshold.is_defined()) {
         throw std::runtime_error("Threshold is undefined.");
@@ -62,131 +103,34 @@ double BaseDiscriminator::parse_threshold(const Threshold &threshold) const {
 double BaseDiscriminator::parse_sigma_threshold_string(
     const std::string &threshold_string
 ) const {
-    std::string compact_threshold_string = threshold_string;
-
-    compact_threshold_string.erase(
-        std::remove_if(
-            compact_threshold_string.begin(),
-            compact_threshold_string.end(),
-            [](unsigned char character) {
-                return std::isspace(character);
-            }
-        ),
-        compact_threshold_string.end()
-    );
-
-    const std::string sigma_suffix = "sigma";
-
-    if (
-        compact_threshold_string.size() <= sigma_suffix.size() ||
-        compact_threshold_string.substr(
-            compact_threshold_string.size() - sigma_suffix.size()
-        ) != sigma_suffix
-    ) {
-        throw std::runtime_error(
-            "Unknown threshold format: '" + threshold_string +
-            "'. Expected a numeric value or a string like '4sigma'."
-        );
-    }
-
-    const std::string sigma_multiplier_string =
-        compact_threshold_string.substr(
-            0,
-            compact_threshold_string.size() - sigma_suffix.size()
-        );
-
-    double number_of_sigma;
-    try {
-        number_of_sigma = std::stod(sigma_multiplier_string);
-    } catch (...) {
-        throw std::runtime_error(
-            "Failed to parse sigma threshold from '" + threshold_string + "'."
-        );
-    }
+    const double number_of_sigma = parse_sigma_multiplier(threshold_string);
 
     this->validate_detector_existence(this->trigger_channel);
 
-    const std::vector<double> &signal =
+    const std::span<const double> signal =
         this->trigger.signal_map.at(this->trigger_channel);
 
-    const double median_value = this->compute_median(signal);
-    const double sigma_mad = this->compute_mad_based_sigma(signal);
-
-    return median_value + number_of_sigma * sigma_mad;
-}
-
-
-double BaseDiscriminator::compute_median(std::vector<double> values) const {
-    if (values.empty()) {
-        throw std::runtime_error("Cannot compute median of an empty signal.");
-    }
-
-    const size_t number_of_values = values.size();
-    const size_t middle_index = number_of_values / 2;
-
-    std::nth_element(
-        values.begin(),
-        values.begin() + middle_index,
-        values.end()
-    );
-
-    const double upper_middle_value = values[middle_index];
-
-    if (number_of_values % 2 != 0) {
-        return upper_middle_value;
-    }
-
-    std::nth_element(
-        values.begin(),
-        values.begin() + middle_index - 1,
-        values.begin() + middle_index
-    );
+    NoiseFloorEstimator estimator(this->noise_floor_sample_capacity);
+    estimator.add_samples(signal);
 
-    const double lower_middle_value = values[middle_index - 1];
+    const NoiseFloor noise_floor = estimator.estimate();
 
-    return 0.5 * (lower_middle_value + upper_middle_value);
+    return noise_floor.median + number_of_sigma * noise_floor.sigma;
 }
 
 
-double BaseDiscriminator::compute_mad_based_sigma(
-    const std::vector<double> &signal
-) const {
-    if (signal.empty()) {
-        throw std::runtime_error(
-            "Cannot compute MAD based sigma of an empty signal."
-        );
-    }
-
-    const double median_value = this->compute_median(signal);
-
-    std::vector<double> absolute_deviations;
-    absolute_deviations.reserve(signal.size());
-
-    for (const double value : signal) {
-        absolute_deviations.push_back(std::abs(value - median_value));
-    }
-
-    const double mad = this->compute_median(std::move(absolute_deviations));
-
-    return mad / 0.6745;
-}
-
-
-
 // =============================
 // FixedWindow implementation
 // =============================
 
-void FixedWindow::run() {
+std::vector<std::pair<int, int>> FixedWindow::find_event_windows() {
     if (!this->threshold.is_defined()) {
         throw std::runtime_error(
             "FixedWindow threshold must be set before calling run()."
         );
     }
 
-    this->trigger.clear();
-
-    if (this->trigger.global_time.empty()) {
+    if (!this->trigger.has_time()) {
         throw std::runtime_error(
             "Global time axis must be set before running triggers."
         );
@@ -203,41 +147,38 @@ void FixedWindow::run() {
     this->resolved_threshold = this->parse_threshold(this->threshold);
     this->threshold.set_numeric(this->resolved_threshold);
 
-    const std::vector<double> &signal =
+    const std::span<const double> signal =
         this->trigger.signal_map.at(this->trigger_channel);
 
+    const ThresholdCrossings crossings =
+        find_threshold_crossings(signal, this->resolved_threshold, false);
+
     std::vector<std::pair<int, int>> valid_triggers;
     int last_end = -1;
 
-    for (size_t index = 1; index < signal.size(); ++index) {
-        if (
-            signal[index - 1] <= this->resolved_threshold &&
-            signal[index] > this->resolved_threshold
-        ) {
-            const int trigger_index = static_cast<int>(index);
-            const int start = trigger_index - static_cast<int>(this->pre_buffer);
-            const int end = trigger_index + static_cast<int>(this->post_buffer);
+    for (const size_t index : crossings.rising_edges) {
+        const int trigger_index = static_cast<int>(index);
+        const int start = trigger_index - static_cast<int>(this->pre_buffer);
+        const int end = trigger_index + static_cast<int>(this->post_buffer);
 
-            if (start < 0 || end >= static_cast<int>(signal.size())) {
-                continue;
-            }
+        if (start < 0 || end >= static_cast<int>(signal.size())) {
+            continue;
+        }
 
-            if (start > last_end) {
-                valid_triggers.emplace_back(start, end);
-                last_end = end;
-            }
+        if (start > last_end) {
+            valid_triggers.emplace_back(start, end);
+            last_end = end;
+        }
 
-            if (
-                this->max_triggers > 0 &&
-                valid_triggers.size() >= static_cast<size_t>(this->max_triggers)
-            ) {
-                break;
-            }
+        if (
+            this->max_triggers > 0 &&
+            valid_triggers.size() >= static_cast<size_t>(this->max_triggers)
+        ) {
+            break;
         }
     }
 
-    this->trigger.run_segmentation(valid_triggers);
-    this->print_warning_if_no_signal_met_trigger_criteria();
+    return valid_triggers;
 }
 
 
@@ -246,16 +187,14 @@ void FixedWindow::run() {
 // DynamicWindow implementation
 // =============================
 
-void DynamicWindow::run() {
+std::vector<std::pair<int, int>> DynamicWindow::find_event_windows() {
     if (!this->threshold.is_defined()) {
         throw std::runtime_error(
             "DynamicWindow threshold must be set before calling run()."
         );
     }
 
-    this->trigger.clear();
-
-    if (this->trigger.global_time.empty()) {
+    if (!this->trigger.has_time()) {
         throw std::runtime_error(
             "Global time axis must be set before running triggers."
         );
@@ -272,59 +211,61 @@ void DynamicWindow::run() {
     this->resolved_threshold = this->parse_threshold(this->threshold);
     this->threshold.set_numeric(this->resolved_threshold);
 
-    const std::vector<double> &signal =
+    const std::span<const double> signal =
         this->trigger.signal_map.at(this->trigger_channel);
 
+    const ThresholdCrossings crossings =
+        find_threshold_crossings(signal, this->resolved_threshold, true);
+
     std::vector<std::pair<int, int>> valid_triggers;
 
     int last_end = -1;
 
-    for (size_t index = 1; index < signal.size(); ++index) {
-        if (
-            signal[index - 1] <= this->resolved_threshold &&
-            signal[index] > this->resolved_threshold
-        ) {
-            int start = static_cast<int>(index) - static_cast<int>(this->pre_buffer);
+    // Crossings inside an accepted run are skipped, as the serial scan resumes after it.
+    size_t resume_index = 0;
 
-            if (start < 0) {
-                start = 0;
-            }
+    for (const size_t index : crossings.rising_edges) {
+        if (index < resume_index) {
+            continue;
+        }
 
-            size_t end_index = index;
+        int start = static_cast<int>(index) - static_cast<int>(this->pre_buffer);
 
-            while (
-                end_index < signal.size() &&
-                signal[end_index] > this->resolved_threshold
-            ) {
-                ++end_index;
-            }
+        if (start < 0) {
+            start = 0;
+        }
 
-            int end =
-                static_cast<int>(end_index) - 1 +
-                static_cast<int>(this->post_buffer);
+        const size_t end_index = find_run_end(
+            signal,
+            this->resolved_threshold,
+            crossings.falling_edges,
+            index
+        );
 
-            if (end >= static_cast<int>(signal.size())) {
-                end = static_cast<int>(signal.size()) - 1;
-            }
+        int end =
+            static_cast<int>(end_index) - 1 +
+            static_cast<int>(this->post_buffer);
 
-            if (start > last_end) {
-                valid_triggers.emplace_back(start, end);
-                last_end = end;
-            }
+        if (end >= static_cast<int>(signal.size())) {
+            end = static_cast<int>(signal.size()) - 1;
+        }
 
-            if (
-                this->max_triggers > 0 &&
-                valid_triggers.size() >= static_cast<size_t>(this->max_triggers)
-            ) {
-                break;
-            }
+        if (start > last_end) {
+            valid_triggers.emplace_back(start, end);
+            last_end = end;
+        }
 
-            index = end_index;
+        if (
+            this->max_triggers > 0 &&
+            valid_triggers.size() >= static_cast<size_t>(this->max_triggers)
+        ) {
+            break;
         }
+
+        resume_index = end_index + 1;
     }
 
-    this->trigger.run_segmentation(valid_triggers);
-    this->print_warning_if_no_signal_met_trigger_criteria();
+    return valid_triggers;
 }
 
 
@@ -333,16 +274,14 @@ void DynamicWindow::run() {
 // DoubleThreshold implementation
 // =============================
 
-void DoubleThreshold::run() {
+std::vector<std::pair<int, int>> DoubleThreshold::find_event_windows() {
     if (!this->threshold.is_defined()) {
         throw std::runtime_error(
             "DoubleThreshold primary threshold must be set before calling run()."
         );
     }
 
-    this->trigger.clear();
-
-    if (this->trigger.global_time.empty()) {
+    if (!this->trigger.has_time()) {
         throw std::runtime_error(
             "Global time axis must be set before running triggers."
         );
@@ -366,93 +305,83 @@ void DoubleThreshold::run() {
         this->resolved_lower_threshold = this->resolved_upper_threshold;
     }
 
-    const std::vector<double> &signal =
+    const std::span<const double> signal =
         this->trigger.signal_map.at(this->trigger_channel);
 
+    const ThresholdCrossings upper_crossings =
+        find_threshold_crossings(signal, this->resolved_upper_threshold, true);
+
     std::vector<std::pair<int, int>> valid_triggers;
 
     int last_end = -1;
 
-    for (size_t index = 1; index < signal.size(); ++index) {
-        if (
-            signal[index - 1] <= this->resolved_upper_threshold &&
-            signal[index] > this->resolved_upper_threshold
-        ) {
-            size_t threshold_crossing_end = index;
-
-            if (this->debounce_enabled && this->min_window_duration != -1) {
-                size_t above_threshold_count = 0;
-
-                while (
-                    threshold_crossing_end < signal.size() &&
-                    signal[threshold_crossing_end] > this->resolved_upper_threshold
-                ) {
-                    ++above_threshold_count;
-                    ++threshold_crossing_end;
-
-                    if (
-                        above_threshold_count >=
-                        static_cast<size_t>(this->min_window_duration)
-                    ) {
-                        break;
-                    }
-                }
-
-                if (
-                    above_threshold_count <
-                    static_cast<size_t>(this->min_window_duration)
-                ) {
-                    index = threshold_crossing_end;
-                    continue;
-                }
-            } else {
-                while (
-                    threshold_crossing_end < signal.size() &&
-                    signal[threshold_crossing_end] > this->resolved_upper_threshold
-                ) {
-                    ++threshold_crossing_end;
-                }
-            }
+    // Crossings inside a processed run are skipped, as the serial scan resumes after it.
+    size_t resume_index = 0;
 
-            int start = static_cast<int>(index) - static_cast<int>(this->pre_buffer);
+    for (const size_t index : upper_crossings.rising_edges) {
+        if (index < resume_index) {
+            continue;
+        }
 
-            if (start < 0) {
-                start = 0;
-            }
+        const size_t upper_run_end = find_run_end(
+            signal,
+            this->resolved_upper_threshold,
+            upper_crossings.falling_edges,
+            index
+        );
 
-            size_t lower_threshold_crossing_end = threshold_crossing_end;
+        size_t threshold_crossing_end = upper_run_end;
 
-            while (
-                lower_threshold_crossing_end < signal.size() &&
-                signal[lower_threshold_crossing_end] > this->resolved_lower_threshold
-            ) {
-                ++lower_threshold_crossing_end;
-            }
+        if (this->debounce_enabled && this->min_window_duration != -1) {
+            // The scan stops once min_window_duration samples, and at least one, are above the threshold.
+            const size_t min_window_duration = static_cast<size_t>(this->min_window_duration);
+            const size_t scanned_length = std::max<size_t>(min_window_duration, 1);
 
-            int end =
-                static_cast<int>(lower_threshold_crossing_end) - 1 +
-                static_cast<int>(this->post_buffer);
-
-            if (end >= static_cast<int>(signal.size())) {
-                end = static_cast<int>(signal.size()) - 1;
+            if (upper_run_end - index >= scanned_length) {
+                threshold_crossing_end = index + scanned_length;
             }
 
-            if (start > last_end) {
-                valid_triggers.emplace_back(start, end);
-                last_end = end;
+            if (threshold_crossing_end - index < min_window_duration) {
+                resume_index = threshold_crossing_end + 1;
+                continue;
             }
+        }
 
-            if (
-                this->max_triggers > 0 &&
-                valid_triggers.size() >= static_cast<size_t>(this->max_triggers)
-            ) {
-                break;
-            }
+        int start = static_cast<int>(index) - static_cast<int>(this->pre_buffer);
+
+        if (start < 0) {
+            start = 0;
+        }
+
+        // Only accepted crossings follow the lower threshold, so it is scanned directly.
+        const size_t lower_threshold_crossing_end = find_run_end(
+            signal,
+            this->resolved_lower_threshold,
+            threshold_crossing_end
+        );
+
+        int end =
+            static_cast<int>(lower_threshold_crossing_end) - 1 +
+            static_cast<int>(this->post_buffer);
+
+        if (end >= static_cast<int>(signal.size())) {
+            end = static_cast<int>(signal.size()) - 1;
+        }
 
-            index = lower_threshold_crossing_end;
+        if (start > last_end) {
+            valid_triggers.emplace_back(start, end);
+            last_end = end;
         }
+
+        if (
+            this->max_triggers > 0 &&
+            valid_triggers.size() >= static_cast<size_t>(this->max_triggers)
+        ) {
+            break;
+        }
+
+        resume_index = lower_threshold_crossing_end + 1;
     }
 
-    this->trigger.run_segmentation(valid_triggers);
-    this->print_warning_if_no_signal_met_trigger_criteria();
+    return valid_triggers;
 }
@@ -1,13 +1,16 @@
 #pragma once
 
 #include <cmath>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
 #include <cstdio> // for printf
 #include <algorithm> // for std::minmax_element
 
+#include "noise_floor.h"
 #include "threshold.h"
 #include "trigger.h"
 
@@ -41,6 +44,9 @@ public:
     /// Maximum number of accepted triggers. A value of -1 means no limit.
     int max_triggers = -1;
 
+    /// Number of samples used to resolve sigma thresholds. A value of 0 uses every sample.
+    size_t noise_floor_sample_capacity = NoiseFloorEstimator::default_capacity;
+
     /// Internal container storing time, signals, and segmented outputs.
     Trigger trigger;
 
@@ -84,6 +90,16 @@ public:
      */
     void add_time(const std::vector<double> &time);
 
+    /**
+     * @brief Add a uniform time axis used by all signal channels.
+     *
+     * Equivalent to the vector overload, without storing one time value per sample.
+     *
+     * @param time_axis
+     *     Affine time axis with one value per signal sample.
+     */
+    void add_time(const utils::TimeAxis &time_axis);
+
     /**
      * @brief Add a signal channel to the trigger system.
      *
@@ -94,11 +110,27 @@ public:
      * @param detector_name
      *     Name associated with the signal channel.
      * @param signal
-     *     One dimensional vector containing the signal samples.
+     *     One dimensional vector containing the signal samples, moved into the trigger.
      */
     void add_signal(
         const std::string &detector_name,
-        const std::vector<double> &signal
+        std::vector<double> signal
+    );
+
+    /**
+     * @brief Use the channels of an acquisition buffer as time axis and signals.
+     *
+     * The trigger keeps views of the buffer rather than copies, so detection and
+     * segmentation read the buffer memory directly.
+     *
+     * @param buffer
+     *     Acquisition buffer holding a `"Time"` channel and the signal channels.
+     *
+     * @throws std::runtime_error
+     *     If the buffer has no `"Time"` channel or no samples.
+     */
+    void add_acquisition_buffer(
+        const std::shared_ptr<const utils::AcquisitionBuffer> &buffer
     );
 
     /**
@@ -123,14 +155,25 @@ public:
     /**
      * @brief Execute trigger detection and segmentation.
      *
+     * The event windows returned by `find_event_windows()` are segmented out of
+     * every stored signal into the internal Trigger.
+     */
+    void run();
+
+    /**
+     * @brief Detect the event windows without segmenting the signals.
+     *
      * This method must be implemented by derived classes and is responsible for:
      *
      * - validating the configuration
      * - resolving stored threshold values
      * - detecting valid trigger windows
-     * - segmenting the stored signals around those windows
+     *
+     * @return
+     *     Inclusive (start, end) sample indices of the accepted event windows,
+     *     in increasing order and non overlapping.
      */
-    virtual void run() = 0;
+    virtual std::vector<std::pair<int, int>> find_event_windows() = 0;
 
 protected:
     /**
@@ -167,6 +210,8 @@ protected:
      *     median(signal) + N * sigma_mad(signal)
      *
      * where `sigma_mad` is a robust MAD based estimate of the standard deviation.
+     * Both statistics are estimated by a NoiseFloorEstimator over at most
+     * `noise_floor_sample_capacity` evenly strided samples.
      *
      * @param threshold_string
      *     Symbolic sigma threshold string.
@@ -178,37 +223,6 @@ protected:
         const std::string &threshold_string
     ) const;
 
-    /**
-     * @brief Compute the median of a vector of values.
-     *
-     * The input vector is taken by value because the algorithm reorders the
-     * content using `std::nth_element`.
-     *
-     * @param values
-     *     Input values for which the median is computed.
-     *
-     * @return
-     *     Median of the provided values.
-     */
-    double compute_median(std::vector<double> values) const;
-
-    /**
-     * @brief Compute a MAD based estimate of the signal standard deviation.
-     *
-     * The returned quantity is:
-     *
-     *     median(|x - median(x)|) / 0.6745
-     *
-     * which is a robust estimator of sigma for approximately Gaussian data.
-     *
-     * @param signal
-     *     Input signal values.
-     *
-     * @return
-     *     Robust sigma estimate of the signal.
-     */
-    double compute_mad_based_sigma(const std::vector<double> &signal) const;
-
     /**
      * @brief Print a warning when no segment satisfies the trigger criteria.
      *
@@ -221,7 +235,7 @@ protected:
      * during development or debugging.
      */
     void print_warning_if_no_signal_met_trigger_criteria() {
-        const auto segmented_signal =
+        const std::vector<double> &segmented_signal =
             this->trigger.get_segmented_signal(
                 this->trigger_channel
             );
@@ -239,7 +253,7 @@ protected:
             return;
         }
 
-        const std::vector<double> &signal = signal_iterator->second;
+        const std::span<const double> signal = signal_iterator->second;
 
         if (signal.empty()) {
             return;
@@ -331,13 +345,12 @@ public:
     }
 
     /**
-     * @brief Execute fixed window trigger detection.
+     * @brief Detect fixed window events.
      *
      * This method resolves the stored threshold, detects rising threshold
-     * crossings on `trigger_channel`, builds fixed width event windows, and
-     * segments the stored signals accordingly.
+     * crossings on `trigger_channel` and builds fixed width event windows.
      */
-    void run() override;
+    std::vector<std::pair<int, int>> find_event_windows() override;
 };
 
 
@@ -410,13 +423,13 @@ public:
     }
 
     /**
-     * @brief Execute dynamic window trigger detection.
+     * @brief Detect dynamic window events.
      *
      * This method resolves the stored threshold, detects rising threshold
-     * crossings on `trigger_channel`, extends each event until the signal
-     * drops below threshold, and segments the stored signals accordingly.
+     * crossings on `trigger_channel` and extends each event until the signal
+     * drops below threshold.
      */
-    void run() override;
+    std::vector<std::pair<int, int>> find_event_windows() override;
 };
 
 
@@ -558,12 +571,11 @@ public:
     }
 
     /**
-     * @brief Execute double threshold trigger detection.
+     * @brief Detect double threshold events.
      *
      * This method resolves the stored primary threshold and optional lower
-     * threshold, detects threshold crossings on `trigger_channel`, applies
-     * hysteresis and optional debounce logic, and segments the stored signals
-     * around the accepted event windows.
+     * threshold, detects threshold crossings on `trigger_channel` and applies
+     * hysteresis and optional debounce logic.
      */
-    void run() override;
+    std::vector<std::pair<int, int>> find_event_windows() override;
 };
@@ -1,17 +1,139 @@
 #include <cmath>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 
 #include "discriminator.h"
+#include "online_discriminator.h"
+#include <digital_processing/peak_locator/peak_locator.h>
 #include <pint/pint.h>
+#include <utils/module_binding.h>
+#include <utils/numpy.h>
+#include <utils/profiler_binding.h>
+#include <utils/threading_binding.h>
 
 namespace py = pybind11;
 
-PYBIND11_MODULE(discriminator, module) {
+namespace {
+
+// Load the time axis and signal channels of a run_with_dict input into the discriminator.
+std::vector<std::string> load_data_dict(BaseDiscriminator &self, const py::dict &data_dict) {
+    if (!data_dict.contains("Time")) {
+        throw std::runtime_error("Input dictionary must contain a 'Time' key.");
+    }
+
+    // A TimeAxis, e.g. from Digitizer.get_time_axis, is used as is instead of being materialized.
+    const py::object time = data_dict["Time"];
+
+    if (py::isinstance<utils::TimeAxis>(time)) {
+        self.add_time(time.cast<const utils::TimeAxis &>());
+    } else {
+        const std::vector<double> time_vector =
+            array_to_vector(quantity_to_contiguous_array<double>(time, "second"));
+
+        self.add_time(time_vector);
+    }
+
+    std::vector<std::string> channel_names;
+    channel_names.reserve(data_dict.size() > 0 ? data_dict.size() - 1 : 0);
+
+    for (const auto &item : data_dict) {
+        const std::string key =
+            py::reinterpret_borrow<py::object>(item.first).cast<std::string>();
+
+        if (key == "Time") {
+            continue;
+        }
+
+        std::vector<double> signal_vector =
+            array_to_vector(quantity_to_contiguous_array<double>(item.second, "volt"));
+
+        self.add_signal(key, std::move(signal_vector));
+        channel_names.push_back(key);
+    }
+
+    if (channel_names.empty()) {
+        throw std::runtime_error(
+            "Input dictionary must contain at least one signal channel in addition to 'Time'."
+        );
+    }
+
+    return channel_names;
+}
+
+// Flatten the segmented output of a discriminator run into a Python dictionary.
+py::dict build_segmented_output_dict(
+    BaseDiscriminator &self,
+    const std::vector<std::string> &channel_names,
+    const py::object &ureg
+) {
+    const std::vector<double> &segmented_time = *self.trigger.time_out;
+
+    py::dict final_output;
+
+    // Segment IDs are expanded from the segment offsets; the other arrays wrap the
+    // buffers of this run, which later runs do not reuse.
+    final_output["segment_id"] = vector_to_numpy_without_copy(self.trigger.get_segment_ids());
+    final_output["Time"] = shared_vector_to_numpy(self.trigger.time_out) * ureg.attr("second");
+
+    for (const std::string &channel_name : channel_names) {
+        const std::shared_ptr<std::vector<double>> segmented_signal =
+            self.trigger.get_segmented_signal_buffer(channel_name);
+
+        if (segmented_signal->size() != segmented_time.size()) {
+            throw std::runtime_error(
+                "Segmented signal size mismatch for channel '" + channel_name + "'."
+            );
+        }
+
+        final_output[py::str(channel_name)] = shared_vector_to_numpy(segmented_signal) * ureg.attr("volt");
+    }
+
+    return final_output;
+}
+
+// Segments are views of the segmented signal buffer, which they keep alive.
+py::list build_segment_views(Trigger &trigger, const std::string &detector_name) {
+    const py::array_t<double> segmented_signal = shared_vector_to_numpy(trigger.get_segmented_signal_buffer(detector_name));
+    const std::vector<size_t> &offsets = trigger.segment_offsets;
+
+    py::list segments;
+
+    for (size_t segment = 0; segment < trigger.get_number_of_segments(); ++segment)
+        segments.append(
+            py::array_t<double>(offsets[segment + 1] - offsets[segment], segmented_signal.data() + offsets[segment], segmented_signal)
+        );
+
+    return segments;
+}
+
+py::array_t<double> build_segment_matrix(Trigger &trigger, const std::string &detector_name) {
+    const size_t segment_length = trigger.get_uniform_segment_length();
+    const std::shared_ptr<std::vector<double>> segmented_signal = trigger.get_segmented_signal_buffer(detector_name);
+
+    if (segmented_signal->size() != trigger.time_out->size()) {
+        throw std::runtime_error(
+            "No segmented signal for channel '" + detector_name + "'."
+        );
+    }
+
+    return py::array_t<double>(
+        {static_cast<py::ssize_t>(trigger.get_number_of_segments()), static_cast<py::ssize_t>(segment_length)},
+        segmented_signal->data(),
+        shared_vector_owner(segmented_signal)
+    );
+}
+
+}  // namespace
+
+
+FLOWCYPY_MODULE(discriminator, module) {
     py::object ureg = get_shared_ureg();
 
     module.doc() = R"pbdoc(
@@ -22,6 +144,9 @@ PYBIND11_MODULE(discriminator, module) {
         pre/post buffering, and segment extraction.
     )pbdoc";
 
+    // AcquisitionBuffer and TimeAxis are registered by their own module.
+    py::module_::import("FlowCyPy.binary.acquisition_buffer");
+
     py::class_<Threshold>(module, "Threshold")
         .def(py::init<>())
         .def(py::init<double>(), py::arg("numeric_value"))
@@ -149,19 +274,21 @@ PYBIND11_MODULE(discriminator, module) {
 
     py::class_<Trigger>(module, "Trigger")
         .def(py::init<>())
-        .def_readonly(
+        .def_property_readonly(
             "global_time",
-            &Trigger::global_time,
-            py::return_value_policy::reference_internal,
+            &Trigger::get_global_time,
             R"pbdoc(
                 Global time vector used for all signal operations.
 
-                This aligns one to one with samples in added signals.
+                This aligns one to one with samples in added signals. A time axis
+                given as a ``TimeAxis`` is materialized on access.
             )pbdoc"
         )
         .def(
             "get_segmented_signal",
-            &Trigger::get_segmented_signal,
+            [](py::object self, const std::string &detector_name) {
+                return shared_vector_to_numpy(self.cast<Trigger &>().get_segmented_signal_buffer(detector_name));
+            },
             py::arg("detector_name"),
             R"pbdoc(
                 Retrieve the segmented signal values for a specific detector.
@@ -174,52 +301,187 @@ PYBIND11_MODULE(discriminator, module) {
                 Returns
                 -------
                 numpy.ndarray
-                    One dimensional array of segmented signal values.
+                    One dimensional view of the segmented signal values of the last run.
             )pbdoc"
         )
-        .def_readonly(
+        .def(
+            "get_segments",
+            [](py::object self, const std::string &detector_name) {
+                return build_segment_views(self.cast<Trigger &>(), detector_name);
+            },
+            py::arg("detector_name"),
+            R"pbdoc(
+                Retrieve the segments of a specific detector as a ragged list.
+
+                Parameters
+                ----------
+                detector_name : str
+                    Name of the signal detector to retrieve.
+
+                Returns
+                -------
+                list of numpy.ndarray
+                    One array per segment, each viewing the segmented signal of the last run.
+            )pbdoc"
+        )
+        .def(
+            "get_segment_matrix",
+            [](py::object self, const std::string &detector_name) {
+                return build_segment_matrix(self.cast<Trigger &>(), detector_name);
+            },
+            py::arg("detector_name"),
+            R"pbdoc(
+                Retrieve the segments of a specific detector as a dense matrix.
+
+                Parameters
+                ----------
+                detector_name : str
+                    Name of the signal detector to retrieve.
+
+                Returns
+                -------
+                numpy.ndarray
+                    View of shape (n_segments, segment_length) of the segmented signal of the last run.
+
+                Raises
+                ------
+                RuntimeError
+                    If the segments do not all have the same length.
+            )pbdoc"
+        )
+        .def_property_readonly(
             "segmented_time",
-            &Trigger::time_out,
-            py::return_value_policy::reference_internal,
+            [](py::object self) {
+                return shared_vector_to_numpy(self.cast<const Trigger &>().time_out);
+            },
             R"pbdoc(
                 Time samples corresponding to the segmented output.
 
-                This is flattened across all detected segments.
+                This is flattened across all detected segments, and views the
+                time stamps of the last run.
             )pbdoc"
         )
-        .def_readonly(
+        .def_property_readonly(
+            "segment_offsets",
+            [](py::object self) {
+                const std::vector<size_t> &segment_offsets = self.cast<const Trigger &>().segment_offsets;
+                return py::array_t<size_t>(segment_offsets.size(), segment_offsets.data());
+            },
+            R"pbdoc(
+                Boundaries of the segments in the flattened output.
+
+                Segment k spans ``segment_offsets[k]:segment_offsets[k + 1]`` of
+                ``segmented_time`` and of every segmented signal.
+            )pbdoc"
+        )
+        .def_property_readonly(
             "segment_ids",
-            &Trigger::segment_ids_out,
-            py::return_value_policy::reference_internal,
+            [](const Trigger &self) {
+                return vector_to_numpy_without_copy(self.get_segment_ids());
+            },
             R"pbdoc(
                 Segment identifier associated with each segmented sample.
 
-                This is flattened across all detected segments.
+                This is expanded from ``segment_offsets`` on each access.
             )pbdoc"
         )
         .def(
             "__repr__",
             [](const Trigger& self) {
-                std::size_t number_of_segments = 0;
-
-                for (std::size_t index = 0; index < self.segment_ids_out.size(); ++index) {
-                    if (index == 0 || self.segment_ids_out[index] != self.segment_ids_out[index - 1]) {
-                        ++number_of_segments;
-                    }
-                }
-
                 return
                     "Trigger(n_signals=" +
                     std::to_string(self.signal_map.size()) +
                     ", n_segmented_channels=" +
                     std::to_string(self.signal_segments.size()) +
                     ", n_segmented_samples=" +
-                    std::to_string(self.segment_ids_out.size()) +
+                    std::to_string(self.time_out->size()) +
                     ", n_segments=" +
-                    std::to_string(number_of_segments) + ")";
+                    std::to_string(self.get_number_of_segments()) + ")";
             }
         );
 
+    py::class_<NoiseFloorEstimator>(
+        module,
+        "NoiseFloorEstimator",
+        R"pbdoc(
+            Streaming estimator of the median and MAD based sigma of a signal.
+
+            Samples are fed chunk by chunk. Every ``stride``-th sample is kept and
+            the stride doubles whenever ``capacity`` samples are kept, so memory
+            stays bounded. Streams of at most ``capacity`` samples are estimated
+            exactly. NaN samples are ignored.
+
+            Parameters
+            ----------
+            capacity : int
+                Maximum number of kept samples. 0 keeps every sample.
+        )pbdoc"
+    )
+        .def(
+            py::init<size_t>(),
+            py::arg("capacity") = NoiseFloorEstimator::default_capacity
+        )
+        .def(
+            "add_samples",
+            [](NoiseFloorEstimator &self, const py::object &samples) {
+                const contiguous_array<double> values =
+                    py::hasattr(samples, "units")
+                        ? quantity_to_contiguous_array<double>(samples, "volt")
+                        : to_contiguous_array<double>(samples);
+
+                self.add_samples(array_to_span(values));
+            },
+            py::arg("samples"),
+            R"pbdoc(
+                Feed the next chunk of the stream.
+
+                Parameters
+                ----------
+                samples : pint.Quantity or numpy.ndarray
+                    Samples following those already fed, in volts when given as a quantity.
+            )pbdoc"
+        )
+        .def(
+            "clear",
+            &NoiseFloorEstimator::clear,
+            R"pbdoc(
+                Forget every sample fed so far.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "number_of_samples",
+            &NoiseFloorEstimator::get_number_of_samples,
+            R"pbdoc(
+                Number of samples fed so far.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "stride",
+            &NoiseFloorEstimator::get_stride,
+            R"pbdoc(
+                Distance in samples between two kept samples.
+            )pbdoc"
+        )
+        .def(
+            "estimate",
+            [ureg](const NoiseFloorEstimator &self) {
+                const NoiseFloor noise_floor = self.estimate();
+
+                return py::make_tuple(
+                    py::float_(noise_floor.median) * ureg.attr("volt"),
+                    py::float_(noise_floor.sigma) * ureg.attr("volt")
+                );
+            },
+            R"pbdoc(
+                Estimate the noise floor of the samples fed so far.
+
+                Returns
+                -------
+                tuple[pint.Quantity, pint.Quantity]
+                    Median and MAD based sigma, in volts.
+            )pbdoc"
+        );
+
     py::class_<BaseDiscriminator>(module, "BaseDiscriminator")
         .def_readonly(
             "trigger",
@@ -259,81 +521,27 @@ PYBIND11_MODULE(discriminator, module) {
                 A value of -1 disables the limit.
             )pbdoc"
         )
+        .def_readwrite(
+            "noise_floor_sample_capacity",
+            &BaseDiscriminator::noise_floor_sample_capacity,
+            R"pbdoc(
+                Number of samples used to resolve sigma thresholds such as ``"3sigma"``.
+
+                Longer trigger channels are subsampled with an even stride. A value
+                of 0 uses every sample.
+            )pbdoc"
+        )
         .def(
             "run_with_dict",
             [ureg](BaseDiscriminator &self, const py::dict &data_dict) {
-                if (!data_dict.contains("Time")) {
-                    throw std::runtime_error("Input dictionary must contain a 'Time' key.");
-                }
-
-                const std::vector<double> time_vector =
-                    py::reinterpret_borrow<py::object>(data_dict["Time"])
-                        .attr("to")("second")
-                        .attr("magnitude")
-                        .cast<std::vector<double>>();
-
-                self.add_time(time_vector);
-
-                std::vector<std::string> channel_names;
-                channel_names.reserve(data_dict.size() > 0 ? data_dict.size() - 1 : 0);
-
-                for (const auto &item : data_dict) {
-                    const std::string key =
-                        py::reinterpret_borrow<py::object>(item.first).cast<std::string>();
-
-                    if (key == "Time") {
-                        continue;
-                    }
-
-                    const std::vector<double> signal_vector =
-                        py::reinterpret_borrow<py::object>(item.second)
-                            .attr("to")("volt")
-                            .attr("magnitude")
-                            .cast<std::vector<double>>();
-
-                    self.add_signal(key, signal_vector);
-                    channel_names.push_back(key);
-                }
+                const std::vector<std::string> channel_names = load_data_dict(self, data_dict);
 
-                if (channel_names.empty()) {
-                    throw std::runtime_error(
-                        "Input dictionary must contain at least one signal channel in addition to 'Time'."
-                    );
-                }
-
-                self.run();
-
-                py::module_ numpy = py::module_::import("numpy");
-
-                const std::vector<int> &segment_ids = self.trigger.segment_ids_out;
-                const std::vector<double> &segmented_time = self.trigger.time_out;
-
-                if (segment_ids.size() != segmented_time.size()) {
-                    throw std::runtime_error(
-                        "Segmented output is inconsistent: segment_ids_out and time_out do not have the same length."
-                    );
-                }
-
-                py::dict final_output;
-
-                final_output["segment_id"] = numpy.attr("array")(segment_ids);
-                final_output["Time"] = numpy.attr("array")(segmented_time) * ureg.attr("second");
-
-                for (const std::string &channel_name : channel_names) {
-                    const std::vector<double> &segmented_signal =
-                        self.trigger.get_segmented_signal(channel_name);
-
-                    if (segmented_signal.size() != segment_ids.size()) {
-                        throw std::runtime_error(
-                            "Segmented signal size mismatch for channel '" + channel_name + "'."
-                        );
-                    }
-
-                    final_output[py::str(channel_name)] =
-                        numpy.attr("array")(segmented_signal) * ureg.attr("volt");
+                {
+                    py::gil_scoped_release release;
+                    self.run();
                 }
 
-                return final_output;
+                return build_segmented_output_dict(self, channel_names, ureg);
             },
             py::arg("data_dict"),
             R"pbdoc(
@@ -347,6 +555,9 @@ PYBIND11_MODULE(discriminator, module) {
                     "ChannelB": quantity_array_convertible_to_volts,
                 }
 
+                ``"Time"`` may also be a ``TimeAxis``, in which case the segment
+                time stamps are computed from it.
+
                 Returns
                 -------
                 dict
@@ -367,6 +578,126 @@ PYBIND11_MODULE(discriminator, module) {
                     }
             )pbdoc"
         )
+        .def(
+            "run_peak_metrics",
+            [](BaseDiscriminator &self, const py::dict &data_dict, const BasePeakLocator &peak_locator, const std::string &trigger_channel) {
+                load_data_dict(self, data_dict);
+
+                self.trigger.clear();
+                const std::vector<std::pair<int, int>> event_windows = self.find_event_windows();
+
+                EventMetricDictionary event_metrics = peak_locator.run_event_windows(
+                    self.trigger.signal_map,
+                    event_windows,
+                    trigger_channel
+                );
+
+                const py::ssize_t number_of_events = static_cast<py::ssize_t>(event_windows.size());
+                const py::ssize_t max_number_of_peaks = static_cast<py::ssize_t>(peak_locator.max_number_of_peaks);
+
+                py::dict output;
+
+                for (auto &[channel_name, metric_dictionary] : event_metrics) {
+                    py::dict channel_output;
+
+                    for (auto &[metric_name, metric_values] : metric_dictionary) {
+                        channel_output[py::str(metric_name)] =
+                            vector_to_numpy_without_copy(std::move(metric_values))
+                                .attr("reshape")(number_of_events, max_number_of_peaks);
+                    }
+
+                    output[py::str(channel_name)] = channel_output;
+                }
+
+                return output;
+            },
+            py::arg("data_dict"),
+            py::arg("peak_locator"),
+            py::arg("trigger_channel") = "",
+            R"pbdoc(
+                Run trigger detection and compute peak metrics without building segments.
+
+                The event windows found in the trigger channel are handed to the peak
+                locator as views of the input signals, so no segmented copy of the
+                acquisition is made. The metrics equal those of
+                ``peak_locator.run(self.run_with_dict(data_dict), trigger_channel)``.
+                The trigger holds no segments afterwards.
+
+                Parameters
+                ----------
+                data_dict : dict
+                    Input in the :meth:`run_with_dict` format.
+                peak_locator : BasePeakLocator
+                    Peak locator applied to every event window.
+                trigger_channel : str, default=""
+                    Trigger channel name used when the peak locator support is
+                    ``PulseSupport(channel="default", ...)``.
+
+                Returns
+                -------
+                dict
+                    Nested dictionary structured as
+
+                        {
+                            "channel_name": {
+                                "Index": array of shape (n_events, max_number_of_peaks),
+                                "Height": ...,
+                                "Width": ...,   # if enabled
+                                "Area": ...,    # if enabled
+                            },
+                            ...
+                        }
+
+                    Row k holds the metrics of event k, with peak indices relative to
+                    the start of its window.
+            )pbdoc"
+        )
+        .def(
+            "run_with_acquisition_buffer",
+            [ureg](BaseDiscriminator &self, const std::shared_ptr<utils::AcquisitionBuffer> &buffer) {
+                self.add_acquisition_buffer(buffer);
+
+                std::vector<std::string> channel_names;
+                channel_names.reserve(buffer->get_number_of_channels());
+
+                for (const std::string &channel_name : buffer->get_channel_names()) {
+                    if (channel_name != "Time") {
+                        channel_names.push_back(channel_name);
+                    }
+                }
+
+                if (channel_names.empty()) {
+                    throw std::runtime_error(
+                        "Acquisition buffer must contain at least one signal channel in addition to 'Time'."
+                    );
+                }
+
+                {
+                    py::gil_scoped_release release;
+                    self.run();
+                }
+
+                return build_segmented_output_dict(self, channel_names, ureg);
+            },
+            py::arg("buffer"),
+            R"pbdoc(
+                Run trigger detection on an acquisition buffer.
+
+                The discriminator views the buffer channels instead of copying
+                them. The buffer must hold a ``"Time"`` channel in seconds and
+                signal channels in volts.
+
+                Parameters
+                ----------
+                buffer : AcquisitionBuffer
+                    Acquisition buffer to segment.
+
+                Returns
+                -------
+                dict
+                    Flat dictionary in the format of :meth:`run_with_dict`.
+            )pbdoc"
+        )
         .def(
             "__repr__",
             [](const BaseDiscriminator& self) {
@@ -419,10 +750,36 @@ PYBIND11_MODULE(discriminator, module) {
         .def(
             "run",
             &FixedWindow::run,
+            py::call_guard<py::gil_scoped_release>(),
             R"pbdoc(
                 Execute fixed window trigger detection.
             )pbdoc"
         )
+        .def(
+            "get_segment_matrix",
+            [](py::object self, const std::string &channel_name) {
+                py::object ureg = get_shared_ureg();
+
+                return build_segment_matrix(self.cast<FixedWindow &>().trigger, channel_name) * ureg.attr("volt");
+            },
+            py::arg("channel_name"),
+            R"pbdoc(
+                Segments of the last run for one channel, as a dense matrix.
+
+                Every fixed window has ``pre_buffer + post_buffer + 1`` samples, so
+                the segments are viewed as one row per event, without a copy.
+
+                Parameters
+                ----------
+                channel_name : str
+                    Name of the channel to retrieve.
+
+                Returns
+                -------
+                pint.Quantity
+                    Array of shape (n_events, pre_buffer + post_buffer + 1) in volt.
+            )pbdoc"
+        )
         .def_property(
             "threshold",
             [](FixedWindow &self) -> Threshold & {
@@ -528,6 +885,7 @@ PYBIND11_MODULE(discriminator, module) {
         .def(
             "run",
             &DynamicWindow::run,
+            py::call_guard<py::gil_scoped_release>(),
             R"pbdoc(
                 Execute dynamic window trigger detection.
             )pbdoc"
@@ -659,6 +1017,7 @@ PYBIND11_MODULE(discriminator, module) {
         .def(
             "run",
             &DoubleThreshold::run,
+            py::call_guard<py::gil_scoped_release>(),
             R"pbdoc(
                 Execute double threshold trigger detection.
             )pbdoc"
@@ -790,4 +1149,135 @@ PYBIND11_MODULE(discriminator, module) {
                 return output;
             }
         );
+
+    py::class_<OnlineDiscriminator>(
+        module,
+        "OnlineDiscriminator",
+        R"pbdoc(
+            Streaming mode of a FixedWindow, DynamicWindow or DoubleThreshold detector.
+
+            The acquisition is fed block by block with ``add_block``. Events open
+            at the end of a block are carried over to the next one, and every
+            completed window is queued until ``pop_events`` is called. Only the
+            last ``pre_buffer`` samples and the event being collected are kept, so
+            memory does not grow with the length of the acquisition.
+
+            The windows are those the detector extracts from the whole trace.
+            Symbolic thresholds such as ``"3sigma"`` are resolved on the first block.
+
+            Parameters
+            ----------
+            discriminator : FixedWindow or DynamicWindow or DoubleThreshold
+                Detector whose configuration is streamed. Later changes to it are not seen.
+        )pbdoc"
+    )
+        .def(py::init<const FixedWindow &>(), py::arg("discriminator"))
+        .def(py::init<const DynamicWindow &>(), py::arg("discriminator"))
+        .def(py::init<const DoubleThreshold &>(), py::arg("discriminator"))
+        .def(
+            "add_block",
+            [](OnlineDiscriminator &self, const py::dict &data_dict) {
+                if (!data_dict.contains("Time")) {
+                    throw std::runtime_error("Input dictionary must contain a 'Time' key.");
+                }
+
+                const contiguous_array<double> time =
+                    quantity_to_contiguous_array<double>(data_dict["Time"], "second");
+
+                // The arrays own the samples viewed by the spans until the block is processed.
+                std::vector<contiguous_array<double>> signal_arrays;
+                std::map<std::string, std::span<const double>> signals;
+
+                signal_arrays.reserve(data_dict.size());
+
+                for (const auto &item : data_dict) {
+                    const std::string key =
+                        py::reinterpret_borrow<py::object>(item.first).cast<std::string>();
+
+                    if (key == "Time") {
+                        continue;
+                    }
+
+                    signal_arrays.push_back(quantity_to_contiguous_array<double>(item.second, "volt"));
+                    signals[key] = array_to_span(signal_arrays.back());
+                }
+
+                {
+                    py::gil_scoped_release release;
+                    self.add_block(array_to_span(time), signals);
+                }
+            },
+            py::arg("data_dict"),
+            R"pbdoc(
+                Scan the next block of the acquisition.
+
+                Parameters
+                ----------
+                data_dict : dict
+                    Block in the ``run_with_dict`` input format: a ``"Time"`` quantity
+                    convertible to seconds and one quantity convertible to volts per
+                    signal channel. Every block must hold the channels of the first one.
+            )pbdoc"
+        )
+        .def(
+            "finish",
+            &OnlineDiscriminator::finish,
+            R"pbdoc(
+                End the acquisition.
+
+                Events still open are closed at the last sample and queued. The next
+                block starts a new acquisition.
+            )pbdoc"
+        )
+        .def(
+            "pop_events",
+            [ureg](OnlineDiscriminator &self) {
+                py::list events;
+
+                for (TriggeredEvent &event : self.pop_events()) {
+                    py::dict event_dict;
+
+                    event_dict["segment_id"] = event.segment_id;
+                    event_dict["start_index"] = event.start_index;
+                    event_dict["Time"] = vector_to_numpy_without_copy(std::move(event.time)) * ureg.attr("second");
+
+                    for (auto &[channel_name, samples] : event.signals) {
+                        event_dict[py::str(channel_name)] =
+                            vector_to_numpy_without_copy(std::move(samples)) * ureg.attr("volt");
+                    }
+
+                    events.append(std::move(event_dict));
+                }
+
+                return events;
+            },
+            R"pbdoc(
+                Take the events completed so far.
+
+                Returns
+                -------
+                list of dict
+                    One dictionary per event, in acquisition order, holding its
+                    ``"segment_id"``, the acquisition index ``"start_index"`` of its first
+                    sample, its ``"Time"`` samples in seconds and one array in volts per
+                    signal channel.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "number_of_samples",
+            &OnlineDiscriminator::get_number_of_samples,
+            R"pbdoc(
+                Number of samples fed since the start of the acquisition.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "number_of_queued_events",
+            &OnlineDiscriminator::get_number_of_queued_events,
+            R"pbdoc(
+                Number of completed events waiting to be popped.
+            )pbdoc"
+        );
+
+    register_profiling_functions(module);
+    register_threading_functions(module);
 }
@@ -0,0 +1,89 @@
+#include "noise_floor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+double compute_median_in_place(std::vector<double> &values) {
+    const size_t middle_index = values.size() / 2;
+
+    std::nth_element(values.begin(), values.begin() + middle_index, values.end());
+
+    const double upper_middle_value = values[middle_index];
+
+    if (values.size() % 2 != 0)
+        return upper_middle_value;
+
+    // The lower middle value is the largest of the lower half left by nth_element.
+    const double lower_middle_value = *std::max_element(values.begin(), values.begin() + middle_index);
+
+    return 0.5 * (lower_middle_value + upper_middle_value);
+}
+
+}  // namespace
+
+
+void NoiseFloorEstimator::add_samples(std::span<const double> samples) {
+    // Kept samples sit at the stream positions that are multiples of the stride.
+    size_t index = (this->stride - this->number_of_samples % this->stride) % this->stride;
+
+    while (index < samples.size()) {
+        if (this->capacity != 0 && this->kept_samples.size() >= this->capacity) {
+            this->halve_kept_samples();
+
+            if ((this->number_of_samples + index) % this->stride != 0) {
+                index += this->stride / 2;
+                continue;
+            }
+        }
+
+        this->kept_samples.push_back(samples[index]);
+        index += this->stride;
+    }
+
+    this->number_of_samples += samples.size();
+}
+
+
+void NoiseFloorEstimator::clear() {
+    this->stride = 1;
+    this->number_of_samples = 0;
+    this->kept_samples.clear();
+}
+
+
+void NoiseFloorEstimator::halve_kept_samples() {
+    const size_t kept_size = (this->kept_samples.size() + 1) / 2;
+
+    for (size_t index = 1; index < kept_size; ++index)
+        this->kept_samples[index] = this->kept_samples[2 * index];
+
+    this->kept_samples.resize(kept_size);
+    this->stride *= 2;
+}
+
+
+NoiseFloor NoiseFloorEstimator::estimate() const {
+    std::vector<double> values;
+    values.reserve(this->kept_samples.size());
+
+    for (const double value : this->kept_samples)
+        if (!std::isnan(value))
+            values.push_back(value);
+
+    if (values.empty())
+        throw std::runtime_error("Cannot estimate the noise floor of an empty signal.");
+
+    NoiseFloor noise_floor;
+    noise_floor.median = compute_median_in_place(values);
+
+    for (double &value : values)
+        value = std::abs(value - noise_floor.median);
+
+    noise_floor.sigma = compute_median_in_place(values) / 0.6745;
+
+    return noise_floor;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+
+/**
+ * @brief Robust location and spread of a signal.
+ */
+struct NoiseFloor {
+    /// Median of the samples.
+    double median = 0.0;
+
+    /// MAD based estimate of the standard deviation, median(|x - median(x)|) / 0.6745.
+    double sigma = 0.0;
+};
+
+
+/**
+ * @brief Streaming estimator of the median and MAD based sigma of a signal.
+ *
+ * Samples are fed chunk by chunk with `add_samples`. The estimator keeps every
+ * `stride`-th sample of the stream, starting at the first one. When `capacity`
+ * samples are kept, every other one is dropped and the stride doubles, so the
+ * memory stays bounded by `capacity` and the kept samples remain evenly spread
+ * over the whole stream.
+ *
+ * Streams of at most `capacity` samples are kept entirely and the estimate is
+ * exact. Longer streams are estimated from between capacity / 2 and capacity
+ * evenly strided samples, which sets the accuracy. NaN samples are ignored.
+ */
+class NoiseFloorEstimator {
+public:
+    /// Default number of kept samples.
+    static constexpr size_t default_capacity = size_t{1} << 17;
+
+    /**
+     * @param capacity Maximum number of kept samples. 0 keeps every sample.
+     */
+    explicit NoiseFloorEstimator(const size_t capacity = default_capacity)
+        : capacity(capacity) {}
+
+    /**
+     * @brief Feed the next chunk of the stream.
+     *
+     * @param samples Samples following those already fed.
+     */
+    void add_samples(std::span<const double> samples);
+
+    /**
+     * @brief Forget every sample fed so far.
+     */
+    void clear();
+
+    /// Number of samples fed so far, NaN included.
+    size_t get_number_of_samples() const { return this->number_of_samples; }
+
+    /// Distance in samples between two kept samples.
+    size_t get_stride() const { return this->stride; }
+
+    /**
+     * @brief Estimate the noise floor of the samples fed so far.
+     *
+     * @return Median and MAD based sigma of the kept samples.
+     *
+     * @throws std::runtime_error If no sample other than NaN was fed.
+     */
+    NoiseFloor estimate() const;
+
+private:
+    size_t capacity;
+    size_t stride = 1;
+    size_t number_of_samples = 0;
+    std::vector<double> kept_samples;
+
+    void halve_kept_samples();
+};
@@ -0,0 +1,430 @@
+#include "online_discriminator.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+
+OnlineDiscriminator::OnlineDiscriminator(const FixedWindow &discriminator)
+    : trigger_channel(discriminator.trigger_channel),
+      pre_buffer(discriminator.pre_buffer),
+      post_buffer(discriminator.post_buffer),
+      max_triggers(discriminator.max_triggers),
+      noise_floor_sample_capacity(discriminator.noise_floor_sample_capacity),
+      threshold(discriminator.threshold),
+      fixed_window(true) {}
+
+
+OnlineDiscriminator::OnlineDiscriminator(const DynamicWindow &discriminator)
+    : trigger_channel(discriminator.trigger_channel),
+      pre_buffer(discriminator.pre_buffer),
+      post_buffer(discriminator.post_buffer),
+      max_triggers(discriminator.max_triggers),
+      noise_floor_sample_capacity(discriminator.noise_floor_sample_capacity),
+      threshold(discriminator.threshold) {}
+
+
+OnlineDiscriminator::OnlineDiscriminator(const DoubleThreshold &discriminator)
+    : trigger_channel(discriminator.trigger_channel),
+      pre_buffer(discriminator.pre_buffer),
+      post_buffer(discriminator.post_buffer),
+      max_triggers(discriminator.max_triggers),
+      noise_floor_sample_capacity(discriminator.noise_floor_sample_capacity),
+      threshold(discriminator.threshold),
+      lower_threshold(discriminator.lower_threshold),
+      min_window_duration(discriminator.debounce_enabled ? discriminator.min_window_duration : -1) {}
+
+
+void OnlineDiscriminator::add_block(
+    std::span<const double> time,
+    const std::map<std::string, std::span<const double>> &signals
+) {
+    // The stream starts at the first non empty block, which the thresholds are resolved on.
+    if (this->signal_names.empty()) {
+        if (time.empty()) {
+            return;
+        }
+
+        this->start_stream(signals);
+    }
+
+    if (signals.size() != this->signal_names.size()) {
+        throw std::runtime_error(
+            "Every block must contain the signal channels of the first block."
+        );
+    }
+
+    std::vector<std::span<const double>> block = {time};
+
+    for (const std::string &signal_name : this->signal_names) {
+        const auto signal_iterator = signals.find(signal_name);
+
+        if (signal_iterator == signals.end()) {
+            throw std::runtime_error(
+                "Signal channel '" + signal_name + "' is missing from the block."
+            );
+        }
+
+        if (signal_iterator->second.size() != time.size()) {
+            throw std::runtime_error(
+                "Signal channel '" + signal_name + "' does not have as many samples as the time axis."
+            );
+        }
+
+        block.push_back(signal_iterator->second);
+    }
+
+    const std::span<const double> trigger_signal = block[this->trigger_channel_index];
+
+    for (size_t local_index = 0; local_index < trigger_signal.size(); ++local_index) {
+        const size_t index = this->number_of_samples + local_index;
+        const double sample = trigger_signal[local_index];
+
+        // NaN compares false, so a NaN never takes part in a rising edge, as in find_threshold_crossings.
+        const bool is_rising_edge =
+            this->previous_sample <= this->resolved_upper_threshold &&
+            sample > this->resolved_upper_threshold;
+
+        this->previous_sample = sample;
+
+        if (this->fixed_window) {
+            this->process_fixed_window_sample(index, sample, is_rising_edge);
+        } else {
+            this->process_dynamic_window_sample(index, sample, is_rising_edge);
+        }
+
+        if (this->collecting && this->event_accepted && this->event_end <= index) {
+            this->collect(block, this->event_end + 1);
+            this->emit_event();
+        }
+    }
+
+    const size_t block_end = this->number_of_samples + time.size();
+
+    if (this->collecting) {
+        this->collect(block, block_end);
+    }
+
+    this->update_history(block);
+    this->number_of_samples = block_end;
+}
+
+
+void OnlineDiscriminator::finish() {
+    const size_t stream_end = this->number_of_samples;
+
+    if (this->phase == Phase::UpperRun) {
+        if (
+            this->min_window_duration != -1 &&
+            stream_end - this->rising_index < static_cast<size_t>(this->min_window_duration)
+        ) {
+            this->discard_candidate();
+        } else {
+            this->close_candidate(stream_end);
+        }
+    } else if (this->phase == Phase::LowerRun) {
+        this->close_candidate(stream_end);
+    }
+
+    // Every sample of the stream has been collected; only windows reaching past its end are left.
+    if (this->collecting && this->event_accepted && !this->fixed_window) {
+        this->event_end = std::min(this->event_end, stream_end - 1);
+        this->emit_event();
+    }
+
+    this->reset_stream();
+}
+
+
+std::vector<TriggeredEvent> OnlineDiscriminator::pop_events() {
+    std::vector<TriggeredEvent> events(
+        std::make_move_iterator(this->completed_events.begin()),
+        std::make_move_iterator(this->completed_events.end())
+    );
+
+    this->completed_events.clear();
+
+    return events;
+}
+
+
+void OnlineDiscriminator::reset_stream() {
+    this->signal_names.clear();
+    this->history.clear();
+    this->event_samples.clear();
+    this->number_of_samples = 0;
+    this->previous_sample = std::nan("");
+    this->phase = Phase::Idle;
+    this->resume_index = 0;
+    this->last_end = -1;
+    this->number_of_accepted_events = 0;
+    this->number_of_emitted_events = 0;
+    this->collecting = false;
+    this->thresholds_resolved = false;
+}
+
+
+void OnlineDiscriminator::start_stream(
+    const std::map<std::string, std::span<const double>> &signals
+) {
+    if (!this->threshold.is_defined()) {
+        throw std::runtime_error(
+            "OnlineDiscriminator threshold must be set before adding blocks."
+        );
+    }
+
+    const auto trigger_iterator = signals.find(this->trigger_channel);
+
+    if (trigger_iterator == signals.end()) {
+        throw std::runtime_error(
+            "Trigger detector '" + this->trigger_channel + "' was not found in the block."
+        );
+    }
+
+    for (const auto &[signal_name, signal] : signals) {
+        if (signal_name == this->trigger_channel) {
+            this->trigger_channel_index = this->signal_names.size() + 1;
+        }
+
+        this->signal_names.push_back(signal_name);
+    }
+
+    this->history.assign(this->signal_names.size() + 1, {});
+    this->event_samples.assign(this->signal_names.size() + 1, {});
+
+    if (!this->thresholds_resolved) {
+        this->resolve_thresholds(trigger_iterator->second);
+    }
+}
+
+
+void OnlineDiscriminator::resolve_thresholds_on(std::span<const double> trigger_signal) {
+    if (!this->threshold.is_defined()) {
+        throw std::runtime_error(
+            "OnlineDiscriminator threshold must be set before adding blocks."
+        );
+    }
+
+    if (!this->signal_names.empty()) {
+        throw std::runtime_error(
+            "Thresholds cannot be resolved while a stream is in progress."
+        );
+    }
+
+    this->resolve_thresholds(trigger_signal);
+    this->thresholds_resolved = true;
+}
+
+
+void OnlineDiscriminator::resolve_thresholds(std::span<const double> trigger_signal) {
+    const auto resolve = [&](const Threshold &threshold) {
+        if (threshold.has_numeric()) {
+            return threshold.get_numeric();
+        }
+
+        const double number_of_sigma = parse_sigma_multiplier(threshold.get_symbolic());
+
+        NoiseFloorEstimator estimator(this->noise_floor_sample_capacity);
+        estimator.add_samples(trigger_signal);
+
+        const NoiseFloor noise_floor = estimator.estimate();
+
+        return noise_floor.median + number_of_sigma * noise_floor.sigma;
+    };
+
+    this->resolved_upper_threshold = resolve(this->threshold);
+
+    this->resolved_lower_threshold = this->lower_threshold.is_defined()
+        ? resolve(this->lower_threshold)
+        : this->resolved_upper_threshold;
+}
+
+
+bool OnlineDiscriminator::accepts_more_events() const {
+    return
+        this->max_triggers <= 0 ||
+        this->number_of_accepted_events < static_cast<size_t>(this->max_triggers);
+}
+
+
+void OnlineDiscriminator::process_fixed_window_sample(const size_t index, const double, const bool is_rising_edge) {
+    if (!is_rising_edge || !this->accepts_more_events() || index < this->pre_buffer) {
+        return;
+    }
+
+    const size_t start = index - this->pre_buffer;
+
+    // A window ending past the stream is dropped at finish(), as FixedWindow drops it.
+    if (static_cast<long long>(start) > this->last_end) {
+        this->open_candidate(start);
+        this->accept_event(index + this->post_buffer);
+    }
+}
+
+
+void OnlineDiscriminator::process_dynamic_window_sample(const size_t index, const double sample, const bool is_rising_edge) {
+    switch (this->phase) {
+        case Phase::Idle: {
+            if (!is_rising_edge || index < this->resume_index || !this->accepts_more_events()) {
+                return;
+            }
+
+            const size_t start = index >= this->pre_buffer ? index - this->pre_buffer : 0;
+
+            // A candidate overlapping the last accepted window is followed without collecting samples.
+            if (static_cast<long long>(start) > this->last_end) {
+                this->open_candidate(start);
+            }
+
+            this->rising_index = index;
+            this->phase = Phase::UpperRun;
+            [[fallthrough]];
+        }
+
+        case Phase::UpperRun: {
+            if (sample > this->resolved_upper_threshold) {
+                // With debouncing the upper run is only followed for min_window_duration samples, and at least one.
+                if (
+                    this->min_window_duration != -1 &&
+                    index - this->rising_index + 1 >= std::max<size_t>(static_cast<size_t>(this->min_window_duration), 1)
+                ) {
+                    this->phase = Phase::LowerRun;
+                }
+
+                return;
+            }
+
+            if (
+                this->min_window_duration != -1 &&
+                index - this->rising_index < static_cast<size_t>(this->min_window_duration)
+            ) {
+                this->discard_candidate();
+                this->resume_index = index + 1;
+                this->phase = Phase::Idle;
+                return;
+            }
+
+            this->phase = Phase::LowerRun;
+            [[fallthrough]];
+        }
+
+        case Phase::LowerRun: {
+            if (sample > this->resolved_lower_threshold) {
+                return;
+            }
+
+            this->close_candidate(index);
+            return;
+        }
+    }
+}
+
+
+void OnlineDiscriminator::open_candidate(const size_t start) {
+    this->collecting = true;
+    this->event_accepted = false;
+    this->event_start = start;
+    this->collected_until = start;
+
+    for (std::vector<double> &samples : this->event_samples) {
+        samples.clear();
+    }
+}
+
+
+void OnlineDiscriminator::discard_candidate() {
+    if (!this->event_accepted) {
+        this->collecting = false;
+    }
+}
+
+
+void OnlineDiscriminator::close_candidate(const size_t lower_run_end) {
+    this->resume_index = lower_run_end + 1;
+    this->phase = Phase::Idle;
+
+    // Without a candidate, the run overlapped the last accepted window, which may still be collecting.
+    if (this->collecting && !this->event_accepted) {
+        this->accept_event(lower_run_end - 1 + this->post_buffer);
+    }
+}
+
+
+void OnlineDiscriminator::accept_event(const size_t end) {
+    this->event_accepted = true;
+    this->event_end = end;
+    this->last_end = static_cast<long long>(end);
+    ++this->number_of_accepted_events;
+}
+
+
+void OnlineDiscriminator::collect(const std::vector<std::span<const double>> &block, const size_t until) {
+    const size_t block_begin = this->number_of_samples;
+
+    for (size_t channel = 0; channel < block.size(); ++channel) {
+        const std::vector<double> &channel_history = this->history[channel];
+        std::vector<double> &samples = this->event_samples[channel];
+
+        const size_t history_begin = block_begin - channel_history.size();
+        size_t from = this->collected_until;
+
+        if (from < block_begin) {
+            const size_t history_until = std::min(until, block_begin);
+
+            samples.insert(
+                samples.end(),
+                channel_history.begin() + static_cast<std::ptrdiff_t>(from - history_begin),
+                channel_history.begin() + static_cast<std::ptrdiff_t>(history_until - history_begin)
+            );
+
+            from = history_until;
+        }
+
+        if (from < until) {
+            samples.insert(
+                samples.end(),
+                block[channel].begin() + static_cast<std::ptrdiff_t>(from - block_begin),
+                block[channel].begin() + static_cast<std::ptrdiff_t>(until - block_begin)
+            );
+        }
+    }
+
+    this->collected_until = until;
+}
+
+
+void OnlineDiscriminator::emit_event() {
+    TriggeredEvent event;
+    event.segment_id = this->number_of_emitted_events++;
+    event.start_index = this->event_start;
+    event.time = std::move(this->event_samples[0]);
+
+    for (size_t signal = 0; signal < this->signal_names.size(); ++signal) {
+        event.signals[this->signal_names[signal]] = std::move(this->event_samples[signal + 1]);
+    }
+
+    this->completed_events.push_back(std::move(event));
+    this->collecting = false;
+}
+
+
+void OnlineDiscriminator::update_history(const std::vector<std::span<const double>> &block) {
+    for (size_t channel = 0; channel < block.size(); ++channel) {
+        std::vector<double> &channel_history = this->history[channel];
+        const std::span<const double> samples = block[channel];
+
+        if (samples.size() >= this->pre_buffer) {
+            channel_history.assign(samples.end() - static_cast<std::ptrdiff_t>(this->pre_buffer), samples.end());
+            continue;
+        }
+
+        channel_history.insert(channel_history.end(), samples.begin(), samples.end());
+
+        if (channel_history.size() > this->pre_buffer) {
+            channel_history.erase(
+                channel_history.begin(),
+                channel_history.end() - static_cast<std::ptrdiff_t>(this->pre_buffer)
+            );
+        }
+    }
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <cmath>
+#include <deque>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "discriminator.h"
+
+
+/**
+ * @brief Event window completed by an OnlineDiscriminator.
+ */
+struct TriggeredEvent {
+    /// Index of the event among the events accepted in the stream.
+    size_t segment_id = 0;
+
+    /// Stream index of the first sample of the window.
+    size_t start_index = 0;
+
+    /// Time stamps of the window samples.
+    std::vector<double> time;
+
+    /// Window samples of every signal channel, keyed by channel name.
+    std::map<std::string, std::vector<double>> signals;
+};
+
+
+/**
+ * @brief Streaming counterpart of the FixedWindow, DynamicWindow and DoubleThreshold detectors.
+ *
+ * The acquisition is fed as consecutive blocks with `add_block`. Each block is
+ * scanned once, an event open at the end of a block is carried over to the next
+ * one, and every window is queued as a TriggeredEvent, in stream order, as soon
+ * as its last sample arrives. Only the last `pre_buffer` samples of each channel
+ * and the samples of the event being collected are kept, so memory is bounded by
+ * the block and window sizes rather than by the length of the run.
+ *
+ * Feeding a trace in blocks of any size yields the windows the batch detector
+ * extracts from the whole trace. The only difference is that symbolic thresholds
+ * such as `"3sigma"` are resolved on the trigger channel of the first block, as
+ * later samples are not known yet, unless `resolve_thresholds_on` resolved them
+ * beforehand on samples that do not depend on the block size.
+ */
+class OnlineDiscriminator {
+public:
+    /// Name of the signal channel used to detect trigger events.
+    std::string trigger_channel;
+
+    /// Number of samples to include before the detected trigger position.
+    size_t pre_buffer = 0;
+
+    /// Number of samples to include after the detected trigger position.
+    size_t post_buffer = 0;
+
+    /// Maximum number of accepted triggers. A value of -1 means no limit.
+    int max_triggers = -1;
+
+    /// Number of samples used to resolve sigma thresholds. A value of 0 uses every sample.
+    size_t noise_floor_sample_capacity = NoiseFloorEstimator::default_capacity;
+
+    /// Threshold starting an event.
+    Threshold threshold;
+
+    /// Threshold ending an event. When undefined, the event ends below `threshold`.
+    Threshold lower_threshold;
+
+    /// Minimum number of samples above `threshold` for an event to be accepted. A value of -1 disables this constraint.
+    int min_window_duration = -1;
+
+    /// Whether windows have a fixed width around the trigger position, as for FixedWindow.
+    bool fixed_window = false;
+
+    double resolved_upper_threshold = std::nan("");
+    double resolved_lower_threshold = std::nan("");
+
+    /**
+     * @brief Stream the detection of a FixedWindow detector.
+     */
+    explicit OnlineDiscriminator(const FixedWindow &discriminator);
+
+    /**
+     * @brief Stream the detection of a DynamicWindow detector.
+     */
+    explicit OnlineDiscriminator(const DynamicWindow &discriminator);
+
+    /**
+     * @brief Stream the detection of a DoubleThreshold detector.
+     */
+    explicit OnlineDiscriminator(const DoubleThreshold &discriminator);
+
+    /**
+     * @brief Scan the next block of the acquisition.
+     *
+     * The first non empty block fixes the set of signal channels and resolves the thresholds.
+     *
+     * @param time
+     *     Time stamps of the block samples.
+     * @param signals
+     *     Samples of every signal channel, keyed by channel name, each as long as `time`.
+     *
+     * @throws std::runtime_error
+     *     If the channels differ from those of the first block, have different
+     *     lengths, or do not include `trigger_channel`.
+     */
+    void add_block(
+        std::span<const double> time,
+        const std::map<std::string, std::span<const double>> &signals
+    );
+
+    /**
+     * @brief Resolve the thresholds of the next stream on given trigger samples.
+     *
+     * The next stream keeps these thresholds instead of resolving them on its
+     * first block. Numeric thresholds are taken as is.
+     *
+     * @param trigger_signal
+     *     Samples of the trigger channel, e.g. the first samples of the acquisition.
+     *
+     * @throws std::runtime_error
+     *     If the threshold is not set, or if a stream is in progress.
+     */
+    void resolve_thresholds_on(std::span<const double> trigger_signal);
+
+    /**
+     * @brief End the stream.
+     *
+     * Events still open are closed at the last sample, as the batch detectors do at
+     * the end of the trace, and queued. The stream state is then reset, so the
+     * next block starts a new acquisition. Queued events are kept.
+     */
+    void finish();
+
+    /**
+     * @brief Take the events completed so far, in stream order.
+     */
+    std::vector<TriggeredEvent> pop_events();
+
+    /// Number of completed events waiting in the queue.
+    size_t get_number_of_queued_events() const { return this->completed_events.size(); }
+
+    /// Number of samples fed since the start of the stream.
+    size_t get_number_of_samples() const { return this->number_of_samples; }
+
+private:
+    enum class Phase {
+        Idle,       // Waiting for a rising edge of the upper threshold.
+        UpperRun,   // Following the run above the upper threshold.
+        LowerRun    // Following the run above the lower threshold.
+    };
+
+    // Channel 0 holds the time stamps, the others the signals in name order.
+    std::vector<std::string> signal_names;
+    bool thresholds_resolved = false;
+    size_t trigger_channel_index = 0;
+
+    // Last samples of each channel before the current block, at most pre_buffer of them.
+    std::vector<std::vector<double>> history;
+
+    size_t number_of_samples = 0;
+    double previous_sample = std::nan("");
+
+    Phase phase = Phase::Idle;
+    size_t rising_index = 0;
+    size_t resume_index = 0;
+    long long last_end = -1;
+    size_t number_of_accepted_events = 0;
+    size_t number_of_emitted_events = 0;
+
+    // Event whose samples are being collected: an accepted window waiting for its
+    // last sample, or a candidate still following its runs.
+    bool collecting = false;
+    bool event_accepted = false;
+    size_t event_start = 0;
+    size_t event_end = 0;
+    size_t collected_until = 0;
+    std::vector<std::vector<double>> event_samples;
+
+    std::deque<TriggeredEvent> completed_events;
+
+    void reset_stream();
+    void start_stream(const std::map<std::string, std::span<const double>> &signals);
+    void resolve_thresholds(std::span<const double> trigger_signal);
+    bool accepts_more_events() const;
+
+    void process_fixed_window_sample(size_t index, double sample, bool is_rising_edge);
+    void process_dynamic_window_sample(size_t index, double sample, bool is_rising_edge);
+
+    void open_candidate(size_t start);
+    void discard_candidate();
+    void close_candidate(size_t lower_run_end);
+    void accept_event(size_t end);
+
+    void collect(const std::vector<std::span<const double>> &block, size_t until);
+    void emit_event();
+    void update_history(const std::vector<std::span<const double>> &block);
+};
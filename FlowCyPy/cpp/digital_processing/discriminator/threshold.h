@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <optional>
 #include <string>
@@ -142,3 +144,62 @@ public:
         return this->symbolic_value_;
     }
 };
+
+
+/**
+ * @brief Parse the multiplier of a symbolic sigma threshold.
+ *
+ * Supported expressions follow the pattern `"Nsigma"`, for example `"3sigma"`
+ * or `"4.5 sigma"`. White space is ignored.
+ *
+ * @param threshold_string
+ *     Symbolic sigma threshold string.
+ *
+ * @return
+ *     The number of sigma N.
+ *
+ * @throws std::runtime_error
+ *     If the string does not follow the pattern.
+ */
+inline double parse_sigma_multiplier(const std::string &threshold_string) {
+    std::string compact_threshold_string = threshold_string;
+
+    compact_threshold_string.erase(
+        std::remove_if(
+            compact_threshold_string.begin(),
+            compact_threshold_string.end(),
+            [](unsigned char character) {
+                return std::isspace(character);
+            }
+        ),
+        compact_threshold_string.end()
+    );
+
+    const std::string sigma_suffix = "sigma";
+
+    if (
+        compact_threshold_string.size() <= sigma_suffix.size() ||
+        compact_threshold_string.substr(
+            compact_threshold_string.size() - sigma_suffix.size()
+        ) != sigma_suffix
+    ) {
+        throw std::runtime_error(
+            "Unknown threshold format: '" + threshold_string +
+            "'. Expected a numeric value or a string like '4sigma'."
+        );
+    }
+
+    const std::string sigma_multiplier_string =
+        compact_threshold_string.substr(
+            0,
+            compact_threshold_string.size() - sigma_suffix.size()
+        );
+
+    try {
+        return std::stod(sigma_multiplier_string);
+    } catch (...) {
+        throw std::runtime_error(
+            "Failed to parse sigma threshold from '" + threshold_string + "'."
+        );
+    }
+}
@@ -0,0 +1,149 @@
+#include "threshold_crossing.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+#include <utils/threading.h>
+
+namespace {
+
+constexpr size_t block_size = 64;
+
+// Multiple of the block size, so that only the last block of the signal is partial.
+constexpr size_t chunk_size = 1024 * block_size;
+
+void append_set_bits(uint64_t mask, const size_t offset, std::vector<size_t> &indices) {
+    while (mask != 0) {
+        indices.push_back(offset + static_cast<size_t>(std::countr_zero(mask)));
+        mask &= mask - 1;
+    }
+}
+
+void scan_chunk(
+    std::span<const double> signal,
+    const double threshold,
+    const bool find_falling_edges,
+    const size_t begin,
+    const size_t end,
+    ThresholdCrossings &crossings
+) {
+    // Comparison bits of the sample preceding the current block.
+    uint64_t previous_above = 0;
+    uint64_t previous_at_or_below = 0;
+
+    if (begin > 0) {
+        previous_above = signal[begin - 1] > threshold;
+        previous_at_or_below = signal[begin - 1] <= threshold;
+    }
+
+    for (size_t block_begin = begin; block_begin < end; block_begin += block_size) {
+        const size_t count = std::min(block_size, end - block_begin);
+        const double *values = signal.data() + block_begin;
+
+        // Counting is a plain vector reduction and settles the common uniform blocks.
+        size_t number_above = 0;
+        size_t number_at_or_below = 0;
+
+        #pragma omp simd reduction(+:number_above, number_at_or_below)
+        for (size_t offset = 0; offset < count; ++offset) {
+            number_above += values[offset] > threshold;
+            number_at_or_below += values[offset] <= threshold;
+        }
+
+        uint64_t above = 0;
+        uint64_t at_or_below = 0;
+
+        if (number_at_or_below == count) {
+            at_or_below = count == block_size ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+        } else if (number_above == count) {
+            above = count == block_size ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+        } else {
+            // Both masks are needed: NaN is neither above nor at or below the threshold.
+            for (size_t offset = 0; offset < count; ++offset) {
+                above |= static_cast<uint64_t>(values[offset] > threshold) << offset;
+                at_or_below |= static_cast<uint64_t>(values[offset] <= threshold) << offset;
+            }
+        }
+
+        const uint64_t rising = above & ((at_or_below << 1) | previous_at_or_below);
+        append_set_bits(rising, block_begin, crossings.rising_edges);
+
+        if (find_falling_edges) {
+            const uint64_t valid = count == block_size ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+            const uint64_t falling = ~above & ((above << 1) | previous_above) & valid;
+            append_set_bits(falling, block_begin, crossings.falling_edges);
+        }
+
+        previous_above = (above >> (count - 1)) & 1;
+        previous_at_or_below = (at_or_below >> (count - 1)) & 1;
+    }
+}
+
+std::vector<size_t> concatenate(const std::vector<ThresholdCrossings> &chunks, std::vector<size_t> ThresholdCrossings::*member) {
+    size_t total_size = 0;
+
+    for (const ThresholdCrossings &chunk : chunks)
+        total_size += (chunk.*member).size();
+
+    std::vector<size_t> indices;
+    indices.reserve(total_size);
+
+    for (const ThresholdCrossings &chunk : chunks)
+        indices.insert(indices.end(), (chunk.*member).begin(), (chunk.*member).end());
+
+    return indices;
+}
+
+}  // namespace
+
+
+ThresholdCrossings find_threshold_crossings(std::span<const double> signal, const double threshold, const bool find_falling_edges) {
+    const size_t number_of_chunks = (signal.size() + chunk_size - 1) / chunk_size;
+
+    if (number_of_chunks == 0)
+        return {};
+
+    std::vector<ThresholdCrossings> chunks(number_of_chunks);
+
+    #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(signal.size(), utils::ParallelComponent::discriminator))
+    for (long long chunk = 0; chunk < static_cast<long long>(number_of_chunks); ++chunk) {
+        const size_t begin = static_cast<size_t>(chunk) * chunk_size;
+        const size_t end = std::min(begin + chunk_size, signal.size());
+
+        scan_chunk(signal, threshold, find_falling_edges, begin, end, chunks[static_cast<size_t>(chunk)]);
+    }
+
+    if (number_of_chunks == 1)
+        return std::move(chunks.front());
+
+    ThresholdCrossings crossings;
+    crossings.rising_edges = concatenate(chunks, &ThresholdCrossings::rising_edges);
+
+    if (find_falling_edges)
+        crossings.falling_edges = concatenate(chunks, &ThresholdCrossings::falling_edges);
+
+    return crossings;
+}
+
+
+size_t find_run_end(std::span<const double> signal, const double threshold, const size_t index) {
+    size_t end_index = index;
+
+    while (end_index < signal.size() && signal[end_index] > threshold)
+        ++end_index;
+
+    return end_index;
+}
+
+
+size_t find_run_end(std::span<const double> signal, const double threshold, const std::vector<size_t> &falling_edges, const size_t index) {
+    if (index >= signal.size() || !(signal[index] > threshold))
+        return index;
+
+    // The run is above the threshold from index on, so it ends at the next falling edge.
+    const auto iterator = std::upper_bound(falling_edges.begin(), falling_edges.end(), index);
+
+    return iterator == falling_edges.end() ? signal.size() : *iterator;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+
+/**
+ * @brief Sample indices where a signal crosses a threshold, in increasing order.
+ *
+ * A rising edge is an index i >= 1 such that signal[i - 1] <= threshold and
+ * signal[i] > threshold. A falling edge is an index i >= 1 such that
+ * signal[i - 1] > threshold and signal[i] is not above the threshold, NaN
+ * counting as not above.
+ */
+struct ThresholdCrossings {
+    std::vector<size_t> rising_edges;
+    std::vector<size_t> falling_edges;
+};
+
+/**
+ * @brief Find the threshold crossings of a signal.
+ *
+ * The signal is cut into fixed size chunks scanned in parallel. Each chunk is
+ * read 64 samples at a time into comparison bit masks, and the edges are read
+ * off the masks. The chunk results are then concatenated in order, so the
+ * output does not depend on the number of threads and equals a serial scan.
+ *
+ * @param signal Signal to scan.
+ * @param threshold Threshold value.
+ * @param find_falling_edges Whether falling edges are collected as well.
+ *
+ * @return The rising edges and, when requested, the falling edges.
+ */
+ThresholdCrossings find_threshold_crossings(
+    std::span<const double> signal,
+    const double threshold,
+    const bool find_falling_edges
+);
+
+/**
+ * @brief Index of the first sample at or after index that is not above the threshold.
+ *
+ * Scans the signal from index on. Meant for runs followed from a few crossings only.
+ *
+ * @param signal Signal to scan.
+ * @param threshold Threshold value.
+ * @param index Index from which the run above the threshold is followed.
+ *
+ * @return The end of the run, or signal.size() if it extends to the end of the signal.
+ */
+size_t find_run_end(
+    std::span<const double> signal,
+    const double threshold,
+    const size_t index
+);
+
+/**
+ * @brief Index of the first sample at or after index that is not above the threshold.
+ *
+ * Looks the end of the run up in the falling edges rather than scanning the signal.
+ *
+ * @param signal Signal the falling edges were computed on.
+ * @param threshold Threshold the falling edges were computed for.
+ * @param falling_edges Falling edges returned by find_threshold_crossings.
+ * @param index Index from which the run above the threshold is followed.
+ *
+ * @return The end of the run, or signal.size() if it extends to the end of the signal.
+ */
+size_t find_run_end(
+    std::span<const double> signal,
+    const double threshold,
+    const std::vector<size_t> &falling_edges,
+    const size_t index
+);
@@ -1,59 +1,163 @@
 #include "trigger.h"
 
-void Trigger::add_signal(const std::string &signal_name, const std::vector<double> &signal_data) {
-    signal_map[signal_name] = signal_data;
+#include <algorithm>
+#include <stdexcept>
+
+#include <utils/threading.h>
+
+namespace {
+
+// Number of samples of [start, end] lying before the end of the time axis.
+size_t get_segment_length(const int start, const int end, const size_t number_of_samples) {
+    const int last = std::min(end, static_cast<int>(number_of_samples) - 1);
+    return last >= start ? static_cast<size_t>(last - start + 1) : 0;
+}
+
+}  // namespace
+
+void Trigger::add_signal(const std::string &signal_name, std::vector<double> signal_data) {
+    auto owner = std::make_shared<const std::vector<double>>(std::move(signal_data));
+
+    this->signal_map[signal_name] = std::span<const double>(*owner);
+    this->signal_owners[signal_name] = std::move(owner);
+}
+
+void Trigger::add_acquisition_buffer(const std::shared_ptr<const utils::AcquisitionBuffer> &buffer) {
+    for (const std::string &channel_name : buffer->get_channel_names()) {
+        const std::span<const double> samples = buffer->channel(channel_name);
+
+        if (channel_name == "Time") {
+            this->global_time.assign(samples.begin(), samples.end());
+            this->time_axis = utils::TimeAxis();
+            continue;
+        }
+
+        this->signal_map[channel_name] = samples;
+        this->signal_owners[channel_name] = buffer;
+    }
 }
 
 void Trigger::add_time(const std::vector<double> &time) {
     this->global_time = time;
+    this->time_axis = utils::TimeAxis();
+}
+
+void Trigger::add_time(const utils::TimeAxis &time_axis) {
+    this->global_time.clear();
+    this->time_axis = time_axis;
 }
 
 
 std::vector<double>& Trigger::get_segmented_signal(const std::string &detector_name) {
-    return this->signal_segments[detector_name];
+    return *this->get_segmented_signal_buffer(detector_name);
+}
+
+std::shared_ptr<std::vector<double>> Trigger::get_segmented_signal_buffer(const std::string &detector_name) {
+    std::shared_ptr<std::vector<double>> &buffer = this->signal_segments[detector_name];
+
+    if (!buffer)
+        buffer = std::make_shared<std::vector<double>>();
+
+    return buffer;
 }
 
 void Trigger::run_segmentation(const std::vector<std::pair<int, int>> &valid_triggers) {
     if (valid_triggers.empty())
         return ;
 
-    this->extract_time_and_id(valid_triggers);
+    const size_t number_of_samples = this->get_number_of_time_samples();
+    const size_t number_of_segments = valid_triggers.size();
 
-    for (auto const& [detector_name, signal] : this->signal_map)
-        this->extract_signal_segments(detector_name, signal, valid_triggers);
+    this->segment_offsets.assign(number_of_segments + 1, 0);
 
-}
+    for (size_t segment = 0; segment < number_of_segments; ++segment) {
+        const auto &[start, end] = valid_triggers[segment];
+        this->segment_offsets[segment + 1] = this->segment_offsets[segment] + get_segment_length(start, end, number_of_samples);
+    }
+
+    const size_t total_length = this->segment_offsets.back();
+
+    // Outputs are allocated up front, so the copies below only write disjoint ranges.
+    // They are new buffers rather than resized ones, as arrays may still view the
+    // previous ones. A uniform time axis is evaluated in place rather than copied.
+    const bool uses_time_axis = this->global_time.empty();
+
+    std::vector<std::span<const double>> sources;
+    std::vector<double*> destinations;
+
+    this->time_out = std::make_shared<std::vector<double>>(total_length);
+
+    if (!uses_time_axis) {
+        sources.push_back(this->global_time);
+        destinations.push_back(this->time_out->data());
+    }
 
+    for (auto const& [detector_name, signal] : this->signal_map) {
+        std::shared_ptr<std::vector<double>> &signal_segment = this->signal_segments[detector_name];
+        signal_segment = std::make_shared<std::vector<double>>(total_length);
 
-void Trigger::extract_signal_segments(const std::string &detector_name, const std::vector<double> &signal, const std::vector<std::pair<int, int>> &valid_triggers) {
-    std::vector<double> signal_segment;
+        sources.push_back(signal);
+        destinations.push_back(signal_segment->data());
+    }
+
+    const long long number_of_copies = static_cast<long long>(sources.size() * number_of_segments);
 
-    for (const auto &[start, end] : valid_triggers) {
-        for (int i = start; i <= end; ++i) {
+    #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(sources.size() * total_length, utils::ParallelComponent::discriminator))
+    for (long long copy = 0; copy < number_of_copies; ++copy) {
+        const size_t channel = static_cast<size_t>(copy) / number_of_segments;
+        const size_t segment = static_cast<size_t>(copy) % number_of_segments;
+        const size_t offset = this->segment_offsets[segment];
 
-            if (i >= static_cast<int>(this->global_time.size()))
-                break;
+        std::copy_n(
+            sources[channel].begin() + valid_triggers[segment].first,
+            this->segment_offsets[segment + 1] - offset,
+            destinations[channel] + offset
+        );
+    }
 
-            signal_segment.push_back(signal[i]);
+    if (uses_time_axis) {
+        #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(total_length, utils::ParallelComponent::discriminator))
+        for (long long segment = 0; segment < static_cast<long long>(number_of_segments); ++segment) {
+            const size_t offset = this->segment_offsets[segment];
+
+            this->time_axis.fill(
+                std::span<double>(this->time_out->data() + offset, this->segment_offsets[segment + 1] - offset),
+                static_cast<size_t>(valid_triggers[segment].first)
+            );
         }
     }
+}
 
-    this->signal_segments[detector_name] = signal_segment;
+
+std::vector<int> Trigger::get_segment_ids() const {
+    std::vector<int> segment_ids(this->time_out->size());
+
+    for (size_t segment = 0; segment < this->get_number_of_segments(); ++segment)
+        std::fill(
+            segment_ids.begin() + this->segment_offsets[segment],
+            segment_ids.begin() + this->segment_offsets[segment + 1],
+            static_cast<int>(segment)
+        );
+
+    return segment_ids;
 }
 
 
-void Trigger::extract_time_and_id(const std::vector<std::pair<int, int>> &valid_triggers) {
+size_t Trigger::get_uniform_segment_length() const {
+    const size_t number_of_segments = this->get_number_of_segments();
 
-    size_t segment_id = 0;
-    for (const auto &[start, end] : valid_triggers) {
-        for (int i = start; i <= end; ++i) {
+    if (number_of_segments == 0)
+        return 0;
 
-            if (i >= static_cast<int>(this->global_time.size()))
-                break;
+    const size_t segment_length = this->segment_offsets[1];
 
-            this->time_out.push_back(this->global_time[i]);
-            this->segment_ids_out.push_back(segment_id);
+    for (size_t segment = 2; segment <= number_of_segments; ++segment) {
+        if (this->segment_offsets[segment] != segment * segment_length) {
+            throw std::runtime_error(
+                "Segments do not all have the same length and cannot be laid out as a matrix."
+            );
         }
-        segment_id++;
     }
+
+    return segment_length;
 }
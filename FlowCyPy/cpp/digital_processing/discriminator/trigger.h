@@ -3,17 +3,31 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
+#include <span>
+
+#include <utils/acquisition_buffer.h>
+#include <utils/time_axis.h>
 
 // Represents a single trigger event, including its source signal and extracted segments.
 struct Trigger {
-    std::map<std::string, std::vector<double>> signal_map; // Map of signal names to their data
+    // Non-owning views of the input signals, keyed by signal name, and the storage
+    // keeping each view alive. Owners are shared, so copies of a Trigger view the
+    // same samples.
+    std::map<std::string, std::span<const double>> signal_map;
+    std::map<std::string, std::shared_ptr<const void>> signal_owners;
 
 
-    // Output vectors filled after processing:
-    std::map<std::string, std::vector<double>> signal_segments;
+    // Output buffers filled after processing. Segments are stored back to back, and
+    // segment k spans [segment_offsets[k], segment_offsets[k + 1]) of time_out and of
+    // every channel of signal_segments. Each segmentation allocates new buffers, so
+    // arrays sharing those of a previous run, e.g. NumPy views, keep their samples.
+    std::map<std::string, std::shared_ptr<std::vector<double>>> signal_segments;
     std::vector<double> global_time; // Global time vector used for all signal operations
-    std::vector<double> time_out;      // Time stamps corresponding to each segment sample
-    std::vector<int> segment_ids_out;  // Mapping of sample indices to segment IDs
+    utils::TimeAxis time_axis;         // Uniform time axis, used when global_time is empty
+    // Time stamps corresponding to each segment sample
+    std::shared_ptr<std::vector<double>> time_out = std::make_shared<std::vector<double>>();
+    std::vector<size_t> segment_offsets;  // Segment boundaries, one more than the number of segments
 
     Trigger() = default;
 
@@ -22,17 +36,25 @@ struct Trigger {
         // signal_map.clear();
         signal_segments.clear();
         // global_time.clear();
-        time_out.clear();
-        segment_ids_out.clear();
+        time_out = std::make_shared<std::vector<double>>();
+        segment_offsets.clear();
     }
 
     /**
      * @brief Add a signal to the trigger system.
      * @param signal_name Name of the signal to add.
-     * @param signal_data 1D vector of signal values.
+     * @param signal_data 1D vector of signal values, moved into the trigger.
      * This adds a new signal to the trigger system, which can be processed later.
      */
-    void add_signal(const std::string &signal_name, const std::vector<double> &signal_data);
+    void add_signal(const std::string &signal_name, std::vector<double> signal_data);
+
+    /**
+     * @brief View the channels of an acquisition buffer instead of copying them.
+     * @param buffer Acquisition buffer, kept alive by the trigger.
+     * The "Time" channel, if present, becomes the global time axis; every other
+     * channel is added as a signal viewing the buffer memory.
+     */
+    void add_acquisition_buffer(const std::shared_ptr<const utils::AcquisitionBuffer> &buffer);
 
     /**
      * @brief Add a global time axis for subsequent signal additions.
@@ -42,6 +64,31 @@ struct Trigger {
      */
     void add_time(const std::vector<double> &time);
 
+    /**
+     * @brief Use a uniform time axis instead of a time vector.
+     * @param time_axis Affine time axis, one value per signal sample.
+     * Segment time stamps are computed from the axis, so no per sample time vector is stored.
+     */
+    void add_time(const utils::TimeAxis &time_axis);
+
+    /**
+     * @brief Number of samples of the time axis, whichever way it was given.
+     */
+    size_t get_number_of_time_samples() const {
+        return this->global_time.empty() ? this->time_axis.size() : this->global_time.size();
+    }
+
+    bool has_time() const {
+        return this->get_number_of_time_samples() > 0;
+    }
+
+    /**
+     * @brief Time value of every sample, materializing the time axis if one was given.
+     */
+    std::vector<double> get_global_time() const {
+        return this->global_time.empty() ? this->time_axis.to_vector() : this->global_time;
+    }
+
     /**
      * @brief Get the segmented signal for a specific detector.
      * @param detector_name Name of the detector whose segments to retrieve.
@@ -50,31 +97,39 @@ struct Trigger {
      */
     std::vector<double>& get_segmented_signal(const std::string &detector_name);
 
+    /**
+     * @brief Shared buffer of the segmented signal of a detector, empty if it has no segments.
+     * @param detector_name Name of the detector whose segments to retrieve.
+     * The buffer is not reused by later segmentations, so holders keep the segments of this run.
+     */
+    std::shared_ptr<std::vector<double>> get_segmented_signal_buffer(const std::string &detector_name);
+
     /**
      * @brief Run segmentation based on valid trigger indices.
      * @param valid_triggers Vector of (start, end) indices for each trigger.
-     * This populates `signal_segments`, `time_out`, and `segment_ids_out` with the
-     * corresponding segments, time stamps, and segment IDs for each trigger segment.
+     * This computes `segment_offsets` from the trigger list, allocates `time_out` and
+     * every channel of `signal_segments` once, then copies the segments of all
+     * channels in parallel.
      */
     void run_segmentation(const std::vector<std::pair<int, int>> &valid_triggers);
 
     /**
-     * @brief Extract signal segments based on valid trigger indices.
-     * @param detector_name Name of the detector whose signal segments to extract.
-     * @param signal Vector of signal values for the detector.
-     * @param valid_triggers Vector of (start, end) indices for each trigger.
-     * This populates `signal_segments` with the extracted segments for the specified detector.
-     * The segments are extracted based on the provided start and end indices,
-     * ensuring they align with the global time axis.
+     * @brief Number of segments extracted by the last segmentation.
      */
-    void extract_signal_segments(const std::string &detector_name, const std::vector<double> &signal, const std::vector<std::pair<int, int>> &valid_triggers);
+    size_t get_number_of_segments() const {
+        return this->segment_offsets.empty() ? 0 : this->segment_offsets.size() - 1;
+    }
 
     /**
-     * @brief Extract time and segment ID information from valid triggers.
-     * @param valid_triggers Vector of (start, end) indices for each trigger.
-     * This populates `time_out` and `segment_ids_out` with the corresponding time stamps
-     * and segment IDs for each trigger segment.
-     * The time stamps are aligned with the global time axis.
+     * @brief Expand the segment offsets into one segment ID per segmented sample.
+     * @return vector<int> Segment index of each sample of `time_out`.
+     */
+    std::vector<int> get_segment_ids() const;
+
+    /**
+     * @brief Common length of the segments, for outputs laid out as a dense matrix.
+     * @return size_t Number of samples of every segment, 0 if there is no segment.
+     * @throws std::runtime_error If the segments do not all have the same length.
      */
-    void extract_time_and_id(const std::vector<std::pair<int, int>> &valid_triggers);
+    size_t get_uniform_segment_length() const;
 };
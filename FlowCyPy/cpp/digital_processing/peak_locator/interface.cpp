@@ -1,12 +1,44 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+
+#include <utility>
 
 #include "peak_locator.h"
+#include <utils/module_binding.h>
+#include <utils/numpy.h>
+#include <utils/profiler_binding.h>
+#include <utils/threading_binding.h>
 
 namespace py = pybind11;
 
+namespace {
+
+// Convert event-major metrics into {channel: {metric: array of shape (n_events, max_number_of_peaks)}}.
+py::dict build_event_metric_output(EventMetricDictionary&& event_metrics, const size_t max_number_of_peaks) {
+    py::dict output;
+
+    for (auto& [channel_name, metric_dictionary] : event_metrics) {
+        py::dict channel_output;
+
+        for (auto& [metric_name, metric_values] : metric_dictionary) {
+            const py::ssize_t number_of_events = static_cast<py::ssize_t>(metric_values.size() / max_number_of_peaks);
+
+            channel_output[py::str(metric_name)] =
+                vector_to_numpy_without_copy(std::move(metric_values))
+                    .attr("reshape")(number_of_events, static_cast<py::ssize_t>(max_number_of_peaks));
+        }
+
+        output[py::str(channel_name)] = channel_output;
+    }
+
+    return output;
+}
+
+}  // namespace
+
 
-PYBIND11_MODULE(peak_locator, module) {
+FLOWCYPY_MODULE(peak_locator, module) {
     module.doc() = R"pbdoc(
         Fast C++ peak detection utilities for segmented 1D signals.
 
@@ -202,9 +234,30 @@ PYBIND11_MODULE(peak_locator, module) {
                 Maximum number of peaks stored in the fixed-size output buffers.
             )pbdoc"
         )
+        .def_readwrite(
+            "use_prefix_sums",
+            &BasePeakLocator::use_prefix_sums,
+            R"pbdoc(
+                Whether width and area are computed from precomputed tables.
+
+                When enabled, each analyzed signal gets a prefix sum of its area
+                integrand, so every area takes two lookups, and the support signal
+                gets per-block minima, so support expansion crosses 64 samples
+                above the threshold at a time. Channels sharing one support
+                channel reuse its table within an event.
+
+                This pays off for wide pulse supports or many peaks per signal.
+                Areas equal the sample by sample sums up to rounding. Disabled by
+                default.
+            )pbdoc"
+        )
         .def(
             "get_metrics",
-            &BasePeakLocator::get_metrics,
+            [](BasePeakLocator& self, const py::object& array) {
+                const contiguous_array<double> values = to_contiguous_array<double>(array);
+
+                return self.get_metrics(array_to_span(values));
+            },
             py::arg("array"),
             R"pbdoc(
                 Compute peak metrics for a single 1D signal.
@@ -228,7 +281,14 @@ PYBIND11_MODULE(peak_locator, module) {
         )
         .def(
             "compute",
-            &BasePeakLocator::compute,
+            [](BasePeakLocator& self, const py::object& array) {
+                const contiguous_array<double> values = to_contiguous_array<double>(array);
+
+                {
+                    py::gil_scoped_release release;
+                    self.compute(array_to_span(values));
+                }
+            },
             py::arg("array"),
             R"pbdoc(
                 Run peak detection on a single 1D signal and update internal
@@ -258,7 +318,7 @@ PYBIND11_MODULE(peak_locator, module) {
                 }
 
                 const std::vector<int> segment_ids =
-                    py::cast<std::vector<int>>(segmented_signal_dictionary[py::str("segment_id")]);
+                    array_to_vector(to_contiguous_array<int>(segmented_signal_dictionary[py::str("segment_id")]));
 
                 FlatSignalDictionary flat_signal_dictionary;
 
@@ -270,7 +330,7 @@ PYBIND11_MODULE(peak_locator, module) {
                     }
 
                     flat_signal_dictionary[key] =
-                        py::cast<std::vector<double>>(item.second);
+                        array_to_vector(to_contiguous_array<double>(item.second));
                 }
 
                 if (flat_signal_dictionary.empty()) {
@@ -279,12 +339,15 @@ PYBIND11_MODULE(peak_locator, module) {
                     );
                 }
 
-                const SegmentedMetricDictionary segmented_metrics =
-                    self.run_flat_segmented_signals(
+                SegmentedMetricDictionary segmented_metrics;
+                {
+                    py::gil_scoped_release release;
+                    segmented_metrics = self.run_flat_segmented_signals(
                         segment_ids,
                         flat_signal_dictionary,
                         trigger_channel
                     );
+                }
 
                 py::dict output_dictionary;
 
@@ -354,6 +417,72 @@ PYBIND11_MODULE(peak_locator, module) {
                 The regrouping and segmented processing are handled in C++.
             )pbdoc"
         )
+        .def(
+            "run_batch",
+            [](const BasePeakLocator& self,
+               const py::object& segment_offsets,
+               const py::dict& segmented_signals,
+               const std::string& trigger_channel) -> py::dict {
+                const std::vector<size_t> offsets =
+                    array_to_vector(to_contiguous_array<size_t>(segment_offsets));
+
+                // The arrays are kept alive while the C++ side reads them through views.
+                std::vector<contiguous_array<double>> signal_arrays;
+                SignalViewDictionary signal_views;
+
+                for (const auto& item : segmented_signals) {
+                    signal_arrays.push_back(to_contiguous_array<double>(item.second));
+                    signal_views[py::cast<std::string>(item.first)] = array_to_span(signal_arrays.back());
+                }
+
+                EventMetricDictionary metrics;
+                {
+                    py::gil_scoped_release release;
+                    metrics = self.run_segment_offsets(offsets, signal_views, trigger_channel);
+                }
+
+                return build_event_metric_output(std::move(metrics), static_cast<size_t>(self.max_number_of_peaks));
+            },
+            py::arg("segment_offsets"),
+            py::arg("segmented_signals"),
+            py::arg("trigger_channel") = "",
+            R"pbdoc(
+                Compute peak metrics for every segment and channel in one call.
+
+                Segments are stored contiguously: segment k occupies samples
+                ``segment_offsets[k]:segment_offsets[k + 1]`` of every channel
+                array. This is the layout of a discriminator trigger, so
+                ``trigger.segment_offsets`` and ``trigger.get_segmented_signal(name)``
+                can be passed without copies. Segments are processed in parallel.
+
+                Parameters
+                ----------
+                segment_offsets : array-like of int
+                    Segment offsets, starting at 0 and ending at the length of the
+                    channel arrays.
+                segmented_signals : dict
+                    Mapping from channel name to the concatenated segments of that
+                    channel, as an array or a Pint quantity.
+                trigger_channel : str, default=""
+                    Trigger channel name used when the configured support object
+                    is `PulseSupport(channel="default", ...)`.
+
+                Returns
+                -------
+                dict
+                    Nested dictionary structured as
+
+                        {
+                            "channel_name": {
+                                "Index": array of shape (n_segments, max_number_of_peaks),
+                                "Height": ...,
+                                "Width": ...,   # if enabled
+                                "Area": ...,    # if enabled
+                            },
+                            ...
+                        }
+            )pbdoc"
+        )
         .def(
             "__repr__",
             [](const BasePeakLocator& self) {
@@ -524,23 +653,29 @@ PYBIND11_MODULE(peak_locator, module) {
                     Whether to print debug information during peak detection.
             )pbdoc"
         )
-        .def_readonly(
+        .def_property_readonly(
             "polarity",
-            &GlobalPeakLocator::polarity,
+            [](const GlobalPeakLocator& self) {
+                return to_string(self.polarity);
+            },
             R"pbdoc(
                 Measurement polarity used to select the event sample.
             )pbdoc"
         )
-        .def_readonly(
+        .def_property_readonly(
             "height_mode",
-            &GlobalPeakLocator::height_mode,
+            [](const GlobalPeakLocator& self) {
+                return to_string(self.height_mode);
+            },
             R"pbdoc(
                 Height measurement mode used for the reported event amplitude.
             )pbdoc"
         )
-        .def_readonly(
+        .def_property_readonly(
             "baseline_mode",
-            &GlobalPeakLocator::baseline_mode,
+            [](const GlobalPeakLocator& self) {
+                return to_string(self.baseline_mode);
+            },
             R"pbdoc(
                 Baseline convention used by baseline-aware measurement modes.
             )pbdoc"
@@ -551,9 +686,9 @@ PYBIND11_MODULE(peak_locator, module) {
                 return
                     "GlobalPeakLocator(max_number_of_peaks=" +
                     std::to_string(self.max_number_of_peaks) +
-                    ", polarity='" + self.polarity +
-                    "', height_mode='" + self.height_mode +
-                    "', baseline_mode='" + self.baseline_mode +
+                    ", polarity='" + to_string(self.polarity) +
+                    "', height_mode='" + to_string(self.height_mode) +
+                    "', baseline_mode='" + to_string(self.baseline_mode) +
                     "', compute_width=" +
                     std::string(self.compute_width ? "true" : "false") +
                     ", compute_area=" +
@@ -568,4 +703,7 @@ PYBIND11_MODULE(peak_locator, module) {
                     std::string(self.debug_mode ? "true" : "false") + ")";
             }
         );
+
+    register_profiling_functions(module);
+    register_threading_functions(module);
 }
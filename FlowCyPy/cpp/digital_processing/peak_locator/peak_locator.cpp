@@ -3,26 +3,209 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <exception>
+#include <functional>
+#include <limits>
 #include <stdexcept>
 
+#include <utils/profiler.h>
+#include <utils/threading.h>
+
 namespace {
 
-bool is_supported_global_polarity(const std::string& polarity) {
-    return polarity == "positive" ||
-           polarity == "negative" ||
-           polarity == "absolute";
+using GlobalMeasurementKernel = GlobalPeakMeasurement (*)(std::span<const double>, size_t, size_t);
+
+template <PeakBaselineMode baseline_mode>
+double compute_global_baseline(std::span<const double> signal, size_t left_boundary, size_t right_boundary) {
+    if constexpr (baseline_mode == PeakBaselineMode::zero) {
+        return 0.0;
+    } else if constexpr (baseline_mode == PeakBaselineMode::segment_mean) {
+        double sum = 0.0;
+
+        for (const double value : signal) {
+            sum += value;
+        }
+
+        return sum / static_cast<double>(signal.size());
+    } else {
+        return 0.5 * (signal[left_boundary] + signal[right_boundary]);
+    }
+}
+
+// First sample of [start, end) with the highest score: largest value, smallest
+// value, or largest distance to the baseline.
+template <PeakPolarity polarity>
+size_t find_global_event_index(std::span<const double> signal, size_t start, size_t end, double baseline) {
+    const auto score = [baseline](const double value) {
+        if constexpr (polarity == PeakPolarity::positive) {
+            return value;
+        } else if constexpr (polarity == PeakPolarity::negative) {
+            return -value;
+        } else {
+            return std::abs(value - baseline);
+        }
+    };
+
+    size_t best_index = start;
+    double best_score = score(signal[start]);
+
+    for (size_t index = start + 1; index < end; ++index) {
+        const double candidate_score = score(signal[index]);
+
+        if (candidate_score > best_score) {
+            best_score = candidate_score;
+            best_index = index;
+        }
+    }
+
+    return best_index;
+}
+
+template <PeakPolarity polarity, PeakHeightMode height_mode>
+double compute_global_height(
+    std::span<const double> signal,
+    size_t left_boundary,
+    size_t right_boundary,
+    size_t peak_index,
+    double baseline
+) {
+    const double peak_value = signal[peak_index];
+
+    if constexpr (height_mode == PeakHeightMode::raw) {
+        return peak_value;
+    } else if constexpr (height_mode == PeakHeightMode::peak_to_baseline) {
+        if constexpr (polarity == PeakPolarity::positive) {
+            return peak_value - baseline;
+        } else if constexpr (polarity == PeakPolarity::negative) {
+            return baseline - peak_value;
+        } else {
+            return std::abs(peak_value - baseline);
+        }
+    } else {
+        double minimum_value = signal[left_boundary];
+        double maximum_value = signal[left_boundary];
+
+        for (size_t index = left_boundary + 1; index <= right_boundary; ++index) {
+            minimum_value = std::min(minimum_value, signal[index]);
+            maximum_value = std::max(maximum_value, signal[index]);
+        }
+
+        return maximum_value - minimum_value;
+    }
+}
+
+template <PeakPolarity polarity, PeakHeightMode height_mode, PeakBaselineMode baseline_mode>
+GlobalPeakMeasurement measure_global_peak(std::span<const double> signal, size_t left_boundary, size_t right_boundary) {
+    const double baseline = compute_global_baseline<baseline_mode>(signal, left_boundary, right_boundary);
+    const size_t peak_index = find_global_event_index<polarity>(signal, left_boundary, right_boundary + 1, baseline);
+
+    return GlobalPeakMeasurement{
+        peak_index,
+        compute_global_height<polarity, height_mode>(signal, left_boundary, right_boundary, peak_index, baseline),
+        baseline
+    };
+}
+
+template <PeakPolarity polarity, PeakHeightMode height_mode>
+GlobalMeasurementKernel select_kernel_for_baseline(const PeakBaselineMode baseline_mode) {
+    switch (baseline_mode) {
+        case PeakBaselineMode::zero:
+            return &measure_global_peak<polarity, height_mode, PeakBaselineMode::zero>;
+        case PeakBaselineMode::segment_mean:
+            return &measure_global_peak<polarity, height_mode, PeakBaselineMode::segment_mean>;
+        case PeakBaselineMode::edge_mean:
+            return &measure_global_peak<polarity, height_mode, PeakBaselineMode::edge_mean>;
+    }
+
+    throw std::runtime_error("Unknown GlobalPeakLocator baseline_mode.");
 }
 
-bool is_supported_global_height_mode(const std::string& height_mode) {
-    return height_mode == "raw" ||
-           height_mode == "peak_to_baseline" ||
-           height_mode == "peak_to_peak";
+template <PeakPolarity polarity>
+GlobalMeasurementKernel select_kernel_for_height(const PeakHeightMode height_mode, const PeakBaselineMode baseline_mode) {
+    switch (height_mode) {
+        case PeakHeightMode::raw:
+            return select_kernel_for_baseline<polarity, PeakHeightMode::raw>(baseline_mode);
+        case PeakHeightMode::peak_to_baseline:
+            return select_kernel_for_baseline<polarity, PeakHeightMode::peak_to_baseline>(baseline_mode);
+        case PeakHeightMode::peak_to_peak:
+            return select_kernel_for_baseline<polarity, PeakHeightMode::peak_to_peak>(baseline_mode);
+    }
+
+    throw std::runtime_error("Unknown GlobalPeakLocator height_mode.");
+}
+
+GlobalMeasurementKernel select_measurement_kernel(
+    const PeakPolarity polarity,
+    const PeakHeightMode height_mode,
+    const PeakBaselineMode baseline_mode
+) {
+    switch (polarity) {
+        case PeakPolarity::positive:
+            return select_kernel_for_height<PeakPolarity::positive>(height_mode, baseline_mode);
+        case PeakPolarity::negative:
+            return select_kernel_for_height<PeakPolarity::negative>(height_mode, baseline_mode);
+        case PeakPolarity::absolute:
+            return select_kernel_for_height<PeakPolarity::absolute>(height_mode, baseline_mode);
+    }
+
+    throw std::runtime_error("Unknown GlobalPeakLocator polarity.");
+}
+
+// Descending height, ties and NaN heights going to the earlier position, so the
+// order is a strict weak ordering whatever the data.
+bool is_higher_peak(double left_value, size_t left_position, double right_value, size_t right_position) {
+    const bool left_is_nan = std::isnan(left_value);
+    const bool right_is_nan = std::isnan(right_value);
+
+    if (left_is_nan != right_is_nan) {
+        return right_is_nan;
+    }
+
+    if (!left_is_nan && left_value != right_value) {
+        return left_value > right_value;
+    }
+
+    return left_position < right_position;
 }
 
-bool is_supported_global_baseline_mode(const std::string& baseline_mode) {
-    return baseline_mode == "zero" ||
-           baseline_mode == "segment_mean" ||
-           baseline_mode == "edge_mean";
+// Support channel resolution shared by segmented dictionaries and full signal views.
+template <class ChannelDictionary>
+std::string resolve_support_channel_name_in(
+    const BaseSupport& support,
+    const ChannelDictionary& channel_dictionary,
+    const std::string& current_channel_name,
+    const std::string& trigger_channel
+) {
+    if (support.is_full_window()) {
+        return current_channel_name;
+    }
+
+    const std::string support_channel = support.get_channel();
+
+    if (support_channel == "independent") {
+        return current_channel_name;
+    }
+
+    if (support_channel == "default") {
+        if (!trigger_channel.empty()) {
+            if (channel_dictionary.find(trigger_channel) == channel_dictionary.end()) {
+                throw std::runtime_error(
+                    "Trigger channel '" + trigger_channel + "' is not present in the segmented data."
+                );
+            }
+            return trigger_channel;
+        }
+
+        return current_channel_name;
+    }
+
+    if (channel_dictionary.find(support_channel) == channel_dictionary.end()) {
+        throw std::runtime_error(
+            "Support channel '" + support_channel + "' is not present in the segmented data."
+        );
+    }
+
+    return support_channel;
 }
 
 }  // namespace
@@ -249,7 +432,7 @@ BasePeakLocator::BasePeakLocator(
  * array :
  *     Input signal values.
  */
-void BasePeakLocator::validate_input_signal(const std::vector<double>& array) const {
+void BasePeakLocator::validate_input_signal(std::span<const double> array) const {
     if (array.empty()) {
         throw std::runtime_error("signal must not be empty.");
     }
@@ -317,6 +500,8 @@ size_t BasePeakLocator::find_local_peak(
  *     Output inclusive left boundary.
  * right_boundary :
  *     Output inclusive right boundary.
+ * workspace :
+ *     Optional workspace holding support block minima.
  */
 void BasePeakLocator::compute_boundaries(
     const double* ptr,
@@ -324,7 +509,8 @@ void BasePeakLocator::compute_boundaries(
     size_t end,
     size_t peak_index,
     size_t& left_boundary,
-    size_t& right_boundary
+    size_t& right_boundary,
+    const PeakWorkspace* workspace
 ) const {
     if (ptr == nullptr) {
         throw std::runtime_error("Input pointer must not be null.");
@@ -386,18 +572,50 @@ void BasePeakLocator::compute_boundaries(
 
     const double threshold_value = this->support->get_threshold() * peak_value;
 
-    while (
-        left_boundary > start &&
-        ptr[left_boundary - 1] >= threshold_value
-    ) {
-        --left_boundary;
+    // Blocks whose minimum is above the threshold are crossed in one step; the
+    // walk goes sample by sample only up to a block edge and in the final block.
+    const bool use_block_minima =
+        this->use_prefix_sums &&
+        workspace != nullptr &&
+        workspace->support_source == ptr &&
+        end <= workspace->support_source_size;
+
+    constexpr size_t block_size = PeakWorkspace::support_block_size;
+
+    while (left_boundary > start) {
+        if (
+            use_block_minima &&
+            left_boundary % block_size == 0 &&
+            left_boundary >= start + block_size &&
+            workspace->support_block_minima[left_boundary / block_size - 1] >= threshold_value
+        ) {
+            left_boundary -= block_size;
+        }
+        else if (ptr[left_boundary - 1] >= threshold_value) {
+            --left_boundary;
+        }
+        else {
+            break;
+        }
     }
 
-    while (
-        right_boundary + 1 < end &&
-        ptr[right_boundary + 1] >= threshold_value
-    ) {
-        ++right_boundary;
+    while (right_boundary + 1 < end) {
+        const size_t next_index = right_boundary + 1;
+
+        if (
+            use_block_minima &&
+            next_index % block_size == 0 &&
+            next_index + block_size <= end &&
+            workspace->support_block_minima[next_index / block_size] >= threshold_value
+        ) {
+            right_boundary += block_size;
+        }
+        else if (ptr[next_index] >= threshold_value) {
+            ++right_boundary;
+        }
+        else {
+            break;
+        }
     }
 
     if (this->debug_mode) {
@@ -436,6 +654,8 @@ void BasePeakLocator::compute_boundaries(
  *     Exclusive interval end.
  * peak_index :
  *     Peak index used to define the support.
+ * workspace :
+ *     Optional workspace holding area prefix sums and support block minima.
  *
  * Returns
  * -------
@@ -447,7 +667,8 @@ PeakMetrics BasePeakLocator::compute_segment_metrics(
     const double* support_ptr,
     size_t start,
     size_t end,
-    size_t peak_index
+    size_t peak_index,
+    const PeakWorkspace* workspace
 ) const {
     if (value_ptr == nullptr) {
         throw std::runtime_error("value_ptr must not be null.");
@@ -478,7 +699,8 @@ PeakMetrics BasePeakLocator::compute_segment_metrics(
         end,
         peak_index,
         left_boundary,
-        right_boundary
+        right_boundary,
+        workspace
     );
 
     metrics.left_boundary = left_boundary;
@@ -502,7 +724,20 @@ PeakMetrics BasePeakLocator::compute_segment_metrics(
     double minimum_value = value_ptr[left_boundary];
     double maximum_value = value_ptr[left_boundary];
 
-    if (valid_event) {
+    // Prefix sums give the area in O(1) unless the support holds a non finite
+    // sample, whose effect on the sum is left to the sample by sample loop.
+    const bool use_prefix_sums =
+        valid_event &&
+        this->use_prefix_sums &&
+        !this->debug_mode &&
+        workspace != nullptr &&
+        workspace->area_source == value_ptr &&
+        workspace->non_finite_prefix_counts[right_boundary + 1] == workspace->non_finite_prefix_counts[left_boundary];
+
+    if (use_prefix_sums) {
+        area = workspace->area_prefix_sums[right_boundary + 1] - workspace->area_prefix_sums[left_boundary];
+    }
+    else if (valid_event) {
         area = 0.0;
 
         for (size_t index = left_boundary; index <= right_boundary; ++index) {
@@ -575,6 +810,84 @@ PeakMetrics BasePeakLocator::compute_segment_metrics(
     return metrics;
 }
 
+/**
+ * @brief Build the prefix sum and support tables of a workspace.
+ *
+ * Parameters
+ * ----------
+ * value_signal :
+ *     Signal used for area accumulation.
+ * support_signal :
+ *     Signal used to define support boundaries.
+ * workspace :
+ *     Workspace receiving the tables.
+ */
+void BasePeakLocator::prepare_support_tables(
+    std::span<const double> value_signal,
+    std::span<const double> support_signal,
+    PeakWorkspace& workspace
+) const {
+    if (!this->use_prefix_sums) {
+        return;
+    }
+
+    if (this->compute_area) {
+        workspace.area_prefix_sums.resize(value_signal.size() + 1);
+        workspace.non_finite_prefix_counts.resize(value_signal.size() + 1);
+        workspace.area_prefix_sums[0] = 0.0;
+        workspace.non_finite_prefix_counts[0] = 0;
+
+        for (size_t index = 0; index < value_signal.size(); ++index) {
+            const double value = value_signal[index];
+            const bool is_finite = std::isfinite(value);
+            const double integrand = !is_finite
+                ? 0.0
+                : (this->allow_negative_area ? value : std::max(0.0, value));
+
+            workspace.area_prefix_sums[index + 1] = workspace.area_prefix_sums[index] + integrand;
+            workspace.non_finite_prefix_counts[index + 1] =
+                workspace.non_finite_prefix_counts[index] + (is_finite ? 0 : 1);
+        }
+
+        workspace.area_source = value_signal.data();
+    }
+
+    const bool support_is_cached =
+        workspace.support_source == support_signal.data() &&
+        workspace.support_source_size == support_signal.size();
+
+    if (this->support->is_full_window() || support_is_cached) {
+        return;
+    }
+
+    constexpr size_t block_size = PeakWorkspace::support_block_size;
+    const size_t number_of_blocks = (support_signal.size() + block_size - 1) / block_size;
+
+    workspace.support_block_minima.resize(number_of_blocks);
+
+    for (size_t block = 0; block < number_of_blocks; ++block) {
+        const size_t block_end = std::min((block + 1) * block_size, support_signal.size());
+        double minimum_value = support_signal[block * block_size];
+
+        for (size_t index = block * block_size; index < block_end; ++index) {
+            const double value = support_signal[index];
+
+            if (std::isnan(value)) {
+                minimum_value = -std::numeric_limits<double>::infinity();
+                break;
+            }
+
+            minimum_value = std::min(minimum_value, value);
+        }
+
+        workspace.support_block_minima[block] = minimum_value;
+    }
+
+    workspace.support_source = support_signal.data();
+    workspace.support_source_size = support_signal.size();
+}
+
+
 /**
  * @brief Sort peaks by descending height.
  *
@@ -584,11 +897,12 @@ PeakMetrics BasePeakLocator::compute_segment_metrics(
  *     Vector of peaks to sort in place.
  */
 void BasePeakLocator::sort_peaks_descending(std::vector<PeakData>& peaks) const {
-    std::sort(
+    // Stable, so peaks of equal height keep the order they were located in.
+    std::stable_sort(
         peaks.begin(),
         peaks.end(),
         [](const PeakData& left_peak, const PeakData& right_peak) {
-            return left_peak.value > right_peak.value;
+            return is_higher_peak(left_peak.value, 0, right_peak.value, 0);
         }
     );
 }
@@ -628,56 +942,9 @@ void BasePeakLocator::initialize_output_vectors() {
  *     Computed metrics.
  */
 MetricDictionary BasePeakLocator::compute_metric_dictionary(
-    const std::vector<double>& array
+    std::span<const double> array
 ) const {
-    this->validate_input_signal(array);
-
-    std::vector<PeakData> peaks = this->locate_peaks(array);
-    this->sort_peaks_descending(peaks);
-
-    MetricDictionary output;
-    output["Index"] = std::vector<double>(
-        this->max_number_of_peaks,
-        static_cast<double>(this->padding_value)
-    );
-    output["Height"] = std::vector<double>(
-        this->max_number_of_peaks,
-        static_cast<double>(this->padding_value)
-    );
-
-    if (this->compute_area) {
-        output["Area"] = std::vector<double>(
-            this->max_number_of_peaks,
-            static_cast<double>(this->padding_value)
-        );
-    }
-
-    if (this->compute_width) {
-        output["Width"] = std::vector<double>(
-            this->max_number_of_peaks,
-            static_cast<double>(this->padding_value)
-        );
-    }
-
-    const size_t number_of_output_peaks = std::min(
-        static_cast<size_t>(this->max_number_of_peaks),
-        peaks.size()
-    );
-
-    for (size_t index = 0; index < number_of_output_peaks; ++index) {
-        output["Index"][index] = static_cast<double>(peaks[index].index);
-        output["Height"][index] = peaks[index].value;
-
-        if (this->compute_width) {
-            output["Width"][index] = peaks[index].width;
-        }
-
-        if (this->compute_area) {
-            output["Area"][index] = peaks[index].area;
-        }
-    }
-
-    return output;
+    return this->compute_metric_dictionary_with_shared_support(array, array);
 }
 
 
@@ -697,151 +964,224 @@ MetricDictionary BasePeakLocator::compute_metric_dictionary(
  *     Computed metrics.
  */
 MetricDictionary BasePeakLocator::compute_metric_dictionary_with_shared_support(
-    const std::vector<double>& value_signal,
-    const std::vector<double>& support_signal
+    std::span<const double> value_signal,
+    std::span<const double> support_signal
 ) const {
-    this->validate_input_signal(value_signal);
-    this->validate_input_signal(support_signal);
-
-    std::vector<PeakData> peaks = this->locate_peaks_with_support(value_signal, support_signal);
-    this->sort_peaks_descending(peaks);
+    const size_t row_size = static_cast<size_t>(this->max_number_of_peaks);
 
     MetricDictionary output;
-    output["Index"] = std::vector<double>(
-        this->max_number_of_peaks,
-        static_cast<double>(this->padding_value)
-    );
-    output["Height"] = std::vector<double>(
-        this->max_number_of_peaks,
-        static_cast<double>(this->padding_value)
-    );
+    PeakColumns columns;
 
-    if (this->compute_area) {
-        output["Area"] = std::vector<double>(
-            this->max_number_of_peaks,
-            static_cast<double>(this->padding_value)
-        );
-    }
+    output["Index"].resize(row_size);
+    output["Height"].resize(row_size);
+    columns.index = output["Index"].data();
+    columns.height = output["Height"].data();
 
     if (this->compute_width) {
-        output["Width"] = std::vector<double>(
-            this->max_number_of_peaks,
-            static_cast<double>(this->padding_value)
-        );
+        output["Width"].resize(row_size);
+        columns.width = output["Width"].data();
     }
 
-    const size_t number_of_output_peaks = std::min(
-        static_cast<size_t>(this->max_number_of_peaks),
-        peaks.size()
-    );
-
-    for (size_t index = 0; index < number_of_output_peaks; ++index) {
-        output["Index"][index] = static_cast<double>(peaks[index].index);
-        output["Height"][index] = peaks[index].value;
-
-        if (this->compute_width) {
-            output["Width"][index] = peaks[index].width;
-        }
-
-        if (this->compute_area) {
-            output["Area"][index] = peaks[index].area;
-        }
+    if (this->compute_area) {
+        output["Area"].resize(row_size);
+        columns.area = output["Area"].data();
     }
 
+    PeakWorkspace workspace;
+    this->write_peak_row(value_signal, support_signal, columns, 0, workspace);
+
     return output;
 }
 
 
 /**
- * @brief Compute metrics for a single signal and update internal buffers.
+ * @brief Locate the peaks of one signal and write one row of metric columns.
  *
  * Parameters
  * ----------
- * array :
- *     Input signal.
+ * value_signal :
+ *     Signal used to compute peak value and area.
+ * support_signal :
+ *     Signal used to define support boundaries.
+ * columns :
+ *     Destination column buffers.
+ * row :
+ *     Row of the columns to write.
+ * workspace :
+ *     Scratch memory of the calling thread.
  */
-void BasePeakLocator::compute(const std::vector<double>& array) {
-    const MetricDictionary output = this->compute_metric_dictionary(array);
+void BasePeakLocator::write_peak_row(
+    std::span<const double> value_signal,
+    std::span<const double> support_signal,
+    const PeakColumns& columns,
+    const size_t row,
+    PeakWorkspace& workspace
+) const {
+    this->validate_input_signal(value_signal);
+    this->validate_input_signal(support_signal);
 
-    this->initialize_output_vectors();
+    this->locate_peaks_into(value_signal, support_signal, workspace);
 
-    const std::vector<double>& index_values = output.at("Index");
-    const std::vector<double>& height_values = output.at("Height");
+    const size_t row_size = static_cast<size_t>(this->max_number_of_peaks);
+    const size_t offset = row * row_size;
+    const size_t number_of_output_peaks = std::min(row_size, workspace.peaks.size());
+    const double padding = static_cast<double>(this->padding_value);
 
-    for (size_t index = 0; index < index_values.size(); ++index) {
-        this->peak_indices[index] = static_cast<int>(std::llround(index_values[index]));
-        this->peak_heights[index] = height_values[index];
-    }
+    for (size_t index = 0; index < row_size; ++index) {
+        const bool is_peak = index < number_of_output_peaks;
+        const PeakData* peak = is_peak ? &workspace.peaks[index] : nullptr;
 
-    if (this->compute_width) {
-        const std::vector<double>& width_values = output.at("Width");
+        columns.index[offset + index] = is_peak ? static_cast<double>(peak->index) : padding;
+        columns.height[offset + index] = is_peak ? peak->value : padding;
 
-        for (size_t index = 0; index < width_values.size(); ++index) {
-            this->peak_widths[index] = width_values[index];
+        if (columns.width != nullptr) {
+            columns.width[offset + index] = is_peak ? peak->width : padding;
         }
-    }
-
-    if (this->compute_area) {
-        const std::vector<double>& area_values = output.at("Area");
 
-        for (size_t index = 0; index < area_values.size(); ++index) {
-            this->peak_areas[index] = area_values[index];
+        if (columns.area != nullptr) {
+            columns.area[offset + index] = is_peak ? peak->area : padding;
         }
     }
 }
 
 
 /**
- * @brief Return one stored metric vector.
+ * @brief Detect peaks using one signal for both peak selection and support.
  *
  * Parameters
  * ----------
- * metric_name :
- *     Name of the metric to return.
+ * signal :
+ *     Input signal.
  *
  * Returns
  * -------
- * std::vector<double>
- *     Stored metric values.
+ * std::vector<PeakData>
+ *     Detected peaks, by descending height.
  */
-std::vector<double> BasePeakLocator::get_metric_py(const std::string& metric_name) const {
-    if (metric_name == "Index") {
-        return std::vector<double>(this->peak_indices.begin(), this->peak_indices.end());
-    }
-
-    if (metric_name == "Height") {
-        return this->peak_heights;
-    }
-
-    if (metric_name == "Width") {
-        return this->peak_widths;
-    }
-
-    if (metric_name == "Area") {
-        return this->peak_areas;
-    }
-
-    throw std::runtime_error("No valid metric chosen: " + metric_name);
+std::vector<PeakData> BasePeakLocator::locate_peaks(std::span<const double> signal) const {
+    return this->locate_peaks_with_support(signal, signal);
 }
 
 
 /**
- * @brief Compute and return metrics for a single signal.
+ * @brief Detect peaks using a value signal and a separate support signal.
  *
  * Parameters
  * ----------
- * array :
- *     Input signal.
+ * value_signal :
+ *     Signal used for peak values and area accumulation.
+ * support_signal :
+ *     Signal used to define support boundaries.
  *
  * Returns
  * -------
- * MetricDictionary
- *     Computed metrics.
+ * std::vector<PeakData>
+ *     Detected peaks, by descending height.
  */
-MetricDictionary BasePeakLocator::get_metrics(const std::vector<double>& array) {
-    this->compute(array);
+std::vector<PeakData> BasePeakLocator::locate_peaks_with_support(
+    std::span<const double> value_signal,
+    std::span<const double> support_signal
+) const {
+    PeakWorkspace workspace;
+    this->locate_peaks_into(value_signal, support_signal, workspace);
 
-    MetricDictionary output;
+    return std::move(workspace.peaks);
+}
+
+
+/**
+ * @brief Compute metrics for a single signal and update internal buffers.
+ *
+ * Parameters
+ * ----------
+ * array :
+ *     Input signal.
+ */
+void BasePeakLocator::compute(std::span<const double> array) {
+    FLOWCYPY_PROFILE_SCOPE("peak_locator.compute");
+    FLOWCYPY_PROFILE_COUNT("peak_locator.compute", "samples", array.size());
+
+    this->validate_input_signal(array);
+
+    // The caller may have rewritten the samples of a buffer seen before.
+    this->workspace.invalidate_tables();
+    this->locate_peaks_into(array, array, this->workspace);
+
+    this->initialize_output_vectors();
+
+    const size_t number_of_output_peaks = std::min(
+        static_cast<size_t>(this->max_number_of_peaks),
+        this->workspace.peaks.size()
+    );
+
+    for (size_t index = 0; index < number_of_output_peaks; ++index) {
+        const PeakData& peak = this->workspace.peaks[index];
+
+        this->peak_indices[index] = peak.index;
+        this->peak_heights[index] = peak.value;
+
+        if (this->compute_width) {
+            this->peak_widths[index] = peak.width;
+        }
+
+        if (this->compute_area) {
+            this->peak_areas[index] = peak.area;
+        }
+    }
+}
+
+
+/**
+ * @brief Return one stored metric vector.
+ *
+ * Parameters
+ * ----------
+ * metric_name :
+ *     Name of the metric to return.
+ *
+ * Returns
+ * -------
+ * std::vector<double>
+ *     Stored metric values.
+ */
+std::vector<double> BasePeakLocator::get_metric_py(const std::string& metric_name) const {
+    if (metric_name == "Index") {
+        return std::vector<double>(this->peak_indices.begin(), this->peak_indices.end());
+    }
+
+    if (metric_name == "Height") {
+        return this->peak_heights;
+    }
+
+    if (metric_name == "Width") {
+        return this->peak_widths;
+    }
+
+    if (metric_name == "Area") {
+        return this->peak_areas;
+    }
+
+    throw std::runtime_error("No valid metric chosen: " + metric_name);
+}
+
+
+/**
+ * @brief Compute and return metrics for a single signal.
+ *
+ * Parameters
+ * ----------
+ * array :
+ *     Input signal.
+ *
+ * Returns
+ * -------
+ * MetricDictionary
+ *     Computed metrics.
+ */
+MetricDictionary BasePeakLocator::get_metrics(std::span<const double> array) {
+    this->compute(array);
+
+    MetricDictionary output;
     output["Index"] = std::vector<double>(this->peak_indices.begin(), this->peak_indices.end());
     output["Height"] = this->peak_heights;
 
@@ -879,36 +1219,12 @@ std::string BasePeakLocator::resolve_support_channel_name(
     const std::string& current_channel_name,
     const std::string& trigger_channel
 ) const {
-    if (this->support->is_full_window()) {
-        return current_channel_name;
-    }
-
-    const std::string support_channel = this->support->get_channel();
-
-    if (support_channel == "independent") {
-        return current_channel_name;
-    }
-
-    if (support_channel == "default") {
-        if (!trigger_channel.empty()) {
-            if (channel_dictionary.find(trigger_channel) == channel_dictionary.end()) {
-                throw std::runtime_error(
-                    "Trigger channel '" + trigger_channel + "' is not present in the segmented data."
-                );
-            }
-            return trigger_channel;
-        }
-
-        return current_channel_name;
-    }
-
-    if (channel_dictionary.find(support_channel) == channel_dictionary.end()) {
-        throw std::runtime_error(
-            "Support channel '" + support_channel + "' is not present in the segmented data."
-        );
-    }
-
-    return support_channel;
+    return resolve_support_channel_name_in(
+        *this->support,
+        channel_dictionary,
+        current_channel_name,
+        trigger_channel
+    );
 }
 
 
@@ -996,8 +1312,6 @@ SegmentedMetricDictionary BasePeakLocator::run_flat_segmented_signals(
 
     const size_t number_of_samples = segment_ids.size();
 
-    SegmentedSignalDictionary segmented_signals;
-
     for (const auto& [channel_name, signal_vector] : flat_signals) {
         if (signal_vector.size() != number_of_samples) {
             throw std::runtime_error(
@@ -1007,7 +1321,57 @@ SegmentedMetricDictionary BasePeakLocator::run_flat_segmented_signals(
                 std::to_string(number_of_samples) + "."
             );
         }
+    }
+
+    // Increasing runs of segment ids are already the CSR layout of run_segment_offsets.
+    std::vector<size_t> segment_offsets = {0};
+    std::vector<int> run_segment_ids = {segment_ids.front()};
+
+    for (size_t sample_index = 1; sample_index < number_of_samples; ++sample_index) {
+        if (segment_ids[sample_index] != run_segment_ids.back()) {
+            segment_offsets.push_back(sample_index);
+            run_segment_ids.push_back(segment_ids[sample_index]);
+        }
+    }
+
+    segment_offsets.push_back(number_of_samples);
+
+    if (std::is_sorted(run_segment_ids.begin(), run_segment_ids.end(), std::less_equal<int>())) {
+        SignalViewDictionary segmented_signal_views;
+
+        for (const auto& [channel_name, signal_vector] : flat_signals) {
+            segmented_signal_views[channel_name] = signal_vector;
+        }
+
+        const EventMetricDictionary segment_metrics = this->run_segment_offsets(
+            segment_offsets,
+            segmented_signal_views,
+            trigger_channel
+        );
+
+        const size_t row_size = static_cast<size_t>(this->max_number_of_peaks);
+
+        SegmentedMetricDictionary output_dictionary;
+
+        for (size_t segment = 0; segment < run_segment_ids.size(); ++segment) {
+            auto& segment_output = output_dictionary[run_segment_ids[segment]];
+
+            for (const auto& [channel_name, metric_dictionary] : segment_metrics) {
+                for (const auto& [metric_name, metric_values] : metric_dictionary) {
+                    segment_output[channel_name][metric_name].assign(
+                        metric_values.begin() + static_cast<std::ptrdiff_t>(segment * row_size),
+                        metric_values.begin() + static_cast<std::ptrdiff_t>((segment + 1) * row_size)
+                    );
+                }
+            }
+        }
+
+        return output_dictionary;
+    }
+
+    SegmentedSignalDictionary segmented_signals;
 
+    for (const auto& [channel_name, signal_vector] : flat_signals) {
         for (size_t sample_index = 0; sample_index < number_of_samples; ++sample_index) {
             segmented_signals[segment_ids[sample_index]][channel_name].push_back(
                 signal_vector[sample_index]
@@ -1019,6 +1383,214 @@ SegmentedMetricDictionary BasePeakLocator::run_flat_segmented_signals(
 }
 
 
+/**
+ * @brief Compute metrics for segments stored contiguously with CSR offsets.
+ *
+ * Parameters
+ * ----------
+ * segment_offsets :
+ *     Offsets of the segments in the channel buffers.
+ * segmented_signals :
+ *     Views of the concatenated per-channel segments.
+ * trigger_channel :
+ *     Trigger channel used when PulseSupport(channel="default") is configured.
+ *
+ * Returns
+ * -------
+ * EventMetricDictionary
+ *     Segment-major metrics of every channel.
+ */
+EventMetricDictionary BasePeakLocator::run_segment_offsets(
+    const std::vector<size_t>& segment_offsets,
+    const SignalViewDictionary& segmented_signals,
+    const std::string& trigger_channel
+) const {
+    FLOWCYPY_PROFILE_SCOPE("peak_locator.run_segment_offsets");
+
+    if (segment_offsets.empty() || segment_offsets.front() != 0) {
+        throw std::runtime_error("segment_offsets must start at 0.");
+    }
+
+    FLOWCYPY_PROFILE_COUNT("peak_locator.run_segment_offsets", "events", segment_offsets.size() - 1);
+    FLOWCYPY_PROFILE_COUNT("peak_locator.run_segment_offsets", "samples", segment_offsets.back() * segmented_signals.size());
+
+    for (const auto& [channel_name, signal] : segmented_signals) {
+        if (signal.size() != segment_offsets.back()) {
+            throw std::runtime_error(
+                "Channel '" + channel_name + "' has length " +
+                std::to_string(signal.size()) +
+                " but segment_offsets ends at " +
+                std::to_string(segment_offsets.back()) + "."
+            );
+        }
+    }
+
+    std::vector<std::pair<int, int>> segment_windows;
+    segment_windows.reserve(segment_offsets.size() - 1);
+
+    for (size_t segment = 0; segment + 1 < segment_offsets.size(); ++segment) {
+        if (segment_offsets[segment + 1] <= segment_offsets[segment]) {
+            throw std::runtime_error("segment_offsets must be strictly increasing.");
+        }
+
+        segment_windows.emplace_back(
+            static_cast<int>(segment_offsets[segment]),
+            static_cast<int>(segment_offsets[segment + 1] - 1)
+        );
+    }
+
+    return this->run_event_windows(segmented_signals, segment_windows, trigger_channel);
+}
+
+
+/**
+ * @brief Compute metrics for event windows of full acquisition signals.
+ *
+ * Parameters
+ * ----------
+ * signals :
+ *     Views of the full per-channel signals.
+ * event_windows :
+ *     Inclusive (start, end) sample indices of each event.
+ * trigger_channel :
+ *     Trigger channel used when PulseSupport(channel="default") is configured.
+ *
+ * Returns
+ * -------
+ * EventMetricDictionary
+ *     Event-major metrics of every channel.
+ */
+EventMetricDictionary BasePeakLocator::run_event_windows(
+    const SignalViewDictionary& signals,
+    const std::vector<std::pair<int, int>>& event_windows,
+    const std::string& trigger_channel
+) const {
+    if (signals.empty()) {
+        throw std::runtime_error(
+            "signals must contain at least one signal channel."
+        );
+    }
+
+    for (const auto& [start, end] : event_windows) {
+        if (start < 0 || end < start) {
+            throw std::runtime_error("Event windows must satisfy 0 <= start <= end.");
+        }
+
+        for (const auto& [channel_name, signal] : signals) {
+            if (static_cast<size_t>(end) >= signal.size()) {
+                throw std::runtime_error(
+                    "Event window ending at sample " + std::to_string(end) +
+                    " exceeds the length of channel '" + channel_name + "'."
+                );
+            }
+        }
+    }
+
+    const size_t number_of_events = event_windows.size();
+    const size_t row_size = static_cast<size_t>(this->max_number_of_peaks);
+
+    // Columns are allocated once per channel, and each (event, channel) task writes its own row.
+    struct ChannelTask {
+        std::span<const double> value_signal;
+        std::span<const double> support_signal;
+        PeakColumns columns;
+    };
+
+    EventMetricDictionary output;
+    std::vector<ChannelTask> channel_tasks;
+
+    for (const auto& [channel_name, signal] : signals) {
+        const std::string support_channel_name = resolve_support_channel_name_in(
+            *this->support,
+            signals,
+            channel_name,
+            trigger_channel
+        );
+
+        MetricDictionary& metrics = output[channel_name];
+        PeakColumns columns;
+
+        metrics["Index"].resize(number_of_events * row_size);
+        metrics["Height"].resize(number_of_events * row_size);
+        columns.index = metrics["Index"].data();
+        columns.height = metrics["Height"].data();
+
+        if (this->compute_width) {
+            metrics["Width"].resize(number_of_events * row_size);
+            columns.width = metrics["Width"].data();
+        }
+
+        if (this->compute_area) {
+            metrics["Area"].resize(number_of_events * row_size);
+            columns.area = metrics["Area"].data();
+        }
+
+        channel_tasks.push_back({signal, signals.at(support_channel_name), columns});
+    }
+
+    const size_t number_of_channels = channel_tasks.size();
+
+    // With a shared support channel and support tables, one task handles every channel
+    // of an event, so the support tables of the event are built once.
+    const size_t channels_per_task =
+        (this->use_prefix_sums && !this->support->is_full_window() && !this->support->is_independent())
+            ? number_of_channels
+            : 1;
+
+    const long long number_of_tasks =
+        static_cast<long long>(number_of_events * number_of_channels / channels_per_task);
+
+    size_t number_of_window_samples = 0;
+
+    for (const auto& [start, end] : event_windows) {
+        number_of_window_samples += static_cast<size_t>(end - start + 1);
+    }
+
+    std::exception_ptr first_error;
+
+    #pragma omp parallel num_threads(utils::get_team_size(number_of_window_samples * number_of_channels, utils::ParallelComponent::peak_locator))
+    {
+        PeakWorkspace workspace;
+
+        #pragma omp for schedule(dynamic, 16)
+        for (long long task = 0; task < number_of_tasks; ++task) {
+            const size_t first_row = static_cast<size_t>(task) * channels_per_task;
+
+            try {
+                for (size_t row = first_row; row < first_row + channels_per_task; ++row) {
+                    const size_t event = row / number_of_channels;
+                    const ChannelTask& channel_task = channel_tasks[row % number_of_channels];
+
+                    const size_t start = static_cast<size_t>(event_windows[event].first);
+                    const size_t length = static_cast<size_t>(event_windows[event].second) - start + 1;
+
+                    this->write_peak_row(
+                        channel_task.value_signal.subspan(start, length),
+                        channel_task.support_signal.subspan(start, length),
+                        channel_task.columns,
+                        event,
+                        workspace
+                    );
+                }
+            } catch (...) {
+                #pragma omp critical
+                {
+                    if (!first_error) {
+                        first_error = std::current_exception();
+                    }
+                }
+            }
+        }
+    }
+
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+
+    return output;
+}
+
+
 // -------------------- SlidingWindowPeakLocator --------------------
 /**
  * @brief Construct a sliding window peak locator.
@@ -1077,26 +1649,6 @@ SlidingWindowPeakLocator::SlidingWindowPeakLocator(
 }
 
 
-/**
- * @brief Detect peaks using the same signal for value and support.
- *
- * Parameters
- * ----------
- * signal :
- *     Input signal.
- *
- * Returns
- * -------
- * std::vector<PeakData>
- *     Detected peaks.
- */
-std::vector<PeakData> SlidingWindowPeakLocator::locate_peaks(
-    const std::vector<double>& signal
-) const {
-    return this->locate_peaks_with_support(signal, signal);
-}
-
-
 /**
  * @brief Detect peaks using a value signal and a separate support signal.
  *
@@ -1107,14 +1659,14 @@ std::vector<PeakData> SlidingWindowPeakLocator::locate_peaks(
  * support_signal :
  *     Signal used to define support boundaries.
  *
- * Returns
- * -------
- * std::vector<PeakData>
- *     Detected peaks.
+ * workspace :
+ *     Scratch memory receiving the peaks of the max_number_of_peaks highest
+ *     windows, by descending height.
  */
-std::vector<PeakData> SlidingWindowPeakLocator::locate_peaks_with_support(
-    const std::vector<double>& value_signal,
-    const std::vector<double>& support_signal
+void SlidingWindowPeakLocator::locate_peaks_into(
+    std::span<const double> value_signal,
+    std::span<const double> support_signal,
+    PeakWorkspace& workspace
 ) const {
     this->validate_input_signal(value_signal);
     this->validate_input_signal(support_signal);
@@ -1124,68 +1676,214 @@ std::vector<PeakData> SlidingWindowPeakLocator::locate_peaks_with_support(
     }
 
     const size_t number_of_samples = value_signal.size();
+    const size_t window_size = static_cast<size_t>(this->window_size);
+    const size_t window_step = static_cast<size_t>(this->window_step);
 
-    std::vector<PeakData> peaks;
-    peaks.reserve(
-        (number_of_samples + static_cast<size_t>(this->window_step) - 1) /
-        static_cast<size_t>(this->window_step)
-    );
+    // Window maxima are followed with a monotonic queue: window starts and ends only
+    // move forward, so every sample is pushed and popped at most once. Equal values
+    // are kept behind the earlier one, so the front is the first maximum of the window,
+    // as returned by find_local_peak. NaN samples are never pushed; a window starting
+    // on a NaN has its peak at its start, as in find_local_peak.
+    using WindowCandidate = PeakWorkspace::WindowCandidate;
 
-    for (size_t start = 0; start < number_of_samples; start += static_cast<size_t>(this->window_step)) {
-        const size_t end = std::min(
-            start + static_cast<size_t>(this->window_size),
-            number_of_samples
-        );
+    std::vector<WindowCandidate>& candidates = workspace.window_candidates;
+    std::vector<size_t>& maximum_indices = workspace.window_maxima;
 
-        if (end <= start) {
-            continue;
+    candidates.clear();
+    maximum_indices.clear();
+
+    size_t queue_front = 0;
+    size_t next_sample = 0;
+
+    for (size_t start = 0; start < number_of_samples; start += window_step) {
+        const size_t end = std::min(start + window_size, number_of_samples);
+
+        next_sample = std::max(next_sample, start);
+
+        for (; next_sample < end; ++next_sample) {
+            const double sample = value_signal[next_sample];
+
+            if (std::isnan(sample)) {
+                continue;
+            }
+
+            while (maximum_indices.size() > queue_front && value_signal[maximum_indices.back()] < sample) {
+                maximum_indices.pop_back();
+            }
+
+            maximum_indices.push_back(next_sample);
+        }
+
+        while (maximum_indices.size() > queue_front && maximum_indices[queue_front] < start) {
+            ++queue_front;
+        }
+
+        const size_t value_peak_index =
+            (std::isnan(value_signal[start]) || maximum_indices.size() == queue_front)
+                ? start
+                : maximum_indices[queue_front];
+
+        candidates.push_back({start, end, value_peak_index, value_signal[value_peak_index]});
+    }
+
+    if (this->compute_width || this->compute_area) {
+        this->prepare_support_tables(value_signal, support_signal, workspace);
+    }
+
+    // Only the highest max_number_of_peaks windows are kept, ties going to the earlier window.
+    const size_t number_of_kept_peaks = std::min(
+        static_cast<size_t>(this->max_number_of_peaks),
+        candidates.size()
+    );
+
+    std::partial_sort(
+        candidates.begin(),
+        candidates.begin() + static_cast<std::ptrdiff_t>(number_of_kept_peaks),
+        candidates.end(),
+        [](const WindowCandidate& left, const WindowCandidate& right) {
+            return is_higher_peak(left.value, left.start, right.value, right.start);
         }
+    );
+
+    candidates.resize(number_of_kept_peaks);
 
-        const size_t support_peak_index = this->find_local_peak(support_signal.data(), start, end);
-        const size_t value_peak_index = this->find_local_peak(value_signal.data(), start, end);
-        const double peak_value = value_signal[value_peak_index];
+    std::vector<PeakData>& peaks = workspace.peaks;
+    peaks.clear();
 
+    for (const WindowCandidate& candidate : candidates) {
         double width = static_cast<double>(this->padding_value);
         double area = static_cast<double>(this->padding_value);
 
-        const bool should_compute_metrics =
-            (this->compute_width || this->compute_area) &&
-            (
-                this->support->is_full_window() ||
-                support_signal[support_peak_index] > 0.0
-            );
+        if (this->compute_width || this->compute_area) {
+            const size_t support_peak_index = (support_signal.data() == value_signal.data())
+                ? candidate.peak_index
+                : this->find_local_peak(support_signal.data(), candidate.start, candidate.end);
 
-        if (should_compute_metrics) {
-            const PeakMetrics metrics = this->compute_segment_metrics(
-                value_signal.data(),
-                support_signal.data(),
-                start,
-                end,
-                support_peak_index
-            );
+            const bool should_compute_metrics =
+                this->support->is_full_window() ||
+                support_signal[support_peak_index] > 0.0;
+
+            if (should_compute_metrics) {
+                const PeakMetrics metrics = this->compute_segment_metrics(
+                    value_signal.data(),
+                    support_signal.data(),
+                    candidate.start,
+                    candidate.end,
+                    support_peak_index,
+                    &workspace
+                );
 
-            if (this->compute_width) {
-                width = metrics.width;
-            }
+                if (this->compute_width) {
+                    width = metrics.width;
+                }
 
-            if (this->compute_area) {
-                area = metrics.area;
+                if (this->compute_area) {
+                    area = metrics.area;
+                }
             }
         }
 
         peaks.emplace_back(
-            static_cast<int>(value_peak_index),
-            peak_value,
+            static_cast<int>(candidate.peak_index),
+            candidate.value,
             width,
             area
         );
     }
-
-    return peaks;
 }
 
 
 // -------------------- GlobalPeakLocator --------------------
+PeakPolarity parse_peak_polarity(const std::string& name) {
+    if (name == "positive") {
+        return PeakPolarity::positive;
+    }
+
+    if (name == "negative") {
+        return PeakPolarity::negative;
+    }
+
+    if (name == "absolute") {
+        return PeakPolarity::absolute;
+    }
+
+    throw std::runtime_error(
+        "GlobalPeakLocator polarity must be one of: 'positive', 'negative', 'absolute'."
+    );
+}
+
+
+PeakHeightMode parse_peak_height_mode(const std::string& name) {
+    if (name == "raw") {
+        return PeakHeightMode::raw;
+    }
+
+    if (name == "peak_to_baseline") {
+        return PeakHeightMode::peak_to_baseline;
+    }
+
+    if (name == "peak_to_peak") {
+        return PeakHeightMode::peak_to_peak;
+    }
+
+    throw std::runtime_error(
+        "GlobalPeakLocator height_mode must be one of: 'raw', 'peak_to_baseline', 'peak_to_peak'."
+    );
+}
+
+
+PeakBaselineMode parse_peak_baseline_mode(const std::string& name) {
+    if (name == "zero") {
+        return PeakBaselineMode::zero;
+    }
+
+    if (name == "segment_mean") {
+        return PeakBaselineMode::segment_mean;
+    }
+
+    if (name == "edge_mean") {
+        return PeakBaselineMode::edge_mean;
+    }
+
+    throw std::runtime_error(
+        "GlobalPeakLocator baseline_mode must be one of: 'zero', 'segment_mean', 'edge_mean'."
+    );
+}
+
+
+std::string to_string(const PeakPolarity polarity) {
+    switch (polarity) {
+        case PeakPolarity::positive: return "positive";
+        case PeakPolarity::negative: return "negative";
+        case PeakPolarity::absolute: return "absolute";
+    }
+
+    return "unknown";
+}
+
+
+std::string to_string(const PeakHeightMode height_mode) {
+    switch (height_mode) {
+        case PeakHeightMode::raw: return "raw";
+        case PeakHeightMode::peak_to_baseline: return "peak_to_baseline";
+        case PeakHeightMode::peak_to_peak: return "peak_to_peak";
+    }
+
+    return "unknown";
+}
+
+
+std::string to_string(const PeakBaselineMode baseline_mode) {
+    switch (baseline_mode) {
+        case PeakBaselineMode::zero: return "zero";
+        case PeakBaselineMode::segment_mean: return "segment_mean";
+        case PeakBaselineMode::edge_mean: return "edge_mean";
+    }
+
+    return "unknown";
+}
+
+
 /**
  * @brief Construct a global peak locator.
  *
@@ -1227,12 +1925,11 @@ GlobalPeakLocator::GlobalPeakLocator(
           std::move(support),
           debug_mode
       ),
-      polarity(polarity),
-      height_mode(height_mode),
-      baseline_mode(baseline_mode)
+      polarity(parse_peak_polarity(polarity)),
+      height_mode(parse_peak_height_mode(height_mode)),
+      baseline_mode(parse_peak_baseline_mode(baseline_mode)),
+      measurement_kernel(select_measurement_kernel(this->polarity, this->height_mode, this->baseline_mode))
 {
-    this->validate_measurement_modes();
-
     if (this->debug_mode) {
         std::printf(
             "[GlobalPeakLocator] Initialized | support=%s | compute_width=%d | compute_area=%d | allow_negative_area=%d | padding_value=%d | max_number_of_peaks=%d | polarity=%s | height_mode=%s | baseline_mode=%s\n",
@@ -1242,155 +1939,14 @@ GlobalPeakLocator::GlobalPeakLocator(
             static_cast<int>(this->allow_negative_area),
             this->padding_value,
             this->max_number_of_peaks,
-            this->polarity.c_str(),
-            this->height_mode.c_str(),
-            this->baseline_mode.c_str()
-        );
-    }
-}
-
-
-void GlobalPeakLocator::validate_measurement_modes() const {
-    if (!is_supported_global_polarity(this->polarity)) {
-        throw std::runtime_error(
-            "GlobalPeakLocator polarity must be one of: 'positive', 'negative', 'absolute'."
-        );
-    }
-
-    if (!is_supported_global_height_mode(this->height_mode)) {
-        throw std::runtime_error(
-            "GlobalPeakLocator height_mode must be one of: 'raw', 'peak_to_baseline', 'peak_to_peak'."
-        );
-    }
-
-    if (!is_supported_global_baseline_mode(this->baseline_mode)) {
-        throw std::runtime_error(
-            "GlobalPeakLocator baseline_mode must be one of: 'zero', 'segment_mean', 'edge_mean'."
+            to_string(this->polarity).c_str(),
+            to_string(this->height_mode).c_str(),
+            to_string(this->baseline_mode).c_str()
         );
     }
 }
 
 
-double GlobalPeakLocator::compute_baseline(
-    const std::vector<double>& signal,
-    size_t start,
-    size_t end,
-    size_t left_boundary,
-    size_t right_boundary
-) const {
-    if (this->baseline_mode == "zero") {
-        return 0.0;
-    }
-
-    if (this->baseline_mode == "segment_mean") {
-        double sum = 0.0;
-
-        for (size_t index = start; index < end; ++index) {
-            sum += signal[index];
-        }
-
-        return sum / static_cast<double>(end - start);
-    }
-
-    return 0.5 * (signal[left_boundary] + signal[right_boundary]);
-}
-
-
-size_t GlobalPeakLocator::find_measurement_peak_index(
-    const std::vector<double>& signal,
-    size_t start,
-    size_t end,
-    double baseline
-) const {
-    if (this->polarity == "positive") {
-        return this->find_local_peak(signal.data(), start, end);
-    }
-
-    if (this->polarity == "negative") {
-        size_t best_index = start;
-        double minimum_value = signal[start];
-
-        for (size_t index = start + 1; index < end; ++index) {
-            if (signal[index] < minimum_value) {
-                minimum_value = signal[index];
-                best_index = index;
-            }
-        }
-
-        return best_index;
-    }
-
-    size_t best_index = start;
-    double maximum_excursion = std::abs(signal[start] - baseline);
-
-    for (size_t index = start + 1; index < end; ++index) {
-        const double excursion = std::abs(signal[index] - baseline);
-
-        if (excursion > maximum_excursion) {
-            maximum_excursion = excursion;
-            best_index = index;
-        }
-    }
-
-    return best_index;
-}
-
-
-double GlobalPeakLocator::compute_peak_height(
-    const std::vector<double>& signal,
-    size_t left_boundary,
-    size_t right_boundary,
-    size_t peak_index,
-    double baseline
-) const {
-    const double peak_value = signal[peak_index];
-
-    if (this->height_mode == "raw") {
-        return peak_value;
-    }
-
-    if (this->height_mode == "peak_to_baseline") {
-        if (this->polarity == "positive") {
-            return peak_value - baseline;
-        }
-
-        if (this->polarity == "negative") {
-            return baseline - peak_value;
-        }
-
-        return std::abs(peak_value - baseline);
-    }
-
-    double minimum_value = signal[left_boundary];
-    double maximum_value = signal[left_boundary];
-
-    for (size_t index = left_boundary + 1; index <= right_boundary; ++index) {
-        minimum_value = std::min(minimum_value, signal[index]);
-        maximum_value = std::max(maximum_value, signal[index]);
-    }
-
-    return maximum_value - minimum_value;
-}
-
-
-/**
- * @brief Detect a global peak using the same signal for value and support.
- *
- * Parameters
- * ----------
- * signal :
- *     Input signal.
- *
- * Returns
- * -------
- * std::vector<PeakData>
- *     Detected peak.
- */
-std::vector<PeakData> GlobalPeakLocator::locate_peaks(const std::vector<double>& signal) const {
-    return this->locate_peaks_with_support(signal, signal);
-}
-
-
 /**
  * @brief Detect a global peak using a value signal and a separate support signal.
  *
@@ -1401,14 +1957,13 @@ std::vector<PeakData> GlobalPeakLocator::locate_peaks(const std::vector<double>&
  * support_signal :
  *     Signal used to define support boundaries.
  *
- * Returns
- * -------
- * std::vector<PeakData>
- *     Detected peak.
+ * workspace :
+ *     Scratch memory receiving the detected peak.
  */
-std::vector<PeakData> GlobalPeakLocator::locate_peaks_with_support(
-    const std::vector<double>& value_signal,
-    const std::vector<double>& support_signal
+void GlobalPeakLocator::locate_peaks_into(
+    std::span<const double> value_signal,
+    std::span<const double> support_signal,
+    PeakWorkspace& workspace
 ) const {
     this->validate_input_signal(value_signal);
     this->validate_input_signal(support_signal);
@@ -1419,6 +1974,8 @@ std::vector<PeakData> GlobalPeakLocator::locate_peaks_with_support(
 
     const size_t signal_size = value_signal.size();
 
+    this->prepare_support_tables(value_signal, support_signal, workspace);
+
     const size_t support_peak_index = this->find_local_peak(
         support_signal.data(),
         0,
@@ -1434,31 +1991,14 @@ std::vector<PeakData> GlobalPeakLocator::locate_peaks_with_support(
         signal_size,
         support_peak_index,
         left_boundary,
-        right_boundary
-    );
-
-    const double baseline = this->compute_baseline(
-        value_signal,
-        0,
-        signal_size,
-        left_boundary,
-        right_boundary
+        right_boundary,
+        &workspace
     );
 
-    const size_t value_peak_index = this->find_measurement_peak_index(
-        value_signal,
-        left_boundary,
-        right_boundary + 1,
-        baseline
-    );
+    const GlobalPeakMeasurement measurement = this->measure_peak(value_signal, left_boundary, right_boundary);
 
-    const double peak_value = this->compute_peak_height(
-        value_signal,
-        left_boundary,
-        right_boundary,
-        value_peak_index,
-        baseline
-    );
+    const size_t value_peak_index = measurement.peak_index;
+    const double peak_value = measurement.height;
 
     double width = static_cast<double>(this->padding_value);
     double area = static_cast<double>(this->padding_value);
@@ -1475,7 +2015,8 @@ std::vector<PeakData> GlobalPeakLocator::locate_peaks_with_support(
             support_signal.data(),
             0,
             signal_size,
-            support_peak_index
+            support_peak_index,
+            &workspace
         );
 
         if (this->compute_width) {
@@ -1501,22 +2042,21 @@ std::vector<PeakData> GlobalPeakLocator::locate_peaks_with_support(
             value_peak_index,
             left_boundary,
             right_boundary,
-            baseline,
-            this->polarity.c_str(),
-            this->height_mode.c_str(),
-            this->baseline_mode.c_str(),
+            measurement.baseline,
+            to_string(this->polarity).c_str(),
+            to_string(this->height_mode).c_str(),
+            to_string(this->baseline_mode).c_str(),
             peak_value,
             width,
             area
         );
     }
 
-    return std::vector<PeakData>{
-        PeakData(
-            static_cast<int>(value_peak_index),
-            peak_value,
-            width,
-            area
-        )
-    };
+    workspace.peaks.clear();
+    workspace.peaks.emplace_back(
+        static_cast<int>(value_peak_index),
+        peak_value,
+        width,
+        area
+    );
 }
@@ -2,7 +2,9 @@
 
 #include <map>
 #include <memory>
+#include <span>
 #include <string>
+#include <utility>
 #include <vector>
 
 
@@ -60,6 +62,32 @@ using SegmentedSignalDictionary = std::map<int, std::map<std::string, std::vecto
 using SegmentedMetricDictionary = std::map<int, std::map<std::string, MetricDictionary>>;
 
 
+/**
+ * @brief Dictionary mapping channel names to non-owning views of full signals.
+ */
+using SignalViewDictionary = std::map<std::string, std::span<const double>>;
+
+/**
+ * @brief Dictionary mapping channel names to event-major metric dictionaries.
+ *
+ * The nested structure is:
+ *
+ *     {
+ *         channel_name: {
+ *             "Index": [...],
+ *             "Height": [...],
+ *             "Width": [...],
+ *             "Area": [...],
+ *         },
+ *         ...
+ *     }
+ *
+ * Each metric vector holds `max_number_of_peaks` values per event, so the
+ * metrics of event k occupy [k * max_number_of_peaks, (k + 1) * max_number_of_peaks).
+ */
+using EventMetricDictionary = std::map<std::string, MetricDictionary>;
+
+
 /**
  * @brief Container storing one detected peak and its optional metrics.
  *
@@ -85,6 +113,72 @@ struct PeakData {
 };
 
 
+/**
+ * @brief Non-owning column buffers receiving peak metrics row by row.
+ *
+ * Row k of a column holds the metrics of signal k and spans
+ * [k * max_number_of_peaks, (k + 1) * max_number_of_peaks). Columns of
+ * metrics that are not computed are left null and never touched.
+ */
+struct PeakColumns {
+    double* index = nullptr;
+    double* height = nullptr;
+    double* width = nullptr;
+    double* area = nullptr;
+};
+
+
+/**
+ * @brief Scratch memory reused across peak locator calls.
+ *
+ * The buffers are cleared, not released, between calls, so once they have
+ * grown to the largest signal a locator sees, further calls do not allocate.
+ * A workspace must not be shared between threads.
+ */
+struct PeakWorkspace {
+    /// Window of a SlidingWindowPeakLocator and the first maximum of its value signal.
+    struct WindowCandidate {
+        size_t start;
+        size_t end;
+        size_t peak_index;
+        double value;
+    };
+
+    /// Located peaks, by descending height.
+    std::vector<PeakData> peaks;
+
+    std::vector<WindowCandidate> window_candidates;
+
+    /// Monotonic queue of window maximum indices.
+    std::vector<size_t> window_maxima;
+
+    /// Prefix sums of the area integrand of the value signal, non finite samples counting as 0.
+    std::vector<double> area_prefix_sums;
+
+    /// Prefix counts of the non finite samples of the value signal.
+    std::vector<size_t> non_finite_prefix_counts;
+
+    /// Minimum of each block of support_block_size support samples, -inf for blocks holding a NaN.
+    std::vector<double> support_block_minima;
+
+    /// Signals the tables were built for.
+    const double* area_source = nullptr;
+    const double* support_source = nullptr;
+    size_t support_source_size = 0;
+
+    static constexpr size_t support_block_size = 64;
+
+    /**
+     * @brief Forget the support tables, to be called when the support samples change in place.
+     */
+    void invalidate_tables() {
+        this->area_source = nullptr;
+        this->support_source = nullptr;
+        this->support_source_size = 0;
+    }
+};
+
+
 /**
  * @brief Internal container describing the support used for width and area.
  *
@@ -270,11 +364,17 @@ public:
     bool debug_mode;
     std::shared_ptr<BaseSupport> support;
 
+    /// Whether width and area are computed from prefix sums and support block minima.
+    bool use_prefix_sums = false;
+
     std::vector<int> peak_indices;
     std::vector<double> peak_heights;
     std::vector<double> peak_widths;
     std::vector<double> peak_areas;
 
+    /// Scratch memory of compute().
+    PeakWorkspace workspace;
+
     BasePeakLocator(
         bool compute_width,
         bool compute_area,
@@ -300,7 +400,7 @@ public:
      * std::runtime_error
      *     If the signal is empty.
      */
-    void validate_input_signal(const std::vector<double>& array) const;
+    void validate_input_signal(std::span<const double> array) const;
 
     /**
      * @brief Find the index of the maximum value in [start, end).
@@ -353,6 +453,9 @@ public:
      *     Output inclusive left support boundary.
      * right_boundary :
      *     Output inclusive right support boundary.
+     * workspace :
+     *     Workspace whose support block minima, when built for `ptr`, are
+     *     used to skip whole blocks above the threshold.
      */
     void compute_boundaries(
         const double* ptr,
@@ -360,7 +463,8 @@ public:
         size_t end,
         size_t peak_index,
         size_t& left_boundary,
-        size_t& right_boundary
+        size_t& right_boundary,
+        const PeakWorkspace* workspace = nullptr
     ) const;
 
     /**
@@ -376,6 +480,9 @@ public:
      *     Exclusive interval end.
      * peak_index :
      *     Peak index used to build the support.
+     * workspace :
+     *     Workspace whose tables, when built for these signals, give the area
+     *     from two prefix sums instead of a sum over the support.
      *
      * Returns
      * -------
@@ -387,7 +494,31 @@ public:
         const double* support_ptr,
         size_t start,
         size_t end,
-        size_t peak_index
+        size_t peak_index,
+        const PeakWorkspace* workspace = nullptr
+    ) const;
+
+    /**
+     * @brief Build the prefix sum and support tables of a workspace.
+     *
+     * Does nothing unless `use_prefix_sums` is set. The area prefix sums are
+     * rebuilt for every value signal, while the support block minima are kept
+     * as long as the same support signal is passed, so channels sharing one
+     * support channel build them once.
+     *
+     * Parameters
+     * ----------
+     * value_signal :
+     *     Signal used for area accumulation.
+     * support_signal :
+     *     Signal used to define support boundaries.
+     * workspace :
+     *     Workspace receiving the tables.
+     */
+    void prepare_support_tables(
+        std::span<const double> value_signal,
+        std::span<const double> support_signal,
+        PeakWorkspace& workspace
     ) const;
 
     /**
@@ -405,7 +536,7 @@ public:
      *     Dictionary containing Index, Height, and optionally Width and Area.
      */
     MetricDictionary compute_metric_dictionary(
-        const std::vector<double>& array
+        std::span<const double> array
     ) const;
 
     /**
@@ -424,13 +555,42 @@ public:
      *     Dictionary containing Index, Height, and optionally Width and Area.
      */
     MetricDictionary compute_metric_dictionary_with_shared_support(
-        const std::vector<double>& value_signal,
-        const std::vector<double>& support_signal
+        std::span<const double> value_signal,
+        std::span<const double> support_signal
+    ) const;
+
+    /**
+     * @brief Locate the peaks of one signal and write one row of metric columns.
+     *
+     * Slots beyond the located peaks are set to the padding value. Width and
+     * area are only written when their columns are set.
+     *
+     * Parameters
+     * ----------
+     * value_signal :
+     *     Signal used for peak value extraction and area accumulation.
+     * support_signal :
+     *     Signal used to define support boundaries.
+     * columns :
+     *     Destination column buffers.
+     * row :
+     *     Row of the columns to write.
+     * workspace :
+     *     Scratch memory of the calling thread.
+     */
+    void write_peak_row(
+        std::span<const double> value_signal,
+        std::span<const double> support_signal,
+        const PeakColumns& columns,
+        size_t row,
+        PeakWorkspace& workspace
     ) const;
 
     /**
      * @brief Sort detected peaks by descending height.
      *
+     * The sort is stable and places NaN heights last.
+     *
      * Parameters
      * ----------
      * peaks :
@@ -451,7 +611,7 @@ public:
      * array :
      *     Input signal.
      */
-    void compute(const std::vector<double>& array);
+    void compute(std::span<const double> array);
 
     /**
      * @brief Return one stored metric buffer.
@@ -481,7 +641,7 @@ public:
      * MetricDictionary
      *     Dictionary containing computed metrics.
      */
-    MetricDictionary get_metrics(const std::vector<double>& array);
+    MetricDictionary get_metrics(std::span<const double> array);
 
     /**
      * @brief Compute metrics for all channels in segmented multi-channel data.
@@ -507,6 +667,10 @@ public:
     /**
      * @brief Regroup flat per-sample signals by segment id, then compute metrics.
      *
+     * Segment ids laid out in increasing contiguous runs, as produced by the
+     * discriminators, are processed in place with run_segment_offsets. Other
+     * layouts are regrouped first.
+     *
      * Parameters
      * ----------
      * segment_ids :
@@ -528,6 +692,77 @@ public:
         const std::string& trigger_channel = ""
     ) const;
 
+    /**
+     * @brief Compute metrics for event windows directly on full signals.
+     *
+     * This is the segmented computation without the segments: each window is
+     * analyzed through a view of the original channel buffers, in parallel over
+     * events and channels, and only the per-event metrics are written.
+     *
+     * Parameters
+     * ----------
+     * signals :
+     *     Views of the full per-channel signals.
+     * event_windows :
+     *     Inclusive (start, end) sample indices of each event, as returned by
+     *     a discriminator.
+     * trigger_channel :
+     *     Trigger channel name used when PulseSupport(channel="default") is
+     *     configured.
+     *
+     * Returns
+     * -------
+     * EventMetricDictionary
+     *     Event-major metrics of every channel. Peak indices are relative to
+     *     the start of their event window, as in segmented mode.
+     *
+     * Throws
+     * ------
+     * std::runtime_error
+     *     If a window is empty or exceeds the length of a channel.
+     */
+    EventMetricDictionary run_event_windows(
+        const SignalViewDictionary& signals,
+        const std::vector<std::pair<int, int>>& event_windows,
+        const std::string& trigger_channel = ""
+    ) const;
+
+    /**
+     * @brief Compute metrics for segments stored contiguously with CSR offsets.
+     *
+     * Segment k occupies samples [segment_offsets[k], segment_offsets[k + 1])
+     * of every channel buffer, which is the layout of the discriminator
+     * trigger output. Segments are processed in parallel as in
+     * run_event_windows.
+     *
+     * Parameters
+     * ----------
+     * segment_offsets :
+     *     Offsets of the segments, starting at 0 and ending at the length of
+     *     the channel buffers.
+     * segmented_signals :
+     *     Views of the concatenated per-channel segments.
+     * trigger_channel :
+     *     Trigger channel name used when PulseSupport(channel="default") is
+     *     configured.
+     *
+     * Returns
+     * -------
+     * EventMetricDictionary
+     *     Segment-major metrics of every channel.
+     *
+     * Throws
+     * ------
+     * std::runtime_error
+     *     If the offsets are not strictly increasing from 0 to the length of
+     *     every channel buffer.
+     */
+    EventMetricDictionary run_segment_offsets(
+        const std::vector<size_t>& segment_offsets,
+        const SignalViewDictionary& segmented_signals,
+        const std::string& trigger_channel = ""
+    ) const;
+
     /**
      * @brief Resolve the support channel name for a given current channel.
      *
@@ -562,11 +797,11 @@ public:
      * Returns
      * -------
      * std::vector<PeakData>
-     *     Detected peaks.
+     *     Detected peaks, by descending height.
      */
-    virtual std::vector<PeakData> locate_peaks(
-        const std::vector<double>& signal
-    ) const = 0;
+    std::vector<PeakData> locate_peaks(
+        std::span<const double> signal
+    ) const;
 
     /**
      * @brief Detect peaks using a value signal and a separate support signal.
@@ -581,11 +816,30 @@ public:
      * Returns
      * -------
      * std::vector<PeakData>
-     *     Detected peaks.
+     *     Detected peaks, by descending height.
+     */
+    std::vector<PeakData> locate_peaks_with_support(
+        std::span<const double> value_signal,
+        std::span<const double> support_signal
+    ) const;
+
+    /**
+     * @brief Detect peaks into the scratch memory of the calling thread.
+     *
+     * Parameters
+     * ----------
+     * value_signal :
+     *     Signal used for peak value extraction and area accumulation.
+     * support_signal :
+     *     Signal used to define support boundaries.
+     * workspace :
+     *     Scratch memory. On return, `workspace.peaks` holds at most
+     *     `max_number_of_peaks` peaks by descending height.
      */
-    virtual std::vector<PeakData> locate_peaks_with_support(
-        const std::vector<double>& value_signal,
-        const std::vector<double>& support_signal
+    virtual void locate_peaks_into(
+        std::span<const double> value_signal,
+        std::span<const double> support_signal,
+        PeakWorkspace& workspace
     ) const = 0;
 };
 
@@ -595,6 +849,10 @@ public:
  *
  * One peak is selected in each window and the resulting peaks are sorted by
  * descending height before being written to the fixed-size output buffers.
+ *
+ * Window maxima are tracked with a monotonic queue, so the signal is scanned
+ * once whatever the overlap between windows, and width and area are only
+ * computed for the `max_number_of_peaks` highest windows.
  */
 class SlidingWindowPeakLocator : public BasePeakLocator {
 public:
@@ -613,14 +871,86 @@ public:
         bool debug_mode
     );
 
-    std::vector<PeakData> locate_peaks(
-        const std::vector<double>& signal
+    void locate_peaks_into(
+        std::span<const double> value_signal,
+        std::span<const double> support_signal,
+        PeakWorkspace& workspace
     ) const override;
+};
 
-    std::vector<PeakData> locate_peaks_with_support(
-        const std::vector<double>& value_signal,
-        const std::vector<double>& support_signal
-    ) const override;
+
+/**
+ * @brief Rule choosing the sample that represents the event of a GlobalPeakLocator.
+ *
+ * - positive: largest sample.
+ * - negative: smallest sample.
+ * - absolute: sample furthest from the baseline.
+ */
+enum class PeakPolarity {
+    positive,
+    negative,
+    absolute
+};
+
+/**
+ * @brief Conversion of the event sample into the height reported by a GlobalPeakLocator.
+ *
+ * - raw: value of the event sample.
+ * - peak_to_baseline: excursion of the event sample from the baseline, signed by the polarity.
+ * - peak_to_peak: range of the samples inside the support.
+ */
+enum class PeakHeightMode {
+    raw,
+    peak_to_baseline,
+    peak_to_peak
+};
+
+/**
+ * @brief Reference level of the baseline aware modes of a GlobalPeakLocator.
+ *
+ * - zero: 0.
+ * - segment_mean: mean of the whole window.
+ * - edge_mean: mean of the two support boundary samples.
+ */
+enum class PeakBaselineMode {
+    zero,
+    segment_mean,
+    edge_mean
+};
+
+/**
+ * @brief Parse a polarity name, "positive", "negative" or "absolute".
+ *
+ * @throws std::runtime_error If the name is not a polarity.
+ */
+PeakPolarity parse_peak_polarity(const std::string& name);
+
+/**
+ * @brief Parse a height mode name, "raw", "peak_to_baseline" or "peak_to_peak".
+ *
+ * @throws std::runtime_error If the name is not a height mode.
+ */
+PeakHeightMode parse_peak_height_mode(const std::string& name);
+
+/**
+ * @brief Parse a baseline mode name, "zero", "segment_mean" or "edge_mean".
+ *
+ * @throws std::runtime_error If the name is not a baseline mode.
+ */
+PeakBaselineMode parse_peak_baseline_mode(const std::string& name);
+
+std::string to_string(const PeakPolarity polarity);
+std::string to_string(const PeakHeightMode height_mode);
+std::string to_string(const PeakBaselineMode baseline_mode);
+
+
+/**
+ * @brief Event sample, height and baseline of one window, as measured by GlobalPeakLocator.
+ */
+struct GlobalPeakMeasurement {
+    size_t peak_index;
+    double height;
+    double baseline;
 };
 
 
@@ -629,12 +959,18 @@ public:
  *
  * Only one physical peak is detected in the full signal. Output buffers still
  * honor the configured maximum number of peaks and are padded when needed.
+ *
+ * The polarity, height and baseline modes are parsed once at construction.
+ * Each of their combinations is a separate instantiation of the measurement
+ * kernel, free of mode tests, and the instantiation matching the modes is
+ * selected at construction: measuring a window costs one indirect call
+ * instead of a chain of string comparisons.
  */
 class GlobalPeakLocator : public BasePeakLocator {
 public:
-    std::string polarity;
-    std::string height_mode;
-    std::string baseline_mode;
+    PeakPolarity polarity;
+    PeakHeightMode height_mode;
+    PeakBaselineMode baseline_mode;
 
     GlobalPeakLocator(
         int max_number_of_peaks,
@@ -649,37 +985,29 @@ public:
         bool debug_mode
     );
 
-    std::vector<PeakData> locate_peaks(
-        const std::vector<double>& signal
+    void locate_peaks_into(
+        std::span<const double> value_signal,
+        std::span<const double> support_signal,
+        PeakWorkspace& workspace
     ) const override;
 
-    std::vector<PeakData> locate_peaks_with_support(
-        const std::vector<double>& value_signal,
-        const std::vector<double>& support_signal
-    ) const override;
-
-    void validate_measurement_modes() const;
-
-    double compute_baseline(
-        const std::vector<double>& signal,
-        size_t start,
-        size_t end,
+    /**
+     * @brief Measure the event of a window whose support is [left_boundary, right_boundary].
+     *
+     * @param signal Whole window, used by the segment_mean baseline.
+     * @param left_boundary First sample of the support.
+     * @param right_boundary Last sample of the support, included.
+     */
+    GlobalPeakMeasurement measure_peak(
+        std::span<const double> signal,
         size_t left_boundary,
         size_t right_boundary
-    ) const;
+    ) const {
+        return this->measurement_kernel(signal, left_boundary, right_boundary);
+    }
 
-    size_t find_measurement_peak_index(
-        const std::vector<double>& signal,
-        size_t start,
-        size_t end,
-        double baseline
-    ) const;
+private:
+    using MeasurementKernel = GlobalPeakMeasurement (*)(std::span<const double>, size_t, size_t);
 
-    double compute_peak_height(
-        const std::vector<double>& signal,
-        size_t left_boundary,
-        size_t right_boundary,
-        size_t peak_index,
-        double baseline
-    ) const;
+    MeasurementKernel measurement_kernel = nullptr;
 };
@@ -1,7 +1,47 @@
-#include <random>
 #include "distributions.h"
 #include "detail.h"
 
+#include <utils/threading.h>
+
+
+namespace {
+
+// Fills output with inverse_cdf(lower + span * u), u uniform in (0, 1), clamped to the cutoffs.
+template <typename InverseCdf>
+void fill_by_inversion(
+    double *output,
+    const size_t n_samples,
+    const utils::CounterRandomGenerator &generator,
+    const uint64_t first_index,
+    const double lower,
+    const double span,
+    const double low_cutoff,
+    const double high_cutoff,
+    InverseCdf inverse_cdf
+) {
+    #pragma omp parallel for simd schedule(static) num_threads(utils::get_team_size(n_samples, utils::ParallelComponent::flow_cell))
+    for (size_t i = 0; i < n_samples; ++i) {
+        const double p = lower + span * generator.uniform(first_index + i);
+
+        // Numerically, x can be off by a few ulps near the bounds, clamp it safely.
+        output[i] = std::clamp(inverse_cdf(p), low_cutoff, high_cutoff);
+    }
+}
+
+}  // namespace
+
+
+std::vector<double> BaseDistribution::sample(const size_t n_samples) const {
+    std::vector<double> output(n_samples);
+
+    const utils::CounterRandomGenerator generator =
+        utils::RandomService::instance().next_generator(utils::RandomStreamId::distribution_samples);
+
+    this->sample_into(output.data(), n_samples, generator);
+
+    return output;
+}
+
 
 // __________ NORMAL _____________
 // ________________________________
@@ -14,8 +54,7 @@ Normal::Normal(
 : mean(mean),
   standard_deviation(standard_deviation),
   low_cutoff(low_cutoff),
-  high_cutoff(high_cutoff),
-  generator(std::random_device{}())
+  high_cutoff(high_cutoff)
 {
     if (!(this->standard_deviation > 0.0)) {
         throw std::invalid_argument("standard_deviation must be > 0");
@@ -25,12 +64,9 @@ Normal::Normal(
     }
 }
 
-std::vector<double> Normal::sample(const std::size_t n_samples) const {
-    std::vector<double> output;
-    output.reserve(n_samples);
-
+void Normal::sample_into(double *output, const size_t n_samples, const utils::CounterRandomGenerator &generator, const uint64_t first_index) const {
     if (n_samples == 0) {
-        return output;
+        return;
     }
 
     const double a = (low_cutoff - mean) / standard_deviation;
@@ -52,23 +88,14 @@ std::vector<double> Normal::sample(const std::size_t n_samples) const {
     // In that case, return the closest bound (still within the truncation)
     const double eps = 64.0 * std::numeric_limits<double>::epsilon();
     if (!(span > eps)) {
-        const double clamped_value = std::clamp(mean, low_cutoff, high_cutoff);
-        output.assign(n_samples, clamped_value);
-        return output;
+        std::fill(output, output + n_samples, std::clamp(mean, low_cutoff, high_cutoff));
+        return;
     }
 
-    std::uniform_real_distribution<double> uniform(Fa, Fb);
-
-    for (std::size_t i = 0; i < n_samples; ++i) {
-        const double u = uniform(generator);
-        const double z = detail::normal_inv_cdf(u);
-        const double x = mean + standard_deviation * z;
-
-        // Numerically, x can be off by a few ulps near the bounds, clamp it safely.
-        output.push_back(std::clamp(x, low_cutoff, high_cutoff));
-    }
-
-    return output;
+    fill_by_inversion(
+        output, n_samples, generator, first_index, Fa, span, low_cutoff, high_cutoff,
+        [this](const double p) { return this->mean + this->standard_deviation * detail::normal_inv_cdf(p); }
+    );
 }
 
 // Normal.cpp
@@ -93,20 +120,8 @@ double Normal::proportion_within_cutoffs() const {
 
 // __________ UNIFORM _____________
 // ________________________________
-std::vector<double>
-Uniform::sample(const size_t n_samples) const {
-    std::vector<double> output;
-    output.reserve(n_samples);
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dist(this->lower_bound, this->upper_bound);
-
-    for (size_t i = 0; i < n_samples; ++i) {
-        output.push_back(dist(gen));
-    }
-
-    return output;
+void Uniform::sample_into(double *output, const size_t n_samples, const utils::CounterRandomGenerator &generator, const uint64_t first_index) const {
+    generator.fill_uniform(output, n_samples, this->lower_bound, this->upper_bound, first_index);
 }
 
 double Uniform::proportion_within_cutoffs() const { return 1.0; }
@@ -114,13 +129,9 @@ double Uniform::proportion_within_cutoffs() const { return 1.0; }
 
 // __________ ROSIN-RAMMLER _____________
 // ______________________________________
-std::vector<double>
-RosinRammler::sample(const size_t n_samples) const {
-    std::vector<double> output;
-    output.reserve(n_samples);
-
+void RosinRammler::sample_into(double *output, const size_t n_samples, const utils::CounterRandomGenerator &generator, const uint64_t first_index) const {
     if (n_samples == 0) {
-        return output;
+        return;
     }
 
     if (!(scale > 0.0)) {
@@ -151,20 +162,14 @@ RosinRammler::sample(const size_t n_samples) const {
     const double eps = 64.0 * std::numeric_limits<double>::epsilon();
 
     if (!(span > eps)) {
-        const double clamped_value = std::clamp(scale, low_cutoff, high_cutoff);
-        output.assign(n_samples, clamped_value);
-        return output;
-    }
-
-    std::uniform_real_distribution<double> uniform(F_low, F_high);
-
-    for (size_t i = 0; i < n_samples; ++i) {
-        const double p = uniform(generator);
-        const double x = detail::rosin_rammler_inv_cdf(p, scale, shape);
-        output.push_back(std::clamp(x, low_cutoff, high_cutoff));
+        std::fill(output, output + n_samples, std::clamp(scale, low_cutoff, high_cutoff));
+        return;
     }
 
-    return output;
+    fill_by_inversion(
+        output, n_samples, generator, first_index, F_low, span, low_cutoff, high_cutoff,
+        [this](const double p) { return detail::rosin_rammler_inv_cdf(p, this->scale, this->shape); }
+    );
 }
 
 double RosinRammler::proportion_within_cutoffs() const {
@@ -186,13 +191,9 @@ double RosinRammler::proportion_within_cutoffs() const {
 
 // __________ LOG-NORMAL _____________
 // ___________________________________
-std::vector<double>
-LogNormal::sample(const size_t n_samples) const {
-    std::vector<double> output;
-    output.reserve(n_samples);
-
+void LogNormal::sample_into(double *output, const size_t n_samples, const utils::CounterRandomGenerator &generator, const uint64_t first_index) const {
     if (n_samples == 0) {
-        return output;
+        return;
     }
 
     if (!(standard_deviation > 0.0)) {
@@ -229,25 +230,14 @@ LogNormal::sample(const size_t n_samples) const {
 
     // Degenerate truncation case
     if (!(span > eps)) {
-        const double clamped =
-            std::clamp(std::exp(mean), low_cutoff, high_cutoff);
-        output.assign(n_samples, clamped);
-        return output;
+        std::fill(output, output + n_samples, std::clamp(std::exp(mean), low_cutoff, high_cutoff));
+        return;
     }
 
-    std::uniform_real_distribution<double> uniform(Fa, Fb);
-
-    for (size_t i = 0; i < n_samples; ++i) {
-        const double u = uniform(generator);
-        const double z = detail::normal_inv_cdf(u);
-        const double y = mean + standard_deviation * z;
-        const double x = std::exp(y);
-
-        // Numerical safety near bounds
-        output.push_back(std::clamp(x, low_cutoff, high_cutoff));
-    }
-
-    return output;
+    fill_by_inversion(
+        output, n_samples, generator, first_index, Fa, span, low_cutoff, high_cutoff,
+        [this](const double p) { return std::exp(this->mean + this->standard_deviation * detail::normal_inv_cdf(p)); }
+    );
 }
 
 double LogNormal::proportion_within_cutoffs() const {
@@ -276,10 +266,8 @@ double LogNormal::proportion_within_cutoffs() const {
 
 // __________ DELTA _____________
 // ______________________________
-std::vector<double>
-Delta::sample(const size_t n_samples) const {
-    std::vector<double> output(n_samples, this->value);
-    return output;
+void Delta::sample_into(double *output, const size_t n_samples, const utils::CounterRandomGenerator &, const uint64_t) const {
+    std::fill(output, output + n_samples, this->value);
 }
 
 double Delta::proportion_within_cutoffs() const { return 1.0; }
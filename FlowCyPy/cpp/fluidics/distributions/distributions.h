@@ -1,15 +1,37 @@
 #pragma once
 
 #include <vector>
-#include <random>
+#include <cstdint>
 #include <limits>
+#include <string>
+
+#include <utils/random.h>
 
 class BaseDistribution {
     public:
         std::string units;
 
         virtual ~BaseDistribution(){};
-        virtual std::vector<double> sample(const size_t n_samples) const = 0;
+
+        /*
+            @brief Draw n_samples values from a fresh stream of the random service.
+        */
+        std::vector<double> sample(const size_t n_samples) const;
+
+        /*
+            @brief Fill output[i] with the value drawn at counter index first_index + i, in parallel.
+
+            Each value depends only on the generator and its index, so the output
+            does not depend on the number of threads and disjoint index ranges
+            can be filled independently.
+        */
+        virtual void sample_into(
+            double *output,
+            const size_t n_samples,
+            const utils::CounterRandomGenerator &generator,
+            const uint64_t first_index = 0
+        ) const = 0;
+
         virtual double proportion_within_cutoffs() const = 0;
 
 };
@@ -21,7 +43,6 @@ public:
     double standard_deviation = 1.0;
     double low_cutoff = -1.0;
     double high_cutoff = 1.0;
-    mutable std::mt19937 generator;
 
 
     Normal(
@@ -31,7 +52,7 @@ public:
         double high_cutoff
     );
 
-    std::vector<double> sample(const size_t n_samples) const override;
+    void sample_into(double *output, const size_t n_samples, const utils::CounterRandomGenerator &generator, const uint64_t first_index = 0) const override;
     double proportion_within_cutoffs() const override;
 
 };
@@ -41,13 +62,12 @@ class Uniform : public BaseDistribution {
     public:
         double lower_bound;
         double upper_bound;
-        mutable std::mt19937 generator;
 
         Uniform(const double lower_bound, const double upper_bound)
         : lower_bound(lower_bound), upper_bound(upper_bound)
         {}
 
-        std::vector<double> sample(const size_t n_samples) const override;
+        void sample_into(double *output, const size_t n_samples, const utils::CounterRandomGenerator &generator, const uint64_t first_index = 0) const override;
         double proportion_within_cutoffs() const override;
 
     };
@@ -58,7 +78,6 @@ class RosinRammler : public BaseDistribution {
         double shape;
         double low_cutoff;
         double high_cutoff;
-        mutable std::mt19937 generator;
 
         RosinRammler(
             const double scale,
@@ -72,7 +91,7 @@ class RosinRammler : public BaseDistribution {
             high_cutoff(high_cutoff)
         {}
 
-        std::vector<double> sample(const size_t n_samples) const override;
+        void sample_into(double *output, const size_t n_samples, const utils::CounterRandomGenerator &generator, const uint64_t first_index = 0) const override;
         double proportion_within_cutoffs() const override;
 };
 
@@ -82,7 +101,6 @@ class LogNormal : public BaseDistribution {
         double standard_deviation;
         double low_cutoff;
         double high_cutoff;
-        mutable std::mt19937 generator;
 
         LogNormal(
             const double mean,
@@ -96,7 +114,7 @@ class LogNormal : public BaseDistribution {
             high_cutoff(high_cutoff)
         {}
 
-        std::vector<double> sample(const size_t n_samples) const override;
+        void sample_into(double *output, const size_t n_samples, const utils::CounterRandomGenerator &generator, const uint64_t first_index = 0) const override;
         double proportion_within_cutoffs() const override;
 
 };
@@ -105,13 +123,12 @@ class LogNormal : public BaseDistribution {
 class Delta : public BaseDistribution {
     public:
         double value;
-        mutable std::mt19937 generator;
 
         Delta(const double value)
         : value(value)
         {}
 
-        std::vector<double> sample(const size_t n_samples) const override;
+        void sample_into(double *output, const size_t n_samples, const utils::CounterRandomGenerator &generator, const uint64_t first_index = 0) const override;
         double proportion_within_cutoffs() const override;
 
 };
@@ -2,21 +2,33 @@
 #include <pybind11/stl.h>
 #include <memory>
 
+#include <utils/module_binding.h>
 #include <utils/numpy.h>
 #include <pint/pint.h>
 #include "distributions.h"
+#include <utils/random_binding.h>
+#include <utils/threading_binding.h>
 
 
 namespace py = pybind11;
 
-PYBIND11_MODULE(distributions, module) {
+FLOWCYPY_MODULE(distributions, module) {
     py::object ureg = get_shared_ureg();
+
+    register_random_seed_functions(module);
+    register_threading_functions(module);
+
     py::class_<BaseDistribution, std::shared_ptr<BaseDistribution>>(module, "BaseDistribution")
         .def(
             "sample",
             [ureg](const BaseDistribution& self, const size_t n_samples){
-                std::vector<double> output = self.sample(n_samples);
-                py::array_t<double> py_output = vector_move_from_numpy(output, {output.size(),});
+                std::vector<double> output;
+                {
+                    py::gil_scoped_release release;
+                    output = self.sample(n_samples);
+                }
+                const size_t n_elements = output.size();
+                py::array_t<double> py_output = vector_move_from_numpy(std::move(output), {n_elements,});
 
                 return (py_output * ureg.attr(py::str(self.units)));
             },
@@ -1,5 +1,90 @@
 #include "flow_cell.h"
 
+#include <utils/random.h>
+#include <utils/profiler.h>
+#include <utils/threading.h>
+
+namespace {
+
+// Spacings summed by one task of the prefix sum. Fixed, so that the rounding of
+// the sums, and thus the arrival times, do not depend on the number of threads.
+constexpr std::size_t prefix_sum_block_size = 1 << 16;
+
+/*
+    @brief Fill data[i] with the sum of the first i + 1 exponential spacings drawn at first_index + i, in parallel.
+
+    Each block is summed in order by one thread, the block offsets are then
+    accumulated serially, so the sums are non decreasing.
+*/
+void fill_exponential_prefix_sums(
+    std::vector<double> &data,
+    const utils::CounterRandomGenerator &generator,
+    const uint64_t first_index
+) {
+    const std::size_t size = data.size();
+    const std::size_t number_of_blocks = (size + prefix_sum_block_size - 1) / prefix_sum_block_size;
+
+    std::vector<double> block_offsets(number_of_blocks + 1, 0.0);
+    const int team_size = utils::get_team_size(size, utils::ParallelComponent::flow_cell);
+
+    #pragma omp parallel for schedule(static) num_threads(team_size)
+    for (std::size_t block = 0; block < number_of_blocks; ++block) {
+        const std::size_t begin = block * prefix_sum_block_size;
+        const std::size_t end = std::min(begin + prefix_sum_block_size, size);
+
+        double sum = 0.0;
+
+        for (std::size_t i = begin; i < end; ++i) {
+            sum += -std::log(generator.uniform(first_index + i));
+            data[i] = sum;
+        }
+
+        block_offsets[block + 1] = sum;
+    }
+
+    for (std::size_t block = 0; block < number_of_blocks; ++block)
+        block_offsets[block + 1] += block_offsets[block];
+
+    #pragma omp parallel for schedule(static) num_threads(team_size)
+    for (std::size_t block = 1; block < number_of_blocks; ++block) {
+        const std::size_t begin = block * prefix_sum_block_size;
+        const std::size_t end = std::min(begin + prefix_sum_block_size, size);
+
+        for (std::size_t i = begin; i < end; ++i)
+            data[i] += block_offsets[block];
+    }
+}
+
+/*
+    @brief Sorted uniform order statistics of n_events draws over [0, run_time], without sorting.
+
+    With E_1, ..., E_{n + 1} independent standard exponentials and S_k their partial
+    sums, (S_1, ..., S_n) / S_{n + 1} are distributed as the sorted values of n
+    independent uniforms on (0, 1). Spacings are drawn at first_index, first_index + 1, ...
+*/
+std::vector<double> sample_sorted_uniform_times(
+    const std::size_t n_events,
+    const double run_time,
+    const utils::CounterRandomGenerator &generator,
+    const uint64_t first_index
+) {
+    std::vector<double> arrival_times(n_events + 1);
+
+    fill_exponential_prefix_sums(arrival_times, generator, first_index);
+
+    const double scale = run_time / arrival_times.back();
+
+    arrival_times.pop_back();
+
+    #pragma omp parallel for simd schedule(static) num_threads(utils::get_team_size(n_events, utils::ParallelComponent::flow_cell))
+    for (std::size_t i = 0; i < n_events; ++i)
+        arrival_times[i] *= scale;
+
+    return arrival_times;
+}
+
+}  // namespace
+
 FlowCell::FlowCell(
     double width,
     double height,
@@ -32,61 +117,64 @@ FlowCell::FlowCell(
 
 std::tuple<std::vector<double>, std::vector<double>, std::vector<double>>
 FlowCell::sample_transverse_profile(int n_samples) const {
+    FLOWCYPY_PROFILE_SCOPE("flow_cell.sample_transverse_profile");
+    FLOWCYPY_PROFILE_COUNT("flow_cell.sample_transverse_profile", "events", n_samples);
+
     if (n_samples < 0) {
         throw std::runtime_error("n_samples must be non negative.");
     }
 
-    std::vector<double> y_samples;
-    std::vector<double> z_samples;
-    std::vector<double> velocity_samples;
+    this->validate_transverse_sampling_scheme();
+
+    const std::size_t number_of_samples = static_cast<std::size_t>(n_samples);
+
+    std::vector<double> y_samples(number_of_samples, 0.0);
+    std::vector<double> z_samples(number_of_samples, 0.0);
+    std::vector<double> velocity_samples(number_of_samples, u_center);
+
+    if (perfectly_aligned) {
+        return std::make_tuple(y_samples, z_samples, velocity_samples);
+    }
+
+    const utils::CounterRandomGenerator random_generator =
+        utils::RandomService::instance().next_generator(utils::RandomStreamId::flow_cell_positions);
 
-    y_samples.reserve(static_cast<std::size_t>(n_samples));
-    z_samples.reserve(static_cast<std::size_t>(n_samples));
-    velocity_samples.reserve(static_cast<std::size_t>(n_samples));
+    const bool velocity_weighted = transverse_sampling_scheme == "velocity-weighted";
 
-    std::random_device random_device;
-    std::mt19937 generator(random_device());
+    const std::size_t n_cells = transverse_cells_per_axis;
+    const double cell_width = sample.width / static_cast<double>(n_cells);
+    const double cell_height = sample.height / static_cast<double>(n_cells);
 
-    std::uniform_real_distribution<double> y_distribution(-sample.width / 2.0, sample.width / 2.0);
-    std::uniform_real_distribution<double> z_distribution(-sample.height / 2.0, sample.height / 2.0);
-    std::uniform_real_distribution<double> acceptance_distribution(0.0, 1.0);
+    #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(number_of_samples, utils::ParallelComponent::flow_cell))
+    for (std::size_t sample_index = 0; sample_index < number_of_samples; ++sample_index) {
+        // Every draw of a sample comes from that sample's index.
+        utils::CounterRandomGenerator::Engine generator = random_generator.engine(static_cast<uint64_t>(sample_index));
+
+        std::uniform_real_distribution<double> unit_distribution(0.0, 1.0);
 
-    for (int sample_index = 0; sample_index < n_samples; ++sample_index) {
         double y = 0.0;
         double z = 0.0;
-        double velocity = u_center;
-
-        if (!perfectly_aligned) {
-            bool accepted_sample = false;
-
-            while (!accepted_sample) {
-                y = y_distribution(generator);
-                z = z_distribution(generator);
-                velocity = this->get_velocity(y, z, dpdx);
-
-                if (transverse_sampling_scheme == "uniform-random") {
-                    accepted_sample = true;
-                } else if (transverse_sampling_scheme == "velocity-weighted") {
-                    const double acceptance_probability = velocity / u_center;
-
-                    if (
-                        acceptance_probability >= 1.0 ||
-                        acceptance_distribution(generator) <= acceptance_probability
-                    ) {
-                        accepted_sample = true;
-                    }
-                } else {
-                    throw std::runtime_error(
-                        "Unsupported transverse_sampling_scheme '" + transverse_sampling_scheme +
-                        "'. Expected one of: 'velocity-weighted', 'uniform-random'."
-                    );
-                }
+
+        if (velocity_weighted && n_cells > 0) {
+            // Walker alias draw of a cell with probability proportional to its flux, then a uniform position inside it.
+            const double scaled_draw = unit_distribution(generator) * static_cast<double>(n_cells * n_cells);
+
+            std::size_t cell = std::min(static_cast<std::size_t>(scaled_draw), n_cells * n_cells - 1);
+
+            if (scaled_draw - static_cast<double>(cell) >= transverse_cell_probability[cell]) {
+                cell = transverse_cell_alias[cell];
             }
+
+            y = -sample.width / 2.0 + (static_cast<double>(cell / n_cells) + unit_distribution(generator)) * cell_width;
+            z = -sample.height / 2.0 + (static_cast<double>(cell % n_cells) + unit_distribution(generator)) * cell_height;
+        } else {
+            y = (unit_distribution(generator) - 0.5) * sample.width;
+            z = (unit_distribution(generator) - 0.5) * sample.height;
         }
 
-        y_samples.push_back(y);
-        z_samples.push_back(z);
-        velocity_samples.push_back(velocity);
+        y_samples[sample_index] = y;
+        z_samples[sample_index] = z;
+        velocity_samples[sample_index] = this->get_velocity(y, z, dpdx);
     }
 
     return std::make_tuple(y_samples, z_samples, velocity_samples);
@@ -95,6 +183,9 @@ FlowCell::sample_transverse_profile(int n_samples) const {
 void FlowCell::initialize() {
     Q_total = sample_volume_flow + sheath_volume_flow;
 
+    this->build_series_terms();
+    this->build_velocity_table();
+
     const double reference_channel_flow = compute_channel_flow(dpdx_ref);
 
     if (reference_channel_flow == 0.0) {
@@ -103,7 +194,7 @@ void FlowCell::initialize() {
 
     dpdx = dpdx_ref * (Q_total / reference_channel_flow);
 
-    u_center = this->get_velocity(0.0, 0.0, dpdx);
+    u_center = this->evaluate_velocity_series(0.0, 0.0, dpdx);
 
     if (u_center <= 0.0) {
         throw std::runtime_error("Computed center velocity is non positive.");
@@ -114,7 +205,7 @@ void FlowCell::initialize() {
     const double sample_height = sample_core_scale * height;
     const double sample_area = sample_width * sample_height;
     const double sample_average_flow_speed = sample_volume_flow / sample_area;
-    const double sample_max_flow_speed = this->get_velocity(0.0, 0.0, dpdx);
+    const double sample_max_flow_speed = u_center;
 
     this->sample = FluidRegion(
         sample_height,
@@ -124,6 +215,8 @@ void FlowCell::initialize() {
         sample_average_flow_speed
     );
 
+    this->build_transverse_alias_table();
+
     const double sheath_area = area - sample_area;
     const double sheath_average_flow_speed = sheath_area > 0.0
         ? sheath_volume_flow / sheath_area
@@ -244,22 +337,211 @@ double FlowCell::compute_sample_core_scale() const {
     return 0.5 * (lower_scale + upper_scale);
 }
 
+void FlowCell::build_series_terms() {
+    series_terms.clear();
+    series_terms.reserve(static_cast<std::size_t>(N_terms));
+
+    for (int n = 1; n < 2 * N_terms; n += 2) {
+        const double wavenumber = n * M_PI / height;
+
+        series_terms.push_back(SeriesTerm{
+            wavenumber,
+            1.0 / (static_cast<double>(n) * n * n),
+            wavenumber * width / 2.0,
+            1.0 / (1.0 + std::exp(-wavenumber * width))
+        });
+    }
+}
+
+void FlowCell::build_velocity_table() {
+    const std::size_t n_nodes = static_cast<std::size_t>(n_int);
+    const std::size_t n_terms = series_terms.size();
+
+    table_dy = width / static_cast<double>(n_nodes - 1);
+    table_dz = height / static_cast<double>(n_nodes - 1);
+
+    // Every term is a product of a function of y and a function of z, tabulated once per axis.
+    std::vector<double> term_y(n_terms * n_nodes), term_y_derivative(n_terms * n_nodes);
+    std::vector<double> term_z(n_terms * n_nodes), term_z_derivative(n_terms * n_nodes);
+
+    for (std::size_t t = 0; t < n_terms; ++t) {
+        const SeriesTerm& term = series_terms[t];
+
+        for (std::size_t i = 0; i < n_nodes; ++i) {
+            const double y = -width / 2.0 + static_cast<double>(i) * table_dy;
+            const double absolute_phase = term.wavenumber * std::abs(y);
+            const double growth = std::exp(absolute_phase - term.half_width_phase) * term.attenuation;
+            const double decay = std::exp(-2.0 * absolute_phase);
+
+            term_y[t * n_nodes + i] = term.weight * (1.0 - growth * (1.0 + decay));
+            term_y_derivative[t * n_nodes + i] = -term.weight * term.wavenumber * std::copysign(growth * (1.0 - decay), y);
+
+            const double z = -height / 2.0 + static_cast<double>(i) * table_dz;
+            const double phase = term.wavenumber * (z + height / 2.0);
+
+            term_z[t * n_nodes + i] = std::sin(phase);
+            term_z_derivative[t * n_nodes + i] = term.wavenumber * std::cos(phase);
+        }
+    }
+
+    const double prefactor = this->get_unit_velocity_prefactor();
+
+    table_velocity.assign(n_nodes * n_nodes, 0.0);
+    table_velocity_dy.assign(n_nodes * n_nodes, 0.0);
+    table_velocity_dz.assign(n_nodes * n_nodes, 0.0);
+    table_velocity_dydz.assign(n_nodes * n_nodes, 0.0);
+
+    #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(n_nodes * n_nodes * n_terms, utils::ParallelComponent::flow_cell))
+    for (std::size_t i = 0; i < n_nodes; ++i) {
+        for (std::size_t t = 0; t < n_terms; ++t) {
+            const double y_value = prefactor * term_y[t * n_nodes + i];
+            const double y_derivative = prefactor * term_y_derivative[t * n_nodes + i];
+
+            for (std::size_t j = 0; j < n_nodes; ++j) {
+                const std::size_t node = i * n_nodes + j;
+
+                table_velocity[node] += y_value * term_z[t * n_nodes + j];
+                table_velocity_dy[node] += y_derivative * term_z[t * n_nodes + j];
+                table_velocity_dz[node] += y_value * term_z_derivative[t * n_nodes + j];
+                table_velocity_dydz[node] += y_derivative * term_z_derivative[t * n_nodes + j];
+            }
+        }
+    }
+}
+
+void FlowCell::build_transverse_alias_table() {
+    transverse_cell_probability.clear();
+    transverse_cell_alias.clear();
+    transverse_cells_per_axis = 0;
+
+    if (sample.width <= 0.0 || sample.height <= 0.0) {
+        return;
+    }
+
+    const std::size_t n_cells = static_cast<std::size_t>(n_int);
+    const std::size_t n_total = n_cells * n_cells;
+    const double cell_width = sample.width / static_cast<double>(n_cells);
+    const double cell_height = sample.height / static_cast<double>(n_cells);
+
+    // Cells have equal areas, so their flux is proportional to the velocity at their center.
+    std::vector<double> scaled_weight(n_total);
+
+    #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(n_total, utils::ParallelComponent::flow_cell))
+    for (std::size_t i = 0; i < n_cells; ++i) {
+        const double y = -sample.width / 2.0 + (static_cast<double>(i) + 0.5) * cell_width;
+
+        for (std::size_t j = 0; j < n_cells; ++j) {
+            const double z = -sample.height / 2.0 + (static_cast<double>(j) + 0.5) * cell_height;
+            scaled_weight[i * n_cells + j] = std::max(this->interpolate_unit_velocity(y, z), 0.0);
+        }
+    }
+
+    double total_weight = 0.0;
+
+    for (const double weight : scaled_weight) {
+        total_weight += weight;
+    }
+
+    if (total_weight <= 0.0) {
+        return;
+    }
+
+    for (double& weight : scaled_weight) {
+        weight *= static_cast<double>(n_total) / total_weight;
+    }
+
+    // Vose's construction: pair every cell below the mean with one above it.
+    transverse_cell_probability.assign(n_total, 1.0);
+    transverse_cell_alias.resize(n_total);
+
+    std::vector<std::size_t> small_cells;
+    std::vector<std::size_t> large_cells;
+
+    for (std::size_t cell = 0; cell < n_total; ++cell) {
+        transverse_cell_alias[cell] = cell;
+        (scaled_weight[cell] < 1.0 ? small_cells : large_cells).push_back(cell);
+    }
+
+    while (!small_cells.empty() && !large_cells.empty()) {
+        const std::size_t small_cell = small_cells.back();
+        const std::size_t large_cell = large_cells.back();
+        small_cells.pop_back();
+        large_cells.pop_back();
+
+        transverse_cell_probability[small_cell] = scaled_weight[small_cell];
+        transverse_cell_alias[small_cell] = large_cell;
+
+        scaled_weight[large_cell] = (scaled_weight[large_cell] + scaled_weight[small_cell]) - 1.0;
+        (scaled_weight[large_cell] < 1.0 ? small_cells : large_cells).push_back(large_cell);
+    }
+
+    // Cells left over are at the mean up to rounding and keep a probability of one.
+    transverse_cells_per_axis = n_cells;
+}
+
+double FlowCell::interpolate_unit_velocity(const double y, const double z) const {
+    const std::size_t n_nodes = static_cast<std::size_t>(n_int);
+
+    const double y_position = (y + width / 2.0) / table_dy;
+    const double z_position = (z + height / 2.0) / table_dz;
+
+    const std::size_t i = std::min(static_cast<std::size_t>(y_position), n_nodes - 2);
+    const std::size_t j = std::min(static_cast<std::size_t>(z_position), n_nodes - 2);
+
+    const double t = y_position - static_cast<double>(i);
+    const double u = z_position - static_cast<double>(j);
+
+    // Cubic Hermite basis: values at the two ends, then derivatives scaled to the cell size.
+    const double value_basis_y[2] = {(1.0 + 2.0 * t) * (1.0 - t) * (1.0 - t), t * t * (3.0 - 2.0 * t)};
+    const double slope_basis_y[2] = {t * (1.0 - t) * (1.0 - t) * table_dy, -t * t * (1.0 - t) * table_dy};
+    const double value_basis_z[2] = {(1.0 + 2.0 * u) * (1.0 - u) * (1.0 - u), u * u * (3.0 - 2.0 * u)};
+    const double slope_basis_z[2] = {u * (1.0 - u) * (1.0 - u) * table_dz, -u * u * (1.0 - u) * table_dz};
+
+    double velocity = 0.0;
+
+    for (std::size_t a = 0; a < 2; ++a) {
+        for (std::size_t b = 0; b < 2; ++b) {
+            const std::size_t node = (i + a) * n_nodes + (j + b);
+
+            velocity +=
+                value_basis_y[a] * value_basis_z[b] * table_velocity[node] +
+                slope_basis_y[a] * value_basis_z[b] * table_velocity_dy[node] +
+                value_basis_y[a] * slope_basis_z[b] * table_velocity_dz[node] +
+                slope_basis_y[a] * slope_basis_z[b] * table_velocity_dydz[node];
+        }
+    }
+
+    return velocity;
+}
+
+double FlowCell::get_unit_velocity_prefactor() const {
+    return 4.0 * height * height / (std::pow(M_PI, 3) * viscosity);
+}
+
 double FlowCell::get_velocity(double y, double z, double dpdx_local) const {
+    const bool inside_channel = std::abs(y) <= width / 2.0 && std::abs(z) <= height / 2.0;
+
+    if (!inside_channel || table_velocity.empty()) {
+        return this->evaluate_velocity_series(y, z, dpdx_local);
+    }
+
+    return -dpdx_local * this->interpolate_unit_velocity(y, z);
+}
+
+double FlowCell::evaluate_velocity_series(double y, double z, double dpdx_local) const {
     double velocity = 0.0;
-    const double prefactor =
-        (4.0 * height * height / (std::pow(M_PI, 3) * viscosity)) * (-dpdx_local);
 
-    for (int n = 1; n < 2 * N_terms; n += 2) {
-        const double term_y =
-            1.0 - std::cosh((n * M_PI * y) / height) / std::cosh((n * M_PI * width / 2.0) / height);
+    for (const SeriesTerm& term : series_terms) {
+        const double absolute_phase = term.wavenumber * std::abs(y);
+        const double cosh_ratio =
+            std::exp(absolute_phase - term.half_width_phase) * (1.0 + std::exp(-2.0 * absolute_phase)) * term.attenuation;
 
-        const double term_z =
-            std::sin((n * M_PI * (z + height / 2.0)) / height);
+        const double term_z = std::sin(term.wavenumber * (z + height / 2.0));
 
-        velocity += term_y * term_z / std::pow(static_cast<double>(n), 3);
+        velocity += term.weight * (1.0 - cosh_ratio) * term_z;
     }
 
-    return prefactor * velocity;
+    return this->get_unit_velocity_prefactor() * (-dpdx_local) * velocity;
 }
 
 double FlowCell::compute_region_flow(
@@ -288,26 +570,24 @@ double FlowCell::compute_region_flow(
         return 0.0;
     }
 
-    const double y_min = -region_width / 2.0;
-    const double y_max = region_width / 2.0;
-    const double z_min = -region_height / 2.0;
-    const double z_max = region_height / 2.0;
+    // Integral over [-a, a] of 1 - cosh(k y) / cosh(k w / 2) is 2 a - 2 sinh(k a) / (k cosh(k w / 2)),
+    // and over [-b, b] of sin(k (z + h / 2)) is 2 sin(k h / 2) sin(k b) / k.
+    double flow = 0.0;
 
-    const double dy = (y_max - y_min) / static_cast<double>(n_int - 1);
-    const double dz = (z_max - z_min) / static_cast<double>(n_int - 1);
+    for (const SeriesTerm& term : series_terms) {
+        const double half_region_phase = term.wavenumber * region_width / 2.0;
+        const double sinh_ratio =
+            std::exp(half_region_phase - term.half_width_phase) * (1.0 - std::exp(-2.0 * half_region_phase)) * term.attenuation;
 
-    double sum = 0.0;
+        const double y_integral = region_width - 2.0 * sinh_ratio / term.wavenumber;
 
-    for (int i = 0; i < n_int; ++i) {
-        const double y = y_min + static_cast<double>(i) * dy;
+        const double z_integral =
+            2.0 * std::sin(term.wavenumber * height / 2.0) * std::sin(term.wavenumber * region_height / 2.0) / term.wavenumber;
 
-        for (int j = 0; j < n_int; ++j) {
-            const double z = z_min + static_cast<double>(j) * dz;
-            sum += this->get_velocity(y, z, dpdx_input);
-        }
+        flow += term.weight * y_integral * z_integral;
     }
 
-    return sum * dy * dz;
+    return this->get_unit_velocity_prefactor() * (-dpdx_input) * flow;
 }
 
 double FlowCell::compute_channel_flow(double dpdx_input) const {
@@ -320,21 +600,10 @@ FlowCell::sample_arrival_times_uniform_random(
     const double run_time
 ) const
 {
-    std::random_device random_device;
-    std::mt19937 generator(random_device());
-
-    std::vector<double> arrival_times;
-    arrival_times.reserve(n_events);
+    const utils::CounterRandomGenerator generator =
+        utils::RandomService::instance().next_generator(utils::RandomStreamId::flow_cell_arrivals);
 
-    std::uniform_real_distribution<double> uniform_distribution(0.0, run_time);
-
-    for (std::size_t event_index = 0; event_index < n_events; ++event_index) {
-        arrival_times.push_back(uniform_distribution(generator));
-    }
-
-    std::sort(arrival_times.begin(), arrival_times.end());
-
-    return arrival_times;
+    return sample_sorted_uniform_times(n_events, run_time, generator, 0);
 }
 
 std::vector<double>
@@ -374,27 +643,13 @@ FlowCell::sample_arrival_times_poisson(
         throw std::runtime_error("particle_flux must be strictly positive for poisson sampling.");
     }
 
-    std::vector<double> arrival_times;
-    arrival_times.reserve(static_cast<std::size_t>(run_time * particle_flux));
-
-    std::random_device random_device;
-    std::mt19937 generator(random_device());
-    std::exponential_distribution<double> exponential_distribution(particle_flux);
+    const utils::CounterRandomGenerator generator =
+        utils::RandomService::instance().next_generator(utils::RandomStreamId::flow_cell_arrivals);
 
-    double current_time = 0.0;
+    // Given their number, the events of a Poisson process are uniform order statistics over the run.
+    const std::size_t n_events = static_cast<std::size_t>(generator.poisson(particle_flux * run_time, 0));
 
-    while (current_time <= run_time) {
-        const double dt = exponential_distribution(generator);
-        current_time += dt;
-
-        if (current_time > run_time) {
-            break;
-        }
-
-        arrival_times.push_back(current_time);
-    }
-
-    return arrival_times;
+    return sample_sorted_uniform_times(n_events, run_time, generator, 1);
 }
 
 std::vector<double>
@@ -404,6 +659,8 @@ FlowCell::sample_arrival_times(
     const double particle_flux
 ) const
 {
+    FLOWCYPY_PROFILE_SCOPE("flow_cell.sample_arrival_times");
+
     if (run_time < 0.0) {
         throw std::runtime_error("run_time must be non negative.");
     }
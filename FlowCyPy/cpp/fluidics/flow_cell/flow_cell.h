@@ -78,7 +78,7 @@ public:
      * @param sheath_volume_flow Volume flow rate of the sheath fluid in m^3/s.
      * @param viscosity Viscosity of the fluid in Pa.s.
      * @param N_terms Number of odd terms used in the Fourier series expansion.
-     * @param n_int Number of integration points per axis used for numerical integration.
+     * @param n_int Number of grid points per axis of the velocity lookup table, which sets its accuracy.
      * @param event_scheme Default event sampling scheme. Supported values are "uniform-random", "linear", and "poisson".
      * @param transverse_sampling_scheme Transverse position sampling scheme. Supported values are "velocity-weighted" and "uniform-random".
      * @param perfectly_aligned If true, the sample stream is perfectly aligned with the center of the channel.
@@ -106,11 +106,14 @@ public:
      * By default, coordinates are sampled with probability proportional to the local
      * axial velocity. This gives flux-weighted trajectory sampling, so faster regions
      * of the sample stream contribute proportionally more particles per unit time.
+     * A cell of the sample core is drawn from an alias table built at initialization,
+     * then the position is drawn uniformly inside it, so every sample costs O(1).
      * If `transverse_sampling_scheme` is set to "uniform-random", coordinates are sampled
      * uniformly within the sample region dimensions.
      *
      * The velocity is calculated based on the flow cell's parameters and the
-     * transverse position within the channel.
+     * transverse position within the channel. Samples are drawn in parallel, each
+     * from its own counter of the random stream.
      *
      * @param n_samples Number of transverse samples to generate.
      * @return A tuple containing three vectors: y-coordinates, z-coordinates, and velocities.
@@ -164,13 +167,70 @@ private:
      */
     double compute_sample_core_scale() const;
 
+    /**
+     * @brief Cache the constants of every term of the Fourier series.
+     */
+    void build_series_terms();
+
+    /**
+     * @brief Tabulate the velocity for a unit pressure gradient on an n_int by n_int grid over the channel.
+     * The value and the exact y, z and cross derivatives of the series are stored at every node,
+     * so that `get_velocity` interpolates by bicubic Hermite patches.
+     */
+    void build_velocity_table();
+
+    /**
+     * @brief Build the Walker alias table of the velocity-weighted transverse sampler.
+     * The sample core is divided into n_int by n_int cells weighted by the tabulated velocity
+     * at their center, so that a cell is drawn in O(1) with probability proportional to its flux.
+     */
+    void build_transverse_alias_table();
+
+    /**
+     * @brief Interpolate the velocity table at a point of the channel.
+     */
+    double interpolate_unit_velocity(double y, double z) const;
+
+    /**
+     * @brief Constant factor of the series for a unit pressure gradient, 4 h^2 / (pi^3 mu).
+     */
+    double get_unit_velocity_prefactor() const;
+
+    /**
+     * @brief Constants of one odd term n of the Fourier series.
+     * With k = n pi / height, the term is weight * (1 - cosh(k y) / cosh(k width / 2)) * sin(k (z + height / 2)).
+     * The cosh ratio is evaluated as exp(k |y| - half_width_phase) * (1 + exp(-2 k |y|)) * attenuation,
+     * which does not overflow for wide channels.
+     */
+    struct SeriesTerm {
+        double wavenumber;       // k = n pi / height [1/m]
+        double weight;           // 1 / n^3
+        double half_width_phase; // k width / 2
+        double attenuation;      // 1 / (1 + exp(-k width))
+    };
+
+    std::vector<SeriesTerm> series_terms;
+
+    // Velocity for a pressure gradient of -1 Pa/m and its derivatives, row major with z contiguous.
+    double table_dy = 0.0;
+    double table_dz = 0.0;
+    std::vector<double> table_velocity;
+    std::vector<double> table_velocity_dy;
+    std::vector<double> table_velocity_dz;
+    std::vector<double> table_velocity_dydz;
+
+    // Alias table over the sample core cells, indexed by y cell * transverse_cells_per_axis + z cell.
+    std::size_t transverse_cells_per_axis = 0;
+    std::vector<double> transverse_cell_probability;
+    std::vector<std::size_t> transverse_cell_alias;
+
 public:
     /**
      * @brief Calculate the velocity at a given point in the flow cell.
      * This method computes the local axial velocity based on the y and z coordinates and the
      * specified pressure gradient.
-     * The velocity is calculated using a Fourier series solution for fully developed laminar
-     * flow in a rectangular channel.
+     * Inside the channel the velocity is interpolated from the table built at initialization,
+     * which is proportional to the pressure gradient; outside it, the series is evaluated.
      *
      * @param y The y-coordinate in meters.
      * @param z The z-coordinate in meters.
@@ -179,10 +239,23 @@ public:
      */
     double get_velocity(double y, double z, double dpdx_local) const;
 
+    /**
+     * @brief Evaluate the velocity at a given point from the Fourier series.
+     * The velocity is calculated using a Fourier series solution for fully developed laminar
+     * flow in a rectangular channel, truncated to `N_terms` odd terms.
+     *
+     * @param y The y-coordinate in meters.
+     * @param z The z-coordinate in meters.
+     * @param dpdx_local The pressure gradient in Pa/m.
+     * @return The local axial velocity in m/s.
+     */
+    double evaluate_velocity_series(double y, double z, double dpdx_local) const;
+
     /**
      * @brief Compute the volumetric flow rate through a centered rectangular region.
-     * This method numerically integrates the velocity field over a centered rectangle
-     * of dimensions `region_width` by `region_height`.
+     * This method integrates the truncated Fourier series over a centered rectangle
+     * of dimensions `region_width` by `region_height`. Each term is separable and
+     * integrates in closed form, so the cost is one evaluation per term.
      *
      * @param region_width Width of the centered region in meters.
      * @param region_height Height of the centered region in meters.
@@ -197,7 +270,7 @@ public:
 
     /**
      * @brief Compute the channel volumetric flow rate for a given pressure gradient.
-     * This method numerically integrates the velocity field over the rectangular channel
+     * This method integrates the velocity field over the rectangular channel
      * cross section in order to estimate the total volumetric flow rate.
      *
      * @param dpdx_input The pressure gradient in Pa/m.
@@ -207,9 +280,9 @@ public:
 
     /**
      * @brief Sample event arrival times from a Poisson process.
-     * This method generates inter-arrival times from an exponential distribution
-     * with rate `particle_flux`, then cumulatively sums them until `run_time`
-     * is reached.
+     * This method draws the number of events from a Poisson distribution of mean
+     * `particle_flux * run_time`, then places them as sorted uniform order statistics
+     * over the run, which is the distribution of the process given its count.
      *
      * @param run_time Total duration over which events are sampled, in seconds.
      * @param particle_flux Event rate in events per second.
@@ -219,8 +292,10 @@ public:
 
     /**
      * @brief Sample sorted random arrival times uniformly over the run time.
-     * This method draws `n_events` independent uniform samples in [0, run_time]
-     * and sorts them in ascending order.
+     * This method draws the sorted values of `n_events` independent uniform samples
+     * in [0, run_time] directly, as normalized partial sums of exponential spacings
+     * computed by a parallel prefix sum, so no sort is needed. The times are
+     * reproducible for a given seed whatever the number of threads.
      *
      * @param n_events Number of events to generate.
      * @param run_time Total duration over which events are sampled, in seconds.
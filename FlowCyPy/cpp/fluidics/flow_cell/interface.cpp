@@ -3,14 +3,22 @@
 
 #include "flow_cell.h"
 #include <pint/pint.h>
+#include <utils/module_binding.h>
 #include <utils/numpy.h>
+#include <utils/profiler_binding.h>
+#include <utils/threading_binding.h>
+#include <utils/random_binding.h>
 
 namespace py = pybind11;
 
-PYBIND11_MODULE(flow_cell, module) {
+FLOWCYPY_MODULE(flow_cell, module) {
 
     py::object ureg = get_shared_ureg();
 
+    register_random_seed_functions(module);
+    register_profiling_functions(module);
+    register_threading_functions(module);
+
     py::class_<FluidRegion, std::shared_ptr<FluidRegion>>(module, "FluidRegion")
         .def_property_readonly(
             "width",
@@ -192,7 +200,8 @@ PYBIND11_MODULE(flow_cell, module) {
             N_terms : int, optional
                 Number of odd terms to use in the Fourier series solution.
             n_int : int, optional
-                Number of grid points per axis for numerical integration.
+                Number of grid points per axis of the velocity lookup table. The velocity is
+                interpolated bicubically between nodes, so the error decreases as ``n_int**-4``.
             event_scheme : str, optional
                 Default event sampling scheme. Must be one of
                 ``"uniform-random"``, ``"linear"``, or ``"poisson"``.
@@ -321,14 +330,18 @@ PYBIND11_MODULE(flow_cell, module) {
         "sample_transverse_profile",
         [ureg](const FlowCell& self, const size_t n_samples)
         {
-            auto [y, z, velocities] = self.sample_transverse_profile(static_cast<int>(n_samples));
+            std::vector<double> y, z, velocities;
+            {
+                py::gil_scoped_release release;
+                std::tie(y, z, velocities) = self.sample_transverse_profile(static_cast<int>(n_samples));
+            }
 
             const size_t n_elements = y.size();
             std::vector<size_t> shape = {n_elements};
 
-            py::object _y = vector_move_from_numpy(y, shape) * ureg.attr("meter");
-            py::object _z = vector_move_from_numpy(z, shape) * ureg.attr("meter");
-            py::object _velocities = vector_move_from_numpy(velocities, shape) * ureg.attr("meter/second");
+            py::object _y = vector_move_from_numpy(std::move(y), shape) * ureg.attr("meter");
+            py::object _z = vector_move_from_numpy(std::move(z), shape) * ureg.attr("meter");
+            py::object _velocities = vector_move_from_numpy(std::move(velocities), shape) * ureg.attr("meter/second");
 
             return py::make_tuple(_y, _z, _velocities);
         },
@@ -370,7 +383,8 @@ PYBIND11_MODULE(flow_cell, module) {
             using the analytical Fourier series solution for pressure-driven flow.
 
             The velocity profile is derived from solving the Stokes equation under the assumption of fully developed,
-            incompressible, laminar flow with no-slip boundary conditions.
+            incompressible, laminar flow with no-slip boundary conditions. Inside the channel it is interpolated
+            from a table of the series tabulated on an ``n_int`` by ``n_int`` grid when the flow cell is built.
 
             Parameters
             ----------
@@ -419,16 +433,20 @@ PYBIND11_MODULE(flow_cell, module) {
             const double _run_time =
                 run_time.attr("to")(ureg.attr("second")).attr("magnitude").cast<double>();
 
-            auto arrival_times = self.sample_arrival_times(
-                n_events,
-                _run_time,
-                particle_flux
-            );
+            std::vector<double> arrival_times;
+            {
+                py::gil_scoped_release release;
+                arrival_times = self.sample_arrival_times(
+                    n_events,
+                    _run_time,
+                    particle_flux
+                );
+            }
 
             const size_t n_elements = arrival_times.size();
             std::vector<size_t> shape = {n_elements};
 
-            py::object output = vector_move_from_numpy(arrival_times, shape) * ureg.attr("second");
+            py::object output = vector_move_from_numpy(std::move(arrival_times), shape) * ureg.attr("second");
             return output;
         },
         py::arg("n_events"),
@@ -440,7 +458,7 @@ PYBIND11_MODULE(flow_cell, module) {
             Configured schemes
             ------------------
             ``"uniform-random"``
-                Draw ``n_events`` random times uniformly over the run duration and sort them.
+                Draw the sorted values of ``n_events`` random times uniformly distributed over the run duration.
 
             ``"linear"``
                 Generate ``n_events`` linearly spaced times over the run duration.
@@ -450,6 +468,9 @@ PYBIND11_MODULE(flow_cell, module) {
                 Generate arrival times from a Poisson process with rate ``particle_flux``.
                 In this mode, ``n_events`` is ignored and the number of returned events is stochastic.
 
+            Random times are generated in parallel and are reproducible for a given random seed,
+            whatever the number of threads.
+
             Parameters
             ----------
             n_events : int
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+
+
+/*
+    @brief Name and unit of one column of an EventTable.
+*/
+struct EventField {
+    std::string_view name;
+    std::string_view units;
+};
+
+
+/*
+    @brief Columns of the events sampled from a SpherePopulation.
+*/
+struct SphereEventLayout {
+    enum Field : size_t { medium_refractive_index, refractive_index, diameter };
+
+    static constexpr std::array<EventField, 3> fields = {{
+        {"MediumRefractiveIndex", "RIU"},
+        {"RefractiveIndex", "RIU"},
+        {"Diameter", "meter"}
+    }};
+};
+
+
+/*
+    @brief Columns of the events sampled from a CoreShellPopulation.
+*/
+struct CoreShellEventLayout {
+    enum Field : size_t { medium_refractive_index, core_refractive_index, shell_refractive_index, core_diameter, shell_thickness };
+
+    static constexpr std::array<EventField, 5> fields = {{
+        {"MediumRefractiveIndex", "RIU"},
+        {"CoreRefractiveIndex", "RIU"},
+        {"ShellRefractiveIndex", "RIU"},
+        {"CoreDiameter", "meter"},
+        {"ShellThickness", "meter"}
+    }};
+};
+
+
+/*
+    @brief Alignment in bytes of every column of an EventTable.
+*/
+constexpr size_t event_table_alignment = 64;
+
+
+/*
+    @brief Structure of arrays holding one column per field of a layout.
+
+    The layout fixes the columns at compile time, so a column is addressed by its
+    Field enumerator rather than looked up by name. All columns share one
+    allocation: column f starts at f * column_stride, the stride being rounded up
+    so that every column starts on a 64 byte boundary, the padding being zero.
+
+    @tparam Layout Type with a Field enumeration and a constexpr std::array<EventField, N> fields listed in enumeration order.
+*/
+template <typename Layout>
+class EventTable {
+public:
+    using Field = typename Layout::Field;
+
+    static constexpr size_t number_of_fields = Layout::fields.size();
+
+    explicit EventTable(const size_t number_of_events)
+        : number_of_events(number_of_events),
+          column_stride((number_of_events + values_per_alignment - 1) / values_per_alignment * values_per_alignment)
+    {
+        // At least one aligned block, as std::aligned_alloc may return null for a zero size.
+        const size_t total_size = std::max<size_t>(number_of_fields * this->column_stride, values_per_alignment);
+
+        double* pointer = static_cast<double*>(std::aligned_alloc(event_table_alignment, total_size * sizeof(double)));
+
+        if (pointer == nullptr)
+            throw std::bad_alloc();
+
+        std::memset(pointer, 0, total_size * sizeof(double));
+        this->values.reset(pointer);
+    }
+
+    EventTable(const EventTable&) = delete;
+    EventTable& operator=(const EventTable&) = delete;
+    EventTable(EventTable&&) noexcept = default;
+    EventTable& operator=(EventTable&&) noexcept = default;
+
+    size_t get_number_of_events() const { return this->number_of_events; }
+
+    /*
+        @brief Distance in values between the first values of two consecutive columns.
+    */
+    size_t get_column_stride() const { return this->column_stride; }
+
+    std::span<double> column(const Field field) {
+        return {this->values.get() + static_cast<size_t>(field) * this->column_stride, this->number_of_events};
+    }
+
+    std::span<const double> column(const Field field) const {
+        return {this->values.get() + static_cast<size_t>(field) * this->column_stride, this->number_of_events};
+    }
+
+    double* data() { return this->values.get(); }
+    const double* data() const { return this->values.get(); }
+
+private:
+    static constexpr size_t values_per_alignment = event_table_alignment / sizeof(double);
+
+    struct FreeDeleter {
+        void operator()(double* pointer) const { std::free(pointer); }
+    };
+
+    size_t number_of_events;
+    size_t column_stride;
+    std::unique_ptr<double[], FreeDeleter> values;
+};
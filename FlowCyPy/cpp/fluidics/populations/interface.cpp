@@ -2,8 +2,11 @@
 #include <pybind11/stl.h>
 
 #include <pint/pint.h>
+#include <utils/module_binding.h>
 #include <utils/numpy.h>
 #include "populations.h"
+#include <utils/random_binding.h>
+#include <utils/threading_binding.h>
 
 namespace py = pybind11;
 
@@ -20,9 +23,47 @@ std::shared_ptr<BaseDistribution> as_distribution(const py::object& object, cons
 };
 
 
-PYBIND11_MODULE(populations, module) {
+// Dictionary of quantities viewing the columns of an event table, which the
+// returned arrays keep alive; the aligned columns are exposed without a copy.
+template <typename Layout>
+py::dict event_table_to_dict(const py::object& ureg, EventTable<Layout>&& table) {
+    auto* owned_table = new EventTable<Layout>(std::move(table));
+
+    py::capsule owner(owned_table, [](void* pointer) {
+        delete static_cast<EventTable<Layout>*>(pointer);
+    });
+
+    const std::vector<py::ssize_t> shape = {
+        static_cast<py::ssize_t>(EventTable<Layout>::number_of_fields),
+        static_cast<py::ssize_t>(owned_table->get_number_of_events())
+    };
+
+    const std::vector<py::ssize_t> strides = {
+        static_cast<py::ssize_t>(owned_table->get_column_stride() * sizeof(double)),
+        static_cast<py::ssize_t>(sizeof(double))
+    };
+
+    py::array_t<double> values(shape, strides, owned_table->data(), owner);
+
+    py::dict samples_with_units;
+
+    for (size_t field = 0; field < Layout::fields.size(); ++field) {
+        const EventField& event_field = Layout::fields[field];
+
+        samples_with_units[py::str(std::string(event_field.name))] =
+            values[py::int_(field)] * ureg.attr(py::str(std::string(event_field.units)));
+    }
+
+    return samples_with_units;
+}
+
+
+FLOWCYPY_MODULE(populations, module) {
     py::object ureg = get_shared_ureg();
 
+    register_random_seed_functions(module);
+    register_threading_functions(module);
+
     module.doc() = R"pdoc(
         FlowCyPy population module.
 
@@ -275,20 +316,7 @@ PYBIND11_MODULE(populations, module) {
         .def(
             "sample",
             [ureg](const SpherePopulation &population, const size_t number_of_samples) {
-                py::dict samples_with_units;
-
-                std::vector<size_t> shape = {number_of_samples};
-
-                samples_with_units["MediumRefractiveIndex"] =
-                    vector_move_from_numpy(population.medium_refractive_index->sample(number_of_samples), shape) * ureg.attr("RIU");
-
-                samples_with_units["RefractiveIndex"] =
-                    vector_move_from_numpy(population.refractive_index->sample(number_of_samples), shape) * ureg.attr("RIU");
-
-                samples_with_units["Diameter"] =
-                    vector_move_from_numpy(population.diameter->sample(number_of_samples), shape) * ureg.attr("meter");
-
-                return samples_with_units;
+                return event_table_to_dict(ureg, population.sample_events(number_of_samples));
             },
             py::arg("number_of_samples"),
             R"pdoc(
@@ -407,26 +435,7 @@ PYBIND11_MODULE(populations, module) {
         .def(
             "sample",
             [ureg](const CoreShellPopulation &population, const size_t number_of_samples) {
-                py::dict samples_with_units;
-
-                std::vector<size_t> shape = {number_of_samples};
-
-                samples_with_units["MediumRefractiveIndex"] =
-                    vector_move_from_numpy(population.medium_refractive_index->sample(number_of_samples), shape) * ureg.attr("RIU");
-
-                samples_with_units["CoreRefractiveIndex"] =
-                    vector_move_from_numpy(population.core_refractive_index->sample(number_of_samples), shape) * ureg.attr("RIU");
-
-                samples_with_units["ShellRefractiveIndex"] =
-                    vector_move_from_numpy(population.shell_refractive_index->sample(number_of_samples), shape) * ureg.attr("RIU");
-
-                samples_with_units["CoreDiameter"] =
-                    vector_move_from_numpy(population.core_diameter->sample(number_of_samples), shape) * ureg.attr("meter");
-
-                samples_with_units["ShellThickness"] =
-                    vector_move_from_numpy(population.shell_thickness->sample(number_of_samples), shape) * ureg.attr("meter");
-
-                return samples_with_units;
+                return event_table_to_dict(ureg, population.sample_events(number_of_samples));
             },
             py::arg("number_of_samples"),
             R"pdoc(
@@ -1,16 +1,48 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include <complex>
 #include <string>
-#include <unordered_map>
 #include <memory>
 
 #include <fluidics/distributions/distributions.h>
+#include <utils/random.h>
 #include "./sampling_methods.h"
+#include "./event_table.h"
 
 typedef std::complex<double> complex128;
 
+/*
+    @brief Sample one column of an event table per distribution, in parallel.
+
+    All columns are drawn from one fresh stream of the random service, column f at
+    the counter indices [f * number_of_events, (f + 1) * number_of_events), so the
+    values do not depend on the number of threads.
+
+    @param distributions Distribution of each field, in the order of Layout::fields.
+*/
+template <typename Layout>
+EventTable<Layout> sample_event_table(
+    const std::array<std::shared_ptr<BaseDistribution>, Layout::fields.size()> &distributions,
+    const size_t number_of_events
+) {
+    EventTable<Layout> table(number_of_events);
+
+    const utils::CounterRandomGenerator generator =
+        utils::RandomService::instance().next_generator(utils::RandomStreamId::population_properties);
+
+    for (size_t field = 0; field < distributions.size(); ++field)
+        distributions[field]->sample_into(
+            table.column(static_cast<typename Layout::Field>(field)).data(),
+            number_of_events,
+            generator,
+            static_cast<uint64_t>(field) * number_of_events
+        );
+
+    return table;
+}
+
 class BasePopulation {
 public:
     std::string name;
@@ -37,8 +69,6 @@ public:
         return concentration;
     }
 
-    virtual std::unordered_map<std::string, std::vector<double>> sample() const = 0;
-
 };
 
 class SpherePopulation: public BasePopulation {
@@ -64,12 +94,17 @@ public:
 
     double get_effective_concentration() const override;
 
-    std::unordered_map<std::string, std::vector<double>> sample() const override {
-        std::unordered_map<std::string, std::vector<double>> samples;
-        samples["Medium"] = medium_refractive_index->sample(1000);
-        samples["RefractiveIndex"] = refractive_index->sample(1000);
-        samples["Diameter"] = diameter->sample(1000);
-        return samples;
+    using EventLayout = SphereEventLayout;
+
+    /*
+        @brief Distribution of each field of the event layout, in field order.
+    */
+    std::array<std::shared_ptr<BaseDistribution>, 3> get_field_distributions() const {
+        return {medium_refractive_index, refractive_index, diameter};
+    }
+
+    EventTable<EventLayout> sample_events(const size_t number_of_events) const {
+        return sample_event_table<EventLayout>(this->get_field_distributions(), number_of_events);
     }
 
 };
@@ -104,14 +139,17 @@ public:
 
     double get_effective_concentration() const override;
 
-    std::unordered_map<std::string, std::vector<double>> sample() const override {
-        std::unordered_map<std::string, std::vector<double>> samples;
-        samples["Medium"] = medium_refractive_index->sample(1000);
-        samples["CoreRefractiveIndex"] = core_refractive_index->sample(1000);
-        samples["ShellRefractiveIndex"] = shell_refractive_index->sample(1000);
-        samples["CoreDiameter"] = core_diameter->sample(1000);
-        samples["ShellThickness"] = shell_thickness->sample(1000);
-        return samples;
+    using EventLayout = CoreShellEventLayout;
+
+    /*
+        @brief Distribution of each field of the event layout, in field order.
+    */
+    std::array<std::shared_ptr<BaseDistribution>, 5> get_field_distributions() const {
+        return {medium_refractive_index, core_refractive_index, shell_refractive_index, core_diameter, shell_thickness};
+    }
+
+    EventTable<EventLayout> sample_events(const size_t number_of_events) const {
+        return sample_event_table<EventLayout>(this->get_field_distributions(), number_of_events);
     }
 
 };
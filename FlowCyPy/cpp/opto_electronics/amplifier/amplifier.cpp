@@ -1,6 +1,10 @@
 #include "amplifier.h"
 #include <omp.h>
 
+#include <utils/random.h>
+#include <utils/profiler.h>
+#include <utils/threading.h>
+
 
 Amplifier::Amplifier(
     const double gain,
@@ -67,13 +71,19 @@ double Amplifier::get_rms_noise() const {
 }
 
 std::vector<double> Amplifier::amplify(
-    const std::vector<double>& signal,
+    std::span<const double> signal,
     const double sampling_rate
 ) const {
+    FLOWCYPY_PROFILE_SCOPE("amplifier.amplify");
+
     if (signal.empty()) {
         throw std::runtime_error("signal vector is empty.");
     }
 
+    FLOWCYPY_PROFILE_COUNT("amplifier.amplify", "samples", signal.size());
+    FLOWCYPY_PROFILE_COUNT("amplifier.amplify", "bytes", signal.size() * sizeof(double));
+    FLOWCYPY_PROFILE_MAX("amplifier.amplify", "threads", omp_get_max_threads());
+
     std::vector<double> output_signal;
 
     if (std::isnan(this->bandwidth)) {
@@ -105,7 +115,7 @@ std::vector<double> Amplifier::amplify(
 
 
 std::vector<double> Amplifier::amplify_with_bandwidth(
-    const std::vector<double>& signal,
+    std::span<const double> signal,
     const double sampling_rate
 ) const {
     if (signal.empty()) {
@@ -138,7 +148,7 @@ std::vector<double> Amplifier::amplify_with_bandwidth(
 
 
 
-    std::vector<double> output_signal(signal);
+    std::vector<double> output_signal(signal.begin(), signal.end());
 
     utils::apply_bessel_lowpass_filter_to_signal(
         output_signal,
@@ -153,7 +163,7 @@ std::vector<double> Amplifier::amplify_with_bandwidth(
 
 
 std::vector<double> Amplifier::amplify_without_bandwidth(
-    const std::vector<double>& signal
+    std::span<const double> signal
 ) const {
     if (signal.empty()) {
         throw std::runtime_error("signal vector is empty.");
@@ -161,7 +171,7 @@ std::vector<double> Amplifier::amplify_without_bandwidth(
 
     std::vector<double> output_signal(signal.size());
 
-    #pragma omp parallel
+    #pragma omp parallel num_threads(utils::get_team_size(signal.size(), utils::ParallelComponent::amplifier))
     {
         #pragma omp single
         {
@@ -184,49 +194,42 @@ std::vector<double> Amplifier::amplify_without_bandwidth(
 
 
 std::vector<double> Amplifier::add_gaussian_noise(
-    const std::vector<double>& signal,
+    std::span<const double> signal,
     const double mean,
     const double standard_deviation
 ) const {
+    FLOWCYPY_PROFILE_SCOPE("amplifier.add_gaussian_noise");
+
     if (signal.empty()) {
         throw std::runtime_error("signal vector is empty.");
     }
 
+    FLOWCYPY_PROFILE_COUNT("amplifier.add_gaussian_noise", "samples", signal.size());
+    FLOWCYPY_PROFILE_MAX("amplifier.add_gaussian_noise", "threads", omp_get_max_threads());
+
     if (standard_deviation < 0.0) {
         throw std::runtime_error("standard_deviation must be non negative.");
     }
 
     if (standard_deviation == 0.0) {
-        return signal;
+        return {signal.begin(), signal.end()};
     }
 
-    std::vector<double> output_signal(signal);
+    std::vector<double> output_signal(signal.begin(), signal.end());
 
-    #pragma omp parallel
-    {
-        #pragma omp single
-        {
-            if (this->debug_mode) {
-                std::printf(
-                    "[Amplifier::add_gaussian_noise] using %d OpenMP threads | mean=%g | std=%g\n",
-                    omp_get_num_threads(),
-                    mean,
-                    standard_deviation
-                );
-            }
-        }
-
-        std::random_device random_device;
-        std::mt19937 generator(
-            random_device() + static_cast<unsigned int>(omp_get_thread_num())
+    if (this->debug_mode) {
+        std::printf(
+            "[Amplifier::add_gaussian_noise] using %d OpenMP threads | mean=%g | std=%g\n",
+            omp_get_max_threads(),
+            mean,
+            standard_deviation
         );
-        std::normal_distribution<double> distribution(mean, standard_deviation);
-
-        #pragma omp for
-        for (long long index = 0; index < static_cast<long long>(output_signal.size()); ++index) {
-            output_signal[index] += distribution(generator);
-        }
     }
 
+    const utils::CounterRandomGenerator generator =
+        utils::RandomService::instance().next_generator(utils::RandomStreamId::amplifier_noise);
+
+    generator.add_normal(output_signal.data(), output_signal.size(), mean, standard_deviation);
+
     return output_signal;
 }
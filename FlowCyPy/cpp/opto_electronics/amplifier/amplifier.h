@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <span>
 #include <limits>
 #include <random>
 #include <cmath>
@@ -57,7 +58,7 @@ public:
      * @return Amplified signal.
      */
     std::vector<double> amplify(
-        const std::vector<double>& signal,
+        std::span<const double> signal,
         const double sampling_rate = std::numeric_limits<double>::quiet_NaN()
     ) const;
 
@@ -73,7 +74,7 @@ public:
      * @return Amplified and filtered signal.
      */
     std::vector<double> amplify_with_bandwidth(
-        const std::vector<double>& signal,
+        std::span<const double> signal,
         const double sampling_rate
     ) const;
 
@@ -84,7 +85,7 @@ public:
      * @return Amplified signal.
      */
     std::vector<double> amplify_without_bandwidth(
-        const std::vector<double>& signal
+        std::span<const double> signal
     ) const;
 
     /**
@@ -96,7 +97,7 @@ public:
      * @return Noisy signal.
      */
     std::vector<double> add_gaussian_noise(
-        const std::vector<double>& signal,
+        std::span<const double> signal,
         const double mean,
         const double standard_deviation
     ) const;
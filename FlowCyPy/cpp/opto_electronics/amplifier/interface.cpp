@@ -1,19 +1,31 @@
 #include <limits>
 #include <memory>
 #include <cmath>
+#include <utility>
 #include <vector>
 
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 #include <pint/pint.h>
+#include <utils/fft_plan_cache_binding.h>
+#include <utils/module_binding.h>
+#include <utils/profiler_binding.h>
+#include <utils/threading_binding.h>
+#include <utils/random_binding.h>
+#include <utils/numpy.h>
 
 #include "amplifier.h"
 
 namespace py = pybind11;
 
-PYBIND11_MODULE(amplifier, module) {
+FLOWCYPY_MODULE(amplifier, module) {
     py::object ureg = get_shared_ureg();
 
+    register_random_seed_functions(module);
+    register_profiling_functions(module);
+    register_threading_functions(module);
+    register_fft_plan_cache_functions(module);
+
     py::class_<Amplifier, std::shared_ptr<Amplifier>>(
         module,
         "Amplifier",
@@ -218,8 +230,7 @@ PYBIND11_MODULE(amplifier, module) {
 
                 py::object signal_in_ampere = signal.attr("to")("ampere");
 
-                std::vector<double> input_signal =
-                    signal_in_ampere.attr("magnitude").cast<std::vector<double>>();
+                const contiguous_array<double> input_signal = to_contiguous_array<double>(signal_in_ampere);
 
                 double sampling_rate_value = std::numeric_limits<double>::quiet_NaN();
                 if (!sampling_rate.is_none()) {
@@ -231,17 +242,13 @@ PYBIND11_MODULE(amplifier, module) {
                     }
                 }
 
-                std::vector<double> output_signal =
-                    amplifier.amplify(input_signal, sampling_rate_value);
-
-                py::array_t<double> output_array(output_signal.size());
-                auto mutable_view = output_array.mutable_unchecked<1>();
-
-                for (ssize_t index = 0; index < static_cast<ssize_t>(output_signal.size()); ++index) {
-                    mutable_view(index) = output_signal[static_cast<size_t>(index)];
+                std::vector<double> output_signal;
+                {
+                    py::gil_scoped_release release;
+                    output_signal = amplifier.amplify(array_to_span(input_signal), sampling_rate_value);
                 }
 
-                return output_array * ureg.attr("volt");
+                return vector_to_numpy_without_copy(std::move(output_signal)) * ureg.attr("volt");
             },
             py::arg("signal"),
             py::arg("sampling_rate"),
@@ -1,83 +1,190 @@
 #include "circuits.h"
 
+#include <algorithm>
 
-std::vector<double> SlidingMinimumBaselineCorrection::process(
-    const std::vector<double>& signal,
+#include <utils/profiler.h>
+
+
+void BaseCircuit::process_chunk(
+    std::span<float> signal,
     const double sampling_rate
-) const {
-    if (signal.empty()) {
-        throw std::runtime_error("signal vector is empty.");
-    }
+) {
+    std::vector<double> widened_signal(signal.begin(), signal.end());
 
-    std::vector<double> output_signal(signal);
+    this->process_chunk(std::span<double>(widened_signal), sampling_rate);
 
-    int window_size_in_samples = -1;
+    std::transform(
+        widened_signal.begin(),
+        widened_signal.end(),
+        signal.begin(),
+        [](const double value) { return static_cast<float>(value); }
+    );
+}
 
-    if (this->window_size != -1.0) {
-        if (std::isnan(sampling_rate) || sampling_rate <= 0.0) {
-            throw std::runtime_error(
-                "sampling_rate must be strictly positive for finite sliding minimum correction window."
-            );
-        }
 
-        window_size_in_samples = static_cast<int>(
-            std::llround(this->window_size * sampling_rate)
+int SlidingMinimumBaselineCorrection::get_window_size_in_samples(const double sampling_rate) const {
+    if (this->window_size == -1.0) {
+        return -1;
+    }
+
+    if (std::isnan(sampling_rate) || sampling_rate <= 0.0) {
+        throw std::runtime_error(
+            "sampling_rate must be strictly positive for finite sliding minimum correction window."
         );
+    }
 
-        if (window_size_in_samples <= 0) {
-            throw std::runtime_error(
-                "window_size corresponds to fewer than one sample."
-            );
-        }
+    const int window_size_in_samples = static_cast<int>(
+        std::llround(this->window_size * sampling_rate)
+    );
+
+    if (window_size_in_samples <= 0) {
+        throw std::runtime_error(
+            "window_size corresponds to fewer than one sample."
+        );
+    }
+
+    return window_size_in_samples;
+}
+
+
+std::vector<double> SlidingMinimumBaselineCorrection::process(
+    std::span<const double> signal,
+    const double sampling_rate
+) const {
+    FLOWCYPY_PROFILE_SCOPE("circuits.sliding_minimum_baseline_correction");
+    FLOWCYPY_PROFILE_COUNT("circuits.sliding_minimum_baseline_correction", "samples", signal.size());
+    FLOWCYPY_PROFILE_COUNT("circuits.sliding_minimum_baseline_correction", "bytes", signal.size() * sizeof(double));
+
+    if (signal.empty()) {
+        throw std::runtime_error("signal vector is empty.");
     }
 
+    std::vector<double> output_signal(signal.begin(), signal.end());
+
     utils::apply_baseline_restoration_to_signal(
         output_signal,
-        window_size_in_samples
+        this->get_window_size_in_samples(sampling_rate)
     );
 
     return output_signal;
 }
 
 
+void SlidingMinimumBaselineCorrection::process_chunk(
+    std::span<double> signal,
+    const double sampling_rate
+) {
+    if (signal.empty()) {
+        return;
+    }
+
+    const int window_size_in_samples = this->get_window_size_in_samples(sampling_rate);
+
+    if (this->sliding_minimum.get_window_size() != window_size_in_samples) {
+        this->sliding_minimum = utils::SlidingMinimum(window_size_in_samples);
+    }
+
+    this->sliding_minimum.subtract_in_place(signal.data(), signal.size());
+}
+
+
+void SlidingMinimumBaselineCorrection::reset() {
+    this->sliding_minimum.reset();
+}
+
+
 std::vector<double> BaselineRestorationServo::process(
-    const std::vector<double>& signal,
+    std::span<const double> signal,
     const double sampling_rate
 ) const {
+    FLOWCYPY_PROFILE_SCOPE("circuits.baseline_restoration_servo");
+    FLOWCYPY_PROFILE_COUNT("circuits.baseline_restoration_servo", "samples", signal.size());
+    FLOWCYPY_PROFILE_COUNT("circuits.baseline_restoration_servo", "bytes", signal.size() * sizeof(double));
+
     if (signal.empty()) {
         throw std::runtime_error("signal vector is empty.");
     }
 
+    BaselineRestorationServo servo(*this);
+    servo.reset();
+
+    std::vector<double> output_signal(signal.begin(), signal.end());
+    servo.process_chunk(output_signal, sampling_rate);
+
+    return output_signal;
+}
+
+
+void BaselineRestorationServo::process_chunk(
+    std::span<double> signal,
+    const double sampling_rate
+) {
+    this->process_chunk_samples(signal, sampling_rate);
+}
+
+
+void BaselineRestorationServo::process_chunk(
+    std::span<float> signal,
+    const double sampling_rate
+) {
+    this->process_chunk_samples(signal, sampling_rate);
+}
+
+
+template <typename Real>
+void BaselineRestorationServo::process_chunk_samples(
+    std::span<Real> signal,
+    const double sampling_rate
+) {
     if (std::isnan(sampling_rate) || sampling_rate <= 0.0) {
         throw std::runtime_error("sampling_rate must be strictly positive.");
     }
 
+    if (signal.empty()) {
+        return;
+    }
+
     const double time_step = 1.0 / sampling_rate;
     const double alpha = 1.0 - std::exp(-time_step / this->time_constant);
 
-    std::vector<double> output_signal(signal.size());
+    if (!this->has_started) {
+        this->baseline_estimate = this->initialize_with_first_sample
+            ? signal.front()
+            : this->reference_level;
+
+        this->has_started = true;
+    }
 
-    double baseline_estimate = this->initialize_with_first_sample
-        ? signal.front()
-        : this->reference_level;
+    double baseline_estimate = this->baseline_estimate;
 
     for (size_t index = 0; index < signal.size(); ++index) {
         baseline_estimate =
             (1.0 - alpha) * baseline_estimate +
             alpha * signal[index];
 
-        output_signal[index] =
-            signal[index] - baseline_estimate + this->reference_level;
+        signal[index] = static_cast<Real>(
+            signal[index] - baseline_estimate + this->reference_level
+        );
     }
 
-    return output_signal;
+    this->baseline_estimate = baseline_estimate;
+}
+
+
+void BaselineRestorationServo::reset() {
+    this->baseline_estimate = 0.0;
+    this->has_started = false;
 }
 
 
 std::vector<double> ButterworthLowPassFilter::process(
-    const std::vector<double>& signal,
+    std::span<const double> signal,
     const double sampling_rate
 ) const {
+    FLOWCYPY_PROFILE_SCOPE("circuits.butterworth_low_pass");
+    FLOWCYPY_PROFILE_COUNT("circuits.butterworth_low_pass", "samples", signal.size());
+    FLOWCYPY_PROFILE_COUNT("circuits.butterworth_low_pass", "bytes", signal.size() * sizeof(double));
+
     if (signal.empty()) {
         throw std::runtime_error("signal vector is empty.");
     }
@@ -92,7 +199,13 @@ std::vector<double> ButterworthLowPassFilter::process(
         );
     }
 
-    std::vector<double> output_signal(signal);
+    std::vector<double> output_signal(signal.begin(), signal.end());
+
+    if (this->implementation == LowPassImplementation::iir) {
+        utils::BiquadCascade cascade = this->design_cascade(sampling_rate);
+        cascade.process_in_place(output_signal);
+        return output_signal;
+    }
 
     utils::apply_butterworth_lowpass_filter_to_signal(
         output_signal,
@@ -107,9 +220,13 @@ std::vector<double> ButterworthLowPassFilter::process(
 
 
 std::vector<double> BesselLowPassFilter::process(
-    const std::vector<double>& signal,
+    std::span<const double> signal,
     const double sampling_rate
 ) const {
+    FLOWCYPY_PROFILE_SCOPE("circuits.bessel_low_pass");
+    FLOWCYPY_PROFILE_COUNT("circuits.bessel_low_pass", "samples", signal.size());
+    FLOWCYPY_PROFILE_COUNT("circuits.bessel_low_pass", "bytes", signal.size() * sizeof(double));
+
     if (signal.empty()) {
         throw std::runtime_error("signal vector is empty.");
     }
@@ -124,7 +241,13 @@ std::vector<double> BesselLowPassFilter::process(
         );
     }
 
-    std::vector<double> output_signal(signal);
+    std::vector<double> output_signal(signal.begin(), signal.end());
+
+    if (this->implementation == LowPassImplementation::iir) {
+        utils::BiquadCascade cascade = this->design_cascade(sampling_rate);
+        cascade.process_in_place(output_signal);
+        return output_signal;
+    }
 
     utils::apply_bessel_lowpass_filter_to_signal(
         output_signal,
@@ -136,3 +259,177 @@ std::vector<double> BesselLowPassFilter::process(
 
     return output_signal;
 }
+
+
+utils::BiquadCascade ButterworthLowPassFilter::design_cascade(const double sampling_rate) const {
+    return utils::design_butterworth_lowpass_sos(
+        sampling_rate,
+        this->cutoff_frequency,
+        this->order,
+        this->gain
+    );
+}
+
+
+utils::BiquadCascade BesselLowPassFilter::design_cascade(const double sampling_rate) const {
+    return utils::design_bessel_lowpass_sos(
+        sampling_rate,
+        this->cutoff_frequency,
+        this->order,
+        this->gain
+    );
+}
+
+
+void ButterworthLowPassFilter::process_chunk(
+    std::span<double> signal,
+    const double sampling_rate
+) {
+    this->process_chunk_samples(signal, sampling_rate);
+}
+
+
+void ButterworthLowPassFilter::process_chunk(
+    std::span<float> signal,
+    const double sampling_rate
+) {
+    this->process_chunk_samples(signal, sampling_rate);
+}
+
+
+template <typename Real>
+void ButterworthLowPassFilter::process_chunk_samples(
+    std::span<Real> signal,
+    const double sampling_rate
+) {
+    if (this->implementation != LowPassImplementation::iir) {
+        throw std::runtime_error(
+            "process_chunk requires the iir implementation: the fft implementation needs the whole signal."
+        );
+    }
+
+    if (sampling_rate != this->cascade_sampling_rate) {
+        this->cascade = this->design_cascade(sampling_rate);
+        this->cascade_sampling_rate = sampling_rate;
+    }
+
+    this->cascade.process_in_place(signal.data(), signal.size());
+}
+
+
+void ButterworthLowPassFilter::reset() {
+    this->cascade.reset();
+}
+
+
+void BesselLowPassFilter::process_chunk(
+    std::span<double> signal,
+    const double sampling_rate
+) {
+    this->process_chunk_samples(signal, sampling_rate);
+}
+
+
+void BesselLowPassFilter::process_chunk(
+    std::span<float> signal,
+    const double sampling_rate
+) {
+    this->process_chunk_samples(signal, sampling_rate);
+}
+
+
+template <typename Real>
+void BesselLowPassFilter::process_chunk_samples(
+    std::span<Real> signal,
+    const double sampling_rate
+) {
+    if (this->implementation != LowPassImplementation::iir) {
+        throw std::runtime_error(
+            "process_chunk requires the iir implementation: the fft implementation needs the whole signal."
+        );
+    }
+
+    if (sampling_rate != this->cascade_sampling_rate) {
+        this->cascade = this->design_cascade(sampling_rate);
+        this->cascade_sampling_rate = sampling_rate;
+    }
+
+    this->cascade.process_in_place(signal.data(), signal.size());
+}
+
+
+void BesselLowPassFilter::reset() {
+    this->cascade.reset();
+}
+
+
+CircuitChain::CircuitChain(std::vector<std::shared_ptr<BaseCircuit>> circuits)
+    : circuits(std::move(circuits))
+{
+    for (const std::shared_ptr<BaseCircuit>& circuit : this->circuits) {
+        if (!circuit) {
+            throw std::runtime_error("CircuitChain circuits must not be null.");
+        }
+    }
+}
+
+
+std::vector<double> CircuitChain::process(
+    std::span<const double> signal,
+    const double sampling_rate
+) const {
+    FLOWCYPY_PROFILE_SCOPE("circuits.chain");
+    FLOWCYPY_PROFILE_COUNT("circuits.chain", "samples", signal.size());
+    FLOWCYPY_PROFILE_COUNT("circuits.chain", "bytes", signal.size() * sizeof(double));
+
+    if (signal.empty()) {
+        throw std::runtime_error("signal vector is empty.");
+    }
+
+    std::vector<double> output_signal(signal.begin(), signal.end());
+
+    for (const std::shared_ptr<BaseCircuit>& circuit : this->circuits) {
+        output_signal = circuit->process(output_signal, sampling_rate);
+    }
+
+    return output_signal;
+}
+
+
+void CircuitChain::process_chunk(
+    std::span<double> signal,
+    const double sampling_rate
+) {
+    for (const std::shared_ptr<BaseCircuit>& circuit : this->circuits) {
+        circuit->process_chunk(signal, sampling_rate);
+    }
+}
+
+
+void CircuitChain::process_chunk(
+    std::span<float> signal,
+    const double sampling_rate
+) {
+    for (const std::shared_ptr<BaseCircuit>& circuit : this->circuits) {
+        circuit->process_chunk(signal, sampling_rate);
+    }
+}
+
+
+void CircuitChain::reset() {
+    for (const std::shared_ptr<BaseCircuit>& circuit : this->circuits) {
+        circuit->reset();
+    }
+}
+
+
+std::shared_ptr<BaseCircuit> CircuitChain::clone() const {
+    std::vector<std::shared_ptr<BaseCircuit>> cloned_circuits;
+    cloned_circuits.reserve(this->circuits.size());
+
+    for (const std::shared_ptr<BaseCircuit>& circuit : this->circuits) {
+        cloned_circuits.push_back(circuit->clone());
+    }
+
+    return std::make_shared<CircuitChain>(std::move(cloned_circuits));
+}
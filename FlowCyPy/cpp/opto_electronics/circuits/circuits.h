@@ -3,9 +3,26 @@
 #include <vector>
 #include <limits>
 #include <cmath>
+#include <memory>
+#include <span>
 #include <stdexcept>
 
 #include <utils/utils.h>
+#include <utils/iir_filter.h>
+
+
+/**
+ * @brief Numerical implementation used by the low pass filter circuits.
+ *
+ * - fft: zero phase magnitude response applied in the frequency domain over the
+ *   whole signal. The signal is treated as periodic.
+ * - iir: causal cascade of second order sections obtained with the bilinear
+ *   transform. It runs in O(N) time and O(order) memory, like an analog filter.
+ */
+enum class LowPassImplementation {
+    fft,
+    iir
+};
 
 
 class BaseCircuit {
@@ -29,9 +46,53 @@ public:
      * @return Processed signal samples.
      */
     virtual std::vector<double> process(
-        const std::vector<double>& signal,
+        std::span<const double> signal,
         const double sampling_rate = std::numeric_limits<double>::quiet_NaN()
     ) const = 0;
+
+    /**
+     * @brief Process one block of a longer signal in place, keeping state across calls.
+     *
+     * Feeding a signal block by block through process_chunk gives the same samples
+     * as a single call on the concatenated signal, as long as the circuit state is
+     * not reset in between. Memory use is bounded by the block size and the circuit
+     * state, independently of the total signal length.
+     *
+     * @param signal Block of samples, overwritten with the processed output.
+     * @param sampling_rate Sampling rate in hertz. Use NaN when not required.
+     */
+    virtual void process_chunk(
+        std::span<double> signal,
+        const double sampling_rate = std::numeric_limits<double>::quiet_NaN()
+    ) = 0;
+
+    /**
+     * @brief Single precision counterpart of process_chunk.
+     *
+     * Circuit states stay in double precision. The default implementation widens
+     * the block to double, processes it, then rounds it back to float; circuits
+     * with a per sample recursion override it to work on the floats directly.
+     *
+     * @param signal Block of samples, overwritten with the processed output.
+     * @param sampling_rate Sampling rate in hertz. Use NaN when not required.
+     */
+    virtual void process_chunk(
+        std::span<float> signal,
+        const double sampling_rate = std::numeric_limits<double>::quiet_NaN()
+    );
+
+    /**
+     * @brief Clear the internal state so the next chunk starts a new signal.
+     */
+    virtual void reset() = 0;
+
+    /**
+     * @brief Copy of the circuit, parameters and chunk state included.
+     *
+     * Streams of several channels use one clone per channel, so that each
+     * channel keeps its own state.
+     */
+    virtual std::shared_ptr<BaseCircuit> clone() const = 0;
 };
 
 
@@ -99,9 +160,40 @@ public:
      * one sample.
      */
     std::vector<double> process(
-        const std::vector<double>& signal,
+        std::span<const double> signal,
         const double sampling_rate = std::numeric_limits<double>::quiet_NaN()
     ) const override;
+
+    /**
+     * @brief Apply the correction to one block, continuing the window of previous blocks.
+     *
+     * The monotonic deque of the sliding minimum is kept between blocks, so the
+     * minimum at the start of a block is taken over the same window as in a single
+     * pass. If the sampling rate changes, the window restarts empty.
+     *
+     * @param signal Block of samples, corrected in place.
+     * @param sampling_rate Sampling rate in hertz. Required for finite windows.
+     *
+     * @throws std::runtime_error If a finite window is requested and the
+     * sampling rate is not strictly positive.
+     */
+    void process_chunk(
+        std::span<double> signal,
+        const double sampling_rate = std::numeric_limits<double>::quiet_NaN()
+    ) override;
+
+    using BaseCircuit::process_chunk;
+
+    void reset() override;
+
+    std::shared_ptr<BaseCircuit> clone() const override {
+        return std::make_shared<SlidingMinimumBaselineCorrection>(*this);
+    }
+
+private:
+    int get_window_size_in_samples(const double sampling_rate) const;
+
+    utils::SlidingMinimum sliding_minimum;
 };
 
 
@@ -180,9 +272,40 @@ public:
      * @throws std::runtime_error If the sampling rate is not strictly positive.
      */
     std::vector<double> process(
-        const std::vector<double>& signal,
+        std::span<const double> signal,
         const double sampling_rate
     ) const override;
+
+    /**
+     * @brief Apply the servo to one block, continuing from the previous baseline estimate.
+     *
+     * @param signal Block of samples, restored in place.
+     * @param sampling_rate Sampling rate in hertz.
+     *
+     * @throws std::runtime_error If the sampling rate is not strictly positive.
+     */
+    void process_chunk(
+        std::span<double> signal,
+        const double sampling_rate
+    ) override;
+
+    void process_chunk(
+        std::span<float> signal,
+        const double sampling_rate
+    ) override;
+
+    void reset() override;
+
+    std::shared_ptr<BaseCircuit> clone() const override {
+        return std::make_shared<BaselineRestorationServo>(*this);
+    }
+
+private:
+    template <typename Real>
+    void process_chunk_samples(std::span<Real> signal, const double sampling_rate);
+
+    double baseline_estimate = 0.0;
+    bool has_started = false;
 };
 
 
@@ -191,6 +314,7 @@ public:
     double cutoff_frequency;  // [hertz]
     int order;
     double gain;
+    LowPassImplementation implementation = LowPassImplementation::fft;
 
     ButterworthLowPassFilter() = default;
 
@@ -200,15 +324,18 @@ public:
      * @param cutoff_frequency Cutoff frequency in hertz.
      * @param order Filter order.
      * @param gain Output gain applied after filtering.
+     * @param implementation Frequency domain or causal IIR implementation.
      */
     ButterworthLowPassFilter(
         const double cutoff_frequency,
         const int order,
-        const double gain
+        const double gain,
+        const LowPassImplementation implementation = LowPassImplementation::fft
     )
         : cutoff_frequency(cutoff_frequency),
           order(order),
-          gain(gain)
+          gain(gain),
+          implementation(implementation)
     {
         if (this->cutoff_frequency <= 0.0) {
             throw std::runtime_error("cutoff_frequency must be strictly positive.");
@@ -223,9 +350,10 @@ public:
      * @brief Process a signal using a Butterworth low pass filter.
      *
      * This method applies a Butterworth low pass filter to the input signal and
-     * returns the filtered result. The filter is implemented in the frequency
-     * domain and requires the sampling rate to determine the discrete frequency
-     * axis.
+     * returns the filtered result. With the fft implementation the filter is
+     * applied in the frequency domain; with the iir implementation it runs as a
+     * causal cascade of second order sections (see design_cascade). Both require
+     * the sampling rate to map the cutoff frequency to the discrete signal.
      *
      * The transfer function magnitude is defined as:
      *
@@ -245,9 +373,58 @@ public:
      * to the Nyquist frequency.
      */
     std::vector<double> process(
-        const std::vector<double>& signal,
+        std::span<const double> signal,
         const double sampling_rate
     ) const override;
+
+    /**
+     * @brief Build the causal second order section cascade of this filter.
+     *
+     * The returned cascade starts from a zero state and can be fed chunk by chunk
+     * through utils::BiquadCascade::process_in_place.
+     *
+     * @param sampling_rate Sampling rate in hertz.
+     * @return Cascade including the output gain.
+     *
+     * @throws std::runtime_error If the sampling rate is not strictly positive or
+     * if the cutoff frequency is not below the Nyquist frequency.
+     */
+    utils::BiquadCascade design_cascade(const double sampling_rate) const;
+
+    /**
+     * @brief Filter one block with the causal cascade, keeping its state across calls.
+     *
+     * The cascade is designed on the first call and designed again, from a zero
+     * state, whenever the sampling rate changes.
+     *
+     * @param signal Block of samples, filtered in place.
+     * @param sampling_rate Sampling rate in hertz.
+     *
+     * @throws std::runtime_error If the filter uses the fft implementation, which
+     * needs the whole signal at once.
+     */
+    void process_chunk(
+        std::span<double> signal,
+        const double sampling_rate
+    ) override;
+
+    void process_chunk(
+        std::span<float> signal,
+        const double sampling_rate
+    ) override;
+
+    void reset() override;
+
+    std::shared_ptr<BaseCircuit> clone() const override {
+        return std::make_shared<ButterworthLowPassFilter>(*this);
+    }
+
+private:
+    template <typename Real>
+    void process_chunk_samples(std::span<Real> signal, const double sampling_rate);
+
+    utils::BiquadCascade cascade;
+    double cascade_sampling_rate = std::numeric_limits<double>::quiet_NaN();
 };
 
 
@@ -256,6 +433,7 @@ public:
     double cutoff_frequency;  // [hertz]
     int order;
     double gain;
+    LowPassImplementation implementation = LowPassImplementation::fft;
 
     BesselLowPassFilter() = default;
 
@@ -265,15 +443,18 @@ public:
      * @param cutoff_frequency Cutoff frequency in hertz.
      * @param order Filter order.
      * @param gain Output gain applied after filtering.
+     * @param implementation Frequency domain or causal IIR implementation.
      */
     BesselLowPassFilter(
         const double cutoff_frequency,
         const int order,
-        const double gain
+        const double gain,
+        const LowPassImplementation implementation = LowPassImplementation::fft
     )
         : cutoff_frequency(cutoff_frequency),
           order(order),
-          gain(gain)
+          gain(gain),
+          implementation(implementation)
     {
         if (this->cutoff_frequency <= 0.0) {
             throw std::runtime_error("cutoff_frequency must be strictly positive.");
@@ -288,9 +469,10 @@ public:
      * @brief Process a signal using a Bessel low pass filter.
      *
      * This method applies a Bessel low pass filter to the input signal and
-     * returns the filtered result. The filter is implemented in the frequency
-     * domain and requires the sampling rate to determine the discrete frequency
-     * axis.
+     * returns the filtered result. With the fft implementation the filter is
+     * applied in the frequency domain; with the iir implementation it runs as a
+     * causal cascade of second order sections (see design_cascade). Both require
+     * the sampling rate to map the cutoff frequency to the discrete signal.
      *
      * The Bessel filter is often preferred when preserving pulse shape and group
      * delay characteristics is more important than achieving the sharpest
@@ -308,7 +490,99 @@ public:
      * to the Nyquist frequency.
      */
     std::vector<double> process(
-        const std::vector<double>& signal,
+        std::span<const double> signal,
+        const double sampling_rate
+    ) const override;
+
+    /**
+     * @brief Build the causal second order section cascade of this filter.
+     *
+     * The returned cascade starts from a zero state and can be fed chunk by chunk
+     * through utils::BiquadCascade::process_in_place.
+     *
+     * @param sampling_rate Sampling rate in hertz.
+     * @return Cascade including the output gain.
+     *
+     * @throws std::runtime_error If the sampling rate is not strictly positive or
+     * if the cutoff frequency is not below the Nyquist frequency.
+     */
+    utils::BiquadCascade design_cascade(const double sampling_rate) const;
+
+    /**
+     * @brief Filter one block with the causal cascade, keeping its state across calls.
+     *
+     * The cascade is designed on the first call and designed again, from a zero
+     * state, whenever the sampling rate changes.
+     *
+     * @param signal Block of samples, filtered in place.
+     * @param sampling_rate Sampling rate in hertz.
+     *
+     * @throws std::runtime_error If the filter uses the fft implementation, which
+     * needs the whole signal at once.
+     */
+    void process_chunk(
+        std::span<double> signal,
+        const double sampling_rate
+    ) override;
+
+    void process_chunk(
+        std::span<float> signal,
         const double sampling_rate
+    ) override;
+
+    void reset() override;
+
+    std::shared_ptr<BaseCircuit> clone() const override {
+        return std::make_shared<BesselLowPassFilter>(*this);
+    }
+
+private:
+    template <typename Real>
+    void process_chunk_samples(std::span<Real> signal, const double sampling_rate);
+
+    utils::BiquadCascade cascade;
+    double cascade_sampling_rate = std::numeric_limits<double>::quiet_NaN();
+};
+
+
+/**
+ * @brief Sequence of circuits applied one after the other.
+ *
+ * process_chunk runs every stage in place over the same block, so a chain of
+ * any length only ever holds one block of samples. process applies the stages
+ * to a copy of the input and leaves the stage states untouched.
+ */
+class CircuitChain : public BaseCircuit {
+public:
+    std::vector<std::shared_ptr<BaseCircuit>> circuits;
+
+    CircuitChain() = default;
+
+    /**
+     * @brief Construct a chain from its stages, in processing order.
+     *
+     * @param circuits Circuits applied in order.
+     *
+     * @throws std::runtime_error If one of the circuits is null.
+     */
+    explicit CircuitChain(std::vector<std::shared_ptr<BaseCircuit>> circuits);
+
+    std::vector<double> process(
+        std::span<const double> signal,
+        const double sampling_rate = std::numeric_limits<double>::quiet_NaN()
     ) const override;
+
+    void process_chunk(
+        std::span<double> signal,
+        const double sampling_rate = std::numeric_limits<double>::quiet_NaN()
+    ) override;
+
+    void process_chunk(
+        std::span<float> signal,
+        const double sampling_rate = std::numeric_limits<double>::quiet_NaN()
+    ) override;
+
+    void reset() override;
+
+    std::shared_ptr<BaseCircuit> clone() const override;
 };
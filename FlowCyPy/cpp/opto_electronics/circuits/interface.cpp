@@ -1,6 +1,8 @@
 #include <limits>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <pybind11/pybind11.h>
@@ -8,12 +10,45 @@
 #include <pybind11/numpy.h>
 
 #include <pint/pint.h>
+#include <utils/module_binding.h>
+#include <utils/fft_plan_cache_binding.h>
+#include <utils/numpy.h>
+#include <utils/profiler_binding.h>
+#include <utils/threading_binding.h>
 #include "circuits.h"
 
 namespace py = pybind11;
 
 
-PYBIND11_MODULE(circuits, module) {
+namespace {
+
+LowPassImplementation parse_lowpass_implementation(const std::string& value) {
+    if (value == "fft") {
+        return LowPassImplementation::fft;
+    }
+
+    if (value == "iir") {
+        return LowPassImplementation::iir;
+    }
+
+    throw std::invalid_argument(
+        "implementation must be one of {'fft', 'iir'}."
+    );
+}
+
+
+std::string lowpass_implementation_to_string(const LowPassImplementation value) {
+    if (value == LowPassImplementation::iir) {
+        return "iir";
+    }
+
+    return "fft";
+}
+
+}  // namespace
+
+
+FLOWCYPY_MODULE(circuits, module) {
     py::object ureg = get_shared_ureg();
 
     module.doc() = R"pbdoc(
@@ -65,8 +100,7 @@ PYBIND11_MODULE(circuits, module) {
                 }
 
                 py::object signal_units = signal.attr("units");
-                std::vector<double> input_signal =
-                    signal.attr("magnitude").cast<std::vector<double>>();
+                const contiguous_array<double> input_signal = to_contiguous_array<double>(signal);
 
                 double sampling_rate_value = std::numeric_limits<double>::quiet_NaN();
 
@@ -79,17 +113,13 @@ PYBIND11_MODULE(circuits, module) {
                     }
                 }
 
-                std::vector<double> output_signal =
-                    circuit.process(input_signal, sampling_rate_value);
-
-                py::array_t<double> output_array(output_signal.size());
-                auto output_view = output_array.mutable_unchecked<1>();
-
-                for (ssize_t index = 0; index < static_cast<ssize_t>(output_signal.size()); ++index) {
-                    output_view(index) = output_signal[static_cast<size_t>(index)];
+                std::vector<double> output_signal;
+                {
+                    py::gil_scoped_release release;
+                    output_signal = circuit.process(array_to_span(input_signal), sampling_rate_value);
                 }
 
-                return output_array * signal_units;
+                return vector_to_numpy_without_copy(std::move(output_signal)) * signal_units;
             },
             py::arg("signal"),
             py::arg("sampling_rate") = py::none(),
@@ -118,6 +148,76 @@ PYBIND11_MODULE(circuits, module) {
                 Only the numerical values are transformed by the circuit.
             )pbdoc"
         )
+        .def(
+            "process_chunk",
+            [](
+                BaseCircuit& circuit,
+                const py::object& signal,
+                const py::object& sampling_rate
+            ) {
+                if (!py::hasattr(signal, "units") || !py::hasattr(signal, "magnitude")) {
+                    throw std::runtime_error(
+                        "signal must be a Pint quantity backed by a one dimensional NumPy array."
+                    );
+                }
+
+                py::object signal_units = signal.attr("units");
+                std::vector<double> chunk = array_to_vector(to_contiguous_array<double>(signal));
+
+                double sampling_rate_value = std::numeric_limits<double>::quiet_NaN();
+
+                if (!sampling_rate.is_none()) {
+                    sampling_rate_value =
+                        sampling_rate.attr("to")("hertz").attr("magnitude").cast<double>();
+
+                    if (sampling_rate_value <= 0.0) {
+                        throw std::runtime_error("sampling_rate must be strictly positive.");
+                    }
+                }
+
+                {
+                    py::gil_scoped_release release;
+                    circuit.process_chunk(chunk, sampling_rate_value);
+                }
+
+                return vector_to_numpy_without_copy(std::move(chunk)) * signal_units;
+            },
+            py::arg("signal"),
+            py::arg("sampling_rate") = py::none(),
+            R"pbdoc(
+                Process one block of a longer signal, keeping the circuit state.
+
+                Successive calls continue from the state left by the previous
+                call, so feeding a signal block by block gives the same result as
+                a single :meth:`process` call on the whole signal.
+
+                Parameters
+                ----------
+                signal : pint.Quantity
+                    One dimensional block of the input signal.
+                sampling_rate : pint.Quantity or None, optional
+                    Sampling rate in hertz.
+
+                Returns
+                -------
+                pint.Quantity
+                    Processed block with the same units as the input.
+
+                Notes
+                -----
+                Low pass filters only support this method with
+                ``implementation="iir"``.
+            )pbdoc"
+        )
+        .def(
+            "reset",
+            &BaseCircuit::reset,
+            R"pbdoc(
+                Clear the state kept by :meth:`process_chunk`.
+
+                The next block is processed as the start of a new signal.
+            )pbdoc"
+        )
         .def(
             "__repr__",
             [](py::object self) {
@@ -214,8 +314,7 @@ PYBIND11_MODULE(circuits, module) {
                 }
 
                 py::object signal_units = signal.attr("units");
-                std::vector<double> input_signal =
-                    signal.attr("magnitude").cast<std::vector<double>>();
+                const contiguous_array<double> input_signal = to_contiguous_array<double>(signal);
 
                 double sampling_rate_value = std::numeric_limits<double>::quiet_NaN();
 
@@ -228,17 +327,13 @@ PYBIND11_MODULE(circuits, module) {
                     }
                 }
 
-                std::vector<double> output_signal =
-                    circuit.process(input_signal, sampling_rate_value);
-
-                py::array_t<double> output_array(output_signal.size());
-                auto output_view = output_array.mutable_unchecked<1>();
-
-                for (ssize_t index = 0; index < static_cast<ssize_t>(output_signal.size()); ++index) {
-                    output_view(index) = output_signal[static_cast<size_t>(index)];
+                std::vector<double> output_signal;
+                {
+                    py::gil_scoped_release release;
+                    output_signal = circuit.process(array_to_span(input_signal), sampling_rate_value);
                 }
 
-                return output_array * signal_units;
+                return vector_to_numpy_without_copy(std::move(output_signal)) * signal_units;
             },
             py::arg("signal"),
             py::arg("sampling_rate") = py::none(),
@@ -393,8 +488,7 @@ PYBIND11_MODULE(circuits, module) {
                 }
 
                 py::object signal_units = signal.attr("units");
-                std::vector<double> input_signal =
-                    signal.attr("magnitude").cast<std::vector<double>>();
+                const contiguous_array<double> input_signal = to_contiguous_array<double>(signal);
 
                 const double sampling_rate_value =
                     sampling_rate.attr("to")("hertz").attr("magnitude").cast<double>();
@@ -403,17 +497,13 @@ PYBIND11_MODULE(circuits, module) {
                     throw std::runtime_error("sampling_rate must be strictly positive.");
                 }
 
-                std::vector<double> output_signal =
-                    circuit.process(input_signal, sampling_rate_value);
-
-                py::array_t<double> output_array(output_signal.size());
-                auto output_view = output_array.mutable_unchecked<1>();
-
-                for (ssize_t index = 0; index < static_cast<ssize_t>(output_signal.size()); ++index) {
-                    output_view(index) = output_signal[static_cast<size_t>(index)];
+                std::vector<double> output_signal;
+                {
+                    py::gil_scoped_release release;
+                    output_signal = circuit.process(array_to_span(input_signal), sampling_rate_value);
                 }
 
-                return output_array * signal_units;
+                return vector_to_numpy_without_copy(std::move(output_signal)) * signal_units;
             },
             py::arg("signal"),
             py::arg("sampling_rate"),
@@ -477,7 +567,8 @@ PYBIND11_MODULE(circuits, module) {
                 [ureg](
                     const py::object& cutoff_frequency,
                     const int order,
-                    const double gain
+                    const double gain,
+                    const std::string& implementation
                 ) {
                     const double cutoff_frequency_hertz =
                         cutoff_frequency.attr("to")("hertz").attr("magnitude").cast<double>();
@@ -485,13 +576,15 @@ PYBIND11_MODULE(circuits, module) {
                     return std::make_shared<ButterworthLowPassFilter>(
                         cutoff_frequency_hertz,
                         order,
-                        gain
+                        gain,
+                        parse_lowpass_implementation(implementation)
                     );
                 }
             ),
             py::arg("cutoff_frequency"),
             py::arg("order"),
             py::arg("gain"),
+            py::arg("implementation") = "fft",
             R"pbdoc(
                 Initialize a Butterworth low pass filter.
 
@@ -505,6 +598,12 @@ PYBIND11_MODULE(circuits, module) {
                     Higher orders produce a steeper roll off.
                 gain : float
                     Multiplicative gain applied to the filtered output.
+                implementation : {"fft", "iir"}, default="fft"
+                    ``"fft"`` applies the magnitude response in the frequency
+                    domain over the whole signal (zero phase, periodic edges).
+                    ``"iir"`` runs a causal cascade of second order sections
+                    obtained with the bilinear transform, as an analog filter
+                    would.
 
                 Notes
                 -----
@@ -537,6 +636,15 @@ PYBIND11_MODULE(circuits, module) {
                 and stopband.
             )pbdoc"
         )
+        .def_property_readonly(
+            "implementation",
+            [](const ButterworthLowPassFilter& circuit) {
+                return lowpass_implementation_to_string(circuit.implementation);
+            },
+            R"pbdoc(
+                Numerical implementation of the filter, ``"fft"`` or ``"iir"``.
+            )pbdoc"
+        )
         .def_readonly(
             "gain",
             &ButterworthLowPassFilter::gain,
@@ -564,8 +672,7 @@ PYBIND11_MODULE(circuits, module) {
                 }
 
                 py::object signal_units = signal.attr("units");
-                std::vector<double> input_signal =
-                    signal.attr("magnitude").cast<std::vector<double>>();
+                const contiguous_array<double> input_signal = to_contiguous_array<double>(signal);
 
                 const double sampling_rate_value =
                     sampling_rate.attr("to")("hertz").attr("magnitude").cast<double>();
@@ -574,17 +681,13 @@ PYBIND11_MODULE(circuits, module) {
                     throw std::runtime_error("sampling_rate must be strictly positive.");
                 }
 
-                std::vector<double> output_signal =
-                    circuit.process(input_signal, sampling_rate_value);
-
-                py::array_t<double> output_array(output_signal.size());
-                auto output_view = output_array.mutable_unchecked<1>();
-
-                for (ssize_t index = 0; index < static_cast<ssize_t>(output_signal.size()); ++index) {
-                    output_view(index) = output_signal[static_cast<size_t>(index)];
+                std::vector<double> output_signal;
+                {
+                    py::gil_scoped_release release;
+                    output_signal = circuit.process(array_to_span(input_signal), sampling_rate_value);
                 }
 
-                return output_array * signal_units;
+                return vector_to_numpy_without_copy(std::move(output_signal)) * signal_units;
             },
             py::arg("signal"),
             py::arg("sampling_rate"),
@@ -616,7 +719,8 @@ PYBIND11_MODULE(circuits, module) {
                     "ButterworthLowPass(cutoff_frequency=" +
                     std::to_string(circuit.cutoff_frequency) +
                     ", order=" + std::to_string(circuit.order) +
-                    ", gain=" + std::to_string(circuit.gain) + ")";
+                    ", gain=" + std::to_string(circuit.gain) +
+                    ", implementation='" + lowpass_implementation_to_string(circuit.implementation) + "')";
             }
         );
 
@@ -645,7 +749,8 @@ PYBIND11_MODULE(circuits, module) {
                 [ureg](
                     const py::object& cutoff_frequency,
                     const int order,
-                    const double gain
+                    const double gain,
+                    const std::string& implementation
                 ) {
                     const double cutoff_frequency_hertz =
                         cutoff_frequency.attr("to")("hertz").attr("magnitude").cast<double>();
@@ -653,13 +758,15 @@ PYBIND11_MODULE(circuits, module) {
                     return std::make_shared<BesselLowPassFilter>(
                         cutoff_frequency_hertz,
                         order,
-                        gain
+                        gain,
+                        parse_lowpass_implementation(implementation)
                     );
                 }
             ),
             py::arg("cutoff_frequency"),
             py::arg("order"),
             py::arg("gain"),
+            py::arg("implementation") = "fft",
             R"pbdoc(
                 Initialize a Bessel low pass filter.
 
@@ -671,6 +778,12 @@ PYBIND11_MODULE(circuits, module) {
                     Filter order.
                 gain : float
                     Multiplicative gain applied to the filtered output.
+                implementation : {"fft", "iir"}, default="fft"
+                    ``"fft"`` applies the magnitude response in the frequency
+                    domain over the whole signal (zero phase, periodic edges).
+                    ``"iir"`` runs a causal cascade of second order sections
+                    obtained with the bilinear transform, as an analog filter
+                    would.
 
                 Notes
                 -----
@@ -702,6 +815,15 @@ PYBIND11_MODULE(circuits, module) {
                 Higher orders increase the sharpness of the low pass transition.
             )pbdoc"
         )
+        .def_property_readonly(
+            "implementation",
+            [](const BesselLowPassFilter& circuit) {
+                return lowpass_implementation_to_string(circuit.implementation);
+            },
+            R"pbdoc(
+                Numerical implementation of the filter, ``"fft"`` or ``"iir"``.
+            )pbdoc"
+        )
         .def_readonly(
             "gain",
             &BesselLowPassFilter::gain,
@@ -729,8 +851,7 @@ PYBIND11_MODULE(circuits, module) {
                 }
 
                 py::object signal_units = signal.attr("units");
-                std::vector<double> input_signal =
-                    signal.attr("magnitude").cast<std::vector<double>>();
+                const contiguous_array<double> input_signal = to_contiguous_array<double>(signal);
 
                 const double sampling_rate_value =
                     sampling_rate.attr("to")("hertz").attr("magnitude").cast<double>();
@@ -739,17 +860,13 @@ PYBIND11_MODULE(circuits, module) {
                     throw std::runtime_error("sampling_rate must be strictly positive.");
                 }
 
-                std::vector<double> output_signal =
-                    circuit.process(input_signal, sampling_rate_value);
-
-                py::array_t<double> output_array(output_signal.size());
-                auto output_view = output_array.mutable_unchecked<1>();
-
-                for (ssize_t index = 0; index < static_cast<ssize_t>(output_signal.size()); ++index) {
-                    output_view(index) = output_signal[static_cast<size_t>(index)];
+                std::vector<double> output_signal;
+                {
+                    py::gil_scoped_release release;
+                    output_signal = circuit.process(array_to_span(input_signal), sampling_rate_value);
                 }
 
-                return output_array * signal_units;
+                return vector_to_numpy_without_copy(std::move(output_signal)) * signal_units;
             },
             py::arg("signal"),
             py::arg("sampling_rate"),
@@ -781,7 +898,54 @@ PYBIND11_MODULE(circuits, module) {
                     "BesselLowPass(cutoff_frequency=" +
                     std::to_string(circuit.cutoff_frequency) +
                     ", order=" + std::to_string(circuit.order) +
-                    ", gain=" + std::to_string(circuit.gain) + ")";
+                    ", gain=" + std::to_string(circuit.gain) +
+                    ", implementation='" + lowpass_implementation_to_string(circuit.implementation) + "')";
             }
         );
+
+
+    py::class_<
+        CircuitChain,
+        BaseCircuit,
+        std::shared_ptr<CircuitChain>
+    >(
+        module,
+        "CircuitChain",
+        R"pbdoc(
+            Sequence of circuits applied one after the other.
+
+            :meth:`process_chunk` runs every stage in place over the same block,
+            so long acquisitions can stream through the whole chain one block at
+            a time.
+        )pbdoc"
+    )
+        .def(
+            py::init<std::vector<std::shared_ptr<BaseCircuit>>>(),
+            py::arg("circuits"),
+            R"pbdoc(
+                Initialize a circuit chain.
+
+                Parameters
+                ----------
+                circuits : list of BaseCircuit
+                    Circuits applied in order.
+            )pbdoc"
+        )
+        .def_readonly(
+            "circuits",
+            &CircuitChain::circuits,
+            R"pbdoc(
+                Circuits of the chain, in processing order.
+            )pbdoc"
+        )
+        .def(
+            "__repr__",
+            [](const CircuitChain& circuit) {
+                return "CircuitChain(stages=" + std::to_string(circuit.circuits.size()) + ")";
+            }
+        );
+
+    register_profiling_functions(module);
+    register_threading_functions(module);
+    register_fft_plan_cache_functions(module);
 }
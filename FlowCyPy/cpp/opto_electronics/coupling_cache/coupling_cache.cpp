@@ -0,0 +1,371 @@
+#include "coupling_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+
+#include <utils/threading.h>
+
+
+namespace {
+
+constexpr char file_magic[8] = {'F', 'C', 'P', 'Y', 'C', 'P', 'L', 'C'};
+constexpr uint64_t file_version = 1;
+
+template <typename T>
+void write_value(std::ofstream& stream, const T& value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T read_value(std::ifstream& stream) {
+    T value;
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+
+    if (!stream)
+        throw std::runtime_error("CouplingCache: unexpected end of file.");
+
+    return value;
+}
+
+}  // namespace
+
+
+CouplingCache::CouplingCache(
+    const double diameter_step,
+    const double refractive_index_step,
+    const double medium_refractive_index_step,
+    const double relative_tolerance)
+:   steps{diameter_step, refractive_index_step, medium_refractive_index_step},
+    relative_tolerance(relative_tolerance)
+{
+    for (const double step : this->steps) {
+        if (!(step > 0.0) || !std::isfinite(step))
+            throw std::invalid_argument("CouplingCache: grid steps must be finite and strictly positive.");
+    }
+
+    if (!(relative_tolerance >= 0.0))
+        throw std::invalid_argument("CouplingCache: relative_tolerance must be non-negative.");
+}
+
+CouplingCache::CouplingCache(const CouplingCache& other)
+:   steps(other.steps),
+    relative_tolerance(other.relative_tolerance)
+{
+    std::shared_lock lock(other.mutex);
+    this->tables = other.tables;
+}
+
+void CouplingCache::validate_particles(
+    const std::vector<double>& diameter,
+    const std::vector<double>& refractive_index,
+    const std::vector<double>& medium_refractive_index) const
+{
+    if (refractive_index.size() != diameter.size() || medium_refractive_index.size() != diameter.size())
+        throw std::invalid_argument("CouplingCache: diameter, refractive_index and medium_refractive_index must have the same size.");
+
+    // locate casts positions to int64_t cells, and get_cell_nodes doubles them.
+    constexpr double max_position = 0x1p60;
+    const std::array<const std::vector<double>*, number_of_axes> axes = {&diameter, &refractive_index, &medium_refractive_index};
+    constexpr std::array<const char*, number_of_axes> names = {"diameter", "refractive_index", "medium_refractive_index"};
+
+    for (size_t axis = 0; axis < number_of_axes; ++axis) {
+        for (size_t idx = 0; idx < axes[axis]->size(); ++idx) {
+            const double value = (*axes[axis])[idx];
+
+            if (!std::isfinite(value) || std::abs(value / this->steps[axis]) >= max_position)
+                throw std::invalid_argument(
+                    "CouplingCache: " + std::string(names[axis]) + " of particle " + std::to_string(idx) + " is not finite or lies off the grid."
+                );
+        }
+    }
+}
+
+void CouplingCache::locate(
+    const std::array<double, number_of_axes>& particle,
+    std::array<int64_t, number_of_axes>& cell,
+    std::array<double, number_of_axes>& fraction) const
+{
+    for (size_t axis = 0; axis < number_of_axes; ++axis) {
+        const double position = particle[axis] / this->steps[axis];
+        const double lower = std::floor(position);
+
+        cell[axis] = static_cast<int64_t>(lower);
+        fraction[axis] = position - lower;
+    }
+}
+
+std::array<CouplingLatticeKey, 8> CouplingCache::get_cell_nodes(const std::array<int64_t, number_of_axes>& cell) {
+    std::array<CouplingLatticeKey, 8> nodes;
+
+    for (size_t corner = 0; corner < 8; ++corner) {
+        for (size_t axis = 0; axis < number_of_axes; ++axis)
+            nodes[corner].index[axis] = 2 * (cell[axis] + static_cast<int64_t>((corner >> axis) & 1));
+    }
+
+    return nodes;
+}
+
+CouplingLatticeKey CouplingCache::get_cell_center(const std::array<int64_t, number_of_axes>& cell) {
+    return CouplingLatticeKey{{2 * cell[0] + 1, 2 * cell[1] + 1, 2 * cell[2] + 1}};
+}
+
+std::vector<double> CouplingCache::get_required_points(
+    const std::vector<double>& setup_key,
+    const std::vector<double>& diameter,
+    const std::vector<double>& refractive_index,
+    const std::vector<double>& medium_refractive_index) const
+{
+    this->validate_particles(diameter, refractive_index, medium_refractive_index);
+
+    std::shared_lock lock(this->mutex);
+
+    const auto table_iterator = this->tables.find(setup_key);
+    const Table* table = table_iterator == this->tables.end() ? nullptr : &table_iterator->second;
+
+    std::unordered_set<CouplingLatticeKey, CouplingLatticeKeyHash> missing;
+    std::vector<double> points;
+
+    auto request = [&](const CouplingLatticeKey& key) {
+        if (table != nullptr && table->count(key) != 0)
+            return;
+
+        if (!missing.insert(key).second)
+            return;
+
+        for (size_t axis = 0; axis < number_of_axes; ++axis)
+            points.push_back(0.5 * static_cast<double>(key.index[axis]) * this->steps[axis]);
+    };
+
+    std::array<int64_t, number_of_axes> cell;
+    std::array<double, number_of_axes> fraction;
+
+    for (size_t idx = 0; idx < diameter.size(); ++idx) {
+        this->locate({diameter[idx], refractive_index[idx], medium_refractive_index[idx]}, cell, fraction);
+
+        for (const CouplingLatticeKey& node : get_cell_nodes(cell))
+            request(node);
+
+        request(get_cell_center(cell));
+    }
+
+    return points;
+}
+
+void CouplingCache::insert_points(
+    const std::vector<double>& setup_key,
+    const std::vector<double>& points,
+    const std::vector<double>& values)
+{
+    if (points.size() != number_of_axes * values.size())
+        throw std::invalid_argument("CouplingCache: points must hold three coordinates per value.");
+
+    std::vector<CouplingLatticeKey> keys(values.size());
+
+    for (size_t idx = 0; idx < values.size(); ++idx) {
+        for (size_t axis = 0; axis < number_of_axes; ++axis) {
+            const double half_steps = 2.0 * points[number_of_axes * idx + axis] / this->steps[axis];
+            const double rounded = std::round(half_steps);
+
+            if (!std::isfinite(half_steps) || std::abs(half_steps - rounded) > 1e-6)
+                throw std::invalid_argument("CouplingCache: inserted points must come from get_required_points.");
+
+            keys[idx].index[axis] = static_cast<int64_t>(rounded);
+        }
+    }
+
+    std::unique_lock lock(this->mutex);
+
+    Table& table = this->tables[setup_key];
+
+    for (size_t idx = 0; idx < values.size(); ++idx)
+        table[keys[idx]] = values[idx];
+}
+
+std::vector<double> CouplingCache::interpolate(
+    const std::vector<double>& setup_key,
+    const std::vector<double>& diameter,
+    const std::vector<double>& refractive_index,
+    const std::vector<double>& medium_refractive_index) const
+{
+    this->validate_particles(diameter, refractive_index, medium_refractive_index);
+
+    constexpr double not_available = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> output(diameter.size(), not_available);
+
+    std::shared_lock lock(this->mutex);
+
+    const auto table_iterator = this->tables.find(setup_key);
+
+    if (table_iterator == this->tables.end())
+        return output;
+
+    const Table& table = table_iterator->second;
+    const double tolerance = this->relative_tolerance;
+
+    auto trilinear = [](const std::array<double, 8>& corner_values, const std::array<double, number_of_axes>& fraction) {
+        double value = 0.0;
+
+        for (size_t corner = 0; corner < 8; ++corner) {
+            double weight = 1.0;
+
+            for (size_t axis = 0; axis < number_of_axes; ++axis)
+                weight *= ((corner >> axis) & 1) ? fraction[axis] : 1.0 - fraction[axis];
+
+            value += weight * corner_values[corner];
+        }
+
+        return value;
+    };
+
+    const std::array<double, number_of_axes> center_fraction = {0.5, 0.5, 0.5};
+    const long long number_of_particles = static_cast<long long>(diameter.size());
+
+    // Each particle reads the 8 nodes of its cell, hence counts as 8 work items.
+    #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(8 * diameter.size(), utils::ParallelComponent::detector))
+    for (long long idx = 0; idx < number_of_particles; ++idx) {
+        std::array<int64_t, number_of_axes> cell;
+        std::array<double, number_of_axes> fraction;
+
+        this->locate({diameter[idx], refractive_index[idx], medium_refractive_index[idx]}, cell, fraction);
+
+        const auto center_iterator = table.find(get_cell_center(cell));
+        if (center_iterator == table.end())
+            continue;
+
+        std::array<double, 8> corner_values;
+        double largest_magnitude = std::abs(center_iterator->second);
+        bool complete = true;
+
+        const std::array<CouplingLatticeKey, 8> nodes = get_cell_nodes(cell);
+
+        for (size_t corner = 0; corner < 8 && complete; ++corner) {
+            const auto node_iterator = table.find(nodes[corner]);
+            complete = node_iterator != table.end();
+
+            if (complete) {
+                corner_values[corner] = node_iterator->second;
+                largest_magnitude = std::max(largest_magnitude, std::abs(node_iterator->second));
+            }
+        }
+
+        if (!complete)
+            continue;
+
+        const double center_error = std::abs(trilinear(corner_values, center_fraction) - center_iterator->second);
+
+        if (center_error > tolerance * largest_magnitude)
+            continue;
+
+        output[idx] = trilinear(corner_values, fraction);
+    }
+
+    return output;
+}
+
+size_t CouplingCache::get_number_of_points() const {
+    std::shared_lock lock(this->mutex);
+
+    size_t count = 0;
+    for (const auto& [setup_key, table] : this->tables)
+        count += table.size();
+
+    return count;
+}
+
+size_t CouplingCache::get_number_of_setups() const {
+    std::shared_lock lock(this->mutex);
+    return this->tables.size();
+}
+
+void CouplingCache::clear() {
+    std::unique_lock lock(this->mutex);
+    this->tables.clear();
+}
+
+void CouplingCache::save(const std::string& filename) const {
+    std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+
+    if (!stream)
+        throw std::runtime_error("CouplingCache: cannot open '" + filename + "' for writing.");
+
+    std::shared_lock lock(this->mutex);
+
+    stream.write(file_magic, sizeof(file_magic));
+    write_value(stream, file_version);
+
+    for (const double step : this->steps)
+        write_value(stream, step);
+
+    write_value(stream, this->relative_tolerance);
+    write_value(stream, static_cast<uint64_t>(this->tables.size()));
+
+    for (const auto& [setup_key, table] : this->tables) {
+        write_value(stream, static_cast<uint64_t>(setup_key.size()));
+        for (const double value : setup_key)
+            write_value(stream, value);
+
+        write_value(stream, static_cast<uint64_t>(table.size()));
+        for (const auto& [key, value] : table) {
+            for (const int64_t index : key.index)
+                write_value(stream, index);
+
+            write_value(stream, value);
+        }
+    }
+
+    if (!stream)
+        throw std::runtime_error("CouplingCache: failed to write '" + filename + "'.");
+}
+
+CouplingCache CouplingCache::load(const std::string& filename) {
+    std::ifstream stream(filename, std::ios::binary);
+
+    if (!stream)
+        throw std::runtime_error("CouplingCache: cannot open '" + filename + "' for reading.");
+
+    char magic[sizeof(file_magic)];
+    stream.read(magic, sizeof(magic));
+
+    if (!stream || std::memcmp(magic, file_magic, sizeof(file_magic)) != 0)
+        throw std::runtime_error("CouplingCache: '" + filename + "' is not a coupling cache file.");
+
+    if (read_value<uint64_t>(stream) != file_version)
+        throw std::runtime_error("CouplingCache: unsupported version in '" + filename + "'.");
+
+    std::array<double, number_of_axes> steps;
+    for (double& step : steps)
+        step = read_value<double>(stream);
+
+    const double relative_tolerance = read_value<double>(stream);
+
+    CouplingCache cache(steps[0], steps[1], steps[2], relative_tolerance);
+
+    const uint64_t number_of_setups = read_value<uint64_t>(stream);
+
+    for (uint64_t setup = 0; setup < number_of_setups; ++setup) {
+        std::vector<double> setup_key(read_value<uint64_t>(stream));
+        for (double& value : setup_key)
+            value = read_value<double>(stream);
+
+        Table& table = cache.tables[setup_key];
+
+        const uint64_t number_of_points = read_value<uint64_t>(stream);
+        table.reserve(number_of_points);
+
+        for (uint64_t point = 0; point < number_of_points; ++point) {
+            CouplingLatticeKey key;
+            for (int64_t& index : key.index)
+                index = read_value<int64_t>(stream);
+
+            table[key] = read_value<double>(stream);
+        }
+    }
+
+    return cache;
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * @brief Lattice coordinates of a cached coupling point, in half grid steps.
+ *
+ * Grid nodes have even coordinates on every axis and cell centers odd coordinates,
+ * so that the nodes of a cell and the probe point at its center share one table.
+ */
+struct CouplingLatticeKey {
+    std::array<int64_t, 3> index;
+
+    bool operator==(const CouplingLatticeKey& other) const { return index == other.index; }
+};
+
+struct CouplingLatticeKeyHash {
+    size_t operator()(const CouplingLatticeKey& key) const {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+
+        for (const int64_t value : key.index) {
+            hash ^= static_cast<uint64_t>(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        }
+
+        return static_cast<size_t>(hash);
+    }
+};
+
+
+/**
+ * @brief Memoized coupling power of spheres, interpolated on a user set grid.
+ *
+ * The coupling of a sphere depends on its diameter, its refractive index and the
+ * medium refractive index for a given optical setup (source wavelength and
+ * polarization, detector numerical apertures, angles and sampling). Coupling
+ * values are stored per unit source intensity, on a regular grid over the three
+ * particle parameters, separately for every optical setup. The optical setup is
+ * identified by a key vector built by the caller.
+ *
+ * The table is filled lazily in two steps:
+ * - get_required_points lists the grid nodes around the requested particles, and
+ *   the centers of their cells, whose exact coupling is not known yet;
+ * - insert_points stores the exact couplings the caller computed for them.
+ *
+ * interpolate then evaluates the trilinear interpolation of the cell holding each
+ * particle. The exact coupling at the cell center bounds the interpolation error:
+ * a cell whose interpolated center deviates by more than relative_tolerance from
+ * the exact value is rejected, and its particles get NaN so that the caller
+ * evaluates them exactly. This keeps Mie resonances from being smoothed out when
+ * the grid is too coarse for them.
+ *
+ * The cache may be shared between runs and detectors, and saved to or loaded
+ * from disk, so that sweeps over the same optical setup skip Mie evaluation once
+ * the grid is filled. Concurrent reads are safe; insertions are serialized.
+ */
+class CouplingCache {
+public:
+    static constexpr size_t number_of_axes = 3;
+
+    /**
+     * @param diameter_step Grid step of the diameter axis, in meters.
+     * @param refractive_index_step Grid step of the particle refractive index axis.
+     * @param medium_refractive_index_step Grid step of the medium refractive index axis.
+     * @param relative_tolerance Largest accepted relative interpolation error at a cell center.
+     *
+     * @throws std::invalid_argument If a step is not strictly positive or the tolerance is negative.
+     */
+    CouplingCache(
+        const double diameter_step,
+        const double refractive_index_step,
+        const double medium_refractive_index_step,
+        const double relative_tolerance = 1e-3
+    );
+
+    CouplingCache(const CouplingCache& other);
+    CouplingCache& operator=(const CouplingCache& other) = delete;
+
+    /**
+     * @brief Points whose exact coupling is needed before interpolate can serve the given particles.
+     *
+     * @param setup_key Values identifying the optical setup.
+     * @param diameter Particle diameters, in meters.
+     * @param refractive_index Particle refractive indices.
+     * @param medium_refractive_index Medium refractive indices.
+     * @return Row major (M, 3) array of (diameter, refractive index, medium refractive index), without duplicates.
+     *
+     * @throws std::invalid_argument If the particle arrays differ in size.
+     */
+    std::vector<double> get_required_points(
+        const std::vector<double>& setup_key,
+        const std::vector<double>& diameter,
+        const std::vector<double>& refractive_index,
+        const std::vector<double>& medium_refractive_index
+    ) const;
+
+    /**
+     * @brief Store exact couplings, per unit source intensity, of points returned by get_required_points.
+     *
+     * @param setup_key Values identifying the optical setup.
+     * @param points Row major (M, 3) array of points.
+     * @param values Coupling of every point.
+     *
+     * @throws std::invalid_argument If the sizes do not match or a point does not lie on the lattice.
+     */
+    void insert_points(
+        const std::vector<double>& setup_key,
+        const std::vector<double>& points,
+        const std::vector<double>& values
+    );
+
+    /**
+     * @brief Interpolated coupling, per unit source intensity, of every particle.
+     *
+     * @return Coupling of every particle; NaN where a point of its cell is missing
+     *         or the cell does not meet the tolerance.
+     */
+    std::vector<double> interpolate(
+        const std::vector<double>& setup_key,
+        const std::vector<double>& diameter,
+        const std::vector<double>& refractive_index,
+        const std::vector<double>& medium_refractive_index
+    ) const;
+
+    /**
+     * @brief Total number of stored points over all optical setups.
+     */
+    size_t get_number_of_points() const;
+
+    /**
+     * @brief Number of optical setups with at least one stored point.
+     */
+    size_t get_number_of_setups() const;
+
+    /**
+     * @brief Remove every stored point.
+     */
+    void clear();
+
+    /**
+     * @brief Write the grid and every stored point to a binary file.
+     *
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void save(const std::string& filename) const;
+
+    /**
+     * @brief Read a cache written by save.
+     *
+     * @throws std::runtime_error If the file cannot be read or is not a coupling cache.
+     */
+    static CouplingCache load(const std::string& filename);
+
+    double get_diameter_step() const { return this->steps[0]; }
+    double get_refractive_index_step() const { return this->steps[1]; }
+    double get_medium_refractive_index_step() const { return this->steps[2]; }
+    double get_relative_tolerance() const { return this->relative_tolerance; }
+
+private:
+    using Table = std::unordered_map<CouplingLatticeKey, double, CouplingLatticeKeyHash>;
+
+    std::array<double, number_of_axes> steps;
+    double relative_tolerance;
+
+    mutable std::shared_mutex mutex;
+    std::map<std::vector<double>, Table> tables;
+
+    /**
+     * @brief Check the particle arrays share one size and hold finite values a cell index can represent.
+     *
+     * @throws std::invalid_argument Otherwise, before any particle is located.
+     */
+    void validate_particles(
+        const std::vector<double>& diameter,
+        const std::vector<double>& refractive_index,
+        const std::vector<double>& medium_refractive_index
+    ) const;
+
+    /**
+     * @brief Lower node of the cell holding a particle, in grid steps, and its fractional position in the cell.
+     *
+     * The particle must have passed validate_particles.
+     */
+    void locate(
+        const std::array<double, number_of_axes>& particle,
+        std::array<int64_t, number_of_axes>& cell,
+        std::array<double, number_of_axes>& fraction
+    ) const;
+
+    /**
+     * @brief The eight nodes of a cell, in half grid steps, indexed by the bits (axis 0, axis 1, axis 2).
+     */
+    static std::array<CouplingLatticeKey, 8> get_cell_nodes(const std::array<int64_t, number_of_axes>& cell);
+
+    static CouplingLatticeKey get_cell_center(const std::array<int64_t, number_of_axes>& cell);
+};
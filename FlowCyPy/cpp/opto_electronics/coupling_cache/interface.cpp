@@ -0,0 +1,246 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+
+#include <string>
+#include <vector>
+
+#include "coupling_cache.h"
+#include <pint/pint.h>
+#include <utils/module_binding.h>
+#include <utils/numpy.h>
+#include <utils/threading_binding.h>
+
+namespace py = pybind11;
+
+
+FLOWCYPY_MODULE(coupling_cache, module) {
+    py::object ureg = get_shared_ureg();
+
+    register_threading_functions(module);
+
+    module.doc() = R"pbdoc(
+        Memoized coupling power for FlowCyPy.
+
+        This module stores sphere coupling powers on a regular grid over diameter,
+        refractive index and medium refractive index, per optical setup, and
+        interpolates them with a bounded error so that repeated runs over the same
+        optical setup skip Mie evaluation.
+    )pbdoc";
+
+    py::class_<CouplingCache, std::shared_ptr<CouplingCache>>(
+        module,
+        "CouplingCache",
+        R"pbdoc(
+            Coupling power per unit source intensity, interpolated on a grid and filled lazily.
+
+            Values are stored separately for every optical setup, identified by a
+            key of floats (source wavelength and polarization, detector numerical
+            apertures, angles and sampling). Each particle is interpolated
+            trilinearly in its grid cell. The exact coupling at the cell center
+            is stored as well, and a cell whose interpolated center deviates from
+            it by more than ``relative_tolerance`` is not interpolated: its
+            particles must be evaluated exactly.
+
+            Parameters
+            ----------
+            diameter_step : pint.Quantity
+                Grid step of the diameter axis.
+            refractive_index_step : float
+                Grid step of the particle refractive index axis.
+            medium_refractive_index_step : float
+                Grid step of the medium refractive index axis.
+            relative_tolerance : float, optional
+                Largest accepted relative interpolation error at a cell center.
+        )pbdoc"
+    )
+        .def(
+            py::init(
+                [](
+                    const py::object& diameter_step,
+                    const double refractive_index_step,
+                    const double medium_refractive_index_step,
+                    const double relative_tolerance
+                ) {
+                    return std::make_shared<CouplingCache>(
+                        to_meters_strict(diameter_step),
+                        refractive_index_step,
+                        medium_refractive_index_step,
+                        relative_tolerance
+                    );
+                }
+            ),
+            py::arg("diameter_step"),
+            py::arg("refractive_index_step"),
+            py::arg("medium_refractive_index_step"),
+            py::arg("relative_tolerance") = 1e-3
+        )
+        .def_property_readonly(
+            "diameter_step",
+            [ureg](const CouplingCache& self) {
+                return py::float_(self.get_diameter_step()) * ureg.attr("meter");
+            },
+            R"pbdoc(
+                Grid step of the diameter axis.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "refractive_index_step",
+            &CouplingCache::get_refractive_index_step,
+            R"pbdoc(
+                Grid step of the particle refractive index axis.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "medium_refractive_index_step",
+            &CouplingCache::get_medium_refractive_index_step,
+            R"pbdoc(
+                Grid step of the medium refractive index axis.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "relative_tolerance",
+            &CouplingCache::get_relative_tolerance,
+            R"pbdoc(
+                Largest accepted relative interpolation error at a cell center.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "number_of_points",
+            &CouplingCache::get_number_of_points,
+            R"pbdoc(
+                Number of stored exact couplings, over all optical setups.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "number_of_setups",
+            &CouplingCache::get_number_of_setups,
+            R"pbdoc(
+                Number of optical setups with stored couplings.
+            )pbdoc"
+        )
+        .def(
+            "get_required_points",
+            [](const CouplingCache& self, const std::vector<double>& setup_key, const py::object& diameter, const py::object& refractive_index, const py::object& medium_refractive_index) {
+                std::vector<double> points = self.get_required_points(
+                    setup_key,
+                    to_vector_units(diameter, "meter"),
+                    array_like_1d_to_double_vector(refractive_index),
+                    array_like_1d_to_double_vector(medium_refractive_index)
+                );
+
+                const size_t number_of_points = points.size() / CouplingCache::number_of_axes;
+
+                return vector_move_from_numpy(std::move(points), {number_of_points, CouplingCache::number_of_axes});
+            },
+            py::arg("setup_key"),
+            py::arg("diameter"),
+            py::arg("refractive_index"),
+            py::arg("medium_refractive_index"),
+            R"pbdoc(
+                Points whose exact coupling is needed to interpolate the given particles.
+
+                Parameters
+                ----------
+                setup_key : list[float]
+                    Values identifying the optical setup.
+                diameter : pint.Quantity
+                    Particle diameters.
+                refractive_index : array-like
+                    Particle refractive indices.
+                medium_refractive_index : array-like
+                    Medium refractive indices.
+
+                Returns
+                -------
+                numpy.ndarray
+                    Array of shape (M, 3) of (diameter in meters, refractive index,
+                    medium refractive index), one row per missing grid node or cell
+                    center.
+            )pbdoc"
+        )
+        .def(
+            "insert_points",
+            [](CouplingCache& self, const std::vector<double>& setup_key, const py::object& points, const py::object& values) {
+                self.insert_points(
+                    setup_key,
+                    array_to_vector(to_contiguous_array<double>(points)),
+                    array_like_1d_to_double_vector(values)
+                );
+            },
+            py::arg("setup_key"),
+            py::arg("points"),
+            py::arg("values"),
+            R"pbdoc(
+                Store the exact coupling, per unit source intensity, of points returned by :meth:`get_required_points`.
+
+                Parameters
+                ----------
+                setup_key : list[float]
+                    Values identifying the optical setup.
+                points : numpy.ndarray
+                    Array of shape (M, 3) returned by :meth:`get_required_points`.
+                values : array-like
+                    Coupling of every point, in watts per unit source intensity.
+            )pbdoc"
+        )
+        .def(
+            "interpolate",
+            [](const CouplingCache& self, const std::vector<double>& setup_key, const py::object& diameter, const py::object& refractive_index, const py::object& medium_refractive_index) {
+                return vector_to_numpy_without_copy(
+                    self.interpolate(
+                        setup_key,
+                        to_vector_units(diameter, "meter"),
+                        array_like_1d_to_double_vector(refractive_index),
+                        array_like_1d_to_double_vector(medium_refractive_index)
+                    )
+                );
+            },
+            py::arg("setup_key"),
+            py::arg("diameter"),
+            py::arg("refractive_index"),
+            py::arg("medium_refractive_index"),
+            R"pbdoc(
+                Interpolated coupling, per unit source intensity, of every particle.
+
+                Returns
+                -------
+                numpy.ndarray
+                    Coupling of every particle, NaN where the cell of the particle
+                    is incomplete or exceeds the tolerance.
+            )pbdoc"
+        )
+        .def(
+            "clear",
+            &CouplingCache::clear,
+            R"pbdoc(
+                Remove every stored coupling.
+            )pbdoc"
+        )
+        .def(
+            "save",
+            &CouplingCache::save,
+            py::arg("filename"),
+            R"pbdoc(
+                Write the grid and every stored coupling to a binary file.
+            )pbdoc"
+        )
+        .def_static(
+            "load",
+            [](const std::string& filename) {
+                return std::make_shared<CouplingCache>(CouplingCache::load(filename));
+            },
+            py::arg("filename"),
+            R"pbdoc(
+                Read a coupling cache written by :meth:`save`.
+            )pbdoc"
+        )
+        .def(
+            "__repr__",
+            [](const CouplingCache& self) {
+                return
+                    "CouplingCache(setups=" + std::to_string(self.get_number_of_setups()) +
+                    ", points=" + std::to_string(self.get_number_of_points()) + ")";
+            }
+        );
+}
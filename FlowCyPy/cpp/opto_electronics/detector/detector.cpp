@@ -5,6 +5,8 @@
 #include <cstdint>
 
 #include <utils/constants.h>
+#include <utils/random.h>
+#include <utils/profiler.h>
 
 
 Detector::Detector(
@@ -118,18 +120,13 @@ double Detector::resolve_bandwidth(
 }
 
 
-std::vector<double> Detector::apply_dark_current_noise(
-    const std::vector<double>& signal,
+double Detector::get_current_noise_standard_deviation(
     const double bandwidth
 ) const {
     const double effective_bandwidth = this->resolve_bandwidth(bandwidth);
 
     if (!this->bandwidth_is_defined(effective_bandwidth)) {
-        return signal;
-    }
-
-    if (signal.empty()) {
-        throw std::invalid_argument("Signal array is empty.");
+        return std::numeric_limits<double>::quiet_NaN();
     }
 
     const double dark_current_shot_noise_variance =
@@ -143,24 +140,44 @@ std::vector<double> Detector::apply_dark_current_noise(
         this->current_noise_density *
         effective_bandwidth;
 
-    const double standard_deviation_noise = std::sqrt(
+    return std::sqrt(
         dark_current_shot_noise_variance +
         current_noise_density_variance
     );
+}
 
-    std::random_device random_device;
-    std::mt19937_64 random_number_generator(random_device());
-    std::normal_distribution<double> normal_distribution(
-        this->dark_current,
-        standard_deviation_noise
-    );
 
-    std::vector<double> noisy_signal(signal.size());
+std::vector<double> Detector::apply_dark_current_noise(
+    std::span<const double> signal,
+    const double bandwidth
+) const {
+    FLOWCYPY_PROFILE_SCOPE("detector.apply_dark_current_noise");
+    FLOWCYPY_PROFILE_COUNT("detector.apply_dark_current_noise", "samples", signal.size());
+    FLOWCYPY_PROFILE_COUNT("detector.apply_dark_current_noise", "bytes", signal.size() * sizeof(double));
 
-    for (size_t index = 0; index < signal.size(); ++index) {
-        noisy_signal[index] = signal[index] + normal_distribution(random_number_generator);
+    const double standard_deviation_noise =
+        this->get_current_noise_standard_deviation(bandwidth);
+
+    if (std::isnan(standard_deviation_noise)) {
+        return {signal.begin(), signal.end()};
+    }
+
+    if (signal.empty()) {
+        throw std::invalid_argument("Signal array is empty.");
     }
 
+    const utils::CounterRandomGenerator generator =
+        utils::RandomService::instance().next_generator(utils::RandomStreamId::detector_dark_current);
+
+    std::vector<double> noisy_signal(signal.begin(), signal.end());
+
+    generator.add_normal(
+        noisy_signal.data(),
+        noisy_signal.size(),
+        this->dark_current,
+        standard_deviation_noise
+    );
+
     return noisy_signal;
 }
 
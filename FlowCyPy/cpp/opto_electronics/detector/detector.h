@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <span>
 #include <cmath>
 #include <limits>
 #include <stdexcept>
@@ -39,7 +40,17 @@ public:
     void clear_bandwidth();
 
     std::vector<double> apply_dark_current_noise(
-        const std::vector<double>& signal,
+        std::span<const double> signal,
+        const double bandwidth = std::numeric_limits<double>::quiet_NaN()
+    ) const;
+
+    /**
+     * @brief Standard deviation of the dark current shot noise and current noise density.
+     *
+     * @param bandwidth Noise bandwidth in hertz, NaN to use the detector bandwidth.
+     * @return Standard deviation in ampere, NaN if no bandwidth is defined.
+     */
+    double get_current_noise_standard_deviation(
         const double bandwidth = std::numeric_limits<double>::quiet_NaN()
     ) const;
 
@@ -3,13 +3,19 @@
 #include <pybind11/numpy.h>
 
 #include <string>
+#include <utility>
 #include <vector>
 #include <limits>
 #include <cmath>
 
 #include "detector.h"
 #include <utils/casting.h>
+#include <utils/module_binding.h>
+#include <utils/numpy.h>
 #include <pint/pint.h>
+#include <utils/profiler_binding.h>
+#include <utils/threading_binding.h>
+#include <utils/random_binding.h>
 
 namespace py = pybind11;
 
@@ -47,7 +53,7 @@ py::object as_responsivity_quantity(
 }  // namespace
 
 
-PYBIND11_MODULE(detector, module) {
+FLOWCYPY_MODULE(detector, module) {
     py::object unit_registry = get_shared_ureg();
 
     module.doc() = R"pbdoc(
@@ -72,6 +78,10 @@ PYBIND11_MODULE(detector, module) {
         - responsivity in units compatible with ampere per watt
     )pbdoc";
 
+    register_random_seed_functions(module);
+    register_profiling_functions(module);
+    register_threading_functions(module);
+
     py::class_<Detector>(
         module,
         "Detector",
@@ -474,10 +484,13 @@ PYBIND11_MODULE(detector, module) {
                         "hertz"
                     );
 
-                const std::vector<double> output_signal =
-                    self.apply_dark_current_noise(signal_vector, bandwidth_value);
+                std::vector<double> output_signal;
+                {
+                    py::gil_scoped_release release;
+                    output_signal = self.apply_dark_current_noise(signal_vector, bandwidth_value);
+                }
 
-                return py::array_t<double>(output_signal.size(), output_signal.data()) * unit_registry.attr("ampere");
+                return vector_to_numpy_without_copy(std::move(output_signal)) * unit_registry.attr("ampere");
             },
             py::arg("signal"),
             py::arg("bandwidth") = py::none(),
@@ -1,7 +1,12 @@
 #include "digitizer.h"
 
+#include <algorithm>
 #include <omp.h>
 #include <cstdio>
+#include <type_traits>
+
+#include <utils/profiler.h>
+#include <utils/threading.h>
 
 
 namespace {
@@ -10,6 +15,118 @@ inline bool is_metadata_channel(const std::string& channel_name) {
     return channel_name == "Time" || channel_name == "segment_id";
 }
 
+
+// Round half away from zero, as std::llround, with operations that vectorize: the
+// conversion to int64_t truncates and the fraction left decides the carry.
+inline int64_t round_half_away_from_zero(const double value) {
+    const int64_t truncated = static_cast<int64_t>(value);
+    const double fraction = value - static_cast<double>(truncated);
+    return truncated + (fraction >= 0.5 ? 1 : 0) - (fraction <= -0.5 ? 1 : 0);
+}
+
+
+// Fused clip + normalize + round kernel. Floating point outputs keep NaN samples as
+// NaN; integer outputs write 0 for them. Returns whether a NaN sample was found.
+template <typename Output>
+bool quantize_samples(
+    const double* input,
+    Output* output,
+    const size_t number_of_samples,
+    const double local_min_voltage,
+    const double local_max_voltage,
+    const int64_t minimum_code,
+    const int64_t maximum_code
+) {
+    const double minimum_code_value = static_cast<double>(minimum_code);
+    const double maximum_code_value = static_cast<double>(maximum_code);
+    const double voltage_span = local_max_voltage - local_min_voltage;
+    const double code_span = maximum_code_value - minimum_code_value;
+
+    // An integer count rather than a boolean flag keeps the reduction vectorizable.
+    size_t nan_count = 0;
+
+    #pragma omp parallel for simd schedule(static) reduction(+:nan_count) num_threads(utils::get_team_size(number_of_samples, utils::ParallelComponent::digitizer))
+    for (size_t index = 0; index < number_of_samples; ++index) {
+        const double sample = input[index];
+        const bool sample_is_nan = std::isnan(sample);
+        nan_count += sample_is_nan ? 1 : 0;
+
+        const double clipped_sample = std::clamp(sample_is_nan ? local_min_voltage : sample, local_min_voltage, local_max_voltage);
+        const double normalized_value = (clipped_sample - local_min_voltage) / voltage_span;
+        const double floating_code = minimum_code_value + normalized_value * code_span;
+        const int64_t code = round_half_away_from_zero(std::clamp(floating_code, minimum_code_value, maximum_code_value));
+
+        if constexpr (std::is_floating_point_v<Output>) {
+            output[index] = sample_is_nan ? sample : static_cast<Output>(code);
+        } else {
+            output[index] = sample_is_nan ? Output(0) : static_cast<Output>(code);
+        }
+    }
+
+    return nan_count > 0;
+}
+
+
+// Clip and quantize a signal into integer codes in one pass, with the rounding of
+// Digitizer::digitize_signal_with_range.
+template <typename Code>
+std::vector<Code> quantize_signal_to_codes(
+    const std::vector<double>& signal,
+    const double local_min_voltage,
+    const double local_max_voltage,
+    const int64_t minimum_code,
+    const int64_t maximum_code
+) {
+    std::vector<Code> codes(signal.size());
+
+    const bool found_nan = quantize_samples(
+        signal.data(),
+        codes.data(),
+        signal.size(),
+        local_min_voltage,
+        local_max_voltage,
+        minimum_code,
+        maximum_code
+    );
+
+    if (found_nan) {
+        throw std::runtime_error(
+            "Digitized integer output cannot represent NaN values."
+        );
+    }
+
+    return codes;
+}
+
+
+struct MinMax {
+    double minimum = std::numeric_limits<double>::infinity();
+    double maximum = -std::numeric_limits<double>::infinity();
+    size_t valid_sample_count = 0;
+};
+
+
+// NaN aware minimum and maximum as one parallel reduction over the samples.
+MinMax get_min_max_ignoring_nan(const std::span<const double> signal) {
+    const double* data = signal.data();
+    const size_t number_of_samples = signal.size();
+
+    double minimum = std::numeric_limits<double>::infinity();
+    double maximum = -std::numeric_limits<double>::infinity();
+    size_t valid_sample_count = 0;
+
+    // Comparisons with NaN are false, so NaN samples leave both bounds unchanged.
+    #pragma omp parallel for simd schedule(static) reduction(min:minimum) reduction(max:maximum) reduction(+:valid_sample_count) num_threads(utils::get_team_size(number_of_samples, utils::ParallelComponent::digitizer))
+    for (size_t index = 0; index < number_of_samples; ++index) {
+        const double sample = data[index];
+        minimum = (sample < minimum) ? sample : minimum;
+        maximum = (sample > maximum) ? sample : maximum;
+        valid_sample_count += std::isnan(sample) ? 0 : 1;
+    }
+
+    return {minimum, maximum, valid_sample_count};
+}
+
 }  // namespace
 
 
@@ -22,7 +139,8 @@ Digitizer::Digitizer(
     const bool use_auto_range,
     const bool output_signed_codes,
     const bool debug_mode,
-    const ChannelRangeMode channel_range_mode
+    const ChannelRangeMode channel_range_mode,
+    const bool compact_codes
 )
     : bandwidth(bandwidth),
       sampling_rate(sampling_rate),
@@ -33,6 +151,7 @@ Digitizer::Digitizer(
       output_signed_codes(output_signed_codes),
       debug_mode(debug_mode),
       channel_range_mode(channel_range_mode),
+      compact_codes(compact_codes),
       channel_voltage_ranges()
 {
     if (std::isnan(this->sampling_rate) || this->sampling_rate <= 0.0) {
@@ -151,7 +270,7 @@ void Digitizer::validate_voltage_range_for_digitization(
 
 
 void Digitizer::clip_signal_with_range(
-    std::vector<double>& signal,
+    const std::span<double> signal,
     const double local_min_voltage,
     const double local_max_voltage
 ) const {
@@ -159,23 +278,19 @@ void Digitizer::clip_signal_with_range(
         return;
     }
 
-    for (auto& sample : signal) {
-        if (std::isnan(sample)) {
-            continue;
-        }
+    double* data = signal.data();
+    const size_t number_of_samples = signal.size();
 
-        if (sample < local_min_voltage) {
-            sample = local_min_voltage;
-        }
-        else if (sample > local_max_voltage) {
-            sample = local_max_voltage;
-        }
+    // std::clamp returns NaN samples unchanged.
+    #pragma omp parallel for simd schedule(static) num_threads(utils::get_team_size(number_of_samples, utils::ParallelComponent::digitizer))
+    for (size_t index = 0; index < number_of_samples; ++index) {
+        data[index] = std::clamp(data[index], local_min_voltage, local_max_voltage);
     }
 }
 
 
 void Digitizer::digitize_signal_with_range(
-    std::vector<double>& signal,
+    const std::span<double> signal,
     const double local_min_voltage,
     const double local_max_voltage
 ) const {
@@ -185,38 +300,34 @@ void Digitizer::digitize_signal_with_range(
 
     this->validate_voltage_range_for_digitization(local_min_voltage, local_max_voltage);
 
-    const double voltage_span = local_max_voltage - local_min_voltage;
-    const int64_t minimum_code = this->get_minimum_code();
-    const int64_t maximum_code = this->get_maximum_code();
-    const double code_span = static_cast<double>(maximum_code - minimum_code);
-
-    for (auto& sample : signal) {
-        if (std::isnan(sample)) {
-            continue;
-        }
-
-        const double clipped_sample = std::clamp(sample, local_min_voltage, local_max_voltage);
-        const double normalized_value = (clipped_sample - local_min_voltage) / voltage_span;
-        const double floating_code = static_cast<double>(minimum_code) + normalized_value * code_span;
-
-        const int64_t quantized_code = std::clamp(
-            static_cast<int64_t>(std::llround(floating_code)),
-            minimum_code,
-            maximum_code
-        );
-
-        sample = static_cast<double>(quantized_code);
-    }
+    quantize_samples(
+        signal.data(),
+        signal.data(),
+        signal.size(),
+        local_min_voltage,
+        local_max_voltage,
+        this->get_minimum_code(),
+        this->get_maximum_code()
+    );
 }
 
 
 void Digitizer::process_signal_with_range(
-    std::vector<double>& signal,
+    const std::span<double> signal,
     const double local_min_voltage,
     const double local_max_voltage
 ) const {
+    FLOWCYPY_PROFILE_SCOPE("digitizer.process_signal");
+    FLOWCYPY_PROFILE_COUNT("digitizer.process_signal", "samples", signal.size());
+    FLOWCYPY_PROFILE_MAX("digitizer.process_signal", "threads", omp_get_max_threads());
+
+    // The quantization kernel clips as it goes, so digitized signals take a single pass.
+    if (this->should_digitize()) {
+        this->digitize_signal_with_range(signal, local_min_voltage, local_max_voltage);
+        return;
+    }
+
     this->clip_signal_with_range(signal, local_min_voltage, local_max_voltage);
-    this->digitize_signal_with_range(signal, local_min_voltage, local_max_voltage);
 }
 
 
@@ -225,28 +336,16 @@ void Digitizer::clip_signal(std::vector<double>& signal) const {
 }
 
 
-std::pair<double, double> Digitizer::get_min_max(const std::vector<double>& signal) const {
-    double minimum_value = std::numeric_limits<double>::infinity();
-    double maximum_value = -std::numeric_limits<double>::infinity();
-    bool found_valid_sample = false;
+std::pair<double, double> Digitizer::get_min_max(const std::span<const double> signal) const {
+    const MinMax min_max = get_min_max_ignoring_nan(signal);
 
-    for (const double sample : signal) {
-        if (std::isnan(sample)) {
-            continue;
-        }
-
-        found_valid_sample = true;
-        minimum_value = std::min(minimum_value, sample);
-        maximum_value = std::max(maximum_value, sample);
-    }
-
-    if (!found_valid_sample) {
+    if (min_max.valid_sample_count == 0) {
         throw std::runtime_error(
             "Cannot compute min and max from a signal containing only NaN values."
         );
     }
 
-    return {minimum_value, maximum_value};
+    return {min_max.minimum, min_max.maximum};
 }
 
 
@@ -308,7 +407,7 @@ void Digitizer::digitize_signal(std::vector<double>& signal) const {
 
 
 std::pair<double, double> Digitizer::resolve_fixed_or_auto_range_for_signal(
-    const std::vector<double>& signal
+    const std::span<const double> signal
 ) const {
     if (this->use_auto_range) {
         return this->get_min_max(signal);
@@ -352,31 +451,27 @@ void Digitizer::capture_signal(
 }
 
 
-std::pair<double, double> Digitizer::get_shared_min_max_from_data_map(
-    const std::map<std::string, std::vector<double>>& data_map
+std::pair<double, double> Digitizer::get_shared_min_max_from_channels(
+    const std::vector<ChannelView>& channels
 ) const {
     double global_minimum_value = std::numeric_limits<double>::infinity();
     double global_maximum_value = -std::numeric_limits<double>::infinity();
     bool found_valid_sample = false;
 
-    for (const auto& [channel_name, channel_signal] : data_map) {
-        if (is_metadata_channel(channel_name)) {
-            continue;
-        }
-
+    for (const auto& [channel_name, channel_signal] : channels) {
         if (this->channel_voltage_ranges.contains(channel_name)) {
             continue;
         }
 
-        for (const double sample : channel_signal) {
-            if (std::isnan(sample)) {
-                continue;
-            }
+        const MinMax channel_min_max = get_min_max_ignoring_nan(channel_signal);
 
-            found_valid_sample = true;
-            global_minimum_value = std::min(global_minimum_value, sample);
-            global_maximum_value = std::max(global_maximum_value, sample);
+        if (channel_min_max.valid_sample_count == 0) {
+            continue;
         }
+
+        found_valid_sample = true;
+        global_minimum_value = std::min(global_minimum_value, channel_min_max.minimum);
+        global_maximum_value = std::max(global_maximum_value, channel_min_max.maximum);
     }
 
     if (!found_valid_sample) {
@@ -395,7 +490,7 @@ std::pair<double, double> Digitizer::get_shared_min_max_from_data_map(
 
 std::pair<double, double> Digitizer::resolve_channel_voltage_range(
     const std::string& channel_name,
-    const std::vector<double>& channel_signal,
+    const std::span<const double> channel_signal,
     const std::pair<double, double>& shared_auto_range
 ) const {
     if (this->channel_voltage_ranges.contains(channel_name)) {
@@ -414,29 +509,23 @@ std::pair<double, double> Digitizer::resolve_channel_voltage_range(
 }
 
 
-void Digitizer::process_data_map(
-    std::map<std::string, std::vector<double>>& data_map
+std::vector<std::pair<std::string, std::pair<double, double>>> Digitizer::resolve_channel_voltage_ranges(
+    const std::vector<ChannelView>& channels
 ) const {
-    std::vector<std::string> channel_names;
-    channel_names.reserve(data_map.size());
-
-    for (const auto& [channel_name, channel_signal] : data_map) {
-        (void)channel_signal;
-
-        if (is_metadata_channel(channel_name)) {
-            continue;
-        }
-
-        channel_names.push_back(channel_name);
-    }
-
     std::pair<double, double> shared_auto_range = {
         std::numeric_limits<double>::quiet_NaN(),
         std::numeric_limits<double>::quiet_NaN()
     };
 
-    if (this->use_auto_range && this->channel_range_mode == ChannelRangeMode::shared) {
-        shared_auto_range = this->get_shared_min_max_from_data_map(data_map);
+    // Channels with an explicit range, e.g. fixed by fix_voltage_ranges, need no shared range.
+    const bool needs_shared_auto_range = std::any_of(
+        channels.begin(),
+        channels.end(),
+        [this](const ChannelView& channel) { return !this->channel_voltage_ranges.contains(channel.first); }
+    );
+
+    if (this->use_auto_range && this->channel_range_mode == ChannelRangeMode::shared && needs_shared_auto_range) {
+        shared_auto_range = this->get_shared_min_max_from_channels(channels);
 
         if (this->debug_mode) {
             std::printf(
@@ -447,10 +536,20 @@ void Digitizer::process_data_map(
         }
     }
 
+    std::vector<std::pair<std::string, std::pair<double, double>>> channel_ranges;
+    channel_ranges.reserve(channels.size());
+
+    for (const auto& [channel_name, channel_signal] : channels) {
+        channel_ranges.emplace_back(
+            channel_name,
+            this->resolve_channel_voltage_range(channel_name, channel_signal, shared_auto_range)
+        );
+    }
+
     if (this->debug_mode) {
         std::printf(
             "[Digitizer::process_data_map] channels=%zu | digitize=%d | use_auto_range=%d | has_voltage_range=%d | channel_range_mode=%d | explicit_channel_ranges=%zu\n",
-            channel_names.size(),
+            channel_ranges.size(),
             static_cast<int>(this->should_digitize()),
             static_cast<int>(this->use_auto_range),
             static_cast<int>(this->has_voltage_range()),
@@ -459,22 +558,85 @@ void Digitizer::process_data_map(
         );
     }
 
-    #pragma omp parallel for
-    for (ptrdiff_t index = 0; index < static_cast<ptrdiff_t>(channel_names.size()); ++index) {
-        const std::string& channel_name = channel_names[static_cast<size_t>(index)];
-        std::vector<double>& channel_signal = data_map.at(channel_name);
+    return channel_ranges;
+}
 
-        const auto [local_min_voltage, local_max_voltage] =
-            this->resolve_channel_voltage_range(
-                channel_name,
-                channel_signal,
-                shared_auto_range
-            );
+
+std::vector<std::pair<std::string, std::pair<double, double>>> Digitizer::resolve_data_map_voltage_ranges(
+    const std::map<std::string, std::vector<double>>& data_map
+) const {
+    std::vector<ChannelView> channels;
+    channels.reserve(data_map.size());
+
+    for (const auto& [channel_name, channel_signal] : data_map) {
+        if (!is_metadata_channel(channel_name)) {
+            channels.emplace_back(channel_name, channel_signal);
+        }
+    }
+
+    return this->resolve_channel_voltage_ranges(channels);
+}
+
+
+void Digitizer::fix_voltage_ranges(const std::map<std::string, std::span<const double>>& channels) {
+    if (!this->should_digitize()) {
+        return;
+    }
+
+    std::vector<ChannelView> channel_views;
+    channel_views.reserve(channels.size());
+
+    for (const auto& [channel_name, channel_signal] : channels) {
+        if (!is_metadata_channel(channel_name)) {
+            channel_views.emplace_back(channel_name, channel_signal);
+        }
+    }
+
+    for (const auto& [channel_name, channel_range] : this->resolve_channel_voltage_ranges(channel_views)) {
+        // Undefined or degenerate ranges are left to be resolved, or rejected, per call.
+        if (std::isnan(channel_range.first) || std::isnan(channel_range.second) || !(channel_range.second > channel_range.first)) {
+            continue;
+        }
+
+        this->set_channel_voltage_range(channel_name, channel_range.first, channel_range.second);
+    }
+}
+
+
+void Digitizer::process_acquisition_buffer(utils::AcquisitionBuffer& buffer) const {
+    std::vector<ChannelView> channels;
+    channels.reserve(buffer.get_number_of_channels());
+
+    for (const std::string& channel_name : buffer.get_channel_names()) {
+        if (!is_metadata_channel(channel_name)) {
+            channels.emplace_back(channel_name, std::as_const(buffer).channel(channel_name));
+        }
+    }
+
+    for (const auto& [channel_name, channel_range] : this->resolve_channel_voltage_ranges(channels)) {
+        this->process_signal_with_range(
+            buffer.channel(channel_name),
+            channel_range.first,
+            channel_range.second
+        );
+    }
+}
+
+
+void Digitizer::process_data_map(
+    std::map<std::string, std::vector<double>>& data_map
+) const {
+    const std::vector<std::pair<std::string, std::pair<double, double>>> channel_ranges =
+        this->resolve_data_map_voltage_ranges(data_map);
+
+    // Channels are processed one after the other: each kernel is parallel over samples.
+    for (size_t index = 0; index < channel_ranges.size(); ++index) {
+        const auto& [channel_name, channel_range] = channel_ranges[index];
 
         this->process_signal_with_range(
-            channel_signal,
-            local_min_voltage,
-            local_max_voltage
+            data_map.at(channel_name),
+            channel_range.first,
+            channel_range.second
         );
     }
 }
@@ -561,17 +723,36 @@ std::vector<uint64_t> Digitizer::convert_signal_to_unsigned_codes(
 std::map<std::string, std::vector<int64_t>> Digitizer::get_processed_signed_data_map(
     const std::map<std::string, std::vector<double>>& data_map
 ) const {
-    const std::map<std::string, std::vector<double>> processed_data_map =
-        this->get_processed_data_map(data_map);
-
     std::map<std::string, std::vector<int64_t>> output_map;
 
-    for (const auto& [channel_name, channel_signal] : processed_data_map) {
-        if (is_metadata_channel(channel_name)) {
-            continue;
+    if (!this->should_digitize()) {
+        const std::map<std::string, std::vector<double>> processed_data_map =
+            this->get_processed_data_map(data_map);
+
+        for (const auto& [channel_name, channel_signal] : processed_data_map) {
+            if (is_metadata_channel(channel_name)) {
+                continue;
+            }
+
+            output_map[channel_name] = this->convert_signal_to_signed_codes(channel_signal);
         }
 
-        output_map[channel_name] = this->convert_signal_to_signed_codes(channel_signal);
+        return output_map;
+    }
+
+    const int64_t minimum_code = this->get_minimum_code();
+    const int64_t maximum_code = this->get_maximum_code();
+
+    for (const auto& [channel_name, channel_range] : this->resolve_data_map_voltage_ranges(data_map)) {
+        this->validate_voltage_range_for_digitization(channel_range.first, channel_range.second);
+
+        output_map[channel_name] = quantize_signal_to_codes<int64_t>(
+            data_map.at(channel_name),
+            channel_range.first,
+            channel_range.second,
+            minimum_code,
+            maximum_code
+        );
     }
 
     return output_map;
@@ -581,50 +762,168 @@ std::map<std::string, std::vector<int64_t>> Digitizer::get_processed_signed_data
 std::map<std::string, std::vector<uint64_t>> Digitizer::get_processed_unsigned_data_map(
     const std::map<std::string, std::vector<double>>& data_map
 ) const {
-    const std::map<std::string, std::vector<double>> processed_data_map =
-        this->get_processed_data_map(data_map);
-
     std::map<std::string, std::vector<uint64_t>> output_map;
 
-    for (const auto& [channel_name, channel_signal] : processed_data_map) {
-        if (is_metadata_channel(channel_name)) {
-            continue;
+    if (!this->should_digitize()) {
+        const std::map<std::string, std::vector<double>> processed_data_map =
+            this->get_processed_data_map(data_map);
+
+        for (const auto& [channel_name, channel_signal] : processed_data_map) {
+            if (is_metadata_channel(channel_name)) {
+                continue;
+            }
+
+            output_map[channel_name] = this->convert_signal_to_unsigned_codes(channel_signal);
         }
 
-        output_map[channel_name] = this->convert_signal_to_unsigned_codes(channel_signal);
+        return output_map;
+    }
+
+    const int64_t minimum_code = this->get_minimum_code();
+    const int64_t maximum_code = this->get_maximum_code();
+
+    if (minimum_code < 0) {
+        throw std::runtime_error(
+            "Unsigned digitizer output encountered a negative code."
+        );
+    }
+
+    for (const auto& [channel_name, channel_range] : this->resolve_data_map_voltage_ranges(data_map)) {
+        this->validate_voltage_range_for_digitization(channel_range.first, channel_range.second);
+
+        output_map[channel_name] = quantize_signal_to_codes<uint64_t>(
+            data_map.at(channel_name),
+            channel_range.first,
+            channel_range.second,
+            minimum_code,
+            maximum_code
+        );
     }
 
     return output_map;
 }
 
 
-std::map<std::string, std::vector<double>> Digitizer::process_flat_acquisition_data(
+CodeType Digitizer::get_code_type() const {
+    if (!this->should_digitize()) {
+        throw std::runtime_error(
+            "Digitizer code type is undefined when bit_depth is 0."
+        );
+    }
+
+    if (this->output_signed_codes) {
+        if (this->bit_depth <= 8) return CodeType::int8;
+        if (this->bit_depth <= 16) return CodeType::int16;
+        if (this->bit_depth <= 32) return CodeType::int32;
+        return CodeType::int64;
+    }
+
+    if (this->bit_depth <= 8) return CodeType::uint8;
+    if (this->bit_depth <= 16) return CodeType::uint16;
+    if (this->bit_depth <= 32) return CodeType::uint32;
+    return CodeType::uint64;
+}
+
+
+std::pair<double, double> Digitizer::get_code_to_volt_scale_and_offset(
+    const double local_min_voltage,
+    const double local_max_voltage
+) const {
+    this->validate_voltage_range_for_digitization(local_min_voltage, local_max_voltage);
+
+    const int64_t minimum_code = this->get_minimum_code();
+    const double code_span = static_cast<double>(this->get_maximum_code() - minimum_code);
+    const double scale = (local_max_voltage - local_min_voltage) / code_span;
+
+    return {scale, local_min_voltage - static_cast<double>(minimum_code) * scale};
+}
+
+
+std::map<std::string, DigitizedChannel> Digitizer::get_processed_code_data_map(
     const std::map<std::string, std::vector<double>>& data_map
+) const {
+    FLOWCYPY_PROFILE_SCOPE("digitizer.get_processed_code_data_map");
+
+    const CodeType code_type = this->get_code_type();
+    const int64_t minimum_code = this->get_minimum_code();
+    const int64_t maximum_code = this->get_maximum_code();
+
+    std::map<std::string, DigitizedChannel> output_map;
+
+    for (const auto& [channel_name, channel_range] : this->resolve_data_map_voltage_ranges(data_map)) {
+        const auto [local_min_voltage, local_max_voltage] = channel_range;
+        const std::vector<double>& channel_signal = data_map.at(channel_name);
+        const auto [scale, offset] = this->get_code_to_volt_scale_and_offset(local_min_voltage, local_max_voltage);
+
+        CodeBuffer codes;
+
+        switch (code_type) {
+            case CodeType::int8:
+                codes = quantize_signal_to_codes<int8_t>(channel_signal, local_min_voltage, local_max_voltage, minimum_code, maximum_code);
+                break;
+            case CodeType::uint8:
+                codes = quantize_signal_to_codes<uint8_t>(channel_signal, local_min_voltage, local_max_voltage, minimum_code, maximum_code);
+                break;
+            case CodeType::int16:
+                codes = quantize_signal_to_codes<int16_t>(channel_signal, local_min_voltage, local_max_voltage, minimum_code, maximum_code);
+                break;
+            case CodeType::uint16:
+                codes = quantize_signal_to_codes<uint16_t>(channel_signal, local_min_voltage, local_max_voltage, minimum_code, maximum_code);
+                break;
+            case CodeType::int32:
+                codes = quantize_signal_to_codes<int32_t>(channel_signal, local_min_voltage, local_max_voltage, minimum_code, maximum_code);
+                break;
+            case CodeType::uint32:
+                codes = quantize_signal_to_codes<uint32_t>(channel_signal, local_min_voltage, local_max_voltage, minimum_code, maximum_code);
+                break;
+            case CodeType::int64:
+                codes = quantize_signal_to_codes<int64_t>(channel_signal, local_min_voltage, local_max_voltage, minimum_code, maximum_code);
+                break;
+            case CodeType::uint64:
+                codes = quantize_signal_to_codes<uint64_t>(channel_signal, local_min_voltage, local_max_voltage, minimum_code, maximum_code);
+                break;
+        }
+
+        FLOWCYPY_PROFILE_COUNT("digitizer.get_processed_code_data_map", "samples", channel_signal.size());
+        FLOWCYPY_PROFILE_COUNT(
+            "digitizer.get_processed_code_data_map",
+            "bytes",
+            std::visit([](const auto& buffer) { return buffer.size() * sizeof(buffer[0]); }, codes)
+        );
+
+        output_map.emplace(channel_name, DigitizedChannel{std::move(codes), scale, offset});
+    }
+
+    return output_map;
+}
+
+
+std::map<std::string, std::vector<double>> Digitizer::process_flat_acquisition_data(
+    std::map<std::string, std::vector<double>> data_map
 ) const {
     if (!data_map.contains("Time")) {
         throw std::runtime_error("Input dictionary must contain a 'Time' key.");
     }
 
-    return this->get_processed_data_map(data_map);
+    this->process_data_map(data_map);
+    return data_map;
 }
 
 
 std::map<std::string, std::map<std::string, std::vector<double>>> Digitizer::process_nested_acquisition_data(
-    const std::map<std::string, std::map<std::string, std::vector<double>>>& data_map
+    std::map<std::string, std::map<std::string, std::vector<double>>> data_map
 ) const {
-    std::map<std::string, std::map<std::string, std::vector<double>>> output_map;
-
-    for (const auto& [segment_id, segment_data_map] : data_map) {
+    for (auto& [segment_id, segment_data_map] : data_map) {
         if (!segment_data_map.contains("Time")) {
             throw std::runtime_error(
                 "Each triggered segment dictionary must contain a 'Time' key."
             );
         }
 
-        output_map[segment_id] = this->get_processed_data_map(segment_data_map);
+        this->process_data_map(segment_data_map);
     }
 
-    return output_map;
+    return data_map;
 }
 
 
@@ -677,19 +976,19 @@ std::pair<double, double> Digitizer::get_channel_voltage_range(
 }
 
 
-std::vector<double> Digitizer::get_time_series(const double run_time) const {
+utils::TimeAxis Digitizer::get_time_axis(const double run_time) const {
     if (run_time < 0.0) {
         throw std::invalid_argument("Digitizer run_time must be non negative.");
     }
 
     const size_t sample_count = static_cast<size_t>(this->sampling_rate * run_time);
-    std::vector<double> time_series(sample_count);
 
-    for (size_t index = 0; index < sample_count; ++index) {
-        time_series[index] = static_cast<double>(index) / this->sampling_rate;
-    }
+    return utils::TimeAxis::from_sampling_rate(this->sampling_rate, sample_count);
+}
+
 
-    return time_series;
+std::vector<double> Digitizer::get_time_series(const double run_time) const {
+    return this->get_time_axis(run_time).to_vector();
 }
 
 
@@ -716,6 +1015,7 @@ std::string Digitizer::repr() const {
         ", use_auto_range=" + std::string(this->use_auto_range ? "True" : "False") +
         ", output_signed_codes=" + std::string(this->output_signed_codes ? "True" : "False") +
         ", channel_range_mode='" + channel_range_mode_string + "'" +
+        ", compact_codes=" + std::string(this->compact_codes ? "True" : "False") +
         ", explicit_channel_range_count=" + std::to_string(this->channel_voltage_ranges.size()) +
         ")";
 }
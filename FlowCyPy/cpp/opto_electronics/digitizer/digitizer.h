@@ -10,6 +10,11 @@
 #include <cstdint>
 #include <utility>
 #include <map>
+#include <span>
+#include <variant>
+
+#include <utils/acquisition_buffer.h>
+#include <utils/time_axis.h>
 
 
 enum class ChannelRangeMode {
@@ -18,6 +23,48 @@ enum class ChannelRangeMode {
 };
 
 
+/**
+ * @brief Integer type holding the ADC codes of a channel.
+ */
+enum class CodeType {
+    int8,
+    uint8,
+    int16,
+    uint16,
+    int32,
+    uint32,
+    int64,
+    uint64
+};
+
+
+/**
+ * @brief ADC codes of one channel, stored in the narrowest integer type for the bit depth.
+ */
+using CodeBuffer = std::variant<
+    std::vector<int8_t>,
+    std::vector<uint8_t>,
+    std::vector<int16_t>,
+    std::vector<uint16_t>,
+    std::vector<int32_t>,
+    std::vector<uint32_t>,
+    std::vector<int64_t>,
+    std::vector<uint64_t>
+>;
+
+
+/**
+ * @brief Digitized channel: codes plus the affine map back to volt.
+ *
+ * voltage = code_to_volt_scale * code + code_to_volt_offset
+ */
+struct DigitizedChannel {
+    CodeBuffer codes;
+    double code_to_volt_scale;
+    double code_to_volt_offset;
+};
+
+
 class Digitizer {
 public:
     double bandwidth;
@@ -29,6 +76,7 @@ public:
     bool output_signed_codes;
     bool debug_mode;
     ChannelRangeMode channel_range_mode;
+    bool compact_codes;
     std::map<std::string, std::pair<double, double>> channel_voltage_ranges;
 
     Digitizer(
@@ -40,7 +88,8 @@ public:
         const bool use_auto_range = false,
         const bool output_signed_codes = false,
         const bool debug_mode = false,
-        const ChannelRangeMode channel_range_mode = ChannelRangeMode::shared
+        const ChannelRangeMode channel_range_mode = ChannelRangeMode::shared,
+        const bool compact_codes = false
     );
 
     bool has_bandwidth() const;
@@ -52,7 +101,7 @@ public:
     void clear_voltage_range();
 
     void clip_signal(std::vector<double>& signal) const;
-    std::pair<double, double> get_min_max(const std::vector<double>& signal) const;
+    std::pair<double, double> get_min_max(std::span<const double> signal) const;
     void set_auto_range(const std::vector<double>& signal);
 
     int64_t get_minimum_code() const;
@@ -74,6 +123,7 @@ public:
         const std::map<std::string, std::vector<double>>& data_map
     ) const;
 
+    utils::TimeAxis get_time_axis(const double run_time) const;
     std::vector<double> get_time_series(const double run_time) const;
 
     std::vector<int64_t> convert_signal_to_signed_codes(
@@ -92,14 +142,83 @@ public:
         const std::map<std::string, std::vector<double>>& data_map
     ) const;
 
-    std::map<std::string, std::vector<double>> process_flat_acquisition_data(
+    /**
+     * @brief Return the narrowest integer type able to hold every code of the bit depth.
+     *
+     * @throws std::runtime_error If bit_depth is 0.
+     */
+    CodeType get_code_type() const;
+
+    /**
+     * @brief Return the scale and offset mapping a code back to volt for a voltage range.
+     *
+     * @param local_min_voltage Voltage mapped to the minimum code.
+     * @param local_max_voltage Voltage mapped to the maximum code.
+     * @return Pair (scale, offset) such that voltage = scale * code + offset.
+     */
+    std::pair<double, double> get_code_to_volt_scale_and_offset(
+        const double local_min_voltage,
+        const double local_max_voltage
+    ) const;
+
+    /**
+     * @brief Digitize every detector channel straight into integer codes of get_code_type().
+     *
+     * Clipping and quantization are done in one pass per channel, without an
+     * intermediate floating point copy. The voltage ranges are resolved as in
+     * process_data_map.
+     *
+     * @param data_map Acquisition data; metadata channels are skipped.
+     * @return Digitized channels keyed by channel name.
+     *
+     * @throws std::runtime_error If bit_depth is 0 or if a channel contains NaN.
+     */
+    std::map<std::string, DigitizedChannel> get_processed_code_data_map(
         const std::map<std::string, std::vector<double>>& data_map
     ) const;
 
+    /**
+     * @brief Clip and digitize every detector channel of an acquisition buffer, in place.
+     *
+     * Voltage ranges are resolved as in process_data_map; the channels are
+     * processed through views of the buffer, without copy.
+     *
+     * @param buffer Acquisition buffer; metadata channels are left untouched.
+     */
+    void process_acquisition_buffer(utils::AcquisitionBuffer& buffer) const;
+
+    /**
+     * @brief Process a flat acquisition map.
+     *
+     * The map is taken by value and processed in place, so callers can move their
+     * data in instead of having it copied.
+     *
+     * @throws std::runtime_error If the map has no "Time" entry.
+     */
+    std::map<std::string, std::vector<double>> process_flat_acquisition_data(
+        std::map<std::string, std::vector<double>> data_map
+    ) const;
+
+    /**
+     * @brief Process every segment of a nested acquisition map, in place.
+     *
+     * @throws std::runtime_error If a segment has no "Time" entry.
+     */
     std::map<std::string, std::map<std::string, std::vector<double>>> process_nested_acquisition_data(
-        const std::map<std::string, std::map<std::string, std::vector<double>>>& data_map
+        std::map<std::string, std::map<std::string, std::vector<double>>> data_map
     ) const;
 
+    /**
+     * @brief Resolve the voltage range of every channel now and keep it for later calls.
+     *
+     * Auto ranges are computed from the given samples, as process_data_map would,
+     * and stored as explicit channel ranges, so that every later block of a stream
+     * is digitized with the same codes.
+     *
+     * @param channels Views of the detector channels; metadata channels are skipped.
+     */
+    void fix_voltage_ranges(const std::map<std::string, std::span<const double>>& channels);
+
     void set_channel_voltage_range(
         const std::string& channel_name,
         const double minimum_voltage,
@@ -130,34 +249,47 @@ private:
     ) const;
 
     void clip_signal_with_range(
-        std::vector<double>& signal,
+        std::span<double> signal,
         const double local_min_voltage,
         const double local_max_voltage
     ) const;
 
     void digitize_signal_with_range(
-        std::vector<double>& signal,
+        std::span<double> signal,
         const double local_min_voltage,
         const double local_max_voltage
     ) const;
 
     void process_signal_with_range(
-        std::vector<double>& signal,
+        std::span<double> signal,
         const double local_min_voltage,
         const double local_max_voltage
     ) const;
 
-    std::pair<double, double> get_shared_min_max_from_data_map(
-        const std::map<std::string, std::vector<double>>& data_map
+    /**
+     * @brief Named, non-owning view of one channel, as the range resolution sees it.
+     */
+    using ChannelView = std::pair<std::string, std::span<const double>>;
+
+    std::pair<double, double> get_shared_min_max_from_channels(
+        const std::vector<ChannelView>& channels
     ) const;
 
     std::pair<double, double> resolve_fixed_or_auto_range_for_signal(
-        const std::vector<double>& signal
+        std::span<const double> signal
     ) const;
 
     std::pair<double, double> resolve_channel_voltage_range(
         const std::string& channel_name,
-        const std::vector<double>& channel_signal,
+        std::span<const double> channel_signal,
         const std::pair<double, double>& shared_auto_range
     ) const;
+
+    std::vector<std::pair<std::string, std::pair<double, double>>> resolve_channel_voltage_ranges(
+        const std::vector<ChannelView>& channels
+    ) const;
+
+    std::vector<std::pair<std::string, std::pair<double, double>>> resolve_data_map_voltage_ranges(
+        const std::map<std::string, std::vector<double>>& data_map
+    ) const;
 };
@@ -8,10 +8,15 @@
 #include <map>
 #include <string>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "digitizer.h"
 #include <utils/casting.h>
+#include <utils/module_binding.h>
+#include <utils/numpy.h>
+#include <utils/profiler_binding.h>
+#include <utils/threading_binding.h>
 #include <pint/pint.h>
 
 namespace py = pybind11;
@@ -47,22 +52,70 @@ std::string channel_range_mode_to_string(const ChannelRangeMode value) {
 }
 
 
+std::string code_type_to_string(const CodeType value) {
+    switch (value) {
+        case CodeType::int8: return "int8";
+        case CodeType::uint8: return "uint8";
+        case CodeType::int16: return "int16";
+        case CodeType::uint16: return "uint16";
+        case CodeType::int32: return "int32";
+        case CodeType::uint32: return "uint32";
+        case CodeType::int64: return "int64";
+        case CodeType::uint64: return "uint64";
+    }
+
+    return "int64";
+}
+
+
+py::array code_buffer_to_numpy(CodeBuffer&& codes) {
+    return std::visit(
+        [](auto&& code_vector) -> py::array {
+            return vector_to_numpy_without_copy(std::move(code_vector));
+        },
+        std::move(codes)
+    );
+}
+
+
+py::dict build_python_output_dict_from_processed_code_map(
+    const py::dict& input_data_dict,
+    std::map<std::string, DigitizedChannel>& processed_code_map
+) {
+    py::dict output_dict;
+
+    if (input_data_dict.contains("Time")) {
+        output_dict[py::str("Time")] = input_data_dict[py::str("Time")];
+    }
+
+    if (input_data_dict.contains("segment_id")) {
+        output_dict[py::str("segment_id")] = input_data_dict[py::str("segment_id")];
+    }
+
+    for (auto& [channel_name, digitized_channel] : processed_code_map) {
+        output_dict[py::str(channel_name)] = code_buffer_to_numpy(std::move(digitized_channel.codes));
+    }
+
+    return output_dict;
+}
+
+
 
 
 py::dict build_python_output_dict_from_processed_double_map(
     const py::object& unit_registry,
     const py::dict& input_data_dict,
-    const std::map<std::string, std::vector<double>>& processed_data_map
+    std::map<std::string, std::vector<double>>&& processed_data_map
 ) {
     py::dict output_dict;
 
-    for (const auto& [channel_name, channel_signal] : processed_data_map) {
+    for (auto& [channel_name, channel_signal] : processed_data_map) {
         if (is_metadata_channel(channel_name)) {
             output_dict[py::str(channel_name)] = input_data_dict[py::str(channel_name)];
             continue;
         }
 
-        output_dict[py::str(channel_name)] = py::array_t<double>(channel_signal.size(), channel_signal.data()) * unit_registry.attr("volt");
+        output_dict[py::str(channel_name)] = vector_to_numpy_without_copy(std::move(channel_signal)) * unit_registry.attr("volt");
     }
 
     return output_dict;
@@ -71,7 +124,7 @@ py::dict build_python_output_dict_from_processed_double_map(
 
 py::dict build_python_output_dict_from_processed_signed_map(
     const py::dict& input_data_dict,
-    const std::map<std::string, std::vector<int64_t>>& processed_data_map
+    std::map<std::string, std::vector<int64_t>>&& processed_data_map
 ) {
     py::dict output_dict;
 
@@ -83,13 +136,13 @@ py::dict build_python_output_dict_from_processed_signed_map(
         output_dict[py::str("segment_id")] = input_data_dict[py::str("segment_id")];
     }
 
-    for (const auto& [channel_name, channel_signal] : processed_data_map) {
+    for (auto& [channel_name, channel_signal] : processed_data_map) {
         if (is_metadata_channel(channel_name)) {
             continue;
         }
 
         output_dict[py::str(channel_name)] =
-            py::array_t<int64_t>(channel_signal.size(), channel_signal.data());
+            vector_to_numpy_without_copy(std::move(channel_signal));
     }
 
     return output_dict;
@@ -98,7 +151,7 @@ py::dict build_python_output_dict_from_processed_signed_map(
 
 py::dict build_python_output_dict_from_processed_unsigned_map(
     const py::dict& input_data_dict,
-    const std::map<std::string, std::vector<uint64_t>>& processed_data_map
+    std::map<std::string, std::vector<uint64_t>>&& processed_data_map
 ) {
     py::dict output_dict;
 
@@ -110,13 +163,13 @@ py::dict build_python_output_dict_from_processed_unsigned_map(
         output_dict[py::str("segment_id")] = input_data_dict[py::str("segment_id")];
     }
 
-    for (const auto& [channel_name, channel_signal] : processed_data_map) {
+    for (auto& [channel_name, channel_signal] : processed_data_map) {
         if (is_metadata_channel(channel_name)) {
             continue;
         }
 
         output_dict[py::str(channel_name)] =
-            py::array_t<uint64_t>(channel_signal.size(), channel_signal.data());
+            vector_to_numpy_without_copy(std::move(channel_signal));
     }
 
     return output_dict;
@@ -126,7 +179,7 @@ py::dict build_python_output_dict_from_processed_unsigned_map(
 }  // namespace
 
 
-PYBIND11_MODULE(digitizer, module) {
+FLOWCYPY_MODULE(digitizer, module) {
     py::object unit_registry = get_shared_ureg();
 
     module.doc() = R"pbdoc(
@@ -142,6 +195,9 @@ PYBIND11_MODULE(digitizer, module) {
         Time axes are expected to be Pint quantities compatible with seconds.
     )pbdoc";
 
+    // AcquisitionBuffer and TimeAxis are registered by their own module.
+    py::module_::import("FlowCyPy.binary.acquisition_buffer");
+
     py::class_<Digitizer>(
         module,
         "Digitizer",
@@ -188,6 +244,9 @@ PYBIND11_MODULE(digitizer, module) {
                 If ``True``, print debug information during processing.
             channel_range_mode : {"shared", "per_channel"}, default="shared"
                 Automatic range scope used when ``use_auto_range`` is enabled.
+            compact_codes : bool, default=False
+                If ``True``, :meth:`digitize_data_dict` returns codes in the
+                narrowest integer dtype for ``bit_depth`` instead of 64 bit integers.
         )pbdoc"
     )
         .def(
@@ -200,7 +259,8 @@ PYBIND11_MODULE(digitizer, module) {
                 const bool use_auto_range,
                 const bool output_signed_codes,
                 const bool debug_mode,
-                const std::string& channel_range_mode
+                const std::string& channel_range_mode,
+                const bool compact_codes
             ) {
                 const double sampling_rate_value = Casting::cast_py_to_scalar<double>(
                     sampling_rate,
@@ -221,7 +281,8 @@ PYBIND11_MODULE(digitizer, module) {
                     use_auto_range,
                     output_signed_codes,
                     debug_mode,
-                    parse_channel_range_mode(channel_range_mode)
+                    parse_channel_range_mode(channel_range_mode),
+                    compact_codes
                 );
             }),
             py::arg("sampling_rate"),
@@ -233,6 +294,7 @@ PYBIND11_MODULE(digitizer, module) {
             py::arg("output_signed_codes") = false,
             py::arg("debug_mode") = false,
             py::arg("channel_range_mode") = "shared",
+            py::arg("compact_codes") = false,
             R"pbdoc(
                 Initialize a digitizer.
 
@@ -256,6 +318,8 @@ PYBIND11_MODULE(digitizer, module) {
                     If ``True``, print debug information during processing.
                 channel_range_mode : {"shared", "per_channel"}, default="shared"
                     Automatic range scope when ``use_auto_range`` is enabled.
+                compact_codes : bool, default=False
+                    If ``True``, return ADC codes in the narrowest integer dtype.
             )pbdoc"
         )
 
@@ -479,6 +543,29 @@ PYBIND11_MODULE(digitizer, module) {
                 Whether digitized outputs use signed integer like code values.
             )pbdoc"
         )
+        .def_readwrite(
+            "compact_codes",
+            &Digitizer::compact_codes,
+            R"pbdoc(
+                Whether :meth:`digitize_data_dict` returns codes in the narrowest
+                integer dtype for ``bit_depth``, e.g. ``int16`` for a 14 bit
+                signed digitizer, instead of 64 bit integers.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "code_dtype",
+            [](const Digitizer& self) {
+                return code_type_to_string(self.get_code_type());
+            },
+            R"pbdoc(
+                Name of the narrowest NumPy integer dtype holding every ADC code.
+
+                Raises
+                ------
+                RuntimeError
+                    If digitization is disabled.
+            )pbdoc"
+        )
         .def_property(
             "min_voltage",
             [unit_registry](const Digitizer& self) -> py::object {
@@ -725,7 +812,7 @@ PYBIND11_MODULE(digitizer, module) {
 
                 self.clip_signal(signal_vector);
 
-                return py::array_t<double>(signal_vector.size(), signal_vector.data()) * unit_registry.attr("volt");
+                return vector_to_numpy_without_copy(std::move(signal_vector)) * unit_registry.attr("volt");
             },
             py::arg("signal"),
             R"pbdoc(
@@ -753,23 +840,26 @@ PYBIND11_MODULE(digitizer, module) {
             [unit_registry](Digitizer& self, const py::object& signal) -> py::object {
                 std::vector<double> signal_vector = Casting::cast_py_to_vector<double>(signal, "signal", "volt");
 
-                self.process_signal(signal_vector);
+                {
+                    py::gil_scoped_release release;
+                    self.process_signal(signal_vector);
+                }
 
                 if (!self.should_digitize()) {
-                    return py::array_t<double>(signal_vector.size(), signal_vector.data()) * unit_registry.attr("volt");
+                    return vector_to_numpy_without_copy(std::move(signal_vector)) * unit_registry.attr("volt");
                 }
 
                 if (self.output_signed_codes) {
-                    const std::vector<int64_t> output_signal =
+                    std::vector<int64_t> output_signal =
                         self.convert_signal_to_signed_codes(signal_vector);
 
-                    return py::array_t<int64_t>(output_signal.size(), output_signal.data());
+                    return vector_to_numpy_without_copy(std::move(output_signal));
                 }
 
-                const std::vector<uint64_t> output_signal =
+                std::vector<uint64_t> output_signal =
                     self.convert_signal_to_unsigned_codes(signal_vector);
 
-                return py::array_t<uint64_t>(output_signal.size(), output_signal.data());
+                return vector_to_numpy_without_copy(std::move(output_signal));
             },
             py::arg("signal"),
             R"pbdoc(
@@ -838,23 +928,26 @@ PYBIND11_MODULE(digitizer, module) {
                 std::vector<double> signal_vector =
                     Casting::cast_py_to_vector<double>(signal, "signal", "volt");
 
-                self.digitize_signal(signal_vector);
+                {
+                    py::gil_scoped_release release;
+                    self.digitize_signal(signal_vector);
+                }
 
                 if (!self.should_digitize()) {
-                    return py::array_t<double>(signal_vector.size(), signal_vector.data());
+                    return vector_to_numpy_without_copy(std::move(signal_vector));
                 }
 
                 if (self.output_signed_codes) {
-                    const std::vector<int64_t> output_signal =
+                    std::vector<int64_t> output_signal =
                         self.convert_signal_to_signed_codes(signal_vector);
 
-                    return py::array_t<int64_t>(output_signal.size(), output_signal.data());
+                    return vector_to_numpy_without_copy(std::move(output_signal));
                 }
 
-                const std::vector<uint64_t> output_signal =
+                std::vector<uint64_t> output_signal =
                     self.convert_signal_to_unsigned_codes(signal_vector);
 
-                return py::array_t<uint64_t>(output_signal.size(), output_signal.data());
+                return vector_to_numpy_without_copy(std::move(output_signal));
             },
             py::arg("signal"),
             R"pbdoc(
@@ -880,32 +973,57 @@ PYBIND11_MODULE(digitizer, module) {
         .def(
             "digitize_data_dict",
             [unit_registry](const Digitizer& self, const py::dict& data_dict) -> py::object {
-                const std::map<std::string, std::vector<double>> input_data_map = Casting::cast_py_dict_to_flat_data_map(data_dict);
+                std::map<std::string, std::vector<double>> input_data_map = Casting::cast_py_dict_to_flat_data_map(data_dict);
 
                 if (!self.should_digitize()) {
-                    const std::map<std::string, std::vector<double>> processed_data_map = self.process_flat_acquisition_data(input_data_map);
+                    std::map<std::string, std::vector<double>> processed_data_map;
+                    {
+                        py::gil_scoped_release release;
+                        processed_data_map = self.process_flat_acquisition_data(std::move(input_data_map));
+                    }
 
                     return build_python_output_dict_from_processed_double_map(
                         unit_registry,
                         data_dict,
-                        processed_data_map
+                        std::move(processed_data_map)
+                    );
+                }
+
+                if (self.compact_codes) {
+                    std::map<std::string, DigitizedChannel> processed_code_map;
+                    {
+                        py::gil_scoped_release release;
+                        processed_code_map = self.get_processed_code_data_map(input_data_map);
+                    }
+
+                    return build_python_output_dict_from_processed_code_map(
+                        data_dict,
+                        processed_code_map
                     );
                 }
 
                 if (self.output_signed_codes) {
-                    const std::map<std::string, std::vector<int64_t>> processed_data_map = self.get_processed_signed_data_map(input_data_map);
+                    std::map<std::string, std::vector<int64_t>> processed_data_map;
+                    {
+                        py::gil_scoped_release release;
+                        processed_data_map = self.get_processed_signed_data_map(input_data_map);
+                    }
 
                     return build_python_output_dict_from_processed_signed_map(
                         data_dict,
-                        processed_data_map
+                        std::move(processed_data_map)
                     );
                 }
 
-                const std::map<std::string, std::vector<uint64_t>> processed_data_map = self.get_processed_unsigned_data_map(input_data_map);
+                std::map<std::string, std::vector<uint64_t>> processed_data_map;
+                {
+                    py::gil_scoped_release release;
+                    processed_data_map = self.get_processed_unsigned_data_map(input_data_map);
+                }
 
                 return build_python_output_dict_from_processed_unsigned_map(
                     data_dict,
-                    processed_data_map
+                    std::move(processed_data_map)
                 );
             },
             py::arg("data_dict"),
@@ -952,10 +1070,110 @@ PYBIND11_MODULE(digitizer, module) {
                     as integer ADC code arrays.
             )pbdoc"
         )
+        .def(
+            "digitize_data_dict_to_codes",
+            [unit_registry](const Digitizer& self, const py::dict& data_dict) -> py::tuple {
+                const std::map<std::string, std::vector<double>> input_data_map = Casting::cast_py_dict_to_flat_data_map(data_dict);
+
+                std::map<std::string, DigitizedChannel> processed_code_map;
+                {
+                    py::gil_scoped_release release;
+                    processed_code_map = self.get_processed_code_data_map(input_data_map);
+                }
+
+                py::dict code_to_volt_dict;
+
+                for (const auto& [channel_name, digitized_channel] : processed_code_map) {
+                    code_to_volt_dict[py::str(channel_name)] = py::make_tuple(
+                        py::float_(digitized_channel.code_to_volt_scale) * unit_registry.attr("volt"),
+                        py::float_(digitized_channel.code_to_volt_offset) * unit_registry.attr("volt")
+                    );
+                }
+
+                py::dict code_dict = build_python_output_dict_from_processed_code_map(
+                    data_dict,
+                    processed_code_map
+                );
+
+                return py::make_tuple(code_dict, code_to_volt_dict);
+            },
+            py::arg("data_dict"),
+            R"pbdoc(
+                Digitize acquisition data into compact integer codes.
+
+                Each detector channel is clipped and quantized in a single pass,
+                straight into the narrowest integer dtype for ``bit_depth``
+                (see :attr:`code_dtype`). The code arrays are handed to NumPy
+                without a copy. Ranges are resolved as in :meth:`digitize_data_dict`.
+
+                Parameters
+                ----------
+                data_dict : dict
+                    Acquisition data dictionary using Pint quantities.
+
+                Returns
+                -------
+                tuple of dict
+                    ``(codes, code_to_volt)``. ``codes`` holds the metadata fields
+                    and one integer code array per detector channel.
+                    ``code_to_volt`` maps each channel to ``(scale, offset)`` such
+                    that ``voltage = scale * code + offset``.
+
+                Raises
+                ------
+                RuntimeError
+                    If digitization is disabled or a channel contains NaN.
+            )pbdoc"
+        )
+        .def(
+            "process_acquisition_buffer",
+            &Digitizer::process_acquisition_buffer,
+            py::arg("buffer"),
+            R"pbdoc(
+                Clip and digitize the detector channels of an acquisition buffer in place.
+
+                Ranges are resolved as in :meth:`digitize_data_dict`. Metadata
+                channels such as ``Time`` and ``segment_id`` are left untouched.
+                The channels are rewritten through views of the buffer, so NumPy
+                arrays obtained from it see the processed values. Digitized
+                channels hold the ADC codes as floating point values.
+
+                Parameters
+                ----------
+                buffer : AcquisitionBuffer
+                    Acquisition buffer holding voltages in volt.
+            )pbdoc"
+        )
+        .def(
+            "get_time_axis",
+            [](const Digitizer& self, const py::object& run_time) {
+                return self.get_time_axis(
+                    Casting::cast_py_to_scalar<double>(
+                        run_time,
+                        "run_time",
+                        "second"
+                    )
+                );
+            },
+            py::arg("run_time"),
+            R"pbdoc(
+                Return the sampling time axis for a given acquisition duration, without materializing it.
+
+                Parameters
+                ----------
+                run_time : pint.Quantity
+                    Acquisition duration in seconds.
+
+                Returns
+                -------
+                TimeAxis
+                    Time axis starting at zero, spaced by the sampling period.
+            )pbdoc"
+        )
         .def(
             "get_time_series",
             [unit_registry](const Digitizer& self, const py::object& run_time) -> py::object {
-                const std::vector<double> time_series = self.get_time_series(
+                std::vector<double> time_series = self.get_time_series(
                     Casting::cast_py_to_scalar<double>(
                         run_time,
                         "run_time",
@@ -963,7 +1181,7 @@ PYBIND11_MODULE(digitizer, module) {
                     )
                 );
 
-                return py::array_t<double>(time_series.size(), time_series.data()) * unit_registry.attr("second");
+                return vector_to_numpy_without_copy(std::move(time_series)) * unit_registry.attr("second");
             },
             py::arg("run_time"),
             R"pbdoc(
@@ -986,4 +1204,7 @@ PYBIND11_MODULE(digitizer, module) {
                 return self.repr();
             }
         );
+
+    register_profiling_functions(module);
+    register_threading_functions(module);
 }
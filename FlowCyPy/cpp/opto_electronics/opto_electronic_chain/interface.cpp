@@ -0,0 +1,232 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "opto_electronic_chain.h"
+#include <pint/pint.h>
+#include <utils/module_binding.h>
+#include <utils/numpy.h>
+#include <utils/profiler_binding.h>
+#include <utils/threading_binding.h>
+#include <utils/random_binding.h>
+
+namespace py = pybind11;
+
+
+namespace {
+
+double quantity_to_magnitude_or_nan(const py::object& value, const char* units) {
+    if (value.is_none()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return value.attr("to")(units).attr("magnitude").cast<double>();
+}
+
+}  // namespace
+
+
+FLOWCYPY_MODULE(opto_electronic_chain, module) {
+    py::object ureg = get_shared_ureg();
+
+    // The source, detector and amplifier types are registered by their own modules.
+    py::module_::import("FlowCyPy.opto_electronics.source");
+    py::module_::import("FlowCyPy.opto_electronics.detector");
+    py::module_::import("FlowCyPy.opto_electronics.amplifier");
+
+    module.doc() = R"pbdoc(
+        Fused opto electronic chain for FlowCyPy.
+
+        This module converts optical power traces into amplifier output voltages
+        in a single pass, applying source RIN, shot noise, detector responsivity,
+        dark current noise, amplifier gain and amplifier noise sample by sample.
+
+        It produces the same noise model as the staged methods of
+        :class:`FlowCyPy.opto_electronics.OptoElectronics` while avoiding the
+        intermediate traces.
+    )pbdoc";
+
+    register_random_seed_functions(module);
+    register_profiling_functions(module);
+    register_threading_functions(module);
+
+    py::class_<OptoElectronicChain, std::shared_ptr<OptoElectronicChain>>(
+        module,
+        "OptoElectronicChain",
+        R"pbdoc(
+            Fused conversion of optical power traces into output voltages.
+
+            Parameters
+            ----------
+            source : BaseSource
+                Light source providing the RIN and shot noise parameters.
+            detectors : list[Detector]
+                Detectors, one per optical power trace.
+            amplifier : Amplifier
+                Transimpedance amplifier shared by all detectors.
+            bandwidth : pint.Quantity or None, optional
+                Detector noise bandwidth. If None, each detector uses its own bandwidth.
+            sampling_rate : pint.Quantity or None, optional
+                Sampling rate used by the amplifier low-pass filter. If None, the
+                filter is skipped.
+        )pbdoc"
+    )
+        .def(
+            py::init(
+                [](
+                    const std::shared_ptr<BaseSource>& source,
+                    const py::list& detectors,
+                    const Amplifier& amplifier,
+                    const py::object& bandwidth,
+                    const py::object& sampling_rate
+                ) {
+                    std::vector<Detector> detector_list;
+                    detector_list.reserve(detectors.size());
+
+                    for (const py::handle& detector : detectors) {
+                        detector_list.push_back(py::cast<const Detector&>(detector));
+                    }
+
+                    return std::make_shared<OptoElectronicChain>(
+                        source,
+                        std::move(detector_list),
+                        amplifier,
+                        quantity_to_magnitude_or_nan(bandwidth, "hertz"),
+                        quantity_to_magnitude_or_nan(sampling_rate, "hertz")
+                    );
+                }
+            ),
+            py::arg("source"),
+            py::arg("detectors"),
+            py::arg("amplifier"),
+            py::arg("bandwidth") = py::none(),
+            py::arg("sampling_rate") = py::none()
+        )
+        .def_property_readonly(
+            "source",
+            [](const OptoElectronicChain& self) {
+                return self.source;
+            },
+            R"pbdoc(
+                Light source of the chain.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "bandwidth",
+            [ureg](const OptoElectronicChain& self) -> py::object {
+                if (std::isnan(self.bandwidth)) {
+                    return py::none();
+                }
+
+                return py::float_(self.bandwidth) * ureg.attr("hertz");
+            },
+            R"pbdoc(
+                Detector noise bandwidth, or None to use each detector bandwidth.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "sampling_rate",
+            [ureg](const OptoElectronicChain& self) -> py::object {
+                if (std::isnan(self.sampling_rate)) {
+                    return py::none();
+                }
+
+                return py::float_(self.sampling_rate) * ureg.attr("hertz");
+            },
+            R"pbdoc(
+                Sampling rate of the amplifier filter, or None if filtering is skipped.
+            )pbdoc"
+        )
+        .def_readwrite(
+            "debug_mode",
+            &OptoElectronicChain::debug_mode,
+            R"pbdoc(
+                Whether diagnostic information is printed during processing.
+            )pbdoc"
+        )
+        .def(
+            "process",
+            [ureg](const OptoElectronicChain& self, const py::dict& signal_dict) {
+                if (!signal_dict.contains("Time")) {
+                    throw std::runtime_error("signal_dict must contain a 'Time' entry.");
+                }
+
+                const contiguous_array<double> time_array =
+                    quantity_to_contiguous_array<double>(signal_dict["Time"], "second");
+
+                const double time_step = self.source->get_time_step_from_time_array(array_to_span(time_array));
+
+                std::vector<std::string> detector_names;
+                std::vector<std::vector<double>> detector_signals;
+
+                detector_names.reserve(self.detectors.size());
+                detector_signals.reserve(self.detectors.size());
+
+                for (const Detector& detector : self.detectors) {
+                    if (!signal_dict.contains(detector.name)) {
+                        throw std::runtime_error(
+                            "signal_dict has no entry for detector '" + detector.name + "'."
+                        );
+                    }
+
+                    detector_names.push_back(detector.name);
+                    detector_signals.push_back(
+                        array_to_vector(quantity_to_contiguous_array<double>(signal_dict[py::str(detector.name)], "watt"))
+                    );
+                }
+
+                {
+                    py::gil_scoped_release release;
+                    self.process_in_place(detector_signals, time_step);
+                }
+
+                py::dict output_signal_dict;
+                output_signal_dict["Time"] = signal_dict["Time"];
+
+                for (size_t channel_index = 0; channel_index < detector_names.size(); ++channel_index) {
+                    output_signal_dict[py::str(detector_names[channel_index])] =
+                        vector_to_numpy_without_copy(std::move(detector_signals[channel_index])) * ureg.attr("volt");
+                }
+
+                return output_signal_dict;
+            },
+            py::arg("signal_dict"),
+            R"pbdoc(
+                Convert optical power traces into output voltages.
+
+                Parameters
+                ----------
+                signal_dict : dict
+                    Signal dictionary with a ``"Time"`` entry and one optical power
+                    trace per detector, keyed by detector name.
+
+                Returns
+                -------
+                dict
+                    Dictionary with the same ``"Time"`` entry and one voltage trace
+                    per detector.
+
+                Raises
+                ------
+                RuntimeError
+                    If a detector trace is missing, if traces differ in length, or if
+                    an optical power sample is negative where RIN or shot noise is
+                    applied.
+            )pbdoc"
+        )
+        .def(
+            "__repr__",
+            [](const OptoElectronicChain& self) {
+                return
+                    "OptoElectronicChain(detectors=" + std::to_string(self.detectors.size()) +
+                    ", filter=" + std::string(self.applies_amplifier_filter() ? "True" : "False") + ")";
+            }
+        );
+}
@@ -0,0 +1,418 @@
+#include "opto_electronic_chain.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <cstdio>
+
+#include <utils/offload.h>
+#include <utils/random.h>
+#include <utils/shot_noise.h>
+#include <utils/threading.h>
+#include <utils/utils.h>
+
+
+namespace {
+
+struct ChannelParameters {
+    double responsivity;
+    double dark_current;
+    double current_noise_standard_deviation;
+    bool has_current_noise;
+};
+
+// Constants and generators of the fused pass, trivially copyable so that they map to a device.
+struct SampleStageParameters {
+    bool apply_rin;
+    double rin_sigma;
+    bool apply_shot_noise;
+    double watt_to_photon;
+    double amplifier_gain;
+    bool add_amplifier_noise;
+    double amplifier_sigma;
+    utils::CounterRandomGenerator rin_generator;
+    utils::CounterRandomGenerator shot_noise_generator;
+    utils::CounterRandomGenerator detector_generator;
+    utils::CounterRandomGenerator amplifier_generator;
+};
+
+FLOWCYPY_DECLARE_TARGET_BEGIN
+
+// One sample of the fused pass: optical power in, output of the per sample stages out.
+// common_index draws the RIN shared by every channel, channel_index the other noises.
+inline double apply_sample_stages(
+    const SampleStageParameters& stages,
+    const ChannelParameters& channel,
+    double power,
+    const uint64_t common_index,
+    const uint64_t channel_index,
+    bool& found_negative_power
+) {
+    // Common RIN: the fluctuation of sample t is shared by every channel.
+    if (stages.apply_rin) {
+        power *= 1.0 + stages.rin_sigma * stages.rin_generator.normal(common_index);
+    }
+
+    if (stages.apply_shot_noise) {
+        if (power < 0.0) {
+            found_negative_power = true;
+            power = 0.0;
+        }
+
+        const double mean_photons = power * stages.watt_to_photon;
+        double noisy_photons = 0.0;
+
+        if (mean_photons < utils::shot_noise_poisson_threshold) {
+            noisy_photons = stages.shot_noise_generator.poisson(mean_photons, channel_index);
+        } else {
+            noisy_photons = std::max(
+                0.0,
+                mean_photons + stages.shot_noise_generator.normal(channel_index) * std::sqrt(mean_photons)
+            );
+        }
+
+        power = noisy_photons / stages.watt_to_photon;
+    }
+
+    double current = power * channel.responsivity;
+
+    if (channel.has_current_noise) {
+        current += channel.dark_current +
+            channel.current_noise_standard_deviation * stages.detector_generator.normal(channel_index);
+    }
+
+    double output = current * stages.amplifier_gain;
+
+    if (stages.add_amplifier_noise) {
+        output += stages.amplifier_sigma * stages.amplifier_generator.normal(channel_index);
+    }
+
+    return output;
+}
+
+FLOWCYPY_DECLARE_TARGET_END
+
+}  // namespace
+
+
+OptoElectronicChain::OptoElectronicChain(
+    std::shared_ptr<BaseSource> source,
+    std::vector<Detector> detectors,
+    Amplifier amplifier,
+    const double bandwidth,
+    const double sampling_rate
+)
+    : source(std::move(source)),
+      detectors(std::move(detectors)),
+      amplifier(std::move(amplifier)),
+      bandwidth(bandwidth),
+      sampling_rate(sampling_rate)
+{
+    if (!this->source) {
+        throw std::runtime_error("source must not be null.");
+    }
+}
+
+
+bool OptoElectronicChain::applies_amplifier_filter() const {
+    return !std::isnan(this->amplifier.bandwidth) && !std::isnan(this->sampling_rate);
+}
+
+
+void OptoElectronicChain::process_in_place(
+    std::vector<std::vector<double>>& signals,
+    const double time_step
+) const {
+    if (signals.size() != this->detectors.size()) {
+        throw std::runtime_error("The number of signals must match the number of detectors.");
+    }
+
+    if (signals.empty()) {
+        return;
+    }
+
+    const size_t number_of_samples = signals.front().size();
+
+    for (const std::vector<double>& signal : signals) {
+        if (signal.size() != number_of_samples) {
+            throw std::runtime_error("All detector channels must have the same number of samples.");
+        }
+    }
+
+    if (number_of_samples == 0) {
+        throw std::runtime_error("signal vector is empty.");
+    }
+
+    const OptoElectronicNoiseStreams streams = this->draw_noise_streams();
+
+    const std::vector<std::span<double>> signal_views(signals.begin(), signals.end());
+
+    if (this->debug_mode) {
+        std::printf(
+            "[OptoElectronicChain] channels=%zu | samples=%zu | filter=%d | threads=%d\n",
+            signals.size(),
+            number_of_samples,
+            this->applies_amplifier_filter(),
+            omp_get_max_threads()
+        );
+    }
+
+    this->apply_per_sample_stages(signal_views, time_step, streams, 0, number_of_samples);
+
+    if (!this->applies_amplifier_filter()) {
+        return;
+    }
+
+    // ---------------- amplifier bandwidth ----------------
+    const bool apply_amplifier_noise = this->has_amplifier_noise();
+    const double amplifier_sigma = apply_amplifier_noise ? this->amplifier.get_rms_noise() : 0.0;
+
+    for (size_t channel_index = 0; channel_index < signals.size(); ++channel_index) {
+        std::vector<double>& signal = signals[channel_index];
+
+        utils::apply_bessel_lowpass_filter_to_signal(
+            signal,
+            this->sampling_rate,
+            this->amplifier.bandwidth,
+            this->amplifier.filter_order,
+            this->amplifier.gain
+        );
+
+        if (apply_amplifier_noise) {
+            streams.amplifier.add_normal(
+                signal.data(),
+                signal.size(),
+                0.0,
+                amplifier_sigma,
+                static_cast<uint64_t>(channel_index) * number_of_samples
+            );
+        }
+    }
+}
+
+
+OptoElectronicNoiseStreams OptoElectronicChain::draw_noise_streams() const {
+    utils::RandomService& random_service = utils::RandomService::instance();
+
+    OptoElectronicNoiseStreams streams;
+    streams.rin = random_service.next_generator(utils::RandomStreamId::source_common_rin);
+    streams.shot_noise = random_service.next_generator(utils::RandomStreamId::source_shot_noise);
+    streams.detector = random_service.next_generator(utils::RandomStreamId::detector_dark_current);
+    streams.amplifier = random_service.next_generator(utils::RandomStreamId::amplifier_noise);
+
+    return streams;
+}
+
+
+std::vector<utils::BiquadCascade> OptoElectronicChain::design_amplifier_filters() const {
+    if (!this->applies_amplifier_filter()) {
+        return {};
+    }
+
+    return std::vector<utils::BiquadCascade>(
+        this->detectors.size(),
+        utils::design_bessel_lowpass_sos(
+            this->sampling_rate,
+            this->amplifier.bandwidth,
+            this->amplifier.filter_order,
+            this->amplifier.gain
+        )
+    );
+}
+
+
+template <typename Real>
+void OptoElectronicChain::process_block_in_place(
+    const std::vector<std::span<Real>>& signals,
+    const double time_step,
+    const OptoElectronicNoiseStreams& streams,
+    const uint64_t first_sample_index,
+    std::vector<utils::BiquadCascade>& amplifier_filters
+) const {
+    if (signals.size() != this->detectors.size()) {
+        throw std::runtime_error("The number of signals must match the number of detectors.");
+    }
+
+    if (signals.empty() || signals.front().empty()) {
+        return;
+    }
+
+    for (const std::span<Real>& signal : signals) {
+        if (signal.size() != signals.front().size()) {
+            throw std::runtime_error("All detector channels must have the same number of samples.");
+        }
+    }
+
+    this->apply_per_sample_stages(signals, time_step, streams, first_sample_index, block_channel_stride);
+
+    if (!this->applies_amplifier_filter()) {
+        return;
+    }
+
+    if (amplifier_filters.size() != signals.size()) {
+        throw std::runtime_error("One amplifier filter is required per detector channel.");
+    }
+
+    const bool apply_amplifier_noise = this->has_amplifier_noise();
+    const double amplifier_sigma = apply_amplifier_noise ? this->amplifier.get_rms_noise() : 0.0;
+
+    for (size_t channel_index = 0; channel_index < signals.size(); ++channel_index) {
+        const std::span<Real> signal = signals[channel_index];
+
+        amplifier_filters[channel_index].process_in_place(signal.data(), signal.size());
+
+        if (apply_amplifier_noise) {
+            streams.amplifier.add_normal(
+                signal.data(),
+                signal.size(),
+                0.0,
+                amplifier_sigma,
+                static_cast<uint64_t>(channel_index) * block_channel_stride + first_sample_index
+            );
+        }
+    }
+}
+
+template void OptoElectronicChain::process_block_in_place<double>(
+    const std::vector<std::span<double>>&, const double, const OptoElectronicNoiseStreams&,
+    const uint64_t, std::vector<utils::BiquadCascade>&
+) const;
+
+template void OptoElectronicChain::process_block_in_place<float>(
+    const std::vector<std::span<float>>&, const double, const OptoElectronicNoiseStreams&,
+    const uint64_t, std::vector<utils::BiquadCascade>&
+) const;
+
+
+bool OptoElectronicChain::has_amplifier_noise() const {
+    return
+        !std::isnan(this->amplifier.bandwidth) &&
+        (this->amplifier.voltage_noise_density > 0.0 || this->amplifier.current_noise_density > 0.0);
+}
+
+
+template <typename Real>
+void OptoElectronicChain::apply_per_sample_stages(
+    const std::vector<std::span<Real>>& signals,
+    const double time_step,
+    const OptoElectronicNoiseStreams& streams,
+    const uint64_t first_sample_index,
+    const uint64_t channel_stride
+) const {
+    const size_t number_of_samples = signals.front().size();
+
+    if (this->use_device && !utils::offload::is_device_available()) {
+        throw std::runtime_error(
+            "use_device requires a build with FLOWCYPY_OPENMP_OFFLOAD and an available OpenMP target device."
+        );
+    }
+
+    // ---------------- per run constants ----------------
+    const bool apply_rin =
+        this->source->include_rin_noise &&
+        !std::isnan(this->source->rin) &&
+        !std::isnan(this->source->bandwidth);
+
+    if (apply_rin && this->source->bandwidth <= 0.0) {
+        throw std::runtime_error("bandwidth must be strictly positive.");
+    }
+
+    const double rin_sigma = apply_rin
+        ? std::sqrt(this->source->get_rin_linear() * this->source->bandwidth)
+        : 0.0;
+
+    const bool apply_shot_noise = this->source->include_shot_noise;
+
+    if (apply_shot_noise && !(time_step > 0.0)) {
+        throw std::runtime_error("time_step must be strictly positive.");
+    }
+
+    const double watt_to_photon = apply_shot_noise
+        ? this->source->get_watt_to_photon_factor(time_step)
+        : 1.0;
+
+    std::vector<ChannelParameters> channels;
+    channels.reserve(this->detectors.size());
+
+    for (const Detector& detector : this->detectors) {
+        const double standard_deviation = detector.get_current_noise_standard_deviation(this->bandwidth);
+
+        channels.push_back({
+            detector.responsivity,
+            detector.dark_current,
+            std::isnan(standard_deviation) ? 0.0 : standard_deviation,
+            !std::isnan(standard_deviation)
+        });
+    }
+
+    const bool filter_output = this->applies_amplifier_filter();
+    const double amplifier_gain = filter_output ? 1.0 : this->amplifier.gain;
+
+    const bool apply_amplifier_noise = this->has_amplifier_noise();
+    const double amplifier_sigma = apply_amplifier_noise ? this->amplifier.get_rms_noise() : 0.0;
+
+    if (filter_output && this->amplifier.bandwidth >= 0.5 * this->sampling_rate) {
+        throw std::runtime_error("Amplifier bandwidth is too high for the digitizer sampling rate.");
+    }
+
+    // RIN requires nonnegative input power: checked up front so nothing throws inside
+    // the parallel region.
+    if (apply_rin) {
+        for (const std::span<Real>& signal : signals) {
+            if (utils::find_first_negative(signal.data(), number_of_samples) != number_of_samples) {
+                throw std::runtime_error("RIN cannot be applied to negative optical power values.");
+            }
+        }
+    }
+
+    const SampleStageParameters stages{
+        apply_rin,
+        rin_sigma,
+        apply_shot_noise,
+        watt_to_photon,
+        amplifier_gain,
+        !filter_output && apply_amplifier_noise,
+        amplifier_sigma,
+        streams.rin,
+        streams.shot_noise,
+        streams.detector,
+        streams.amplifier
+    };
+
+    // ---------------- fused per sample pass ----------------
+    bool found_negative_power = false;
+
+    for (size_t channel_index = 0; channel_index < signals.size(); ++channel_index) {
+        Real* data = signals[channel_index].data();
+        const ChannelParameters channel = channels[channel_index];
+        const uint64_t channel_offset = static_cast<uint64_t>(channel_index) * channel_stride + first_sample_index;
+
+#if FLOWCYPY_OPENMP_OFFLOAD
+        // The channel is copied to the device and back; the analog filters that follow run on the host.
+        if (this->use_device) {
+            #pragma omp target teams distribute parallel for map(tofrom: data[0:number_of_samples]) reduction(||:found_negative_power)
+            for (size_t t = 0; t < number_of_samples; ++t) {
+                data[t] = static_cast<Real>(
+                    apply_sample_stages(stages, channel, data[t], first_sample_index + t, channel_offset + t, found_negative_power)
+                );
+            }
+
+            continue;
+        }
+#endif
+
+        #pragma omp parallel for schedule(static) reduction(||:found_negative_power) num_threads(utils::get_team_size(number_of_samples, utils::ParallelComponent::opto_electronic_chain))
+        for (size_t t = 0; t < number_of_samples; ++t) {
+            data[t] = static_cast<Real>(
+                apply_sample_stages(stages, channel, data[t], first_sample_index + t, channel_offset + t, found_negative_power)
+            );
+        }
+    }
+
+    if (found_negative_power) {
+        throw std::runtime_error(
+            "Shot noise received a negative optical power sample, which is nonphysical. "
+            "Shot noise can only be applied to nonnegative optical power. "
+            "This usually indicates that the source RIN noise produces invalid power values."
+        );
+    }
+}
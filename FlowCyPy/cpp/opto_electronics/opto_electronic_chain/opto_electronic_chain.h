@@ -0,0 +1,168 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <limits>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <cstdint>
+
+#include <opto_electronics/source/source.h>
+#include <opto_electronics/detector/detector.h>
+#include <opto_electronics/amplifier/amplifier.h>
+#include <utils/iir_filter.h>
+#include <utils/random.h>
+
+
+/**
+ * @brief Random streams of one acquisition, drawn once and shared by all its blocks.
+ */
+struct OptoElectronicNoiseStreams {
+    utils::CounterRandomGenerator rin;
+    utils::CounterRandomGenerator shot_noise;
+    utils::CounterRandomGenerator detector;
+    utils::CounterRandomGenerator amplifier;
+};
+
+
+/**
+ * @brief Fused conversion of optical power traces into amplifier output voltages.
+ *
+ * The staged path of OptoElectronics walks every trace five times and allocates
+ * a new vector at each step: source RIN, shot noise, detector responsivity, dark
+ * current noise, then amplifier gain and noise. This class applies the same
+ * per-sample model in a single parallel pass, in place:
+ *
+ *     P   = P * (1 + sigma_rin * n_rin[t])                 common RIN
+ *     P   = Poisson(P * k) / k,  k = dt / photon_energy     shot noise
+ *     I   = P * responsivity + dark_current + sigma_I * n_I dark current noise
+ *     V   = gain * I + sigma_V * n_V                        amplifier
+ *
+ * When the amplifier bandwidth and the sampling rate are both defined, the
+ * amplifier low-pass filter is not a per-sample operation: the fused pass stops
+ * at the photocurrent, then the Bessel filter and the amplifier noise are applied
+ * in place on each trace.
+ *
+ * Noise comes from utils::RandomService, so a seeded run is reproducible for any
+ * number of threads.
+ */
+class OptoElectronicChain {
+public:
+    std::shared_ptr<BaseSource> source;
+    std::vector<Detector> detectors;
+    Amplifier amplifier;
+    double bandwidth;       // [hertz] detector noise bandwidth, NaN to use each detector bandwidth
+    double sampling_rate;   // [hertz] amplifier filter sampling rate, NaN to skip filtering
+    bool debug_mode = false;
+    bool use_device = false;    // run the fused per sample pass on the OpenMP offload device
+
+    /**
+     * @brief Construct an opto electronic chain.
+     *
+     * @param source Light source providing the RIN and shot noise parameters.
+     * @param detectors Detectors, one per optical power trace.
+     * @param amplifier Transimpedance amplifier shared by all detectors.
+     * @param bandwidth Detector noise bandwidth in hertz, NaN to use each detector bandwidth.
+     * @param sampling_rate Sampling rate in hertz used by the amplifier filter, NaN to skip it.
+     *
+     * @throws std::runtime_error If source is null.
+     */
+    OptoElectronicChain(
+        std::shared_ptr<BaseSource> source,
+        std::vector<Detector> detectors,
+        Amplifier amplifier,
+        const double bandwidth = std::numeric_limits<double>::quiet_NaN(),
+        const double sampling_rate = std::numeric_limits<double>::quiet_NaN()
+    );
+
+    /**
+     * @brief Convert optical power traces into output voltages, in place.
+     *
+     * @param signals One optical power trace per detector, in watt, overwritten with volt.
+     * @param time_step Sampling interval in second, required by the shot noise model.
+     *
+     * @throws std::runtime_error If the number of traces does not match the number of
+     * detectors, if the traces differ in length, or if an optical power sample is
+     * negative where RIN or shot noise cannot be applied.
+     */
+    void process_in_place(
+        std::vector<std::vector<double>>& signals,
+        const double time_step
+    ) const;
+
+    /**
+     * @brief Whether the amplifier low-pass filter is applied.
+     */
+    bool applies_amplifier_filter() const;
+
+    /**
+     * @brief Draw the random streams of a new acquisition from utils::RandomService.
+     */
+    OptoElectronicNoiseStreams draw_noise_streams() const;
+
+    /**
+     * @brief Causal amplifier filters of a block stream, one per detector.
+     *
+     * The batch path filters each whole trace with the zero phase FFT Bessel
+     * filter, which a stream cannot do; blocks are filtered instead with the
+     * causal Bessel cascade of the same order and cutoff, including the gain.
+     *
+     * @return One cascade per detector, or an empty vector if the filter is not applied.
+     */
+    std::vector<utils::BiquadCascade> design_amplifier_filters() const;
+
+    /**
+     * @brief Convert one block of a longer acquisition into output voltages, in place.
+     *
+     * Sample i of the block draws its noise at stream index first_sample_index + i,
+     * so feeding an acquisition block by block gives the same noise for any block
+     * size. The filters carry their state from one block to the next.
+     *
+     * @param signals One optical power block per detector, in watt, overwritten with volt.
+     * @param time_step Sampling interval in second.
+     * @param streams Random streams of the acquisition, from draw_noise_streams.
+     * @param first_sample_index Index of the first block sample in the acquisition.
+     * @param amplifier_filters Filter states from design_amplifier_filters.
+     *
+     * @tparam Real Sample type of the blocks, double or float. Every stage computes
+     *     in double precision; samples are rounded to Real when stored.
+     *
+     * @throws std::runtime_error As process_in_place.
+     */
+    template <typename Real>
+    void process_block_in_place(
+        const std::vector<std::span<Real>>& signals,
+        const double time_step,
+        const OptoElectronicNoiseStreams& streams,
+        const uint64_t first_sample_index,
+        std::vector<utils::BiquadCascade>& amplifier_filters
+    ) const;
+
+    /// Stride between the noise indices of two channels of a block stream.
+    static constexpr uint64_t block_channel_stride = uint64_t{1} << 40;
+
+private:
+    bool has_amplifier_noise() const;
+
+    /**
+     * @brief Apply every per sample stage of the chain, in place.
+     *
+     * Sample t of channel c draws its common RIN at first_sample_index + t and its
+     * other noises at c * channel_stride + first_sample_index + t.
+     *
+     * With use_device the pass runs on the OpenMP offload device, one channel at a
+     * time. Draws use the same Philox indices, so the noise matches the host run up
+     * to the rounding of the device math library.
+     *
+     * @throws std::runtime_error If use_device is set and no offload device is available.
+     */
+    template <typename Real>
+    void apply_per_sample_stages(
+        const std::vector<std::span<Real>>& signals,
+        const double time_step,
+        const OptoElectronicNoiseStreams& streams,
+        const uint64_t first_sample_index,
+        const uint64_t channel_stride
+    ) const;
+};
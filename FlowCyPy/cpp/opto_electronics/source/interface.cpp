@@ -4,14 +4,22 @@
 
 #include <opto_electronics/source/source.h>
 #include <pint/pint.h>
+#include <utils/fft_plan_cache_binding.h>
+#include <utils/module_binding.h>
+#include <utils/numpy.h>
+#include <utils/profiler_binding.h>
+#include <utils/threading_binding.h>
+#include <utils/random_binding.h>
 #include <cmath>
 #include <limits>
+#include <span>
+#include <utility>
 
 
 namespace py = pybind11;
 
 
-PYBIND11_MODULE(source, module) {
+FLOWCYPY_MODULE(source, module) {
     py::object ureg = get_shared_ureg();
 
     module.doc() = R"doc(
@@ -31,6 +39,11 @@ PYBIND11_MODULE(source, module) {
         All physical inputs and outputs are Pint aware on the Python side.
     )doc";
 
+    register_random_seed_functions(module);
+    register_profiling_functions(module);
+    register_threading_functions(module);
+    register_fft_plan_cache_functions(module);
+
     py::class_<BaseSource, std::shared_ptr<BaseSource>>(
         module,
         "BaseSource",
@@ -214,22 +227,18 @@ PYBIND11_MODULE(source, module) {
             "add_shot_noise_to_signal",
             [ureg](const BaseSource& source, const py::object& signal, const py::object& time_array) {
                 const double time_step = source.get_time_step_from_time_array(
-                    time_array.attr("to")("second").attr("magnitude").cast<std::vector<double>>()
+                    array_to_span(quantity_to_contiguous_array<double>(time_array, "second"))
                 );
 
                 std::vector<double> signal_values =
-                    signal.attr("to")("watt").attr("magnitude").cast<std::vector<double>>();
-
-                source.add_shot_noise_to_signal(signal_values, time_step);
-
-                py::array_t<double> output(signal_values.size());
-                auto mutable_view = output.mutable_unchecked<1>();
+                    array_to_vector(quantity_to_contiguous_array<double>(signal, "watt"));
 
-                for (ssize_t index = 0; index < static_cast<ssize_t>(signal_values.size()); ++index) {
-                    mutable_view(index) = signal_values[static_cast<size_t>(index)];
+                {
+                    py::gil_scoped_release release;
+                    source.add_shot_noise_to_signal(signal_values, time_step);
                 }
 
-                return output * ureg.attr("watt");
+                return vector_to_numpy_without_copy(std::move(signal_values)) * ureg.attr("watt");
             },
             py::arg("signal"),
             py::arg("time"),
@@ -258,17 +267,14 @@ PYBIND11_MODULE(source, module) {
             "add_rin_to_signal",
             [ureg](const BaseSource& source, const py::object& signal) {
                 std::vector<double> signal_values =
-                    signal.attr("to")("watt").attr("magnitude").cast<std::vector<double>>();
-
-                source.add_rin_to_signal(signal_values);
-                py::array_t<double> output(signal_values.size());
-                auto mutable_view = output.mutable_unchecked<1>();
+                    array_to_vector(quantity_to_contiguous_array<double>(signal, "watt"));
 
-                for (ssize_t index = 0; index < static_cast<ssize_t>(signal_values.size()); ++index) {
-                    mutable_view(index) = signal_values[static_cast<size_t>(index)];
+                {
+                    py::gil_scoped_release release;
+                    source.add_rin_to_signal(signal_values);
                 }
 
-                return output * ureg.attr("watt");
+                return vector_to_numpy_without_copy(std::move(signal_values)) * ureg.attr("watt");
             },
             py::arg("signal"),
             R"doc(
@@ -314,26 +320,21 @@ PYBIND11_MODULE(source, module) {
 
                     detector_names.push_back(key);
                     detector_signals.push_back(
-                        signal_in_watt.attr("magnitude").cast<std::vector<double>>()
+                        array_to_vector(to_contiguous_array<double>(signal_in_watt))
                     );
                 }
 
-                source.add_common_rin_to_signals(detector_signals);
+                {
+                    py::gil_scoped_release release;
+                    source.add_common_rin_to_signals(detector_signals);
+                }
 
                 py::dict output_signal_dict;
                 output_signal_dict["Time"] = signal_dict["Time"];
 
                 for (size_t channel_index = 0; channel_index < detector_names.size(); ++channel_index) {
-                    py::array_t<double> output_array(detector_signals[channel_index].size());
-                    auto mutable_view = output_array.mutable_unchecked<1>();
-
-                    for (ssize_t sample_index = 0; sample_index < static_cast<ssize_t>(detector_signals[channel_index].size()); ++sample_index) {
-                        mutable_view(sample_index) =
-                            detector_signals[channel_index][static_cast<size_t>(sample_index)];
-                    }
-
                     output_signal_dict[py::str(detector_names[channel_index])] =
-                        output_array * ureg.attr("watt");
+                        vector_to_numpy_without_copy(std::move(detector_signals[channel_index])) * ureg.attr("watt");
                 }
 
                 return output_signal_dict;
@@ -443,12 +444,12 @@ PYBIND11_MODULE(source, module) {
                 const py::object& z
             ) {
                 std::vector<double> values = source.get_amplitude_signal(
-                    x.attr("to")("meter").attr("magnitude").cast<std::vector<double>>(),
-                    y.attr("to")("meter").attr("magnitude").cast<std::vector<double>>(),
-                    z.attr("to")("meter").attr("magnitude").cast<std::vector<double>>()
+                    array_to_span(quantity_to_contiguous_array<double>(x, "meter")),
+                    array_to_span(quantity_to_contiguous_array<double>(y, "meter")),
+                    array_to_span(quantity_to_contiguous_array<double>(z, "meter"))
                 );
 
-                return py::cast(values) * ureg.attr("volt / meter");
+                return vector_to_numpy_without_copy(std::move(values)) * ureg.attr("volt / meter");
             },
             py::arg("x"),
             py::arg("y"),
@@ -481,13 +482,13 @@ PYBIND11_MODULE(source, module) {
                 const py::object& time_step
             ) {
                 std::vector<double> values = source.get_power_signal(
-                    x.attr("to")("meter").attr("magnitude").cast<std::vector<double>>(),
-                    y.attr("to")("meter").attr("magnitude").cast<std::vector<double>>(),
-                    z.attr("to")("meter").attr("magnitude").cast<std::vector<double>>(),
+                    array_to_span(quantity_to_contiguous_array<double>(x, "meter")),
+                    array_to_span(quantity_to_contiguous_array<double>(y, "meter")),
+                    array_to_span(quantity_to_contiguous_array<double>(z, "meter")),
                     time_step.attr("to")("second").attr("magnitude").cast<double>()
                 );
 
-                return py::cast(values) * ureg.attr("watt");
+                return vector_to_numpy_without_copy(std::move(values)) * ureg.attr("watt");
             },
             py::arg("x"),
             py::arg("y"),
@@ -521,12 +522,11 @@ PYBIND11_MODULE(source, module) {
         .def(
             "get_particle_width",
             [ureg](const BaseSource& source, const py::object& velocity) {
-                std::vector<double> velocity_values =
-                    velocity.attr("to")("meter / second").attr("magnitude").cast<std::vector<double>>();
-
-                std::vector<double> widths = source.get_particle_width(velocity_values);
+                std::vector<double> widths = source.get_particle_width(
+                    array_to_span(quantity_to_contiguous_array<double>(velocity, "meter / second"))
+                );
 
-                return py::cast(widths) * ureg.attr("second");
+                return vector_to_numpy_without_copy(std::move(widths)) * ureg.attr("second");
             },
             py::arg("velocity"),
             R"doc(
@@ -552,14 +552,29 @@ PYBIND11_MODULE(source, module) {
                 const py::object& scale,
                 const py::object& mean_velocity
             ) {
-                std::vector<double> values = source.get_gamma_trace(
-                    time_array.attr("to")("second").attr("magnitude").cast<std::vector<double>>(),
-                    shape,
-                    scale.attr("to")("watt").attr("magnitude").cast<double>(),
-                    mean_velocity.attr("to")("meter / second").attr("magnitude").cast<double>()
-                );
+                const double scale_watt = scale.attr("to")("watt").attr("magnitude").cast<double>();
+                const double mean_velocity_meter_per_second =
+                    mean_velocity.attr("to")("meter / second").attr("magnitude").cast<double>();
+
+                // A TimeAxis carries its spacing, so no time array is converted nor validated.
+                const utils::TimeAxis time_axis = py::isinstance<utils::TimeAxis>(time_array)
+                    ? time_array.cast<utils::TimeAxis>()
+                    : utils::TimeAxis::from_samples(
+                        array_to_span(quantity_to_contiguous_array<double>(time_array, "second"))
+                    );
+
+                std::vector<double> values;
+                {
+                    py::gil_scoped_release release;
+                    values = source.get_gamma_trace(
+                        time_axis,
+                        shape,
+                        scale_watt,
+                        mean_velocity_meter_per_second
+                    );
+                }
 
-                return py::cast(values) * ureg.attr("watt");
+                return vector_to_numpy_without_copy(std::move(values)) * ureg.attr("watt");
             },
             py::arg("time_array"),
             py::arg("shape"),
@@ -570,8 +585,8 @@ PYBIND11_MODULE(source, module) {
 
                 Parameters
                 ----------
-                time_array : pint.Quantity
-                    Time samples defining the output trace.
+                time_array : pint.Quantity or TimeAxis
+                    Uniformly sampled time axis defining the output trace.
                 shape : float
                     Shape parameter of the gamma model.
                 scale : pint.Quantity
@@ -596,16 +611,25 @@ PYBIND11_MODULE(source, module) {
                 const py::object& time_array,
                 const py::object& base_level
             ) {
+                const contiguous_array<double> velocity_values = quantity_to_contiguous_array<double>(velocities, "meter / second");
+                const contiguous_array<double> center_values = quantity_to_contiguous_array<double>(pulse_centers, "second");
+                const contiguous_array<double> amplitude_values = quantity_to_contiguous_array<double>(pulse_amplitudes, "watt");
+                const contiguous_array<double> time_values = quantity_to_contiguous_array<double>(time_array, "second");
+                const double base_level_watt = base_level.attr("to")("watt").attr("magnitude").cast<double>();
+
+                std::vector<double> values;
+                {
+                    py::gil_scoped_release release;
+                    values = source.generate_pulses(
+                        array_to_span(velocity_values),
+                        array_to_span(center_values),
+                        array_to_span(amplitude_values),
+                        array_to_span(time_values),
+                        base_level_watt
+                    );
+                }
 
-                std::vector<double> values = source.generate_pulses(
-                    velocities.attr("to")("meter / second").attr("magnitude").cast<std::vector<double>>(),
-                    pulse_centers.attr("to")("second").attr("magnitude").cast<std::vector<double>>(),
-                    pulse_amplitudes.attr("to")("watt").attr("magnitude").cast<std::vector<double>>(),
-                    time_array.attr("to")("second").attr("magnitude").cast<std::vector<double>>(),
-                    base_level.attr("to")("watt").attr("magnitude").cast<double>()
-                );
-
-                return py::cast(values) * ureg.attr("watt");
+                return vector_to_numpy_without_copy(std::move(values)) * ureg.attr("watt");
             },
             py::arg("velocities"),
             py::arg("pulse_centers"),
@@ -634,6 +658,117 @@ PYBIND11_MODULE(source, module) {
                     Optical power trace containing the generated pulses.
             )doc"
         )
+        .def(
+            "generate_multi_detector_pulses",
+            [ureg](
+                const BaseSource& source,
+                const py::object& velocities,
+                const py::object& pulse_centers,
+                const py::object& pulse_amplitudes,
+                const py::object& time_array,
+                const py::object& base_level,
+                const py::object& periodic_window
+            ) {
+                using amplitude_array = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+                amplitude_array amplitude_matrix = amplitude_array::ensure(
+                    pulse_amplitudes.attr("to")("watt").attr("magnitude")
+                );
+
+                if (!amplitude_matrix || amplitude_matrix.ndim() != 2) {
+                    throw py::value_error(
+                        "pulse_amplitudes must be a 2D quantity of shape (n_events, n_detectors)."
+                    );
+                }
+
+                const size_t number_of_events = static_cast<size_t>(amplitude_matrix.shape(0));
+                const size_t number_of_detectors = static_cast<size_t>(amplitude_matrix.shape(1));
+
+                const std::span<const double> amplitude_values(
+                    amplitude_matrix.data(),
+                    number_of_events * number_of_detectors
+                );
+
+                const double periodic_window_second = periodic_window.is_none()
+                    ? std::numeric_limits<double>::quiet_NaN()
+                    : periodic_window.attr("to")("second").attr("magnitude").cast<double>();
+
+                const contiguous_array<double> velocity_values = quantity_to_contiguous_array<double>(velocities, "meter / second");
+                const contiguous_array<double> center_values = quantity_to_contiguous_array<double>(pulse_centers, "second");
+                const contiguous_array<double> time_values = quantity_to_contiguous_array<double>(time_array, "second");
+                const double base_level_watt = base_level.attr("to")("watt").attr("magnitude").cast<double>();
+
+                std::vector<std::vector<double>> signals;
+                {
+                    py::gil_scoped_release release;
+                    signals = source.generate_multi_detector_pulses(
+                        array_to_span(velocity_values),
+                        array_to_span(center_values),
+                        amplitude_values,
+                        number_of_detectors,
+                        array_to_span(time_values),
+                        base_level_watt,
+                        periodic_window_second
+                    );
+                }
+
+                const size_t number_of_samples = signals.empty() ? 0 : signals.front().size();
+
+                py::array_t<double> output(
+                    std::vector<py::ssize_t>{
+                        static_cast<py::ssize_t>(number_of_detectors),
+                        static_cast<py::ssize_t>(number_of_samples)
+                    }
+                );
+                double* output_data = output.mutable_data();
+
+                for (size_t detector_index = 0; detector_index < number_of_detectors; ++detector_index) {
+                    std::copy(
+                        signals[detector_index].begin(),
+                        signals[detector_index].end(),
+                        output_data + detector_index * number_of_samples
+                    );
+                }
+
+                return output * ureg.attr("watt");
+            },
+            py::arg("velocities"),
+            py::arg("pulse_centers"),
+            py::arg("pulse_amplitudes"),
+            py::arg("time_array"),
+            py::arg("base_level"),
+            py::arg("periodic_window") = py::none(),
+            R"doc(
+                Generate the pulse trains of several detectors in a single pass.
+
+                All detectors share the same particle transits, hence the same
+                pulse envelopes. Each envelope value is computed once and
+                scattered into every detector trace with the detector specific
+                amplitude.
+
+                Parameters
+                ----------
+                velocities : pint.Quantity
+                    Particle velocities, one per event.
+                pulse_centers : pint.Quantity
+                    Pulse center times, one per event.
+                pulse_amplitudes : pint.Quantity
+                    Optical power amplitudes of shape ``(n_events, n_detectors)``.
+                time_array : pint.Quantity
+                    Time samples of the output signals.
+                base_level : pint.Quantity
+                    Constant optical background level added to every trace.
+                periodic_window : pint.Quantity or None, optional
+                    If given, pulses are wrapped periodically with this period so
+                    that events near one edge of the acquisition also contribute
+                    to the opposite edge.
+
+                Returns
+                -------
+                pint.Quantity
+                    Optical power traces of shape ``(n_detectors, n_samples)``.
+            )doc"
+        )
         .def(
             "__repr__",
             [ureg](const BaseSource& source) {
@@ -777,6 +912,23 @@ PYBIND11_MODULE(source, module) {
                 Gaussian beam waist along the z direction.
             )doc"
         )
+        .def_property(
+            "pulse_support_cutoff",
+            [](const Gaussian& source) {
+                return source.pulse_support_cutoff;
+            },
+            &Gaussian::set_pulse_support_cutoff,
+            R"doc(
+                Half support of synthesized Gaussian pulses, in units of the pulse
+                standard deviation.
+
+                :meth:`generate_pulses` only evaluates each pulse on the samples
+                lying within this many standard deviations of its center.
+                %
+                Setting this attribute to ``float('inf')`` disables truncation and
+                evaluates every pulse on the full time axis.
+            )doc"
+        )
         .def(
             "set_waist",
             [](Gaussian& source, const py::object& waist_y, const py::object& waist_z) {
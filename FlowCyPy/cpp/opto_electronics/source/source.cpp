@@ -1,4 +1,9 @@
 #include <opto_electronics/source/source.h>
+#include <utils/utils.h>
+#include <utils/random.h>
+#include <utils/shot_noise.h>
+#include <utils/profiler.h>
+#include <utils/threading.h>
 
 
 BaseSource::BaseSource(
@@ -43,8 +48,10 @@ BaseSource::BaseSource(
 }
 
 void BaseSource::test_openmp() {
-    std::printf("max threads = %d\n", omp_get_max_threads());
-    #pragma omp parallel
+    const int number_of_threads = utils::ThreadingSettings::instance().get_number_of_threads();
+
+    std::printf("max threads = %d\n", number_of_threads);
+    #pragma omp parallel num_threads(number_of_threads)
     {
         #pragma omp single
         std::printf("parallel threads = %d\n", omp_get_num_threads());
@@ -76,34 +83,14 @@ double BaseSource::get_watt_to_photon_factor(const double time_step) const {
 }
 
 
-double BaseSource::get_time_step_from_time_array(const std::vector<double>& time_array) const {
-    if (time_array.size() < 2) {
-        throw std::runtime_error("time_array must contain at least two samples.");
-    }
-
-    const double time_step = time_array[1] - time_array[0];
-
-    if (time_step <= 0.0) {
-        throw std::runtime_error("time_array must be strictly increasing.");
-    }
-
-    for (size_t index = 2; index < time_array.size(); ++index) {
-        const double current_step = time_array[index] - time_array[index - 1];
-
-        if (current_step <= 0.0) {
-            throw std::runtime_error("time_array must be strictly increasing.");
-        }
-
-        if (std::abs(current_step - time_step) > 1e-12 * std::max(1.0, std::abs(time_step))) {
-            throw std::runtime_error("time_array must be uniformly sampled.");
-        }
-    }
-
-    return time_step;
+double BaseSource::get_time_step_from_time_array(std::span<const double> time_array) const {
+    return utils::TimeAxis::from_samples(time_array).time_step;
 }
 
 
 void BaseSource::add_rin_to_signal(std::vector<double>& signal_values) const {
+    FLOWCYPY_PROFILE_SCOPE("source.add_rin_to_signal");
+
     if (std::isnan(this->bandwidth)) {
         if (debug_mode) {
             std::printf("[RIN] bandwidth is NaN → RIN disabled\n");
@@ -127,7 +114,24 @@ void BaseSource::add_rin_to_signal(std::vector<double>& signal_values) const {
 
     const size_t N = signal_values.size();
 
-    #pragma omp parallel
+    FLOWCYPY_PROFILE_COUNT("source.add_rin_to_signal", "samples", N);
+    FLOWCYPY_PROFILE_MAX("source.add_rin_to_signal", "threads", omp_get_max_threads());
+
+    bool found_negative_value = false;
+
+    #pragma omp parallel for simd reduction(||:found_negative_value) num_threads(utils::get_team_size(N, utils::ParallelComponent::source))
+    for (size_t i = 0; i < N; ++i) {
+        found_negative_value = found_negative_value || (signal_values[i] < 0.0);
+    }
+
+    if (found_negative_value) {
+        throw std::runtime_error("RIN cannot be applied to negative signal values.");
+    }
+
+    const utils::CounterRandomGenerator generator =
+        utils::RandomService::instance().next_generator(utils::RandomStreamId::source_rin);
+
+    #pragma omp parallel num_threads(utils::get_team_size(N, utils::ParallelComponent::noise))
     {
         #pragma omp single
         {
@@ -136,22 +140,10 @@ void BaseSource::add_rin_to_signal(std::vector<double>& signal_values) const {
             }
         }
 
-        static thread_local std::random_device rd;
-        static thread_local std::mt19937 gen(rd());
-        static thread_local std::normal_distribution<double> standard_normal(0.0, 1.0);
-
-        #pragma omp for
+        #pragma omp for simd
         for (size_t i = 0; i < N; ++i) {
-            const double value = signal_values[i];
-
-            if (value < 0.0) {
-                throw std::runtime_error("RIN cannot be applied to negative signal values.");
-            }
-
-            const double sigma = sigma_factor * value;
-            const double noise = standard_normal(gen) * sigma;
-
-            signal_values[i] += noise;
+            const double sigma = sigma_factor * signal_values[i];
+            signal_values[i] += generator.normal(i) * sigma;
         }
     }
 }
@@ -160,6 +152,8 @@ void BaseSource::add_rin_to_signal(std::vector<double>& signal_values) const {
 
 
 void BaseSource::add_common_rin_to_signals(std::vector<std::vector<double>>& signal_values_per_channel) const {
+    FLOWCYPY_PROFILE_SCOPE("source.add_common_rin_to_signals");
+
     if (std::isnan(this->bandwidth)) {
         if (debug_mode) {
             std::printf("[CommonRIN] bandwidth is NaN → RIN disabled\n");
@@ -192,7 +186,27 @@ void BaseSource::add_common_rin_to_signals(std::vector<std::vector<double>>& sig
         );
     }
 
-    #pragma omp parallel
+    for (const auto& ch : signal_values_per_channel) {
+        bool found_negative_value = false;
+
+        #pragma omp parallel for simd reduction(||:found_negative_value) num_threads(utils::get_team_size(N, utils::ParallelComponent::source))
+        for (size_t t = 0; t < N; ++t) {
+            found_negative_value = found_negative_value || (ch[t] < 0.0);
+        }
+
+        if (found_negative_value) {
+            throw std::runtime_error("RIN cannot be applied to negative optical power values.");
+        }
+    }
+
+    FLOWCYPY_PROFILE_COUNT("source.add_common_rin_to_signals", "samples", N * signal_values_per_channel.size());
+    FLOWCYPY_PROFILE_MAX("source.add_common_rin_to_signals", "threads", omp_get_max_threads());
+
+    // One fluctuation per time sample, shared by every channel.
+    const utils::CounterRandomGenerator generator =
+        utils::RandomService::instance().next_generator(utils::RandomStreamId::source_common_rin);
+
+    #pragma omp parallel num_threads(utils::get_team_size(N, utils::ParallelComponent::noise))
     {
         #pragma omp single
         {
@@ -200,18 +214,12 @@ void BaseSource::add_common_rin_to_signals(std::vector<std::vector<double>>& sig
                 std::printf("[CommonRIN] using %d OpenMP threads\n", omp_get_num_threads());
             }
         }
-        static thread_local std::random_device random_device;
-        static thread_local std::mt19937 generator(random_device());
-        static thread_local std::normal_distribution<double> standard_normal(0.0, 1.0);
 
         #pragma omp for
         for (size_t t = 0; t < N; ++t) {
-            const double fluct = standard_normal(generator) * sigma;
+            const double fluct = generator.normal(t) * sigma;
 
             for (auto& ch : signal_values_per_channel) {
-                if (ch[t] < 0.0) {
-                    throw std::runtime_error("RIN cannot be applied to negative optical power values.");
-                }
                 ch[t] *= (1.0 + fluct);
             }
         }
@@ -222,108 +230,51 @@ void BaseSource::add_common_rin_to_signals(std::vector<std::vector<double>>& sig
 
 
 void BaseSource::add_shot_noise_to_signal(std::vector<double>& power_values, const double time_step) const {
-    if (time_step <= 0.0) {
-        throw std::runtime_error("time_step must be strictly positive.");
-    }
+    FLOWCYPY_PROFILE_SCOPE("source.add_shot_noise_to_signal");
+    FLOWCYPY_PROFILE_COUNT("source.add_shot_noise_to_signal", "samples", power_values.size());
+    FLOWCYPY_PROFILE_MAX("source.add_shot_noise_to_signal", "threads", omp_get_max_threads());
 
-    const double photon_energy = this->get_photon_energy();
-    const double watt_to_photon = time_step / photon_energy;
+    const double watt_to_photon = this->get_watt_to_photon_factor(time_step);
 
     if (debug_mode && !power_values.empty()) {
         const double minimum_power = *std::min_element(power_values.begin(), power_values.end());
         const double maximum_power = *std::max_element(power_values.begin(), power_values.end());
 
         std::printf(
-            "[ShotNoise] min=%.6e W | max=%.6e W | photon_energy=%.6e J | factor=%.6e\n",
+            "[ShotNoise] min=%.6e W | max=%.6e W | photon_energy=%.6e J | factor=%.6e | threads=%d\n",
             minimum_power,
             maximum_power,
-            photon_energy,
-            watt_to_photon
+            this->get_photon_energy(),
+            watt_to_photon,
+            omp_get_max_threads()
         );
     }
 
-    bool found_negative_input = false;
-    size_t bad_index = 0;
-    double bad_value = 0.0;
-
-    const size_t number_of_samples = power_values.size();
-
-    #pragma omp parallel
-    {
-        #pragma omp single
-        {
-            if (debug_mode) {
-                std::printf("[ShotNoise] using %d OpenMP threads\n", omp_get_num_threads());
-            }
-        }
-
-        static thread_local std::random_device random_device;
-        static thread_local std::mt19937 generator(random_device());
-        static thread_local std::normal_distribution<double> standard_normal(0.0, 1.0);
-
-        bool local_found_negative_input = false;
-        size_t local_bad_index = 0;
-        double local_bad_value = 0.0;
-
-        #pragma omp for
-        for (size_t sample_index = 0; sample_index < number_of_samples; ++sample_index) {
-            if (found_negative_input) {
-                continue;
-            }
-
-            const double power_value = power_values[sample_index];
-
-            if (power_value < 0.0) {
-                local_found_negative_input = true;
-                local_bad_index = sample_index;
-                local_bad_value = power_value;
-                continue;
-            }
-
-            const double mean_photons = power_value * watt_to_photon;
-            double noisy_photons = 0.0;
-
-            if (mean_photons < 100.0) {
-                std::poisson_distribution<int> poisson_distribution(mean_photons);
-                noisy_photons = static_cast<double>(poisson_distribution(generator));
-            } else {
-                noisy_photons = std::max(
-                    0.0,
-                    mean_photons + standard_normal(generator) * std::sqrt(mean_photons)
-                );
-            }
-
-            power_values[sample_index] = noisy_photons / watt_to_photon;
-        }
-
-        #pragma omp critical
-        {
-            if (local_found_negative_input && !found_negative_input) {
-                found_negative_input = true;
-                bad_index = local_bad_index;
-                bad_value = local_bad_value;
-            }
-        }
-    }
+    const size_t bad_index = utils::find_first_negative(power_values.data(), power_values.size());
 
-    if (found_negative_input) {
+    if (bad_index != power_values.size()) {
         throw std::runtime_error(
             "Shot noise received a negative optical power sample, which is nonphysical. "
             "Shot noise can only be applied to nonnegative optical power. "
             "This usually indicates that the source RIN noise produces invalid power values. "
             "First invalid sample: index=" + std::to_string(bad_index) +
-            ", value=" + std::to_string(bad_value) + " W."
+            ", value=" + std::to_string(power_values[bad_index]) + " W."
         );
     }
+
+    const utils::CounterRandomGenerator generator =
+        utils::RandomService::instance().next_generator(utils::RandomStreamId::source_shot_noise);
+
+    utils::apply_shot_noise_in_place(power_values.data(), power_values.size(), watt_to_photon, generator);
 }
 
 
 
 
 std::vector<double> BaseSource::get_amplitude_signal(
-    const std::vector<double>& x,
-    const std::vector<double>& y,
-    const std::vector<double>& z
+    std::span<const double> x,
+    std::span<const double> y,
+    std::span<const double> z
 ) const {
 
     this->validate_coordinate_vectors(x, y, z);
@@ -346,9 +297,9 @@ std::vector<double> BaseSource::get_amplitude_signal(
 
 
 std::vector<double> BaseSource::get_power_signal(
-    const std::vector<double>& x,
-    const std::vector<double>& y,
-    const std::vector<double>& z,
+    std::span<const double> x,
+    std::span<const double> y,
+    std::span<const double> z,
     const double time_step
 ) const {
     (void)time_step;
@@ -383,9 +334,11 @@ double BaseSource::get_power_at(
 
 
 std::vector<double> BaseSource::convolve_with_kernel(
-    const std::vector<double>& signal,
-    const std::vector<double>& kernel
+    std::span<const double> signal,
+    std::span<const double> kernel
 ) const {
+    FLOWCYPY_PROFILE_SCOPE("source.convolve_with_kernel");
+
     if (signal.empty()) {
         throw std::runtime_error("signal must not be empty.");
     }
@@ -393,51 +346,151 @@ std::vector<double> BaseSource::convolve_with_kernel(
         throw std::runtime_error("kernel must not be empty.");
     }
 
-    const int half = kernel.size() / 2;
-    const int N    = signal.size();
+    if (debug_mode) {
+        std::printf(
+            "[Convolution] N=%zu | K=%zu | path=%s | using %d OpenMP threads\n",
+            signal.size(),
+            kernel.size(),
+            kernel.size() >= utils::fft_convolution_kernel_threshold ? "fft" : "direct",
+            omp_get_max_threads()
+        );
+    }
 
-    std::vector<double> out(N, 0.0);
+    FLOWCYPY_PROFILE_COUNT("source.convolve_with_kernel", "samples", signal.size());
+    FLOWCYPY_PROFILE_COUNT("source.convolve_with_kernel", "bytes", signal.size() * sizeof(double));
+    FLOWCYPY_PROFILE_MAX("source.convolve_with_kernel", "threads", omp_get_max_threads());
 
-    #pragma omp parallel
-    {
-        #pragma omp single
-        {
-            if (debug_mode) {
-                std::printf("[Convolution] using %d OpenMP threads\n", omp_get_num_threads());
-            }
-        }
+    return utils::convolve_with_reflected_boundaries(signal, kernel);
+}
 
-        #pragma omp for
-        for (int i = 0; i < N; ++i) {
-            double acc = 0.0;
 
-            for (int k = 0; k < (int)kernel.size(); ++k) {
-                int idx = i + k - half;
 
-                idx = std::abs(idx);
-                if (idx >= N) idx = 2 * N - idx - 2;
 
-                acc += signal[idx] * kernel[k];
-            }
+template <typename Real>
+std::vector<std::vector<Real>> BaseSource::generate_multi_detector_pulses(
+    std::span<const double> velocities,
+    std::span<const double> pulse_centers,
+    std::span<const double> pulse_amplitudes,
+    const size_t number_of_detectors,
+    std::span<const double> time_array,
+    const double base_level,
+    const double periodic_window
+) const {
+    FLOWCYPY_PROFILE_SCOPE("source.generate_multi_detector_pulses");
+
+    if (velocities.size() != pulse_centers.size()) {
+        throw std::runtime_error("velocities and pulse_centers must have the same size.");
+    }
+
+    if (pulse_amplitudes.size() != velocities.size() * number_of_detectors) {
+        throw std::runtime_error(
+            "pulse_amplitudes must hold one row of number_of_detectors values per event."
+        );
+    }
+
+    this->validate_velocity_vector(velocities);
+
+    std::vector<std::vector<Real>> signals(
+        number_of_detectors,
+        std::vector<Real>(time_array.size(), static_cast<Real>(base_level))
+    );
+
+    FLOWCYPY_PROFILE_COUNT("source.generate_multi_detector_pulses", "samples", time_array.size() * number_of_detectors);
+    FLOWCYPY_PROFILE_COUNT("source.generate_multi_detector_pulses", "bytes", time_array.size() * number_of_detectors * sizeof(Real));
+    FLOWCYPY_PROFILE_COUNT("source.generate_multi_detector_pulses", "events", velocities.size());
+
+    const std::vector<double> pulse_widths = this->get_particle_width(velocities);
+
+    if (std::isnan(periodic_window)) {
+        this->accumulate_multi_detector_pulses(
+            signals,
+            time_array,
+            pulse_centers,
+            pulse_widths,
+            pulse_amplitudes
+        );
+
+        return signals;
+    }
 
-            out[i] = acc;
+    if (!(periodic_window > 0.0)) {
+        throw std::runtime_error("periodic_window must be strictly positive or NaN.");
+    }
+
+    // Each event is replicated one period before and after; images whose support does
+    // not intersect the time axis are skipped by the synthesis engine.
+    const size_t number_of_events = velocities.size();
+
+    std::vector<double> wrapped_centers;
+    std::vector<double> wrapped_widths;
+    std::vector<double> wrapped_amplitudes;
+
+    wrapped_centers.reserve(3 * number_of_events);
+    wrapped_widths.reserve(3 * number_of_events);
+    wrapped_amplitudes.reserve(3 * pulse_amplitudes.size());
+
+    for (const double shift : {-periodic_window, 0.0, periodic_window}) {
+        for (size_t event_index = 0; event_index < number_of_events; ++event_index) {
+            wrapped_centers.push_back(pulse_centers[event_index] + shift);
+            wrapped_widths.push_back(pulse_widths[event_index]);
         }
+
+        wrapped_amplitudes.insert(
+            wrapped_amplitudes.end(),
+            pulse_amplitudes.begin(),
+            pulse_amplitudes.end()
+        );
     }
 
-    return out;
+    this->accumulate_multi_detector_pulses(
+        signals,
+        time_array,
+        wrapped_centers,
+        wrapped_widths,
+        wrapped_amplitudes
+    );
+
+    return signals;
 }
 
+template std::vector<std::vector<double>> BaseSource::generate_multi_detector_pulses<double>(
+    std::span<const double>, std::span<const double>, std::span<const double>,
+    const size_t, std::span<const double>, const double, const double
+) const;
+
+template std::vector<std::vector<float>> BaseSource::generate_multi_detector_pulses<float>(
+    std::span<const double>, std::span<const double>, std::span<const double>,
+    const size_t, std::span<const double>, const double, const double
+) const;
 
 
+std::vector<double> BaseSource::get_gamma_trace(
+    std::span<const double> time_array,
+    double shape,
+    double scale,
+    double mean_velocity
+) const {
+    return this->get_gamma_trace(utils::TimeAxis::from_samples(time_array), shape, scale, mean_velocity);
+}
+
 
 std::vector<double> BaseSource::get_gamma_trace(
-    const std::vector<double>& time_array,
+    const utils::TimeAxis& time_axis,
     double shape,
     double scale,
     double mean_velocity
 ) const {
-    const size_t N = time_array.size();
-    const double dt = this->get_time_step_from_time_array(time_array);
+    if (time_axis.size() < 2) {
+        throw std::runtime_error("time_array must contain at least two samples.");
+    }
+
+    const size_t N = time_axis.size();
+    FLOWCYPY_PROFILE_SCOPE("source.get_gamma_trace");
+    FLOWCYPY_PROFILE_COUNT("source.get_gamma_trace", "samples", N);
+    FLOWCYPY_PROFILE_COUNT("source.get_gamma_trace", "bytes", N * sizeof(double));
+    FLOWCYPY_PROFILE_MAX("source.get_gamma_trace", "threads", omp_get_max_threads());
+
+    const double dt = time_axis.time_step;
 
     if (debug_mode) {
         std::printf("[GammaTrace] dt=%.6e | shape=%.6e | scale=%.6e | v=%.6e\n", dt, shape, scale, mean_velocity);
@@ -445,7 +498,10 @@ std::vector<double> BaseSource::get_gamma_trace(
 
     std::vector<double> latent(N);
 
-    #pragma omp parallel
+    const utils::CounterRandomGenerator generator =
+        utils::RandomService::instance().next_generator(utils::RandomStreamId::source_gamma_trace);
+
+    #pragma omp parallel num_threads(utils::get_team_size(N, utils::ParallelComponent::noise))
     {
         #pragma omp single
         {
@@ -454,13 +510,11 @@ std::vector<double> BaseSource::get_gamma_trace(
             }
         }
 
-        static thread_local std::random_device rd;
-        static thread_local std::mt19937 gen(rd());
-        std::gamma_distribution<double> gamma_dist(shape, scale);
-
         #pragma omp for
         for (size_t i = 0; i < N; ++i) {
-            latent[i] = gamma_dist(gen);
+            std::gamma_distribution<double> gamma_dist(shape, scale);
+            utils::CounterRandomGenerator::Engine engine = generator.engine(i);
+            latent[i] = gamma_dist(engine);
         }
     }
 
@@ -476,9 +530,9 @@ void BaseSource::update_amplitude() {
 }
 
 void BaseSource::validate_coordinate_vectors(
-    const std::vector<double>& x,
-    const std::vector<double>& y,
-    const std::vector<double>& z
+    std::span<const double> x,
+    std::span<const double> y,
+    std::span<const double> z
 ) const {
     if (x.size() != y.size() || x.size() != z.size()) {
         throw std::runtime_error("x, y, and z must have the same size.");
@@ -487,9 +541,9 @@ void BaseSource::validate_coordinate_vectors(
 
 
 void BaseSource::validate_pulse_vectors(
-    const std::vector<double>& velocities,
-    const std::vector<double>& pulse_centers,
-    const std::vector<double>& pulse_amplitudes
+    std::span<const double> velocities,
+    std::span<const double> pulse_centers,
+    std::span<const double> pulse_amplitudes
 ) const {
     if (
         velocities.size() != pulse_centers.size() ||
@@ -503,7 +557,7 @@ void BaseSource::validate_pulse_vectors(
 
 
 void BaseSource::validate_velocity_vector(
-    const std::vector<double>& velocity
+    std::span<const double> velocity
 ) const {
     if (velocity.empty()) {
         throw std::runtime_error("velocity must not be empty.");
@@ -572,7 +626,16 @@ void Gaussian::set_waist(
 }
 
 
-std::vector<double> Gaussian::get_particle_width(const std::vector<double>& velocity) const {
+void Gaussian::set_pulse_support_cutoff(const double pulse_support_cutoff) {
+    if (!(pulse_support_cutoff > 0.0)) {
+        throw std::runtime_error("pulse_support_cutoff must be strictly positive.");
+    }
+
+    this->pulse_support_cutoff = pulse_support_cutoff;
+}
+
+
+std::vector<double> Gaussian::get_particle_width(std::span<const double> velocity) const {
     this->validate_velocity_vector(velocity);
 
     std::vector<double> widths;
@@ -643,10 +706,10 @@ double Gaussian::get_amplitude_at(
 }
 
 std::vector<double> Gaussian::generate_pulses(
-    const std::vector<double>& velocities,
-    const std::vector<double>& pulse_centers,
-    const std::vector<double>& pulse_amplitudes,
-    const std::vector<double>& time_array,
+    std::span<const double> velocities,
+    std::span<const double> pulse_centers,
+    std::span<const double> pulse_amplitudes,
+    std::span<const double> time_array,
     const double base_level
 ) const {
     this->validate_pulse_vectors(
@@ -657,26 +720,54 @@ std::vector<double> Gaussian::generate_pulses(
 
     this->validate_velocity_vector(velocities);
 
-    std::vector<double> signal;
-    signal.reserve(time_array.size());
+    std::vector<double> signal(time_array.size(), base_level);
 
-    for (double time_value : time_array) {
-        double signal_value = base_level;
+    utils::pulse_synthesis::accumulate_gaussian_pulses(
+        signal,
+        time_array,
+        pulse_centers,
+        this->get_particle_width(velocities),
+        pulse_amplitudes,
+        this->pulse_support_cutoff
+    );
 
-        for (size_t index = 0; index < velocities.size(); ++index) {
-            const double pulse_width = this->waist_z / (2.0 * velocities[index]);
-            const double normalized_time =
-                (time_value - pulse_centers[index]) / pulse_width;
+    return signal;
+}
 
-            const double exponent = -0.5 * normalized_time * normalized_time;
 
-            signal_value += pulse_amplitudes[index] * std::exp(exponent);
-        }
+void Gaussian::accumulate_multi_detector_pulses(
+    std::vector<std::vector<double>>& signals,
+    std::span<const double> time_array,
+    std::span<const double> pulse_centers,
+    std::span<const double> pulse_widths,
+    std::span<const double> pulse_amplitudes
+) const {
+    utils::pulse_synthesis::accumulate_multichannel_gaussian_pulses(
+        signals,
+        time_array,
+        pulse_centers,
+        pulse_widths,
+        pulse_amplitudes,
+        this->pulse_support_cutoff
+    );
+}
 
-        signal.push_back(signal_value);
-    }
 
-    return signal;
+void Gaussian::accumulate_multi_detector_pulses(
+    std::vector<std::vector<float>>& signals,
+    std::span<const double> time_array,
+    std::span<const double> pulse_centers,
+    std::span<const double> pulse_widths,
+    std::span<const double> pulse_amplitudes
+) const {
+    utils::pulse_synthesis::accumulate_multichannel_gaussian_pulses(
+        signals,
+        time_array,
+        pulse_centers,
+        pulse_widths,
+        pulse_amplitudes,
+        this->pulse_support_cutoff
+    );
 }
 
 
@@ -759,7 +850,7 @@ void FlatTop::set_waist(const double waist_y, const double waist_z) {
 }
 
 
-std::vector<double> FlatTop::get_particle_width(const std::vector<double>& velocity) const {
+std::vector<double> FlatTop::get_particle_width(std::span<const double> velocity) const {
     this->validate_velocity_vector(velocity);
 
     std::vector<double> widths;
@@ -833,10 +924,10 @@ double FlatTop::get_amplitude_at(
 
 
 std::vector<double> FlatTop::generate_pulses(
-    const std::vector<double>& velocities,
-    const std::vector<double>& pulse_centers,
-    const std::vector<double>& pulse_amplitudes,
-    const std::vector<double>& time_array,
+    std::span<const double> velocities,
+    std::span<const double> pulse_centers,
+    std::span<const double> pulse_amplitudes,
+    std::span<const double> time_array,
     const double base_level
 ) const {
 
@@ -848,24 +939,51 @@ std::vector<double> FlatTop::generate_pulses(
 
     this->validate_velocity_vector(velocities);
 
-    std::vector<double> signal;
-    signal.reserve(time_array.size());
+    std::vector<double> signal(time_array.size(), base_level);
 
-    for (double time_value : time_array) {
-        double signal_value = base_level;
+    utils::pulse_synthesis::accumulate_rectangular_pulses(
+        signal,
+        time_array,
+        pulse_centers,
+        this->get_particle_width(velocities),
+        pulse_amplitudes
+    );
 
-        for (size_t index = 0; index < velocities.size(); ++index) {
-            const double pulse_width = this->waist_z / (2.0 * velocities[index]);
-            const bool is_inside_pulse =
-                std::abs(time_value - pulse_centers[index]) <= pulse_width / 2.0;
+    return signal;
+}
 
-            signal_value += pulse_amplitudes[index] * (is_inside_pulse ? 1.0 : 0.0);
-        }
 
-        signal.push_back(signal_value);
-    }
+void FlatTop::accumulate_multi_detector_pulses(
+    std::vector<std::vector<double>>& signals,
+    std::span<const double> time_array,
+    std::span<const double> pulse_centers,
+    std::span<const double> pulse_widths,
+    std::span<const double> pulse_amplitudes
+) const {
+    utils::pulse_synthesis::accumulate_multichannel_rectangular_pulses(
+        signals,
+        time_array,
+        pulse_centers,
+        pulse_widths,
+        pulse_amplitudes
+    );
+}
 
-    return signal;
+
+void FlatTop::accumulate_multi_detector_pulses(
+    std::vector<std::vector<float>>& signals,
+    std::span<const double> time_array,
+    std::span<const double> pulse_centers,
+    std::span<const double> pulse_widths,
+    std::span<const double> pulse_amplitudes
+) const {
+    utils::pulse_synthesis::accumulate_multichannel_rectangular_pulses(
+        signals,
+        time_array,
+        pulse_centers,
+        pulse_widths,
+        pulse_amplitudes
+    );
 }
 
 
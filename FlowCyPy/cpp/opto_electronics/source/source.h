@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <span>
 #include <random>
 #include <cmath>
 #include <stdexcept>
@@ -10,6 +11,8 @@
 #include <omp.h>
 
 #include <utils/constants.h>
+#include <utils/pulse_synthesis.h>
+#include <utils/time_axis.h>
 
 
 /**
@@ -136,7 +139,7 @@ public:
      * @throws std::runtime_error If the time axis is too short, not strictly increasing,
      * or not uniformly sampled.
      */
-    double get_time_step_from_time_array(const std::vector<double>& time_array) const;
+    double get_time_step_from_time_array(std::span<const double> time_array) const;
 
     /**
      * @brief Apply independent relative intensity noise to a signal.
@@ -193,7 +196,9 @@ public:
      * - from a Poisson distribution for small counts
      * - from a Gaussian approximation for large counts
      *
-     * The noisy photon count is finally converted back to optical power.
+     * The noisy photon count is finally converted back to optical power. Inputs are
+     * validated in a separate pre-scan and the counts are drawn by the batch kernel
+     * utils::apply_shot_noise_in_place.
      *
      * This produces a physically motivated discrete counting noise model.
      *
@@ -225,9 +230,9 @@ public:
      * @throws std::runtime_error If x, y, and z do not have identical sizes.
      */
     std::vector<double> get_amplitude_signal(
-        const std::vector<double>& x,
-        const std::vector<double>& y,
-        const std::vector<double>& z
+        std::span<const double> x,
+        std::span<const double> y,
+        std::span<const double> z
     ) const;
 
     /**
@@ -250,9 +255,9 @@ public:
      * @throws std::runtime_error If x, y, and z do not have identical sizes.
      */
     std::vector<double> get_power_signal(
-        const std::vector<double>& x,
-        const std::vector<double>& y,
-        const std::vector<double>& z,
+        std::span<const double> x,
+        std::span<const double> y,
+        std::span<const double> z,
         const double time_step
     ) const;
 
@@ -283,7 +288,17 @@ public:
      * @return Pulse widths in second, one per input velocity.
      */
     virtual std::vector<double> get_particle_width(
-        const std::vector<double>& velocity
+        std::span<const double> velocity
+    ) const = 0;
+
+    /**
+     * @brief Half width of the time support of a pulse, outside of which the pulse is zero.
+     *
+     * @param pulse_width Pulse width in second, as returned by get_particle_width.
+     * @return Half support in second.
+     */
+    virtual double get_pulse_half_support(
+        const double pulse_width
     ) const = 0;
 
     /**
@@ -316,13 +331,50 @@ public:
      * @return Time domain optical power signal in watt.
      */
     virtual std::vector<double> generate_pulses(
-        const std::vector<double>& velocities,
-        const std::vector<double>& pulse_centers,
-        const std::vector<double>& pulse_amplitudes,
-        const std::vector<double>& time_array,
+        std::span<const double> velocities,
+        std::span<const double> pulse_centers,
+        std::span<const double> pulse_amplitudes,
+        std::span<const double> time_array,
         const double base_level
     ) const = 0;
 
+    /**
+     * @brief Generate the pulse trains of several detectors in a single pass.
+     *
+     * All detectors share the same events and therefore the same pulse envelopes; only
+     * the per detector amplitude differs. The envelope of each event is evaluated once
+     * per sample and scattered into every detector trace, so the synthesis cost does not
+     * grow with the number of detectors beyond the final multiply add.
+     *
+     * When periodic_window is finite, each event is also replicated at
+     * center - periodic_window and center + periodic_window so that pulses crossing the
+     * acquisition boundaries wrap around to the opposite edge.
+     *
+     * @param velocities Particle velocities in meter / second.
+     * @param pulse_centers Pulse center times in second.
+     * @param pulse_amplitudes Row major (n_events x number_of_detectors) amplitude matrix in watt.
+     * @param number_of_detectors Number of detector columns in pulse_amplitudes.
+     * @param time_array Time axis in second.
+     * @param base_level Baseline optical power in watt added to every trace.
+     * @param periodic_window Wrap around period in second, or NaN to disable wrapping.
+     * @return One time domain optical power signal in watt per detector.
+     *
+     * @tparam Real Sample type of the traces, double or float. Pulse shapes are
+     *     always evaluated in double precision.
+     *
+     * @throws std::runtime_error If the input sizes are inconsistent or a velocity is non positive.
+     */
+    template <typename Real = double>
+    std::vector<std::vector<Real>> generate_multi_detector_pulses(
+        std::span<const double> velocities,
+        std::span<const double> pulse_centers,
+        std::span<const double> pulse_amplitudes,
+        const size_t number_of_detectors,
+        std::span<const double> time_array,
+        const double base_level,
+        const double periodic_window = std::numeric_limits<double>::quiet_NaN()
+    ) const;
+
     /**
      * @brief Compute the characteristic temporal width of the source kernel.
      *
@@ -354,10 +406,12 @@ public:
     ) const = 0;
 
     /**
-     * @brief Convolve a discrete signal with a kernel using zero padding.
+     * @brief Convolve a discrete signal with a kernel using reflected boundaries.
      *
-     * Samples outside the input signal support are treated as zero. The output has the
-     * same size as the input signal.
+     * Samples outside the input signal support are mirrored about the first and last
+     * samples. The output has the same size as the input signal. Long kernels are
+     * applied with an FFT overlap-save scheme, short ones with a direct loop (see
+     * utils::convolve_with_reflected_boundaries).
      *
      * @param signal Input signal.
      * @param kernel Convolution kernel.
@@ -366,8 +420,8 @@ public:
      * @throws std::runtime_error If signal or kernel is empty.
      */
     std::vector<double> convolve_with_kernel(
-        const std::vector<double>& signal,
-        const std::vector<double>& kernel
+        std::span<const double> signal,
+        std::span<const double> kernel
     ) const;
 
 
@@ -395,7 +449,26 @@ public:
      * its allowed range.
      */
     std::vector<double> get_gamma_trace(
-        const std::vector<double>& time_array,
+        std::span<const double> time_array,
+        double shape,
+        double scale,
+        double mean_velocity
+    ) const;
+
+    /**
+     * @brief Generate a gamma trace on a uniform time axis, without validating a time array.
+     *
+     * @param time_axis Uniform time axis in second, with at least two samples.
+     * @param shape Shape parameter of the gamma law. Must be strictly positive.
+     * @param scale Scale parameter of the gamma law in watt. Must be non negative.
+     * @param mean_velocity Mean particle velocity in meter / second. Must be strictly positive.
+     * @return Correlated optical power trace in watt.
+     *
+     * @throws std::runtime_error If the time axis has fewer than two samples, or if any
+     * parameter is outside its allowed range.
+     */
+    std::vector<double> get_gamma_trace(
+        const utils::TimeAxis& time_axis,
         double shape,
         double scale,
         double mean_velocity
@@ -419,6 +492,34 @@ protected:
      */
     virtual double get_amplitude_at_focus() const = 0;
 
+    /**
+     * @brief Accumulate multi detector pulses with the source specific envelope.
+     *
+     * @param signals Output signals, one per detector, accumulated in place.
+     * @param time_array Time axis in second.
+     * @param pulse_centers Pulse center times in second.
+     * @param pulse_widths Pulse widths in second as returned by get_particle_width.
+     * @param pulse_amplitudes Row major (n_events x n_detectors) amplitude matrix in watt.
+     */
+    virtual void accumulate_multi_detector_pulses(
+        std::vector<std::vector<double>>& signals,
+        std::span<const double> time_array,
+        std::span<const double> pulse_centers,
+        std::span<const double> pulse_widths,
+        std::span<const double> pulse_amplitudes
+    ) const = 0;
+
+    /**
+     * @brief Single precision counterpart of accumulate_multi_detector_pulses.
+     */
+    virtual void accumulate_multi_detector_pulses(
+        std::vector<std::vector<float>>& signals,
+        std::span<const double> time_array,
+        std::span<const double> pulse_centers,
+        std::span<const double> pulse_widths,
+        std::span<const double> pulse_amplitudes
+    ) const = 0;
+
     /**
      * @brief Evaluate the normalized spatial profile at one position.
      *
@@ -446,9 +547,9 @@ protected:
      * @throws std::runtime_error If the three vectors do not have the same length.
      */
     void validate_coordinate_vectors(
-        const std::vector<double>& x,
-        const std::vector<double>& y,
-        const std::vector<double>& z
+        std::span<const double> x,
+        std::span<const double> y,
+        std::span<const double> z
     ) const ;
 
     /**
@@ -464,9 +565,9 @@ protected:
      * @throws std::runtime_error If the vectors do not have the same length.
      */
     void validate_pulse_vectors(
-        const std::vector<double>& velocities,
-        const std::vector<double>& pulse_centers,
-        const std::vector<double>& pulse_amplitudes
+        std::span<const double> velocities,
+        std::span<const double> pulse_centers,
+        std::span<const double> pulse_amplitudes
     ) const;
 
     /**
@@ -477,7 +578,7 @@ protected:
      * @throws std::runtime_error If the vector is empty or contains a non positive value.
      */
     void validate_velocity_vector(
-        const std::vector<double>& velocity
+        std::span<const double> velocity
     ) const;
 };
 
@@ -493,6 +594,7 @@ class Gaussian : public BaseSource {
 public:
     double waist_y;   // [meter]
     double waist_z;   // [meter]
+    double pulse_support_cutoff = utils::pulse_synthesis::default_gaussian_support_cutoff;   // [sigma]
 
     /**
      * @brief Construct a Gaussian source.
@@ -532,6 +634,21 @@ public:
         const double waist_z
     );
 
+    /**
+     * @brief Set the half support used when synthesizing Gaussian pulses.
+     *
+     * Pulses are only evaluated on the samples lying within pulse_support_cutoff
+     * standard deviations of their center. An infinite value disables truncation and
+     * evaluates every pulse on the full time axis.
+     *
+     * @param pulse_support_cutoff Half support in units of the pulse standard deviation.
+     *
+     * @throws std::runtime_error If pulse_support_cutoff is not strictly positive.
+     */
+    void set_pulse_support_cutoff(
+        const double pulse_support_cutoff
+    );
+
     /**
      * @brief Compute Gaussian transit pulse widths for a set of particle velocities.
      *
@@ -542,9 +659,18 @@ public:
      * @return Transit widths in second.
      */
     std::vector<double> get_particle_width(
-        const std::vector<double>& velocity
+        std::span<const double> velocity
     ) const override;
 
+    /**
+     * @brief Pulses are truncated at pulse_support_cutoff standard deviations.
+     */
+    double get_pulse_half_support(
+        const double pulse_width
+    ) const override {
+        return this->pulse_support_cutoff * pulse_width;
+    }
+
     /**
      * @brief Return the Gaussian kernel width associated with a mean velocity.
      *
@@ -598,6 +724,11 @@ public:
      * pulse_amplitudes[index], and widened according to the corresponding particle
      * velocity.
      *
+     * Pulses are truncated at pulse_support_cutoff standard deviations and only
+     * evaluated on their own support, using the tiled engine of
+     * utils::pulse_synthesis. The cost therefore scales with the number of samples
+     * plus the summed pulse footprints rather than with their product.
+     *
      * @param velocities Particle velocities in meter / second.
      * @param pulse_centers Pulse center times in second.
      * @param pulse_amplitudes Pulse amplitudes in watt.
@@ -607,10 +738,10 @@ public:
      * @return Time domain optical power signal in watt.
      */
     std::vector<double> generate_pulses(
-        const std::vector<double>& velocities,
-        const std::vector<double>& pulse_centers,
-        const std::vector<double>& pulse_amplitudes,
-        const std::vector<double>& time_array,
+        std::span<const double> velocities,
+        std::span<const double> pulse_centers,
+        std::span<const double> pulse_amplitudes,
+        std::span<const double> time_array,
         const double base_level
     ) const override;
 
@@ -625,6 +756,25 @@ protected:
      */
     double get_amplitude_at_focus() const override;
 
+    /**
+     * @brief Accumulate truncated Gaussian pulses onto several detector traces.
+     */
+    void accumulate_multi_detector_pulses(
+        std::vector<std::vector<double>>& signals,
+        std::span<const double> time_array,
+        std::span<const double> pulse_centers,
+        std::span<const double> pulse_widths,
+        std::span<const double> pulse_amplitudes
+    ) const override;
+
+    void accumulate_multi_detector_pulses(
+        std::vector<std::vector<float>>& signals,
+        std::span<const double> time_array,
+        std::span<const double> pulse_centers,
+        std::span<const double> pulse_widths,
+        std::span<const double> pulse_amplitudes
+    ) const override;
+
     /**
      * @brief Evaluate the normalized Gaussian intensity profile.
      *
@@ -703,9 +853,18 @@ public:
      * @return Transit widths in second.
      */
     std::vector<double> get_particle_width(
-        const std::vector<double>& velocity
+        std::span<const double> velocity
     ) const override;
 
+    /**
+     * @brief Rectangular pulses span half their width on each side of their center.
+     */
+    double get_pulse_half_support(
+        const double pulse_width
+    ) const override {
+        return pulse_width / 2.0;
+    }
+
     /**
      * @brief Return the rectangular kernel width associated with a mean velocity.
      *
@@ -758,6 +917,9 @@ public:
      *
      * Each pulse contributes a constant amplitude over its support interval and zero
      * outside. The support width is set by the corresponding particle velocity.
+     * The pulses are accumulated from their rising and falling edges, so the cost
+     * does not grow with the overlap of wide pulses, see
+     * utils::pulse_synthesis::accumulate_rectangular_pulse_edges.
      *
      * @param velocities Particle velocities in meter / second.
      * @param pulse_centers Pulse center times in second.
@@ -767,10 +929,10 @@ public:
      * @return Time domain optical power signal in watt.
      */
     std::vector<double> generate_pulses(
-        const std::vector<double>& velocities,
-        const std::vector<double>& pulse_centers,
-        const std::vector<double>& pulse_amplitudes,
-        const std::vector<double>& time_array,
+        std::span<const double> velocities,
+        std::span<const double> pulse_centers,
+        std::span<const double> pulse_amplitudes,
+        std::span<const double> time_array,
         const double base_level
     ) const override;
 
@@ -785,6 +947,25 @@ protected:
      */
     double get_amplitude_at_focus() const override;
 
+    /**
+     * @brief Accumulate rectangular pulses onto several detector traces.
+     */
+    void accumulate_multi_detector_pulses(
+        std::vector<std::vector<double>>& signals,
+        std::span<const double> time_array,
+        std::span<const double> pulse_centers,
+        std::span<const double> pulse_widths,
+        std::span<const double> pulse_amplitudes
+    ) const override;
+
+    void accumulate_multi_detector_pulses(
+        std::vector<std::vector<float>>& signals,
+        std::span<const double> time_array,
+        std::span<const double> pulse_centers,
+        std::span<const double> pulse_widths,
+        std::span<const double> pulse_amplitudes
+    ) const override;
+
     /**
      * @brief Evaluate the normalized flat top intensity profile.
      *
@@ -1,8 +1,9 @@
 #include <pybind11/pybind11.h>
+#include <utils/module_binding.h>
 
 namespace py = pybind11;
 
-PYBIND11_MODULE(interface_pint, module) {
+FLOWCYPY_MODULE(interface_pint, module) {
     module.def(
         "set_ureg",
         [module](py::object ureg_object) mutable {
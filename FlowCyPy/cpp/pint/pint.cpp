@@ -1,7 +1,12 @@
 #include "pint.h"
 
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <mutex>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace py = pybind11;
 
@@ -48,6 +53,60 @@ namespace {
         mutable std::once_flag initialization_flag;
         py::object ureg = py::none();
     };
+
+    class ConversionFactorCache {
+    public:
+        static ConversionFactorCache& instance() {
+            static ConversionFactorCache singleton_instance;
+            return singleton_instance;
+        }
+
+        bool find(const std::string& key, double& factor) const {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            const auto iterator = factors.find(key);
+            if (iterator == factors.end()) {
+                return false;
+            }
+
+            factor = iterator->second;
+            return true;
+        }
+
+        void insert(const std::string& key, double factor) {
+            std::lock_guard<std::mutex> lock(mutex);
+            factors.emplace(key, factor);
+        }
+
+    private:
+        ConversionFactorCache() = default;
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, double> factors;
+    };
+
+    bool is_quantity(py::handle value) {
+        return py::hasattr(value, "magnitude") && py::hasattr(value, "units");
+    }
+
+    // The factor is the image of 1 and the conversion a pure scaling when 0 maps to 0.
+    double compute_conversion_factor(const py::object& registry, const py::object& units, const std::string& unit) {
+        py::object quantity_class = registry.attr("Quantity");
+
+        const double factor = py::cast<double>(quantity_class(1.0, units).attr("to")(unit).attr("magnitude"));
+        const double offset = py::cast<double>(quantity_class(0.0, units).attr("to")(unit).attr("magnitude"));
+
+        return offset == 0.0 ? factor : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    std::vector<double> array_to_vector(const contiguous_double_array& array) {
+        std::vector<double> output(static_cast<std::size_t>(array.size()));
+
+        if (!output.empty()) {
+            std::memcpy(output.data(), array.data(), output.size() * sizeof(double));
+        }
+
+        return output;
+    }
 }
 
 
@@ -102,7 +161,67 @@ py::object meters_quantity_with_ureg(const py::object& ureg, double meters_value
 }
 
 
+double get_conversion_factor(py::handle quantity, const std::string& unit) {
+    py::object registry = registry_from_quantity(quantity);
+    py::object units = py::reinterpret_borrow<py::object>(quantity).attr("units");
+
+    // Registries are few and live for the whole session, so their address disambiguates unit names.
+    const std::string key =
+        std::to_string(reinterpret_cast<std::uintptr_t>(registry.ptr())) + ":" +
+        py::str(units).cast<std::string>() + "->" + unit;
+
+    double factor = 0.0;
+    if (ConversionFactorCache::instance().find(key, factor)) {
+        return factor;
+    }
+
+    factor = compute_conversion_factor(registry, units, unit);
+    ConversionFactorCache::instance().insert(key, factor);
+    return factor;
+}
+
+
+contiguous_double_array quantity_to_array_in_units(py::handle quantity, const std::string& unit) {
+    if (!is_quantity(quantity)) {
+        throw py::type_error("expected a pint.Quantity (missing magnitude or units)");
+    }
+
+    const double factor = get_conversion_factor(quantity, unit);
+
+    if (std::isnan(factor)) {
+        py::object converted = py::reinterpret_borrow<py::object>(quantity).attr("to")(unit);
+        return contiguous_double_array::ensure(converted.attr("magnitude"));
+    }
+
+    contiguous_double_array magnitude = contiguous_double_array::ensure(quantity.attr("magnitude"));
+    if (!magnitude) {
+        throw py::error_already_set();
+    }
+
+    if (factor == 1.0) {
+        return magnitude;
+    }
+
+    contiguous_double_array scaled(std::vector<py::ssize_t>(magnitude.shape(), magnitude.shape() + magnitude.ndim()));
+
+    const double* input = magnitude.data();
+    double* output = scaled.mutable_data();
+    const py::ssize_t size = magnitude.size();
+
+    #pragma omp simd
+    for (py::ssize_t index = 0; index < size; ++index) {
+        output[index] = input[index] * factor;
+    }
+
+    return scaled;
+}
+
+
 std::vector<double> to_vector_units(py::handle values, const std::string& unit) {
+    if (is_quantity(values)) {
+        return array_to_vector(quantity_to_array_in_units(values, unit));
+    }
+
     if (!py::hasattr(values, "__iter__")) {
         throw py::type_error("expected an iterable of pint.Quantity objects");
     }
@@ -114,22 +233,31 @@ std::vector<double> to_vector_units(py::handle values, const std::string& unit)
         magnitudes.reserve(py::len(values));
     }
 
+    // Elements usually share their units, so the factor is looked up again only when they change.
+    py::object previous_units = py::none();
+    double factor = std::numeric_limits<double>::quiet_NaN();
+
     for (py::handle item : py::reinterpret_borrow<py::iterable>(values)) {
         if (py::isinstance<py::int_>(item) || py::isinstance<py::float_>(item)) {
             throw py::type_error("expected pint.Quantity elements (numbers without units are not accepted)");
         }
-        if (!py::hasattr(item, "to")) {
-            throw py::type_error("expected pint.Quantity elements (missing .to method)");
+        if (!is_quantity(item)) {
+            throw py::type_error("expected pint.Quantity elements (missing magnitude or units)");
         }
 
-        py::object quantity = py::reinterpret_borrow<py::object>(item);
-        py::object converted = quantity.attr("to")(unit);
+        py::object units = item.attr("units");
+
+        if (previous_units.is_none() || !units.equal(previous_units)) {
+            factor = get_conversion_factor(item, unit);
+            previous_units = units;
+        }
 
-        if (!py::hasattr(converted, "magnitude")) {
-            throw py::type_error("quantity.to(unit) did not return an object with a magnitude attribute");
+        if (std::isnan(factor)) {
+            magnitudes.push_back(py::cast<double>(item.attr("to")(unit).attr("magnitude")));
+            continue;
         }
 
-        magnitudes.push_back(py::cast<double>(converted.attr("magnitude")));
+        magnitudes.push_back(py::cast<double>(item.attr("magnitude")) * factor);
     }
 
     return magnitudes;
@@ -137,35 +265,23 @@ std::vector<double> to_vector_units(py::handle values, const std::string& unit)
 
 
 double quantity_scalar_to_meters(py::object quantity) {
-    py::object ureg = get_shared_ureg();
-    py::object meter = ureg.attr("meter");
-    py::object converted = quantity.attr("to")(meter);
-    return py::float_(converted.attr("magnitude"));
-}
+    const double factor = get_conversion_factor(quantity, "meter");
 
-std::vector<double> quantity_1d_to_meters_vector(py::object quantity) {
-    py::object ureg = get_shared_ureg();
-    py::object meter = ureg.attr("meter");
+    if (std::isnan(factor)) {
+        return py::float_(quantity.attr("to")("meter").attr("magnitude"));
+    }
 
-    py::object converted = quantity.attr("to")(meter);
-    py::object magnitude = converted.attr("magnitude");
+    return py::cast<double>(quantity.attr("magnitude")) * factor;
+}
 
-    py::module_ numpy = py::module_::import("numpy");
-    py::object float64 = numpy.attr("float64");
+std::vector<double> quantity_1d_to_meters_vector(py::object quantity) {
+    const contiguous_double_array radii = quantity_to_array_in_units(quantity, "meter");
 
-    py::array magnitude_array = py::array::ensure(numpy.attr("asarray")(magnitude, float64));
-    if (!magnitude_array || magnitude_array.ndim() != 1) {
+    if (!radii || radii.ndim() != 1) {
         throw py::value_error("radii must be a one dimensional quantity array.");
     }
 
-    py::array_t<double, py::array::c_style | py::array::forcecast> radii_double(magnitude_array);
-    auto buf = radii_double.unchecked<1>();
-
-    std::vector<double> out(static_cast<std::size_t>(buf.shape(0)));
-    for (py::ssize_t i = 0; i < buf.shape(0); ++i) {
-        out[static_cast<std::size_t>(i)] = buf(i);
-    }
-    return out;
+    return array_to_vector(radii);
 }
 
 std::vector<double> array_like_1d_to_double_vector(py::object values) {
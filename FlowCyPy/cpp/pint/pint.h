@@ -8,6 +8,8 @@
 #include <pybind11/stl.h>       // for py::cast with STL containers
 #include <pybind11/numpy.h>     // for py::array
 
+using contiguous_double_array = pybind11::array_t<double, pybind11::array::c_style | pybind11::array::forcecast>;
+
 namespace py = pybind11;
 
 
@@ -39,9 +41,31 @@ Function to create a pint.Quantity object in meters from a double value.
 */
 py::object meters_quantity_with_ureg(const py::object& ureg, double meters_value);
 
+/*
+Function to retrieve the factor converting the magnitude of a pint.Quantity to a target unit.
+Factors are computed once per (registry, source unit, target unit) and cached.
+@param quantity A pint.Quantity object, scalar or array.
+@param unit A string representing the target unit (e.g., "meter").
+@returns The multiplicative factor, or NaN when the conversion is not a pure scaling (e.g., degC to kelvin).
+@throws py::error_already_set If the units are not compatible.
+*/
+double get_conversion_factor(py::handle quantity, const std::string& unit);
+
+/*
+Function to view the magnitude of a pint.Quantity as a C contiguous float64 array in specified units.
+The magnitude is scaled in C++ with a cached factor rather than through pint.
+@param quantity A pint.Quantity object wrapping a scalar or a numpy array.
+@param unit A string representing the target unit (e.g., "volt").
+@returns The magnitude array itself, without copy, when it is already float64, contiguous and in the target unit;
+         otherwise a new array. The result must be treated as read only.
+@throws py::type_error If quantity is not a pint.Quantity.
+*/
+contiguous_double_array quantity_to_array_in_units(py::handle quantity, const std::string& unit);
+
 /*
 Function to convert an iterable of pint.Quantity objects to a std::vector<double> in specified units.
-@param values An iterable of pint.Quantity objects.
+A pint.Quantity wrapping a numpy array is converted in one pass with quantity_to_array_in_units.
+@param values A pint.Quantity array or an iterable of pint.Quantity objects.
 @param unit A string representing the target unit (e.g., "meter").
 @returns std::vector<double> with the magnitudes in the specified unit.
 */
@@ -0,0 +1,634 @@
+#include "acquisition_file.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+
+#ifdef FLOWCYPY_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+
+static_assert(std::endian::native == std::endian::little, "The acquisition file format is little endian.");
+
+
+namespace {
+
+constexpr char file_magic[8] = {'F', 'C', 'P', 'Y', 'A', 'C', 'Q', 'F'};
+constexpr uint64_t file_version = 2;
+constexpr uint64_t block_alignment = 64;
+
+// magic, version, index offset, index size, then padding up to the first block.
+constexpr uint64_t preamble_size = 64;
+constexpr uint64_t index_offset_position = sizeof(file_magic) + sizeof(uint64_t);
+
+template <typename T>
+void write_value(std::ofstream& stream, const T& value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void write_string(std::ofstream& stream, const std::string& value) {
+    write_value(stream, static_cast<uint64_t>(value.size()));
+    stream.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+template <typename T>
+T read_value(std::span<const std::byte> bytes, size_t& cursor) {
+    if (bytes.size() - cursor < sizeof(T)) {
+        throw std::runtime_error("AcquisitionFile: truncated index.");
+    }
+
+    T value;
+    std::memcpy(&value, bytes.data() + cursor, sizeof(T));
+    cursor += sizeof(T);
+
+    return value;
+}
+
+std::string read_string(std::span<const std::byte> bytes, size_t& cursor) {
+    const uint64_t size = read_value<uint64_t>(bytes, cursor);
+
+    if (bytes.size() - cursor < size) {
+        throw std::runtime_error("AcquisitionFile: truncated index.");
+    }
+
+    std::string value(reinterpret_cast<const char*>(bytes.data() + cursor), size);
+    cursor += size;
+
+    return value;
+}
+
+size_t get_code_size(const CodeType code_type) {
+    switch (code_type) {
+        case CodeType::int8:
+        case CodeType::uint8:
+            return 1;
+        case CodeType::int16:
+        case CodeType::uint16:
+            return 2;
+        case CodeType::int32:
+        case CodeType::uint32:
+            return 4;
+        case CodeType::int64:
+        case CodeType::uint64:
+            return 8;
+    }
+
+    throw std::runtime_error("AcquisitionFile: unknown code type.");
+}
+
+CodeBuffer make_code_buffer(const CodeType code_type) {
+    switch (code_type) {
+        case CodeType::int8: return std::vector<int8_t>{};
+        case CodeType::uint8: return std::vector<uint8_t>{};
+        case CodeType::int16: return std::vector<int16_t>{};
+        case CodeType::uint16: return std::vector<uint16_t>{};
+        case CodeType::int32: return std::vector<int32_t>{};
+        case CodeType::uint32: return std::vector<uint32_t>{};
+        case CodeType::int64: return std::vector<int64_t>{};
+        case CodeType::uint64: return std::vector<uint64_t>{};
+    }
+
+    throw std::runtime_error("AcquisitionFile: unknown code type.");
+}
+
+void check_compression_support(const AcquisitionCompression compression) {
+#ifndef FLOWCYPY_HAS_ZSTD
+    if (compression == AcquisitionCompression::zstd) {
+        throw std::runtime_error("AcquisitionFile: zstd compression is not available in this build.");
+    }
+#endif
+}
+
+}  // namespace
+
+
+// ------------------------------- writer -------------------------------
+
+AcquisitionFileWriter::AcquisitionFileWriter(
+    const std::string& filename,
+    const Digitizer& digitizer,
+    const std::vector<std::string>& channel_names,
+    const AcquisitionCompression compression,
+    const int compression_level
+)
+    : filename(filename),
+      compression_level(compression_level)
+{
+    check_compression_support(compression);
+
+    if (!digitizer.should_digitize()) {
+        throw std::runtime_error("AcquisitionFile: the digitizer must have a non zero bit_depth.");
+    }
+
+    this->header.sampling_rate = digitizer.sampling_rate;
+    this->header.bit_depth = digitizer.bit_depth;
+    this->header.code_type = digitizer.get_code_type();
+    this->header.minimum_code = digitizer.get_minimum_code();
+    this->header.maximum_code = digitizer.get_maximum_code();
+    this->header.compression = compression;
+
+    for (const std::string& channel_name : channel_names) {
+        const bool repeated = std::any_of(
+            this->header.channels.begin(),
+            this->header.channels.end(),
+            [&](const AcquisitionChannelInfo& channel) { return channel.name == channel_name; }
+        );
+
+        if (repeated) {
+            throw std::runtime_error("AcquisitionFile: channel '" + channel_name + "' is repeated.");
+        }
+
+        AcquisitionChannelInfo channel;
+        channel.name = channel_name;
+        this->header.channels.push_back(std::move(channel));
+    }
+
+    // The buffer must be installed before the file is opened.
+    this->stream_buffer.resize(stream_buffer_size);
+    this->stream.rdbuf()->pubsetbuf(this->stream_buffer.data(), static_cast<std::streamsize>(this->stream_buffer.size()));
+    this->stream.open(filename, std::ios::binary | std::ios::trunc);
+
+    if (!this->stream) {
+        throw std::runtime_error("AcquisitionFile: cannot create '" + filename + "'.");
+    }
+
+    // The index location stays zero until close(), marking the file as incomplete.
+    this->stream.write(file_magic, sizeof(file_magic));
+    write_value(this->stream, file_version);
+
+    const std::vector<char> padding(preamble_size - sizeof(file_magic) - sizeof(uint64_t), 0);
+    this->stream.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+}
+
+
+AcquisitionFileWriter::~AcquisitionFileWriter() {
+    try {
+        this->close();
+    } catch (...) {
+    }
+}
+
+
+void AcquisitionFileWriter::append_chunk(const std::map<std::string, DigitizedChannel>& channels) {
+    if (this->closed) {
+        throw std::runtime_error("AcquisitionFile: cannot append to a closed file.");
+    }
+
+    const size_t code_size = get_code_size(this->header.code_type);
+
+    ChunkRecord chunk;
+    chunk.first_sample = this->number_of_samples;
+    chunk.number_of_samples = 0;
+
+    // Validate the whole chunk before writing any of it.
+    for (size_t channel_index = 0; channel_index < this->header.channels.size(); ++channel_index) {
+        const AcquisitionChannelInfo& info = this->header.channels[channel_index];
+        const auto iterator = channels.find(info.name);
+
+        if (iterator == channels.end()) {
+            throw std::runtime_error("AcquisitionFile: chunk has no channel '" + info.name + "'.");
+        }
+
+        const DigitizedChannel& channel = iterator->second;
+
+        if (channel.codes.index() != static_cast<size_t>(this->header.code_type)) {
+            throw std::runtime_error("AcquisitionFile: channel '" + info.name + "' does not hold codes of the file type.");
+        }
+
+        const size_t size = std::visit([](const auto& codes) { return codes.size(); }, channel.codes);
+
+        if (channel_index == 0) {
+            chunk.number_of_samples = size;
+        } else if (size != chunk.number_of_samples) {
+            throw std::runtime_error("AcquisitionFile: channels of a chunk must have the same number of samples.");
+        }
+
+        if (this->scales_fixed && (channel.code_to_volt_scale != info.code_to_volt_scale || channel.code_to_volt_offset != info.code_to_volt_offset)) {
+            throw std::runtime_error("AcquisitionFile: the voltage range of channel '" + info.name + "' changed between chunks.");
+        }
+    }
+
+    if (!this->scales_fixed) {
+        for (AcquisitionChannelInfo& info : this->header.channels) {
+            const DigitizedChannel& channel = channels.at(info.name);
+
+            info.code_to_volt_scale = channel.code_to_volt_scale;
+            info.code_to_volt_offset = channel.code_to_volt_offset;
+            info.minimum_voltage = channel.code_to_volt_scale * static_cast<double>(this->header.minimum_code) + channel.code_to_volt_offset;
+            info.maximum_voltage = channel.code_to_volt_scale * static_cast<double>(this->header.maximum_code) + channel.code_to_volt_offset;
+        }
+
+        this->scales_fixed = true;
+    }
+
+    if (chunk.number_of_samples == 0) {
+        return;
+    }
+
+    for (const AcquisitionChannelInfo& info : this->header.channels) {
+        const DigitizedChannel& channel = channels.at(info.name);
+
+        const auto [data, raw_size] = std::visit(
+            [code_size](const auto& codes) {
+                return std::pair<const char*, size_t>(reinterpret_cast<const char*>(codes.data()), codes.size() * code_size);
+            },
+            channel.codes
+        );
+
+        const uint64_t position = static_cast<uint64_t>(this->stream.tellp());
+        const uint64_t aligned_position = (position + block_alignment - 1) / block_alignment * block_alignment;
+
+        const std::vector<char> padding(aligned_position - position, 0);
+        this->stream.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+        uint64_t stored_size = raw_size;
+
+        if (this->header.compression == AcquisitionCompression::zstd) {
+#ifdef FLOWCYPY_HAS_ZSTD
+            std::vector<char> compressed(ZSTD_compressBound(raw_size));
+
+            const size_t compressed_size = ZSTD_compress(compressed.data(), compressed.size(), data, raw_size, this->compression_level);
+
+            if (ZSTD_isError(compressed_size)) {
+                throw std::runtime_error(std::string("AcquisitionFile: zstd compression failed: ") + ZSTD_getErrorName(compressed_size));
+            }
+
+            this->stream.write(compressed.data(), static_cast<std::streamsize>(compressed_size));
+            stored_size = compressed_size;
+#endif
+        } else {
+            this->stream.write(data, static_cast<std::streamsize>(raw_size));
+        }
+
+        chunk.offsets.push_back(aligned_position);
+        chunk.stored_sizes.push_back(stored_size);
+    }
+
+    if (!this->stream) {
+        throw std::runtime_error("AcquisitionFile: cannot write to '" + this->filename + "'.");
+    }
+
+    this->number_of_samples += chunk.number_of_samples;
+    this->chunks.push_back(std::move(chunk));
+}
+
+
+void AcquisitionFileWriter::add_event(const size_t start_index, const size_t number_of_samples) {
+    this->events.push_back({start_index, number_of_samples});
+}
+
+
+void AcquisitionFileWriter::append_event_metrics(const AcquisitionEventMetrics& metrics) {
+    for (const auto& [channel_name, channel_metrics] : metrics) {
+        for (const auto& [metric_name, values] : channel_metrics) {
+            std::vector<double>& output = this->event_metrics[channel_name][metric_name];
+            output.insert(output.end(), values.begin(), values.end());
+        }
+    }
+}
+
+
+void AcquisitionFileWriter::close() {
+    if (this->closed) {
+        return;
+    }
+
+    this->closed = true;
+
+    const uint64_t index_offset = static_cast<uint64_t>(this->stream.tellp());
+
+    write_value(this->stream, this->header.sampling_rate);
+    write_value(this->stream, static_cast<uint64_t>(this->header.bit_depth));
+    write_value(this->stream, static_cast<uint64_t>(this->header.code_type));
+    write_value(this->stream, this->header.minimum_code);
+    write_value(this->stream, this->header.maximum_code);
+    write_value(this->stream, static_cast<uint64_t>(this->header.compression));
+
+    write_value(this->stream, static_cast<uint64_t>(this->header.channels.size()));
+
+    for (const AcquisitionChannelInfo& channel : this->header.channels) {
+        write_string(this->stream, channel.name);
+        write_string(this->stream, channel.units);
+        write_value(this->stream, channel.code_to_volt_scale);
+        write_value(this->stream, channel.code_to_volt_offset);
+        write_value(this->stream, channel.minimum_voltage);
+        write_value(this->stream, channel.maximum_voltage);
+    }
+
+    write_value(this->stream, static_cast<uint64_t>(this->number_of_samples));
+    write_value(this->stream, static_cast<uint64_t>(this->chunks.size()));
+
+    for (const ChunkRecord& chunk : this->chunks) {
+        write_value(this->stream, chunk.first_sample);
+        write_value(this->stream, chunk.number_of_samples);
+
+        for (size_t channel_index = 0; channel_index < chunk.offsets.size(); ++channel_index) {
+            write_value(this->stream, chunk.offsets[channel_index]);
+            write_value(this->stream, chunk.stored_sizes[channel_index]);
+        }
+    }
+
+    write_value(this->stream, static_cast<uint64_t>(this->events.size()));
+
+    for (const AcquisitionFileEvent& event : this->events) {
+        write_value(this->stream, static_cast<uint64_t>(event.start_index));
+        write_value(this->stream, static_cast<uint64_t>(event.number_of_samples));
+    }
+
+    write_value(this->stream, static_cast<uint64_t>(this->event_metrics.size()));
+
+    for (const auto& [channel_name, channel_metrics] : this->event_metrics) {
+        write_string(this->stream, channel_name);
+        write_value(this->stream, static_cast<uint64_t>(channel_metrics.size()));
+
+        for (const auto& [metric_name, values] : channel_metrics) {
+            write_string(this->stream, metric_name);
+            write_value(this->stream, static_cast<uint64_t>(values.size()));
+            this->stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(double)));
+        }
+    }
+
+    const uint64_t index_size = static_cast<uint64_t>(this->stream.tellp()) - index_offset;
+
+    this->file_size = static_cast<size_t>(index_offset + index_size);
+
+    this->stream.seekp(static_cast<std::streamoff>(index_offset_position));
+    write_value(this->stream, index_offset);
+    write_value(this->stream, index_size);
+
+    this->stream.close();
+
+    if (!this->stream) {
+        throw std::runtime_error("AcquisitionFile: cannot write to '" + this->filename + "'.");
+    }
+}
+
+
+// ------------------------------- reader -------------------------------
+
+AcquisitionFileReader::AcquisitionFileReader(const std::string& filename)
+    : file(std::make_unique<utils::MappedFile>(filename))
+{
+    const std::span<const std::byte> bytes = this->file->bytes();
+
+    if (bytes.size() < preamble_size || std::memcmp(bytes.data(), file_magic, sizeof(file_magic)) != 0) {
+        throw std::runtime_error("AcquisitionFile: '" + filename + "' is not an acquisition file.");
+    }
+
+    size_t cursor = sizeof(file_magic);
+
+    if (read_value<uint64_t>(bytes, cursor) != file_version) {
+        throw std::runtime_error("AcquisitionFile: unsupported file version.");
+    }
+
+    const uint64_t index_offset = read_value<uint64_t>(bytes, cursor);
+    const uint64_t index_size = read_value<uint64_t>(bytes, cursor);
+
+    if (index_offset == 0) {
+        throw std::runtime_error("AcquisitionFile: '" + filename + "' was not closed by its writer.");
+    }
+
+    if (index_offset < preamble_size || index_offset > bytes.size() || bytes.size() - index_offset < index_size) {
+        throw std::runtime_error("AcquisitionFile: truncated index.");
+    }
+
+    const std::span<const std::byte> index = bytes.subspan(index_offset, index_size);
+    cursor = 0;
+
+    this->header.sampling_rate = read_value<double>(index, cursor);
+    this->header.bit_depth = read_value<uint64_t>(index, cursor);
+
+    const uint64_t code_type = read_value<uint64_t>(index, cursor);
+
+    if (code_type > static_cast<uint64_t>(CodeType::uint64)) {
+        throw std::runtime_error("AcquisitionFile: unknown code type.");
+    }
+
+    this->header.code_type = static_cast<CodeType>(code_type);
+    this->header.minimum_code = read_value<int64_t>(index, cursor);
+    this->header.maximum_code = read_value<int64_t>(index, cursor);
+
+    const uint64_t compression = read_value<uint64_t>(index, cursor);
+
+    if (compression > static_cast<uint64_t>(AcquisitionCompression::zstd)) {
+        throw std::runtime_error("AcquisitionFile: unknown compression.");
+    }
+
+    this->header.compression = static_cast<AcquisitionCompression>(compression);
+    check_compression_support(this->header.compression);
+
+    const uint64_t number_of_channels = read_value<uint64_t>(index, cursor);
+
+    for (uint64_t channel_index = 0; channel_index < number_of_channels; ++channel_index) {
+        AcquisitionChannelInfo channel;
+        channel.name = read_string(index, cursor);
+        channel.units = read_string(index, cursor);
+        channel.code_to_volt_scale = read_value<double>(index, cursor);
+        channel.code_to_volt_offset = read_value<double>(index, cursor);
+        channel.minimum_voltage = read_value<double>(index, cursor);
+        channel.maximum_voltage = read_value<double>(index, cursor);
+
+        this->header.channels.push_back(std::move(channel));
+    }
+
+    this->number_of_samples = read_value<uint64_t>(index, cursor);
+
+    const uint64_t number_of_chunks = read_value<uint64_t>(index, cursor);
+    const size_t code_size = get_code_size(this->header.code_type);
+
+    uint64_t expected_first_sample = 0;
+
+    for (uint64_t chunk_index = 0; chunk_index < number_of_chunks; ++chunk_index) {
+        ChunkRecord chunk;
+        chunk.first_sample = read_value<uint64_t>(index, cursor);
+        chunk.number_of_samples = read_value<uint64_t>(index, cursor);
+
+        if (chunk.first_sample != expected_first_sample) {
+            throw std::runtime_error("AcquisitionFile: chunks are not contiguous.");
+        }
+
+        expected_first_sample += chunk.number_of_samples;
+
+        for (uint64_t channel_index = 0; channel_index < number_of_channels; ++channel_index) {
+            const uint64_t offset = read_value<uint64_t>(index, cursor);
+            const uint64_t stored_size = read_value<uint64_t>(index, cursor);
+
+            if (offset > index_offset || index_offset - offset < stored_size) {
+                throw std::runtime_error("AcquisitionFile: channel block outside of the data section.");
+            }
+
+            if (this->header.compression == AcquisitionCompression::none && stored_size != chunk.number_of_samples * code_size) {
+                throw std::runtime_error("AcquisitionFile: channel block size does not match its chunk.");
+            }
+
+            chunk.offsets.push_back(offset);
+            chunk.stored_sizes.push_back(stored_size);
+        }
+
+        this->chunks.push_back(std::move(chunk));
+    }
+
+    if (expected_first_sample != this->number_of_samples) {
+        throw std::runtime_error("AcquisitionFile: chunks do not cover the acquisition.");
+    }
+
+    const uint64_t number_of_events = read_value<uint64_t>(index, cursor);
+
+    for (uint64_t event_index = 0; event_index < number_of_events; ++event_index) {
+        AcquisitionFileEvent event;
+        event.start_index = read_value<uint64_t>(index, cursor);
+        event.number_of_samples = read_value<uint64_t>(index, cursor);
+
+        this->events.push_back(event);
+    }
+
+    const uint64_t number_of_metric_channels = read_value<uint64_t>(index, cursor);
+
+    for (uint64_t channel_index = 0; channel_index < number_of_metric_channels; ++channel_index) {
+        std::map<std::string, std::vector<double>>& channel_metrics = this->event_metrics[read_string(index, cursor)];
+
+        const uint64_t number_of_metrics = read_value<uint64_t>(index, cursor);
+
+        for (uint64_t metric_index = 0; metric_index < number_of_metrics; ++metric_index) {
+            std::vector<double>& values = channel_metrics[read_string(index, cursor)];
+            const uint64_t number_of_values = read_value<uint64_t>(index, cursor);
+
+            if ((index.size() - cursor) / sizeof(double) < number_of_values) {
+                throw std::runtime_error("AcquisitionFile: truncated index.");
+            }
+
+            values.resize(number_of_values);
+            std::memcpy(values.data(), index.data() + cursor, number_of_values * sizeof(double));
+            cursor += number_of_values * sizeof(double);
+        }
+    }
+}
+
+
+std::vector<std::string> AcquisitionFileReader::get_channel_names() const {
+    std::vector<std::string> channel_names;
+    channel_names.reserve(this->header.channels.size());
+
+    for (const AcquisitionChannelInfo& channel : this->header.channels) {
+        channel_names.push_back(channel.name);
+    }
+
+    return channel_names;
+}
+
+
+size_t AcquisitionFileReader::get_channel_index(const std::string& channel_name) const {
+    for (size_t channel_index = 0; channel_index < this->header.channels.size(); ++channel_index) {
+        if (this->header.channels[channel_index].name == channel_name) {
+            return channel_index;
+        }
+    }
+
+    throw std::out_of_range("AcquisitionFile: no channel named '" + channel_name + "'.");
+}
+
+
+template <typename Visitor>
+void AcquisitionFileReader::for_each_chunk(
+    const size_t channel_index,
+    const size_t first_sample,
+    const size_t count,
+    Visitor&& visit
+) const {
+    if (first_sample > this->number_of_samples || this->number_of_samples - first_sample < count) {
+        throw std::out_of_range("AcquisitionFile: requested samples exceed the acquisition.");
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    const size_t code_size = get_code_size(this->header.code_type);
+    const std::span<const std::byte> bytes = this->file->bytes();
+    const size_t last_sample = first_sample + count;
+
+    // Last chunk starting at or before first_sample.
+    auto chunk = std::upper_bound(
+        this->chunks.begin(),
+        this->chunks.end(),
+        first_sample,
+        [](const size_t sample, const ChunkRecord& record) { return sample < record.first_sample; }
+    ) - 1;
+
+    std::vector<std::byte> decompressed;
+
+    for (; chunk != this->chunks.end() && chunk->first_sample < last_sample; ++chunk) {
+        std::span<const std::byte> block = bytes.subspan(chunk->offsets[channel_index], chunk->stored_sizes[channel_index]);
+
+        if (this->header.compression == AcquisitionCompression::zstd) {
+#ifdef FLOWCYPY_HAS_ZSTD
+            decompressed.resize(chunk->number_of_samples * code_size);
+
+            const size_t decompressed_size = ZSTD_decompress(decompressed.data(), decompressed.size(), block.data(), block.size());
+
+            if (ZSTD_isError(decompressed_size) || decompressed_size != decompressed.size()) {
+                throw std::runtime_error("AcquisitionFile: corrupted zstd block.");
+            }
+
+            block = decompressed;
+#endif
+        }
+
+        const size_t begin = std::max<size_t>(first_sample, chunk->first_sample);
+        const size_t end = std::min<size_t>(last_sample, chunk->first_sample + chunk->number_of_samples);
+
+        visit(begin - first_sample, block.subspan((begin - chunk->first_sample) * code_size, (end - begin) * code_size));
+    }
+}
+
+
+CodeBuffer AcquisitionFileReader::read_channel_codes(
+    const std::string& channel_name,
+    const size_t first_sample,
+    const size_t count
+) const {
+    const size_t channel_index = this->get_channel_index(channel_name);
+
+    CodeBuffer output = make_code_buffer(this->header.code_type);
+
+    std::visit(
+        [&](auto& codes) {
+            codes.resize(count);
+
+            this->for_each_chunk(channel_index, first_sample, count, [&](const size_t position, std::span<const std::byte> block) {
+                std::memcpy(codes.data() + position, block.data(), block.size());
+            });
+        },
+        output
+    );
+
+    return output;
+}
+
+
+std::vector<double> AcquisitionFileReader::read_channel_volts(
+    const std::string& channel_name,
+    const size_t first_sample,
+    const size_t count
+) const {
+    const AcquisitionChannelInfo& channel = this->header.channels[this->get_channel_index(channel_name)];
+    const CodeBuffer codes = this->read_channel_codes(channel_name, first_sample, count);
+
+    std::vector<double> volts(count);
+
+    std::visit(
+        [&](const auto& values) {
+            for (size_t index = 0; index < count; ++index) {
+                volts[index] = channel.code_to_volt_scale * static_cast<double>(values[index]) + channel.code_to_volt_offset;
+            }
+        },
+        codes
+    );
+
+    return volts;
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <opto_electronics/digitizer/digitizer.h>
+#include <utils/mapped_file.h>
+
+
+/**
+ * @brief Compression applied to every channel block of an acquisition file.
+ */
+enum class AcquisitionCompression {
+    none,
+    zstd
+};
+
+
+/**
+ * @brief Description of one channel of an acquisition file.
+ *
+ * voltage = code_to_volt_scale * code + code_to_volt_offset
+ */
+struct AcquisitionChannelInfo {
+    std::string name;
+    std::string units = "volt";
+    double code_to_volt_scale = 0.0;
+    double code_to_volt_offset = 0.0;
+    double minimum_voltage = 0.0;
+    double maximum_voltage = 0.0;
+};
+
+
+/**
+ * @brief Header of an acquisition file: the digitizer settings and the channels.
+ */
+struct AcquisitionFileHeader {
+    double sampling_rate = 0.0;     // [hertz]
+    size_t bit_depth = 0;
+    CodeType code_type = CodeType::uint8;
+    int64_t minimum_code = 0;
+    int64_t maximum_code = 0;
+    AcquisitionCompression compression = AcquisitionCompression::none;
+    std::vector<AcquisitionChannelInfo> channels;
+};
+
+
+/**
+ * @brief Triggered window recorded in an acquisition file.
+ */
+struct AcquisitionFileEvent {
+    size_t start_index = 0;
+    size_t number_of_samples = 0;
+};
+
+
+/**
+ * @brief Peak metrics of the recorded events, keyed by channel then metric name.
+ *
+ * Metric vectors are event major, as in EventMetricDictionary: a fixed number of
+ * values per event, in the order of the event table.
+ */
+using AcquisitionEventMetrics = std::map<std::string, std::map<std::string, std::vector<double>>>;
+
+
+/**
+ * @brief Streaming writer of the chunked, columnar acquisition file format.
+ *
+ * The file holds the integer ADC codes of every channel, chunk after chunk, as
+ * appended by the acquisition:
+ *
+ *     preamble   64 bytes: magic, version, offset and size of the index
+ *     chunks     one block per channel and chunk, each starting on a 64 byte boundary
+ *     index      header, chunk table, event table and event metrics
+ *
+ * Blocks hold the codes in the little endian integer type of the digitizer, or a
+ * zstd frame of them when compression is enabled. The index is written by
+ * close(), and the preamble then patched to point at it, so a file whose writer
+ * did not close is rejected by the reader rather than read truncated. Writes go
+ * through a stream buffer of stream_buffer_size bytes, so blocks reach the file
+ * in a few large sequential writes.
+ */
+class AcquisitionFileWriter {
+public:
+    static constexpr size_t stream_buffer_size = size_t{1} << 22;
+
+    /**
+     * @param filename Path of the file, overwritten if it exists.
+     * @param digitizer Digitizer producing the codes; sets the sampling rate, bit depth and code type.
+     * @param channel_names Names of the channels, in the order of the file.
+     * @param compression Compression of the channel blocks.
+     * @param compression_level Compression level, used with zstd only.
+     *
+     * @throws std::runtime_error If the digitizer does not digitize, if a channel
+     *     name is repeated, if the file cannot be created, or if zstd is requested
+     *     in a build without zstd.
+     */
+    AcquisitionFileWriter(
+        const std::string& filename,
+        const Digitizer& digitizer,
+        const std::vector<std::string>& channel_names,
+        const AcquisitionCompression compression = AcquisitionCompression::none,
+        const int compression_level = 3
+    );
+
+    ~AcquisitionFileWriter();
+
+    AcquisitionFileWriter(const AcquisitionFileWriter&) = delete;
+    AcquisitionFileWriter& operator=(const AcquisitionFileWriter&) = delete;
+
+    /**
+     * @brief Append one chunk of codes, the same number of samples for every channel.
+     *
+     * The code to volt map of each channel is taken from the first chunk; the
+     * voltage ranges must stay fixed for the rest of the file.
+     *
+     * @param channels Digitized channels, keyed by name, as from Digitizer::get_processed_code_data_map.
+     *
+     * @throws std::runtime_error If a channel is missing, if the channels differ in
+     *     size or code type, if a code to volt map changes, or if the file is closed.
+     */
+    void append_chunk(const std::map<std::string, DigitizedChannel>& channels);
+
+    /**
+     * @brief Record a triggered window of the acquisition.
+     */
+    void add_event(const size_t start_index, const size_t number_of_samples);
+
+    /**
+     * @brief Append the peak metrics of the latest events, e.g. from BasePeakLocator::run_segment_offsets.
+     */
+    void append_event_metrics(const AcquisitionEventMetrics& metrics);
+
+    /**
+     * @brief Write the index and close the file. Further calls do nothing.
+     *
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void close();
+
+    const AcquisitionFileHeader& get_header() const { return this->header; }
+    size_t get_number_of_samples() const { return this->number_of_samples; }
+    size_t get_number_of_chunks() const { return this->chunks.size(); }
+
+    /// Size of the file in byte, once closed.
+    size_t get_file_size() const { return this->file_size; }
+
+private:
+    struct ChunkRecord {
+        uint64_t first_sample;
+        uint64_t number_of_samples;
+        std::vector<uint64_t> offsets;
+        std::vector<uint64_t> stored_sizes;
+    };
+
+    std::string filename;
+    std::vector<char> stream_buffer;
+    std::ofstream stream;
+    AcquisitionFileHeader header;
+    int compression_level;
+    bool scales_fixed = false;
+    bool closed = false;
+    size_t number_of_samples = 0;
+    size_t file_size = 0;
+    std::vector<ChunkRecord> chunks;
+    std::vector<AcquisitionFileEvent> events;
+    AcquisitionEventMetrics event_metrics;
+};
+
+
+/**
+ * @brief Lazy reader of an acquisition file.
+ *
+ * The file is memory mapped and only the index is parsed on opening; samples
+ * are decoded from the mapped blocks when they are requested, one chunk at a
+ * time, so archived runs far larger than memory can be reprocessed. Reads are
+ * const and do not share state, so a reader can serve several threads.
+ */
+class AcquisitionFileReader {
+public:
+    /**
+     * @param filename Path of the file.
+     *
+     * @throws std::runtime_error If the file is not a complete acquisition file,
+     *     or if it is compressed and the build has no zstd.
+     */
+    explicit AcquisitionFileReader(const std::string& filename);
+
+    const AcquisitionFileHeader& get_header() const { return this->header; }
+    const std::vector<AcquisitionFileEvent>& get_events() const { return this->events; }
+    const AcquisitionEventMetrics& get_event_metrics() const { return this->event_metrics; }
+    size_t get_number_of_samples() const { return this->number_of_samples; }
+    size_t get_number_of_chunks() const { return this->chunks.size(); }
+    const std::string& get_filename() const { return this->file->get_filename(); }
+
+    std::vector<std::string> get_channel_names() const;
+
+    /**
+     * @brief Index of a channel in the header.
+     *
+     * @throws std::out_of_range If the file has no such channel.
+     */
+    size_t get_channel_index(const std::string& channel_name) const;
+
+    /**
+     * @brief ADC codes of a channel over [first_sample, first_sample + count).
+     *
+     * @throws std::out_of_range If the range exceeds the acquisition.
+     */
+    CodeBuffer read_channel_codes(const std::string& channel_name, const size_t first_sample, const size_t count) const;
+
+    /**
+     * @brief Samples of a channel over [first_sample, first_sample + count), in volt.
+     *
+     * @throws std::out_of_range If the range exceeds the acquisition.
+     */
+    std::vector<double> read_channel_volts(const std::string& channel_name, const size_t first_sample, const size_t count) const;
+
+private:
+    struct ChunkRecord {
+        uint64_t first_sample;
+        uint64_t number_of_samples;
+        std::vector<uint64_t> offsets;
+        std::vector<uint64_t> stored_sizes;
+    };
+
+    std::unique_ptr<utils::MappedFile> file;
+    AcquisitionFileHeader header;
+    size_t number_of_samples = 0;
+    std::vector<ChunkRecord> chunks;
+    std::vector<AcquisitionFileEvent> events;
+    AcquisitionEventMetrics event_metrics;
+
+    /**
+     * @brief Call visit(chunk_first, chunk_codes) with the raw codes of every chunk
+     *     overlapping [first_sample, first_sample + count), as a byte view.
+     */
+    template <typename Visitor>
+    void for_each_chunk(const size_t channel_index, const size_t first_sample, const size_t count, Visitor&& visit) const;
+};
@@ -0,0 +1,450 @@
+#include "acquisition_pipeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <utils/bounded_queue.h>
+
+#include "triggered_windows.h"
+
+
+namespace {
+
+/**
+ * @brief Analog samples of one block, handed from the producer to the consumer.
+ */
+template <typename Real>
+struct AnalogBlock {
+    size_t first_sample = 0;
+    std::vector<double> time;
+    std::vector<std::vector<Real>> signals;
+};
+
+
+/**
+ * @brief Double precision view of block samples, widened into scratch if they are floats.
+ */
+template <typename Real>
+std::span<const double> as_double_samples(const std::vector<Real>& samples, std::vector<double>& scratch) {
+    if constexpr (std::is_same_v<Real, double>) {
+        return samples;
+    } else {
+        scratch.assign(samples.begin(), samples.end());
+        return scratch;
+    }
+}
+
+}  // namespace
+
+
+AcquisitionPipeline::AcquisitionPipeline(
+    std::shared_ptr<BaseSource> source,
+    std::vector<Detector> detectors,
+    Amplifier amplifier,
+    Digitizer digitizer,
+    std::vector<std::shared_ptr<BaseCircuit>> circuits,
+    OnlineDiscriminator discriminator,
+    std::shared_ptr<BasePeakLocator> peak_locator,
+    const double background_power
+)
+    : source(source),
+      chain(source, std::move(detectors), std::move(amplifier), digitizer.bandwidth, digitizer.sampling_rate),
+      digitizer(std::move(digitizer)),
+      circuits(std::move(circuits)),
+      discriminator(std::move(discriminator)),
+      peak_locator(std::move(peak_locator)),
+      background_power(background_power)
+{
+    if (!(this->digitizer.sampling_rate > 0.0)) {
+        throw std::runtime_error("AcquisitionPipeline requires a digitizer with a strictly positive sampling rate.");
+    }
+
+    for (const std::shared_ptr<BaseCircuit>& circuit : this->circuits) {
+        if (!circuit) {
+            throw std::runtime_error("AcquisitionPipeline circuits must not be null.");
+        }
+    }
+}
+
+
+AcquisitionPipeline::SortedEvents AcquisitionPipeline::sort_events(
+    const PipelineEvents& events,
+    const double run_duration
+) const {
+    const size_t number_of_events = events.centers.size();
+    const size_t number_of_detectors = this->chain.detectors.size();
+
+    if (events.velocities.size() != number_of_events) {
+        throw std::runtime_error("velocities and centers must have the same size.");
+    }
+
+    if (events.amplitudes.size() != number_of_events * number_of_detectors) {
+        throw std::runtime_error("amplitudes must hold one row of number_of_detectors values per event.");
+    }
+
+    const std::vector<double> widths = this->source->get_particle_width(events.velocities);
+
+    SortedEvents sorted;
+
+    for (const double width : widths) {
+        sorted.halo = std::max(sorted.halo, this->source->get_pulse_half_support(width));
+    }
+
+    // Pulses reaching past an end of the run wrap around to the other end.
+    std::vector<std::pair<double, size_t>> order;
+    order.reserve(number_of_events);
+
+    for (size_t event_index = 0; event_index < number_of_events; ++event_index) {
+        const double center = events.centers[event_index];
+
+        order.emplace_back(center, event_index);
+
+        if (run_duration > 0.0 && center - sorted.halo < 0.0) {
+            order.emplace_back(center + run_duration, event_index);
+        }
+
+        if (run_duration > 0.0 && center + sorted.halo > run_duration) {
+            order.emplace_back(center - run_duration, event_index);
+        }
+    }
+
+    std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    sorted.velocities.reserve(order.size());
+    sorted.centers.reserve(order.size());
+    sorted.amplitudes.reserve(order.size() * number_of_detectors);
+
+    for (const auto& [center, event_index] : order) {
+        sorted.centers.push_back(center);
+        sorted.velocities.push_back(events.velocities[event_index]);
+
+        sorted.amplitudes.insert(
+            sorted.amplitudes.end(),
+            events.amplitudes.begin() + static_cast<std::ptrdiff_t>(event_index * number_of_detectors),
+            events.amplitudes.begin() + static_cast<std::ptrdiff_t>((event_index + 1) * number_of_detectors)
+        );
+    }
+
+    return sorted;
+}
+
+
+std::vector<CircuitChain> AcquisitionPipeline::make_channel_circuits() const {
+    std::vector<CircuitChain> channel_circuits;
+    channel_circuits.reserve(this->chain.detectors.size());
+
+    for (size_t channel = 0; channel < this->chain.detectors.size(); ++channel) {
+        std::vector<std::shared_ptr<BaseCircuit>> clones;
+        clones.reserve(this->circuits.size());
+
+        for (const std::shared_ptr<BaseCircuit>& circuit : this->circuits) {
+            std::shared_ptr<BaseCircuit> clone = circuit->clone();
+            clone->reset();
+
+            if (auto* butterworth = dynamic_cast<ButterworthLowPassFilter*>(clone.get())) {
+                butterworth->implementation = LowPassImplementation::iir;
+            } else if (auto* bessel = dynamic_cast<BesselLowPassFilter*>(clone.get())) {
+                bessel->implementation = LowPassImplementation::iir;
+            }
+
+            clones.push_back(std::move(clone));
+        }
+
+        channel_circuits.emplace_back(std::move(clones));
+    }
+
+    return channel_circuits;
+}
+
+
+AcquisitionPipelineResult AcquisitionPipeline::run(const PipelineEvents& events, const double run_time) const {
+    return this->run(events, run_time, this->chain.draw_noise_streams(), true);
+}
+
+
+AcquisitionPipelineResult AcquisitionPipeline::run(
+    const PipelineEvents& events,
+    const double run_time,
+    const OptoElectronicNoiseStreams& streams,
+    const bool overlap_stages
+) const {
+    if (this->precision == SignalPrecision::float32) {
+        return this->run_blocks<float>(events, run_time, streams, overlap_stages);
+    }
+
+    return this->run_blocks<double>(events, run_time, streams, overlap_stages);
+}
+
+
+template <typename Real>
+AcquisitionPipelineResult AcquisitionPipeline::run_blocks(
+    const PipelineEvents& events,
+    const double run_time,
+    const OptoElectronicNoiseStreams& streams,
+    const bool overlap_stages
+) const {
+    if (!(run_time >= 0.0)) {
+        throw std::runtime_error("run_time must be non negative.");
+    }
+
+    if (this->block_size == 0) {
+        throw std::runtime_error("block_size must be at least one sample.");
+    }
+
+    const double sampling_rate = this->digitizer.sampling_rate;
+    const utils::TimeAxis time_axis = this->digitizer.get_time_axis(run_time);
+    const double time_step = time_axis.time_step;
+    const size_t number_of_samples = time_axis.size();
+    const size_t number_of_detectors = this->chain.detectors.size();
+
+    std::vector<std::string> channel_names;
+    channel_names.reserve(number_of_detectors);
+
+    for (const Detector& detector : this->chain.detectors) {
+        channel_names.push_back(detector.name);
+    }
+
+    const SortedEvents sorted = this->sort_events(events, static_cast<double>(number_of_samples) * time_step);
+
+    // ---------------- per run state ----------------
+    std::vector<utils::BiquadCascade> amplifier_filters = this->chain.design_amplifier_filters();
+    std::vector<CircuitChain> channel_circuits = this->make_channel_circuits();
+    OnlineDiscriminator discriminator = this->discriminator;
+    Digitizer digitizer = this->digitizer;
+
+    AcquisitionPipelineResult result;
+    result.number_of_samples = number_of_samples;
+    result.number_of_blocks = (number_of_samples + this->block_size - 1) / this->block_size;
+
+    if (this->keep_segments) {
+        result.segment_offsets.push_back(0);
+    }
+
+    if (this->event_statistics) {
+        result.statistics = *this->event_statistics;
+        result.statistics->reset();
+        result.statistics->time_step = 1.0 / sampling_rate;
+    }
+
+    if (this->debug_mode) {
+        std::printf(
+            "[AcquisitionPipeline] samples=%zu | blocks=%zu | block_size=%zu | events=%zu | halo=%.3e s | overlap=%d | precision=%s\n",
+            number_of_samples,
+            result.number_of_blocks,
+            this->block_size,
+            sorted.centers.size(),
+            sorted.halo,
+            static_cast<int>(overlap_stages),
+            std::is_same_v<Real, float> ? "float32" : "float64"
+        );
+    }
+
+    // ---------------- producer: synthesis, noise, circuits ----------------
+    auto produce_block = [&](const size_t first) {
+        const size_t block_length = std::min(this->block_size, number_of_samples - first);
+
+        AnalogBlock<Real> block;
+        block.first_sample = first;
+        block.time.resize(block_length);
+        time_axis.fill(block.time, first);
+
+        const auto begin = std::lower_bound(sorted.centers.begin(), sorted.centers.end(), block.time.front() - sorted.halo);
+        const auto end = std::upper_bound(begin, sorted.centers.end(), block.time.back() + sorted.halo);
+
+        const size_t event_begin = static_cast<size_t>(begin - sorted.centers.begin());
+        const size_t event_count = static_cast<size_t>(end - begin);
+
+        block.signals = this->source->template generate_multi_detector_pulses<Real>(
+            std::span<const double>(sorted.velocities).subspan(event_begin, event_count),
+            std::span<const double>(sorted.centers).subspan(event_begin, event_count),
+            std::span<const double>(sorted.amplitudes).subspan(event_begin * number_of_detectors, event_count * number_of_detectors),
+            number_of_detectors,
+            block.time,
+            this->background_power
+        );
+
+        const std::vector<std::span<Real>> views(block.signals.begin(), block.signals.end());
+
+        this->chain.process_block_in_place(views, time_step, streams, first, amplifier_filters);
+
+        for (size_t channel = 0; channel < number_of_detectors; ++channel) {
+            channel_circuits[channel].process_chunk(views[channel], sampling_rate);
+        }
+
+        return block;
+    };
+
+    // ---------------- consumer: discriminator, digitizer, peak locator ----------------
+    // Blocks held back until the warm-up window, which does not depend on block_size, is complete.
+    const size_t warm_up_length = std::min(std::max<size_t>(this->warm_up_samples, 1), number_of_samples);
+    std::vector<AnalogBlock<Real>> warm_up_blocks;
+    size_t number_of_warm_up_samples = 0;
+    bool warmed_up = false;
+
+    // Digitized blocks, windows and metrics are written by the I/O thread of the spill.
+    std::unique_ptr<AsyncAcquisitionFileWriter> spill;
+
+    if (!this->spill_filename.empty()) {
+        spill = std::make_unique<AsyncAcquisitionFileWriter>(
+            this->spill_filename,
+            digitizer,
+            channel_names,
+            this->spill_compression,
+            std::max<size_t>(this->queue_depth, 1)
+        );
+    }
+
+    auto process_events = [&](const std::vector<TriggeredEvent>& triggered_events) {
+        TriggeredWindowBatch batch = concatenate_triggered_windows(triggered_events);
+
+        std::vector<AcquisitionFileEvent> spilled_events;
+
+        if (spill) {
+            for (size_t window = 0; window < batch.get_number_of_windows(); ++window) {
+                spilled_events.push_back({batch.start_indices[window], batch.offsets[window + 1] - batch.offsets[window]});
+            }
+        }
+
+        digitizer.process_data_map(batch.signals);
+
+        EventMetricDictionary metrics = append_triggered_windows(
+            result,
+            std::move(batch),
+            channel_names,
+            this->peak_locator.get(),
+            discriminator.trigger_channel,
+            this->keep_segments
+        );
+
+        if (spill) {
+            spill->append_events(std::move(spilled_events), std::move(metrics));
+        }
+    };
+
+    std::vector<std::vector<double>> widened_signals(number_of_detectors);
+
+    auto resolve_warm_up = [&]() {
+        std::vector<std::vector<double>> warm_up_signals(number_of_detectors);
+        std::map<std::string, std::span<const double>> signals;
+
+        for (size_t channel = 0; channel < number_of_detectors; ++channel) {
+            warm_up_signals[channel].reserve(warm_up_length);
+
+            for (const AnalogBlock<Real>& block : warm_up_blocks) {
+                const size_t count = std::min(block.signals[channel].size(), warm_up_length - warm_up_signals[channel].size());
+                warm_up_signals[channel].insert(warm_up_signals[channel].end(), block.signals[channel].begin(), block.signals[channel].begin() + count);
+            }
+
+            signals[channel_names[channel]] = warm_up_signals[channel];
+        }
+
+        digitizer.fix_voltage_ranges(signals);
+
+        // A missing trigger channel is reported by the discriminator on the first block.
+        const auto trigger_iterator = signals.find(discriminator.trigger_channel);
+
+        if (trigger_iterator != signals.end()) {
+            discriminator.resolve_thresholds_on(trigger_iterator->second);
+        }
+    };
+
+    auto process_block = [&](const AnalogBlock<Real>& block) {
+        std::map<std::string, std::span<const double>> signals;
+
+        for (size_t channel = 0; channel < number_of_detectors; ++channel) {
+            signals[channel_names[channel]] = as_double_samples(block.signals[channel], widened_signals[channel]);
+        }
+
+        if (spill) {
+            std::map<std::string, std::vector<double>> block_map;
+
+            for (size_t channel = 0; channel < number_of_detectors; ++channel) {
+                const std::span<const double> samples = signals[channel_names[channel]];
+                block_map[channel_names[channel]].assign(samples.begin(), samples.end());
+            }
+
+            spill->append_chunk(digitizer.get_processed_code_data_map(block_map));
+        }
+
+        discriminator.add_block(block.time, signals);
+        process_events(discriminator.pop_events());
+    };
+
+    auto consume_block = [&](AnalogBlock<Real>&& block) {
+        if (warmed_up) {
+            process_block(block);
+            return;
+        }
+
+        number_of_warm_up_samples += block.time.size();
+        warm_up_blocks.push_back(std::move(block));
+
+        if (number_of_warm_up_samples < warm_up_length) {
+            return;
+        }
+
+        resolve_warm_up();
+        warmed_up = true;
+
+        for (const AnalogBlock<Real>& warm_up_block : warm_up_blocks) {
+            process_block(warm_up_block);
+        }
+
+        warm_up_blocks.clear();
+    };
+
+    if (overlap_stages) {
+        utils::BoundedQueue<AnalogBlock<Real>> queue(std::max<size_t>(this->queue_depth, 1));
+        std::exception_ptr producer_error;
+
+        std::thread producer([&]() {
+            try {
+                for (size_t first = 0; first < number_of_samples; first += this->block_size) {
+                    if (!queue.push(produce_block(first))) {
+                        break;
+                    }
+                }
+            } catch (...) {
+                producer_error = std::current_exception();
+            }
+
+            queue.close();
+        });
+
+        try {
+            while (std::optional<AnalogBlock<Real>> block = queue.pop()) {
+                consume_block(std::move(*block));
+            }
+
+            producer.join();
+        } catch (...) {
+            queue.close();
+            producer.join();
+            throw;
+        }
+
+        if (producer_error) {
+            std::rethrow_exception(producer_error);
+        }
+    } else {
+        for (size_t first = 0; first < number_of_samples; first += this->block_size) {
+            consume_block(produce_block(first));
+        }
+    }
+
+    discriminator.finish();
+    process_events(discriminator.pop_events());
+
+    if (spill) {
+        result.spill_statistics = spill->close();
+    }
+
+    return result;
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <opto_electronics/source/source.h>
+#include <opto_electronics/detector/detector.h>
+#include <opto_electronics/amplifier/amplifier.h>
+#include <opto_electronics/digitizer/digitizer.h>
+#include <opto_electronics/circuits/circuits.h>
+#include <opto_electronics/opto_electronic_chain/opto_electronic_chain.h>
+#include <digital_processing/discriminator/online_discriminator.h>
+#include <digital_processing/peak_locator/peak_locator.h>
+
+#include "acquisition_file.h"
+#include "async_acquisition_file_writer.h"
+#include "event_statistics.h"
+
+
+/**
+ * @brief Sample type of the analog blocks of an AcquisitionPipeline.
+ */
+enum class SignalPrecision {
+    float64,
+    float32
+};
+
+
+/**
+ * @brief Particle transit events synthesized by an AcquisitionPipeline.
+ */
+struct PipelineEvents {
+    std::vector<double> velocities;     // [meter / second]
+    std::vector<double> centers;        // [second]
+    std::vector<double> amplitudes;     // [watt] row major (number of events x number of detectors)
+};
+
+
+/**
+ * @brief Output of an AcquisitionPipeline run: the triggered windows and their peak metrics.
+ *
+ * Windows are stored back to back: window k spans [segment_offsets[k], segment_offsets[k + 1])
+ * of segment_time and of every channel of segment_signals, as in Trigger.
+ */
+struct AcquisitionPipelineResult {
+    size_t number_of_samples = 0;
+    size_t number_of_blocks = 0;
+
+    /// Acquisition index of the first sample of every window.
+    std::vector<size_t> start_indices;
+
+    /// Window boundaries, one more than the number of windows. Filled only when segments are kept.
+    std::vector<size_t> segment_offsets;
+    std::vector<double> segment_time;
+    std::map<std::string, std::vector<double>> segment_signals;
+
+    /// Window-major peak metrics of every channel, empty without a peak locator.
+    EventMetricDictionary metrics;
+
+    /// Counters of the acquisition file writer, for runs that spill.
+    std::optional<AsyncWriterStatistics> spill_statistics;
+
+    /// Histograms and summaries of the peak metrics, for runs accumulating them.
+    std::optional<EventStatistics> statistics;
+
+    size_t get_number_of_events() const { return this->start_indices.size(); }
+};
+
+
+/**
+ * @brief Constant memory acquisition engine running every stage of a run block by block.
+ *
+ * A run is pushed through the stages in fixed size time blocks:
+ *
+ *     pulse synthesis -> opto electronic noise -> analog circuits      (producer thread)
+ *     discriminator -> digitizer -> peak locator                       (calling thread)
+ *
+ * The two halves run concurrently and exchange blocks through a bounded queue
+ * of queue_depth blocks, so memory is set by block_size, queue_depth and the
+ * number of triggered windows, not by the run length.
+ *
+ * Each block is exact rather than approximated with overlaps:
+ * - pulses are evaluated on the block time stamps, from the events whose support,
+ *   from BaseSource::get_pulse_half_support, reaches the block. Events are sorted
+ *   once, and events near either end of the run are replicated one run length
+ *   away, as in the periodic synthesis of FlowCytometer;
+ * - noise is drawn from counter based streams indexed by the acquisition sample,
+ *   so it does not depend on the block size;
+ * - the amplifier filter and the circuits carry their state between blocks, one
+ *   clone of the circuits per channel. FFT low-pass circuits need the whole
+ *   trace; they run as their causal IIR cascade, as does the amplifier filter;
+ * - the OnlineDiscriminator carries open windows across blocks.
+ *
+ * Auto voltage ranges of the digitizer and sigma thresholds of the
+ * discriminator are resolved on the first warm_up_samples samples of the run,
+ * whatever the block size: blocks are held back until the warm-up window is
+ * complete, then processed in order. A run longer than the warm-up window can
+ * still resolve them differently from a batch run, which sees the whole trace.
+ *
+ * With SignalPrecision::float32, the producer stages store their blocks as
+ * floats, which halves the memory traffic of synthesis, noise and circuits and
+ * of the queue between the two halves. Each stage still computes in double and
+ * keeps its filter and servo states in double; only stored samples are
+ * rounded. The consumer widens each block back to double once, so trigger
+ * levels, ADC codes and peak areas are resolved as in a float64 run.
+ *
+ * With a spill_filename, every block is also digitized whole and handed, with the
+ * triggered windows and their metrics, to an AsyncAcquisitionFileWriter whose
+ * I/O thread writes them to an acquisition file, one chunk per block, while the
+ * next blocks are processed. The run can then be replayed with
+ * replay_acquisition_file. Each run rewrites the file, so an AcquisitionSweep
+ * rejects runs spilling to the same file.
+ *
+ * With event_statistics, every batch of windows also updates a copy of these
+ * statistics as its metrics come out of the peak locator, so histograms and
+ * quantiles of a run are available without keeping its metrics.
+ */
+class AcquisitionPipeline {
+public:
+    std::shared_ptr<BaseSource> source;
+    OptoElectronicChain chain;
+    Digitizer digitizer;
+    std::vector<std::shared_ptr<BaseCircuit>> circuits;
+    OnlineDiscriminator discriminator;
+    std::shared_ptr<BasePeakLocator> peak_locator;
+    double background_power;    // [watt]
+
+    /// Number of samples per block.
+    size_t block_size = size_t{1} << 16;
+
+    /// Number of blocks the producer may run ahead of the consumer, and the consumer ahead of the spill writer.
+    size_t queue_depth = 4;
+
+    /// Number of leading samples resolving auto voltage ranges and sigma thresholds. A value of 0 uses one sample.
+    size_t warm_up_samples = size_t{1} << 16;
+
+    /// Whether the digitized windows are returned along with the metrics.
+    bool keep_segments = true;
+
+    /// Acquisition file receiving the ADC codes and windows of every run, or empty for none.
+    std::string spill_filename;
+
+    /// Compression of the spilled channel blocks.
+    AcquisitionCompression spill_compression = AcquisitionCompression::none;
+
+    /// Sample type of the analog blocks, from synthesis to the analog circuits.
+    SignalPrecision precision = SignalPrecision::float64;
+
+    /// Histogram configuration accumulated by every run, starting from no count, or none.
+    std::optional<EventStatistics> event_statistics;
+
+    bool debug_mode = false;
+
+    /**
+     * @param source Light source synthesizing the pulses.
+     * @param detectors Detectors, one channel each.
+     * @param amplifier Transimpedance amplifier shared by the detectors.
+     * @param digitizer Digitizer setting the sampling rate and the ADC codes.
+     * @param circuits Analog circuits applied, in order, to every channel.
+     * @param discriminator Streaming discriminator extracting the event windows.
+     * @param peak_locator Peak locator applied to the digitized windows, or null.
+     * @param background_power Constant optical power added to every channel, in watt.
+     *
+     * @throws std::runtime_error If source is null or the digitizer has no sampling rate.
+     */
+    AcquisitionPipeline(
+        std::shared_ptr<BaseSource> source,
+        std::vector<Detector> detectors,
+        Amplifier amplifier,
+        Digitizer digitizer,
+        std::vector<std::shared_ptr<BaseCircuit>> circuits,
+        OnlineDiscriminator discriminator,
+        std::shared_ptr<BasePeakLocator> peak_locator = nullptr,
+        const double background_power = 0.0
+    );
+
+    /**
+     * @brief Simulate and process one run.
+     *
+     * Every stateful stage is copied for the run, so a pipeline can run several
+     * times, and runs do not affect each other beyond the random streams they draw.
+     *
+     * @param events Transit events of the run.
+     * @param run_time Acquisition duration in second.
+     * @return Triggered windows and peak metrics.
+     *
+     * @throws std::runtime_error If the events are inconsistent, or if a stage fails.
+     */
+    AcquisitionPipelineResult run(const PipelineEvents& events, const double run_time) const;
+
+    /**
+     * @brief Simulate and process one run with noise streams drawn beforehand.
+     *
+     * @param events Transit events of the run.
+     * @param run_time Acquisition duration in second.
+     * @param streams Noise streams of the run, from chain.draw_noise_streams().
+     * @param overlap_stages Whether synthesis runs on its own thread, ahead of the
+     *     analysis. Without it, every block is produced then consumed on the calling thread.
+     * @return Triggered windows and peak metrics.
+     *
+     * @throws std::runtime_error If the events are inconsistent, or if a stage fails.
+     */
+    AcquisitionPipelineResult run(
+        const PipelineEvents& events,
+        const double run_time,
+        const OptoElectronicNoiseStreams& streams,
+        const bool overlap_stages
+    ) const;
+
+private:
+    /**
+     * @brief Events sorted by center, with their periodic images, and the largest pulse half support.
+     */
+    struct SortedEvents {
+        std::vector<double> velocities;
+        std::vector<double> centers;
+        std::vector<double> amplitudes;
+        double halo = 0.0;
+    };
+
+    SortedEvents sort_events(const PipelineEvents& events, const double run_duration) const;
+
+    /**
+     * @brief Body of run, with analog blocks of samples of type Real.
+     */
+    template <typename Real>
+    AcquisitionPipelineResult run_blocks(
+        const PipelineEvents& events,
+        const double run_time,
+        const OptoElectronicNoiseStreams& streams,
+        const bool overlap_stages
+    ) const;
+
+    /**
+     * @brief One chain of circuit clones per channel, FFT low-pass filters switched to IIR.
+     */
+    std::vector<CircuitChain> make_channel_circuits() const;
+};
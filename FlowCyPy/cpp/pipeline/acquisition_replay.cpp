@@ -0,0 +1,100 @@
+#include "acquisition_replay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "triggered_windows.h"
+
+
+AcquisitionPipelineResult replay_acquisition_file(
+    const AcquisitionFileReader& reader,
+    OnlineDiscriminator discriminator,
+    const std::shared_ptr<BasePeakLocator>& peak_locator,
+    const bool keep_segments,
+    const size_t block_size,
+    const std::optional<EventStatistics>& statistics
+) {
+    if (block_size == 0) {
+        throw std::runtime_error("block_size must be at least one sample.");
+    }
+
+    const AcquisitionFileHeader& header = reader.get_header();
+    const std::vector<std::string> channel_names = reader.get_channel_names();
+    const size_t number_of_samples = reader.get_number_of_samples();
+    const size_t number_of_channels = channel_names.size();
+
+    if (std::find(channel_names.begin(), channel_names.end(), discriminator.trigger_channel) == channel_names.end()) {
+        throw std::runtime_error("Trigger channel '" + discriminator.trigger_channel + "' is not a channel of the acquisition file.");
+    }
+
+    AcquisitionPipelineResult result;
+    result.number_of_samples = number_of_samples;
+    result.number_of_blocks = (number_of_samples + block_size - 1) / block_size;
+
+    if (keep_segments) {
+        result.segment_offsets.push_back(0);
+    }
+
+    if (statistics) {
+        result.statistics = *statistics;
+        result.statistics->reset();
+        result.statistics->time_step = 1.0 / header.sampling_rate;
+    }
+
+    const double minimum_code = static_cast<double>(header.minimum_code);
+    const double maximum_code = static_cast<double>(header.maximum_code);
+
+    auto process_events = [&](const std::vector<TriggeredEvent>& triggered_events) {
+        TriggeredWindowBatch batch = concatenate_triggered_windows(triggered_events);
+
+        // Back from volt to the codes the samples were decoded from.
+        for (const AcquisitionChannelInfo& channel : header.channels) {
+            for (double& sample : batch.signals[channel.name]) {
+                const double code = std::round((sample - channel.code_to_volt_offset) / channel.code_to_volt_scale);
+                sample = std::clamp(code, minimum_code, maximum_code);
+            }
+        }
+
+        append_triggered_windows(
+            result,
+            std::move(batch),
+            channel_names,
+            peak_locator.get(),
+            discriminator.trigger_channel,
+            keep_segments
+        );
+    };
+
+    std::vector<double> time;
+    std::vector<std::vector<double>> signals(number_of_channels);
+
+    for (size_t first = 0; first < number_of_samples; first += block_size) {
+        const size_t block_length = std::min(block_size, number_of_samples - first);
+
+        time.resize(block_length);
+
+        for (size_t index = 0; index < block_length; ++index) {
+            time[index] = static_cast<double>(first + index) / header.sampling_rate;
+        }
+
+        std::map<std::string, std::span<const double>> views;
+
+        for (size_t channel = 0; channel < number_of_channels; ++channel) {
+            signals[channel] = reader.read_channel_volts(channel_names[channel], first, block_length);
+            views[channel_names[channel]] = signals[channel];
+        }
+
+        discriminator.add_block(time, views);
+        process_events(discriminator.pop_events());
+    }
+
+    discriminator.finish();
+    process_events(discriminator.pop_events());
+
+    return result;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+#include "acquisition_file.h"
+#include "acquisition_pipeline.h"
+
+
+/**
+ * @brief Reprocess an archived acquisition with a new discriminator and peak locator.
+ *
+ * The file is read lazily, block_size samples at a time: each block is decoded
+ * to volt and fed to the discriminator, so only the open windows and the current
+ * block are held in memory. The windows are then mapped back to their ADC codes,
+ * as the AcquisitionPipeline hands them to the peak locator, so metrics of a
+ * replay are comparable with the metrics of the original run.
+ *
+ * The discriminator sees the digitized samples rather than the analog signal of
+ * the original run: replaying with the original thresholds gives the original
+ * windows up to the quantization of the trigger channel.
+ *
+ * @param reader Acquisition file, e.g. spilled by an AcquisitionPipeline.
+ * @param discriminator Streaming discriminator; its trigger channel must be a channel of the file.
+ * @param peak_locator Peak locator applied to the windows, or null.
+ * @param keep_segments Whether the windows are returned along with the metrics.
+ * @param block_size Number of samples decoded at a time.
+ * @param statistics Histogram configuration accumulated over the replay, or none.
+ * @return Triggered windows and peak metrics of the replay.
+ *
+ * @throws std::runtime_error If block_size is 0, or if the trigger channel is not in the file.
+ */
+AcquisitionPipelineResult replay_acquisition_file(
+    const AcquisitionFileReader& reader,
+    OnlineDiscriminator discriminator,
+    const std::shared_ptr<BasePeakLocator>& peak_locator = nullptr,
+    const bool keep_segments = true,
+    const size_t block_size = size_t{1} << 16,
+    const std::optional<EventStatistics>& statistics = std::nullopt
+);
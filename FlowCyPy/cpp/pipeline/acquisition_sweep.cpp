@@ -0,0 +1,150 @@
+#include "acquisition_sweep.h"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+size_t AcquisitionSweep::add_events(PipelineEvents events) {
+    this->event_sets.push_back(std::make_shared<const PipelineEvents>(std::move(events)));
+
+    return this->event_sets.size() - 1;
+}
+
+
+size_t AcquisitionSweep::add_run(
+    std::shared_ptr<const AcquisitionPipeline> pipeline,
+    const size_t events_index,
+    const double run_time
+) {
+    if (!pipeline) {
+        throw std::runtime_error("AcquisitionSweep pipeline must not be null.");
+    }
+
+    if (events_index >= this->event_sets.size()) {
+        throw std::out_of_range("events_index " + std::to_string(events_index) + " is not a registered event set.");
+    }
+
+    if (!(run_time >= 0.0)) {
+        throw std::runtime_error("run_time must be non negative.");
+    }
+
+    this->runs.push_back({std::move(pipeline), events_index, run_time});
+
+    return this->runs.size() - 1;
+}
+
+
+std::vector<AcquisitionPipelineResult> AcquisitionSweep::run() const {
+    const size_t number_of_runs = this->runs.size();
+
+    std::vector<AcquisitionPipelineResult> results(number_of_runs);
+
+    if (number_of_runs == 0) {
+        return results;
+    }
+
+    // Concurrent runs spilling to one file would interleave their writes, so they are rejected up front.
+    std::map<std::filesystem::path, size_t> spilling_runs;
+
+    for (size_t run_index = 0; run_index < number_of_runs; ++run_index) {
+        const std::string& spill_filename = this->runs[run_index].pipeline->spill_filename;
+
+        if (spill_filename.empty()) {
+            continue;
+        }
+
+        const auto [found, inserted] = spilling_runs.emplace(
+            std::filesystem::absolute(spill_filename).lexically_normal(),
+            run_index
+        );
+
+        if (!inserted) {
+            throw std::invalid_argument(
+                "Runs " + std::to_string(found->second) + " and " + std::to_string(run_index) +
+                " of the sweep spill to the same file '" + spill_filename + "'."
+            );
+        }
+    }
+
+    // Streams are drawn in run order, whatever order the runs execute in.
+    std::vector<OptoElectronicNoiseStreams> streams;
+    streams.reserve(number_of_runs);
+
+    for (const SweepRun& run : this->runs) {
+        streams.push_back(run.pipeline->chain.draw_noise_streams());
+    }
+
+    // Longest runs first, so the last runs to start are the short ones.
+    std::vector<size_t> order(number_of_runs);
+    std::iota(order.begin(), order.end(), size_t{0});
+
+    std::stable_sort(order.begin(), order.end(), [this](const size_t a, const size_t b) {
+        const SweepRun& run_a = this->runs[a];
+        const SweepRun& run_b = this->runs[b];
+
+        return run_a.run_time * run_a.pipeline->digitizer.sampling_rate > run_b.run_time * run_b.pipeline->digitizer.sampling_rate;
+    });
+
+    const int requested_threads = this->number_of_threads > 0
+        ? static_cast<int>(this->number_of_threads)
+        : omp_get_max_threads();
+
+    const int thread_count = std::max(1, std::min(requested_threads, static_cast<int>(number_of_runs)));
+
+    if (this->debug_mode) {
+        std::printf(
+            "[AcquisitionSweep] runs=%zu | event_sets=%zu | threads=%d\n",
+            number_of_runs,
+            this->event_sets.size(),
+            thread_count
+        );
+    }
+
+    std::vector<std::exception_ptr> errors(number_of_runs);
+
+    // Every stage runs on the thread of its run: nested regions stay inactive.
+    const int max_active_levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(1);
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(thread_count)
+    for (size_t position = 0; position < number_of_runs; ++position) {
+        const size_t run_index = order[position];
+        const SweepRun& run = this->runs[run_index];
+
+        try {
+            results[run_index] = run.pipeline->run(
+                *this->event_sets[run.events_index],
+                run.run_time,
+                streams[run_index],
+                false
+            );
+        } catch (...) {
+            errors[run_index] = std::current_exception();
+        }
+    }
+
+    omp_set_max_active_levels(max_active_levels);
+
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    return results;
+}
+
+
+void AcquisitionSweep::clear() {
+    this->runs.clear();
+    this->event_sets.clear();
+}
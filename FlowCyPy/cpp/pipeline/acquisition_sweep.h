@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "acquisition_pipeline.h"
+
+
+/**
+ * @brief Batch executor running many AcquisitionPipeline runs in parallel.
+ *
+ * A sweep is a list of runs, each pairing a pipeline with a set of transit
+ * events. Event sets and pipelines are shared, not copied: runs that only differ
+ * downstream of the optics, e.g. in gain, threshold or bandwidth, reference the
+ * same events, and runs with the same configuration reference the same pipeline.
+ *
+ * Runs are handed to the threads one at a time, longest first, so threads that
+ * finish early pick up the remaining runs. Each run then executes on a single
+ * thread: nested OpenMP regions of the stages are disabled for the sweep, and
+ * synthesis is not overlapped with analysis, so the sweep uses exactly
+ * number_of_threads cores.
+ *
+ * Noise streams are drawn for every run, in run order, before the runs start, so
+ * a sweep reproduces the results of running its pipelines one after the other.
+ */
+class AcquisitionSweep {
+public:
+    /// Number of runs executed concurrently, 0 for the OpenMP default.
+    size_t number_of_threads = 0;
+
+    bool debug_mode = false;
+
+    AcquisitionSweep() = default;
+
+    /**
+     * @brief Register a set of transit events shared by one or more runs.
+     *
+     * @param events Transit events.
+     * @return Index of the event set, to pass to add_run.
+     */
+    size_t add_events(PipelineEvents events);
+
+    /**
+     * @brief Append a run to the sweep.
+     *
+     * @param pipeline Pipeline processing the run. It is shared, so it must not be
+     *     modified until the sweep has run.
+     * @param events_index Index returned by add_events.
+     * @param run_time Acquisition duration in second.
+     * @return Index of the run in the results of run().
+     *
+     * @throws std::out_of_range If events_index is not a registered event set.
+     * @throws std::runtime_error If pipeline is null or run_time is negative.
+     */
+    size_t add_run(
+        std::shared_ptr<const AcquisitionPipeline> pipeline,
+        const size_t events_index,
+        const double run_time
+    );
+
+    /**
+     * @brief Execute every run.
+     *
+     * @return One result per run, in the order the runs were added.
+     *
+     * @throws std::invalid_argument If two runs spill to the same file, before any run starts.
+     * @throws std::runtime_error The error of the first failing run, once every run has ended.
+     */
+    std::vector<AcquisitionPipelineResult> run() const;
+
+    /**
+     * @brief Remove every run and event set.
+     */
+    void clear();
+
+    /**
+     * @brief Pipeline of a run.
+     *
+     * @throws std::out_of_range If run_index is not a run of the sweep.
+     */
+    const std::shared_ptr<const AcquisitionPipeline>& get_pipeline(const size_t run_index) const {
+        return this->runs.at(run_index).pipeline;
+    }
+
+    size_t get_number_of_runs() const { return this->runs.size(); }
+    size_t get_number_of_event_sets() const { return this->event_sets.size(); }
+
+private:
+    struct SweepRun {
+        std::shared_ptr<const AcquisitionPipeline> pipeline;
+        size_t events_index;
+        double run_time;
+    };
+
+    std::vector<std::shared_ptr<const PipelineEvents>> event_sets;
+    std::vector<SweepRun> runs;
+};
@@ -0,0 +1,152 @@
+#include "async_acquisition_file_writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(const Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+
+AsyncAcquisitionFileWriter::AsyncAcquisitionFileWriter(
+    const std::string& filename,
+    const Digitizer& digitizer,
+    const std::vector<std::string>& channel_names,
+    const AcquisitionCompression compression,
+    const size_t ring_capacity
+)
+    : writer(filename, digitizer, channel_names, compression),
+      ring(ring_capacity)
+{
+    this->statistics.ring_capacity = ring_capacity;
+    this->io_thread = std::thread([this]() { this->drain(); });
+}
+
+
+AsyncAcquisitionFileWriter::~AsyncAcquisitionFileWriter() {
+    try {
+        this->close();
+    } catch (...) {
+    }
+}
+
+
+AsyncAcquisitionFileWriter::Slot& AsyncAcquisitionFileWriter::acquire_slot() {
+    if (this->closed) {
+        throw std::runtime_error("AsyncAcquisitionFileWriter: cannot append to a closed writer.");
+    }
+
+    const size_t full_waits = this->ring.get_number_of_full_waits();
+    const Clock::time_point start = Clock::now();
+
+    Slot* slot = this->ring.acquire();
+
+    if (this->ring.get_number_of_full_waits() != full_waits) {
+        this->statistics.number_of_producer_stalls += 1;
+        this->statistics.producer_stall_time += seconds_since(start);
+    }
+
+    if (slot == nullptr) {
+        // Only the I/O thread closes the ring before close(): it failed.
+        this->closed = true;
+        this->io_thread.join();
+        std::rethrow_exception(this->io_error);
+    }
+
+    return *slot;
+}
+
+
+void AsyncAcquisitionFileWriter::publish_slot() {
+    this->ring.publish();
+    this->statistics.max_queued_slots = std::max(this->statistics.max_queued_slots, this->ring.size());
+}
+
+
+void AsyncAcquisitionFileWriter::append_chunk(std::map<std::string, DigitizedChannel>&& channels) {
+    Slot& slot = this->acquire_slot();
+
+    slot.has_chunk = true;
+    slot.channels = std::move(channels);
+
+    this->publish_slot();
+}
+
+
+void AsyncAcquisitionFileWriter::append_events(std::vector<AcquisitionFileEvent>&& events, AcquisitionEventMetrics&& metrics) {
+    if (events.empty()) {
+        return;
+    }
+
+    Slot& slot = this->acquire_slot();
+
+    slot.events = std::move(events);
+    slot.metrics = std::move(metrics);
+
+    this->publish_slot();
+}
+
+
+void AsyncAcquisitionFileWriter::drain() {
+    try {
+        while (Slot* slot = this->ring.front()) {
+            const Clock::time_point start = Clock::now();
+
+            if (slot->has_chunk) {
+                this->writer.append_chunk(slot->channels);
+                this->statistics.number_of_chunks += 1;
+            }
+
+            for (const AcquisitionFileEvent& event : slot->events) {
+                this->writer.add_event(event.start_index, event.number_of_samples);
+            }
+
+            this->statistics.number_of_events += slot->events.size();
+            this->writer.append_event_metrics(slot->metrics);
+
+            slot->has_chunk = false;
+            slot->channels.clear();
+            slot->events.clear();
+            slot->metrics.clear();
+
+            this->statistics.write_time += seconds_since(start);
+            this->ring.release();
+        }
+    } catch (...) {
+        this->io_error = std::current_exception();
+        this->ring.close();
+    }
+}
+
+
+AsyncWriterStatistics AsyncAcquisitionFileWriter::close() {
+    if (this->closed) {
+        return this->statistics;
+    }
+
+    this->closed = true;
+    this->ring.close();
+    this->io_thread.join();
+
+    if (this->io_error) {
+        std::rethrow_exception(this->io_error);
+    }
+
+    const Clock::time_point start = Clock::now();
+
+    this->writer.close();
+
+    this->statistics.write_time += seconds_since(start);
+    this->statistics.file_size = this->writer.get_file_size();
+
+    return this->statistics;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <utils/spsc_ring.h>
+
+#include "acquisition_file.h"
+
+
+/**
+ * @brief Backpressure and throughput counters of an AsyncAcquisitionFileWriter.
+ */
+struct AsyncWriterStatistics {
+    size_t number_of_chunks = 0;
+    size_t number_of_events = 0;
+
+    /// Number of slots of the ring.
+    size_t ring_capacity = 0;
+
+    /// Largest number of slots waiting for the I/O thread at any time.
+    size_t max_queued_slots = 0;
+
+    /// Number of times the compute thread found the ring full and waited for the I/O thread.
+    size_t number_of_producer_stalls = 0;
+
+    /// Time the compute thread spent waiting for a free slot, in second.
+    double producer_stall_time = 0.0;
+
+    /// Time the I/O thread spent encoding and writing, in second.
+    double write_time = 0.0;
+
+    /// Size of the closed file, in byte.
+    size_t file_size = 0;
+};
+
+
+/**
+ * @brief Acquisition file writer running on its own I/O thread.
+ *
+ * The compute thread fills the slots of a lock free single producer, single
+ * consumer ring with the digitized chunks and the triggered events of the
+ * acquisition; a dedicated thread drains the ring into an AcquisitionFileWriter,
+ * compressing and writing one slot while the next block is simulated. Slots are
+ * preallocated with the ring and reused lap after lap.
+ *
+ * When the disk falls behind, the ring fills up and the compute thread waits for
+ * a free slot; the waits are counted in the statistics, so a run reports whether
+ * its I/O was hidden or throttled the simulation.
+ *
+ * An error of the I/O thread ends the stream: it is rethrown by the next call on
+ * the compute thread, or by close().
+ */
+class AsyncAcquisitionFileWriter {
+public:
+    /**
+     * @param filename Path of the file, overwritten if it exists.
+     * @param digitizer Digitizer producing the codes.
+     * @param channel_names Names of the channels, in the order of the file.
+     * @param compression Compression of the channel blocks.
+     * @param ring_capacity Number of slots the compute thread may run ahead of the I/O thread.
+     *
+     * @throws std::runtime_error As AcquisitionFileWriter.
+     * @throws std::invalid_argument If ring_capacity is zero.
+     */
+    AsyncAcquisitionFileWriter(
+        const std::string& filename,
+        const Digitizer& digitizer,
+        const std::vector<std::string>& channel_names,
+        const AcquisitionCompression compression = AcquisitionCompression::none,
+        const size_t ring_capacity = 4
+    );
+
+    ~AsyncAcquisitionFileWriter();
+
+    AsyncAcquisitionFileWriter(const AsyncAcquisitionFileWriter&) = delete;
+    AsyncAcquisitionFileWriter& operator=(const AsyncAcquisitionFileWriter&) = delete;
+
+    /**
+     * @brief Queue one chunk of codes; the buffers are moved into the ring.
+     *
+     * @throws std::runtime_error If the I/O thread failed, or if the writer is closed.
+     */
+    void append_chunk(std::map<std::string, DigitizedChannel>&& channels);
+
+    /**
+     * @brief Queue triggered windows and their peak metrics.
+     *
+     * @param events Windows, in acquisition order.
+     * @param metrics Event major peak metrics of the windows, or empty.
+     *
+     * @throws std::runtime_error If the I/O thread failed, or if the writer is closed.
+     */
+    void append_events(std::vector<AcquisitionFileEvent>&& events, AcquisitionEventMetrics&& metrics);
+
+    /**
+     * @brief Wait for the queued slots to be written, write the index and close the file.
+     *
+     * @return Statistics of the stream.
+     *
+     * @throws std::runtime_error The error of the I/O thread, if any.
+     */
+    AsyncWriterStatistics close();
+
+private:
+    /**
+     * @brief One unit of work of the I/O thread: a chunk, events, or both.
+     */
+    struct Slot {
+        bool has_chunk = false;
+        std::map<std::string, DigitizedChannel> channels;
+        std::vector<AcquisitionFileEvent> events;
+        AcquisitionEventMetrics metrics;
+    };
+
+    AcquisitionFileWriter writer;
+    utils::SpscRing<Slot> ring;
+    std::thread io_thread;
+    std::exception_ptr io_error;
+    AsyncWriterStatistics statistics;
+    bool closed = false;
+
+    Slot& acquire_slot();
+    void publish_slot();
+    void drain();
+};
@@ -0,0 +1,584 @@
+#include "event_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include <utils/threading.h>
+
+
+namespace {
+
+// Below this magnitude values share the zero bucket of a sketch, which keeps bucket indices in int range.
+constexpr double smallest_sketched_magnitude = 1e-300;
+
+// Events accumulated by one partial of a large batch, independent of the team size.
+constexpr size_t events_per_partial = 4096;
+
+const std::vector<double>* find_metric(const EventMetricDictionary& metrics, const std::string& channel, const std::string& metric) {
+    const auto channel_iterator = metrics.find(channel);
+
+    if (channel_iterator == metrics.end()) {
+        return nullptr;
+    }
+
+    const auto metric_iterator = channel_iterator->second.find(metric);
+
+    return metric_iterator == channel_iterator->second.end() ? nullptr : &metric_iterator->second;
+}
+
+}  // namespace
+
+
+// ---------------------------------------------------------------- HistogramAxis
+
+HistogramAxis::HistogramAxis(const double lower, const double upper, const size_t number_of_bins, const bool logarithmic)
+    : lower(lower), upper(upper), number_of_bins(number_of_bins), logarithmic(logarithmic)
+{
+    if (!(upper > lower) || !std::isfinite(lower) || !std::isfinite(upper)) {
+        throw std::runtime_error("Histogram axis bounds must be finite with upper > lower.");
+    }
+
+    if (number_of_bins == 0) {
+        throw std::runtime_error("Histogram axis needs at least one bin.");
+    }
+
+    if (logarithmic && !(lower > 0.0)) {
+        throw std::runtime_error("Logarithmic histogram axis needs a strictly positive lower bound.");
+    }
+
+    this->origin = logarithmic ? std::log(lower) : lower;
+    this->bins_per_unit = static_cast<double>(number_of_bins) / (logarithmic ? std::log(upper) - std::log(lower) : upper - lower);
+}
+
+
+long long HistogramAxis::find_bin(const double value) const {
+    if (this->logarithmic && !(value > 0.0)) {
+        return -1;
+    }
+
+    const double position = ((this->logarithmic ? std::log(value) : value) - this->origin) * this->bins_per_unit;
+
+    if (position < 0.0) {
+        return -1;
+    }
+
+    if (position >= static_cast<double>(this->number_of_bins)) {
+        return static_cast<long long>(this->number_of_bins);
+    }
+
+    return static_cast<long long>(position);
+}
+
+
+std::vector<double> HistogramAxis::get_edges() const {
+    std::vector<double> edges(this->number_of_bins + 1);
+
+    for (size_t index = 0; index <= this->number_of_bins; ++index) {
+        const double position = this->origin + static_cast<double>(index) / this->bins_per_unit;
+        edges[index] = this->logarithmic ? std::exp(position) : position;
+    }
+
+    edges.front() = this->lower;
+    edges.back() = this->upper;
+
+    return edges;
+}
+
+
+// ---------------------------------------------------------------- Histograms
+
+void Histogram1D::add(const double value) {
+    const long long bin = this->axis.find_bin(value);
+
+    if (bin < 0) {
+        ++this->underflow;
+    } else if (bin >= static_cast<long long>(this->axis.number_of_bins)) {
+        ++this->overflow;
+    } else {
+        ++this->counts[static_cast<size_t>(bin)];
+    }
+}
+
+
+void Histogram1D::merge(const Histogram1D& other) {
+    for (size_t bin = 0; bin < this->counts.size(); ++bin) {
+        this->counts[bin] += other.counts[bin];
+    }
+
+    this->underflow += other.underflow;
+    this->overflow += other.overflow;
+}
+
+
+void Histogram2D::add(const double x, const double y) {
+    const long long x_bin = this->x_axis.find_bin(x);
+    const long long y_bin = this->y_axis.find_bin(y);
+
+    if (
+        x_bin < 0 || x_bin >= static_cast<long long>(this->x_axis.number_of_bins) ||
+        y_bin < 0 || y_bin >= static_cast<long long>(this->y_axis.number_of_bins)
+    ) {
+        ++this->outside;
+        return;
+    }
+
+    ++this->counts[static_cast<size_t>(x_bin) * this->y_axis.number_of_bins + static_cast<size_t>(y_bin)];
+}
+
+
+void Histogram2D::merge(const Histogram2D& other) {
+    for (size_t bin = 0; bin < this->counts.size(); ++bin) {
+        this->counts[bin] += other.counts[bin];
+    }
+
+    this->outside += other.outside;
+}
+
+
+// ---------------------------------------------------------------- RunningMoments
+
+void RunningMoments::add(const double value) {
+    if (this->count == 0) {
+        this->minimum = value;
+        this->maximum = value;
+    } else {
+        this->minimum = std::min(this->minimum, value);
+        this->maximum = std::max(this->maximum, value);
+    }
+
+    ++this->count;
+
+    const double delta = value - this->mean;
+    this->mean += delta / static_cast<double>(this->count);
+    this->sum_of_squared_deviations += delta * (value - this->mean);
+}
+
+
+void RunningMoments::merge(const RunningMoments& other) {
+    if (other.count == 0) {
+        return;
+    }
+
+    if (this->count == 0) {
+        *this = other;
+        return;
+    }
+
+    const double count = static_cast<double>(this->count);
+    const double other_count = static_cast<double>(other.count);
+    const double total_count = count + other_count;
+    const double delta = other.mean - this->mean;
+
+    this->mean += delta * other_count / total_count;
+    this->sum_of_squared_deviations += other.sum_of_squared_deviations + delta * delta * count * other_count / total_count;
+    this->minimum = std::min(this->minimum, other.minimum);
+    this->maximum = std::max(this->maximum, other.maximum);
+    this->count += other.count;
+}
+
+
+// ---------------------------------------------------------------- QuantileSketch
+
+QuantileSketch::QuantileSketch(const double relative_accuracy)
+    : relative_accuracy(relative_accuracy)
+{
+    if (!(relative_accuracy > 0.0 && relative_accuracy < 1.0)) {
+        throw std::runtime_error("relative_accuracy must be within (0, 1).");
+    }
+
+    this->log_gamma = std::log((1.0 + relative_accuracy) / (1.0 - relative_accuracy));
+}
+
+
+int QuantileSketch::get_bucket(const double magnitude) const {
+    return static_cast<int>(std::ceil(std::log(magnitude) / this->log_gamma));
+}
+
+
+double QuantileSketch::get_bucket_value(const int bucket) const {
+    // Midpoint in relative error of (gamma^(i-1), gamma^i].
+    const double gamma = std::exp(this->log_gamma);
+    return 2.0 * std::exp(static_cast<double>(bucket) * this->log_gamma) / (gamma + 1.0);
+}
+
+
+void QuantileSketch::add(const double value) {
+    ++this->count;
+
+    if (std::abs(value) < smallest_sketched_magnitude) {
+        ++this->zero_count;
+    } else if (value > 0.0) {
+        ++this->positive_buckets[this->get_bucket(value)];
+    } else {
+        ++this->negative_buckets[this->get_bucket(-value)];
+    }
+}
+
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.relative_accuracy != this->relative_accuracy) {
+        throw std::runtime_error("Quantile sketches of different relative accuracies cannot be merged.");
+    }
+
+    for (const auto& [bucket, bucket_count] : other.positive_buckets) {
+        this->positive_buckets[bucket] += bucket_count;
+    }
+
+    for (const auto& [bucket, bucket_count] : other.negative_buckets) {
+        this->negative_buckets[bucket] += bucket_count;
+    }
+
+    this->zero_count += other.zero_count;
+    this->count += other.count;
+}
+
+
+double QuantileSketch::get_quantile(const double quantile) const {
+    if (this->count == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    const double rank = std::clamp(quantile, 0.0, 1.0) * static_cast<double>(this->count - 1);
+    uint64_t cumulative_count = 0;
+
+    // Increasing values: negative buckets of decreasing magnitude, zero, positive buckets.
+    for (auto iterator = this->negative_buckets.rbegin(); iterator != this->negative_buckets.rend(); ++iterator) {
+        cumulative_count += iterator->second;
+
+        if (static_cast<double>(cumulative_count) > rank) {
+            return -this->get_bucket_value(iterator->first);
+        }
+    }
+
+    cumulative_count += this->zero_count;
+
+    if (static_cast<double>(cumulative_count) > rank) {
+        return 0.0;
+    }
+
+    for (const auto& [bucket, bucket_count] : this->positive_buckets) {
+        cumulative_count += bucket_count;
+
+        if (static_cast<double>(cumulative_count) > rank) {
+            return this->get_bucket_value(bucket);
+        }
+    }
+
+    return this->get_bucket_value(this->positive_buckets.rbegin()->first);
+}
+
+
+// ---------------------------------------------------------------- EventStatistics
+
+EventStatistics::EventStatistics(const double relative_accuracy)
+    : relative_accuracy(relative_accuracy)
+{
+    // Validates the accuracy once, rather than on the first sketched value.
+    (void) QuantileSketch(relative_accuracy);
+}
+
+
+void EventStatistics::add_histogram(const std::string& channel, const std::string& metric, const HistogramAxis& axis) {
+    Histogram1D histogram;
+    histogram.channel = channel;
+    histogram.metric = metric;
+    histogram.axis = axis;
+    histogram.counts.assign(axis.number_of_bins, 0);
+
+    this->histograms.push_back(std::move(histogram));
+}
+
+
+void EventStatistics::add_histogram_2d(
+    const std::string& x_channel,
+    const std::string& x_metric,
+    const HistogramAxis& x_axis,
+    const std::string& y_channel,
+    const std::string& y_metric,
+    const HistogramAxis& y_axis
+) {
+    Histogram2D histogram;
+    histogram.x_channel = x_channel;
+    histogram.x_metric = x_metric;
+    histogram.y_channel = y_channel;
+    histogram.y_metric = y_metric;
+    histogram.x_axis = x_axis;
+    histogram.y_axis = y_axis;
+    histogram.counts.assign(x_axis.number_of_bins * y_axis.number_of_bins, 0);
+
+    this->histograms_2d.push_back(std::move(histogram));
+}
+
+
+void EventStatistics::set_rate_axis(const HistogramAxis& axis) {
+    Histogram1D histogram;
+    histogram.channel = "";
+    histogram.metric = "Time";
+    histogram.axis = axis;
+    histogram.counts.assign(axis.number_of_bins, 0);
+
+    this->rate_histogram = std::move(histogram);
+}
+
+
+const MetricSummary& EventStatistics::get_summary(
+    const std::string& channel,
+    const std::string& metric,
+    const std::optional<int> label
+) const {
+    const auto iterator = this->summaries.find({label, channel, metric});
+
+    if (iterator == this->summaries.end()) {
+        throw std::out_of_range("No value of metric '" + metric + "' of channel '" + channel + "' was accumulated.");
+    }
+
+    return iterator->second;
+}
+
+
+MetricSummary& EventStatistics::get_or_create_summary(
+    const std::optional<int> label,
+    const std::string& channel,
+    const std::string& metric
+) {
+    return this->summaries.try_emplace(
+        SummaryKey{label, channel, metric},
+        MetricSummary{RunningMoments{}, QuantileSketch(this->relative_accuracy)}
+    ).first->second;
+}
+
+
+void EventStatistics::update(
+    const EventMetricDictionary& metrics,
+    const size_t peaks_per_event,
+    std::span<const size_t> start_indices,
+    std::span<const int> labels,
+    const std::optional<double> padding_value
+) {
+    const size_t number_of_events = start_indices.size();
+
+    if (!labels.empty() && labels.size() != number_of_events) {
+        throw std::runtime_error("EventStatistics needs one label per event.");
+    }
+
+    size_t number_of_metrics = 0;
+
+    for (const auto& [channel, dictionary] : metrics) {
+        for (const auto& [metric, values] : dictionary) {
+            if (values.size() != number_of_events * peaks_per_event) {
+                throw std::runtime_error(
+                    "Metric '" + metric + "' of channel '" + channel + "' does not hold peaks_per_event values per event."
+                );
+            }
+
+            ++number_of_metrics;
+        }
+    }
+
+    const size_t number_of_chunks = (number_of_events + events_per_partial - 1) / events_per_partial;
+
+    if (number_of_chunks <= 1) {
+        this->accumulate(metrics, peaks_per_event, start_indices, labels, padding_value, 0, number_of_events);
+        return;
+    }
+
+    const int team_size = utils::get_team_size(
+        number_of_events * std::max<size_t>(number_of_metrics * peaks_per_event, 1),
+        utils::ParallelComponent::peak_locator
+    );
+
+    // Fixed size chunks are accumulated apart and merged in event order, so the
+    // rounding of the moments does not depend on the team size.
+    const EventStatistics empty = this->clone_empty();
+    const size_t number_of_partials = std::min(static_cast<size_t>(std::max(team_size, 1)), number_of_chunks);
+    std::vector<EventStatistics> partials(number_of_partials, empty);
+
+    for (size_t first_chunk = 0; first_chunk < number_of_chunks; first_chunk += number_of_partials) {
+        const size_t wave_size = std::min(number_of_partials, number_of_chunks - first_chunk);
+
+        #pragma omp parallel for num_threads(static_cast<int>(wave_size)) schedule(static, 1)
+        for (size_t offset = 0; offset < wave_size; ++offset) {
+            const size_t chunk = first_chunk + offset;
+
+            partials[offset] = empty;
+            partials[offset].accumulate(
+                metrics,
+                peaks_per_event,
+                start_indices,
+                labels,
+                padding_value,
+                chunk * events_per_partial,
+                std::min((chunk + 1) * events_per_partial, number_of_events)
+            );
+        }
+
+        for (size_t offset = 0; offset < wave_size; ++offset) {
+            this->merge(partials[offset]);
+        }
+    }
+}
+
+
+void EventStatistics::accumulate(
+    const EventMetricDictionary& metrics,
+    const size_t peaks_per_event,
+    std::span<const size_t> start_indices,
+    std::span<const int> labels,
+    const std::optional<double> padding_value,
+    const size_t first_event,
+    const size_t end_event
+) {
+    const auto is_counted = [padding_value](const double value) {
+        return std::isfinite(value) && !(padding_value && value == *padding_value);
+    };
+
+    if (this->rate_histogram) {
+        for (size_t event = first_event; event < end_event; ++event) {
+            this->rate_histogram->add(static_cast<double>(start_indices[event]) * this->time_step);
+        }
+    }
+
+    for (const auto& [channel, dictionary] : metrics) {
+        for (const auto& [metric, values] : dictionary) {
+            if (metric == "Index") {
+                continue;
+            }
+
+            MetricSummary& summary = this->get_or_create_summary(std::nullopt, channel, metric);
+
+            for (size_t event = first_event; event < end_event; ++event) {
+                MetricSummary* labelled_summary = labels.empty()
+                    ? nullptr
+                    : &this->get_or_create_summary(labels[event], channel, metric);
+
+                for (size_t peak = 0; peak < peaks_per_event; ++peak) {
+                    const double value = values[event * peaks_per_event + peak];
+
+                    if (!is_counted(value)) {
+                        continue;
+                    }
+
+                    summary.moments.add(value);
+                    summary.sketch.add(value);
+
+                    if (labelled_summary) {
+                        labelled_summary->moments.add(value);
+                        labelled_summary->sketch.add(value);
+                    }
+                }
+            }
+        }
+    }
+
+    for (Histogram1D& histogram : this->histograms) {
+        const std::vector<double>* values = find_metric(metrics, histogram.channel, histogram.metric);
+
+        if (values == nullptr) {
+            continue;
+        }
+
+        for (size_t index = first_event * peaks_per_event; index < end_event * peaks_per_event; ++index) {
+            if (is_counted((*values)[index])) {
+                histogram.add((*values)[index]);
+            }
+        }
+    }
+
+    for (Histogram2D& histogram : this->histograms_2d) {
+        const std::vector<double>* x_values = find_metric(metrics, histogram.x_channel, histogram.x_metric);
+        const std::vector<double>* y_values = find_metric(metrics, histogram.y_channel, histogram.y_metric);
+
+        if (x_values == nullptr || y_values == nullptr) {
+            continue;
+        }
+
+        for (size_t index = first_event * peaks_per_event; index < end_event * peaks_per_event; ++index) {
+            if (is_counted((*x_values)[index]) && is_counted((*y_values)[index])) {
+                histogram.add((*x_values)[index], (*y_values)[index]);
+            }
+        }
+    }
+
+    this->number_of_events += end_event - first_event;
+}
+
+
+void EventStatistics::merge(const EventStatistics& other) {
+    const auto same_histogram = [](const Histogram1D& first, const Histogram1D& second) {
+        return first.channel == second.channel && first.metric == second.metric && first.axis == second.axis;
+    };
+
+    const auto same_histogram_2d = [](const Histogram2D& first, const Histogram2D& second) {
+        return first.x_channel == second.x_channel && first.x_metric == second.x_metric && first.x_axis == second.x_axis
+            && first.y_channel == second.y_channel && first.y_metric == second.y_metric && first.y_axis == second.y_axis;
+    };
+
+    if (
+        other.relative_accuracy != this->relative_accuracy ||
+        other.histograms.size() != this->histograms.size() ||
+        other.histograms_2d.size() != this->histograms_2d.size() ||
+        other.rate_histogram.has_value() != this->rate_histogram.has_value() ||
+        !std::equal(this->histograms.begin(), this->histograms.end(), other.histograms.begin(), same_histogram) ||
+        !std::equal(this->histograms_2d.begin(), this->histograms_2d.end(), other.histograms_2d.begin(), same_histogram_2d) ||
+        (this->rate_histogram && !(this->rate_histogram->axis == other.rate_histogram->axis))
+    ) {
+        throw std::runtime_error("Only event statistics with the same histograms and sketch accuracy can be merged.");
+    }
+
+    for (size_t index = 0; index < this->histograms.size(); ++index) {
+        this->histograms[index].merge(other.histograms[index]);
+    }
+
+    for (size_t index = 0; index < this->histograms_2d.size(); ++index) {
+        this->histograms_2d[index].merge(other.histograms_2d[index]);
+    }
+
+    if (this->rate_histogram) {
+        this->rate_histogram->merge(*other.rate_histogram);
+    }
+
+    for (const auto& [key, summary] : other.summaries) {
+        MetricSummary& merged = this->get_or_create_summary(std::get<0>(key), std::get<1>(key), std::get<2>(key));
+        merged.moments.merge(summary.moments);
+        merged.sketch.merge(summary.sketch);
+    }
+
+    this->number_of_events += other.number_of_events;
+}
+
+
+void EventStatistics::reset() {
+    for (Histogram1D& histogram : this->histograms) {
+        std::fill(histogram.counts.begin(), histogram.counts.end(), 0);
+        histogram.underflow = 0;
+        histogram.overflow = 0;
+    }
+
+    for (Histogram2D& histogram : this->histograms_2d) {
+        std::fill(histogram.counts.begin(), histogram.counts.end(), 0);
+        histogram.outside = 0;
+    }
+
+    if (this->rate_histogram) {
+        std::fill(this->rate_histogram->counts.begin(), this->rate_histogram->counts.end(), 0);
+        this->rate_histogram->underflow = 0;
+        this->rate_histogram->overflow = 0;
+    }
+
+    this->summaries.clear();
+    this->number_of_events = 0;
+}
+
+
+EventStatistics EventStatistics::clone_empty() const {
+    EventStatistics statistics(this->relative_accuracy);
+    statistics.time_step = this->time_step;
+    statistics.histograms = this->histograms;
+    statistics.histograms_2d = this->histograms_2d;
+    statistics.rate_histogram = this->rate_histogram;
+    statistics.reset();
+
+    return statistics;
+}
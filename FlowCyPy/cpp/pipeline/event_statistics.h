@@ -0,0 +1,284 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <digital_processing/peak_locator/peak_locator.h>
+
+
+/**
+ * @brief Binning of [lower, upper) into number_of_bins bins, uniform or uniform in log(value).
+ */
+class HistogramAxis {
+public:
+    double lower = 0.0;
+    double upper = 1.0;
+    size_t number_of_bins = 1;
+    bool logarithmic = false;
+
+    HistogramAxis() = default;
+
+    /**
+     * @throws std::runtime_error If upper <= lower, number_of_bins is zero, or a
+     *     logarithmic axis has a non positive lower bound.
+     */
+    HistogramAxis(const double lower, const double upper, const size_t number_of_bins, const bool logarithmic = false);
+
+    /**
+     * @brief Bin of value: -1 below lower, number_of_bins at or above upper.
+     */
+    long long find_bin(const double value) const;
+
+    /**
+     * @brief The number_of_bins + 1 bin edges.
+     */
+    std::vector<double> get_edges() const;
+
+    bool operator==(const HistogramAxis& other) const {
+        return this->lower == other.lower && this->upper == other.upper
+            && this->number_of_bins == other.number_of_bins && this->logarithmic == other.logarithmic;
+    }
+
+private:
+    double origin = 0.0;        // lower, or log(lower)
+    double bins_per_unit = 1.0; // per unit of value, or of log(value)
+};
+
+
+/**
+ * @brief Histogram of one metric of one channel.
+ */
+struct Histogram1D {
+    std::string channel;
+    std::string metric;
+    HistogramAxis axis;
+    std::vector<uint64_t> counts;
+    uint64_t underflow = 0;
+    uint64_t overflow = 0;
+
+    void add(const double value);
+    void merge(const Histogram1D& other);
+};
+
+
+/**
+ * @brief Density grid of two metrics of an event, e.g. the heights of two channels.
+ *
+ * counts[x_bin * y_axis.number_of_bins + y_bin], as numpy.histogram2d.
+ */
+struct Histogram2D {
+    std::string x_channel;
+    std::string x_metric;
+    std::string y_channel;
+    std::string y_metric;
+    HistogramAxis x_axis;
+    HistogramAxis y_axis;
+    std::vector<uint64_t> counts;
+    uint64_t outside = 0;
+
+    void add(const double x, const double y);
+    void merge(const Histogram2D& other);
+};
+
+
+/**
+ * @brief Count, mean, variance and range of a stream of values, mergeable across threads and runs.
+ */
+struct RunningMoments {
+    uint64_t count = 0;
+    double mean = 0.0;
+    double sum_of_squared_deviations = 0.0;
+    double minimum = 0.0;
+    double maximum = 0.0;
+
+    void add(const double value);
+
+    /**
+     * @brief Combine with the moments of another stream, as in Chan et al.
+     */
+    void merge(const RunningMoments& other);
+
+    double get_variance() const {
+        return this->count > 1 ? this->sum_of_squared_deviations / static_cast<double>(this->count - 1) : 0.0;
+    }
+};
+
+
+/**
+ * @brief Mergeable quantile sketch with a bounded relative error (DDSketch).
+ *
+ * Values are counted in buckets of logarithmically growing width, gamma^(i-1) < |x| <= gamma^i
+ * with gamma = (1 + a) / (1 - a), so a quantile estimate is within a relative error a
+ * of a value of the stream with that rank. Merging two sketches adds their buckets,
+ * so it gives exactly the sketch of the combined stream.
+ */
+class QuantileSketch {
+public:
+    QuantileSketch() : QuantileSketch(0.01) {}
+
+    /**
+     * @throws std::runtime_error If relative_accuracy is not within (0, 1).
+     */
+    explicit QuantileSketch(const double relative_accuracy);
+
+    void add(const double value);
+
+    /**
+     * @throws std::runtime_error If the sketches have different accuracies.
+     */
+    void merge(const QuantileSketch& other);
+
+    /**
+     * @brief Estimate of the value of rank quantile * (count - 1), NaN for an empty sketch.
+     */
+    double get_quantile(const double quantile) const;
+
+    uint64_t get_count() const { return this->count; }
+    double get_relative_accuracy() const { return this->relative_accuracy; }
+
+private:
+    double relative_accuracy;
+    double log_gamma;
+    uint64_t count = 0;
+    uint64_t zero_count = 0;
+    std::map<int, uint64_t> positive_buckets;
+    std::map<int, uint64_t> negative_buckets;
+
+    int get_bucket(const double magnitude) const;
+    double get_bucket_value(const int bucket) const;
+};
+
+
+/**
+ * @brief Moments and quantile sketch of one metric of one channel, for all events or one population label.
+ */
+struct MetricSummary {
+    RunningMoments moments;
+    QuantileSketch sketch;
+};
+
+
+/**
+ * @brief Streaming histograms and statistics of the peak metrics of a run.
+ *
+ * Each batch of events, e.g. the windows of one block, updates 1-D histograms,
+ * 2-D density grids, an event rate histogram over time, and the moments and
+ * quantile sketch of every metric of every channel. Summaries are kept for all
+ * events, under no label, and for every population label passed along.
+ * Large batches are split into fixed size chunks, filled over threads in their
+ * own copies of the bins and merged in event order, so the statistics do not
+ * depend on the number of threads. Statistics of several runs or processes
+ * merge with merge().
+ *
+ * Non finite metric values are skipped, and so are values equal to the padding
+ * value of the peak locator, which fills the slots of missing peaks and the
+ * undefined widths and areas. The "Index" metric is not accumulated.
+ */
+class EventStatistics {
+public:
+    /// Population label, or none for all events; channel; metric.
+    using SummaryKey = std::tuple<std::optional<int>, std::string, std::string>;
+
+    /// Duration of one sample in second, converting window start indices to times.
+    double time_step = 0.0;
+
+    /**
+     * @param relative_accuracy Relative accuracy of the quantile sketches.
+     *
+     * @throws std::runtime_error If relative_accuracy is not within (0, 1).
+     */
+    explicit EventStatistics(const double relative_accuracy = 0.01);
+
+    void add_histogram(const std::string& channel, const std::string& metric, const HistogramAxis& axis);
+
+    void add_histogram_2d(
+        const std::string& x_channel,
+        const std::string& x_metric,
+        const HistogramAxis& x_axis,
+        const std::string& y_channel,
+        const std::string& y_metric,
+        const HistogramAxis& y_axis
+    );
+
+    /**
+     * @brief Count the events over time, on an axis in second.
+     */
+    void set_rate_axis(const HistogramAxis& axis);
+
+    /**
+     * @brief Account for a batch of events.
+     *
+     * @param metrics Event major peak metrics of the batch, peaks_per_event values per event.
+     * @param peaks_per_event Number of values of every metric per event.
+     * @param start_indices Acquisition index of the first sample of every event window.
+     * @param labels Population label of every event, or empty.
+     * @param padding_value Padding value of the peak locator that produced the metrics, whose values are skipped.
+     *
+     * @throws std::runtime_error If the sizes of the metrics or labels do not match the events.
+     */
+    void update(
+        const EventMetricDictionary& metrics,
+        const size_t peaks_per_event,
+        std::span<const size_t> start_indices,
+        std::span<const int> labels = {},
+        const std::optional<double> padding_value = std::nullopt
+    );
+
+    /**
+     * @brief Add the counts of statistics with the same histograms.
+     *
+     * @throws std::runtime_error If the histograms or sketch accuracies differ.
+     */
+    void merge(const EventStatistics& other);
+
+    /**
+     * @brief Forget every count, keeping the histogram configuration.
+     */
+    void reset();
+
+    uint64_t get_number_of_events() const { return this->number_of_events; }
+    const std::vector<Histogram1D>& get_histograms() const { return this->histograms; }
+    const std::vector<Histogram2D>& get_histograms_2d() const { return this->histograms_2d; }
+    const std::optional<Histogram1D>& get_rate_histogram() const { return this->rate_histogram; }
+    const std::map<SummaryKey, MetricSummary>& get_summaries() const { return this->summaries; }
+
+    /**
+     * @throws std::out_of_range If no value of this channel, metric and label was seen.
+     */
+    const MetricSummary& get_summary(
+        const std::string& channel,
+        const std::string& metric,
+        const std::optional<int> label = std::nullopt
+    ) const;
+
+private:
+    double relative_accuracy;
+    uint64_t number_of_events = 0;
+    std::vector<Histogram1D> histograms;
+    std::vector<Histogram2D> histograms_2d;
+    std::optional<Histogram1D> rate_histogram;
+    std::map<SummaryKey, MetricSummary> summaries;
+
+    /**
+     * @brief Statistics with the same configuration and no count.
+     */
+    EventStatistics clone_empty() const;
+
+    MetricSummary& get_or_create_summary(const std::optional<int> label, const std::string& channel, const std::string& metric);
+
+    void accumulate(
+        const EventMetricDictionary& metrics,
+        const size_t peaks_per_event,
+        std::span<const size_t> start_indices,
+        std::span<const int> labels,
+        const std::optional<double> padding_value,
+        const size_t first_event,
+        const size_t end_event
+    );
+};
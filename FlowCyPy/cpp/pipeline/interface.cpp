@@ -0,0 +1,1457 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "acquisition_file.h"
+#include "acquisition_pipeline.h"
+#include "acquisition_replay.h"
+#include "acquisition_sweep.h"
+#include "event_statistics.h"
+#include <pint/pint.h>
+#include <utils/module_binding.h>
+#include <utils/numpy.h>
+#include <utils/offload.h>
+#include <utils/profiler_binding.h>
+#include <utils/threading_binding.h>
+#include <utils/random_binding.h>
+
+namespace py = pybind11;
+
+
+namespace {
+
+// FixedWindow, DynamicWindow and DoubleThreshold are streamed; an OnlineDiscriminator is taken as is.
+OnlineDiscriminator to_online_discriminator(const py::object& discriminator) {
+    if (py::isinstance<OnlineDiscriminator>(discriminator)) {
+        return py::cast<const OnlineDiscriminator&>(discriminator);
+    }
+
+    if (py::isinstance<FixedWindow>(discriminator)) {
+        return OnlineDiscriminator(py::cast<const FixedWindow&>(discriminator));
+    }
+
+    if (py::isinstance<DynamicWindow>(discriminator)) {
+        return OnlineDiscriminator(py::cast<const DynamicWindow&>(discriminator));
+    }
+
+    if (py::isinstance<DoubleThreshold>(discriminator)) {
+        return OnlineDiscriminator(py::cast<const DoubleThreshold&>(discriminator));
+    }
+
+    throw std::invalid_argument(
+        "discriminator must be a FixedWindow, DynamicWindow, DoubleThreshold or OnlineDiscriminator."
+    );
+}
+
+
+// Convert window-major metrics into {channel: {metric: array of shape (n_events, max_number_of_peaks)}}.
+py::dict build_metric_output(EventMetricDictionary&& metrics, const size_t max_number_of_peaks) {
+    py::dict output;
+
+    for (auto& [channel_name, metric_dictionary] : metrics) {
+        py::dict channel_output;
+
+        for (auto& [metric_name, metric_values] : metric_dictionary) {
+            const py::ssize_t number_of_events = static_cast<py::ssize_t>(metric_values.size() / max_number_of_peaks);
+
+            channel_output[py::str(metric_name)] =
+                vector_to_numpy_without_copy(std::move(metric_values))
+                    .attr("reshape")(number_of_events, static_cast<py::ssize_t>(max_number_of_peaks));
+        }
+
+        output[py::str(channel_name)] = channel_output;
+    }
+
+    return output;
+}
+
+
+// Convert {channel: {metric: array of shape (n_events, peaks_per_event)}} back into window-major metrics.
+EventMetricDictionary metric_dictionary_from_python(const py::dict& peaks, const size_t number_of_events, size_t& peaks_per_event) {
+    EventMetricDictionary metrics;
+    peaks_per_event = 0;
+
+    for (const auto& [channel_name, channel_metrics] : peaks) {
+        for (const auto& [metric_name, values] : py::cast<py::dict>(channel_metrics)) {
+            const contiguous_array<double> array = to_contiguous_array<double>(values);
+
+            if (number_of_events > 0) {
+                peaks_per_event = static_cast<size_t>(array.size()) / number_of_events;
+            }
+
+            metrics[py::cast<std::string>(channel_name)][py::cast<std::string>(metric_name)] = array_to_vector(array);
+        }
+    }
+
+    return metrics;
+}
+
+
+// Counts and edges of a histogram, as numpy.histogram returns them.
+py::tuple histogram_to_tuple(const Histogram1D& histogram) {
+    return py::make_tuple(
+        vector_to_numpy_without_copy(std::vector<uint64_t>(histogram.counts)),
+        vector_to_numpy_without_copy(histogram.axis.get_edges())
+    );
+}
+
+
+std::string compression_to_string(const AcquisitionCompression value) {
+    if (value == AcquisitionCompression::zstd) {
+        return "zstd";
+    }
+
+    return "none";
+}
+
+
+AcquisitionCompression parse_compression(const std::string& value) {
+    if (value == "none") {
+        return AcquisitionCompression::none;
+    }
+
+    if (value == "zstd") {
+        return AcquisitionCompression::zstd;
+    }
+
+    throw std::invalid_argument("compression must be 'none' or 'zstd'.");
+}
+
+
+std::string precision_to_string(const SignalPrecision value) {
+    if (value == SignalPrecision::float32) {
+        return "float32";
+    }
+
+    return "float64";
+}
+
+
+SignalPrecision parse_precision(const std::string& value) {
+    if (value == "float64") {
+        return SignalPrecision::float64;
+    }
+
+    if (value == "float32") {
+        return SignalPrecision::float32;
+    }
+
+    throw std::invalid_argument("precision must be 'float64' or 'float32'.");
+}
+
+
+std::string code_type_to_string(const CodeType value) {
+    switch (value) {
+        case CodeType::int8: return "int8";
+        case CodeType::uint8: return "uint8";
+        case CodeType::int16: return "int16";
+        case CodeType::uint16: return "uint16";
+        case CodeType::int32: return "int32";
+        case CodeType::uint32: return "uint32";
+        case CodeType::int64: return "int64";
+        case CodeType::uint64: return "uint64";
+    }
+
+    return "int64";
+}
+
+
+py::array code_buffer_to_numpy(CodeBuffer&& codes) {
+    return std::visit(
+        [](auto&& code_vector) -> py::array {
+            return vector_to_numpy_without_copy(std::move(code_vector));
+        },
+        std::move(codes)
+    );
+}
+
+
+// Convert a run or replay result into the dictionary returned by AcquisitionPipeline.run.
+py::dict result_to_dict(
+    const py::object& ureg,
+    const BasePeakLocator* peak_locator,
+    const bool keep_segments,
+    const bool digitized,
+    AcquisitionPipelineResult&& result
+) {
+    py::dict output;
+    output["number_of_samples"] = result.number_of_samples;
+    output["number_of_blocks"] = result.number_of_blocks;
+    output["start_index"] = vector_to_numpy_without_copy(std::move(result.start_indices));
+
+    if (peak_locator) {
+        output["peaks"] = build_metric_output(
+            std::move(result.metrics),
+            static_cast<size_t>(peak_locator->max_number_of_peaks)
+        );
+    } else {
+        output["peaks"] = py::none();
+    }
+
+    if (result.spill_statistics) {
+        const AsyncWriterStatistics& statistics = *result.spill_statistics;
+
+        py::dict spill;
+        spill["number_of_chunks"] = statistics.number_of_chunks;
+        spill["number_of_events"] = statistics.number_of_events;
+        spill["ring_capacity"] = statistics.ring_capacity;
+        spill["max_queued_slots"] = statistics.max_queued_slots;
+        spill["number_of_producer_stalls"] = statistics.number_of_producer_stalls;
+        spill["producer_stall_time"] = py::float_(statistics.producer_stall_time) * ureg.attr("second");
+        spill["write_time"] = py::float_(statistics.write_time) * ureg.attr("second");
+        spill["file_size"] = statistics.file_size;
+
+        output["spill"] = spill;
+    } else {
+        output["spill"] = py::none();
+    }
+
+    if (result.statistics) {
+        output["statistics"] = py::cast(std::move(*result.statistics));
+    } else {
+        output["statistics"] = py::none();
+    }
+
+    if (!keep_segments) {
+        output["segments"] = py::none();
+        return output;
+    }
+
+    std::vector<int> segment_ids;
+    segment_ids.reserve(result.segment_time.size());
+
+    for (size_t window = 0; window + 1 < result.segment_offsets.size(); ++window) {
+        segment_ids.insert(
+            segment_ids.end(),
+            result.segment_offsets[window + 1] - result.segment_offsets[window],
+            static_cast<int>(window)
+        );
+    }
+
+    py::dict segments;
+    segments["segment_id"] = vector_to_numpy_without_copy(std::move(segment_ids));
+    segments["Time"] = vector_to_numpy_without_copy(std::move(result.segment_time)) * ureg.attr("second");
+
+    for (auto& [channel_name, samples] : result.segment_signals) {
+        py::object channel = vector_to_numpy_without_copy(std::move(samples));
+        segments[py::str(channel_name)] = digitized ? channel : channel * ureg.attr("volt");
+    }
+
+    output["segments"] = segments;
+
+    return output;
+}
+
+
+py::dict result_to_dict(const py::object& ureg, const AcquisitionPipeline& pipeline, AcquisitionPipelineResult&& result) {
+    return result_to_dict(
+        ureg,
+        pipeline.peak_locator.get(),
+        pipeline.keep_segments,
+        pipeline.digitizer.should_digitize(),
+        std::move(result)
+    );
+}
+
+
+// Transit events from pint quantities: velocities, centers and a (n_events, n_detectors) amplitude array.
+PipelineEvents quantities_to_events(const py::object& velocities, const py::object& centers, const py::object& amplitudes) {
+    PipelineEvents events;
+    events.velocities = array_to_vector(quantity_to_contiguous_array<double>(velocities, "meter / second"));
+    events.centers = array_to_vector(quantity_to_contiguous_array<double>(centers, "second"));
+    events.amplitudes = array_to_vector(quantity_to_contiguous_array<double>(amplitudes, "watt"));
+
+    return events;
+}
+
+}  // namespace
+
+
+FLOWCYPY_MODULE(acquisition_pipeline, module) {
+    py::object ureg = get_shared_ureg();
+
+    // The stage types are registered by their own modules.
+    py::module_::import("FlowCyPy.opto_electronics.source");
+    py::module_::import("FlowCyPy.opto_electronics.detector");
+    py::module_::import("FlowCyPy.opto_electronics.amplifier");
+    py::module_::import("FlowCyPy.opto_electronics.digitizer");
+    py::module_::import("FlowCyPy.opto_electronics.circuits");
+    py::module_::import("FlowCyPy.digital_processing.discriminator");
+    py::module_::import("FlowCyPy.digital_processing.peak_locator");
+
+    module.doc() = R"pbdoc(
+        Streaming acquisition pipeline for FlowCyPy.
+
+        This module runs pulse synthesis, opto electronic noise, analog circuits,
+        triggering, digitization and peak location block by block, in constant
+        memory, with synthesis and analysis overlapped on two threads, and
+        runs batches of such runs, e.g. parameter sweeps, across cores.
+    )pbdoc";
+
+    register_random_seed_functions(module);
+    register_profiling_functions(module);
+    register_threading_functions(module);
+
+    py::class_<HistogramAxis>(
+        module,
+        "HistogramAxis",
+        R"pbdoc(
+            Binning of ``[lower, upper)`` into bins of equal width, in value or in log(value).
+
+            Parameters
+            ----------
+            lower : float
+                Lower edge of the first bin, strictly positive on a logarithmic axis.
+            upper : float
+                Upper edge of the last bin.
+            number_of_bins : int
+                Number of bins.
+            logarithmic : bool, optional
+                Whether the bins have equal widths in log(value).
+
+            Raises
+            ------
+            RuntimeError
+                If ``upper <= lower``, ``number_of_bins`` is 0, or a logarithmic
+                axis has a non positive lower bound.
+        )pbdoc"
+    )
+        .def(
+            py::init<double, double, size_t, bool>(),
+            py::arg("lower"),
+            py::arg("upper"),
+            py::arg("number_of_bins"),
+            py::arg("logarithmic") = false
+        )
+        .def_readonly("lower", &HistogramAxis::lower)
+        .def_readonly("upper", &HistogramAxis::upper)
+        .def_readonly("number_of_bins", &HistogramAxis::number_of_bins)
+        .def_readonly("logarithmic", &HistogramAxis::logarithmic)
+        .def_property_readonly(
+            "edges",
+            [](const HistogramAxis& self) {
+                return vector_to_numpy_without_copy(self.get_edges());
+            },
+            R"pbdoc(
+                The ``number_of_bins + 1`` bin edges.
+            )pbdoc"
+        )
+        .def(
+            "__repr__",
+            [](const HistogramAxis& self) {
+                return
+                    "HistogramAxis(lower=" + std::to_string(self.lower) +
+                    ", upper=" + std::to_string(self.upper) +
+                    ", number_of_bins=" + std::to_string(self.number_of_bins) +
+                    ", logarithmic=" + (self.logarithmic ? "True" : "False") + ")";
+            }
+        );
+
+    py::class_<EventStatistics>(
+        module,
+        "EventStatistics",
+        R"pbdoc(
+            Streaming histograms and statistics of the peak metrics of a run.
+
+            Each batch of events updates the configured 1-D histograms, 2-D
+            density grids and event rate histogram, along with the moments and
+            a quantile sketch of every metric of every channel, for all events
+            and for every population label given to :meth:`update`. Large
+            batches are split into fixed size chunks filled over threads and
+            merged in event order, so the statistics do not depend on the
+            number of threads. Non finite values, values equal to the padding
+            value of the peak locator, which fills missing peaks and undefined
+            widths and areas, and the ``"Index"`` metric are skipped.
+
+            Assigned to :attr:`AcquisitionPipeline.event_statistics`, the
+            configuration is accumulated, from no count, over every run, and
+            returned as the ``"statistics"`` entry of its output. Accumulators
+            of several runs or processes combine with :meth:`merge`.
+
+            Parameters
+            ----------
+            relative_accuracy : float, optional
+                Relative accuracy of the quantile estimates.
+        )pbdoc"
+    )
+        .def(py::init<double>(), py::arg("relative_accuracy") = 0.01)
+        .def(
+            "add_histogram",
+            &EventStatistics::add_histogram,
+            py::arg("channel"),
+            py::arg("metric"),
+            py::arg("axis"),
+            R"pbdoc(
+                Histogram a metric of a channel, e.g. ``("FSC", "Height")``.
+            )pbdoc"
+        )
+        .def(
+            "add_histogram_2d",
+            &EventStatistics::add_histogram_2d,
+            py::arg("x_channel"),
+            py::arg("x_metric"),
+            py::arg("x_axis"),
+            py::arg("y_channel"),
+            py::arg("y_metric"),
+            py::arg("y_axis"),
+            R"pbdoc(
+                Density grid of two metrics of every peak, e.g. the heights of two channels.
+            )pbdoc"
+        )
+        .def(
+            "set_rate_axis",
+            [](EventStatistics& self, const py::object& start, const py::object& stop, const size_t number_of_bins) {
+                self.set_rate_axis(
+                    HistogramAxis(
+                        start.attr("to")("second").attr("magnitude").cast<double>(),
+                        stop.attr("to")("second").attr("magnitude").cast<double>(),
+                        number_of_bins
+                    )
+                );
+            },
+            py::arg("start"),
+            py::arg("stop"),
+            py::arg("number_of_bins"),
+            R"pbdoc(
+                Count the events over acquisition time, from the start of their windows.
+
+                Parameters
+                ----------
+                start, stop : pint.Quantity
+                    Time span of the rate histogram.
+                number_of_bins : int
+                    Number of time bins.
+            )pbdoc"
+        )
+        .def(
+            "update",
+            [](EventStatistics& self, const py::dict& peaks, const py::object& start_index, const py::object& labels, const std::optional<double> padding_value) {
+                const std::vector<size_t> start_indices = array_to_vector(to_contiguous_array<size_t>(start_index));
+                const std::vector<int> label_values = labels.is_none()
+                    ? std::vector<int>()
+                    : array_to_vector(to_contiguous_array<int>(labels));
+
+                size_t peaks_per_event = 0;
+                const EventMetricDictionary metrics = metric_dictionary_from_python(peaks, start_indices.size(), peaks_per_event);
+
+                py::gil_scoped_release release;
+                self.update(metrics, peaks_per_event, start_indices, label_values, padding_value);
+            },
+            py::arg("peaks"),
+            py::arg("start_index"),
+            py::arg("labels") = py::none(),
+            py::arg("padding_value") = py::none(),
+            R"pbdoc(
+                Account for a batch of events.
+
+                Parameters
+                ----------
+                peaks : dict
+                    Peak metrics in the :meth:`BasePeakLocator.run` format, arrays of
+                    shape ``(n_events, max_number_of_peaks)``.
+                start_index : numpy.ndarray
+                    Acquisition index of the first sample of every event window.
+                labels : numpy.ndarray, optional
+                    Population label of every event, e.g. from a classifier.
+                padding_value : float, optional
+                    ``padding_value`` of the peak locator that produced the
+                    metrics. Values equal to it are skipped as missing peaks.
+
+                Raises
+                ------
+                RuntimeError
+                    If the metrics or labels do not match the events.
+            )pbdoc"
+        )
+        .def(
+            "merge",
+            &EventStatistics::merge,
+            py::arg("other"),
+            R"pbdoc(
+                Add the counts of statistics with the same histograms.
+
+                Raises
+                ------
+                RuntimeError
+                    If the histograms or quantile accuracies differ.
+            )pbdoc"
+        )
+        .def(
+            "reset",
+            &EventStatistics::reset,
+            R"pbdoc(
+                Forget every count, keeping the histograms.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "number_of_events",
+            &EventStatistics::get_number_of_events,
+            R"pbdoc(
+                Number of events accounted for.
+            )pbdoc"
+        )
+        .def(
+            "get_histogram",
+            [](const EventStatistics& self, const size_t index) {
+                const std::vector<Histogram1D>& histograms = self.get_histograms();
+
+                if (index >= histograms.size()) {
+                    throw std::out_of_range("Histogram index out of range.");
+                }
+
+                return histogram_to_tuple(histograms[index]);
+            },
+            py::arg("index"),
+            R"pbdoc(
+                Counts and edges of a 1-D histogram, in the order they were added.
+
+                Returns
+                -------
+                tuple of numpy.ndarray
+                    Counts, of shape ``(number_of_bins,)``, and edges, as :func:`numpy.histogram`.
+            )pbdoc"
+        )
+        .def(
+            "get_histogram_2d",
+            [](const EventStatistics& self, const size_t index) {
+                const std::vector<Histogram2D>& histograms = self.get_histograms_2d();
+
+                if (index >= histograms.size()) {
+                    throw std::out_of_range("2-D histogram index out of range.");
+                }
+
+                const Histogram2D& histogram = histograms[index];
+
+                return py::make_tuple(
+                    vector_to_numpy_without_copy(std::vector<uint64_t>(histogram.counts)).attr("reshape")(
+                        static_cast<py::ssize_t>(histogram.x_axis.number_of_bins),
+                        static_cast<py::ssize_t>(histogram.y_axis.number_of_bins)
+                    ),
+                    vector_to_numpy_without_copy(histogram.x_axis.get_edges()),
+                    vector_to_numpy_without_copy(histogram.y_axis.get_edges())
+                );
+            },
+            py::arg("index"),
+            R"pbdoc(
+                Counts and edges of a 2-D density grid, in the order they were added.
+
+                Returns
+                -------
+                tuple of numpy.ndarray
+                    Counts, of shape ``(x bins, y bins)``, and the x and y edges, as
+                    :func:`numpy.histogram2d`.
+            )pbdoc"
+        )
+        .def(
+            "get_rate",
+            [ureg](const EventStatistics& self) -> py::object {
+                const std::optional<Histogram1D>& histogram = self.get_rate_histogram();
+
+                if (!histogram) {
+                    return py::none();
+                }
+
+                const std::vector<double> edges = histogram->axis.get_edges();
+                std::vector<double> rates(histogram->counts.size());
+
+                for (size_t bin = 0; bin < rates.size(); ++bin) {
+                    rates[bin] = static_cast<double>(histogram->counts[bin]) / (edges[bin + 1] - edges[bin]);
+                }
+
+                return py::make_tuple(
+                    vector_to_numpy_without_copy(std::move(rates)) * ureg.attr("hertz"),
+                    vector_to_numpy_without_copy(std::vector<double>(edges)) * ureg.attr("second")
+                );
+            },
+            R"pbdoc(
+                Event rate over acquisition time, or None without :meth:`set_rate_axis`.
+
+                Returns
+                -------
+                tuple of pint.Quantity
+                    Rate of every time bin and the bin edges.
+            )pbdoc"
+        )
+        .def(
+            "get_summary",
+            [](const EventStatistics& self, const std::string& channel, const std::string& metric, const std::optional<int> label) {
+                const RunningMoments& moments = self.get_summary(channel, metric, label).moments;
+
+                py::dict output;
+                output["count"] = moments.count;
+                output["mean"] = moments.mean;
+                output["variance"] = moments.get_variance();
+                output["min"] = moments.minimum;
+                output["max"] = moments.maximum;
+
+                return output;
+            },
+            py::arg("channel"),
+            py::arg("metric"),
+            py::arg("label") = py::none(),
+            R"pbdoc(
+                Count, mean, sample variance, min and max of a metric.
+
+                Parameters
+                ----------
+                channel, metric : str
+                    Metric of a channel, e.g. ``("FSC", "Height")``.
+                label : int, optional
+                    Population label, or None for all events.
+
+                Raises
+                ------
+                IndexError
+                    If no value of this metric, channel and label was accounted for.
+            )pbdoc"
+        )
+        .def(
+            "get_quantile",
+            [](const EventStatistics& self, const std::string& channel, const std::string& metric, const double quantile, const std::optional<int> label) {
+                return self.get_summary(channel, metric, label).sketch.get_quantile(quantile);
+            },
+            py::arg("channel"),
+            py::arg("metric"),
+            py::arg("quantile"),
+            py::arg("label") = py::none(),
+            R"pbdoc(
+                Estimate of a quantile of a metric, within the relative accuracy of the sketch.
+
+                Parameters
+                ----------
+                channel, metric : str
+                    Metric of a channel.
+                quantile : float
+                    Quantile within ``[0, 1]``, e.g. 0.5 for the median.
+                label : int, optional
+                    Population label, or None for all events.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "labels",
+            [](const EventStatistics& self) {
+                std::vector<int> labels;
+
+                for (const auto& [key, summary] : self.get_summaries()) {
+                    const std::optional<int>& label = std::get<0>(key);
+
+                    if (label && std::find(labels.begin(), labels.end(), *label) == labels.end()) {
+                        labels.push_back(*label);
+                    }
+                }
+
+                std::sort(labels.begin(), labels.end());
+                return labels;
+            },
+            R"pbdoc(
+                Population labels with a summary, sorted.
+            )pbdoc"
+        )
+        .def(
+            "__repr__",
+            [](const EventStatistics& self) {
+                return
+                    "EventStatistics(events=" + std::to_string(self.get_number_of_events()) +
+                    ", histograms=" + std::to_string(self.get_histograms().size()) +
+                    ", histograms_2d=" + std::to_string(self.get_histograms_2d().size()) + ")";
+            }
+        );
+
+    py::class_<AcquisitionPipeline, std::shared_ptr<AcquisitionPipeline>>(
+        module,
+        "AcquisitionPipeline",
+        R"pbdoc(
+            Constant memory acquisition engine running every stage of a run block by block.
+
+            Samples are synthesized, made noisy and filtered by a producer thread,
+            then triggered, digitized and measured on the calling thread, the two
+            exchanging at most ``queue_depth`` blocks of ``block_size`` samples.
+            Only the triggered windows and their metrics are kept.
+
+            Each block is exact: pulses are evaluated on the block time stamps,
+            noise is indexed by acquisition sample, and stateful stages carry
+            their state across blocks, so the output does not depend on
+            ``block_size``. FFT low-pass circuits and the amplifier filter run as
+            their causal IIR cascade. Auto voltage ranges and symbolic thresholds
+            such as ``"3sigma"`` are resolved on the first ``warm_up_samples``
+            samples of the run, whatever ``block_size``.
+
+            Parameters
+            ----------
+            source : BaseSource
+                Light source synthesizing the pulses.
+            detectors : list[Detector]
+                Detectors, one channel each.
+            amplifier : Amplifier
+                Transimpedance amplifier shared by the detectors.
+            digitizer : Digitizer
+                Digitizer setting the sampling rate and the ADC codes.
+            discriminator : FixedWindow or DynamicWindow or DoubleThreshold or OnlineDiscriminator
+                Detector extracting the event windows.
+            circuits : list[BaseCircuit], optional
+                Analog circuits applied, in order, to every channel.
+            peak_locator : BasePeakLocator or None, optional
+                Peak locator applied to the digitized windows.
+            background_power : pint.Quantity, optional
+                Constant optical power added to every channel.
+        )pbdoc"
+    )
+        .def(
+            py::init(
+                [](
+                    const std::shared_ptr<BaseSource>& source,
+                    const py::list& detectors,
+                    const Amplifier& amplifier,
+                    const Digitizer& digitizer,
+                    const py::object& discriminator,
+                    const std::vector<std::shared_ptr<BaseCircuit>>& circuits,
+                    const std::shared_ptr<BasePeakLocator>& peak_locator,
+                    const py::object& background_power
+                ) {
+                    std::vector<Detector> detector_list;
+                    detector_list.reserve(detectors.size());
+
+                    for (const py::handle& detector : detectors) {
+                        detector_list.push_back(py::cast<const Detector&>(detector));
+                    }
+
+                    const double background_power_watt = background_power.is_none()
+                        ? 0.0
+                        : background_power.attr("to")("watt").attr("magnitude").cast<double>();
+
+                    return std::make_shared<AcquisitionPipeline>(
+                        source,
+                        std::move(detector_list),
+                        amplifier,
+                        digitizer,
+                        circuits,
+                        to_online_discriminator(discriminator),
+                        peak_locator,
+                        background_power_watt
+                    );
+                }
+            ),
+            py::arg("source"),
+            py::arg("detectors"),
+            py::arg("amplifier"),
+            py::arg("digitizer"),
+            py::arg("discriminator"),
+            py::arg("circuits") = std::vector<std::shared_ptr<BaseCircuit>>{},
+            py::arg("peak_locator") = nullptr,
+            py::arg("background_power") = py::none()
+        )
+        .def_readwrite(
+            "block_size",
+            &AcquisitionPipeline::block_size,
+            R"pbdoc(
+                Number of samples per block.
+            )pbdoc"
+        )
+        .def_readwrite(
+            "queue_depth",
+            &AcquisitionPipeline::queue_depth,
+            R"pbdoc(
+                Number of blocks the producer thread may run ahead of the analysis,
+                and the analysis ahead of the I/O thread of the spill.
+            )pbdoc"
+        )
+        .def_readwrite(
+            "warm_up_samples",
+            &AcquisitionPipeline::warm_up_samples,
+            R"pbdoc(
+                Number of leading samples resolving auto voltage ranges and symbolic thresholds.
+
+                Blocks are held back until this many samples are available, so
+                the resolved ranges and thresholds do not depend on ``block_size``.
+                Runs shorter than the window resolve them on every sample.
+            )pbdoc"
+        )
+        .def_readwrite(
+            "keep_segments",
+            &AcquisitionPipeline::keep_segments,
+            R"pbdoc(
+                Whether the digitized windows are returned along with the metrics.
+            )pbdoc"
+        )
+        .def_property(
+            "spill_filename",
+            [](const AcquisitionPipeline& self) -> std::optional<std::string> {
+                if (self.spill_filename.empty()) {
+                    return std::nullopt;
+                }
+
+                return self.spill_filename;
+            },
+            [](AcquisitionPipeline& self, const py::object& value) {
+                self.spill_filename = value.is_none()
+                    ? std::string()
+                    : py::module_::import("os").attr("fspath")(value).cast<std::string>();
+            },
+            R"pbdoc(
+                Acquisition file receiving the ADC codes and windows of every run, or None.
+
+                Every block is digitized whole and queued, with the triggered windows
+                and their peak metrics, to an I/O thread writing the file while the
+                next blocks are processed; at most ``queue_depth`` blocks wait for
+                the disk. The file can be read back with :class:`AcquisitionFileReader`
+                and reprocessed with :func:`replay`. Each run rewrites the file, so
+                an :class:`AcquisitionSweep` rejects runs spilling to the same file.
+                Spilling requires a digitizer with a non zero bit depth.
+            )pbdoc"
+        )
+        .def_property(
+            "spill_compression",
+            [](const AcquisitionPipeline& self) {
+                return compression_to_string(self.spill_compression);
+            },
+            [](AcquisitionPipeline& self, const std::string& value) {
+                self.spill_compression = parse_compression(value);
+            },
+            R"pbdoc(
+                Compression of the spilled channel blocks, ``"none"`` or ``"zstd"``.
+
+                ``"zstd"`` is only available when FlowCyPy is built with zstd.
+            )pbdoc"
+        )
+        .def_property(
+            "precision",
+            [](const AcquisitionPipeline& self) {
+                return precision_to_string(self.precision);
+            },
+            [](AcquisitionPipeline& self, const std::string& value) {
+                self.precision = parse_precision(value);
+            },
+            R"pbdoc(
+                Sample type of the analog blocks, ``"float64"`` or ``"float32"``.
+
+                With ``"float32"``, pulse synthesis, opto electronic noise and the
+                analog circuits store their samples as floats, halving their memory
+                traffic. Computations and filter states stay in double precision,
+                and blocks are widened back to double before the discriminator, so
+                only the rounding of the analog samples differs from ``"float64"``.
+            )pbdoc"
+        )
+        .def_property(
+            "use_device",
+            [](const AcquisitionPipeline& self) {
+                return self.chain.use_device;
+            },
+            [](AcquisitionPipeline& self, const bool value) {
+                if (value && !utils::offload::is_device_available()) {
+                    throw std::invalid_argument(
+                        "use_device requires FlowCyPy built with FLOWCYPY_OPENMP_OFFLOAD and an available OpenMP target device."
+                    );
+                }
+
+                self.chain.use_device = value;
+            },
+            R"pbdoc(
+                Whether the fused noise pass of each block runs on the OpenMP offload device.
+
+                RIN, shot noise, dark current noise and the amplifier gain are then
+                computed on the device, channel by channel, with the same counter
+                based random streams as on the host. The analog filters, the
+                discriminator and the digitizer stay on the host. See
+                :func:`is_offload_device_available`.
+            )pbdoc"
+        )
+        .def_readwrite(
+            "event_statistics",
+            &AcquisitionPipeline::event_statistics,
+            R"pbdoc(
+                :class:`EventStatistics` accumulated by every run, or None.
+
+                Each run starts from a copy of it without counts and updates the
+                copy with the metrics of every block as they leave the peak
+                locator. The copy is returned as the ``"statistics"`` entry of
+                :meth:`run`; the accumulator assigned here is left untouched.
+            )pbdoc"
+        )
+        .def_readwrite(
+            "debug_mode",
+            &AcquisitionPipeline::debug_mode,
+            R"pbdoc(
+                Whether diagnostic information is printed during processing.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "source",
+            [](const AcquisitionPipeline& self) {
+                return self.source;
+            },
+            R"pbdoc(
+                Light source of the pipeline.
+            )pbdoc"
+        )
+        .def(
+            "run",
+            [ureg](
+                const AcquisitionPipeline& self,
+                const py::object& run_time,
+                const py::object& velocities,
+                const py::object& centers,
+                const py::object& amplitudes
+            ) {
+                const PipelineEvents events = quantities_to_events(velocities, centers, amplitudes);
+                const double run_time_second = run_time.attr("to")("second").attr("magnitude").cast<double>();
+
+                AcquisitionPipelineResult result;
+                {
+                    py::gil_scoped_release release;
+                    result = self.run(events, run_time_second);
+                }
+
+                return result_to_dict(ureg, self, std::move(result));
+            },
+            py::arg("run_time"),
+            py::arg("velocities"),
+            py::arg("centers"),
+            py::arg("amplitudes"),
+            R"pbdoc(
+                Simulate and process one run.
+
+                Parameters
+                ----------
+                run_time : pint.Quantity
+                    Acquisition duration.
+                velocities : pint.Quantity
+                    Particle velocity of every event.
+                centers : pint.Quantity
+                    Arrival time of every event, within ``[0, run_time)``.
+                amplitudes : pint.Quantity
+                    Peak optical power of every event on every detector, of shape
+                    ``(n_events, n_detectors)`` in detector order.
+
+                Returns
+                -------
+                dict
+                    ``"number_of_samples"`` and ``"number_of_blocks"`` of the run,
+                    ``"start_index"``, the acquisition index of the first sample of
+                    every window, ``"peaks"``, the peak locator metrics in the
+                    :meth:`BasePeakLocator.run` format or None, ``"segments"``,
+                    the windows in the :meth:`Digitizer.digitize_data_dict` format with
+                    a ``"segment_id"`` entry, or None if ``keep_segments`` is False,
+                    and ``"spill"``, the counters of the acquisition file writer, or
+                    None without ``spill_filename``: ``"number_of_chunks"``,
+                    ``"number_of_events"``, ``"ring_capacity"``, ``"max_queued_slots"``,
+                    ``"number_of_producer_stalls"``, the number of times the analysis
+                    waited for the I/O thread, ``"producer_stall_time"``,
+                    ``"write_time"`` and ``"file_size"`` in byte, and ``"statistics"``,
+                    the :class:`EventStatistics` of the run, or None without
+                    ``event_statistics``.
+
+                Raises
+                ------
+                RuntimeError
+                    If the event arrays are inconsistent, or if a stage fails.
+            )pbdoc"
+        )
+        .def(
+            "__repr__",
+            [](const AcquisitionPipeline& self) {
+                return
+                    "AcquisitionPipeline(detectors=" + std::to_string(self.chain.detectors.size()) +
+                    ", circuits=" + std::to_string(self.circuits.size()) +
+                    ", block_size=" + std::to_string(self.block_size) + ")";
+            }
+        );
+
+    py::class_<AcquisitionSweep, std::shared_ptr<AcquisitionSweep>>(
+        module,
+        "AcquisitionSweep",
+        R"pbdoc(
+            Batch executor running many AcquisitionPipeline runs in parallel.
+
+            Event sets registered with ``add_events`` and pipelines passed to
+            ``add_run`` are shared by reference, so runs that only differ in gain,
+            threshold or bandwidth reuse the same events, and the same pipeline can
+            serve several runs. Pipelines must not be modified until the sweep has run.
+
+            Runs are handed to ``number_of_threads`` threads one at a time, longest
+            first. Each run executes on a single thread, with nested OpenMP regions
+            disabled, so the sweep never oversubscribes the cores. Noise streams are
+            drawn in run order before the runs start: for a given seed, a sweep
+            returns what running its pipelines one after the other returns.
+        )pbdoc"
+    )
+        .def(py::init<>())
+        .def_readwrite(
+            "number_of_threads",
+            &AcquisitionSweep::number_of_threads,
+            R"pbdoc(
+                Number of runs executed concurrently, 0 for the OpenMP default.
+            )pbdoc"
+        )
+        .def_readwrite(
+            "debug_mode",
+            &AcquisitionSweep::debug_mode,
+            R"pbdoc(
+                Whether diagnostic information is printed during processing.
+            )pbdoc"
+        )
+        .def(
+            "add_events",
+            [](AcquisitionSweep& self, const py::object& velocities, const py::object& centers, const py::object& amplitudes) {
+                return self.add_events(quantities_to_events(velocities, centers, amplitudes));
+            },
+            py::arg("velocities"),
+            py::arg("centers"),
+            py::arg("amplitudes"),
+            R"pbdoc(
+                Register a set of transit events shared by one or more runs.
+
+                Parameters
+                ----------
+                velocities, centers, amplitudes : pint.Quantity
+                    Events in the :meth:`AcquisitionPipeline.run` format.
+
+                Returns
+                -------
+                int
+                    Index of the event set, to pass to :meth:`add_run`.
+            )pbdoc"
+        )
+        .def(
+            "add_run",
+            [](AcquisitionSweep& self, const std::shared_ptr<AcquisitionPipeline>& pipeline, const size_t events_index, const py::object& run_time) {
+                return self.add_run(
+                    pipeline,
+                    events_index,
+                    run_time.attr("to")("second").attr("magnitude").cast<double>()
+                );
+            },
+            py::arg("pipeline"),
+            py::arg("events_index"),
+            py::arg("run_time"),
+            R"pbdoc(
+                Append a run to the sweep.
+
+                Parameters
+                ----------
+                pipeline : AcquisitionPipeline
+                    Pipeline processing the run.
+                events_index : int
+                    Index returned by :meth:`add_events`.
+                run_time : pint.Quantity
+                    Acquisition duration.
+
+                Returns
+                -------
+                int
+                    Index of the run in the list returned by :meth:`run`.
+            )pbdoc"
+        )
+        .def(
+            "run",
+            [ureg](const AcquisitionSweep& self) {
+                std::vector<AcquisitionPipelineResult> results;
+                {
+                    py::gil_scoped_release release;
+                    results = self.run();
+                }
+
+                py::list output;
+
+                for (size_t run_index = 0; run_index < results.size(); ++run_index) {
+                    output.append(result_to_dict(ureg, *self.get_pipeline(run_index), std::move(results[run_index])));
+                }
+
+                return output;
+            },
+            R"pbdoc(
+                Execute every run.
+
+                Returns
+                -------
+                list of dict
+                    One :meth:`AcquisitionPipeline.run` dictionary per run, in the
+                    order the runs were added.
+
+                Raises
+                ------
+                ValueError
+                    If two runs spill to the same file, before any run starts.
+                RuntimeError
+                    The error of the first failing run, once every run has ended.
+            )pbdoc"
+        )
+        .def(
+            "clear",
+            &AcquisitionSweep::clear,
+            R"pbdoc(
+                Remove every run and event set.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "number_of_runs",
+            &AcquisitionSweep::get_number_of_runs,
+            R"pbdoc(
+                Number of runs in the sweep.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "number_of_event_sets",
+            &AcquisitionSweep::get_number_of_event_sets,
+            R"pbdoc(
+                Number of registered event sets.
+            )pbdoc"
+        );
+
+    py::class_<AcquisitionFileReader, std::shared_ptr<AcquisitionFileReader>>(
+        module,
+        "AcquisitionFileReader",
+        R"pbdoc(
+            Lazy reader of an acquisition file, as spilled by an AcquisitionPipeline.
+
+            The file holds the ADC codes of every channel in chunks of aligned,
+            optionally zstd compressed, per channel blocks, followed by an index
+            with the digitizer settings, the channels and the triggered windows.
+            It is memory mapped: opening it only parses the index, and samples are
+            decoded from the mapped blocks when they are read, so runs larger than
+            memory can be reprocessed with :func:`replay`.
+
+            Parameters
+            ----------
+            filename : str or os.PathLike
+                Path of the file.
+
+            Raises
+            ------
+            RuntimeError
+                If the file is not a complete acquisition file, or if it is
+                compressed and FlowCyPy is built without zstd.
+        )pbdoc"
+    )
+        .def(
+            py::init(
+                [](const py::object& filename) {
+                    return std::make_shared<AcquisitionFileReader>(
+                        py::module_::import("os").attr("fspath")(filename).cast<std::string>()
+                    );
+                }
+            ),
+            py::arg("filename")
+        )
+        .def_property_readonly(
+            "sampling_rate",
+            [ureg](const AcquisitionFileReader& self) {
+                return py::float_(self.get_header().sampling_rate) * ureg.attr("hertz");
+            },
+            R"pbdoc(
+                Sampling rate of the acquisition.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "bit_depth",
+            [](const AcquisitionFileReader& self) {
+                return self.get_header().bit_depth;
+            },
+            R"pbdoc(
+                Bit depth of the digitizer.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "code_type",
+            [](const AcquisitionFileReader& self) {
+                return code_type_to_string(self.get_header().code_type);
+            },
+            R"pbdoc(
+                Integer type of the stored codes, e.g. ``"uint16"``.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "compression",
+            [](const AcquisitionFileReader& self) {
+                return compression_to_string(self.get_header().compression);
+            },
+            R"pbdoc(
+                Compression of the channel blocks, ``"none"`` or ``"zstd"``.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "channel_names",
+            &AcquisitionFileReader::get_channel_names,
+            R"pbdoc(
+                Names of the channels, in file order.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "number_of_samples",
+            &AcquisitionFileReader::get_number_of_samples,
+            R"pbdoc(
+                Number of samples of every channel.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "number_of_chunks",
+            &AcquisitionFileReader::get_number_of_chunks,
+            R"pbdoc(
+                Number of chunks, one per block of the spilling pipeline.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "events",
+            [](const AcquisitionFileReader& self) {
+                std::vector<size_t> start_indices;
+                std::vector<size_t> lengths;
+
+                for (const AcquisitionFileEvent& event : self.get_events()) {
+                    start_indices.push_back(event.start_index);
+                    lengths.push_back(event.number_of_samples);
+                }
+
+                py::dict output;
+                output["start_index"] = vector_to_numpy_without_copy(std::move(start_indices));
+                output["number_of_samples"] = vector_to_numpy_without_copy(std::move(lengths));
+
+                return output;
+            },
+            R"pbdoc(
+                Triggered windows of the original run.
+
+                Returns
+                -------
+                dict
+                    ``"start_index"``, the acquisition index of the first sample of
+                    every window, and ``"number_of_samples"``, its length.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "event_metrics",
+            [](const AcquisitionFileReader& self) {
+                const py::ssize_t number_of_events = static_cast<py::ssize_t>(self.get_events().size());
+
+                py::dict output;
+
+                for (const auto& [channel_name, channel_metrics] : self.get_event_metrics()) {
+                    py::dict channel_output;
+
+                    for (const auto& [metric_name, values] : channel_metrics) {
+                        py::object array = vector_to_numpy_without_copy(std::vector<double>(values));
+
+                        channel_output[py::str(metric_name)] = number_of_events > 0
+                            ? array.attr("reshape")(number_of_events, -1)
+                            : array;
+                    }
+
+                    output[py::str(channel_name)] = channel_output;
+                }
+
+                return output;
+            },
+            R"pbdoc(
+                Peak metrics of the triggered windows of the original run.
+
+                Returns
+                -------
+                dict
+                    ``{channel: {metric: array}}`` in the :meth:`BasePeakLocator.run`
+                    format, one row per window; empty if the run had no peak locator.
+            )pbdoc"
+        )
+        .def(
+            "get_voltage_range",
+            [ureg](const AcquisitionFileReader& self, const std::string& channel_name) {
+                const AcquisitionChannelInfo& channel = self.get_header().channels.at(self.get_channel_index(channel_name));
+
+                return py::make_tuple(
+                    py::float_(channel.minimum_voltage) * ureg.attr("volt"),
+                    py::float_(channel.maximum_voltage) * ureg.attr("volt")
+                );
+            },
+            py::arg("channel"),
+            R"pbdoc(
+                Voltage range of a channel, mapped to the minimum and maximum codes.
+
+                Parameters
+                ----------
+                channel : str
+                    Channel name.
+
+                Returns
+                -------
+                tuple of pint.Quantity
+                    Minimum and maximum voltage.
+
+                Raises
+                ------
+                IndexError
+                    If the file has no such channel.
+            )pbdoc"
+        )
+        .def(
+            "read_codes",
+            [](const AcquisitionFileReader& self, const std::string& channel_name, const size_t start, const std::optional<size_t> count) {
+                const size_t length = count.value_or(self.get_number_of_samples() - std::min(start, self.get_number_of_samples()));
+
+                return code_buffer_to_numpy(self.read_channel_codes(channel_name, start, length));
+            },
+            py::arg("channel"),
+            py::arg("start") = 0,
+            py::arg("count") = py::none(),
+            R"pbdoc(
+                ADC codes of a channel.
+
+                Parameters
+                ----------
+                channel : str
+                    Channel name.
+                start : int, optional
+                    Acquisition index of the first sample.
+                count : int or None, optional
+                    Number of samples, up to the end of the acquisition by default.
+
+                Returns
+                -------
+                numpy.ndarray
+                    Codes, in the integer type of :attr:`code_type`.
+
+                Raises
+                ------
+                IndexError
+                    If the channel does not exist or the samples exceed the acquisition.
+            )pbdoc"
+        )
+        .def(
+            "read_volts",
+            [ureg](const AcquisitionFileReader& self, const std::string& channel_name, const size_t start, const std::optional<size_t> count) {
+                const size_t length = count.value_or(self.get_number_of_samples() - std::min(start, self.get_number_of_samples()));
+
+                std::vector<double> volts;
+                {
+                    py::gil_scoped_release release;
+                    volts = self.read_channel_volts(channel_name, start, length);
+                }
+
+                return vector_to_numpy_without_copy(std::move(volts)) * ureg.attr("volt");
+            },
+            py::arg("channel"),
+            py::arg("start") = 0,
+            py::arg("count") = py::none(),
+            R"pbdoc(
+                Samples of a channel decoded to volt.
+
+                Parameters
+                ----------
+                channel : str
+                    Channel name.
+                start : int, optional
+                    Acquisition index of the first sample.
+                count : int or None, optional
+                    Number of samples, up to the end of the acquisition by default.
+
+                Returns
+                -------
+                pint.Quantity
+                    Samples in volt.
+
+                Raises
+                ------
+                IndexError
+                    If the channel does not exist or the samples exceed the acquisition.
+            )pbdoc"
+        )
+        .def(
+            "__repr__",
+            [](const AcquisitionFileReader& self) {
+                return
+                    "AcquisitionFileReader('" + self.get_filename() +
+                    "', channels=" + std::to_string(self.get_header().channels.size()) +
+                    ", samples=" + std::to_string(self.get_number_of_samples()) +
+                    ", events=" + std::to_string(self.get_events().size()) + ")";
+            }
+        );
+
+    module.def(
+        "is_offload_device_available",
+        &utils::offload::is_device_available,
+        R"pbdoc(
+            Whether :attr:`AcquisitionPipeline.use_device` can be enabled.
+
+            Returns
+            -------
+            bool
+                True if FlowCyPy was built with ``FLOWCYPY_OPENMP_OFFLOAD`` and an
+                OpenMP target device is present.
+        )pbdoc"
+    );
+
+    module.def(
+        "replay",
+        [ureg](
+            const AcquisitionFileReader& reader,
+            const py::object& discriminator,
+            const std::shared_ptr<BasePeakLocator>& peak_locator,
+            const bool keep_segments,
+            const size_t block_size,
+            const std::optional<EventStatistics>& statistics
+        ) {
+            OnlineDiscriminator online_discriminator = to_online_discriminator(discriminator);
+            AcquisitionPipelineResult result;
+            {
+                py::gil_scoped_release release;
+                result = replay_acquisition_file(
+                    reader,
+                    std::move(online_discriminator),
+                    peak_locator,
+                    keep_segments,
+                    block_size,
+                    statistics
+                );
+            }
+
+            return result_to_dict(ureg, peak_locator.get(), keep_segments, true, std::move(result));
+        },
+        py::arg("reader"),
+        py::arg("discriminator"),
+        py::arg("peak_locator") = nullptr,
+        py::arg("keep_segments") = true,
+        py::arg("block_size") = size_t{1} << 16,
+        py::arg("statistics") = py::none(),
+        R"pbdoc(
+            Reprocess an archived acquisition with a new discriminator and peak locator.
+
+            The file is decoded ``block_size`` samples at a time and streamed
+            through the discriminator, in volt. The windows are then mapped back to
+            their ADC codes, as in :meth:`AcquisitionPipeline.run`, so the metrics of
+            a replay are comparable with the metrics of the original run. The
+            discriminator sees the digitized samples rather than the analog signal:
+            replaying with the original thresholds gives the original windows up to
+            the quantization of the trigger channel.
+
+            Parameters
+            ----------
+            reader : AcquisitionFileReader
+                Archived acquisition.
+            discriminator : FixedWindow or DynamicWindow or DoubleThreshold or OnlineDiscriminator
+                Detector extracting the event windows.
+            peak_locator : BasePeakLocator or None, optional
+                Peak locator applied to the windows.
+            keep_segments : bool, optional
+                Whether the windows are returned along with the metrics.
+            block_size : int, optional
+                Number of samples decoded at a time.
+            statistics : EventStatistics, optional
+                Histograms accumulated over the replay, from no count.
+
+            Returns
+            -------
+            dict
+                The :meth:`AcquisitionPipeline.run` dictionary of the replay.
+
+            Raises
+            ------
+            RuntimeError
+                If the trigger channel is not a channel of the file.
+        )pbdoc"
+    );
+}
@@ -0,0 +1,94 @@
+#include "triggered_windows.h"
+
+#include <optional>
+#include <span>
+#include <utility>
+
+
+TriggeredWindowBatch concatenate_triggered_windows(const std::vector<TriggeredEvent>& events) {
+    TriggeredWindowBatch batch;
+
+    for (const TriggeredEvent& event : events) {
+        batch.offsets.push_back(batch.offsets.back() + event.time.size());
+        batch.start_indices.push_back(event.start_index);
+
+        std::vector<double>& time = batch.signals["Time"];
+        time.insert(time.end(), event.time.begin(), event.time.end());
+
+        for (const auto& [channel_name, samples] : event.signals) {
+            std::vector<double>& channel = batch.signals[channel_name];
+            channel.insert(channel.end(), samples.begin(), samples.end());
+        }
+    }
+
+    return batch;
+}
+
+
+EventMetricDictionary append_triggered_windows(
+    AcquisitionPipelineResult& result,
+    TriggeredWindowBatch&& batch,
+    const std::vector<std::string>& channel_names,
+    const BasePeakLocator* peak_locator,
+    const std::string& trigger_channel,
+    const bool keep_segments
+) {
+    EventMetricDictionary metrics;
+
+    if (batch.get_number_of_windows() == 0) {
+        return metrics;
+    }
+
+    result.start_indices.insert(result.start_indices.end(), batch.start_indices.begin(), batch.start_indices.end());
+
+    if (peak_locator) {
+        SignalViewDictionary views;
+
+        for (const std::string& channel_name : channel_names) {
+            views[channel_name] = batch.signals.at(channel_name);
+        }
+
+        metrics = peak_locator->run_segment_offsets(batch.offsets, views, trigger_channel);
+
+        for (const auto& [channel_name, channel_metrics] : metrics) {
+            for (const auto& [metric_name, values] : channel_metrics) {
+                std::vector<double>& output = result.metrics[channel_name][metric_name];
+                output.insert(output.end(), values.begin(), values.end());
+            }
+        }
+    }
+
+    if (result.statistics) {
+        const size_t number_of_windows = batch.get_number_of_windows();
+
+        result.statistics->update(
+            metrics,
+            peak_locator ? static_cast<size_t>(peak_locator->max_number_of_peaks) : 0,
+            std::span<const size_t>(result.start_indices).last(number_of_windows),
+            std::span<const int>(),
+            peak_locator ? std::optional<double>(peak_locator->padding_value) : std::nullopt
+        );
+    }
+
+    if (!keep_segments) {
+        return metrics;
+    }
+
+    const size_t base_offset = result.segment_offsets.back();
+
+    for (size_t window = 1; window < batch.offsets.size(); ++window) {
+        result.segment_offsets.push_back(base_offset + batch.offsets[window]);
+    }
+
+    for (auto& [channel_name, samples] : batch.signals) {
+        std::vector<double>& output = channel_name == "Time" ? result.segment_time : result.segment_signals[channel_name];
+
+        if (output.empty()) {
+            output = std::move(samples);
+        } else {
+            output.insert(output.end(), samples.begin(), samples.end());
+        }
+    }
+
+    return metrics;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "acquisition_pipeline.h"
+
+
+/**
+ * @brief Triggered windows concatenated back to back, window k spanning [offsets[k], offsets[k + 1]).
+ */
+struct TriggeredWindowBatch {
+    std::vector<size_t> offsets = {0};
+    std::vector<size_t> start_indices;
+
+    /// "Time" and every signal channel.
+    std::map<std::string, std::vector<double>> signals;
+
+    size_t get_number_of_windows() const { return this->start_indices.size(); }
+};
+
+
+/**
+ * @brief Concatenate the windows popped from an OnlineDiscriminator.
+ */
+TriggeredWindowBatch concatenate_triggered_windows(const std::vector<TriggeredEvent>& events);
+
+
+/**
+ * @brief Append a batch of digitized windows to a result: start indices, peak
+ *     metrics, their statistics when the result has some and, when kept, the window samples.
+ *
+ * @param result Result of the run.
+ * @param batch Digitized windows.
+ * @param channel_names Signal channels handed to the peak locator.
+ * @param peak_locator Peak locator, or null.
+ * @param trigger_channel Trigger channel of the discriminator.
+ * @param keep_segments Whether the window samples are kept.
+ * @return Peak metrics of the batch alone, empty without a peak locator.
+ */
+EventMetricDictionary append_triggered_windows(
+    AcquisitionPipelineResult& result,
+    TriggeredWindowBatch&& batch,
+    const std::vector<std::string>& channel_names,
+    const BasePeakLocator* peak_locator,
+    const std::string& trigger_channel,
+    const bool keep_segments
+);
@@ -0,0 +1,120 @@
+#include "acquisition_buffer.h"
+#include "threading.h"
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+
+namespace {
+
+constexpr size_t samples_per_alignment = utils::acquisition_buffer_alignment / sizeof(double);
+
+std::vector<std::string> get_map_keys(const std::map<std::string, std::vector<double>>& data_map) {
+    std::vector<std::string> keys;
+    keys.reserve(data_map.size());
+
+    for (const auto& [key, value] : data_map)
+        keys.push_back(key);
+
+    return keys;
+}
+
+size_t get_common_size(const std::map<std::string, std::vector<double>>& data_map) {
+    if (data_map.empty())
+        return 0;
+
+    const size_t size = data_map.begin()->second.size();
+
+    for (const auto& [key, value] : data_map)
+        if (value.size() != size)
+            throw std::runtime_error("All channels of an acquisition buffer must have the same number of samples.");
+
+    return size;
+}
+
+}  // namespace
+
+
+utils::AcquisitionBuffer::AcquisitionBuffer(const std::vector<std::string>& channel_names, const size_t number_of_samples)
+    : channel_names(channel_names),
+      number_of_samples(number_of_samples),
+      channel_stride((number_of_samples + samples_per_alignment - 1) / samples_per_alignment * samples_per_alignment)
+{
+    for (size_t index = 0; index < this->channel_names.size(); ++index)
+        if (!this->channel_indices.emplace(this->channel_names[index], index).second)
+            throw std::runtime_error("Channel '" + this->channel_names[index] + "' appears twice in the acquisition buffer.");
+
+    const size_t total_size = this->channel_stride * this->channel_names.size();
+
+    if (total_size == 0)
+        return;
+
+    // The byte count is a multiple of the alignment, as std::aligned_alloc requires.
+    double* pointer = static_cast<double*>(std::aligned_alloc(acquisition_buffer_alignment, total_size * sizeof(double)));
+
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+
+    this->storage.reset(pointer);
+
+    // Zeroed channel by channel in parallel, so that pages sit on the socket of the
+    // threads that process that part of every channel.
+    for (size_t index = 0; index < this->channel_names.size(); ++index)
+        utils::first_touch_fill(std::span<double>(pointer + index * this->channel_stride, this->channel_stride), 0.0);
+}
+
+
+utils::AcquisitionBuffer::AcquisitionBuffer(const std::map<std::string, std::vector<double>>& data_map)
+    : AcquisitionBuffer(get_map_keys(data_map), get_common_size(data_map))
+{
+    for (const auto& [channel_name, channel_signal] : data_map)
+        std::copy(channel_signal.begin(), channel_signal.end(), this->channel(channel_name).begin());
+}
+
+
+bool utils::AcquisitionBuffer::contains(const std::string& channel_name) const {
+    return this->channel_indices.contains(channel_name);
+}
+
+
+size_t utils::AcquisitionBuffer::get_channel_index(const std::string& channel_name) const {
+    const auto iterator = this->channel_indices.find(channel_name);
+
+    if (iterator == this->channel_indices.end())
+        throw std::runtime_error("Channel '" + channel_name + "' was not found in the acquisition buffer.");
+
+    return iterator->second;
+}
+
+
+std::span<double> utils::AcquisitionBuffer::channel(const size_t channel_index) {
+    return {this->storage.get() + channel_index * this->channel_stride, this->number_of_samples};
+}
+
+
+std::span<const double> utils::AcquisitionBuffer::channel(const size_t channel_index) const {
+    return {this->storage.get() + channel_index * this->channel_stride, this->number_of_samples};
+}
+
+
+std::span<double> utils::AcquisitionBuffer::channel(const std::string& channel_name) {
+    return this->channel(this->get_channel_index(channel_name));
+}
+
+
+std::span<const double> utils::AcquisitionBuffer::channel(const std::string& channel_name) const {
+    return this->channel(this->get_channel_index(channel_name));
+}
+
+
+std::map<std::string, std::vector<double>> utils::AcquisitionBuffer::to_map() const {
+    std::map<std::string, std::vector<double>> data_map;
+
+    for (size_t index = 0; index < this->channel_names.size(); ++index) {
+        const std::span<const double> samples = this->channel(index);
+        data_map.emplace(this->channel_names[index], std::vector<double>(samples.begin(), samples.end()));
+    }
+
+    return data_map;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+
+namespace utils {
+
+/**
+ * @brief Alignment in bytes of every channel of an AcquisitionBuffer.
+ */
+constexpr size_t acquisition_buffer_alignment = 64;
+
+/**
+ * @brief Contiguous, channel-major store for the traces of one acquisition.
+ *
+ * All channels share one allocation. Channel c starts at c * channel_stride and
+ * holds number_of_samples samples; the stride is rounded up so that every channel
+ * starts on a 64 byte boundary, the padding being zero. Channels are addressed by
+ * name through a name to index table and handed out as std::span views, so every
+ * stage of the acquisition reads and writes the same memory.
+ *
+ * The buffer owns its storage and cannot be copied: stages share it through a
+ * std::shared_ptr and keep views into it.
+ */
+class AcquisitionBuffer {
+public:
+    /**
+     * @brief Allocate a zero filled buffer, first touched by the threads that process it.
+     *
+     * @param channel_names Names of the channels, in storage order.
+     * @param number_of_samples Number of samples of every channel.
+     *
+     * @throws std::runtime_error If a channel name is repeated.
+     */
+    AcquisitionBuffer(const std::vector<std::string>& channel_names, const size_t number_of_samples);
+
+    /**
+     * @brief Copy a channel map into a new buffer, channels in map order.
+     *
+     * @param data_map Channels keyed by name.
+     *
+     * @throws std::runtime_error If the channels differ in length.
+     */
+    explicit AcquisitionBuffer(const std::map<std::string, std::vector<double>>& data_map);
+
+    AcquisitionBuffer(const AcquisitionBuffer&) = delete;
+    AcquisitionBuffer& operator=(const AcquisitionBuffer&) = delete;
+    AcquisitionBuffer(AcquisitionBuffer&&) noexcept = default;
+    AcquisitionBuffer& operator=(AcquisitionBuffer&&) noexcept = default;
+
+    size_t get_number_of_channels() const { return this->channel_names.size(); }
+    size_t get_number_of_samples() const { return this->number_of_samples; }
+
+    /**
+     * @brief Distance in samples between the first samples of two consecutive channels.
+     */
+    size_t get_channel_stride() const { return this->channel_stride; }
+
+    const std::vector<std::string>& get_channel_names() const { return this->channel_names; }
+
+    bool contains(const std::string& channel_name) const;
+
+    /**
+     * @throws std::runtime_error If the channel does not exist.
+     */
+    size_t get_channel_index(const std::string& channel_name) const;
+
+    std::span<double> channel(const size_t channel_index);
+    std::span<const double> channel(const size_t channel_index) const;
+
+    /**
+     * @throws std::runtime_error If the channel does not exist.
+     */
+    std::span<double> channel(const std::string& channel_name);
+    std::span<const double> channel(const std::string& channel_name) const;
+
+    double* data() { return this->storage.get(); }
+    const double* data() const { return this->storage.get(); }
+
+    /**
+     * @brief Copy the channels back into a map, for the stages still working on maps.
+     */
+    std::map<std::string, std::vector<double>> to_map() const;
+
+private:
+    struct AlignedDeleter {
+        void operator()(double* pointer) const { std::free(pointer); }
+    };
+
+    std::vector<std::string> channel_names;
+    std::map<std::string, size_t> channel_indices;
+    size_t number_of_samples = 0;
+    size_t channel_stride = 0;
+    std::unique_ptr<double[], AlignedDeleter> storage;
+};
+
+}
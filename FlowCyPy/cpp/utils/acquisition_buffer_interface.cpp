@@ -0,0 +1,295 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "acquisition_buffer.h"
+#include "time_axis.h"
+#include "module_binding.h"
+
+namespace py = pybind11;
+
+
+namespace {
+
+// Quantities are stored in SI base units, plain arrays as they are.
+py::array_t<double, py::array::c_style | py::array::forcecast> to_si_array(const py::handle& value) {
+    py::object array = py::reinterpret_borrow<py::object>(value);
+
+    if (py::hasattr(array, "to_base_units")) {
+        array = array.attr("to_base_units")().attr("magnitude");
+    }
+
+    return py::array_t<double, py::array::c_style | py::array::forcecast>::ensure(array);
+}
+
+}  // namespace
+
+
+FLOWCYPY_MODULE(acquisition_buffer, module) {
+    module.doc() = R"pbdoc(
+        Shared acquisition buffer and time axis for FlowCyPy.
+
+        An acquisition buffer stores the traces of one acquisition in a single
+        contiguous, channel-major block, each channel starting on a 64 byte
+        boundary. Digitizer and discriminator stages read and write it in place,
+        and NumPy sees the same memory through the buffer protocol.
+
+        A time axis describes a uniformly sampled time axis by its start, time
+        step and number of samples, its values being computed on demand.
+    )pbdoc";
+
+    py::class_<utils::AcquisitionBuffer, std::shared_ptr<utils::AcquisitionBuffer>>(
+        module,
+        "AcquisitionBuffer",
+        py::buffer_protocol(),
+        R"pbdoc(
+            Contiguous channel-major store for the traces of one acquisition.
+
+            Parameters
+            ----------
+            channel_names : list[str]
+                Names of the channels, in storage order.
+            number_of_samples : int
+                Number of samples of every channel. The buffer is zero filled.
+
+            Notes
+            -----
+            ``numpy.asarray(buffer)`` returns a ``(channels, samples)`` view of the
+            storage, without copy. Values are stored in SI units.
+        )pbdoc"
+    )
+        .def(
+            py::init<const std::vector<std::string>&, size_t>(),
+            py::arg("channel_names"),
+            py::arg("number_of_samples")
+        )
+        .def_static(
+            "from_dict",
+            [](const py::dict& data_dict) {
+                std::vector<std::string> channel_names;
+                std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> arrays;
+
+                for (const auto& item : data_dict) {
+                    channel_names.push_back(py::cast<std::string>(item.first));
+                    arrays.push_back(to_si_array(item.second));
+                }
+
+                const size_t number_of_samples = arrays.empty() ? 0 : static_cast<size_t>(arrays.front().size());
+
+                for (size_t index = 0; index < arrays.size(); ++index) {
+                    if (arrays[index].ndim() != 1 || static_cast<size_t>(arrays[index].size()) != number_of_samples) {
+                        throw std::runtime_error(
+                            "Channel '" + channel_names[index] + "' must be one dimensional with the same number of samples as the other channels."
+                        );
+                    }
+                }
+
+                auto buffer = std::make_shared<utils::AcquisitionBuffer>(channel_names, number_of_samples);
+
+                for (size_t index = 0; index < arrays.size(); ++index) {
+                    std::copy_n(arrays[index].data(), number_of_samples, buffer->channel(index).data());
+                }
+
+                return buffer;
+            },
+            py::arg("data_dict"),
+            R"pbdoc(
+                Build a buffer from a dictionary of one dimensional arrays.
+
+                Parameters
+                ----------
+                data_dict : dict
+                    Channels keyed by name. Pint quantities are converted to SI base
+                    units, for instance volt and second.
+
+                Returns
+                -------
+                AcquisitionBuffer
+                    New buffer holding a copy of the channels, in dictionary order.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "channel_names",
+            &utils::AcquisitionBuffer::get_channel_names,
+            R"pbdoc(
+                Names of the channels, in storage order.
+            )pbdoc"
+        )
+        .def_property_readonly(
+            "number_of_samples",
+            &utils::AcquisitionBuffer::get_number_of_samples,
+            R"pbdoc(
+                Number of samples of every channel.
+            )pbdoc"
+        )
+        .def(
+            "__contains__",
+            &utils::AcquisitionBuffer::contains,
+            py::arg("channel_name")
+        )
+        .def(
+            "__len__",
+            &utils::AcquisitionBuffer::get_number_of_channels
+        )
+        .def(
+            "__getitem__",
+            [](py::object self, const std::string& channel_name) {
+                utils::AcquisitionBuffer& buffer = self.cast<utils::AcquisitionBuffer&>();
+                const std::span<double> samples = buffer.channel(channel_name);
+
+                // The returned array keeps the buffer alive and aliases its storage.
+                return py::array_t<double>(static_cast<py::ssize_t>(samples.size()), samples.data(), self);
+            },
+            py::arg("channel_name"),
+            R"pbdoc(
+                Writable view of one channel.
+
+                Parameters
+                ----------
+                channel_name : str
+                    Name of the channel.
+
+                Returns
+                -------
+                numpy.ndarray
+                    One dimensional view of the channel, without copy.
+            )pbdoc"
+        )
+        .def_buffer(
+            [](utils::AcquisitionBuffer& self) {
+                return py::buffer_info(
+                    self.data(),
+                    sizeof(double),
+                    py::format_descriptor<double>::format(),
+                    2,
+                    {
+                        static_cast<py::ssize_t>(self.get_number_of_channels()),
+                        static_cast<py::ssize_t>(self.get_number_of_samples())
+                    },
+                    {
+                        static_cast<py::ssize_t>(self.get_channel_stride() * sizeof(double)),
+                        static_cast<py::ssize_t>(sizeof(double))
+                    }
+                );
+            }
+        )
+        .def(
+            "__repr__",
+            [](const utils::AcquisitionBuffer& self) {
+                return
+                    "AcquisitionBuffer(channels=" + std::to_string(self.get_number_of_channels()) +
+                    ", samples=" + std::to_string(self.get_number_of_samples()) + ")";
+            }
+        );
+
+    py::class_<utils::TimeAxis>(
+        module,
+        "TimeAxis",
+        R"pbdoc(
+            Uniformly sampled time axis ``t[i] = start + i * time_step``.
+
+            Parameters
+            ----------
+            start : float
+                Time of the first sample, in second.
+            time_step : float
+                Sampling interval in second, strictly positive.
+            number_of_samples : int
+                Number of samples.
+
+            Notes
+            -----
+            The time values are computed on demand. Stages accepting a time axis
+            therefore neither store one value per sample nor check the spacing of
+            the samples again.
+        )pbdoc"
+    )
+        .def(
+            py::init<double, double, size_t>(),
+            py::arg("start"),
+            py::arg("time_step"),
+            py::arg("number_of_samples")
+        )
+        .def_static(
+            "from_samples",
+            [](const py::object& samples) {
+                const auto array = to_si_array(samples);
+
+                return utils::TimeAxis::from_samples(
+                    std::span<const double>(array.data(), static_cast<size_t>(array.size()))
+                );
+            },
+            py::arg("samples"),
+            R"pbdoc(
+                Recover the time axis of a uniformly sampled time array.
+
+                Parameters
+                ----------
+                samples : numpy.ndarray or pint.Quantity
+                    Strictly increasing, uniformly spaced time values. Quantities
+                    are converted to second.
+
+                Returns
+                -------
+                TimeAxis
+                    Time axis with the first value and spacing of ``samples``.
+            )pbdoc"
+        )
+        .def_readonly(
+            "start",
+            &utils::TimeAxis::start,
+            R"pbdoc(
+                Time of the first sample, in second.
+            )pbdoc"
+        )
+        .def_readonly(
+            "time_step",
+            &utils::TimeAxis::time_step,
+            R"pbdoc(
+                Sampling interval, in second.
+            )pbdoc"
+        )
+        .def_readonly(
+            "number_of_samples",
+            &utils::TimeAxis::number_of_samples,
+            R"pbdoc(
+                Number of samples.
+            )pbdoc"
+        )
+        .def(
+            "__len__",
+            &utils::TimeAxis::size
+        )
+        .def(
+            "to_array",
+            [](const utils::TimeAxis& self) {
+                py::array_t<double> samples(static_cast<py::ssize_t>(self.size()));
+                self.fill(std::span<double>(samples.mutable_data(), self.size()));
+                return samples;
+            },
+            R"pbdoc(
+                Materialize the time values.
+
+                Returns
+                -------
+                numpy.ndarray
+                    Time of every sample, in second.
+            )pbdoc"
+        )
+        .def(
+            "__repr__",
+            [](const utils::TimeAxis& self) {
+                return
+                    "TimeAxis(start=" + std::to_string(self.start) +
+                    ", time_step=" + std::to_string(self.time_step) +
+                    ", samples=" + std::to_string(self.number_of_samples) + ")";
+            }
+        );
+}
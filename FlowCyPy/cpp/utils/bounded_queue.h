@@ -0,0 +1,114 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+
+namespace utils {
+
+/**
+ * @brief Blocking first in, first out queue holding at most a fixed number of items.
+ *
+ * push blocks while the queue is full and pop blocks while it is empty, so a fast
+ * producer thread can never run more than `capacity` items ahead of its consumer.
+ * Closing the queue wakes both sides: push then fails, and pop drains the
+ * remaining items before reporting the end of the stream.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    /**
+     * @param capacity Maximum number of queued items, at least one.
+     *
+     * @throws std::invalid_argument If capacity is zero.
+     */
+    explicit BoundedQueue(const size_t capacity)
+        : capacity(capacity)
+    {
+        if (capacity == 0) {
+            throw std::invalid_argument("BoundedQueue capacity must be at least one.");
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * @brief Append an item, waiting for room if the queue is full.
+     *
+     * @return False if the queue was closed, in which case the item is dropped.
+     */
+    bool push(T item) {
+        std::unique_lock lock(this->mutex);
+
+        this->not_full.wait(lock, [this] { return this->closed || this->items.size() < this->capacity; });
+
+        if (this->closed) {
+            return false;
+        }
+
+        this->items.push_back(std::move(item));
+        lock.unlock();
+        this->not_empty.notify_one();
+
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest item, waiting for one if the queue is empty.
+     *
+     * @return The item, or nothing once the queue is closed and drained.
+     */
+    std::optional<T> pop() {
+        std::unique_lock lock(this->mutex);
+
+        this->not_empty.wait(lock, [this] { return this->closed || !this->items.empty(); });
+
+        if (this->items.empty()) {
+            return std::nullopt;
+        }
+
+        T item = std::move(this->items.front());
+        this->items.pop_front();
+        lock.unlock();
+        this->not_full.notify_one();
+
+        return item;
+    }
+
+    /**
+     * @brief End the stream and wake every waiting thread.
+     */
+    void close() {
+        {
+            std::lock_guard lock(this->mutex);
+            this->closed = true;
+        }
+
+        this->not_full.notify_all();
+        this->not_empty.notify_all();
+    }
+
+    /**
+     * @brief Number of items currently queued.
+     */
+    size_t size() const {
+        std::lock_guard lock(this->mutex);
+        return this->items.size();
+    }
+
+private:
+    const size_t capacity;
+    mutable std::mutex mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+    std::deque<T> items;
+    bool closed = false;
+};
+
+}
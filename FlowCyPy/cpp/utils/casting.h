@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <string>
+#include <cstring>
 #include <sstream>
 #include <complex>
 #include <memory>
@@ -14,6 +15,8 @@
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 
+#include <pint/pint.h>
+
 namespace py = pybind11;
 using complex128 = std::complex<double>;
 
@@ -61,9 +64,20 @@ namespace Casting {
             }
 
             try {
-                value_object = py::reinterpret_borrow<py::object>(
-                    object.attr("to")(units).attr("magnitude")
-                );
+                // Floating point quantities are scaled by a cached factor rather than through Pint.
+                if constexpr (std::is_floating_point_v<dtype>) {
+                    if (py::hasattr(object, "magnitude") && py::hasattr(object, "units")) {
+                        value_object = quantity_to_array_in_units(object, units);
+                    }
+                    else {
+                        value_object = object.attr("to")(units).attr("magnitude");
+                    }
+                }
+                else {
+                    value_object = py::reinterpret_borrow<py::object>(
+                        object.attr("to")(units).attr("magnitude")
+                    );
+                }
             }
             catch (const py::error_already_set&) {
                 raise_value_error(
@@ -89,6 +103,25 @@ namespace Casting {
             }
 
             if (array.ndim() == 1) {
+                // Floating point arrays are copied with one memcpy rather than element by element.
+                if constexpr (std::is_floating_point_v<dtype>) {
+                    using contiguous_array = py::array_t<dtype, py::array::c_style | py::array::forcecast>;
+
+                    const contiguous_array contiguous_values = contiguous_array::ensure(array);
+
+                    if (contiguous_values) {
+                        std::vector<dtype> values(static_cast<size_t>(contiguous_values.size()));
+
+                        if (!values.empty()) {
+                            std::memcpy(values.data(), contiguous_values.data(), values.size() * sizeof(dtype));
+                        }
+
+                        return values;
+                    }
+
+                    PyErr_Clear();
+                }
+
                 try {
                     return value_object.cast<std::vector<dtype>>();
                 }
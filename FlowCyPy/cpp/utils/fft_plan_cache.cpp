@@ -0,0 +1,159 @@
+#include "fft_plan_cache.h"
+
+#include <cstdlib>
+#include <stdexcept>
+
+
+namespace {
+
+unsigned parse_planner_flags(const char* value) {
+    if (value == nullptr)
+        return FFTW_ESTIMATE;
+
+    const std::string planner(value);
+
+    if (planner == "measure")
+        return FFTW_MEASURE;
+
+    if (planner == "patient")
+        return FFTW_PATIENT;
+
+    return FFTW_ESTIMATE;
+}
+
+// The planner is global to the FFTW library, which every module of the process shares, while
+// the mutex of FFTPlanCache only covers the plans of its own module. FFTW serializes plan creation
+// and destruction itself once asked to, which is done when the module loads, before any plan.
+[[maybe_unused]] const bool planner_is_thread_safe = []() {
+    fftw_make_planner_thread_safe();
+    return true;
+}();
+
+}  // namespace
+
+
+utils::FFTPlanCache& utils::FFTPlanCache::instance() {
+    static FFTPlanCache cache;
+    return cache;
+}
+
+
+utils::FFTPlanCache::FFTPlanCache()
+    : planner_flags(parse_planner_flags(std::getenv("FLOWCYPY_FFTW_PLANNER")))
+{
+    const char* wisdom = std::getenv("FLOWCYPY_FFTW_WISDOM");
+
+    if (wisdom != nullptr) {
+        this->wisdom_filename = wisdom;
+        fftw_import_wisdom_from_filename(this->wisdom_filename.c_str());
+    }
+}
+
+
+utils::FFTPlanCache::~FFTPlanCache() {
+    if (!this->wisdom_filename.empty())
+        fftw_export_wisdom_to_filename(this->wisdom_filename.c_str());
+
+    this->clear();
+}
+
+
+utils::FFTPlan utils::FFTPlanCache::get_plan(const size_t size, const FFTDirection direction) {
+    if (size == 0)
+        throw std::runtime_error("FFT size must be strictly positive.");
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    const auto key = std::make_pair(size, direction);
+    const auto found = this->plans.find(key);
+
+    if (found != this->plans.end())
+        return found->second;
+
+    // Plan on scratch buffers: FFTW_MEASURE overwrites the arrays while planning.
+    double* real = (double*) fftw_malloc(sizeof(double) * size);
+    fftw_complex* spectrum = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (size / 2 + 1));
+
+    fftw_plan plan = (direction == FFTDirection::forward)
+        ? fftw_plan_dft_r2c_1d(static_cast<int>(size), real, spectrum, this->planner_flags)
+        : fftw_plan_dft_c2r_1d(static_cast<int>(size), spectrum, real, this->planner_flags);
+
+    fftw_free(real);
+    fftw_free(spectrum);
+
+    if (plan == nullptr)
+        throw std::runtime_error("FFTW failed to create a plan of size " + std::to_string(size) + ".");
+
+    FFTPlan handle(plan, fftw_destroy_plan);
+    this->plans.emplace(key, handle);
+
+    return handle;
+}
+
+
+void utils::FFTPlanCache::set_planner_flags(const unsigned flags) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->planner_flags = flags;
+}
+
+
+unsigned utils::FFTPlanCache::get_planner_flags() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->planner_flags;
+}
+
+
+void utils::FFTPlanCache::warm_up(const size_t size) {
+    this->get_plan(size, FFTDirection::forward);
+    this->get_plan(size, FFTDirection::backward);
+}
+
+
+bool utils::FFTPlanCache::import_wisdom(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return fftw_import_wisdom_from_filename(filename.c_str()) != 0;
+}
+
+
+bool utils::FFTPlanCache::export_wisdom(const std::string& filename) const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return fftw_export_wisdom_to_filename(filename.c_str()) != 0;
+}
+
+
+void utils::FFTPlanCache::clear() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->plans.clear();
+}
+
+
+size_t utils::FFTPlanCache::get_number_of_plans() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->plans.size();
+}
+
+
+utils::FFTWorkspace::~FFTWorkspace() {
+    fftw_free(this->real);
+    fftw_free(this->spectrum);
+}
+
+
+void utils::FFTWorkspace::reserve(const size_t size) {
+    if (size <= this->capacity)
+        return;
+
+    fftw_free(this->real);
+    fftw_free(this->spectrum);
+
+    this->real = (double*) fftw_malloc(sizeof(double) * size);
+    this->spectrum = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (size / 2 + 1));
+    this->capacity = size;
+}
+
+
+utils::FFTWorkspace& utils::get_thread_fft_workspace(const size_t size) {
+    static thread_local FFTWorkspace workspace;
+    workspace.reserve(size);
+    return workspace;
+}
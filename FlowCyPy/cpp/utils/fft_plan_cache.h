@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <fftw3.h>
+
+
+namespace utils {
+
+/**
+ * @brief Direction of a real to complex FFT plan.
+ */
+enum class FFTDirection {
+    forward,    // real to complex
+    backward    // complex to real
+};
+
+/**
+ * @brief Shared handle of an FFTW plan, destroyed with fftw_destroy_plan when its last holder lets go.
+ */
+using FFTPlan = std::shared_ptr<std::remove_pointer_t<fftw_plan>>;
+
+/**
+ * @brief Process wide cache of real one-dimensional FFTW plans keyed by (N, direction).
+ *
+ * Creating an FFTW plan is expensive and not thread safe, while executing an existing
+ * plan through the new-array interface (fftw_execute_dft_r2c / fftw_execute_dft_c2r) is
+ * thread safe. The cache therefore serializes plan creation behind a mutex and hands out
+ * plans that any thread can execute on its own buffers, provided those buffers come from
+ * fftw_malloc (see FFTWorkspace).
+ *
+ * That mutex only covers the cache of one module, while the FFTW planner is shared by
+ * every module of the process. Loading this file therefore calls
+ * fftw_make_planner_thread_safe, from libfftw3_threads, so FFTW itself serializes plan
+ * creation and destruction across modules, e.g. circuits and amplifiers filtering from
+ * several Python threads with the GIL released.
+ *
+ * Plans are created out of place on scratch buffers owned by the cache, so the planner
+ * flags may include FFTW_MEASURE without touching user data. They are handed out as
+ * shared handles: clear() only drops the references of the cache, and a plan another
+ * thread is executing is destroyed once that thread releases its handle.
+ *
+ * Two environment variables configure the cache when it is first used:
+ * - FLOWCYPY_FFTW_PLANNER: "estimate" (default), "measure" or "patient".
+ * - FLOWCYPY_FFTW_WISDOM: path of a wisdom file imported on first use and exported
+ *   when the process exits, so that measured plans are reused across runs.
+ *
+ * Each extension module links its own copy of utils_lib; the environment variables are
+ * what keeps the configuration consistent between modules. FFTW wisdom itself is global
+ * to the FFTW library and shared by all of them.
+ */
+class FFTPlanCache {
+public:
+    /**
+     * @brief Return the cache instance of this module.
+     */
+    static FFTPlanCache& instance();
+
+    FFTPlanCache(const FFTPlanCache&) = delete;
+    FFTPlanCache& operator=(const FFTPlanCache&) = delete;
+
+    /**
+     * @brief Return the plan of the given size and direction, creating it if needed.
+     *
+     * @param size Number of real samples of the transform.
+     * @param direction Transform direction.
+     * @return Shared handle of the FFTW plan, valid for as long as it is held.
+     *
+     * @throws std::runtime_error If size is zero or if FFTW fails to create the plan.
+     */
+    FFTPlan get_plan(const size_t size, const FFTDirection direction);
+
+    /**
+     * @brief Set the planner flags used for plans created from now on.
+     *
+     * @param flags FFTW planner flags, typically FFTW_ESTIMATE or FFTW_MEASURE.
+     */
+    void set_planner_flags(const unsigned flags);
+
+    /**
+     * @brief Return the planner flags currently in use.
+     */
+    unsigned get_planner_flags() const;
+
+    /**
+     * @brief Create the forward and backward plans of a size ahead of time.
+     *
+     * Useful with FFTW_MEASURE to pay the planning cost once before a batch run.
+     *
+     * @param size Number of real samples of the transform.
+     */
+    void warm_up(const size_t size);
+
+    /**
+     * @brief Import FFTW wisdom from a file.
+     *
+     * @param filename Path of the wisdom file.
+     * @return True if the wisdom was imported.
+     */
+    bool import_wisdom(const std::string& filename);
+
+    /**
+     * @brief Export the accumulated FFTW wisdom to a file.
+     *
+     * @param filename Path of the wisdom file.
+     * @return True if the wisdom was written.
+     */
+    bool export_wisdom(const std::string& filename) const;
+
+    /**
+     * @brief Drop every cached plan.
+     *
+     * Handles previously returned by get_plan stay valid; each plan is destroyed
+     * when its last handle is released.
+     */
+    void clear();
+
+    /**
+     * @brief Return the number of cached plans, forward and backward counted apart.
+     */
+    size_t get_number_of_plans() const;
+
+private:
+    FFTPlanCache();
+    ~FFTPlanCache();
+
+    mutable std::mutex mutex;
+    std::map<std::pair<size_t, FFTDirection>, FFTPlan> plans;
+    unsigned planner_flags;
+    std::string wisdom_filename;
+};
+
+
+/**
+ * @brief Per thread FFTW aligned work buffers, grown on demand and reused across calls.
+ *
+ * The buffers are allocated with fftw_malloc and therefore satisfy the alignment
+ * requirement of plans returned by FFTPlanCache.
+ */
+struct FFTWorkspace {
+    double* real = nullptr;
+    fftw_complex* spectrum = nullptr;
+    size_t capacity = 0;
+
+    FFTWorkspace() = default;
+    FFTWorkspace(const FFTWorkspace&) = delete;
+    FFTWorkspace& operator=(const FFTWorkspace&) = delete;
+    ~FFTWorkspace();
+
+    /**
+     * @brief Make sure the buffers hold at least size real samples and size / 2 + 1 bins.
+     *
+     * @param size Number of real samples of the transform.
+     */
+    void reserve(const size_t size);
+};
+
+/**
+ * @brief Return the work buffers of the calling thread, sized for a transform of size samples.
+ *
+ * @param size Number of real samples of the transform.
+ * @return Thread local workspace.
+ */
+FFTWorkspace& get_thread_fft_workspace(const size_t size);
+
+}
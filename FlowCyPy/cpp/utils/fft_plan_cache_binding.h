@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <pybind11/pybind11.h>
+
+#include <utils/fft_plan_cache.h>
+
+inline unsigned parse_fftw_planner(const std::string& name) {
+    if (name == "estimate") return FFTW_ESTIMATE;
+    if (name == "measure") return FFTW_MEASURE;
+    if (name == "patient") return FFTW_PATIENT;
+
+    throw std::invalid_argument("planner must be 'estimate', 'measure' or 'patient', got '" + name + "'.");
+}
+
+inline std::string fftw_planner_to_string(const unsigned flags) {
+    if (flags & FFTW_PATIENT) return "patient";
+    if (flags & FFTW_ESTIMATE) return "estimate";
+
+    return "measure";
+}
+
+/*
+    @brief Adds the FFT plan cache functions to an extension module.
+    @param module The pybind11 module whose kernels draw plans from its FFTPlanCache.
+    @note Each extension module owns its FFTPlanCache, so planner, warm up and clear act on the
+          plans of this module. FFTW wisdom is global to the FFTW library, so importing it through
+          one module serves the plans of every module created afterwards.
+*/
+inline void register_fft_plan_cache_functions(pybind11::module_& module) {
+    module.def(
+        "set_fftw_planner",
+        [](const std::string& planner) {
+            utils::FFTPlanCache::instance().set_planner_flags(parse_fftw_planner(planner));
+        },
+        pybind11::arg("planner"),
+        R"pbdoc(
+            Set how thoroughly the plans of this module created from now on are planned.
+
+            Parameters
+            ----------
+            planner : {'estimate', 'measure', 'patient'}
+                'estimate' plans at once from heuristics, 'measure' and 'patient'
+                time candidate plans, which pays off for sizes used many times.
+        )pbdoc"
+    );
+
+    module.def(
+        "get_fftw_planner",
+        []() {
+            return fftw_planner_to_string(utils::FFTPlanCache::instance().get_planner_flags());
+        },
+        R"pbdoc(
+            Return the planner of this module, 'estimate', 'measure' or 'patient'.
+        )pbdoc"
+    );
+
+    module.def(
+        "warm_up_fft_plans",
+        [](const size_t size) {
+            pybind11::gil_scoped_release release;
+            utils::FFTPlanCache::instance().warm_up(size);
+        },
+        pybind11::arg("size"),
+        R"pbdoc(
+            Create the forward and backward plans of a transform size ahead of a run.
+
+            Parameters
+            ----------
+            size : int
+                Number of real samples of the transform.
+        )pbdoc"
+    );
+
+    module.def(
+        "clear_fft_plans",
+        []() {
+            utils::FFTPlanCache::instance().clear();
+        },
+        R"pbdoc(
+            Drop the cached plans of this module; later transforms plan again.
+
+            Safe while other threads filter: a plan they are executing is
+            destroyed once they are done with it.
+        )pbdoc"
+    );
+
+    module.def(
+        "get_number_of_fft_plans",
+        []() {
+            return utils::FFTPlanCache::instance().get_number_of_plans();
+        },
+        R"pbdoc(
+            Return the number of plans cached by this module, forward and backward counted apart.
+        )pbdoc"
+    );
+
+    module.def(
+        "import_fftw_wisdom",
+        [](const std::string& filename) {
+            return utils::FFTPlanCache::instance().import_wisdom(filename);
+        },
+        pybind11::arg("filename"),
+        R"pbdoc(
+            Import FFTW wisdom from a file, for the plans created from now on.
+
+            Parameters
+            ----------
+            filename : str
+                Path of the wisdom file.
+
+            Returns
+            -------
+            bool
+                Whether the wisdom was imported.
+        )pbdoc"
+    );
+
+    module.def(
+        "export_fftw_wisdom",
+        [](const std::string& filename) {
+            return utils::FFTPlanCache::instance().export_wisdom(filename);
+        },
+        pybind11::arg("filename"),
+        R"pbdoc(
+            Export the FFTW wisdom accumulated by the process to a file.
+
+            Parameters
+            ----------
+            filename : str
+                Path of the wisdom file.
+
+            Returns
+            -------
+            bool
+                Whether the wisdom was written.
+        )pbdoc"
+    );
+}
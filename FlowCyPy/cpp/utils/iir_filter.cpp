@@ -0,0 +1,247 @@
+#include "iir_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+namespace {
+
+void validate_lowpass_design(const double sampling_rate, const double cutoff_frequency, const int order) {
+    if (!(sampling_rate > 0.0) || !std::isfinite(sampling_rate))
+        throw std::runtime_error("sampling_rate must be strictly positive.");
+
+    if (!(cutoff_frequency > 0.0))
+        throw std::runtime_error("cutoff_frequency must be strictly positive.");
+
+    if (cutoff_frequency >= 0.5 * sampling_rate)
+        throw std::runtime_error("cutoff_frequency must be strictly smaller than the Nyquist frequency.");
+
+    if (order <= 0)
+        throw std::runtime_error("order must be strictly positive.");
+}
+
+// Roots of the reverse Bessel polynomial theta_n(s) = sum_k a_k s^k with
+// a_k = (2n - k)! / (2^(n - k) k! (n - k)!), found with the Durand-Kerner iteration.
+std::vector<std::complex<double>> compute_bessel_poles(const int order) {
+    std::vector<double> coefficients(order + 1);
+
+    for (int k = 0; k <= order; ++k) {
+        // a_k computed in log space to stay finite for large orders.
+        const double log_a = std::lgamma(2.0 * order - k + 1.0)
+            - (order - k) * std::log(2.0)
+            - std::lgamma(k + 1.0)
+            - std::lgamma(order - k + 1.0);
+        coefficients[k] = std::exp(log_a);
+    }
+
+    // Monic polynomial: divide by the leading coefficient a_n = 1.
+    const double leading = coefficients[order];
+    for (double& c : coefficients)
+        c /= leading;
+
+    auto evaluate = [&](const std::complex<double>& s) {
+        std::complex<double> value = 1.0;
+        for (int k = order - 1; k >= 0; --k)
+            value = value * s + coefficients[k];
+        return value;
+    };
+
+    // The roots lie on a circle of radius close to (a_0)^(1/n).
+    const double radius = std::pow(coefficients[0], 1.0 / order);
+    std::vector<std::complex<double>> roots(order);
+    for (int k = 0; k < order; ++k)
+        roots[k] = std::polar(radius, M_PI * (2.0 * k + 1.0) / (2.0 * order) + 0.4);
+
+    for (int iteration = 0; iteration < 500; ++iteration) {
+        double largest_step = 0.0;
+
+        for (int i = 0; i < order; ++i) {
+            std::complex<double> denominator = 1.0;
+            for (int j = 0; j < order; ++j)
+                if (j != i)
+                    denominator *= roots[i] - roots[j];
+
+            const std::complex<double> step = evaluate(roots[i]) / denominator;
+            roots[i] -= step;
+            largest_step = std::max(largest_step, std::abs(step) / std::max(1.0, std::abs(roots[i])));
+        }
+
+        if (largest_step < 1e-15)
+            break;
+    }
+
+    return roots;
+}
+
+
+template <typename Real>
+void process_cascade_in_place(utils::BiquadCascade& cascade, Real* data, const size_t size) {
+    // Section by section over the block: the inner loop keeps only two states live,
+    // and each pass streams through memory once.
+    for (utils::SecondOrderSection& section : cascade.sections) {
+        utils::SecondOrderSection local = section;
+
+        for (size_t i = 0; i < size; ++i)
+            data[i] = static_cast<Real>(local.step(data[i]));
+
+        section.z1 = local.z1;
+        section.z2 = local.z2;
+    }
+
+    if (cascade.gain != 1.0)
+        for (size_t i = 0; i < size; ++i)
+            data[i] = static_cast<Real>(data[i] * cascade.gain);
+}
+
+}  // namespace
+
+
+void utils::SecondOrderSection::settle(const double x) {
+    // Steady state of the transposed direct form II for a constant input x.
+    const double y = x * (this->b0 + this->b1 + this->b2) / (1.0 + this->a1 + this->a2);
+    this->z2 = this->b2 * x - this->a2 * y;
+    this->z1 = this->b1 * x - this->a1 * y + this->z2;
+}
+
+
+utils::BiquadCascade::BiquadCascade(std::vector<SecondOrderSection> sections, const double gain)
+    : sections(std::move(sections)), gain(gain)
+{}
+
+
+void utils::BiquadCascade::process_in_place(double* data, const size_t size) {
+    process_cascade_in_place(*this, data, size);
+}
+
+
+void utils::BiquadCascade::process_in_place(float* data, const size_t size) {
+    process_cascade_in_place(*this, data, size);
+}
+
+
+void utils::BiquadCascade::process_in_place(std::vector<double>& signal) {
+    this->process_in_place(signal.data(), signal.size());
+}
+
+
+void utils::BiquadCascade::reset() {
+    for (SecondOrderSection& section : this->sections) {
+        section.z1 = 0.0;
+        section.z2 = 0.0;
+    }
+}
+
+
+void utils::BiquadCascade::settle(const double x) {
+    double level = x;
+
+    for (SecondOrderSection& section : this->sections) {
+        section.settle(level);
+        level *= (section.b0 + section.b1 + section.b2) / (1.0 + section.a1 + section.a2);
+    }
+}
+
+
+utils::BiquadCascade utils::discretize_all_pole_prototype(
+    const std::vector<std::complex<double>>& normalized_poles,
+    const double sampling_rate,
+    const double cutoff_frequency,
+    const double gain)
+{
+    // Bilinear transform s = K (1 - z^-1) / (1 + z^-1), with the analog cutoff prewarped
+    // so that the digital response at cutoff_frequency matches the analog one.
+    const double K = 2.0 * sampling_rate;
+    const double angular_cutoff = K * std::tan(M_PI * cutoff_frequency / sampling_rate);
+
+    std::vector<SecondOrderSection> sections;
+    std::vector<double> real_poles;
+
+    for (const std::complex<double>& pole : normalized_poles) {
+        if (std::abs(pole.imag()) < 1e-12 * std::max(1.0, std::abs(pole))) {
+            real_poles.push_back(pole.real() * angular_cutoff);
+            continue;
+        }
+
+        if (pole.imag() < 0.0)
+            continue;
+
+        // Conjugate pair: H(s) = B / (s^2 + A s + B)
+        const std::complex<double> q = pole * angular_cutoff;
+        const double A = -2.0 * q.real();
+        const double B = std::norm(q);
+        const double a0 = K * K + A * K + B;
+
+        SecondOrderSection section;
+        section.b0 = B / a0;
+        section.b1 = 2.0 * B / a0;
+        section.b2 = B / a0;
+        section.a1 = 2.0 * (B - K * K) / a0;
+        section.a2 = (K * K - A * K + B) / a0;
+        sections.push_back(section);
+    }
+
+    // Real poles are paired into second order sections, the odd one left first order.
+    size_t index = 0;
+    for (; index + 1 < real_poles.size(); index += 2) {
+        const double w1 = -real_poles[index];
+        const double w2 = -real_poles[index + 1];
+        const double A = w1 + w2;
+        const double B = w1 * w2;
+        const double a0 = K * K + A * K + B;
+
+        SecondOrderSection section;
+        section.b0 = B / a0;
+        section.b1 = 2.0 * B / a0;
+        section.b2 = B / a0;
+        section.a1 = 2.0 * (B - K * K) / a0;
+        section.a2 = (K * K - A * K + B) / a0;
+        sections.push_back(section);
+    }
+
+    if (index < real_poles.size()) {
+        // H(s) = w / (s + w)
+        const double w = -real_poles[index];
+
+        SecondOrderSection section;
+        section.b0 = w / (K + w);
+        section.b1 = w / (K + w);
+        section.a1 = (w - K) / (K + w);
+        sections.push_back(section);
+    }
+
+    return BiquadCascade(std::move(sections), gain);
+}
+
+
+utils::BiquadCascade utils::design_butterworth_lowpass_sos(
+    const double sampling_rate,
+    const double cutoff_frequency,
+    const int order,
+    const double gain)
+{
+    validate_lowpass_design(sampling_rate, cutoff_frequency, order);
+
+    const std::vector<std::complex<double>> poles(order, std::complex<double>(-1.0, 0.0));
+
+    return discretize_all_pole_prototype(poles, sampling_rate, cutoff_frequency, gain);
+}
+
+
+utils::BiquadCascade utils::design_bessel_lowpass_sos(
+    const double sampling_rate,
+    const double cutoff_frequency,
+    const int order,
+    const double gain)
+{
+    validate_lowpass_design(sampling_rate, cutoff_frequency, order);
+
+    std::vector<std::complex<double>> poles = compute_bessel_poles(order);
+
+    // Snap the iteration residue: real roots exactly real, complex roots in exact pairs.
+    for (std::complex<double>& pole : poles)
+        if (std::abs(pole.imag()) < 1e-9 * std::abs(pole))
+            pole = std::complex<double>(pole.real(), 0.0);
+
+    return discretize_all_pole_prototype(poles, sampling_rate, cutoff_frequency, gain);
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+
+namespace utils {
+
+/**
+ * @brief One second order IIR section in transposed direct form II.
+ *
+ * The section implements
+ *
+ *     H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+ *
+ * and keeps its two delay states between calls, so a long signal can be filtered
+ * chunk by chunk with the same result as in a single pass. First order sections are
+ * represented with b2 = a2 = 0.
+ */
+struct SecondOrderSection {
+    double b0 = 1.0;
+    double b1 = 0.0;
+    double b2 = 0.0;
+    double a1 = 0.0;
+    double a2 = 0.0;
+
+    double z1 = 0.0;
+    double z2 = 0.0;
+
+    /**
+     * @brief Filter one sample and update the delay states.
+     */
+    inline double step(const double x) {
+        const double y = this->b0 * x + this->z1;
+        this->z1 = this->b1 * x - this->a1 * y + this->z2;
+        this->z2 = this->b2 * x - this->a2 * y;
+        return y;
+    }
+
+    /**
+     * @brief Set the delay states to the steady state reached for a constant input.
+     *
+     * @param x Constant input level.
+     */
+    void settle(const double x);
+};
+
+
+/**
+ * @brief Cascade of second order sections followed by a scalar gain.
+ *
+ * The cascade is causal, runs in O(N) time and O(order) memory, and keeps its state
+ * between calls to process_in_place. Calling reset clears the state.
+ */
+class BiquadCascade {
+public:
+    std::vector<SecondOrderSection> sections;
+    double gain = 1.0;
+
+    BiquadCascade() = default;
+
+    /**
+     * @brief Build a cascade from its sections and output gain.
+     */
+    BiquadCascade(std::vector<SecondOrderSection> sections, const double gain = 1.0);
+
+    /**
+     * @brief Filter a block of samples in place, continuing from the current state.
+     *
+     * @param data Pointer to the samples.
+     * @param size Number of samples.
+     */
+    void process_in_place(double* data, const size_t size);
+
+    /**
+     * @brief Filter single precision samples in place, continuing from the current state.
+     *
+     * The sections and their delay states stay in double precision; only the
+     * samples passed between sections are rounded to float.
+     */
+    void process_in_place(float* data, const size_t size);
+
+    /**
+     * @brief Filter a vector in place, continuing from the current state.
+     */
+    void process_in_place(std::vector<double>& signal);
+
+    /**
+     * @brief Clear the delay states of every section.
+     */
+    void reset();
+
+    /**
+     * @brief Initialize the delay states as if the input had always been equal to x.
+     *
+     * This avoids the start up transient when the first sample is far from zero.
+     *
+     * @param x Constant input level.
+     */
+    void settle(const double x);
+
+    /**
+     * @brief Number of sections in the cascade.
+     */
+    size_t number_of_sections() const { return this->sections.size(); }
+};
+
+
+/**
+ * @brief Design a causal low pass whose magnitude matches the FFT Butterworth filter.
+ *
+ * apply_butterworth_lowpass_filter_to_signal uses the magnitude response
+ * (1 / sqrt(1 + (f / fc)^2))^order, i.e. order identical first order poles at fc.
+ * This function discretizes that analog prototype with the bilinear transform,
+ * prewarped at the cutoff frequency, and pairs the poles into second order sections.
+ *
+ * @param sampling_rate Sampling rate in hertz.
+ * @param cutoff_frequency Cutoff frequency in hertz, below the Nyquist frequency.
+ * @param order Filter order, strictly positive.
+ * @param gain Output gain.
+ * @return Unity DC gain cascade scaled by gain.
+ *
+ * @throws std::runtime_error If the parameters are invalid.
+ */
+BiquadCascade design_butterworth_lowpass_sos(
+    const double sampling_rate,
+    const double cutoff_frequency,
+    const int order,
+    const double gain = 1.0
+);
+
+/**
+ * @brief Design a causal Bessel low pass as a cascade of second order sections.
+ *
+ * The analog prototype is H(s) = theta_n(0) / theta_n(s / (2 pi fc)) with theta_n the
+ * reverse Bessel polynomial, which is the response used by
+ * apply_bessel_lowpass_filter_to_signal. Its poles are discretized with the bilinear
+ * transform prewarped at the cutoff frequency.
+ *
+ * @param sampling_rate Sampling rate in hertz.
+ * @param cutoff_frequency Cutoff frequency in hertz, below the Nyquist frequency.
+ * @param order Filter order, strictly positive.
+ * @param gain Output gain.
+ * @return Unity DC gain cascade scaled by gain.
+ *
+ * @throws std::runtime_error If the parameters are invalid.
+ */
+BiquadCascade design_bessel_lowpass_sos(
+    const double sampling_rate,
+    const double cutoff_frequency,
+    const int order,
+    const double gain = 1.0
+);
+
+/**
+ * @brief Discretize a unity DC gain all pole analog prototype into second order sections.
+ *
+ * @param normalized_poles Analog poles normalized to the angular cutoff frequency
+ *        (left half plane). Complex poles must come in conjugate pairs; only the member
+ *        with positive imaginary part is used.
+ * @param sampling_rate Sampling rate in hertz.
+ * @param cutoff_frequency Cutoff frequency in hertz used for the prewarping.
+ * @param gain Output gain.
+ * @return Cascade of second order sections.
+ */
+BiquadCascade discretize_all_pole_prototype(
+    const std::vector<std::complex<double>>& normalized_poles,
+    const double sampling_rate,
+    const double cutoff_frequency,
+    const double gain = 1.0
+);
+
+}
@@ -2,10 +2,11 @@
 #include <pybind11/stl.h>
 
 #include "utils.h"
+#include "module_binding.h"
 
 namespace py = pybind11;
 
-PYBIND11_MODULE(interface_utils, module) {
+FLOWCYPY_MODULE(interface_utils, module) {
     module.doc() = "Signal processing utility functions for filtering, noise, and pulse generation.";
 
     // ----------------------------
@@ -90,6 +91,36 @@ PYBIND11_MODULE(interface_utils, module) {
         )pbdoc"
     );
 
+    module.attr("fft_convolution_kernel_threshold") = utils::fft_convolution_kernel_threshold;
+
+    module.def(
+        "convolve_with_reflected_boundaries",
+        [](const std::vector<double>& signal, const std::vector<double>& kernel, const size_t fft_threshold) {
+            return utils::convolve_with_reflected_boundaries(signal, kernel, fft_threshold);
+        },
+        py::arg("signal"),
+        py::arg("kernel"),
+        py::arg("fft_threshold") = utils::fft_convolution_kernel_threshold,
+        R"pbdoc(
+        Correlate a signal with a centered kernel, mirroring the signal at its ends.
+
+        Parameters
+        ----------
+        signal : List[float]
+            Input signal.
+        kernel : List[float]
+            Centered kernel.
+        fft_threshold : int, optional
+            Kernel length from which FFT overlap-save blocks replace the direct
+            loop, for kernels no wider than the signal.
+
+        Returns
+        -------
+        List[float]
+            Filtered signal, as long as the input.
+        )pbdoc"
+    );
+
     // ----------------------------
     // Noise Functions
     // ----------------------------
@@ -139,10 +170,12 @@ PYBIND11_MODULE(interface_utils, module) {
         py::arg("coupling_power"),
         py::arg("time"),
         py::arg("background_power"),
+        py::arg("support_cutoff") = utils::pulse_synthesis::default_gaussian_support_cutoff,
         R"pbdoc(
         Generate Gaussian pulses and add them to a signal buffer.
 
         Each pulse is defined by a center and width, and added with specified coupling and background power.
+        Pulses are only evaluated within ``support_cutoff`` widths of their center.
 
         Parameters
         ----------
@@ -158,6 +191,9 @@ PYBIND11_MODULE(interface_utils, module) {
             Time axis corresponding to the signal.
         background_power : float
             Constant background signal level.
+        support_cutoff : float, optional
+            Half support of each pulse in units of its width. Use ``float('inf')`` to
+            evaluate every pulse on the full time axis.
         )pbdoc"
     );
 }
@@ -0,0 +1,124 @@
+#include "mapped_file.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+
+utils::MappedFile::MappedFile(const std::string& filename)
+    : filename(filename)
+{
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("MappedFile: cannot open '" + filename + "'.");
+    }
+
+    LARGE_INTEGER file_size;
+
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        throw std::runtime_error("MappedFile: cannot read the size of '" + filename + "'.");
+    }
+
+    this->file_handle = file;
+    this->size = static_cast<size_t>(file_size.QuadPart);
+
+    // Empty files cannot be mapped; they are exposed as an empty view.
+    if (this->size == 0) {
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        throw std::runtime_error("MappedFile: cannot map '" + filename + "'.");
+    }
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("MappedFile: cannot map '" + filename + "'.");
+    }
+
+    this->mapping_handle = mapping;
+    this->data = static_cast<const std::byte*>(view);
+}
+
+
+utils::MappedFile::~MappedFile() {
+    if (this->data != nullptr) {
+        UnmapViewOfFile(this->data);
+    }
+
+    if (this->mapping_handle != nullptr) {
+        CloseHandle(this->mapping_handle);
+    }
+
+    if (this->file_handle != nullptr) {
+        CloseHandle(this->file_handle);
+    }
+}
+
+#else
+
+utils::MappedFile::MappedFile(const std::string& filename)
+    : filename(filename)
+{
+    this->file_descriptor = ::open(filename.c_str(), O_RDONLY);
+
+    if (this->file_descriptor < 0) {
+        throw std::runtime_error("MappedFile: cannot open '" + filename + "'.");
+    }
+
+    struct stat file_status;
+
+    if (::fstat(this->file_descriptor, &file_status) != 0) {
+        ::close(this->file_descriptor);
+        throw std::runtime_error("MappedFile: cannot read the size of '" + filename + "'.");
+    }
+
+    this->size = static_cast<size_t>(file_status.st_size);
+
+    // Empty files cannot be mapped; they are exposed as an empty view.
+    if (this->size == 0) {
+        return;
+    }
+
+    void* view = ::mmap(nullptr, this->size, PROT_READ, MAP_SHARED, this->file_descriptor, 0);
+
+    if (view == MAP_FAILED) {
+        ::close(this->file_descriptor);
+        throw std::runtime_error("MappedFile: cannot map '" + filename + "'.");
+    }
+
+    this->data = static_cast<const std::byte*>(view);
+}
+
+
+utils::MappedFile::~MappedFile() {
+    if (this->data != nullptr) {
+        ::munmap(const_cast<std::byte*>(this->data), this->size);
+    }
+
+    if (this->file_descriptor >= 0) {
+        ::close(this->file_descriptor);
+    }
+}
+
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+
+namespace utils {
+
+/**
+ * @brief Read only memory mapping of a whole file.
+ *
+ * Pages are loaded by the operating system as they are touched, so readers can
+ * address files larger than memory and only pay for the bytes they use. The
+ * mapping is released with the object; views returned by bytes() must not
+ * outlive it.
+ */
+class MappedFile {
+public:
+    /**
+     * @param filename Path of the file to map.
+     *
+     * @throws std::runtime_error If the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& filename);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Whole file content.
+     */
+    std::span<const std::byte> bytes() const { return {this->data, this->size}; }
+
+    size_t get_size() const { return this->size; }
+
+    const std::string& get_filename() const { return this->filename; }
+
+private:
+    std::string filename;
+    const std::byte* data = nullptr;
+    size_t size = 0;
+
+#ifdef _WIN32
+    void* file_handle = nullptr;
+    void* mapping_handle = nullptr;
+#else
+    int file_descriptor = -1;
+#endif
+};
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+#ifndef FLOWCYPY_UNIFIED_MODULE
+#define FLOWCYPY_UNIFIED_MODULE 0
+#endif
+
+/*
+    @brief Defines the bindings of a component module, as PYBIND11_MODULE(name, variable) does.
+    @param name Module name; the body becomes void flowcypy_register_<name>(pybind11::module_& variable).
+    @param variable Name of the module the body fills.
+    @note A standalone build also defines the PYBIND11_MODULE entry point calling the registration
+          function. With FLOWCYPY_UNIFIED_MODULE, no entry point is emitted: the _flowcypy_core
+          extension calls the registration function of every component to fill its submodules.
+*/
+#if FLOWCYPY_UNIFIED_MODULE
+#define FLOWCYPY_MODULE(name, variable) \
+    void flowcypy_register_##name(pybind11::module_& variable)
+#else
+#define FLOWCYPY_MODULE(name, variable)                             \
+    void flowcypy_register_##name(pybind11::module_& variable);     \
+    PYBIND11_MODULE(name, flowcypy_module) {                        \
+        flowcypy_register_##name(flowcypy_module);                  \
+    }                                                               \
+    void flowcypy_register_##name(pybind11::module_& variable)
+#endif
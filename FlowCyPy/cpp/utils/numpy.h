@@ -1,16 +1,29 @@
+#pragma once
+
 #include <pybind11/numpy.h>
+#include <pint/pint.h>
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
 
 /*
     @brief Converts a std::vector to a NumPy array by moving the data.
     @tparam T The data type of the elements in the vector and NumPy array.
     @param data The std::vector whose data will be moved to the NumPy array.
     @param shape The desired shape of the resulting NumPy array.
-    @return A NumPy array containing the data from the input vector.
-    @note This function moves the data from the vector to the NumPy array, leaving the original vector in a valid but unspecified state.
+    @return A C contiguous NumPy array owning the buffer of the input vector.
+    @note The vector is left empty; its buffer is released by a capsule when the NumPy array is garbage collected.
 */
 template <class T>
 inline pybind11::array_t<T> vector_move_from_numpy(
-    const std::vector<T>& data,
+    std::vector<T>&& data,
     const std::vector<size_t>& shape
 )
 {
@@ -49,23 +62,169 @@ inline pybind11::array_t<T> vector_move_from_numpy(
     shape_ss.reserve(shape.size());
     for (size_t d : shape) shape_ss.push_back(static_cast<pybind11::ssize_t>(d));
 
-    pybind11::array_t<T> out(shape_ss);
-    if (got > 0) {
-        std::memcpy(out.mutable_data(),
-                    data.data(),
-                    got * sizeof(T));
-    }
-    return out;
+    std::vector<T>* owned_data = new std::vector<T>(std::move(data));
+
+    pybind11::capsule owner(owned_data, [](void* pointer) {
+        delete static_cast<std::vector<T>*>(pointer);
+    });
+
+    return pybind11::array_t<T>(shape_ss, owned_data->data(), owner);
 }
 
 
 
 template <class T>
 inline pybind11::array_t<T> vector_move_from_numpy(
-    const std::vector<T>& data,
+    std::vector<T>&& data,
     const size_t& size
 )
 {
     std::vector<size_t> shape = {size,};
     return vector_move_from_numpy(std::move(data), shape);
 }
+
+
+
+/*
+    @brief Hands a std::vector over to a NumPy array without copying its data.
+    @tparam T The data type of the elements in the vector and NumPy array.
+    @param data The std::vector to move; its buffer is owned by the returned array.
+    @return A one dimensional NumPy array viewing the moved buffer.
+    @note The buffer is released by a capsule when the NumPy array is garbage collected.
+*/
+template <class T>
+inline pybind11::array_t<T> vector_to_numpy_without_copy(std::vector<T>&& data)
+{
+    std::vector<T>* owned_data = new std::vector<T>(std::move(data));
+
+    pybind11::capsule owner(owned_data, [](void* pointer) {
+        delete static_cast<std::vector<T>*>(pointer);
+    });
+
+    return pybind11::array_t<T>(
+        static_cast<pybind11::ssize_t>(owned_data->size()),
+        owned_data->data(),
+        owner
+    );
+}
+
+
+/*
+    @brief Capsule holding a reference to a shared std::vector, as base of the arrays viewing it.
+    @tparam T The data type of the elements in the vector.
+    @param data The shared vector, kept alive until the capsule is garbage collected.
+*/
+template <class T>
+inline pybind11::capsule shared_vector_owner(std::shared_ptr<std::vector<T>> data)
+{
+    auto* owned_data = new std::shared_ptr<std::vector<T>>(std::move(data));
+
+    return pybind11::capsule(owned_data, [](void* pointer) {
+        delete static_cast<std::shared_ptr<std::vector<T>>*>(pointer);
+    });
+}
+
+
+/*
+    @brief Views a shared std::vector as a NumPy array without copying its data.
+    @tparam T The data type of the elements in the vector and NumPy array.
+    @param data The shared vector; the returned array holds a reference to it.
+    @return A one dimensional NumPy array viewing the vector buffer.
+    @note The vector must not be resized while the array is alive, as that would move its buffer.
+*/
+template <class T>
+inline pybind11::array_t<T> shared_vector_to_numpy(std::shared_ptr<std::vector<T>> data)
+{
+    const pybind11::ssize_t size = static_cast<pybind11::ssize_t>(data->size());
+    T* values = data->data();
+
+    return pybind11::array_t<T>(size, values, shared_vector_owner(std::move(data)));
+}
+
+
+
+/*
+    @brief NumPy array argument accepted without copy when it is already a C contiguous array of T.
+    @note Other inputs, such as lists or arrays of another dtype, are converted once by NumPy.
+*/
+template <class T>
+using contiguous_array = pybind11::array_t<T, pybind11::array::c_style | pybind11::array::forcecast>;
+
+
+
+/*
+    @brief Views an object as a C contiguous NumPy array of T, stripping Pint units if any.
+    @param object NumPy array, sequence, or Pint quantity whose magnitude is taken in its current units.
+    @return A view of the input when no conversion is needed, otherwise a converted copy.
+    @throws pybind11::error_already_set If the object cannot be converted.
+*/
+template <class T>
+inline contiguous_array<T> to_contiguous_array(const pybind11::handle& object)
+{
+    pybind11::object value = pybind11::reinterpret_borrow<pybind11::object>(object);
+
+    if (pybind11::hasattr(value, "magnitude")) {
+        value = value.attr("magnitude");
+    }
+
+    contiguous_array<T> array = contiguous_array<T>::ensure(value);
+
+    if (!array) {
+        throw pybind11::error_already_set();
+    }
+
+    return array;
+}
+
+
+
+/*
+    @brief Converts a Pint quantity to the given units and views its magnitude as a C contiguous NumPy array of T.
+    @param quantity Pint quantity with units compatible with units.
+    @param units Target units, for instance "volt".
+    @return The magnitude array, viewed without copy when it is already a contiguous array of T in the target units.
+    @note Double arrays are scaled by a cached conversion factor instead of going through Pint.
+*/
+template <class T>
+inline contiguous_array<T> quantity_to_contiguous_array(
+    const pybind11::handle& quantity,
+    const char* units
+)
+{
+    if constexpr (std::is_same_v<T, double>) {
+        return quantity_to_array_in_units(quantity, units);
+    }
+    else {
+        return to_contiguous_array<T>(quantity.attr("to")(units));
+    }
+}
+
+
+
+/*
+    @brief Non-owning view of the samples of a contiguous array.
+    @note The view is valid while the array is alive.
+*/
+template <class T>
+inline std::span<const T> array_to_span(const contiguous_array<T>& array)
+{
+    return {array.data(), static_cast<size_t>(array.size())};
+}
+
+
+
+/*
+    @brief Copies a contiguous array into a std::vector with a single memcpy.
+    @note Prefer this over the pybind11 list caster, which converts element by element.
+*/
+template <class T>
+inline std::vector<T> array_to_vector(const contiguous_array<T>& array)
+{
+    std::vector<T> output(static_cast<size_t>(array.size()));
+
+    if (!output.empty()) {
+        std::memcpy(output.data(), array.data(), output.size() * sizeof(T));
+    }
+
+    return output;
+}
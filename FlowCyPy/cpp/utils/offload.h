@@ -0,0 +1,53 @@
+#pragma once
+
+#include <omp.h>
+
+// Set to 1, with a compiler offload target, to let kernels run on an OpenMP target device.
+#ifndef FLOWCYPY_OPENMP_OFFLOAD
+#define FLOWCYPY_OPENMP_OFFLOAD 0
+#endif
+
+/*
+    Functions between FLOWCYPY_DECLARE_TARGET_BEGIN and FLOWCYPY_DECLARE_TARGET_END are
+    compiled for the offload device as well, so that target regions can call them.
+    Without offload both markers expand to nothing.
+*/
+#if FLOWCYPY_OPENMP_OFFLOAD
+#define FLOWCYPY_DECLARE_TARGET_BEGIN _Pragma("omp declare target")
+#define FLOWCYPY_DECLARE_TARGET_END _Pragma("omp end declare target")
+#else
+#define FLOWCYPY_DECLARE_TARGET_BEGIN
+#define FLOWCYPY_DECLARE_TARGET_END
+#endif
+
+// True in the device pass of an offload compilation, where host only code must be avoided.
+#if FLOWCYPY_OPENMP_OFFLOAD && (defined(__NVPTX__) || defined(__AMDGCN__))
+#define FLOWCYPY_DEVICE_COMPILATION 1
+#else
+#define FLOWCYPY_DEVICE_COMPILATION 0
+#endif
+
+
+namespace utils {
+namespace offload {
+
+/**
+ * @brief Whether this build can offload kernels, i.e. was compiled with FLOWCYPY_OPENMP_OFFLOAD=1.
+ */
+constexpr bool is_compiled() {
+    return FLOWCYPY_OPENMP_OFFLOAD != 0;
+}
+
+/**
+ * @brief Whether kernels can be offloaded now: offload is compiled and a target device is present.
+ */
+inline bool is_device_available() {
+#if FLOWCYPY_OPENMP_OFFLOAD
+    return omp_get_num_devices() > 0;
+#else
+    return false;
+#endif
+}
+
+}  // namespace offload
+}  // namespace utils
@@ -0,0 +1,96 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+
+namespace utils {
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+
+void Profiler::set_enabled(const bool enabled, const bool trace) {
+    this->tracing.store(enabled && trace, std::memory_order_relaxed);
+    this->enabled.store(enabled, std::memory_order_relaxed);
+}
+
+
+void Profiler::record_scope(
+    const char* name,
+    const std::chrono::steady_clock::time_point start,
+    const std::chrono::steady_clock::time_point stop
+) {
+    const double duration = std::chrono::duration<double>(stop - start).count();
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    ProfileEntry& entry = this->entries[name];
+
+    entry.minimum_time = entry.number_of_calls == 0 ? duration : std::min(entry.minimum_time, duration);
+    entry.maximum_time = std::max(entry.maximum_time, duration);
+    entry.total_time += duration;
+    entry.number_of_calls += 1;
+
+    if (!this->is_tracing()) {
+        return;
+    }
+
+    if (this->trace_events.size() >= max_trace_events) {
+        this->number_of_dropped_trace_events += 1;
+        return;
+    }
+
+    this->trace_events.push_back({
+        name,
+        static_cast<uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())),
+        std::chrono::duration<double, std::micro>(start.time_since_epoch()).count(),
+        duration * 1e6
+    });
+}
+
+
+void Profiler::add_counter(const char* name, const char* counter, const double value) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->entries[name].counters[counter] += value;
+}
+
+
+void Profiler::max_counter(const char* name, const char* counter, const double value) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    double& current = this->entries[name].counters[counter];
+    current = std::max(current, value);
+}
+
+
+std::map<std::string, ProfileEntry> Profiler::get_report() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->entries;
+}
+
+
+std::vector<ProfileTraceEvent> Profiler::get_trace_events() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->trace_events;
+}
+
+
+size_t Profiler::get_number_of_dropped_trace_events() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->number_of_dropped_trace_events;
+}
+
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    this->entries.clear();
+    this->trace_events.clear();
+    this->number_of_dropped_trace_events = 0;
+}
+
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Set to 0 to compile the timers and counters out of every component.
+#ifndef FLOWCYPY_PROFILING
+#define FLOWCYPY_PROFILING 1
+#endif
+
+
+namespace utils {
+
+/**
+ * @brief Accumulated timings and counters of one instrumented scope.
+ */
+struct ProfileEntry {
+    size_t number_of_calls = 0;
+    double total_time = 0.0;        // [second]
+    double minimum_time = 0.0;      // [second]
+    double maximum_time = 0.0;      // [second]
+
+    /// Named counters of the scope, e.g. "samples", "bytes", "events", "threads".
+    std::map<std::string, double> counters;
+};
+
+
+/**
+ * @brief One completed scope, as a Chrome trace "complete" event.
+ */
+struct ProfileTraceEvent {
+    std::string name;
+    uint64_t thread_id = 0;
+    double start_time = 0.0;        // [microsecond], on the steady clock
+    double duration = 0.0;          // [microsecond]
+};
+
+
+/**
+ * @brief Collects the scoped timers and counters of the instrumented kernels.
+ *
+ * Each extension module owns its profiler; FlowCyPy.profiling enables them
+ * together and merges their reports. The profiler is disabled by default and
+ * an instrumented scope then costs a single relaxed atomic load. Scopes are
+ * placed around whole kernels, not inside their loops, so recording takes a
+ * lock.
+ *
+ * Building with FLOWCYPY_PROFILING=0 removes the instrumentation entirely.
+ */
+class Profiler {
+public:
+    /// Trace events kept at most; later events are counted as dropped.
+    static constexpr size_t max_trace_events = size_t{1} << 20;
+
+    /**
+     * @brief Return the profiler of this module.
+     */
+    static Profiler& instance();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /**
+     * @param enabled Whether scopes and counters are recorded.
+     * @param trace Whether every scope is also kept as a trace event.
+     */
+    void set_enabled(const bool enabled, const bool trace = false);
+
+    bool is_enabled() const { return this->enabled.load(std::memory_order_relaxed); }
+    bool is_tracing() const { return this->tracing.load(std::memory_order_relaxed); }
+
+    void record_scope(
+        const char* name,
+        const std::chrono::steady_clock::time_point start,
+        const std::chrono::steady_clock::time_point stop
+    );
+
+    /**
+     * @brief Add a value to a counter of a scope.
+     */
+    void add_counter(const char* name, const char* counter, const double value);
+
+    /**
+     * @brief Raise a counter of a scope to a value, e.g. the number of threads used.
+     */
+    void max_counter(const char* name, const char* counter, const double value);
+
+    std::map<std::string, ProfileEntry> get_report() const;
+    std::vector<ProfileTraceEvent> get_trace_events() const;
+    size_t get_number_of_dropped_trace_events() const;
+
+    /**
+     * @brief Forget every recorded scope, counter and trace event.
+     */
+    void reset();
+
+private:
+    Profiler() = default;
+
+    std::atomic<bool> enabled{false};
+    std::atomic<bool> tracing{false};
+
+    mutable std::mutex mutex;
+    std::map<std::string, ProfileEntry> entries;
+    std::vector<ProfileTraceEvent> trace_events;
+    size_t number_of_dropped_trace_events = 0;
+};
+
+
+/**
+ * @brief Times the enclosing scope when the profiler is enabled.
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* name)
+        : name(Profiler::instance().is_enabled() ? name : nullptr)
+    {
+        if (this->name) {
+            this->start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedTimer() {
+        if (this->name) {
+            Profiler::instance().record_scope(this->name, this->start, std::chrono::steady_clock::now());
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+};
+
+}
+
+
+#define FLOWCYPY_PROFILE_CONCATENATE_IMPLEMENTATION(first, second) first##second
+#define FLOWCYPY_PROFILE_CONCATENATE(first, second) FLOWCYPY_PROFILE_CONCATENATE_IMPLEMENTATION(first, second)
+
+#if FLOWCYPY_PROFILING
+
+/// Time the rest of the enclosing scope under a name, e.g. "source.generate_pulses".
+#define FLOWCYPY_PROFILE_SCOPE(name) \
+    const utils::ScopedTimer FLOWCYPY_PROFILE_CONCATENATE(flowcypy_profile_scope_, __LINE__)(name)
+
+/// Add a value to a counter of a scope; the value is not evaluated while profiling is disabled.
+#define FLOWCYPY_PROFILE_COUNT(name, counter, value)                                                     \
+    do {                                                                                                 \
+        if (utils::Profiler::instance().is_enabled()) {                                                  \
+            utils::Profiler::instance().add_counter(name, counter, static_cast<double>(value));           \
+        }                                                                                                \
+    } while (0)
+
+/// Raise a counter of a scope to a value; the value is not evaluated while profiling is disabled.
+#define FLOWCYPY_PROFILE_MAX(name, counter, value)                                                       \
+    do {                                                                                                 \
+        if (utils::Profiler::instance().is_enabled()) {                                                  \
+            utils::Profiler::instance().max_counter(name, counter, static_cast<double>(value));           \
+        }                                                                                                \
+    } while (0)
+
+#else
+
+#define FLOWCYPY_PROFILE_SCOPE(name) do {} while (0)
+#define FLOWCYPY_PROFILE_COUNT(name, counter, value) do {} while (0)
+#define FLOWCYPY_PROFILE_MAX(name, counter, value) do {} while (0)
+
+#endif
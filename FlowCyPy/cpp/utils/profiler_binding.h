@@ -0,0 +1,105 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+#include <utils/profiler.h>
+
+/*
+    @brief Adds the profiling functions to an extension module.
+    @param module The pybind11 module whose kernels are instrumented.
+    @note Each extension module owns its Profiler; FlowCyPy.profiling calls the
+          functions of every module and merges their reports.
+*/
+inline void register_profiling_functions(pybind11::module_& module) {
+    module.def(
+        "set_profiling_enabled",
+        [](const bool enabled, const bool trace) {
+            utils::Profiler::instance().set_enabled(enabled, trace);
+        },
+        pybind11::arg("enabled"),
+        pybind11::arg("trace") = false,
+        R"pbdoc(
+            Enable or disable the timers and counters of this module.
+
+            Parameters
+            ----------
+            enabled : bool
+                Whether instrumented scopes are recorded.
+            trace : bool, optional
+                Whether every scope is also kept as a trace event.
+        )pbdoc"
+    );
+
+    module.def(
+        "reset_profiling",
+        []() {
+            utils::Profiler::instance().reset();
+        },
+        R"pbdoc(
+            Forget the timers, counters and trace events recorded by this module.
+        )pbdoc"
+    );
+
+    module.def(
+        "get_profiling_report",
+        []() {
+            pybind11::dict report;
+
+            for (const auto& [name, entry] : utils::Profiler::instance().get_report()) {
+                pybind11::dict counters;
+
+                for (const auto& [counter, value] : entry.counters) {
+                    counters[pybind11::str(counter)] = value;
+                }
+
+                pybind11::dict scope;
+                scope["calls"] = entry.number_of_calls;
+                scope["total_time"] = entry.total_time;
+                scope["min_time"] = entry.minimum_time;
+                scope["max_time"] = entry.maximum_time;
+                scope["counters"] = counters;
+
+                report[pybind11::str(name)] = scope;
+            }
+
+            return report;
+        },
+        R"pbdoc(
+            Timers and counters recorded by this module.
+
+            Returns
+            -------
+            dict
+                Keyed by scope name, each a dict with ``calls``, ``total_time``,
+                ``min_time`` and ``max_time`` in seconds, and ``counters``.
+        )pbdoc"
+    );
+
+    module.def(
+        "get_profiling_trace",
+        []() {
+            pybind11::list events;
+
+            for (const utils::ProfileTraceEvent& event : utils::Profiler::instance().get_trace_events()) {
+                pybind11::dict trace_event;
+                trace_event["name"] = event.name;
+                trace_event["tid"] = event.thread_id;
+                trace_event["ts"] = event.start_time;
+                trace_event["dur"] = event.duration;
+
+                events.append(trace_event);
+            }
+
+            return events;
+        },
+        R"pbdoc(
+            Trace events recorded by this module while tracing was enabled.
+
+            Returns
+            -------
+            list of dict
+                One dict per scope with ``name``, ``tid``, and ``ts`` and ``dur``
+                in microseconds, as in the Chrome trace event format.
+        )pbdoc"
+    );
+}
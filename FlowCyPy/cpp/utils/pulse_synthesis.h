@@ -0,0 +1,758 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+#include <omp.h>
+
+#include <utils/threading.h>
+
+
+namespace utils {
+namespace pulse_synthesis {
+
+/**
+ * @brief Number of samples per tile used by the pulse local synthesis engine.
+ *
+ * A tile of 4096 double precision samples occupies 32 KiB, which keeps the
+ * accumulation target resident in the L1 / L2 cache while the events overlapping
+ * the tile are processed.
+ */
+constexpr size_t default_tile_size = 4096;
+
+/**
+ * @brief Default half support of a truncated Gaussian pulse in units of sigma.
+ *
+ * At eight standard deviations the neglected tail is below exp(-32), i.e. roughly
+ * 1e-14 of the pulse amplitude, which is below double precision resolution for any
+ * signal whose baseline is of the same order as the pulse.
+ */
+constexpr double default_gaussian_support_cutoff = 8.0;
+
+/**
+ * @brief Half open sample range [first, last) touched by one pulse.
+ */
+struct PulseFootprint {
+    size_t first;
+    size_t last;
+};
+
+/**
+ * @brief Check whether a time axis is sorted in non decreasing order.
+ *
+ * @param time Time axis.
+ * @return True if time[i] <= time[i + 1] for all i.
+ */
+inline bool is_non_decreasing(std::span<const double> time) {
+    return std::is_sorted(time.begin(), time.end());
+}
+
+/**
+ * @brief Locate the samples lying inside the support of one pulse.
+ *
+ * A sample t belongs to the support if -half_support <= (t - center) <= half_support.
+ * The offset t - center is evaluated exactly as in a dense per sample test, so the
+ * footprint selects the same samples as a brute force scan would.
+ *
+ * @param time Time axis, sorted in non decreasing order.
+ * @param center Pulse center.
+ * @param half_support Half width of the pulse support, in the same unit as time.
+ * @return Sample range [first, last) of the pulse support, possibly empty.
+ */
+inline PulseFootprint compute_pulse_footprint(
+    std::span<const double> time,
+    const double center,
+    const double half_support
+) {
+    const auto first = std::partition_point(
+        time.begin(),
+        time.end(),
+        [center, half_support](double t) { return (t - center) < -half_support; }
+    );
+
+    const auto last = std::partition_point(
+        first,
+        time.end(),
+        [center, half_support](double t) { return (t - center) <= half_support; }
+    );
+
+    return PulseFootprint{
+        static_cast<size_t>(first - time.begin()),
+        static_cast<size_t>(last - time.begin())
+    };
+}
+
+/**
+ * @brief Visit every (event, sample) pair lying inside the support of a pulse.
+ *
+ * Each pulse is only visited inside its own support instead of on the full time
+ * axis, which reduces the cost from O(N_samples x N_events) to
+ * O(N_samples + sum of the pulse footprints).
+ *
+ * Events are binned into fixed size time tiles (an event spanning several tiles is
+ * registered in each of them) and the OpenMP loop runs over tiles. Each sample index
+ * is therefore only ever visited by one thread, and a visitor writing to sample
+ * sample_index of one or several outputs needs no atomic update. Inside a tile events
+ * are visited in their input order, so the summation order per sample, and hence the
+ * result, does not depend on the number of threads.
+ *
+ * If the time axis is not sorted, footprints cannot be located by bisection, and if a
+ * support is infinite tiling brings nothing. In both cases the engine falls back to a
+ * dense scan parallelized over samples, which keeps the same ownership guarantee.
+ *
+ * @tparam Visitor Callable with signature void(size_t event_index, size_t sample_index).
+ * @param time Time axis.
+ * @param centers Pulse centers, one per event.
+ * @param half_supports Half width of the support of each pulse, one per event.
+ * @param visitor Callback invoked for each sample inside each pulse support.
+ * @param tile_size Number of samples per tile.
+ *
+ * @throws std::runtime_error If the input sizes are inconsistent or tile_size is zero.
+ */
+template <typename Visitor>
+void for_each_pulse_sample(
+    std::span<const double> time,
+    std::span<const double> centers,
+    std::span<const double> half_supports,
+    const Visitor& visitor,
+    const size_t tile_size = default_tile_size
+) {
+    if (centers.size() != half_supports.size()) {
+        throw std::runtime_error("centers and half_supports must have the same length.");
+    }
+
+    if (tile_size == 0) {
+        throw std::runtime_error("tile_size must be strictly positive.");
+    }
+
+    const size_t number_of_samples = time.size();
+    const size_t number_of_events = centers.size();
+
+    if (number_of_samples == 0 || number_of_events == 0) {
+        return;
+    }
+
+    const bool has_unbounded_support = std::any_of(
+        half_supports.begin(),
+        half_supports.end(),
+        [](double half_support) { return !std::isfinite(half_support); }
+    );
+
+    if (has_unbounded_support || !is_non_decreasing(time)) {
+        #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(number_of_samples * number_of_events, utils::ParallelComponent::source))
+        for (long long sample_index = 0; sample_index < static_cast<long long>(number_of_samples); ++sample_index) {
+            const double time_value = time[sample_index];
+
+            for (size_t event_index = 0; event_index < number_of_events; ++event_index) {
+                if (std::abs(time_value - centers[event_index]) <= half_supports[event_index]) {
+                    visitor(event_index, static_cast<size_t>(sample_index));
+                }
+            }
+        }
+
+        return;
+    }
+
+    std::vector<PulseFootprint> footprints(number_of_events);
+
+    #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(number_of_events, utils::ParallelComponent::source))
+    for (long long event_index = 0; event_index < static_cast<long long>(number_of_events); ++event_index) {
+        footprints[event_index] = compute_pulse_footprint(
+            time,
+            centers[event_index],
+            half_supports[event_index]
+        );
+    }
+
+    // Bin events into tiles as a compressed sparse row table: tile_offsets[tile]
+    // points to the first entry of tile_events belonging to that tile.
+    const size_t number_of_tiles = (number_of_samples + tile_size - 1) / tile_size;
+
+    std::vector<size_t> tile_offsets(number_of_tiles + 1, 0);
+    size_t number_of_visits = 0;
+
+    for (const PulseFootprint& footprint : footprints) {
+        if (footprint.first >= footprint.last) {
+            continue;
+        }
+
+        number_of_visits += footprint.last - footprint.first;
+
+        const size_t first_tile = footprint.first / tile_size;
+        const size_t last_tile = (footprint.last - 1) / tile_size;
+
+        for (size_t tile = first_tile; tile <= last_tile; ++tile) {
+            ++tile_offsets[tile + 1];
+        }
+    }
+
+    for (size_t tile = 0; tile < number_of_tiles; ++tile) {
+        tile_offsets[tile + 1] += tile_offsets[tile];
+    }
+
+    std::vector<size_t> tile_events(tile_offsets.back());
+    std::vector<size_t> tile_cursor(tile_offsets.begin(), tile_offsets.end() - 1);
+
+    for (size_t event_index = 0; event_index < number_of_events; ++event_index) {
+        const PulseFootprint& footprint = footprints[event_index];
+
+        if (footprint.first >= footprint.last) {
+            continue;
+        }
+
+        const size_t first_tile = footprint.first / tile_size;
+        const size_t last_tile = (footprint.last - 1) / tile_size;
+
+        for (size_t tile = first_tile; tile <= last_tile; ++tile) {
+            tile_events[tile_cursor[tile]++] = event_index;
+        }
+    }
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(utils::get_team_size(number_of_visits, utils::ParallelComponent::source))
+    for (long long tile = 0; tile < static_cast<long long>(number_of_tiles); ++tile) {
+        const size_t tile_start = static_cast<size_t>(tile) * tile_size;
+        const size_t tile_end = std::min(tile_start + tile_size, number_of_samples);
+
+        for (size_t entry = tile_offsets[tile]; entry < tile_offsets[tile + 1]; ++entry) {
+            const size_t event_index = tile_events[entry];
+            const PulseFootprint& footprint = footprints[event_index];
+
+            const size_t first = std::max(footprint.first, tile_start);
+            const size_t last = std::min(footprint.last, tile_end);
+
+            for (size_t sample_index = first; sample_index < last; ++sample_index) {
+                visitor(event_index, sample_index);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Accumulate a sum of compactly supported pulses onto a signal.
+ *
+ * Thin wrapper around for_each_pulse_sample for the single channel case.
+ *
+ * @tparam Profile Callable with signature double(size_t event_index, double time).
+ *         It must return the contribution of one event at one time value and may be
+ *         called concurrently from several threads.
+ * @param signal Output signal, accumulated in place. Must have the size of time.
+ * @param time Time axis of the signal.
+ * @param centers Pulse centers, one per event.
+ * @param half_supports Half width of the support of each pulse, one per event.
+ * @param profile Pulse profile evaluator.
+ * @param tile_size Number of samples per tile.
+ *
+ * @throws std::runtime_error If the input sizes are inconsistent or tile_size is zero.
+ */
+template <typename Profile>
+void accumulate_pulses(
+    std::vector<double>& signal,
+    std::span<const double> time,
+    std::span<const double> centers,
+    std::span<const double> half_supports,
+    const Profile& profile,
+    const size_t tile_size = default_tile_size
+) {
+    if (signal.size() != time.size()) {
+        throw std::runtime_error("signal and time must have the same length.");
+    }
+
+    for_each_pulse_sample(
+        time,
+        centers,
+        half_supports,
+        [&](size_t event_index, size_t sample_index) {
+            signal[sample_index] += profile(event_index, time[sample_index]);
+        },
+        tile_size
+    );
+}
+
+/**
+ * @brief Accumulate pulses sharing one envelope onto several channels at once.
+ *
+ * The envelope of each event is evaluated once per sample and scattered into every
+ * channel with a per channel amplitude, so the cost of the envelope is paid once
+ * regardless of the number of channels.
+ *
+ * Envelopes and amplitudes are evaluated in double precision; only the stored
+ * contribution is rounded to Real.
+ *
+ * @tparam Real Sample type of the signals, double or float.
+ * @tparam Envelope Callable with signature double(size_t event_index, double time)
+ *         returning the unit amplitude envelope of one event.
+ * @param signals Output signals, one per channel, each of the size of time.
+ * @param time Time axis of the signals.
+ * @param centers Pulse centers, one per event.
+ * @param half_supports Half width of the support of each pulse, one per event.
+ * @param amplitudes Row major (n_events x n_channels) amplitude matrix.
+ * @param envelope Pulse envelope evaluator.
+ * @param tile_size Number of samples per tile.
+ *
+ * @throws std::runtime_error If the input sizes are inconsistent.
+ */
+template <typename Real, typename Envelope>
+void accumulate_multichannel_pulses(
+    std::vector<std::vector<Real>>& signals,
+    std::span<const double> time,
+    std::span<const double> centers,
+    std::span<const double> half_supports,
+    std::span<const double> amplitudes,
+    const Envelope& envelope,
+    const size_t tile_size = default_tile_size
+) {
+    const size_t number_of_channels = signals.size();
+
+    for (const std::vector<Real>& signal : signals) {
+        if (signal.size() != time.size()) {
+            throw std::runtime_error("every signal must have the length of time.");
+        }
+    }
+
+    if (amplitudes.size() != centers.size() * number_of_channels) {
+        throw std::runtime_error("amplitudes must hold n_events x n_channels values.");
+    }
+
+    if (number_of_channels == 0) {
+        return;
+    }
+
+    std::vector<Real*> channel_pointers(number_of_channels);
+
+    for (size_t channel = 0; channel < number_of_channels; ++channel) {
+        channel_pointers[channel] = signals[channel].data();
+    }
+
+    for_each_pulse_sample(
+        time,
+        centers,
+        half_supports,
+        [&](size_t event_index, size_t sample_index) {
+            const double value = envelope(event_index, time[sample_index]);
+            const double* event_amplitudes = amplitudes.data() + event_index * number_of_channels;
+
+            for (size_t channel = 0; channel < number_of_channels; ++channel) {
+                channel_pointers[channel][sample_index] += static_cast<Real>(value * event_amplitudes[channel]);
+            }
+        },
+        tile_size
+    );
+}
+
+/**
+ * @brief Rising or falling edge of one rectangular pulse.
+ */
+struct PulseEdge {
+    size_t sample_index;
+    size_t event_index;
+    bool is_rising;
+};
+
+/**
+ * @brief Accumulate rectangular pulses onto several channels from their edges.
+ *
+ * A rectangular pulse is fully described by the two edges of its footprint: it
+ * adds its amplitude from sample first onwards and removes it again from sample
+ * last onwards. The pulses are thus accumulated as a sparse difference array: the
+ * 2 x N_events edges are sorted by sample and swept once, and between two edges
+ * the running level is added to every covered sample. The cost is
+ * O(N_events log N_events + covered samples) however much the pulses overlap, and
+ * samples covered by no pulse are not touched.
+ *
+ * The sweep is split into the fixed size tiles of for_each_pulse_sample. The level
+ * entering each tile is obtained by one serial scan over the edges, after which the
+ * tiles are swept in parallel. The tiling does not depend on the number of threads,
+ * so neither does the result. Whenever no pulse is active the level is reset to an
+ * exact zero, so rounding never leaks from one pulse into the samples that follow.
+ *
+ * Sample inclusion is the one of compute_pulse_footprint, i.e. the samples
+ * satisfying |t - center| <= half_support, as in a dense scan.
+ *
+ * @tparam Real Sample type of the signals, double or float.
+ * @param channels Output signals, one pointer per channel, each of the size of time.
+ * @param time Time axis, sorted in non decreasing order.
+ * @param centers Pulse centers, one per event.
+ * @param half_supports Half width of the support of each pulse, one per event.
+ * @param amplitudes Row major (n_events x n_channels) amplitude matrix.
+ * @param tile_size Number of samples per tile.
+ */
+template <typename Real>
+void accumulate_rectangular_pulse_edges(
+    std::span<Real* const> channels,
+    std::span<const double> time,
+    std::span<const double> centers,
+    std::span<const double> half_supports,
+    std::span<const double> amplitudes,
+    const size_t tile_size = default_tile_size
+) {
+    const size_t number_of_channels = channels.size();
+    const size_t number_of_samples = time.size();
+    const size_t number_of_events = centers.size();
+
+    if (number_of_channels == 0 || number_of_samples == 0 || number_of_events == 0) {
+        return;
+    }
+
+    std::vector<PulseFootprint> footprints(number_of_events);
+
+    #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(number_of_events, utils::ParallelComponent::source))
+    for (long long event_index = 0; event_index < static_cast<long long>(number_of_events); ++event_index) {
+        footprints[event_index] = compute_pulse_footprint(
+            time,
+            centers[event_index],
+            half_supports[event_index]
+        );
+    }
+
+    // Falling edges at the end of the time axis never take effect and are dropped.
+    std::vector<PulseEdge> edges;
+    edges.reserve(2 * number_of_events);
+
+    for (size_t event_index = 0; event_index < number_of_events; ++event_index) {
+        const PulseFootprint& footprint = footprints[event_index];
+
+        if (footprint.first >= footprint.last) {
+            continue;
+        }
+
+        edges.push_back(PulseEdge{footprint.first, event_index, true});
+
+        if (footprint.last < number_of_samples) {
+            edges.push_back(PulseEdge{footprint.last, event_index, false});
+        }
+    }
+
+    // A stable sort keeps events in input order on a shared sample, which fixes the
+    // summation order of the running level.
+    std::stable_sort(
+        edges.begin(),
+        edges.end(),
+        [](const PulseEdge& left, const PulseEdge& right) { return left.sample_index < right.sample_index; }
+    );
+
+    const auto apply_edge = [&](const PulseEdge& edge, double* levels, size_t& number_of_active_pulses) {
+        const double* event_amplitudes = amplitudes.data() + edge.event_index * number_of_channels;
+
+        if (edge.is_rising) {
+            ++number_of_active_pulses;
+
+            for (size_t channel = 0; channel < number_of_channels; ++channel) {
+                levels[channel] += event_amplitudes[channel];
+            }
+
+            return;
+        }
+
+        --number_of_active_pulses;
+
+        for (size_t channel = 0; channel < number_of_channels; ++channel) {
+            levels[channel] = number_of_active_pulses == 0 ? 0.0 : levels[channel] - event_amplitudes[channel];
+        }
+    };
+
+    // Serial scan: edge range, number of active pulses and levels entering each tile.
+    const size_t number_of_tiles = (number_of_samples + tile_size - 1) / tile_size;
+
+    std::vector<size_t> tile_edge_offsets(number_of_tiles + 1);
+    std::vector<size_t> tile_active_pulses(number_of_tiles);
+    std::vector<double> tile_levels(number_of_tiles * number_of_channels);
+
+    std::vector<double> levels(number_of_channels, 0.0);
+    size_t number_of_active_pulses = 0;
+    size_t edge_index = 0;
+
+    for (size_t tile = 0; tile < number_of_tiles; ++tile) {
+        const size_t tile_start = tile * tile_size;
+
+        while (edge_index < edges.size() && edges[edge_index].sample_index < tile_start) {
+            apply_edge(edges[edge_index++], levels.data(), number_of_active_pulses);
+        }
+
+        tile_edge_offsets[tile] = edge_index;
+        tile_active_pulses[tile] = number_of_active_pulses;
+        std::copy(levels.begin(), levels.end(), tile_levels.begin() + tile * number_of_channels);
+    }
+
+    tile_edge_offsets[number_of_tiles] = edges.size();
+
+    #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(number_of_samples * number_of_channels, utils::ParallelComponent::source))
+    for (long long tile = 0; tile < static_cast<long long>(number_of_tiles); ++tile) {
+        const size_t tile_start = static_cast<size_t>(tile) * tile_size;
+        const size_t tile_end = std::min(tile_start + tile_size, number_of_samples);
+
+        double* local_levels = tile_levels.data() + static_cast<size_t>(tile) * number_of_channels;
+        size_t local_active_pulses = tile_active_pulses[tile];
+        size_t cursor = tile_start;
+
+        const auto fill_until = [&](const size_t stop) {
+            if (local_active_pulses != 0) {
+                for (size_t channel = 0; channel < number_of_channels; ++channel) {
+                    Real* signal = channels[channel];
+                    const double level = local_levels[channel];
+
+                    for (size_t sample_index = cursor; sample_index < stop; ++sample_index) {
+                        signal[sample_index] += static_cast<Real>(level);
+                    }
+                }
+            }
+
+            cursor = stop;
+        };
+
+        for (size_t entry = tile_edge_offsets[tile]; entry < tile_edge_offsets[tile + 1]; ++entry) {
+            fill_until(edges[entry].sample_index);
+            apply_edge(edges[entry], local_levels, local_active_pulses);
+        }
+
+        fill_until(tile_end);
+    }
+}
+
+/**
+ * @brief Accumulate Gaussian pulses truncated at a given number of sigma.
+ *
+ * Each pulse contributes amplitude * exp(-0.5 * ((t - center) / sigma)^2) on the
+ * samples satisfying |t - center| <= support_cutoff * sigma. A non finite
+ * support_cutoff disables truncation and reproduces the exact dense sum.
+ *
+ * @param signal Output signal, accumulated in place.
+ * @param time Time axis of the signal.
+ * @param centers Pulse centers.
+ * @param sigmas Pulse standard deviations, strictly positive.
+ * @param amplitudes Pulse amplitudes.
+ * @param support_cutoff Half support in units of sigma. Must be strictly positive.
+ *
+ * @throws std::runtime_error If the input sizes are inconsistent or support_cutoff is not positive.
+ */
+inline void accumulate_gaussian_pulses(
+    std::vector<double>& signal,
+    std::span<const double> time,
+    std::span<const double> centers,
+    std::span<const double> sigmas,
+    std::span<const double> amplitudes,
+    const double support_cutoff = default_gaussian_support_cutoff
+) {
+    if (centers.size() != sigmas.size() || centers.size() != amplitudes.size()) {
+        throw std::runtime_error("centers, sigmas and amplitudes must have the same length.");
+    }
+
+    if (!(support_cutoff > 0.0)) {
+        throw std::runtime_error("support_cutoff must be strictly positive.");
+    }
+
+    std::vector<double> half_supports(sigmas.size());
+    std::vector<double> inverse_sigmas(sigmas.size());
+
+    for (size_t index = 0; index < sigmas.size(); ++index) {
+        half_supports[index] = support_cutoff * sigmas[index];
+        inverse_sigmas[index] = 1.0 / sigmas[index];
+    }
+
+    accumulate_pulses(
+        signal,
+        time,
+        centers,
+        half_supports,
+        [&](size_t event_index, double time_value) {
+            const double normalized_time = (time_value - centers[event_index]) * inverse_sigmas[event_index];
+            return amplitudes[event_index] * std::exp(-0.5 * normalized_time * normalized_time);
+        }
+    );
+}
+
+/**
+ * @brief Accumulate rectangular pulses of full width `widths`.
+ *
+ * Each pulse contributes its amplitude on the samples satisfying
+ * |t - center| <= width / 2. Rectangular pulses are compactly supported, so no
+ * truncation is involved and the samples covered match the dense evaluation exactly.
+ * On a sorted time axis the pulses are accumulated from their edges, see
+ * accumulate_rectangular_pulse_edges; otherwise the dense fallback of
+ * for_each_pulse_sample is used.
+ *
+ * @param signal Output signal, accumulated in place.
+ * @param time Time axis of the signal.
+ * @param centers Pulse centers.
+ * @param widths Full pulse widths.
+ * @param amplitudes Pulse amplitudes.
+ *
+ * @throws std::runtime_error If the input sizes are inconsistent.
+ */
+inline void accumulate_rectangular_pulses(
+    std::vector<double>& signal,
+    std::span<const double> time,
+    std::span<const double> centers,
+    std::span<const double> widths,
+    std::span<const double> amplitudes
+) {
+    if (centers.size() != widths.size() || centers.size() != amplitudes.size()) {
+        throw std::runtime_error("centers, widths and amplitudes must have the same length.");
+    }
+
+    std::vector<double> half_supports(widths.size());
+
+    for (size_t index = 0; index < widths.size(); ++index) {
+        half_supports[index] = widths[index] / 2.0;
+    }
+
+    if (is_non_decreasing(time)) {
+        if (signal.size() != time.size()) {
+            throw std::runtime_error("signal and time must have the same length.");
+        }
+
+        double* const channel_pointer = signal.data();
+
+        accumulate_rectangular_pulse_edges(
+            std::span<double* const>(&channel_pointer, 1),
+            time,
+            centers,
+            half_supports,
+            amplitudes
+        );
+
+        return;
+    }
+
+    accumulate_pulses(
+        signal,
+        time,
+        centers,
+        half_supports,
+        [&](size_t event_index, double) {
+            return amplitudes[event_index];
+        }
+    );
+}
+
+/**
+ * @brief Accumulate truncated Gaussian pulses onto several channels at once.
+ *
+ * Multi channel counterpart of accumulate_gaussian_pulses: channel c receives
+ * amplitudes[event * n_channels + c] * exp(-0.5 * ((t - center) / sigma)^2).
+ *
+ * @tparam Real Sample type of the signals, double or float.
+ * @param signals Output signals, one per channel.
+ * @param time Time axis of the signals.
+ * @param centers Pulse centers.
+ * @param sigmas Pulse standard deviations, strictly positive.
+ * @param amplitudes Row major (n_events x n_channels) amplitude matrix.
+ * @param support_cutoff Half support in units of sigma. Must be strictly positive.
+ *
+ * @throws std::runtime_error If the input sizes are inconsistent or support_cutoff is not positive.
+ */
+template <typename Real>
+void accumulate_multichannel_gaussian_pulses(
+    std::vector<std::vector<Real>>& signals,
+    std::span<const double> time,
+    std::span<const double> centers,
+    std::span<const double> sigmas,
+    std::span<const double> amplitudes,
+    const double support_cutoff = default_gaussian_support_cutoff
+) {
+    if (centers.size() != sigmas.size()) {
+        throw std::runtime_error("centers and sigmas must have the same length.");
+    }
+
+    if (!(support_cutoff > 0.0)) {
+        throw std::runtime_error("support_cutoff must be strictly positive.");
+    }
+
+    std::vector<double> half_supports(sigmas.size());
+    std::vector<double> inverse_sigmas(sigmas.size());
+
+    for (size_t index = 0; index < sigmas.size(); ++index) {
+        half_supports[index] = support_cutoff * sigmas[index];
+        inverse_sigmas[index] = 1.0 / sigmas[index];
+    }
+
+    accumulate_multichannel_pulses(
+        signals,
+        time,
+        centers,
+        half_supports,
+        amplitudes,
+        [&](size_t event_index, double time_value) {
+            const double normalized_time = (time_value - centers[event_index]) * inverse_sigmas[event_index];
+            return std::exp(-0.5 * normalized_time * normalized_time);
+        }
+    );
+}
+
+/**
+ * @brief Accumulate rectangular pulses onto several channels at once.
+ *
+ * Multi channel counterpart of accumulate_rectangular_pulses: on a sorted time axis
+ * the edges of each pulse are swept once for all channels.
+ *
+ * @tparam Real Sample type of the signals, double or float.
+ * @param signals Output signals, one per channel.
+ * @param time Time axis of the signals.
+ * @param centers Pulse centers.
+ * @param widths Full pulse widths.
+ * @param amplitudes Row major (n_events x n_channels) amplitude matrix.
+ *
+ * @throws std::runtime_error If the input sizes are inconsistent.
+ */
+template <typename Real>
+void accumulate_multichannel_rectangular_pulses(
+    std::vector<std::vector<Real>>& signals,
+    std::span<const double> time,
+    std::span<const double> centers,
+    std::span<const double> widths,
+    std::span<const double> amplitudes
+) {
+    if (centers.size() != widths.size()) {
+        throw std::runtime_error("centers and widths must have the same length.");
+    }
+
+    std::vector<double> half_supports(widths.size());
+
+    for (size_t index = 0; index < widths.size(); ++index) {
+        half_supports[index] = widths[index] / 2.0;
+    }
+
+    if (is_non_decreasing(time)) {
+        for (const std::vector<Real>& signal : signals) {
+            if (signal.size() != time.size()) {
+                throw std::runtime_error("every signal must have the length of time.");
+            }
+        }
+
+        if (amplitudes.size() != centers.size() * signals.size()) {
+            throw std::runtime_error("amplitudes must hold n_events x n_channels values.");
+        }
+
+        std::vector<Real*> channel_pointers(signals.size());
+
+        for (size_t channel = 0; channel < signals.size(); ++channel) {
+            channel_pointers[channel] = signals[channel].data();
+        }
+
+        accumulate_rectangular_pulse_edges(
+            std::span<Real* const>(channel_pointers),
+            time,
+            centers,
+            half_supports,
+            amplitudes
+        );
+
+        return;
+    }
+
+    accumulate_multichannel_pulses(
+        signals,
+        time,
+        centers,
+        half_supports,
+        amplitudes,
+        [](size_t, double) {
+            return 1.0;
+        }
+    );
+}
+
+} // namespace pulse_synthesis
+} // namespace utils
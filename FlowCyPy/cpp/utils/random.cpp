@@ -0,0 +1,184 @@
+#include "random.h"
+#include "threading.h"
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+
+namespace {
+
+uint64_t splitmix64(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+constexpr size_t log_factorial_table_size = 256;
+
+const std::array<double, log_factorial_table_size>& get_log_factorial_table() {
+    static const std::array<double, log_factorial_table_size> table = [] {
+        std::array<double, log_factorial_table_size> values{};
+
+        // lgamma, as on the device, rather than a running sum of logs, whose rounding drifts from it.
+        for (size_t k = 0; k < log_factorial_table_size; ++k)
+            values[k] = std::lgamma(static_cast<double>(k) + 1.0);
+
+        return values;
+    }();
+
+    return table;
+}
+
+FLOWCYPY_DECLARE_TARGET_BEGIN
+
+// The device has no copy of the table and evaluates lgamma directly.
+inline double log_factorial(const double k) {
+#if !FLOWCYPY_DEVICE_COMPILATION
+    if (k < static_cast<double>(log_factorial_table_size))
+        return get_log_factorial_table()[static_cast<size_t>(k)];
+#endif
+
+    return std::lgamma(k + 1.0);
+}
+
+FLOWCYPY_DECLARE_TARGET_END
+
+uint64_t read_initial_seed() {
+    const char* value = std::getenv("FLOWCYPY_SEED");
+
+    if (value != nullptr)
+        return std::stoull(value);
+
+    std::random_device random_device;
+    return (static_cast<uint64_t>(random_device()) << 32) | random_device();
+}
+
+}  // namespace
+
+
+utils::CounterRandomGenerator::CounterRandomGenerator(const uint64_t seed, const uint64_t stream) {
+    // The key mixes seed and stream so that nearby seeds or streams give unrelated keys.
+    const uint64_t mixed = splitmix64(seed ^ splitmix64(stream));
+    this->key = {static_cast<uint32_t>(mixed), static_cast<uint32_t>(mixed >> 32)};
+}
+
+
+FLOWCYPY_DECLARE_TARGET_BEGIN
+
+double utils::CounterRandomGenerator::poisson(const double mean, const uint64_t index) const {
+    if (mean <= 0.0)
+        return 0.0;
+
+    if (mean < 10.0) {
+        const double u = this->uniform(index);
+        double probability = std::exp(-mean);
+        double cumulative = probability;
+        double count = 0.0;
+
+        // The probability vanishes before the cumulative sum can stall below u.
+        while (u > cumulative && probability > 0.0) {
+            count += 1.0;
+            probability *= mean / count;
+            cumulative += probability;
+        }
+
+        return count;
+    }
+
+    const double sqrt_mean = std::sqrt(mean);
+    const double log_mean = std::log(mean);
+    const double b = 0.931 + 2.53 * sqrt_mean;
+    const double a = -0.059 + 0.02483 * b;
+    const double log_inverse_alpha = std::log(1.1239 + 1.1328 / (b - 3.4));
+    const double v_r = 0.9277 - 3.6224 / (b - 2.0);
+
+    Engine engine = this->engine(index);
+
+    while (true) {
+        const uint32_t word_0 = engine(), word_1 = engine(), word_2 = engine(), word_3 = engine();
+
+        const double u = to_open_unit_interval(word_0, word_1) - 0.5;
+        const double v = to_open_unit_interval(word_2, word_3);
+        const double us = 0.5 - std::abs(u);
+        const double k = std::floor((2.0 * a / us + b) * u + mean + 0.43);
+
+        if (us >= 0.07 && v <= v_r)
+            return k;
+
+        if (k < 0.0 || (us < 0.013 && v > us))
+            continue;
+
+        if (std::log(v) + log_inverse_alpha - std::log(a / (us * us) + b) <= -mean + k * log_mean - log_factorial(k))
+            return k;
+    }
+}
+
+FLOWCYPY_DECLARE_TARGET_END
+
+
+void utils::CounterRandomGenerator::fill_normal(double* data, const size_t size, const double mean, const double standard_deviation, const uint64_t first_index) const {
+    #pragma omp parallel for simd schedule(static) num_threads(utils::get_team_size(size, utils::ParallelComponent::noise))
+    for (size_t i = 0; i < size; ++i)
+        data[i] = mean + standard_deviation * this->normal(first_index + i);
+}
+
+
+void utils::CounterRandomGenerator::add_normal(double* data, const size_t size, const double mean, const double standard_deviation, const uint64_t first_index) const {
+    #pragma omp parallel for simd schedule(static) num_threads(utils::get_team_size(size, utils::ParallelComponent::noise))
+    for (size_t i = 0; i < size; ++i)
+        data[i] += mean + standard_deviation * this->normal(first_index + i);
+}
+
+
+void utils::CounterRandomGenerator::add_normal(float* data, const size_t size, const double mean, const double standard_deviation, const uint64_t first_index) const {
+    #pragma omp parallel for simd schedule(static) num_threads(utils::get_team_size(size, utils::ParallelComponent::noise))
+    for (size_t i = 0; i < size; ++i)
+        data[i] = static_cast<float>(data[i] + mean + standard_deviation * this->normal(first_index + i));
+}
+
+
+void utils::CounterRandomGenerator::fill_uniform(double* data, const size_t size, const double lower, const double upper, const uint64_t first_index) const {
+    const double range = upper - lower;
+
+    #pragma omp parallel for simd schedule(static) num_threads(utils::get_team_size(size, utils::ParallelComponent::noise))
+    for (size_t i = 0; i < size; ++i)
+        data[i] = lower + range * this->uniform(first_index + i);
+}
+
+
+utils::RandomService& utils::RandomService::instance() {
+    static RandomService service;
+    return service;
+}
+
+
+utils::RandomService::RandomService()
+    : seed(read_initial_seed())
+{}
+
+
+void utils::RandomService::set_seed(const uint64_t seed) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->seed = seed;
+    this->call_counts.clear();
+}
+
+
+uint64_t utils::RandomService::get_seed() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->seed;
+}
+
+
+utils::CounterRandomGenerator utils::RandomService::next_generator(const RandomStreamId id) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    const uint64_t call_index = this->call_counts[id]++;
+    const uint64_t stream = (static_cast<uint64_t>(id) << 40) | call_index;
+
+    return CounterRandomGenerator(this->seed, stream);
+}
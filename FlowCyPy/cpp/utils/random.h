@@ -0,0 +1,265 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+
+#include "offload.h"
+
+
+namespace utils {
+
+/**
+ * @brief Identifier of the noise model drawing from a random stream.
+ *
+ * Every noise model draws from its own stream so that two models never share
+ * random numbers, whatever the order in which they are called.
+ */
+enum class RandomStreamId : uint32_t {
+    source_rin = 1,
+    source_common_rin,
+    source_shot_noise,
+    source_gamma_trace,
+    amplifier_noise,
+    detector_dark_current,
+    flow_cell_positions,
+    flow_cell_arrivals,
+    distribution_samples,
+    population_properties
+};
+
+
+// The generator is also compiled for the offload device: a device kernel drawing at
+// index i gets the same Philox bits as the host.
+FLOWCYPY_DECLARE_TARGET_BEGIN
+
+/**
+ * @brief Philox4x32-10 block function (Salmon et al., SC'11).
+ *
+ * Maps a 128 bit counter and a 64 bit key to 128 random bits. The function has no
+ * state, so the value drawn for a given counter does not depend on how the
+ * counters are distributed among threads.
+ */
+inline std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key) {
+    constexpr uint32_t multiplier_0 = 0xD2511F53u;
+    constexpr uint32_t multiplier_1 = 0xCD9E8D57u;
+    constexpr uint32_t weyl_0 = 0x9E3779B9u;
+    constexpr uint32_t weyl_1 = 0xBB67AE85u;
+
+    for (int round = 0; round < 10; ++round) {
+        const uint64_t product_0 = static_cast<uint64_t>(multiplier_0) * counter[0];
+        const uint64_t product_1 = static_cast<uint64_t>(multiplier_1) * counter[2];
+
+        counter = {
+            static_cast<uint32_t>(product_1 >> 32) ^ counter[1] ^ key[0],
+            static_cast<uint32_t>(product_1),
+            static_cast<uint32_t>(product_0 >> 32) ^ counter[3] ^ key[1],
+            static_cast<uint32_t>(product_0)
+        };
+
+        key[0] += weyl_0;
+        key[1] += weyl_1;
+    }
+
+    return counter;
+}
+
+
+/**
+ * @brief Counter based generator: the value of draw i depends only on (seed, stream, i).
+ *
+ * Sample i of a signal uses index i, so parallel loops give the same output for any
+ * number of threads and no generator has to be seeded or advanced per thread.
+ */
+class CounterRandomGenerator {
+public:
+    /**
+     * @brief Uniform random bit generator over the extra blocks of one index.
+     *
+     * Rejection samplers (Poisson, gamma, ...) need a variable number of uniforms
+     * per sample. This engine serves them from the blocks (index, 1), (index, 2), ...
+     * so they stay a pure function of the index. It satisfies the standard
+     * UniformRandomBitGenerator requirements.
+     */
+    class Engine {
+    public:
+        using result_type = uint32_t;
+
+        Engine(const std::array<uint32_t, 2>& key, const uint64_t index)
+            : key(key), index(index) {}
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<uint32_t>::max(); }
+
+        result_type operator()() {
+            if (this->position == 4) {
+                ++this->draw;
+                this->words = philox4x32(
+                    {static_cast<uint32_t>(this->index), static_cast<uint32_t>(this->index >> 32), this->draw, 0u},
+                    this->key
+                );
+                this->position = 0;
+            }
+
+            return this->words[this->position++];
+        }
+
+    private:
+        std::array<uint32_t, 2> key;
+        uint64_t index;
+        uint32_t draw = 0;
+        std::array<uint32_t, 4> words{};
+        int position = 4;
+    };
+
+    CounterRandomGenerator() : CounterRandomGenerator(0, 0) {}
+
+    /**
+     * @brief Build the generator of one stream.
+     *
+     * @param seed Global seed.
+     * @param stream Stream number; different streams give independent sequences.
+     */
+    CounterRandomGenerator(const uint64_t seed, const uint64_t stream);
+
+    /**
+     * @brief Return the 128 random bits of an index.
+     */
+    inline std::array<uint32_t, 4> block(const uint64_t index) const {
+        return philox4x32(
+            {static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32), 0u, 0u},
+            this->key
+        );
+    }
+
+    /**
+     * @brief Uniform double in the open interval (0, 1) for an index.
+     */
+    inline double uniform(const uint64_t index) const {
+        const std::array<uint32_t, 4> words = this->block(index);
+        return to_open_unit_interval(words[0], words[1]);
+    }
+
+    /**
+     * @brief Standard normal double for an index (Box-Muller on one block).
+     */
+    inline double normal(const uint64_t index) const {
+        const std::array<uint32_t, 4> words = this->block(index);
+        const double u1 = to_open_unit_interval(words[0], words[1]);
+        const double u2 = to_open_unit_interval(words[2], words[3]);
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+    }
+
+    /**
+     * @brief Engine serving the extra uniforms of an index to rejection samplers.
+     */
+    inline Engine engine(const uint64_t index) const {
+        return Engine(this->key, index);
+    }
+
+    /**
+     * @brief Poisson distributed count with the given mean for an index.
+     *
+     * Means below 10 are drawn by inversion of the cumulative distribution with
+     * uniform(index). Larger means use the transformed rejection sampler PTRS
+     * (Hormann, 1993) fed by engine(index), with a tabulated log factorial.
+     * Both cost O(1) on average, unlike the sequential samplers of std::poisson_distribution.
+     *
+     * @param mean Mean of the distribution, must be nonnegative.
+     * @param index Index of the draw.
+     * @return Drawn count, as a double.
+     */
+    double poisson(const double mean, const uint64_t index) const;
+
+    /**
+     * @brief Fill data[i] with mean + standard_deviation * normal(first_index + i), in parallel.
+     *
+     * @param data Output buffer.
+     * @param size Number of samples.
+     * @param mean Mean of the distribution.
+     * @param standard_deviation Standard deviation of the distribution.
+     * @param first_index Index of the first sample.
+     */
+    void fill_normal(double* data, const size_t size, const double mean = 0.0, const double standard_deviation = 1.0, const uint64_t first_index = 0) const;
+
+    /**
+     * @brief Add mean + standard_deviation * normal(first_index + i) to data[i], in parallel.
+     */
+    void add_normal(double* data, const size_t size, const double mean = 0.0, const double standard_deviation = 1.0, const uint64_t first_index = 0) const;
+
+    /**
+     * @brief Single precision counterpart of add_normal, the draws are rounded to float once added.
+     */
+    void add_normal(float* data, const size_t size, const double mean = 0.0, const double standard_deviation = 1.0, const uint64_t first_index = 0) const;
+
+    /**
+     * @brief Fill data[i] with a uniform double in (lower, upper) drawn at first_index + i, in parallel.
+     */
+    void fill_uniform(double* data, const size_t size, const double lower = 0.0, const double upper = 1.0, const uint64_t first_index = 0) const;
+
+private:
+    static inline double to_open_unit_interval(const uint32_t low, const uint32_t high) {
+        // 53 random bits, shifted by half a step so that neither 0 nor 1 can occur.
+        const uint64_t bits = ((static_cast<uint64_t>(high) << 32) | low) >> 11;
+        return (static_cast<double>(bits) + 0.5) * 0x1.0p-53;
+    }
+
+    std::array<uint32_t, 2> key;
+};
+
+FLOWCYPY_DECLARE_TARGET_END
+
+
+/**
+ * @brief Process wide source of random streams for the noise models.
+ *
+ * Each request for a generator returns a fresh stream made of the stream identifier
+ * and the number of generators already handed out for it, so a sequence of calls
+ * is reproducible for a given seed while successive calls still draw new noise.
+ *
+ * The seed is read from the FLOWCYPY_SEED environment variable when the service is
+ * first used; without it a nondeterministic seed is drawn from std::random_device.
+ * As for FFTPlanCache, each extension module holds its own instance, and the
+ * Python function FlowCyPy.set_random_seed seeds all of them at once.
+ */
+class RandomService {
+public:
+    /**
+     * @brief Return the service instance of this module.
+     */
+    static RandomService& instance();
+
+    RandomService(const RandomService&) = delete;
+    RandomService& operator=(const RandomService&) = delete;
+
+    /**
+     * @brief Set the global seed and restart every stream.
+     */
+    void set_seed(const uint64_t seed);
+
+    /**
+     * @brief Return the global seed.
+     */
+    uint64_t get_seed() const;
+
+    /**
+     * @brief Return the generator for the next call of a noise model.
+     *
+     * @param id Noise model drawing the numbers.
+     * @return Generator of a stream that was never handed out before for this seed.
+     */
+    CounterRandomGenerator next_generator(const RandomStreamId id);
+
+private:
+    RandomService();
+
+    mutable std::mutex mutex;
+    uint64_t seed;
+    std::map<RandomStreamId, uint64_t> call_counts;
+};
+
+}
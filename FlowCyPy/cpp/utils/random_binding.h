@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <pybind11/pybind11.h>
+
+#include <utils/random.h>
+
+/*
+    @brief Adds set_random_seed / get_random_seed to an extension module.
+    @param module The pybind11 module drawing noise through utils::RandomService.
+    @note Each extension module owns its RandomService; FlowCyPy.set_random_seed calls
+          the function of every module so the whole simulation uses one seed.
+*/
+inline void register_random_seed_functions(pybind11::module_& module) {
+    module.def(
+        "set_random_seed",
+        [](const uint64_t seed) {
+            utils::RandomService::instance().set_seed(seed);
+        },
+        pybind11::arg("seed"),
+        R"pbdoc(
+            Seed the noise generators of this module.
+
+            Noise values depend only on the seed, the noise model and the sample
+            index, so a seeded run gives the same result for any number of threads.
+
+            Parameters
+            ----------
+            seed : int
+                Non negative seed.
+        )pbdoc"
+    );
+
+    module.def(
+        "get_random_seed",
+        []() {
+            return utils::RandomService::instance().get_seed();
+        },
+        R"pbdoc(
+            Return the seed of the noise generators of this module.
+        )pbdoc"
+    );
+}
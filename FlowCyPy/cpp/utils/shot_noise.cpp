@@ -0,0 +1,82 @@
+#include "shot_noise.h"
+#include "threading.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+constexpr size_t simd_width = 8;
+
+template <typename Real>
+size_t find_first_negative_sample(const Real* data, const size_t size) {
+    Real minimum = 0;
+
+    #pragma omp parallel for simd reduction(min:minimum) num_threads(utils::get_team_size(size, utils::ParallelComponent::noise))
+    for (size_t i = 0; i < size; ++i)
+        minimum = std::min(minimum, data[i]);
+
+    if (minimum >= 0)
+        return size;
+
+    return static_cast<size_t>(std::find_if(data, data + size, [](const Real value) { return value < 0; }) - data);
+}
+
+}  // namespace
+
+
+size_t utils::find_first_negative(const double* data, const size_t size) {
+    return find_first_negative_sample(data, size);
+}
+
+
+size_t utils::find_first_negative(const float* data, const size_t size) {
+    return find_first_negative_sample(data, size);
+}
+
+
+void utils::apply_shot_noise_in_place(
+    double* data,
+    const size_t size,
+    const double watt_to_photon,
+    const CounterRandomGenerator& generator,
+    const uint64_t first_index
+) {
+    const double photon_to_watt = 1.0 / watt_to_photon;
+    const size_t number_of_blocks = (size + simd_width - 1) / simd_width;
+
+    #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(size, utils::ParallelComponent::noise))
+    for (size_t block = 0; block < number_of_blocks; ++block) {
+        const size_t begin = block * simd_width;
+        const size_t end = std::min(begin + simd_width, size);
+
+        bool all_gaussian = (end - begin) == simd_width;
+
+        for (size_t i = begin; i < end; ++i)
+            all_gaussian = all_gaussian && (data[i] * watt_to_photon >= shot_noise_poisson_threshold);
+
+        if (all_gaussian) {
+            #pragma omp simd
+            for (size_t i = begin; i < end; ++i) {
+                const double mean_photons = data[i] * watt_to_photon;
+                const double noisy_photons = mean_photons + generator.normal(first_index + i) * std::sqrt(mean_photons);
+                data[i] = std::max(0.0, noisy_photons) * photon_to_watt;
+            }
+
+            continue;
+        }
+
+        for (size_t i = begin; i < end; ++i) {
+            const double mean_photons = data[i] * watt_to_photon;
+            double noisy_photons = 0.0;
+
+            if (mean_photons < shot_noise_poisson_threshold)
+                noisy_photons = generator.poisson(mean_photons, first_index + i);
+            else
+                noisy_photons = std::max(0.0, mean_photons + generator.normal(first_index + i) * std::sqrt(mean_photons));
+
+            data[i] = noisy_photons * photon_to_watt;
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "random.h"
+
+
+namespace utils {
+
+/**
+ * @brief Mean photon count below which shot noise is drawn from a Poisson distribution.
+ *
+ * Above it the Gaussian approximation mean + sqrt(mean) * n is used.
+ */
+constexpr double shot_noise_poisson_threshold = 100.0;
+
+/**
+ * @brief Return the index of the first negative sample, or size if there is none.
+ *
+ * The scan is a vectorized minimum reduction; the position is only searched for
+ * once a negative value is known to exist.
+ *
+ * @param data Samples to check.
+ * @param size Number of samples.
+ */
+size_t find_first_negative(const double* data, const size_t size);
+
+/**
+ * @brief Single precision counterpart of find_first_negative.
+ */
+size_t find_first_negative(const float* data, const size_t size);
+
+/**
+ * @brief Apply photon shot noise to optical power samples, in place.
+ *
+ * Sample i is converted to the mean photon count data[i] * watt_to_photon, replaced
+ * by a noisy count and converted back to watt. Counts below
+ * shot_noise_poisson_threshold are drawn with CounterRandomGenerator::poisson,
+ * larger ones from the Gaussian approximation.
+ *
+ * Samples are processed in blocks of simd_width: a block made only of large counts
+ * goes through a vectorized Gaussian loop, other blocks are drawn sample by sample.
+ * Draw i uses index first_index + i of the generator, so the result does not depend
+ * on the number of threads.
+ *
+ * @param data Optical power samples in watt. They must be nonnegative, see find_first_negative.
+ * @param size Number of samples.
+ * @param watt_to_photon Photons per watt over one sample, see BaseSource::get_watt_to_photon_factor.
+ * @param generator Generator of the shot noise stream.
+ * @param first_index Generator index of the first sample.
+ */
+void apply_shot_noise_in_place(
+    double* data,
+    const size_t size,
+    const double watt_to_photon,
+    const CounterRandomGenerator& generator,
+    const uint64_t first_index = 0
+);
+
+}
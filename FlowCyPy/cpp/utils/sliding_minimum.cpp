@@ -0,0 +1,89 @@
+#include "sliding_minimum.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+utils::SlidingMinimum::SlidingMinimum(const long long window_size)
+    : window_size(window_size)
+{
+    if (window_size < -1)
+        throw std::runtime_error("window_size must be positive or equal to -1 for infinite window.");
+
+    if (window_size >= 0) {
+        this->values.resize(static_cast<size_t>(window_size) + 1);
+        this->indices.resize(static_cast<size_t>(window_size) + 1);
+    }
+}
+
+
+void utils::SlidingMinimum::subtract_in_place(double* data, const size_t size) {
+    if (size == 0)
+        return;
+
+    if (this->window_size == -1) {
+        size_t start = 0;
+
+        if (this->sample_index == 0) {
+            this->running_minimum = data[0];
+            start = 1;
+        }
+
+        double running_minimum = this->running_minimum;
+
+        for (size_t i = start; i < size; ++i) {
+            running_minimum = std::min(running_minimum, data[i]);
+            data[i] -= running_minimum;
+        }
+
+        this->running_minimum = running_minimum;
+        this->sample_index += size;
+        return;
+    }
+
+    const size_t capacity = this->values.size();
+    const size_t window = static_cast<size_t>(this->window_size);
+
+    for (size_t i = 0; i < size; ++i) {
+        const size_t t = this->sample_index + i;
+        const double x = data[i];
+
+        // Drop the front entries that left the window [t - W, t].
+        while (this->count > 0 && this->indices[this->head] + window < t) {
+            this->head = (this->head + 1 == capacity) ? 0 : this->head + 1;
+            --this->count;
+        }
+
+        // Drop the back entries that can no longer be the minimum.
+        while (this->count > 0) {
+            size_t back = this->head + this->count - 1;
+            if (back >= capacity)
+                back -= capacity;
+
+            if (this->values[back] < x)
+                break;
+
+            --this->count;
+        }
+
+        size_t slot = this->head + this->count;
+        if (slot >= capacity)
+            slot -= capacity;
+
+        this->values[slot] = x;
+        this->indices[slot] = t;
+        ++this->count;
+
+        data[i] = x - this->values[this->head];
+    }
+
+    this->sample_index += size;
+}
+
+
+void utils::SlidingMinimum::reset() {
+    this->head = 0;
+    this->count = 0;
+    this->sample_index = 0;
+    this->running_minimum = std::numeric_limits<double>::infinity();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+
+namespace utils {
+
+/**
+ * @brief Streaming sliding minimum subtraction with amortized O(1) cost per sample.
+ *
+ * For a finite window of W samples the output is
+ *
+ *     output[i] = signal[i] - min(signal[max(0, i - W) .. i])
+ *
+ * i.e. the window holds the current sample and the W previous ones. For an infinite
+ * window (W = -1) the minimum runs over every sample seen so far, and the very first
+ * sample is left unchanged, as in apply_baseline_restoration_to_signal.
+ *
+ * The ascending minima are kept in a monotonic deque stored in a ring buffer of
+ * W + 1 entries, so memory is bounded by the window and the state carries over
+ * between calls: a signal can be fed block by block with the same result as in a
+ * single pass.
+ */
+class SlidingMinimum {
+public:
+    SlidingMinimum() = default;
+
+    /**
+     * @brief Construct a sliding minimum over a window of window_size previous samples.
+     *
+     * @param window_size Number of previous samples in the window, or -1 for an infinite window.
+     *
+     * @throws std::runtime_error If window_size is smaller than -1.
+     */
+    explicit SlidingMinimum(const long long window_size);
+
+    /**
+     * @brief Subtract the sliding minimum from a block of samples, in place.
+     *
+     * @param data Pointer to the samples.
+     * @param size Number of samples.
+     */
+    void subtract_in_place(double* data, const size_t size);
+
+    /**
+     * @brief Forget every sample seen so far.
+     */
+    void reset();
+
+    /**
+     * @brief Window size given at construction, -1 for an infinite window.
+     */
+    long long get_window_size() const { return this->window_size; }
+
+private:
+    long long window_size = 0;
+
+    // Ring buffer holding the monotonic deque, front at head.
+    std::vector<double> values;
+    std::vector<size_t> indices;
+    size_t head = 0;
+    size_t count = 0;
+
+    size_t sample_index = 0;
+    double running_minimum = std::numeric_limits<double>::infinity();
+};
+
+}
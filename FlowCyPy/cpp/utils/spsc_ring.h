@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+namespace utils {
+
+/**
+ * @brief Lock free ring of preallocated slots between one producer and one consumer thread.
+ *
+ * Slots are filled and drained in place: the producer takes the next free slot
+ * with acquire(), fills it and hands it over with publish(); the consumer takes
+ * the oldest published slot with front() and gives it back with release(). Slots
+ * keep their buffers across laps, so a steady stream does not allocate.
+ *
+ * Indices are plain atomics; a side waiting for its counterpart sleeps on an
+ * atomic wait rather than spinning. Closing the ring wakes both sides: acquire
+ * then fails, and front drains the published slots before reporting the end of
+ * the stream.
+ */
+template <typename T>
+class SpscRing {
+public:
+    /**
+     * @param capacity Number of slots, at least one.
+     *
+     * @throws std::invalid_argument If capacity is zero.
+     */
+    explicit SpscRing(const size_t capacity)
+        : slots(capacity)
+    {
+        if (capacity == 0) {
+            throw std::invalid_argument("SpscRing capacity must be at least one.");
+        }
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Producer: next free slot, waiting for the consumer if the ring is full.
+     *
+     * @return The slot, or nullptr if the ring was closed.
+     */
+    T* acquire() {
+        const size_t write = this->write_index.load(std::memory_order_relaxed);
+
+        while (true) {
+            if (this->closed.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+
+            if (write - this->read_index.load(std::memory_order_acquire) < this->slots.size()) {
+                return &this->slots[write % this->slots.size()];
+            }
+
+            // The counter is read before the index is checked again, so a release in
+            // between changes it and the wait returns at once.
+            const uint32_t signal = this->producer_signal.load(std::memory_order_acquire);
+
+            if (write - this->read_index.load(std::memory_order_acquire) < this->slots.size() || this->closed.load(std::memory_order_acquire)) {
+                continue;
+            }
+
+            this->number_of_full_waits.fetch_add(1, std::memory_order_relaxed);
+            this->producer_signal.wait(signal, std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * @brief Producer: hand the slot returned by acquire() to the consumer.
+     */
+    void publish() {
+        this->write_index.fetch_add(1, std::memory_order_release);
+        this->consumer_signal.fetch_add(1, std::memory_order_release);
+        this->consumer_signal.notify_one();
+    }
+
+    /**
+     * @brief Consumer: oldest published slot, waiting for the producer if the ring is empty.
+     *
+     * @return The slot, or nullptr once the ring is closed and drained.
+     */
+    T* front() {
+        const size_t read = this->read_index.load(std::memory_order_relaxed);
+
+        while (true) {
+            if (this->write_index.load(std::memory_order_acquire) != read) {
+                return &this->slots[read % this->slots.size()];
+            }
+
+            if (this->closed.load(std::memory_order_acquire)) {
+                // A slot published just before closing is still delivered.
+                if (this->write_index.load(std::memory_order_acquire) != read) {
+                    continue;
+                }
+
+                return nullptr;
+            }
+
+            const uint32_t signal = this->consumer_signal.load(std::memory_order_acquire);
+
+            if (this->write_index.load(std::memory_order_acquire) != read || this->closed.load(std::memory_order_acquire)) {
+                continue;
+            }
+
+            this->consumer_signal.wait(signal, std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * @brief Consumer: give the slot returned by front() back to the producer.
+     */
+    void release() {
+        this->read_index.fetch_add(1, std::memory_order_release);
+        this->producer_signal.fetch_add(1, std::memory_order_release);
+        this->producer_signal.notify_one();
+    }
+
+    /**
+     * @brief End the stream and wake both sides.
+     */
+    void close() {
+        this->closed.store(true, std::memory_order_release);
+
+        this->producer_signal.fetch_add(1, std::memory_order_release);
+        this->producer_signal.notify_all();
+        this->consumer_signal.fetch_add(1, std::memory_order_release);
+        this->consumer_signal.notify_all();
+    }
+
+    /**
+     * @brief Number of published slots not yet released by the consumer.
+     */
+    size_t size() const {
+        return this->write_index.load(std::memory_order_acquire) - this->read_index.load(std::memory_order_acquire);
+    }
+
+    size_t get_capacity() const { return this->slots.size(); }
+
+    /**
+     * @brief Number of times the producer found the ring full and had to wait.
+     */
+    size_t get_number_of_full_waits() const { return this->number_of_full_waits.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t cache_line_size = 64;
+
+    std::vector<T> slots;
+
+    // Each side writes its own cache line.
+    alignas(cache_line_size) std::atomic<size_t> write_index{0};
+    std::atomic<uint32_t> consumer_signal{0};
+
+    alignas(cache_line_size) std::atomic<size_t> read_index{0};
+    std::atomic<uint32_t> producer_signal{0};
+
+    alignas(cache_line_size) std::atomic<bool> closed{false};
+    std::atomic<size_t> number_of_full_waits{0};
+};
+
+}
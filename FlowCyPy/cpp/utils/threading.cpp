@@ -0,0 +1,166 @@
+#include "threading.h"
+
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+
+namespace {
+
+// Below about 16k samples per thread, the fork and join of a region costs more
+// than the loop saves. Noise draws cost several times a plain arithmetic loop.
+constexpr size_t default_grain_size = 16384;
+constexpr size_t default_noise_grain_size = 4096;
+
+size_t get_default_grain_size(const utils::ParallelComponent component) {
+    return component == utils::ParallelComponent::noise ? default_noise_grain_size : default_grain_size;
+}
+
+}  // namespace
+
+
+utils::ThreadingSettings& utils::ThreadingSettings::instance() {
+    static ThreadingSettings settings;
+    return settings;
+}
+
+
+utils::ThreadingSettings::ThreadingSettings() {
+    this->reset();
+}
+
+
+void utils::ThreadingSettings::set_number_of_threads(const int number_of_threads) {
+    if (number_of_threads < 0) {
+        throw std::invalid_argument("number_of_threads must be non negative, 0 selecting the OpenMP default.");
+    }
+
+    this->number_of_threads.store(number_of_threads, std::memory_order_relaxed);
+}
+
+
+int utils::ThreadingSettings::get_number_of_threads() const {
+    const int number_of_threads = this->number_of_threads.load(std::memory_order_relaxed);
+    return number_of_threads > 0 ? number_of_threads : omp_get_max_threads();
+}
+
+
+void utils::ThreadingSettings::set_grain_size(const ParallelComponent component, const size_t grain_size) {
+    this->grain_sizes[static_cast<size_t>(component)].store(grain_size, std::memory_order_relaxed);
+}
+
+
+size_t utils::ThreadingSettings::get_grain_size(const ParallelComponent component) const {
+    return this->grain_sizes[static_cast<size_t>(component)].load(std::memory_order_relaxed);
+}
+
+
+void utils::ThreadingSettings::reset() {
+    this->number_of_threads.store(0, std::memory_order_relaxed);
+
+    for (size_t index = 0; index < number_of_parallel_components; ++index) {
+        const auto component = static_cast<ParallelComponent>(index);
+        this->grain_sizes[index].store(get_default_grain_size(component), std::memory_order_relaxed);
+    }
+}
+
+
+int utils::pin_threads(const ThreadPlacement placement) {
+#if defined(__linux__)
+    // The mask of the process before any pinning, which ThreadPlacement::none restores.
+    static const cpu_set_t process_mask = [] {
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+
+        if (sched_getaffinity(0, sizeof(mask), &mask) != 0) {
+            throw std::runtime_error("Could not read the CPU affinity of the process.");
+        }
+
+        return mask;
+    }();
+
+    std::vector<int> cpus;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &process_mask)) {
+            cpus.push_back(cpu);
+        }
+    }
+
+    if (cpus.empty()) {
+        return 0;
+    }
+
+    int number_of_placed_threads = 0;
+    bool failed = false;
+
+    #pragma omp parallel num_threads(ThreadingSettings::instance().get_number_of_threads()) reduction(||:failed)
+    {
+        const size_t thread = static_cast<size_t>(omp_get_thread_num());
+        const size_t team_size = static_cast<size_t>(omp_get_num_threads());
+
+        cpu_set_t mask = process_mask;
+
+        if (placement != ThreadPlacement::none) {
+            const size_t slot = placement == ThreadPlacement::spread
+                ? thread * cpus.size() / team_size
+                : thread % cpus.size();
+
+            CPU_ZERO(&mask);
+            CPU_SET(cpus[slot], &mask);
+        }
+
+        // Thread 0 is the calling Python thread, left on its own mask. A pid of 0 designates the calling thread.
+        if (thread != 0) {
+            failed = sched_setaffinity(0, sizeof(mask), &mask) != 0;
+        }
+
+        #pragma omp single
+        number_of_placed_threads = static_cast<int>(team_size) - 1;
+    }
+
+    if (failed) {
+        throw std::runtime_error("Could not set the CPU affinity of the OpenMP threads.");
+    }
+
+    return number_of_placed_threads;
+#else
+    (void) placement;
+    return 0;
+#endif
+}
+
+
+std::vector<std::vector<int>> utils::get_thread_cpus() {
+    std::vector<std::vector<int>> thread_cpus;
+
+#if defined(__linux__)
+    const int number_of_threads = ThreadingSettings::instance().get_number_of_threads();
+    thread_cpus.resize(static_cast<size_t>(number_of_threads));
+
+    #pragma omp parallel num_threads(number_of_threads)
+    {
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+
+        if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+            std::vector<int>& cpus = thread_cpus[static_cast<size_t>(omp_get_thread_num())];
+
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &mask)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+    }
+
+    // The runtime may grant fewer threads than requested.
+    while (!thread_cpus.empty() && thread_cpus.back().empty()) {
+        thread_cpus.pop_back();
+    }
+#endif
+
+    return thread_cpus;
+}
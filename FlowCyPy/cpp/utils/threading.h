@@ -0,0 +1,167 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <omp.h>
+
+
+namespace utils {
+
+/**
+ * @brief Kernel families sharing one grain size.
+ */
+enum class ParallelComponent {
+    source,
+    detector,
+    amplifier,
+    circuits,
+    digitizer,
+    opto_electronic_chain,
+    noise,
+    flow_cell,
+    discriminator,
+    peak_locator,
+    classifier,
+    memory,
+};
+
+constexpr size_t number_of_parallel_components = static_cast<size_t>(ParallelComponent::memory) + 1;
+
+/**
+ * @brief Where pin_threads places the OpenMP worker threads on the CPUs the process may use.
+ *
+ * - none: every worker may run on any of these CPUs again.
+ * - close: worker t runs on the t-th CPU, filling one socket before the next.
+ * - spread: workers are spread evenly over the CPUs, hence over the sockets.
+ */
+enum class ThreadPlacement {
+    none,
+    close,
+    spread,
+};
+
+/**
+ * @brief Thread count and grain sizes of the OpenMP kernels of this module.
+ *
+ * Parallel regions ask get_team_size for the number of threads of a loop of n
+ * work items: at most one thread per grain_size items, so inputs smaller than
+ * the grain size run serially without the fork/join of a parallel region, and
+ * never more than get_number_of_threads threads.
+ *
+ * Each extension module links its own copy of utils_lib and owns its settings;
+ * FlowCyPy.set_threads applies the same settings to every module. Settings are
+ * atomics so that they can be changed while a run holds no GIL.
+ */
+class ThreadingSettings {
+public:
+    static ThreadingSettings& instance();
+
+    ThreadingSettings(const ThreadingSettings&) = delete;
+    ThreadingSettings& operator=(const ThreadingSettings&) = delete;
+
+    /**
+     * @param number_of_threads Largest team of a parallel region, 0 for the OpenMP default.
+     *
+     * @throws std::invalid_argument If number_of_threads is negative.
+     */
+    void set_number_of_threads(const int number_of_threads);
+
+    /**
+     * @brief Largest team of a parallel region: the configured count, or omp_get_max_threads().
+     */
+    int get_number_of_threads() const;
+
+    /**
+     * @param grain_size Smallest number of work items per thread, 0 to always use every thread.
+     */
+    void set_grain_size(const ParallelComponent component, const size_t grain_size);
+
+    size_t get_grain_size(const ParallelComponent component) const;
+
+    /**
+     * @brief Restore the default thread count and grain sizes.
+     */
+    void reset();
+
+    /**
+     * @brief Number of threads of a parallel loop over number_of_work_items items.
+     */
+    int get_team_size(const size_t number_of_work_items, const ParallelComponent component) const {
+        const int number_of_threads = this->get_number_of_threads();
+        const size_t grain_size = this->get_grain_size(component);
+
+        if (grain_size == 0) {
+            return number_of_threads;
+        }
+
+        const size_t number_of_grains = number_of_work_items / grain_size;
+
+        if (number_of_grains <= 1) {
+            return 1;
+        }
+
+        return number_of_grains < static_cast<size_t>(number_of_threads)
+            ? static_cast<int>(number_of_grains)
+            : number_of_threads;
+    }
+
+private:
+    ThreadingSettings();
+
+    std::atomic<int> number_of_threads{0};
+    std::array<std::atomic<size_t>, number_of_parallel_components> grain_sizes;
+};
+
+
+/**
+ * @brief Shorthand for ThreadingSettings::instance().get_team_size, for num_threads clauses.
+ */
+inline int get_team_size(const size_t number_of_work_items, const ParallelComponent component) {
+    return ThreadingSettings::instance().get_team_size(number_of_work_items, component);
+}
+
+
+/**
+ * @brief Fill values in parallel, with the static schedule of the kernels writing them later.
+ *
+ * On multi socket machines a page is placed on the socket of the thread touching it
+ * first. Zeroing a buffer from one thread places it all on one socket, whereas this
+ * fill places every chunk next to the thread that a schedule(static) loop of the same
+ * team size hands it to.
+ */
+template <typename T>
+void first_touch_fill(std::span<T> values, const T value) {
+    const long long number_of_values = static_cast<long long>(values.size());
+
+    #pragma omp parallel for schedule(static) num_threads(get_team_size(values.size(), ParallelComponent::memory))
+    for (long long index = 0; index < number_of_values; ++index) {
+        values[index] = value;
+    }
+}
+
+
+/**
+ * @brief Bind the OpenMP worker threads to CPUs of the process affinity mask.
+ *
+ * OpenMP runtimes keep their threads between parallel regions, so the placement
+ * holds for the following regions of any module. The calling thread, which is
+ * thread 0 of every region it starts, keeps its mask: it is the Python thread,
+ * and the threads it creates later inherit its mask. Only available on Linux.
+ *
+ * @return Number of worker threads placed, 0 where thread affinity is not supported.
+ */
+int pin_threads(const ThreadPlacement placement);
+
+/**
+ * @brief CPUs each thread of a region of get_number_of_threads threads may run on.
+ *
+ * @return One sorted list of CPUs per thread, in thread order, empty where thread
+ *     affinity is not supported.
+ */
+std::vector<std::vector<int>> get_thread_cpus();
+
+}  // namespace utils
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <utils/threading.h>
+
+inline utils::ParallelComponent parse_parallel_component(const std::string& name) {
+    static const std::pair<const char*, utils::ParallelComponent> components[] = {
+        {"source", utils::ParallelComponent::source},
+        {"detector", utils::ParallelComponent::detector},
+        {"amplifier", utils::ParallelComponent::amplifier},
+        {"circuits", utils::ParallelComponent::circuits},
+        {"digitizer", utils::ParallelComponent::digitizer},
+        {"opto_electronic_chain", utils::ParallelComponent::opto_electronic_chain},
+        {"noise", utils::ParallelComponent::noise},
+        {"flow_cell", utils::ParallelComponent::flow_cell},
+        {"discriminator", utils::ParallelComponent::discriminator},
+        {"peak_locator", utils::ParallelComponent::peak_locator},
+        {"classifier", utils::ParallelComponent::classifier},
+        {"memory", utils::ParallelComponent::memory},
+    };
+
+    for (const auto& [component_name, component] : components) {
+        if (name == component_name) {
+            return component;
+        }
+    }
+
+    throw std::invalid_argument("Unknown parallel component '" + name + "'.");
+}
+
+inline utils::ThreadPlacement parse_thread_placement(const std::string& name) {
+    if (name == "none") return utils::ThreadPlacement::none;
+    if (name == "close") return utils::ThreadPlacement::close;
+    if (name == "spread") return utils::ThreadPlacement::spread;
+
+    throw std::invalid_argument("placement must be 'none', 'close' or 'spread', got '" + name + "'.");
+}
+
+/*
+    @brief Adds the thread count, grain size and thread placement functions to an extension module.
+    @param module The pybind11 module whose kernels size their teams with utils::get_team_size.
+    @note Each extension module owns its ThreadingSettings; FlowCyPy.set_threads calls the
+          functions of every module so all kernels follow one configuration.
+*/
+inline void register_threading_functions(pybind11::module_& module) {
+    module.def(
+        "set_number_of_threads",
+        [](const int number_of_threads) {
+            utils::ThreadingSettings::instance().set_number_of_threads(number_of_threads);
+        },
+        pybind11::arg("number_of_threads"),
+        R"pbdoc(
+            Set the largest number of threads of the parallel kernels of this module.
+
+            Parameters
+            ----------
+            number_of_threads : int
+                Number of threads, 0 for the OpenMP default.
+        )pbdoc"
+    );
+
+    module.def(
+        "get_number_of_threads",
+        []() {
+            return utils::ThreadingSettings::instance().get_number_of_threads();
+        },
+        R"pbdoc(
+            Return the largest number of threads of the parallel kernels of this module.
+        )pbdoc"
+    );
+
+    module.def(
+        "set_grain_size",
+        [](const std::string& component, const size_t grain_size) {
+            utils::ThreadingSettings::instance().set_grain_size(parse_parallel_component(component), grain_size);
+        },
+        pybind11::arg("component"),
+        pybind11::arg("grain_size"),
+        R"pbdoc(
+            Set the smallest number of work items per thread of a kernel family.
+
+            Loops with fewer items than the grain size run serially.
+
+            Parameters
+            ----------
+            component : str
+                One of 'source', 'detector', 'amplifier', 'circuits', 'digitizer',
+                'opto_electronic_chain', 'noise', 'flow_cell', 'discriminator',
+                'peak_locator', 'classifier' or 'memory'.
+            grain_size : int
+                Work items per thread, 0 to always use every thread.
+        )pbdoc"
+    );
+
+    module.def(
+        "get_grain_size",
+        [](const std::string& component) {
+            return utils::ThreadingSettings::instance().get_grain_size(parse_parallel_component(component));
+        },
+        pybind11::arg("component"),
+        R"pbdoc(
+            Return the smallest number of work items per thread of a kernel family.
+        )pbdoc"
+    );
+
+    module.def(
+        "get_team_size",
+        [](const size_t number_of_work_items, const std::string& component) {
+            return utils::get_team_size(number_of_work_items, parse_parallel_component(component));
+        },
+        pybind11::arg("number_of_work_items"),
+        pybind11::arg("component"),
+        R"pbdoc(
+            Return the number of threads a kernel family uses for a loop of this many items.
+
+            Parameters
+            ----------
+            number_of_work_items : int
+                Number of work items of the loop, e.g. samples.
+            component : str
+                Kernel family, as in :func:`set_grain_size`.
+
+            Returns
+            -------
+            int
+                1 for loops shorter than two grains, which run serially, otherwise
+                one thread per grain up to :func:`get_number_of_threads`. A grain
+                size of 0 always gives :func:`get_number_of_threads`.
+        )pbdoc"
+    );
+
+    module.def(
+        "reset_threading",
+        []() {
+            utils::ThreadingSettings::instance().reset();
+        },
+        R"pbdoc(
+            Restore the default thread count and grain sizes of this module.
+        )pbdoc"
+    );
+
+    module.def(
+        "pin_threads",
+        [](const std::string& placement) {
+            return utils::pin_threads(parse_thread_placement(placement));
+        },
+        pybind11::arg("placement"),
+        R"pbdoc(
+            Bind the OpenMP worker threads of the process to CPUs.
+
+            The threads are shared by every module, so one call places them for
+            all. The calling thread is left on its own CPUs, so the Python thread
+            and the threads it starts later are not pinned.
+
+            Parameters
+            ----------
+            placement : {'none', 'close', 'spread'}
+                'close' fills the CPUs in order, 'spread' distributes the threads
+                evenly over them, hence over the sockets, and 'none' lets every
+                thread run on any CPU again.
+
+            Returns
+            -------
+            int
+                Number of worker threads placed, 0 where affinity is not supported.
+        )pbdoc"
+    );
+
+    module.def(
+        "get_thread_cpus",
+        &utils::get_thread_cpus,
+        R"pbdoc(
+            Return the CPUs each OpenMP thread may run on.
+
+            Returns
+            -------
+            list[list[int]]
+                Sorted CPUs of every thread of a parallel region, the calling
+                thread first, empty where affinity is not supported.
+        )pbdoc"
+    );
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+
+namespace utils {
+
+/**
+ * @brief Uniformly sampled time axis t[i] = start + i * time_step, i < number_of_samples.
+ *
+ * The time values are computed on demand, so stages sharing a uniform axis pass
+ * three numbers around instead of one double per sample, and none of them has to
+ * check the spacing of a materialized array again.
+ */
+struct TimeAxis {
+    double start = 0.0;
+    double time_step = 0.0;
+    size_t number_of_samples = 0;
+
+    TimeAxis() = default;
+
+    /**
+     * @param start Time of the first sample.
+     * @param time_step Sampling interval, strictly positive.
+     * @param number_of_samples Number of samples.
+     *
+     * @throws std::runtime_error If time_step is not strictly positive and finite.
+     */
+    TimeAxis(const double start, const double time_step, const size_t number_of_samples)
+        : start(start), time_step(time_step), number_of_samples(number_of_samples)
+    {
+        if (!(time_step > 0.0) || !std::isfinite(time_step)) {
+            throw std::runtime_error("TimeAxis time_step must be strictly positive and finite.");
+        }
+    }
+
+    /**
+     * @brief Time axis of a digitizer sampling at sampling_rate, starting at zero.
+     *
+     * @throws std::runtime_error If sampling_rate is not strictly positive and finite.
+     */
+    static TimeAxis from_sampling_rate(const double sampling_rate, const size_t number_of_samples) {
+        if (!(sampling_rate > 0.0) || !std::isfinite(sampling_rate)) {
+            throw std::runtime_error("sampling_rate must be strictly positive and finite.");
+        }
+
+        return TimeAxis(0.0, 1.0 / sampling_rate, number_of_samples);
+    }
+
+    /**
+     * @brief Recover the affine axis of a materialized, uniformly sampled time array.
+     *
+     * The array must have at least two samples, be strictly increasing and have a
+     * uniform spacing within a relative tolerance of 1e-12.
+     *
+     * @throws std::runtime_error If one of these conditions does not hold.
+     */
+    static TimeAxis from_samples(std::span<const double> samples) {
+        if (samples.size() < 2) {
+            throw std::runtime_error("time_array must contain at least two samples.");
+        }
+
+        const double time_step = samples[1] - samples[0];
+
+        if (time_step <= 0.0) {
+            throw std::runtime_error("time_array must be strictly increasing.");
+        }
+
+        for (size_t index = 2; index < samples.size(); ++index) {
+            const double current_step = samples[index] - samples[index - 1];
+
+            if (current_step <= 0.0) {
+                throw std::runtime_error("time_array must be strictly increasing.");
+            }
+
+            if (std::abs(current_step - time_step) > 1e-12 * std::max(1.0, std::abs(time_step))) {
+                throw std::runtime_error("time_array must be uniformly sampled.");
+            }
+        }
+
+        return TimeAxis(samples[0], time_step, samples.size());
+    }
+
+    size_t size() const { return this->number_of_samples; }
+    bool empty() const { return this->number_of_samples == 0; }
+
+    double operator[](const size_t index) const {
+        return this->start + static_cast<double>(index) * this->time_step;
+    }
+
+    /**
+     * @brief Write the time values of samples [first_index, first_index + output.size()).
+     */
+    void fill(std::span<double> output, const size_t first_index = 0) const {
+        for (size_t index = 0; index < output.size(); ++index) {
+            output[index] = (*this)[first_index + index];
+        }
+    }
+
+    /**
+     * @brief Materialize the whole axis, for outputs that need an explicit array.
+     */
+    std::vector<double> to_vector() const {
+        std::vector<double> samples(this->number_of_samples);
+        this->fill(samples);
+        return samples;
+    }
+};
+
+}  // namespace utils
@@ -1,82 +1,157 @@
 #include "utils.h"
+#include "fft_plan_cache.h"
+#include "threading.h"
 
-void utils::apply_baseline_restoration_to_signal(std::vector<double> &signal, const int window_size)
-{
-    if (signal.empty()) {
-        throw std::runtime_error("Signal vector is empty.");
-    }
-    // Make a copy of the original signal so that modifications do not affect future computations.
-    std::vector<double> original = signal;
-
-    // Case: Infinite window (-1) => use all previous samples [0, i)
-    if (window_size == -1) {
-        double global_min = original[0];
-        // For i==0, no previous sample exists, so leave signal[0] unchanged.
-        for (size_t i = 1; i < signal.size(); ++i) {
-            global_min = std::min(global_min, original[i]);  // Now look until the last point included
-            // global_min = std::min(global_min, orig[i - 1]);  // Originally for look until the last point excluded
-            signal[i] = original[i] - global_min;
+#include <tuple>
+
+
+namespace {
+
+enum class LowPassKind { butterworth, bessel };
+
+// Magnitude response |H(f_k)| on the N / 2 + 1 bins of a real FFT of size N.
+std::vector<double> compute_lowpass_transfer_function(
+    const LowPassKind kind,
+    const size_t N,
+    const double sampling_rate,
+    const double cutoff_frequency,
+    const int order
+) {
+    const double df = sampling_rate / static_cast<double>(N);
+
+    std::vector<double> transfer_function(N / 2 + 1);
+
+    for (size_t k = 0; k <= N / 2; ++k) {
+        const double f = k * df;
+
+        if (kind == LowPassKind::butterworth) {
+            const double H_single = 1.0 / std::sqrt(1.0 + std::pow(f / cutoff_frequency, 2));
+            transfer_function[k] = std::pow(H_single, order);
+            continue;
         }
-        return;
-    }
 
-    // For a finite window: for each index i, consider the window [max(0, i-window_size), i)
-    signal[0] = 0;  // No previous samples, so leave the first sample unchanged.
-    for (size_t i = 1; i < signal.size(); ++i)
-    {
-        size_t start = (i < static_cast<size_t>(window_size)) ? 0 : i - window_size;
-        double local_min = *std::min_element(original.begin() + start, original.begin() + i + 1);  // Now look until the last point included
-        // double local_min = *std::min_element(orig.begin() + start, orig.begin() + i);  // Originally for look until the last point excluded
-        signal[i] = original[i] - local_min;
+        // Define s = j * (f / cutoff_frequency)
+        const std::complex<double> s(0, f / cutoff_frequency);
+        std::complex<double> H_complex;
+
+        switch (order) {
+            case 1:
+                // Order 1: H(s) = 1 / (s + 1)
+                H_complex = 1.0 / (s + 1.0);
+                break;
+            case 2:
+                // Order 2: H(s) = 3 / (s^2 + 3s + 3)
+                H_complex = 3.0 / (s * s + 3.0 * s + 3.0);
+                break;
+            case 3:
+                // Order 3: H(s) = 15 / (s^3 + 6s^2 + 15s + 15)
+                H_complex = 15.0 / (s * s * s + 6.0 * s * s + 15.0 * s + 15.0);
+                break;
+            case 4:
+                // Order 4: H(s) = 105 / (s^4 + 10s^3 + 45s^2 + 105s + 105)
+                H_complex = 105.0 / (s * s * s * s + 10.0 * s * s * s + 45.0 * s * s + 105.0 * s + 105.0);
+                break;
+            default:
+                throw std::runtime_error("Bessel filter of the given order is not implemented.");
+        }
+
+        // Use the magnitude of the complex transfer function for amplitude attenuation.
+        transfer_function[k] = std::abs(H_complex);
     }
+
+    return transfer_function;
 }
 
+// Per thread cache of transfer functions: batch sweeps call the same filter with the same
+// (N, sampling rate, cutoff, order) thousands of times.
+const std::vector<double>& get_cached_transfer_function(
+    const LowPassKind kind,
+    const size_t N,
+    const double sampling_rate,
+    const double cutoff_frequency,
+    const int order
+) {
+    using Key = std::tuple<LowPassKind, size_t, double, double, int>;
+    constexpr size_t maximum_cached_transfer_functions = 32;
+
+    static thread_local std::map<Key, std::vector<double>> cache;
 
-void utils::apply_butterworth_lowpass_filter_to_signal(std::vector<double> &signal, const double sampling_rate, const double cutoff_frequency, const int order, const double gain) {
-    if (signal.empty()) {
-        throw std::runtime_error("Signal vector is empty.");
-    }
+    const Key key(kind, N, sampling_rate, cutoff_frequency, order);
+    const auto found = cache.find(key);
+
+    if (found != cache.end())
+        return found->second;
 
-    double dt = 1. / sampling_rate;
+    if (cache.size() >= maximum_cached_transfer_functions)
+        cache.clear();
 
+    return cache.emplace(
+        key,
+        compute_lowpass_transfer_function(kind, N, sampling_rate, cutoff_frequency, order)
+    ).first->second;
+}
+
+// Filter a signal in place as IFFT(H * FFT(signal)) * gain using cached plans and the
+// calling thread's aligned work buffers.
+void apply_real_transfer_function(
+    std::vector<double> &signal,
+    const std::vector<double> &transfer_function,
+    const double gain
+) {
     const size_t N = signal.size();
-    // double* data = static_cast<double*>(buf.ptr);
 
-    // Allocate temporary FFT buffers
-    double* in = (double*) fftw_malloc(sizeof(double) * N);
-    fftw_complex* out = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (N/2 + 1));
+    utils::FFTPlanCache &plan_cache = utils::FFTPlanCache::instance();
+    const utils::FFTPlan forward = plan_cache.get_plan(N, utils::FFTDirection::forward);
+    const utils::FFTPlan backward = plan_cache.get_plan(N, utils::FFTDirection::backward);
 
-    // Copy data to FFT input buffer
-    std::copy(signal.begin(), signal.end(), in);
+    utils::FFTWorkspace &workspace = utils::get_thread_fft_workspace(N);
 
-    // Create forward FFT plan
-    fftw_plan forward = fftw_plan_dft_r2c_1d(static_cast<int>(N), in, out, FFTW_ESTIMATE);
-    fftw_execute(forward);
+    std::copy(signal.begin(), signal.end(), workspace.real);
 
-    const double df = 1.0 / (N * dt);
+    fftw_execute_dft_r2c(forward.get(), workspace.real, workspace.spectrum);
 
     for (size_t k = 0; k <= N / 2; ++k) {
-        double f = k * df;
-        double H_single = 1.0 / std::sqrt(1.0 + std::pow(f / cutoff_frequency, 2));
-        double H = std::pow(H_single, order);
-        out[k][0] *= H;
-        out[k][1] *= H;
+        workspace.spectrum[k][0] *= transfer_function[k];
+        workspace.spectrum[k][1] *= transfer_function[k];
     }
 
-    // Create backward FFT plan (inverse FFT)
-    fftw_plan backward = fftw_plan_dft_c2r_1d(static_cast<int>(N), out, in, FFTW_ESTIMATE);
-    fftw_execute(backward);
+    fftw_execute_dft_c2r(backward.get(), workspace.spectrum, workspace.real);
+
+    const double scale = gain / static_cast<double>(N);
 
-    // Normalize and write back into original buffer
     for (size_t i = 0; i < N; ++i) {
-        signal[i] = gain * in[i] / static_cast<double>(N);
+        signal[i] = scale * workspace.real[i];
+    }
+}
+
+}  // namespace
+
+
+void utils::apply_baseline_restoration_to_signal(std::vector<double> &signal, const int window_size)
+{
+    if (signal.empty()) {
+        throw std::runtime_error("Signal vector is empty.");
+    }
+
+    SlidingMinimum sliding_minimum(window_size);
+    sliding_minimum.subtract_in_place(signal.data(), signal.size());
+}
+
+
+void utils::apply_butterworth_lowpass_filter_to_signal(std::vector<double> &signal, const double sampling_rate, const double cutoff_frequency, const int order, const double gain) {
+    if (signal.empty()) {
+        throw std::runtime_error("Signal vector is empty.");
     }
 
-    // Clean up
-    fftw_destroy_plan(forward);
-    fftw_destroy_plan(backward);
-    fftw_free(in);
-    fftw_free(out);
+    const std::vector<double> &transfer_function = get_cached_transfer_function(
+        LowPassKind::butterworth,
+        signal.size(),
+        sampling_rate,
+        cutoff_frequency,
+        order
+    );
+
+    apply_real_transfer_function(signal, transfer_function, gain);
 }
 
 
@@ -88,34 +163,22 @@ std::vector<double> utils::generate_pulses_signal(
     const std::vector<double> &centers,
     const std::vector<double> &coupling_power,
     const std::vector<double> &time,
-    const double background_power
+    const double background_power,
+    const double support_cutoff
 ) {
 
     if (widths.size() != centers.size() || widths.size() != coupling_power.size())
         throw std::runtime_error("widths, centers, coupling_power must have the same length.");
 
-    size_t
-        time_size = time.size(),
-        n_pulses = widths.size();
-
+    if (signal.size() != time.size())
+        throw std::runtime_error("signal and time must have the same length.");
 
     if (background_power != 0.0)
-        for (size_t i = 0; i < time_size; ++i)
+        for (size_t i = 0; i < signal.size(); ++i)
             signal[i] += background_power;
 
-    // #pragma omp parallel for  // Parallelize the outer loop over particles.
-    for (size_t i = 0; i < n_pulses; ++i) {
-        double inv_denom = 1.0 / (2.0 * widths[i] * widths[i]);
-
-        for (size_t t_idx = 0; t_idx < time_size; ++t_idx) {
-
-            double dt = time[t_idx] - centers[i];
-            double gauss_val = coupling_power[i] * std::exp(- (dt * dt) * inv_denom);
-
-            // #pragma omp atomic  // Use atomic update to avoid race conditions
-            signal[t_idx] += gauss_val;
-        }
-    }
+    // Tiled pulse-local accumulation: threads own disjoint output tiles, so no atomic is needed.
+    pulse_synthesis::accumulate_gaussian_pulses(signal, time, centers, widths, coupling_power, support_cutoff);
 
     return signal;
 }
@@ -140,91 +203,208 @@ void utils::apply_bessel_lowpass_filter_to_signal(std::vector<double> &signal, c
         throw std::runtime_error("Signal vector is empty.");
     }
 
-    double dt = 1. / sampling_rate;
+    if (order < 1 || order > 4) {
+        throw std::runtime_error("Bessel filter of the given order is not implemented.");
+    }
 
-    const size_t N = signal.size();
+    const std::vector<double> &transfer_function = get_cached_transfer_function(
+        LowPassKind::bessel,
+        signal.size(),
+        sampling_rate,
+        cutoff_frequency,
+        order
+    );
 
-    // Allocate temporary FFT buffers
-    double* in = (double*) fftw_malloc(sizeof(double) * N);
-    fftw_complex* out = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (N / 2 + 1));
+    apply_real_transfer_function(signal, transfer_function, gain);
+}
 
-    // Copy data to FFT input buffer
-    std::copy(signal.begin(), signal.end(), in);
 
-    // Create forward FFT plan
-    fftw_plan forward = fftw_plan_dft_r2c_1d(static_cast<int>(N), in, out, FFTW_ESTIMATE);
-    fftw_execute(forward);
 
-    const double df = 1.0 / (N * dt);
+void utils::add_poisson_noise_to_signal(std::vector<double> &signal) {
+    if (signal.empty()) {
+        throw std::runtime_error("Signal vector is empty.");
+    }
 
-    for (size_t k = 0; k <= N / 2; ++k) {
-        double f = k * df;
-        // Define s = j * (f / cutoff_frequency)
-        std::complex<double> s(0, f / cutoff_frequency);
-        std::complex<double> H_complex;
+    std::default_random_engine rng(std::random_device{}());
 
-        // Compute the Bessel filter transfer function based on the specified order.
-        switch(order) {
-            case 1:
-                // Order 1: H(s) = 1 / (s + 1)
-                H_complex = 1.0 / (s + 1.0);
-                break;
-            case 2:
-                // Order 2: H(s) = 3 / (s^2 + 3s + 3)
-                H_complex = 3.0 / (s * s + 3.0 * s + 3.0);
-                break;
-            case 3:
-                // Order 3: H(s) = 15 / (s^3 + 6s^2 + 15s + 15)
-                H_complex = 15.0 / (s * s * s + 6.0 * s * s + 15.0 * s + 15.0);
-                break;
-            case 4:
-                // Order 4: H(s) = 105 / (s^4 + 10s^3 + 45s^2 + 105s + 105)
-                H_complex = 105.0 / (s * s * s * s + 10.0 * s * s * s + 45.0 * s * s + 105.0 * s + 105.0);
-                break;
-            default:
-                fftw_destroy_plan(forward);
-                fftw_free(in);
-                fftw_free(out);
-                throw std::runtime_error("Bessel filter of the given order is not implemented.");
+    for (size_t i = 0; i < signal.size(); ++i) {
+        if (signal[i] < 0.0) {
+            throw std::runtime_error("Poisson noise requires non-negative values");
         }
 
-        // Use the magnitude of the complex transfer function for amplitude attenuation.
-        double H = std::abs(H_complex);
-        out[k][0] *= H;
-        out[k][1] *= H;
+        std::poisson_distribution<int> dist(signal[i]);
+        signal[i] = static_cast<double>(dist(rng));
     }
+}
 
-    // Create backward FFT plan (inverse FFT)
-    fftw_plan backward = fftw_plan_dft_c2r_1d(static_cast<int>(N), out, in, FFTW_ESTIMATE);
-    fftw_execute(backward);
 
-    // Normalize and write the filtered data back into the original buffer
-    for (size_t i = 0; i < N; ++i) {
-        signal[i] = gain * in[i] / static_cast<double>(N);
+
+namespace {
+
+// Mirror an index about the first and last samples without repeating them. The mirror is
+// periodic with period 2N - 2, so kernels wider than the signal are handled as well.
+inline size_t reflect_index(long long index, const long long N) {
+    if (N == 1)
+        return 0;
+
+    const long long period = 2 * N - 2;
+
+    index %= period;
+    if (index < 0)
+        index += period;
+
+    return static_cast<size_t>(index < N ? index : period - index);
+}
+
+void validate_convolution_inputs(std::span<const double> signal, std::span<const double> kernel) {
+    if (signal.empty())
+        throw std::runtime_error("signal must not be empty.");
+
+    if (kernel.empty())
+        throw std::runtime_error("kernel must not be empty.");
+}
+
+}  // namespace
+
+
+std::vector<double> utils::convolve_with_reflected_boundaries(
+    std::span<const double> signal,
+    std::span<const double> kernel,
+    const size_t fft_threshold
+) {
+    validate_convolution_inputs(signal, kernel);
+
+    if (kernel.size() >= fft_threshold && signal.size() >= kernel.size())
+        return convolve_with_reflected_boundaries_fft(signal, kernel);
+
+    return convolve_with_reflected_boundaries_direct(signal, kernel);
+}
+
+
+std::vector<double> utils::convolve_with_reflected_boundaries_direct(
+    std::span<const double> signal,
+    std::span<const double> kernel
+) {
+    validate_convolution_inputs(signal, kernel);
+
+    const long long N = static_cast<long long>(signal.size());
+    const long long K = static_cast<long long>(kernel.size());
+    const long long half = K / 2;
+
+    // Samples [interior_begin, interior_end) only read signal[i - half .. i - half + K - 1],
+    // which stays inside the signal, so they need no mirrored index.
+    const long long interior_begin = std::min(half, N);
+    const long long interior_end = std::max(interior_begin, N - (K - 1 - half));
+
+    std::vector<double> out(signal.size(), 0.0);
+
+    const double *signal_data = signal.data();
+    const double *kernel_data = kernel.data();
+
+    #pragma omp parallel for schedule(static) num_threads(utils::get_team_size(static_cast<size_t>(interior_end - interior_begin) * static_cast<size_t>(K), utils::ParallelComponent::circuits))
+    for (long long i = interior_begin; i < interior_end; ++i) {
+        const double *window = signal_data + (i - half);
+        double acc = 0.0;
+
+        #pragma omp simd reduction(+:acc)
+        for (long long k = 0; k < K; ++k)
+            acc += window[k] * kernel_data[k];
+
+        out[i] = acc;
     }
 
-    // Clean up FFTW resources
-    fftw_destroy_plan(forward);
-    fftw_destroy_plan(backward);
-    fftw_free(in);
-    fftw_free(out);
+    auto mirrored_sample = [&](long long i) {
+        double acc = 0.0;
+
+        for (long long k = 0; k < K; ++k)
+            acc += signal_data[reflect_index(i + k - half, N)] * kernel_data[k];
+
+        out[i] = acc;
+    };
+
+    for (long long i = 0; i < interior_begin; ++i)
+        mirrored_sample(i);
+
+    for (long long i = interior_end; i < N; ++i)
+        mirrored_sample(i);
+
+    return out;
 }
 
 
+std::vector<double> utils::convolve_with_reflected_boundaries_fft(
+    std::span<const double> signal,
+    std::span<const double> kernel
+) {
+    validate_convolution_inputs(signal, kernel);
 
-void utils::add_poisson_noise_to_signal(std::vector<double> &signal) {
-    if (signal.empty()) {
-        throw std::runtime_error("Signal vector is empty.");
+    const long long N = static_cast<long long>(signal.size());
+    const long long K = static_cast<long long>(kernel.size());
+    const long long half = K / 2;
+
+    // Overlap-save: each FFT block of size M yields M - K + 1 valid output samples.
+    size_t M = 1;
+    while (M < 4 * static_cast<size_t>(K))
+        M <<= 1;
+
+    const long long block_length = static_cast<long long>(M) - K + 1;
+    const long long number_of_blocks = (N + block_length - 1) / block_length;
+    const size_t spectrum_size = M / 2 + 1;
+
+    FFTPlanCache &plan_cache = FFTPlanCache::instance();
+    const FFTPlan forward = plan_cache.get_plan(M, FFTDirection::forward);
+    const FFTPlan backward = plan_cache.get_plan(M, FFTDirection::backward);
+
+    // The output is a correlation, i.e. a convolution with the reversed kernel.
+    std::vector<std::complex<double>> kernel_spectrum(spectrum_size);
+    {
+        FFTWorkspace &workspace = get_thread_fft_workspace(M);
+
+        std::fill(workspace.real, workspace.real + M, 0.0);
+        for (long long k = 0; k < K; ++k)
+            workspace.real[k] = kernel[K - 1 - k];
+
+        fftw_execute_dft_r2c(forward.get(), workspace.real, workspace.spectrum);
+
+        for (size_t f = 0; f < spectrum_size; ++f)
+            kernel_spectrum[f] = std::complex<double>(workspace.spectrum[f][0], workspace.spectrum[f][1]) / static_cast<double>(M);
     }
 
-    std::default_random_engine rng(std::random_device{}());
+    std::vector<double> out(signal.size(), 0.0);
 
-    for (size_t i = 0; i < signal.size(); ++i) {
-        if (signal[i] < 0.0) {
-            throw std::runtime_error("Poisson noise requires non-negative values");
+    #pragma omp parallel num_threads(utils::get_team_size(signal.size(), utils::ParallelComponent::circuits))
+    {
+        // New-array execution of cached plans is thread safe on fftw_malloc'ed buffers.
+        FFTWorkspace &workspace = get_thread_fft_workspace(M);
+        double *block = workspace.real;
+        fftw_complex *spectrum = workspace.spectrum;
+
+        #pragma omp for schedule(static)
+        for (long long b = 0; b < number_of_blocks; ++b) {
+            const long long output_start = b * block_length;
+            const long long input_start = output_start - half;
+
+            for (long long j = 0; j < static_cast<long long>(M); ++j) {
+                const long long index = input_start + j;
+                block[j] = (index >= 0 && index < N) ? signal[index] : signal[reflect_index(index, N)];
+            }
+
+            fftw_execute_dft_r2c(forward.get(), block, spectrum);
+
+            for (size_t f = 0; f < spectrum_size; ++f) {
+                const std::complex<double> product =
+                    std::complex<double>(spectrum[f][0], spectrum[f][1]) * kernel_spectrum[f];
+                spectrum[f][0] = product.real();
+                spectrum[f][1] = product.imag();
+            }
+
+            fftw_execute_dft_c2r(backward.get(), spectrum, block);
+
+            const long long output_end = std::min(output_start + block_length, N);
+            for (long long i = output_start; i < output_end; ++i)
+                out[i] = block[K - 1 + (i - output_start)];
         }
-
-        std::poisson_distribution<int> dist(signal[i]);
-        signal[i] = static_cast<double>(dist(rng));
     }
+
+    return out;
 }
@@ -2,12 +2,17 @@
 
 #include <stdexcept>
 #include <vector>
+#include <span>
 #include <random>
 #include <fftw3.h>
 #include <cmath>
 #include <complex>
 #include <algorithm>
 #include <map>
+#include <omp.h>
+
+#include <utils/pulse_synthesis.h>
+#include <utils/sliding_minimum.h>
 
 
 namespace utils {
@@ -15,19 +20,21 @@ namespace utils {
 /**
  * @brief Performs baseline restoration on a signal using a rolling window minimum.
  *
- * For each index \( i \) (with \( i \ge 1 \)) in the input signal, this function computes
- * the minimum value among the previous `window_size` samples (i.e. indices from
- * \(\max(0, i - \text{window_size})\) to \( i-1 \)) based on the original unmodified signal.
- * It then subtracts that minimum value from the current sample.
+ * For each index \( i \) the function subtracts the minimum of the original samples with
+ * indices from \(\max(0, i - \text{window_size})\) to \( i \) included, so the first
+ * sample becomes zero.
  *
  * If `window_size == -1`, then for each \( i > 0 \) the function uses the minimum value
- * from indices \([0, i)\).
+ * from indices \([0, i]\) and leaves the first sample unchanged.
+ *
+ * The signal is processed in place in amortized O(N) time with a monotonic deque bounded
+ * by the window size (see SlidingMinimum).
  *
- * @param signal The input signal vector. The function does not update the original signal in-place
- *               during computation; instead, it computes a new baseline-restored signal and writes
- *               it back into the same vector.
+ * @param signal The input signal vector, overwritten with the baseline-restored signal.
  * @param window_size The number of previous samples to consider for the minimum. If set to -1,
- *                    the window is treated as infinite (using all samples from index 0 to \(i-1\)).
+ *                    the window is treated as infinite.
+ *
+ * @throws std::runtime_error If the signal is empty or window_size is smaller than -1.
  */
 void apply_baseline_restoration_to_signal(std::vector<double> &signal, const int window_size);
 
@@ -112,13 +119,20 @@ void apply_bessel_lowpass_filter_to_signal(std::vector<double> &signal, const do
  *   where \f$t\f$ is the current time from the time buffer.
  * - The computed Gaussian value is then added to the output signal at the corresponding time point.
  *
+ * Each pulse is only evaluated within support_cutoff widths of its center. The events are
+ * binned into time tiles and the tiles are processed in parallel, so each thread writes
+ * to a disjoint slice of the signal (see utils::pulse_synthesis::accumulate_pulses).
+ *
  * @param widths A 1D py::buffer containing the pulse widths (standard deviations) for each pulse.
  * @param centers A 1D py::buffer containing the center times for each pulse.
  * @param coupling_power A 1D py::buffer containing the amplitude (coupling power) for each pulse.
  * @param time A 1D py::buffer containing the time values at which the signal is evaluated.
  * @param background_power The constant background power to be added to the signal.
+ * @param support_cutoff Half support of each pulse in units of its width. An infinite value
+ *                       evaluates every pulse on the full time axis.
  *
- * @throws std::runtime_error If the sizes of the widths, centers, and coupling_power buffers are not equal.
+ * @throws std::runtime_error If the sizes of the widths, centers, and coupling_power buffers are not equal,
+ *         if signal and time differ in length, or if support_cutoff is not strictly positive.
  */
 std::vector<double> generate_pulses_signal(
     std::vector<double> &signal,
@@ -126,7 +140,8 @@ std::vector<double> generate_pulses_signal(
     const std::vector<double> &centers,
     const std::vector<double> &coupling_power,
     const std::vector<double> &time,
-    const double background_power
+    const double background_power,
+    const double support_cutoff = pulse_synthesis::default_gaussian_support_cutoff
 );
 
 /**
@@ -164,4 +179,57 @@ void add_gaussian_noise_to_signal(std::vector<double> &signal, const double mean
  */
 void add_poisson_noise_to_signal(std::vector<double> &signal);
 
+
+/**
+ * @brief Kernel length above which convolve_with_reflected_boundaries switches to FFT.
+ *
+ * Below this size the direct O(N K) loop is faster than the FFT overhead.
+ */
+constexpr size_t fft_convolution_kernel_threshold = 64;
+
+/**
+ * @brief Correlates a signal with a centered kernel using reflected boundaries.
+ *
+ * The output is defined for every sample \( i \) as
+ * \f[
+ *     \text{out}[i] = \sum_{k=0}^{K-1} \text{signal}[r(i + k - K/2)] \, \text{kernel}[k],
+ * \f]
+ * where \( r \) mirrors out of range indices about the first and last samples without repeating
+ * them (index -1 maps to 1, index N maps to N-2). A symmetric kernel therefore gives the usual
+ * convolution.
+ *
+ * Kernels shorter than @c fft_threshold are applied with a direct loop whose interior is free of
+ * boundary checks; only the first and last K/2 samples go through the mirrored index path. Longer
+ * kernels use FFTW overlap-save blocks processed in parallel, which reduces the cost from
+ * O(N K) to O(N log K).
+ *
+ * @param signal Input signal.
+ * @param kernel Centered kernel.
+ * @param fft_threshold Kernel length from which the FFT path is used.
+ * @return The filtered signal, same size as the input.
+ *
+ * @throws std::runtime_error If the signal or the kernel is empty.
+ */
+std::vector<double> convolve_with_reflected_boundaries(
+    std::span<const double> signal,
+    std::span<const double> kernel,
+    const size_t fft_threshold = fft_convolution_kernel_threshold
+);
+
+/**
+ * @brief Direct evaluation path of convolve_with_reflected_boundaries.
+ */
+std::vector<double> convolve_with_reflected_boundaries_direct(
+    std::span<const double> signal,
+    std::span<const double> kernel
+);
+
+/**
+ * @brief FFTW overlap-save evaluation path of convolve_with_reflected_boundaries.
+ */
+std::vector<double> convolve_with_reflected_boundaries_fft(
+    std::span<const double> signal,
+    std::span<const double> kernel
+);
+
 }
@@ -0,0 +1,276 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+MPI helpers behind :meth:`FlowCyPy.workflow.Workflow.sweep` with a communicator.
+
+``mpi4py`` is an optional dependency, only imported when a communicator with
+more than one rank is used. Every rank runs the same script, e.g.::
+
+    mpiexec -n 64 python sweep.py
+
+and calls ``workflow.sweep(..., comm=get_world_communicator())``. The root rank
+schedules the tasks and assembles the results, the other ranks run the tasks.
+"""
+import os
+import tempfile
+from typing import Any, Callable, Optional
+
+from FlowCyPy.profiling import get_profiling_report, merge_profiling_reports
+
+_TASK_TAG = 1
+_RESULT_TAG = 2
+_STOP_TAG = 3
+
+
+def get_world_communicator():
+    """
+    Communicator of every process of the MPI job.
+
+    Returns
+    -------
+    mpi4py.MPI.Comm
+        ``MPI.COMM_WORLD``.
+
+    Raises
+    ------
+    ImportError
+        If mpi4py is not installed.
+    """
+    try:
+        from mpi4py import MPI
+    except ImportError as error:
+        raise ImportError("Distributed sweeps require mpi4py, e.g. pip install mpi4py.") from error
+
+    return MPI.COMM_WORLD
+
+
+def run_dynamic(
+    comm,
+    number_of_tasks: int,
+    run_task: Callable[[int], Any],
+    on_result: Callable[[int, Any], None],
+    root: int = 0,
+) -> None:
+    """
+    Run tasks ``0 .. number_of_tasks - 1`` over the ranks of ``comm``.
+
+    The root rank hands one task at a time to every other rank and sends the
+    next one to whichever rank returns a result first, so ranks that draw
+    cheap tasks simply run more of them. ``on_result(task_index, result)`` is
+    called on the root rank as results arrive, while the workers keep running.
+    With a single rank, every task runs in order on that rank.
+
+    Parameters
+    ----------
+    comm : mpi4py.MPI.Comm
+        Communicator of the ranks taking part.
+    number_of_tasks : int
+        Number of tasks.
+    run_task : callable
+        Runs one task from its index and returns a picklable result.
+    on_result : callable
+        Receives the results on the root rank.
+    root : int, optional
+        Rank scheduling the tasks.
+
+    Raises
+    ------
+    RuntimeError
+        On the root rank, if a task raised on a worker. No further task is
+        handed out, and the running ones are waited for.
+    """
+    if comm.Get_size() == 1:
+        for task_index in range(number_of_tasks):
+            on_result(task_index, run_task(task_index))
+        return
+
+    from mpi4py import MPI
+
+    status = MPI.Status()
+
+    if comm.Get_rank() != root:
+        while True:
+            task_index = comm.recv(source=root, tag=MPI.ANY_TAG, status=status)
+
+            if status.Get_tag() == _STOP_TAG:
+                return
+
+            try:
+                message = (task_index, run_task(task_index), None)
+            except Exception as error:
+                message = (task_index, None, f"{type(error).__name__}: {error}")
+
+            comm.send(message, dest=root, tag=_RESULT_TAG)
+
+    next_task = 0
+    number_of_running_tasks = 0
+    failure = None
+
+    def dispatch(worker: int) -> None:
+        nonlocal next_task, number_of_running_tasks
+
+        if failure is None and next_task < number_of_tasks:
+            comm.send(next_task, dest=worker, tag=_TASK_TAG)
+            next_task += 1
+            number_of_running_tasks += 1
+        else:
+            comm.send(None, dest=worker, tag=_STOP_TAG)
+
+    for worker in range(comm.Get_size()):
+        if worker != root:
+            dispatch(worker)
+
+    while number_of_running_tasks > 0:
+        task_index, result, error = comm.recv(source=MPI.ANY_SOURCE, tag=_RESULT_TAG, status=status)
+        number_of_running_tasks -= 1
+
+        if error is not None and failure is None:
+            failure = f"Task {task_index} failed on rank {status.Get_source()}: {error}"
+
+        dispatch(status.Get_source())
+
+        if error is None and failure is None:
+            on_result(task_index, result)
+
+    if failure is not None:
+        raise RuntimeError(failure)
+
+
+def broadcast_coupling_cache(comm, coupling_cache, root: int = 0):
+    """
+    Send the coupling cache of the root rank to every rank, once.
+
+    The cache travels in the binary format of ``CouplingCache.save``. Ranks
+    then fill their own copy, the couplings they add are not sent back.
+
+    Parameters
+    ----------
+    comm : mpi4py.MPI.Comm
+        Communicator of the ranks taking part.
+    coupling_cache : CouplingCache or None
+        Cache of the root rank, ignored on the other ranks.
+    root : int, optional
+        Rank holding the cache.
+
+    Returns
+    -------
+    CouplingCache or None
+        The cache on the root rank, a loaded copy on the others, None if the
+        root rank has no cache.
+    """
+    if comm.Get_size() == 1:
+        return coupling_cache
+
+    payload = None
+
+    if comm.Get_rank() == root and coupling_cache is not None:
+        with tempfile.TemporaryDirectory() as directory:
+            filename = os.path.join(directory, "coupling_cache.bin")
+            coupling_cache.save(filename)
+
+            with open(filename, "rb") as file:
+                payload = file.read()
+
+    payload = comm.bcast(payload, root=root)
+
+    if comm.Get_rank() == root or payload is None:
+        return coupling_cache
+
+    from FlowCyPy.opto_electronics.coupling_cache import CouplingCache
+
+    with tempfile.TemporaryDirectory() as directory:
+        filename = os.path.join(directory, "coupling_cache.bin")
+
+        with open(filename, "wb") as file:
+            file.write(payload)
+
+        return CouplingCache.load(filename)
+
+
+def broadcast_fftw_wisdom(comm, root: int = 0) -> Optional[str]:
+    """
+    Send the FFTW wisdom file of the root rank to every rank, once.
+
+    The root rank reads the file named by ``FLOWCYPY_FFTW_WISDOM``. The other
+    ranks import it through a temporary file, removed right after, and drop
+    ``FLOWCYPY_FFTW_WISDOM``, so they neither read a shared file system at
+    start up nor export into the same file at exit. The variable is read when
+    FFT plans are first used, so this must be called before any FFT circuit
+    runs on the rank.
+
+    Parameters
+    ----------
+    comm : mpi4py.MPI.Comm
+        Communicator of the ranks taking part.
+    root : int, optional
+        Rank reading the wisdom file.
+
+    Returns
+    -------
+    str or None
+        Wisdom file of the root rank on the root rank, None on the other ranks
+        and if the root rank has none.
+    """
+    if comm.Get_size() == 1:
+        return os.environ.get("FLOWCYPY_FFTW_WISDOM")
+
+    payload = None
+
+    if comm.Get_rank() == root:
+        filename = os.environ.get("FLOWCYPY_FFTW_WISDOM")
+
+        if filename is not None and os.path.isfile(filename):
+            with open(filename, "rb") as file:
+                payload = file.read()
+
+    payload = comm.bcast(payload, root=root)
+
+    if comm.Get_rank() == root:
+        return os.environ.get("FLOWCYPY_FFTW_WISDOM")
+
+    os.environ.pop("FLOWCYPY_FFTW_WISDOM", None)
+
+    if payload is None:
+        return None
+
+    from FlowCyPy.opto_electronics import circuits
+
+    descriptor, filename = tempfile.mkstemp(prefix=f"flowcypy_rank{comm.Get_rank()}_", suffix=".wisdom")
+
+    try:
+        with os.fdopen(descriptor, "wb") as file:
+            file.write(payload)
+
+        circuits.import_fftw_wisdom(filename)
+
+    finally:
+        os.unlink(filename)
+
+    return None
+
+
+def gather_profiling_report(comm, root: int = 0) -> Optional[dict]:
+    """
+    Merge the profiling reports of every rank on the root rank.
+
+    Scopes are merged as in :func:`FlowCyPy.profiling.merge_profiling_reports`,
+    so times are summed over ranks.
+
+    Parameters
+    ----------
+    comm : mpi4py.MPI.Comm
+        Communicator of the ranks taking part.
+    root : int, optional
+        Rank receiving the report.
+
+    Returns
+    -------
+    dict or None
+        Merged report on the root rank, None on the others.
+    """
+    reports = comm.gather(get_profiling_report(), root=root)
+
+    if comm.Get_rank() != root:
+        return None
+
+    return merge_profiling_reports(reports)
@@ -1,6 +1,6 @@
 #!/usr/bin/env python
 # -*- coding: utf-8 -*-
-from typing import Optional
+from typing import Any, Callable, Optional
 import numpy as np
 from TypedUnit import Power, Time, ureg, validate_units
 
@@ -9,6 +9,7 @@ from FlowCyPy.fluidics import populations
 from FlowCyPy.fluidics.event_collection import EventCollection
 from FlowCyPy.opto_electronics import OptoElectronics
 from FlowCyPy.run_record import RunRecord
+from FlowCyPy.stage_cache import StageCache, stage_key
 from FlowCyPy.digital_processing import DigitalProcessing
 from FlowCyPy.sub_frames.acquisition import AcquisitionDataFrame
 from FlowCyPy.sub_frames.peaks import PeakDataFrame
@@ -33,16 +34,29 @@ class FlowCytometer:
         Fluidic subsystem, including flow cell and population definitions.
     background_power : pint.Quantity, optional
         Constant optical background added to every detector channel.
+    precision : str, optional
+        Sample type of the analog blocks of streaming runs, ``"float64"`` or
+        ``"float32"``. Single precision halves the memory traffic of pulse
+        synthesis, opto electronic noise and analog circuits; computations and
+        filter states stay in double precision. Batch runs, whose analog traces
+        are returned, always use ``"float64"``.
     """
 
+    _precisions = ("float64", "float32")
+
     @validate_units
     def __init__(
         self,
         fluidics: Fluidics,
         background_power: Optional[Power] = 0 * ureg.milliwatt,
+        precision: str = "float64",
     ):
+        if precision not in self._precisions:
+            raise ValueError(f"precision must be one of {self._precisions}, got {precision!r}.")
+
         self.fluidics = fluidics
         self.background_power = background_power
+        self.precision = precision
 
     def _add_explicit_model_signals(
         self,
@@ -82,60 +96,35 @@ class FlowCytometer:
                     + (time_array_seconds[1] - time_array_seconds[0])
                 )
 
-            event_times = events.get_quantity("Time").to("second")
-            event_velocities = events.get_quantity("Velocity").to("meter / second")
-            pulse_widths = opto_electronics.source.get_particle_width(
-                event_velocities
-            ).to("second")
+            detectors = opto_electronics.detectors
 
-            event_time_values = event_times.magnitude
-            velocity_values = event_velocities.magnitude
-            pulse_width_values = pulse_widths.magnitude
-            support_margin_seconds = 4.0 * pulse_width_values
-
-            prepend_mask = event_time_values >= (
-                acquisition_window_seconds - support_margin_seconds
-            )
-            append_mask = event_time_values < support_margin_seconds
+            if len(detectors) == 0:
+                continue
 
-            wrapped_time_values = np.concatenate(
+            amplitude_matrix = np.column_stack(
                 [
-                    event_time_values[prepend_mask] - acquisition_window_seconds,
-                    event_time_values,
-                    event_time_values[append_mask] + acquisition_window_seconds,
+                    events.get_quantity(detector.name).to("watt").magnitude
+                    for detector in detectors
                 ]
             )
-            wrapped_velocity_values = np.concatenate(
-                [
-                    velocity_values[prepend_mask],
-                    velocity_values,
-                    velocity_values[append_mask],
-                ]
-            )
-
-            wrapped_times = wrapped_time_values * ureg.second
-            wrapped_velocities = wrapped_velocity_values * ureg.meter / ureg.second
 
-            for detector in opto_electronics.detectors:
-                event_amplitudes = events.get_quantity(detector.name).to("watt")
-                amplitude_values = event_amplitudes.magnitude
-                wrapped_amplitude_values = np.concatenate(
-                    [
-                        amplitude_values[prepend_mask],
-                        amplitude_values,
-                        amplitude_values[append_mask],
-                    ]
-                )
+            periodic_window = (
+                acquisition_window_seconds * ureg.second
+                if acquisition_window_seconds > 0
+                else None
+            )
 
-                generated_pulse_signal = opto_electronics.source.generate_pulses(
-                    velocities=wrapped_velocities,
-                    pulse_centers=wrapped_times,
-                    pulse_amplitudes=wrapped_amplitude_values * ureg.watt,
-                    time_array=signal_dict["Time"],
-                    base_level=0 * ureg.watt,
-                )
+            pulse_signals = opto_electronics.source.generate_multi_detector_pulses(
+                velocities=events.get_quantity("Velocity"),
+                pulse_centers=events.get_quantity("Time"),
+                pulse_amplitudes=amplitude_matrix * ureg.watt,
+                time_array=signal_dict["Time"],
+                base_level=0 * ureg.watt,
+                periodic_window=periodic_window,
+            )
 
-                signal_dict[detector.name] += generated_pulse_signal
+            for detector, pulse_signal in zip(detectors, pulse_signals):
+                signal_dict[detector.name] += pulse_signal
 
     def _add_gamma_model_signals(
         self,
@@ -271,6 +260,74 @@ class FlowCytometer:
             Run record containing the analog acquisition and all downstream
             results that could be computed.
         """
+        return self._process_stages(
+            run_time=run_time,
+            event_collection=event_collection,
+            analog_dict=analog_dict,
+            digital_processing=digital_processing,
+            opto_electronics=opto_electronics,
+        )
+
+    @staticmethod
+    def _run_stage(
+        cache: Optional[StageCache],
+        stage: str,
+        upstream_key: str,
+        configuration: tuple,
+        function: Callable[[], Any],
+        exclude: tuple = (),
+    ) -> tuple:
+        """
+        Run one stage, through the cache when there is one.
+
+        Returns
+        -------
+        tuple
+            Key of the stage, empty without a cache, and its output.
+        """
+        if cache is None:
+            return "", function()
+
+        key = stage_key(upstream_key, *configuration, exclude=exclude)
+
+        return key, cache.compute(stage, key, function)
+
+    @staticmethod
+    def _get_threshold_configuration(discriminator) -> list:
+        """
+        Thresholds of a discriminator as configured.
+
+        Each run writes the resolved value of a symbolic threshold back into
+        it, so a symbolic threshold is described by its expression alone.
+        """
+        thresholds = []
+
+        for name in ("threshold", "lower_threshold"):
+            threshold = getattr(discriminator, name, None)
+
+            if getattr(threshold, "has_symbolic", False):
+                threshold = threshold.symbolic
+            elif hasattr(threshold, "numeric"):
+                threshold = threshold.numeric
+
+            thresholds.append((name, threshold))
+
+        return thresholds
+
+    def _process_stages(
+        self,
+        run_time: Time,
+        event_collection: EventCollection,
+        analog_dict: dict,
+        digital_processing: DigitalProcessing,
+        opto_electronics: OptoElectronics,
+        cache: Optional[StageCache] = None,
+        acquisition_key: str = "",
+    ) -> RunRecord:
+        """
+        Run the downstream stages: analog processing, triggering, digitization
+        and peak location, each keyed on the stages before it when a cache is given.
+        """
         run_record = RunRecord(
             run_time=run_time,
             event_collection=event_collection,
@@ -278,41 +335,82 @@ class FlowCytometer:
             digital_processing=digital_processing,
         )
 
-        processed_analog_dict = opto_electronics.apply_analog_processing(
-            analog_dict=analog_dict,
-        )
+        def process_analog_signals() -> tuple:
+            processed_analog_dict = opto_electronics.apply_analog_processing(
+                analog_dict=analog_dict,
+            )
 
-        run_record.signal.analog = AcquisitionDataFrame._construct_from_signal_dict(
-            signal_dict=processed_analog_dict,
-        )
+            return processed_analog_dict, AcquisitionDataFrame._construct_from_signal_dict(
+                signal_dict=processed_analog_dict,
+            )
 
-        triggered_analog_dict = (
-            digital_processing.discriminator.run_with_dict(processed_analog_dict)
-            if digital_processing.discriminator is not None
-            else None
+        analog_key, (processed_analog_dict, run_record.signal.analog) = self._run_stage(
+            cache=cache,
+            stage="analog_processing",
+            upstream_key=acquisition_key,
+            configuration=(opto_electronics.analog_processing, opto_electronics.digitizer.sampling_rate),
+            function=process_analog_signals,
         )
 
-        if triggered_analog_dict is None:
+        discriminator = digital_processing.discriminator
+
+        if discriminator is None:
             return run_record
 
+        trigger_key, triggered_analog_dict = self._run_stage(
+            cache=cache,
+            stage="trigger",
+            upstream_key=analog_key,
+            configuration=(discriminator, self._get_threshold_configuration(discriminator)),
+            function=lambda: discriminator.run_with_dict(processed_analog_dict),
+            exclude=("threshold", "lower_threshold"),
+        )
+
         if len(triggered_analog_dict["segment_id"]) == 0:
             print(
                 "No triggers detected. Returning analog signal without digital processing."
             )
             return run_record
 
-        triggered_digital_dict = opto_electronics.digitizer.digitize_data_dict(
-            triggered_analog_dict
-        )
+        digitizer = opto_electronics.digitizer
 
-        run_record.signal.digital = TriggerDataFrame._construct_from_flat_dict(
-            triggered_digital_dict,
-        )
+        def digitize_windows() -> tuple:
+            triggered_digital_dict = digitizer.digitize_data_dict(triggered_analog_dict)
 
-        if digital_processing.peak_algorithm is not None:
-            peaks_dict = digital_processing.peak_algorithm.run(triggered_digital_dict)
+            return triggered_digital_dict, TriggerDataFrame._construct_from_flat_dict(
+                triggered_digital_dict,
+            )
 
-            run_record.peaks = PeakDataFrame._construct_from_dict(peaks_dict)
+        # With an automatic range the voltage span is written back by each run, it is not configuration.
+        digitize_key, (triggered_digital_dict, run_record.signal.digital) = self._run_stage(
+            cache=cache,
+            stage="digitize",
+            upstream_key=trigger_key,
+            configuration=(
+                digitizer,
+                [
+                    digitizer.get_channel_voltage_range(detector.name)
+                    if digitizer.has_channel_voltage_range(detector.name)
+                    else None
+                    for detector in opto_electronics.detectors
+                ],
+            ),
+            function=digitize_windows,
+            exclude=("min_voltage", "max_voltage") if digitizer.use_auto_range else (),
+        )
+
+        peak_algorithm = digital_processing.peak_algorithm
+
+        if peak_algorithm is not None:
+            _, run_record.peaks = self._run_stage(
+                cache=cache,
+                stage="peaks",
+                upstream_key=digitize_key,
+                configuration=(peak_algorithm,),
+                function=lambda: PeakDataFrame._construct_from_dict(
+                    peak_algorithm.run(triggered_digital_dict)
+                ),
+            )
 
         return run_record
 
@@ -419,15 +517,233 @@ class FlowCytometer:
 
         return run_record
 
+    def run_streaming(
+        self,
+        run_time: Time,
+        opto_electronics: OptoElectronics,
+        digital_processing: DigitalProcessing,
+        block_size: int = 1 << 16,
+        keep_segments: bool = True,
+        spill_filename: Optional[str] = None,
+    ) -> RunRecord:
+        """
+        Run the full simulation block by block, without materializing the analog traces.
+
+        Pulse synthesis, opto electronic noise, analog circuits, triggering,
+        digitization and peak location run in an
+        :class:`FlowCyPy.acquisition_pipeline.AcquisitionPipeline`, so memory is
+        set by ``block_size`` and by the number of triggered windows rather than
+        by ``run_time``. The returned record holds no analog signal.
+
+        FFT low-pass circuits and the amplifier filter run as their causal IIR
+        cascade, and auto voltage ranges and symbolic thresholds are resolved on
+        the first ``AcquisitionPipeline.warm_up_samples`` samples rather than on
+        the whole trace, so results differ from :meth:`run` wherever these
+        stages are used. They do not depend on ``block_size``.
+
+        Parameters
+        ----------
+        run_time : Time
+            Acquisition duration.
+        opto_electronics : OptoElectronics
+            Opto electronic configuration.
+        digital_processing : DigitalProcessing
+            Signal processing configuration. A discriminator is required.
+        block_size : int, optional
+            Number of samples per block.
+        keep_segments : bool, optional
+            Whether the digitized windows are stored in ``signal.digital``.
+        spill_filename : str or os.PathLike or None, optional
+            Acquisition file receiving the ADC codes of the whole run, to be
+            reprocessed later with :func:`FlowCyPy.acquisition_pipeline.replay`.
+            Requires a digitizer with a non zero bit depth.
+
+        Returns
+        -------
+        RunRecord
+            Run record with the event collection, the digitized windows and the peaks.
+
+        Raises
+        ------
+        ValueError
+            If no discriminator is configured, or if a population uses the gamma model.
+        """
+        event_collection, events = self._generate_pipeline_events(
+            run_time=run_time,
+            opto_electronics=opto_electronics,
+        )
+
+        pipeline = self._build_pipeline(
+            opto_electronics=opto_electronics,
+            digital_processing=digital_processing,
+            block_size=block_size,
+            keep_segments=keep_segments,
+        )
+        pipeline.spill_filename = spill_filename
+
+        return self._build_streaming_run_record(
+            run_time=run_time,
+            event_collection=event_collection,
+            opto_electronics=opto_electronics,
+            digital_processing=digital_processing,
+            output=pipeline.run(run_time=run_time, **events),
+        )
+
+    def _generate_pipeline_events(
+        self,
+        run_time: Time,
+        opto_electronics: OptoElectronics,
+    ) -> tuple:
+        """
+        Generate the events of a run and their per detector amplitudes.
+
+        Parameters
+        ----------
+        run_time : Time
+            Acquisition duration.
+        opto_electronics : OptoElectronics
+            Opto electronic configuration.
+
+        Returns
+        -------
+        tuple
+            The event collection, and the ``velocities``, ``centers`` and
+            ``amplitudes`` keyword arguments of ``AcquisitionPipeline.run``.
+
+        Raises
+        ------
+        ValueError
+            If a population uses the gamma model.
+        """
+        event_collection = self.fluidics.generate_event_collection(
+            run_time=run_time,
+            sampling_rate=opto_electronics.digitizer.sampling_rate,
+        )
+
+        opto_electronics.add_coupling_to_dataframe(
+            event_collection=event_collection,
+            compute_cross_section=False,
+        )
+
+        number_of_detectors = len(opto_electronics.detectors)
+
+        velocities, centers = [np.empty(0)], [np.empty(0)]
+        amplitudes = [np.empty((0, number_of_detectors))]
+
+        for events in event_collection:
+            if events.empty:
+                continue
+
+            if not isinstance(events.sampling_method, populations.ExplicitModel):
+                raise ValueError(
+                    "Streaming runs only support ExplicitModel populations, the gamma "
+                    "model trace is synthesized over the whole run."
+                )
+
+            velocities.append(events.get_quantity("Velocity").to("meter / second").magnitude)
+            centers.append(events.get_quantity("Time").to("second").magnitude)
+            amplitudes.append(
+                np.column_stack(
+                    [
+                        events.get_quantity(detector.name).to("watt").magnitude
+                        for detector in opto_electronics.detectors
+                    ]
+                )
+            )
+
+        pipeline_events = dict(
+            velocities=np.concatenate(velocities) * ureg.meter / ureg.second,
+            centers=np.concatenate(centers) * ureg.second,
+            amplitudes=np.concatenate(amplitudes) * ureg.watt,
+        )
+
+        return event_collection, pipeline_events
+
+    def _build_pipeline(
+        self,
+        opto_electronics: OptoElectronics,
+        digital_processing: DigitalProcessing,
+        block_size: int,
+        keep_segments: bool,
+    ):
+        """
+        Build the ``AcquisitionPipeline`` of a configuration.
+
+        Raises
+        ------
+        ValueError
+            If no discriminator is configured.
+        """
+        from FlowCyPy.acquisition_pipeline import AcquisitionPipeline
+
+        if digital_processing.discriminator is None:
+            raise ValueError("Streaming runs require a discriminator.")
+
+        pipeline = AcquisitionPipeline(
+            source=opto_electronics.source,
+            detectors=opto_electronics.detectors,
+            amplifier=opto_electronics.amplifier,
+            digitizer=opto_electronics.digitizer,
+            discriminator=digital_processing.discriminator,
+            circuits=list(opto_electronics.analog_processing),
+            peak_locator=digital_processing.peak_algorithm,
+            background_power=self.background_power,
+        )
+        pipeline.block_size = block_size
+        pipeline.keep_segments = keep_segments
+        pipeline.precision = self.precision
+
+        return pipeline
+
+    @staticmethod
+    def _build_streaming_run_record(
+        run_time: Time,
+        event_collection: EventCollection,
+        opto_electronics: OptoElectronics,
+        digital_processing: DigitalProcessing,
+        output: dict,
+    ) -> RunRecord:
+        """
+        Wrap the output of ``AcquisitionPipeline.run`` into a run record.
+        """
+        run_record = RunRecord(
+            run_time=run_time,
+            event_collection=event_collection,
+            opto_electronics=opto_electronics,
+            digital_processing=digital_processing,
+        )
+
+        if len(output["start_index"]) == 0:
+            return run_record
+
+        if output["segments"] is not None:
+            run_record.signal.digital = TriggerDataFrame._construct_from_flat_dict(
+                output["segments"],
+            )
+
+        if output["peaks"] is not None:
+            run_record.peaks = PeakDataFrame._construct_from_dict(output["peaks"])
+
+        return run_record
+
     def run(
         self,
         run_time: Time,
         opto_electronics: OptoElectronics,
         digital_processing: Optional[DigitalProcessing] = None,
+        cache: Optional[StageCache] = None,
     ) -> RunRecord:
         """
         Run the full simulation pipeline from event generation to peak extraction.
 
+        With a cache, the run is split into the acquisition, analog processing,
+        trigger, digitize and peaks stages, each keyed by its configuration and
+        by the stages before it. A rerun only executes the stages from the
+        first one whose configuration changed: retuning a discriminator
+        threshold, for instance, reuses the synthesized signals and only
+        triggers, digitizes and locates peaks again. A cached acquisition keeps
+        its noise realization, so reruns differ only by what was changed.
+
         Parameters
         ----------
         run_time : Time
@@ -436,6 +752,8 @@ class FlowCytometer:
             Opto electronic configuration.
         digital_processing : DigitalProcessing, optional
             Signal processing configuration. If None, no digital processing is applied.
+        cache : StageCache, optional
+            Cache of the stage outputs of previous runs. If None, every stage is executed.
 
         Returns
         -------
@@ -445,12 +763,44 @@ class FlowCytometer:
         if digital_processing is None:
             digital_processing = DigitalProcessing()
 
-        acquired_run_record = self.acquire(
-            run_time=run_time,
-            opto_electronics=opto_electronics,
+        if cache is None:
+            acquired_run_record = self.acquire(
+                run_time=run_time,
+                opto_electronics=opto_electronics,
+            )
+
+            return self.process_run(
+                run_record=acquired_run_record,
+                digital_processing=digital_processing,
+            )
+
+        digitizer = opto_electronics.digitizer
+
+        acquisition_key = stage_key(
+            "",
+            run_time,
+            self.fluidics,
+            self.background_power,
+            opto_electronics.source,
+            opto_electronics.detectors,
+            opto_electronics.amplifier,
+            opto_electronics.coupling_cache,
+            digitizer.sampling_rate,
+            digitizer.bandwidth,
+        )
+
+        acquired_run_record = cache.compute(
+            "acquisition",
+            acquisition_key,
+            lambda: self.acquire(run_time=run_time, opto_electronics=opto_electronics),
         )
 
-        return self.process_run(
-            run_record=acquired_run_record,
+        return self._process_stages(
+            run_time=run_time,
+            event_collection=acquired_run_record.event_collection,
+            analog_dict=acquired_run_record.signal.analog.raw_data,
             digital_processing=digital_processing,
+            opto_electronics=opto_electronics,
+            cache=cache,
+            acquisition_key=acquisition_key,
         )
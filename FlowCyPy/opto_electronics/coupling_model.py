@@ -6,6 +6,7 @@ import PyMieSim.experiment as _PyMieSim
 
 from TypedUnit import ureg
 from FlowCyPy.opto_electronics.source import BaseSource
+from FlowCyPy.opto_electronics.coupling_cache import CouplingCache
 from FlowCyPy.sub_frames.events import EventDataFrame
 
 
@@ -16,15 +17,22 @@ class ScatteringModel:
     Each event frame is expected to represent a homogeneous scatterer population,
     such as spheres or core-shell particles, and must expose the columns required
     by the corresponding PyMieSim scatterer constructor.
+
+    When a :class:`CouplingCache` is given, sphere couplings are interpolated from
+    the cache, and PyMieSim only evaluates the grid points the cache is missing
+    and the particles of cells that do not meet its tolerance. Coupling scales
+    with the source intensity, so the cache stores it for a unit field amplitude.
     """
 
     def __init__(
         self,
         source: BaseSource,
         detector: object,
+        coupling_cache: CouplingCache | None = None,
     ):
         self.source = source
         self.detector = detector
+        self.coupling_cache = coupling_cache
 
     def run(
         self,
@@ -45,6 +53,10 @@ class ScatteringModel:
             if len(event_dataframe) == 0:
                 continue
 
+            if self._uses_coupling_cache(event_dataframe, compute_cross_section):
+                self._write_cached_results(event_dataframe=event_dataframe)
+                continue
+
             experiment = self._build_experiment(event_dataframe=event_dataframe)
 
             self._write_results(
@@ -53,6 +65,119 @@ class ScatteringModel:
                 compute_cross_section=compute_cross_section,
             )
 
+    def _uses_coupling_cache(
+        self,
+        event_dataframe: EventDataFrame,
+        compute_cross_section: bool,
+    ) -> bool:
+        return (
+            self.coupling_cache is not None
+            and not compute_cross_section
+            and event_dataframe.scatterer_type == "SpherePopulation"
+        )
+
+    def _get_setup_key(self) -> List[float]:
+        """
+        Values identifying the optical setup in the coupling cache.
+        """
+        return [
+            float(self.source.wavelength.to("meter").magnitude),
+            float(np.asarray(self.detector.numerical_aperture)),
+            float(np.asarray(self.detector.cache_numerical_aperture)),
+            float(self.detector.gamma_angle.to("radian").magnitude),
+            float(self.detector.phi_angle.to("radian").magnitude),
+            float(self.detector.sampling),
+        ]
+
+    def _compute_unit_coupling(
+        self,
+        diameter,
+        refractive_index: np.ndarray,
+        medium_refractive_index: np.ndarray,
+    ) -> np.ndarray:
+        """
+        Exact sphere couplings, in watts, for a unit field amplitude.
+        """
+        import PyMieSim.material as _
+
+        num_particles = len(refractive_index)
+
+        source_set = _PyMieSim.source_set.PlaneWaveSet.build_sequential(
+            target_size=num_particles,
+            wavelength=self.source.wavelength,
+            polarization=0 * ureg.degree,
+            amplitude=np.ones(num_particles) * ureg.volt / ureg.meter,
+        )
+
+        scatterer_set = _PyMieSim.scatterer_set.SphereSet.build_sequential(
+            target_size=num_particles,
+            diameter=diameter,
+            material=refractive_index,
+            medium=medium_refractive_index,
+        )
+
+        experiment = _PyMieSim.Setup(
+            source_set=source_set,
+            scatterer_set=scatterer_set,
+            detector_set=self._build_detector_set(num_particles=num_particles),
+        )
+
+        return np.asarray(experiment.get_sequential("coupling"), dtype=float)
+
+    def _write_cached_results(
+        self,
+        event_dataframe: EventDataFrame,
+    ) -> None:
+        setup_key = self._get_setup_key()
+
+        diameter = event_dataframe["Diameter"]
+        refractive_index = np.asarray(event_dataframe["RefractiveIndex"].magnitude, dtype=float)
+        medium_refractive_index = np.asarray(event_dataframe["MediumRefractiveIndex"].magnitude, dtype=float)
+
+        points = self.coupling_cache.get_required_points(
+            setup_key, diameter, refractive_index, medium_refractive_index
+        )
+
+        if len(points) > 0:
+            self.coupling_cache.insert_points(
+                setup_key,
+                points,
+                self._compute_unit_coupling(
+                    diameter=points[:, 0] * ureg.meter,
+                    refractive_index=points[:, 1],
+                    medium_refractive_index=points[:, 2],
+                ),
+            )
+
+        coupling = self.coupling_cache.interpolate(
+            setup_key, diameter, refractive_index, medium_refractive_index
+        )
+
+        outside_tolerance = np.isnan(coupling)
+
+        if np.any(outside_tolerance):
+            coupling[outside_tolerance] = self._compute_unit_coupling(
+                diameter=diameter[outside_tolerance],
+                refractive_index=refractive_index[outside_tolerance],
+                medium_refractive_index=medium_refractive_index[outside_tolerance],
+            )
+
+        x_coordinates = event_dataframe["x"]
+        y_coordinates = event_dataframe["y"]
+
+        amplitude = self.source.get_amplitude_signal(
+            x=x_coordinates,
+            y=y_coordinates,
+            z=np.zeros(len(event_dataframe)) * x_coordinates.units,
+        )
+
+        coupling *= amplitude.to("volt / meter").magnitude ** 2
+
+        event_dataframe.dataframe.set_column(
+            column_name=self.detector.name,
+            values=coupling * ureg.watt,
+        )
+
     def _build_experiment(
         self,
         event_dataframe: EventDataFrame,
@@ -1,4 +1,4 @@
-from typing import List
+from typing import List, Optional
 
 from TypedUnit import Time, Power
 import numpy as np
@@ -6,8 +6,10 @@ import numpy as np
 from . import source, circuits
 from .amplifier import Amplifier
 from .coupling_model import ScatteringModel
+from .coupling_cache import CouplingCache
 from .detector import Detector
 from .digitizer import Digitizer
+from .opto_electronic_chain import OptoElectronicChain
 from FlowCyPy.utils import dataclass, config_dict
 from FlowCyPy.fluidics.event_collection import EventCollection
 
@@ -32,6 +34,9 @@ class OptoElectronics:
         The digitizer instance used to convert analog signals to digital form.
     analog_processing : List[circuits.BaseCircuit]
         List of analog processing circuits applied to the signals.
+    coupling_cache : CouplingCache, optional
+        Cache of sphere couplings shared across runs. If None, every coupling is
+        computed with PyMieSim.
     """
 
     detectors: List[Detector]
@@ -39,6 +44,7 @@ class OptoElectronics:
     amplifier: Amplifier
     digitizer: Digitizer
     analog_processing: List[circuits.BaseCircuit] = tuple()
+    coupling_cache: Optional[CouplingCache] = None
 
     def initialize_optical_signal_dict(
         self, run_time: Time, background_power: Power
@@ -164,6 +170,7 @@ class OptoElectronics:
             simulator = ScatteringModel(
                 source=self.source,
                 detector=detector,
+                coupling_cache=self.coupling_cache,
             )
 
             simulator.run(event_collection, compute_cross_section=compute_cross_section)
@@ -194,6 +201,34 @@ class OptoElectronics:
         """
         Convert optical power traces to analog voltage traces by applying the full optoelectronic chain.
 
+        Source noise, responsivity, detector current noise and amplification are
+        applied in a single fused pass by :class:`OptoElectronicChain`. The staged
+        methods of this class remain available and model the same chain.
+
+        Parameters
+        ----------
+        power_signal_dict : dict
+            Optical power signal dictionary.
+
+        Returns
+        -------
+        dict
+            Analog voltage signal dictionary.
+        """
+        chain = OptoElectronicChain(
+            source=self.source,
+            detectors=list(self.detectors),
+            amplifier=self.amplifier,
+            bandwidth=self.digitizer.bandwidth,
+            sampling_rate=self.digitizer.sampling_rate,
+        )
+
+        return chain.process(signal_dict=power_signal_dict)
+
+    def convert_optical_power_to_voltage_staged(self, power_signal_dict: dict) -> dict:
+        """
+        Convert optical power traces to analog voltage traces one stage at a time.
+
         Parameters
         ----------
         power_signal_dict : dict
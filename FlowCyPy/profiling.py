@@ -0,0 +1,223 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+import json
+import os
+from contextlib import contextmanager
+from typing import Iterator
+
+
+def _get_modules() -> tuple:
+    """Compiled modules holding instrumented kernels, each with its own profiler."""
+    from FlowCyPy.opto_electronics import source, detector, amplifier, circuits, digitizer, opto_electronic_chain
+    from FlowCyPy.digital_processing import discriminator, peak_locator, classifier
+    from FlowCyPy.fluidics import flow_cell
+    from FlowCyPy import acquisition_pipeline
+    from FlowCyPy._core_loader import is_unified
+
+    # The unified extension links every kernel once, so its submodules share one profiler and one set of settings.
+    if is_unified():
+        return (acquisition_pipeline,)
+
+    return (
+        source,
+        detector,
+        amplifier,
+        circuits,
+        digitizer,
+        opto_electronic_chain,
+        discriminator,
+        peak_locator,
+        classifier,
+        flow_cell,
+        acquisition_pipeline,
+    )
+
+
+def enable_profiling(trace: bool = False) -> None:
+    """
+    Start recording the timers and counters of the compiled kernels.
+
+    Parameters
+    ----------
+    trace : bool, optional
+        Whether every timed scope is also kept as a trace event, for
+        :func:`write_chrome_trace`.
+    """
+    for module in _get_modules():
+        module.set_profiling_enabled(True, trace=trace)
+
+
+def disable_profiling() -> None:
+    """Stop recording; what was recorded so far is kept."""
+    for module in _get_modules():
+        module.set_profiling_enabled(False)
+
+
+def reset_profiling() -> None:
+    """Forget every recorded timer, counter and trace event."""
+    for module in _get_modules():
+        module.reset_profiling()
+
+
+def merge_profiling_reports(reports) -> dict:
+    """
+    Merge profiling reports, e.g. those of several modules or MPI ranks.
+
+    Scopes found in several reports have their calls, times and counters
+    summed, except for the ``threads`` counter which keeps the largest value.
+
+    Parameters
+    ----------
+    reports : iterable of dict
+        Reports keyed by scope name, as returned by :func:`get_profiling_report`.
+
+    Returns
+    -------
+    dict
+        Merged report, slowest scope first.
+    """
+    report = {}
+
+    for other in reports:
+        for name, scope in other.items():
+            if name not in report:
+                report[name] = dict(scope, counters=dict(scope["counters"]))
+                continue
+
+            merged = report[name]
+
+            if scope["calls"] > 0:
+                merged["min_time"] = scope["min_time"] if merged["calls"] == 0 else min(merged["min_time"], scope["min_time"])
+                merged["max_time"] = max(merged["max_time"], scope["max_time"])
+
+            merged["calls"] += scope["calls"]
+            merged["total_time"] += scope["total_time"]
+
+            for counter, value in scope["counters"].items():
+                if counter == "threads":
+                    merged["counters"][counter] = max(merged["counters"].get(counter, 0.0), value)
+                else:
+                    merged["counters"][counter] = merged["counters"].get(counter, 0.0) + value
+
+    for scope in report.values():
+        scope["mean_time"] = scope["total_time"] / scope["calls"] if scope["calls"] else 0.0
+
+    return dict(sorted(report.items(), key=lambda item: item[1]["total_time"], reverse=True))
+
+
+def get_profiling_report() -> dict:
+    """
+    Timers and counters of the compiled kernels, merged over modules.
+
+    A kernel linked in several modules, e.g. the source kernels reached from
+    both ``source`` and ``acquisition_pipeline``, has its calls, times and
+    counters summed, except for the ``threads`` counter which keeps the largest
+    value.
+
+    Returns
+    -------
+    dict
+        Keyed by scope name, each a dict with ``calls``, ``total_time``,
+        ``min_time``, ``max_time`` and ``mean_time`` in seconds, and ``counters``.
+    """
+    return merge_profiling_reports(module.get_profiling_report() for module in _get_modules())
+
+
+def format_profiling_report(report: dict = None) -> str:
+    """
+    Table of a profiling report, slowest scope first.
+
+    Parameters
+    ----------
+    report : dict, optional
+        Report from :func:`get_profiling_report`, which is called when omitted.
+
+    Returns
+    -------
+    str
+        One line per scope with its calls, total and mean time, and counters.
+    """
+    if report is None:
+        report = get_profiling_report()
+
+    lines = [f"{'scope':<48} {'calls':>8} {'total [ms]':>12} {'mean [us]':>12}  counters"]
+
+    for name, scope in report.items():
+        counters = ", ".join(f"{counter}={value:g}" for counter, value in sorted(scope["counters"].items()))
+        lines.append(
+            f"{name:<48} {scope['calls']:>8} {scope['total_time'] * 1e3:>12.3f} {scope['mean_time'] * 1e6:>12.1f}  {counters}"
+        )
+
+    return "\n".join(lines)
+
+
+def write_chrome_trace(filename: str) -> int:
+    """
+    Write the recorded trace events in the Chrome trace event format.
+
+    The file opens in ``chrome://tracing`` or Perfetto, with one row per thread.
+    Tracing must have been enabled with ``enable_profiling(trace=True)``.
+
+    Parameters
+    ----------
+    filename : str
+        Path of the JSON file.
+
+    Returns
+    -------
+    int
+        Number of events written.
+    """
+    events = []
+
+    for module in _get_modules():
+        for event in module.get_profiling_trace():
+            events.append(
+                {
+                    "name": event["name"],
+                    "cat": module.__name__.rsplit(".", 1)[-1],
+                    "ph": "X",
+                    "pid": os.getpid(),
+                    "tid": event["tid"],
+                    "ts": event["ts"],
+                    "dur": event["dur"],
+                }
+            )
+
+    events.sort(key=lambda event: event["ts"])
+
+    with open(filename, "w") as file:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, file)
+
+    return len(events)
+
+
+@contextmanager
+def profile(trace: bool = False) -> Iterator[dict]:
+    """
+    Profile the compiled kernels over a block.
+
+    Previously recorded timers are reset on entry. On exit, profiling is
+    disabled and the yielded dict is filled with :func:`get_profiling_report`.
+
+    Parameters
+    ----------
+    trace : bool, optional
+        Whether trace events are recorded as well, for :func:`write_chrome_trace`.
+
+    Examples
+    --------
+    >>> with profile() as report:
+    ...     cytometer.run(run_time=1 * units.millisecond)
+    >>> print(format_profiling_report(report))
+    """
+    report = {}
+
+    reset_profiling()
+    enable_profiling(trace=trace)
+
+    try:
+        yield report
+    finally:
+        disable_profiling()
+        report.update(get_profiling_report())
@@ -0,0 +1,244 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+import dataclasses
+import enum
+import hashlib
+import types
+from collections import OrderedDict
+from typing import Any, Callable, Iterable
+
+import numpy as np
+
+
+def fingerprint(obj: Any, exclude: Iterable[str] = ()) -> tuple:
+    """
+    Hashable description of the configuration held by an object.
+
+    Scalars, strings, quantities and arrays are described by value, containers
+    element by element, and other objects by their type, their instance
+    attributes and their settable properties, recursively. Compiled components
+    also contribute their ``repr`` and those of their read only properties that
+    hold a plain value; read only properties holding arrays or objects are left
+    out, as they expose the buffers of the last run rather than configuration.
+
+    Parameters
+    ----------
+    obj : Any
+        Object to describe.
+    exclude : Iterable[str], optional
+        Attributes and properties of ``obj`` itself that are left out. The
+        ``repr`` of ``obj`` is then left out as well, since it may show them.
+
+    Returns
+    -------
+    tuple
+        Nested tuple of plain values, equal for two objects with the same configuration.
+    """
+    return _fingerprint(obj, exclude=frozenset(exclude), active=set())
+
+
+def _fingerprint(obj: Any, exclude: frozenset, active: set) -> tuple:
+    if obj is None or isinstance(obj, (bool, int, float, complex, str, bytes)):
+        return (type(obj).__name__, obj)
+
+    if isinstance(obj, enum.Enum):
+        return (type(obj).__qualname__, obj.name)
+
+    if isinstance(obj, np.generic):
+        return (type(obj).__name__, obj.item())
+
+    if isinstance(obj, np.ndarray) and obj.dtype != object:
+        return ("ndarray", obj.dtype.str, obj.shape, hashlib.sha256(obj.tobytes()).hexdigest())
+
+    if hasattr(obj, "magnitude") and hasattr(obj, "units"):
+        return ("Quantity", _fingerprint(obj.magnitude, frozenset(), active), str(obj.units))
+
+    if type(obj).__module__.startswith("pint"):
+        return ("pint", str(obj))
+
+    if isinstance(obj, (types.FunctionType, types.BuiltinFunctionType, types.MethodType, type)):
+        return ("callable", getattr(obj, "__module__", None), getattr(obj, "__qualname__", repr(obj)))
+
+    if id(obj) in active:
+        return ("cycle", type(obj).__qualname__)
+
+    active.add(id(obj))
+
+    try:
+        if isinstance(obj, np.ndarray):
+            obj = obj.tolist()
+
+        if isinstance(obj, (list, tuple)):
+            return (type(obj).__name__, tuple(_fingerprint(item, frozenset(), active) for item in obj))
+
+        if isinstance(obj, (set, frozenset)):
+            return (type(obj).__name__, tuple(sorted(repr(_fingerprint(item, frozenset(), active)) for item in obj)))
+
+        if isinstance(obj, dict):
+            items = (
+                (_fingerprint(key, frozenset(), active), _fingerprint(value, frozenset(), active))
+                for key, value in obj.items()
+            )
+            return ("dict", tuple(sorted(items, key=repr)))
+
+        description = [type(obj).__module__ + "." + type(obj).__qualname__]
+        is_compiled = not hasattr(obj, "__dict__")
+
+        if dataclasses.is_dataclass(obj):
+            attributes = {field.name: getattr(obj, field.name) for field in dataclasses.fields(obj)}
+        else:
+            attributes = dict(getattr(obj, "__dict__", {}))
+
+        for name, is_settable in _properties(type(obj)).items():
+            if not is_settable and not is_compiled:
+                continue
+
+            try:
+                value = getattr(obj, name)
+            except Exception as error:
+                value = ("unavailable", type(error).__name__)
+
+            # A read only property of a compiled object is a constructor argument
+            # when it holds a plain value, a buffer of the last run otherwise.
+            if is_settable or _is_plain(value):
+                attributes[name] = value
+
+        for name in sorted(attributes):
+            if name.startswith("__") or name in exclude:
+                continue
+
+            description.append((name, _fingerprint(attributes[name], frozenset(), active)))
+
+        if is_compiled and not exclude and type(obj).__repr__ is not object.__repr__:
+            description.append(("repr", repr(obj)))
+
+        return tuple(description)
+
+    finally:
+        active.discard(id(obj))
+
+
+def _properties(cls: type) -> dict:
+    """Properties of a class and of its bases, mapped to whether they have a setter."""
+    properties = {}
+
+    for base in cls.__mro__:
+        for name, member in vars(base).items():
+            if isinstance(member, property) and name not in properties:
+                properties[name] = member.fset is not None
+
+    return properties
+
+
+def _is_plain(value: Any) -> bool:
+    """Whether a value is a scalar, a string or a scalar quantity."""
+    if hasattr(value, "magnitude") and hasattr(value, "units"):
+        value = value.magnitude
+
+    return value is None or isinstance(value, (bool, int, float, str, np.generic))
+
+
+def stage_key(upstream_key: str, *configuration: Any, exclude: Iterable[str] = ()) -> str:
+    """
+    Key of a stage: a digest of the key of the stage it reads from and of its own configuration.
+
+    Chaining the keys makes every stage depend on all the stages before it, so
+    a configuration change invalidates the stage it belongs to and every later one.
+
+    Parameters
+    ----------
+    upstream_key : str
+        Key of the previous stage, or an empty string for the first stage.
+    *configuration : Any
+        Objects configuring the stage.
+    exclude : Iterable[str], optional
+        Attributes left out of the fingerprint of every configuration object.
+
+    Returns
+    -------
+    str
+        Hexadecimal digest.
+    """
+    description = (upstream_key, tuple(fingerprint(obj, exclude=exclude) for obj in configuration))
+
+    return hashlib.sha256(repr(description).encode()).hexdigest()
+
+
+class StageCache:
+    """
+    Outputs of the stages of a simulation, keyed by the configuration that produced them.
+
+    Each stage keeps its latest outputs in a small least recently used table,
+    keyed by :func:`stage_key`. Rerunning a pipeline after a configuration
+    change finds every stage up to the first changed one in the cache, and only
+    executes the stages after it. Going back and forth between a few settings,
+    e.g. while tuning a threshold, hits the cache at every stage.
+
+    Cached outputs are shared with the results built from them and must not be
+    modified in place.
+
+    Parameters
+    ----------
+    max_entries_per_stage : int, optional
+        Number of outputs kept per stage.
+    """
+
+    def __init__(self, max_entries_per_stage: int = 4):
+        if max_entries_per_stage < 1:
+            raise ValueError("max_entries_per_stage must be at least one.")
+
+        self.max_entries_per_stage = max_entries_per_stage
+        self._entries = {}
+        self._statistics = {}
+
+    def compute(self, stage: str, key: str, function: Callable[[], Any]) -> Any:
+        """
+        Output of a stage for a key, computed by ``function`` on a miss.
+
+        Parameters
+        ----------
+        stage : str
+            Name of the stage.
+        key : str
+            Key of the stage, from :func:`stage_key`.
+        function : Callable[[], Any]
+            Computes the output of the stage.
+
+        Returns
+        -------
+        Any
+            Cached or computed output.
+        """
+        entries = self._entries.setdefault(stage, OrderedDict())
+        statistics = self._statistics.setdefault(stage, {"hits": 0, "misses": 0})
+
+        if key in entries:
+            entries.move_to_end(key)
+            statistics["hits"] += 1
+            return entries[key]
+
+        statistics["misses"] += 1
+        output = function()
+
+        entries[key] = output
+
+        while len(entries) > self.max_entries_per_stage:
+            entries.popitem(last=False)
+
+        return output
+
+    @property
+    def statistics(self) -> dict:
+        """Number of hits and misses of each stage, keyed by stage name."""
+        return {stage: dict(counts) for stage, counts in self._statistics.items()}
+
+    def clear(self) -> None:
+        """Drop every cached output and reset the statistics."""
+        self._entries.clear()
+        self._statistics.clear()
+
+    def __len__(self) -> int:
+        return sum(len(entries) for entries in self._entries.values())
+
+    def __repr__(self) -> str:
+        return f"StageCache(entries={len(self)}, max_entries_per_stage={self.max_entries_per_stage})"
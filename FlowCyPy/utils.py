@@ -1,3 +1,5 @@
+from typing import Dict, Optional
+
 from pydantic import ConfigDict
 from pydantic.dataclasses import dataclass  # noqa: F401
 
@@ -5,3 +7,97 @@ from pydantic.dataclasses import dataclass  # noqa: F401
 config_dict = ConfigDict(
     arbitrary_types_allowed=True, kw_only=True, slots=True, extra="forbid"
 )
+
+
+def set_random_seed(seed: int) -> None:
+    """
+    Seed every noise generator of the simulation.
+
+    Source, detector, amplifier and flow cell noise, as well as particle
+    properties, are drawn from counter based streams, so a given seed reproduces
+    a run exactly, for any number of OpenMP threads. The seed can also be set
+    before import with the ``FLOWCYPY_SEED`` environment variable.
+
+    Parameters
+    ----------
+    seed : int
+        Non negative seed.
+    """
+    from FlowCyPy.opto_electronics import source, amplifier, detector, opto_electronic_chain
+    from FlowCyPy.fluidics import flow_cell, distributions, populations
+    from FlowCyPy import acquisition_pipeline
+
+    for module in (
+        source,
+        amplifier,
+        detector,
+        opto_electronic_chain,
+        flow_cell,
+        distributions,
+        populations,
+        acquisition_pipeline,
+    ):
+        module.set_random_seed(int(seed))
+
+
+def set_threads(
+    number_of_threads: int = 0,
+    grain_sizes: Optional[Dict[str, int]] = None,
+    placement: Optional[str] = None,
+) -> None:
+    """
+    Configure the OpenMP kernels of every compiled module.
+
+    A parallel loop over ``n`` samples runs on at most one thread per grain
+    size, so short loops, e.g. the blocks of a streaming run, run serially
+    without the fork and join of a parallel region. Settings made by
+    :func:`set_threads` replace all previous ones, components left out of
+    ``grain_sizes`` get their default grain size back.
+
+    Parameters
+    ----------
+    number_of_threads : int, optional
+        Largest number of threads of a kernel, 0 for the OpenMP default.
+    grain_sizes : dict, optional
+        Smallest number of samples per thread, keyed by kernel family:
+        'source', 'detector', 'amplifier', 'circuits', 'digitizer',
+        'opto_electronic_chain', 'noise', 'flow_cell', 'discriminator',
+        'peak_locator', 'classifier' or 'memory', the latter for the
+        parallel first touch of acquisition buffers. 0 always uses every thread.
+        Pulse synthesis belongs to 'source', coupling cache lookups to
+        'detector' and particle property draws to 'flow_cell'. Kernels looping
+        over events or particles count each in samples of comparable cost, e.g.
+        a k-means event as its features times the number of clusters.
+    placement : {'close', 'spread', 'none'}, optional
+        Binds the OpenMP worker threads to CPUs. On multi socket machines,
+        'spread' uses every socket. The calling thread is not pinned. If None,
+        the placement is left unchanged.
+
+    Raises
+    ------
+    ValueError
+        If a grain size names an unknown kernel family, or the placement is unknown.
+    """
+    # Every instrumented module also sizes its teams with its own threading settings.
+    from FlowCyPy.profiling import _get_modules
+    from FlowCyPy._core_loader import is_unified
+
+    modules = _get_modules()
+
+    if not is_unified():
+        # Modules with parallel kernels but no profiler.
+        from FlowCyPy.fluidics import distributions, populations
+        from FlowCyPy.opto_electronics import coupling_cache
+
+        modules += (distributions, populations, coupling_cache)
+
+    for module in modules:
+        module.reset_threading()
+        module.set_number_of_threads(int(number_of_threads))
+
+        for component, grain_size in (grain_sizes or {}).items():
+            module.set_grain_size(component, int(grain_size))
+
+    if placement is not None:
+        # The OpenMP threads are shared by every module, one call places them all.
+        modules[0].pin_threads(placement)
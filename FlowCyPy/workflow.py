@@ -1,4 +1,7 @@
-from typing import List
+import dataclasses
+import itertools
+import os
+from typing import Dict, List, Optional, Sequence, Tuple
 from TypedUnit import (
     Length,
     Power,
@@ -22,6 +25,8 @@ from FlowCyPy.fluidics import (
 from FlowCyPy.fluidics.populations import GammaModel, ExplicitModel  # noqa: F401
 
 from FlowCyPy.flow_cytometer import FlowCytometer
+from FlowCyPy.run_record import RunRecord
+from FlowCyPy.stage_cache import StageCache
 from FlowCyPy.opto_electronics.source import Gaussian, FlatTop  # noqa: F401
 from FlowCyPy.opto_electronics import (
     Detector,
@@ -30,6 +35,7 @@ from FlowCyPy.opto_electronics import (
     circuits,
     Digitizer,
 )
+from FlowCyPy.opto_electronics.coupling_cache import CouplingCache
 
 from FlowCyPy.digital_processing import (
     DigitalProcessing,
@@ -42,6 +48,22 @@ from FlowCyPy.digital_processing.discriminator import BaseDiscriminator
 config_dict = ConfigDict(arbitrary_types_allowed=True, extra="forbid", kw_only=True)
 
 
+# Fields that leave the events of a run unchanged: sweep points differing only in
+# these fields share one event set.
+DOWNSTREAM_FIELDS = frozenset(
+    {
+        "gain",
+        "bandwidth",
+        "bit_depth",
+        "use_auto_range",
+        "background_power",
+        "analog_processing",
+        "peak_locator",
+        "discriminator",
+    }
+)
+
+
 @dataclass(config=config_dict, kw_only=True)
 class Workflow:
     """High-level convenience builder for a complete flow cytometry pipeline.
@@ -67,6 +89,7 @@ class Workflow:
     use_auto_range: bool = True
     sampling_rate: Frequency
     background_power: Power = 0 * ureg.watt
+    coupling_cache: Optional[CouplingCache] = None
 
     # Population parameters
     population_list: List[populations.SpherePopulation] = None
@@ -136,6 +159,7 @@ class Workflow:
             detectors=self.detectors,
             source=self.source,
             amplifier=amplifier,
+            coupling_cache=self.coupling_cache,
         )
 
     def _get_digital_processing(self) -> DigitalProcessing:
@@ -157,8 +181,11 @@ class Workflow:
 
         This method materializes the fluidics, opto-electronics, digital
         processing, and flow cytometer objects from the dataclass parameters.
-        It must be called before :meth:`run`.
+        It must be called before :meth:`run`. The stage cache of the workflow
+        is kept, so outputs of unchanged stages survive a re-initialization.
         """
+        if getattr(self, "stage_cache", None) is None:
+            self.stage_cache = StageCache()
 
         self.fluidics = self._get_fluidics()
         self.opto_electronics = self._get_opto_electronics()
@@ -169,13 +196,18 @@ class Workflow:
             background_power=self.background_power,
         )
 
-    def run(self, run_time: Time):
+    def run(self, run_time: Time, use_cache: bool = False):
         """Execute one simulated acquisition.
 
         Parameters
         ----------
         run_time : Time
             Duration of the acquisition to simulate.
+        use_cache : bool, optional
+            Whether stage outputs are reused from, and stored in,
+            ``stage_cache``. Only the stages from the first one whose
+            configuration changed since a cached run are executed, so tuning
+            e.g. a discriminator threshold does not synthesize the signals again.
 
         Returns
         -------
@@ -192,4 +224,254 @@ class Workflow:
             run_time=run_time,
             opto_electronics=self.opto_electronics,
             digital_processing=self.digital_processing,
+            cache=self.stage_cache if use_cache else None,
+        )
+
+    def sweep(
+        self,
+        run_time: Time,
+        grid: Dict[str, Sequence],
+        block_size: int = 1 << 16,
+        keep_segments: bool = True,
+        number_of_threads: int = 0,
+        output_directory: Optional[str] = None,
+        comm=None,
+    ) -> Optional[List[Tuple[dict, RunRecord]]]:
+        """Run the workflow over a parameter grid, in parallel.
+
+        Every point of the Cartesian product of ``grid`` is a copy of this
+        workflow with the given fields replaced, for instance
+        ``{"dilution_factor": [1, 10], "gain": [...], "discriminator": [...]}``.
+        Points are run by a :class:`FlowCyPy.acquisition_pipeline.AcquisitionSweep`,
+        as with :meth:`FlowCytometer.run_streaming`. Events are generated, and
+        their coupling computed, once per distinct value of the fields that
+        affect them: points only differing in ``DOWNSTREAM_FIELDS`` share them.
+
+        With an MPI communicator, every rank calls this method with the same
+        arguments. The points sharing an event set form one task, and tasks are
+        handed out one at a time to the ranks other than rank 0, which
+        schedules them and assembles the run records, see
+        :func:`FlowCyPy.distributed.run_dynamic`. The coupling cache and the
+        FFTW wisdom of rank 0 are broadcast once beforehand. Task ``i`` runs
+        with the seed of rank 0 plus ``i``, so results do not depend on the
+        number of ranks, though they differ from a sweep without communicator.
+        Profiling reports are merged with
+        :func:`FlowCyPy.distributed.gather_profiling_report`.
+
+        Parameters
+        ----------
+        run_time : Time
+            Duration of every acquisition.
+        grid : dict
+            Workflow field names mapped to the values they take.
+        block_size : int, optional
+            Number of samples per block of every run.
+        keep_segments : bool, optional
+            Whether the digitized windows are stored in the run records.
+        number_of_threads : int, optional
+            Number of runs executed concurrently, 0 for the OpenMP default.
+        output_directory : str or os.PathLike or None, optional
+            Directory receiving the ADC codes of every run, as the acquisition
+            file ``point_<index>.fcacq`` of its index in ``itertools.product``
+            order. With a communicator, ranks write their files concurrently.
+        comm : mpi4py.MPI.Comm, optional
+            Communicator of the ranks sharing the sweep, e.g.
+            :func:`FlowCyPy.distributed.get_world_communicator`.
+
+        Returns
+        -------
+        list of tuple or None
+            One ``(point, run_record)`` pair per grid point, ``point`` mapping the
+            swept fields to their values, in ``itertools.product`` order. None on
+            the ranks other than rank 0.
+        """
+        from FlowCyPy.acquisition_pipeline import AcquisitionSweep
+
+        names = list(grid)
+        axes = [list(grid[name]) for name in names]
+
+        points = []
+        events_keys = []
+
+        for indices in itertools.product(*(range(len(axis)) for axis in axes)):
+            points.append({name: axis[index] for name, axis, index in zip(names, axes, indices)})
+            events_keys.append(
+                tuple(index for name, index in zip(names, indices) if name not in DOWNSTREAM_FIELDS)
+            )
+
+        if comm is not None:
+            tasks = {}
+
+            for point_index, events_key in enumerate(events_keys):
+                tasks.setdefault(events_key, []).append(point_index)
+
+            return self._sweep_distributed(
+                comm=comm,
+                run_time=run_time,
+                points=points,
+                tasks=list(tasks.values()),
+                block_size=block_size,
+                keep_segments=keep_segments,
+                number_of_threads=number_of_threads,
+                output_directory=output_directory,
+            )
+
+        acquisition_sweep = AcquisitionSweep()
+        acquisition_sweep.number_of_threads = number_of_threads
+
+        event_sets = {}
+        contexts = []
+
+        for point_index, (point, events_key) in enumerate(zip(points, events_keys)):
+            workflow = dataclasses.replace(self, **point)
+            workflow.initialize()
+
+            if events_key not in event_sets:
+                event_collection, events = workflow.cytometer._generate_pipeline_events(
+                    run_time=run_time,
+                    opto_electronics=workflow.opto_electronics,
+                )
+                event_sets[events_key] = (event_collection, acquisition_sweep.add_events(**events))
+
+            event_collection, events_index = event_sets[events_key]
+
+            pipeline = workflow._build_sweep_pipeline(
+                block_size=block_size,
+                keep_segments=keep_segments,
+                output_directory=output_directory,
+                point_index=point_index,
+            )
+
+            acquisition_sweep.add_run(pipeline, events_index, run_time)
+            contexts.append((point, workflow, event_collection))
+
+        outputs = acquisition_sweep.run()
+
+        return [
+            (point, workflow._build_sweep_run_record(run_time, event_collection, output))
+            for (point, workflow, event_collection), output in zip(contexts, outputs)
+        ]
+
+    def _build_sweep_pipeline(
+        self,
+        block_size: int,
+        keep_segments: bool,
+        output_directory: Optional[str],
+        point_index: int,
+    ):
+        """Pipeline of one sweep point, spilling to its acquisition file if any."""
+        pipeline = self.cytometer._build_pipeline(
+            opto_electronics=self.opto_electronics,
+            digital_processing=self.digital_processing,
+            block_size=block_size,
+            keep_segments=keep_segments,
+        )
+
+        if output_directory is not None:
+            pipeline.spill_filename = os.path.join(output_directory, f"point_{point_index:06d}.fcacq")
+
+        return pipeline
+
+    def _build_sweep_run_record(self, run_time: Time, event_collection, output: dict) -> RunRecord:
+        """Run record of one sweep point from its pipeline output."""
+        return FlowCytometer._build_streaming_run_record(
+            run_time=run_time,
+            event_collection=event_collection,
+            opto_electronics=self.opto_electronics,
+            digital_processing=self.digital_processing,
+            output=output,
         )
+
+    def _sweep_distributed(
+        self,
+        comm,
+        run_time: Time,
+        points: List[dict],
+        tasks: List[List[int]],
+        block_size: int,
+        keep_segments: bool,
+        number_of_threads: int,
+        output_directory: Optional[str],
+    ) -> Optional[List[Tuple[dict, RunRecord]]]:
+        """
+        Sweep over MPI ranks, one task per event set, see :meth:`sweep`.
+
+        Workers send back the event tables and the pipeline outputs, which hold
+        no compiled object, and rank 0 rebuilds the run records around its own
+        copy of the workflow of each point.
+        """
+        from FlowCyPy import acquisition_pipeline
+        from FlowCyPy.acquisition_pipeline import AcquisitionSweep
+        from FlowCyPy.distributed import run_dynamic, broadcast_coupling_cache, broadcast_fftw_wisdom
+        from FlowCyPy.fluidics.event_collection import EventCollection
+        from FlowCyPy.fluidics.population_events import PopulationEvents
+        from FlowCyPy.utils import set_random_seed
+
+        broadcast_fftw_wisdom(comm)
+        base = dataclasses.replace(self, coupling_cache=broadcast_coupling_cache(comm, self.coupling_cache))
+        seed = comm.bcast(acquisition_pipeline.get_random_seed() if comm.Get_rank() == 0 else None, root=0)
+
+        def initialize(point_index: int) -> "Workflow":
+            workflow = dataclasses.replace(base, **points[point_index])
+            workflow.initialize()
+            return workflow
+
+        def run_task(task_index: int) -> tuple:
+            set_random_seed(seed + task_index)
+
+            acquisition_sweep = AcquisitionSweep()
+            acquisition_sweep.number_of_threads = number_of_threads
+
+            for position, point_index in enumerate(tasks[task_index]):
+                workflow = initialize(point_index)
+
+                if position == 0:
+                    event_collection, events = workflow.cytometer._generate_pipeline_events(
+                        run_time=run_time,
+                        opto_electronics=workflow.opto_electronics,
+                    )
+                    events_index = acquisition_sweep.add_events(**events)
+
+                acquisition_sweep.add_run(
+                    workflow._build_sweep_pipeline(block_size, keep_segments, output_directory, point_index),
+                    events_index,
+                    run_time,
+                )
+
+            event_tables = [(events.dataframe, events.metadata) for events in event_collection]
+
+            return event_tables, acquisition_sweep.run()
+
+        records = [None] * len(points)
+
+        def on_result(task_index: int, result: tuple) -> None:
+            event_tables, outputs = result
+
+            for position, (point_index, output) in enumerate(zip(tasks[task_index], outputs)):
+                workflow = initialize(point_index)
+
+                if position == 0:
+                    event_collection = EventCollection(
+                        [
+                            PopulationEvents(
+                                dataframe=dataframe,
+                                population=population,
+                                sampling_method=population.sampling_method,
+                                name=population.name,
+                                scatterer_type=population.__class__.__name__,
+                                metadata=metadata,
+                            )
+                            for population, (dataframe, metadata) in zip(
+                                workflow.fluidics.scatterer_collection.populations, event_tables
+                            )
+                        ]
+                    )
+
+                records[point_index] = (
+                    points[point_index],
+                    workflow._build_sweep_run_record(run_time, event_collection, output),
+                )
+
+        run_dynamic(comm, len(tasks), run_task, on_result)
+
+        return records if comm.Get_rank() == 0 else None
@@ -0,0 +1,218 @@
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <pipeline/acquisition_pipeline.h>
+#include <pipeline/acquisition_sweep.h>
+
+#include "benchmark_utils.h"
+
+using namespace flowcypy_benchmarks;
+
+namespace {
+
+// End-to-end runs sample at 10 MHz: 10^6 to 10^8 samples are 0.1 s to 10 s acquisitions.
+constexpr double acquisition_sampling_rate = 10e6;     // [hertz]
+
+// One transit every 2000 samples, i.e. 5000 events per second.
+constexpr size_t samples_per_event = 2000;
+
+const std::vector<int64_t> acquisition_sample_sizes = {1'000'000, 10'000'000, 100'000'000};
+
+
+std::shared_ptr<AcquisitionPipeline> make_pipeline(
+    const bool keep_segments,
+    const SignalPrecision precision = SignalPrecision::float64
+) {
+    std::shared_ptr<BaseSource> source = std::make_shared<Gaussian>(
+        /*wavelength=*/488e-9,
+        /*rin=*/-120.0,
+        /*optical_power=*/200e-3,
+        /*waist_y=*/10e-6,
+        /*waist_z=*/30e-6,
+        /*polarization=*/0.0,
+        /*bandwidth=*/10e6
+    );
+
+    std::vector<Detector> detectors;
+
+    for (const auto& [phi_angle, name] : {std::pair{0.0, "forward"}, std::pair{1.5707963267948966, "side"}}) {
+        detectors.emplace_back(
+            phi_angle,
+            /*numerical_aperture=*/0.2,
+            /*cache_numerical_aperture=*/0.0,
+            /*gamma_angle=*/0.0,
+            /*sampling=*/200,
+            /*responsivity=*/1.0,
+            /*dark_current=*/0.0,
+            /*current_noise_density=*/0.0,
+            /*bandwidth=*/std::numeric_limits<double>::quiet_NaN(),
+            name
+        );
+    }
+
+    const Amplifier amplifier(
+        /*gain=*/1e4,
+        /*bandwidth=*/2e6,
+        /*voltage_noise_density=*/10e-9
+    );
+
+    const Digitizer digitizer(
+        /*bandwidth=*/2e6,
+        /*sampling_rate=*/acquisition_sampling_rate,
+        /*bit_depth=*/12,
+        /*min_voltage=*/-5e-3,
+        /*max_voltage=*/30e-3
+    );
+
+    FixedWindow discriminator("forward", 20, 20);
+    discriminator.set_threshold(2e-3);
+
+    const std::shared_ptr<BasePeakLocator> peak_locator = std::make_shared<GlobalPeakLocator>(
+        /*max_number_of_peaks=*/1,
+        /*padding_value=*/-1,
+        /*compute_width=*/true,
+        /*compute_area=*/true,
+        /*allow_negative_area=*/false,
+        std::make_shared<FullWindowSupport>(),
+        /*polarity=*/"positive",
+        /*height_mode=*/"raw",
+        /*baseline_mode=*/"zero",
+        /*debug_mode=*/false
+    );
+
+    auto pipeline = std::make_shared<AcquisitionPipeline>(
+        source,
+        std::move(detectors),
+        amplifier,
+        digitizer,
+        std::vector<std::shared_ptr<BaseCircuit>>{std::make_shared<BesselLowPassFilter>(3e6, 2, 1.0)},
+        OnlineDiscriminator(discriminator),
+        peak_locator
+    );
+
+    pipeline->keep_segments = keep_segments;
+    pipeline->precision = precision;
+
+    return pipeline;
+}
+
+
+PipelineEvents make_pipeline_events(const size_t number_of_events, const double run_time) {
+    PipelineEvents events;
+
+    events.centers = make_event_centers(number_of_events, run_time);
+    events.velocities.assign(number_of_events, 1.0);
+    events.amplitudes.assign(2 * number_of_events, 1e-6);
+
+    return events;
+}
+
+
+/**
+ * Full acquisition of range(0) samples: synthesis, noise, circuits, trigger, digitizer and peaks.
+ */
+void run_pipeline_benchmark(benchmark::State& state, const SignalPrecision precision) {
+    const size_t number_of_samples = static_cast<size_t>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const double run_time = static_cast<double>(number_of_samples) / acquisition_sampling_rate;
+    const PipelineEvents events = make_pipeline_events(number_of_samples / samples_per_event, run_time);
+    const std::shared_ptr<AcquisitionPipeline> pipeline = make_pipeline(false, precision);
+
+    size_t number_of_detected_events = 0;
+
+    for ([[maybe_unused]] auto _ : state) {
+        AcquisitionPipelineResult result = pipeline->run(events, run_time);
+        number_of_detected_events = result.get_number_of_events();
+        benchmark::DoNotOptimize(result);
+    }
+
+    const size_t sample_size = precision == SignalPrecision::float32 ? sizeof(float) : sizeof(double);
+
+    set_throughput(state, state.range(0), 2 * state.range(0) * sample_size);
+    state.counters["events"] = static_cast<double>(number_of_detected_events);
+}
+
+
+void BM_Acquisition_PipelineRun(benchmark::State& state) {
+    run_pipeline_benchmark(state, SignalPrecision::float64);
+}
+BENCHMARK(BM_Acquisition_PipelineRun)
+    ->ArgsProduct({acquisition_sample_sizes, get_thread_counts()})
+    ->ArgNames({"samples", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+
+void BM_Acquisition_PipelineRunFloat32(benchmark::State& state) {
+    run_pipeline_benchmark(state, SignalPrecision::float32);
+}
+BENCHMARK(BM_Acquisition_PipelineRunFloat32)
+    ->ArgsProduct({acquisition_sample_sizes, get_thread_counts()})
+    ->ArgNames({"samples", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+
+/**
+ * Acquisition of a fixed length with range(0) transits, keeping the triggered windows.
+ */
+void BM_Acquisition_PipelineEventRate(benchmark::State& state) {
+    const size_t number_of_samples = 10'000'000;
+    const size_t number_of_events = static_cast<size_t>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const double run_time = static_cast<double>(number_of_samples) / acquisition_sampling_rate;
+    const PipelineEvents events = make_pipeline_events(number_of_events, run_time);
+    const std::shared_ptr<AcquisitionPipeline> pipeline = make_pipeline(true);
+
+    for ([[maybe_unused]] auto _ : state) {
+        AcquisitionPipelineResult result = pipeline->run(events, run_time);
+        benchmark::DoNotOptimize(result);
+    }
+
+    set_throughput(state, state.range(0), 2 * number_of_samples * sizeof(double));
+}
+BENCHMARK(BM_Acquisition_PipelineEventRate)->Apply(apply_events_and_threads);
+
+
+/**
+ * Sweep of eight runs of range(0) samples each, range(1) runs at a time.
+ */
+void BM_Acquisition_Sweep(benchmark::State& state) {
+    const size_t number_of_samples = static_cast<size_t>(state.range(0));
+    const size_t number_of_runs = 8;
+
+    const double run_time = static_cast<double>(number_of_samples) / acquisition_sampling_rate;
+    const std::shared_ptr<const AcquisitionPipeline> pipeline = make_pipeline(false);
+
+    AcquisitionSweep sweep;
+    sweep.number_of_threads = static_cast<size_t>(state.range(1));
+
+    const size_t events_index = sweep.add_events(make_pipeline_events(number_of_samples / samples_per_event, run_time));
+
+    for (size_t run = 0; run < number_of_runs; ++run) {
+        sweep.add_run(pipeline, events_index, run_time);
+    }
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<AcquisitionPipelineResult> results = sweep.run();
+        benchmark::DoNotOptimize(results.data());
+    }
+
+    set_throughput(
+        state,
+        number_of_runs * state.range(0),
+        number_of_runs * 2 * state.range(0) * sizeof(double)
+    );
+    state.counters["threads"] = static_cast<double>(state.range(1));
+}
+BENCHMARK(BM_Acquisition_Sweep)
+    ->ArgsProduct({{1'000'000, 10'000'000}, get_thread_counts()})
+    ->ArgNames({"samples", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}
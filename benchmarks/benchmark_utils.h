@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <omp.h>
+
+
+namespace flowcypy_benchmarks {
+
+constexpr double sampling_rate = 100e6;     // [hertz]
+constexpr double time_step = 1.0 / sampling_rate;     // [second]
+
+/// Signal lengths of the sample-bound kernels, 10^4 to 10^8 samples.
+inline const std::vector<int64_t> sample_sizes = {10'000, 1'000'000, 100'000'000};
+
+/// Event counts of the event-bound kernels, 10^2 to 10^6 events.
+inline const std::vector<int64_t> event_counts = {100, 10'000, 1'000'000};
+
+
+/**
+ * @brief OpenMP thread counts 1, 2, 4, ... up to 64, capped at the number of processors.
+ */
+inline std::vector<int64_t> get_thread_counts() {
+    const int64_t number_of_processors = omp_get_num_procs();
+    std::vector<int64_t> thread_counts;
+
+    for (int64_t threads = 1; threads <= 64; threads *= 2) {
+        if (threads > number_of_processors) {
+            break;
+        }
+
+        thread_counts.push_back(threads);
+    }
+
+    if (thread_counts.back() != number_of_processors && number_of_processors <= 64) {
+        thread_counts.push_back(number_of_processors);
+    }
+
+    return thread_counts;
+}
+
+
+/**
+ * @brief Register every (size, thread count) pair of a benchmark, size being range(0).
+ */
+inline void apply_sizes_and_threads(benchmark::internal::Benchmark* benchmark, const std::vector<int64_t>& sizes) {
+    benchmark->ArgsProduct({sizes, get_thread_counts()});
+    benchmark->Unit(benchmark::kMillisecond);
+    benchmark->UseRealTime();
+}
+
+inline void apply_samples_and_threads(benchmark::internal::Benchmark* benchmark) {
+    apply_sizes_and_threads(benchmark, sample_sizes);
+    benchmark->ArgNames({"samples", "threads"});
+}
+
+inline void apply_events_and_threads(benchmark::internal::Benchmark* benchmark) {
+    apply_sizes_and_threads(benchmark, event_counts);
+    benchmark->ArgNames({"events", "threads"});
+}
+
+
+/**
+ * @brief Sets the number of OpenMP threads for the lifetime of a benchmark run.
+ */
+class ScopedThreadCount {
+public:
+    explicit ScopedThreadCount(const int number_of_threads)
+        : previous_number_of_threads(omp_get_max_threads())
+    {
+        omp_set_num_threads(number_of_threads);
+    }
+
+    ~ScopedThreadCount() {
+        omp_set_num_threads(this->previous_number_of_threads);
+    }
+
+    ScopedThreadCount(const ScopedThreadCount&) = delete;
+    ScopedThreadCount& operator=(const ScopedThreadCount&) = delete;
+
+private:
+    int previous_number_of_threads;
+};
+
+
+/**
+ * @brief Report the throughput of a kernel over every iteration of the benchmark loop.
+ */
+inline void set_throughput(benchmark::State& state, const int64_t items_per_iteration, const int64_t bytes_per_iteration) {
+    state.SetItemsProcessed(state.iterations() * items_per_iteration);
+    state.SetBytesProcessed(state.iterations() * bytes_per_iteration);
+    state.counters["threads"] = static_cast<double>(omp_get_max_threads());
+}
+
+
+inline std::vector<double> make_time_array(const size_t number_of_samples) {
+    std::vector<double> time(number_of_samples);
+
+    for (size_t index = 0; index < number_of_samples; ++index) {
+        time[index] = static_cast<double>(index) * time_step;
+    }
+
+    return time;
+}
+
+
+/**
+ * @brief Sorted event centers drawn uniformly over [0, run_time), with a fixed seed.
+ */
+inline std::vector<double> make_event_centers(const size_t number_of_events, const double run_time) {
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution<double> distribution(0.0, run_time);
+
+    std::vector<double> centers(number_of_events);
+
+    for (double& center : centers) {
+        center = distribution(generator);
+    }
+
+    std::sort(centers.begin(), centers.end());
+
+    return centers;
+}
+
+
+/**
+ * @brief Gaussian pulses of unit height and of pulse_width samples on a small deterministic ripple.
+ *
+ * Pulses are evaluated within four widths of their center, so building a
+ * train of 10^8 samples stays a small fraction of the benchmark setup.
+ */
+inline std::vector<double> make_pulse_train(
+    const size_t number_of_samples,
+    const size_t number_of_events,
+    const double pulse_width = 20.0
+) {
+    std::vector<double> signal(number_of_samples);
+
+    for (size_t index = 0; index < number_of_samples; ++index) {
+        signal[index] = 0.01 * std::sin(0.1 * static_cast<double>(index));
+    }
+
+    const std::vector<double> centers = make_event_centers(number_of_events, static_cast<double>(number_of_samples));
+    const double half_support = 4.0 * pulse_width;
+
+    for (const double center : centers) {
+        const size_t first = static_cast<size_t>(std::max(0.0, center - half_support));
+        const size_t last = static_cast<size_t>(std::min(static_cast<double>(number_of_samples), center + half_support));
+
+        for (size_t index = first; index < last; ++index) {
+            const double offset = (static_cast<double>(index) - center) / pulse_width;
+            signal[index] += std::exp(-0.5 * offset * offset);
+        }
+    }
+
+    return signal;
+}
+
+
+/**
+ * @brief Row major (number_of_samples x number_of_features) points in a few well separated clusters.
+ */
+inline std::vector<double> make_clustered_points(
+    const size_t number_of_samples,
+    const size_t number_of_features,
+    const size_t number_of_clusters
+) {
+    std::mt19937_64 generator(42);
+    std::normal_distribution<double> distribution(0.0, 1.0);
+
+    std::vector<double> points(number_of_samples * number_of_features);
+
+    for (size_t sample = 0; sample < number_of_samples; ++sample) {
+        const double cluster_offset = 10.0 * static_cast<double>(sample % number_of_clusters);
+
+        for (size_t feature = 0; feature < number_of_features; ++feature) {
+            points[sample * number_of_features + feature] = cluster_offset + distribution(generator);
+        }
+    }
+
+    return points;
+}
+
+}
@@ -0,0 +1,159 @@
+#include <cmath>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <digital_processing/discriminator/discriminator.h>
+#include <digital_processing/peak_locator/peak_locator.h>
+#include <digital_processing/classifier/classifier.h>
+
+#include "benchmark_utils.h"
+
+using namespace flowcypy_benchmarks;
+
+namespace {
+
+// Samples of every triggered window in the peak locator benchmarks.
+constexpr size_t window_size = 128;
+
+
+void BM_Discriminator_FixedWindow(benchmark::State& state) {
+    const size_t number_of_samples = static_cast<size_t>(state.range(0));
+    const size_t number_of_events = number_of_samples / 1000;
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    FixedWindow discriminator("forward", 64, 64);
+    discriminator.set_threshold(0.5);
+    discriminator.add_time(utils::TimeAxis(0.0, time_step, number_of_samples));
+    discriminator.add_signal("forward", make_pulse_train(number_of_samples, number_of_events));
+
+    for ([[maybe_unused]] auto _ : state) {
+        discriminator.run();
+        benchmark::DoNotOptimize(discriminator.trigger.get_number_of_segments());
+    }
+
+    set_throughput(state, state.range(0), state.range(0) * sizeof(double));
+    state.counters["events"] = static_cast<double>(discriminator.trigger.get_number_of_segments());
+}
+BENCHMARK(BM_Discriminator_FixedWindow)->Apply(apply_samples_and_threads);
+
+
+void BM_Discriminator_DynamicWindow(benchmark::State& state) {
+    const size_t number_of_samples = static_cast<size_t>(state.range(0));
+    const size_t number_of_events = number_of_samples / 1000;
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    DynamicWindow discriminator("forward", 16, 16);
+    discriminator.set_threshold(0.5);
+    discriminator.add_time(utils::TimeAxis(0.0, time_step, number_of_samples));
+    discriminator.add_signal("forward", make_pulse_train(number_of_samples, number_of_events));
+
+    for ([[maybe_unused]] auto _ : state) {
+        discriminator.run();
+        benchmark::DoNotOptimize(discriminator.trigger.get_number_of_segments());
+    }
+
+    set_throughput(state, state.range(0), state.range(0) * sizeof(double));
+    state.counters["events"] = static_cast<double>(discriminator.trigger.get_number_of_segments());
+}
+BENCHMARK(BM_Discriminator_DynamicWindow)->Apply(apply_samples_and_threads);
+
+
+void run_peak_locator_benchmark(benchmark::State& state, const std::shared_ptr<BaseSupport>& support) {
+    const size_t number_of_events = static_cast<size_t>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    // One centered pulse per window, as a FixedWindow discriminator would cut them.
+    const std::vector<double> window = make_pulse_train(window_size, 0);
+    std::vector<double> signal;
+    signal.reserve(number_of_events * window_size);
+
+    for (size_t event = 0; event < number_of_events; ++event) {
+        for (size_t index = 0; index < window_size; ++index) {
+            const double offset = (static_cast<double>(index) - 0.5 * window_size) / 10.0;
+            signal.push_back(window[index] + std::exp(-0.5 * offset * offset));
+        }
+    }
+
+    std::vector<size_t> segment_offsets(number_of_events + 1);
+
+    for (size_t event = 0; event <= number_of_events; ++event) {
+        segment_offsets[event] = event * window_size;
+    }
+
+    const SignalViewDictionary views = {
+        {"forward", std::span<const double>(signal)},
+        {"side", std::span<const double>(signal)}
+    };
+
+    const GlobalPeakLocator peak_locator(
+        /*max_number_of_peaks=*/1,
+        /*padding_value=*/-1,
+        /*compute_width=*/true,
+        /*compute_area=*/true,
+        /*allow_negative_area=*/false,
+        support,
+        /*polarity=*/"positive",
+        /*height_mode=*/"raw",
+        /*baseline_mode=*/"zero",
+        /*debug_mode=*/false
+    );
+
+    for ([[maybe_unused]] auto _ : state) {
+        EventMetricDictionary metrics = peak_locator.run_segment_offsets(segment_offsets, views, "forward");
+        benchmark::DoNotOptimize(metrics);
+    }
+
+    set_throughput(state, state.range(0), 2 * signal.size() * sizeof(double));
+}
+
+
+void BM_PeakLocator_GlobalFullWindow(benchmark::State& state) {
+    run_peak_locator_benchmark(state, std::make_shared<FullWindowSupport>());
+}
+BENCHMARK(BM_PeakLocator_GlobalFullWindow)->Apply(apply_events_and_threads);
+
+
+void BM_PeakLocator_GlobalPulseSupport(benchmark::State& state) {
+    run_peak_locator_benchmark(state, std::make_shared<PulseSupport>("default", 0.5));
+}
+BENCHMARK(BM_PeakLocator_GlobalPulseSupport)->Apply(apply_events_and_threads);
+
+
+void BM_Classifier_Kmeans(benchmark::State& state) {
+    const size_t number_of_events = static_cast<size_t>(state.range(0));
+    const size_t number_of_features = 2;
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const std::vector<double> points = make_clustered_points(number_of_events, number_of_features, 3);
+    const KmeansClassifier classifier(3);
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<int> labels = classifier.run(points.data(), number_of_events, number_of_features);
+        benchmark::DoNotOptimize(labels.data());
+    }
+
+    set_throughput(state, state.range(0), points.size() * sizeof(double));
+}
+BENCHMARK(BM_Classifier_Kmeans)->Apply(apply_events_and_threads);
+
+
+void BM_Classifier_Dbscan(benchmark::State& state) {
+    const size_t number_of_events = static_cast<size_t>(state.range(0));
+    const size_t number_of_features = 2;
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const std::vector<double> points = make_clustered_points(number_of_events, number_of_features, 3);
+    const DbscanClassifier classifier(0.5, 5);
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<int> labels = classifier.run(points.data(), number_of_events, number_of_features);
+        benchmark::DoNotOptimize(labels.data());
+    }
+
+    set_throughput(state, state.range(0), points.size() * sizeof(double));
+}
+BENCHMARK(BM_Classifier_Dbscan)->Apply(apply_events_and_threads);
+
+}
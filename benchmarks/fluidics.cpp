@@ -0,0 +1,94 @@
+#include <cmath>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <fluidics/flow_cell/flow_cell.h>
+#include <fluidics/distributions/distributions.h>
+
+#include "benchmark_utils.h"
+
+using namespace flowcypy_benchmarks;
+
+namespace {
+
+FlowCell make_flow_cell(const std::string& event_scheme) {
+    return FlowCell(
+        /*width=*/10e-6,
+        /*height=*/6e-6,
+        /*sample_volume_flow=*/1e-9,
+        /*sheath_volume_flow=*/6e-9,
+        /*viscosity=*/1e-3,
+        /*N_terms=*/25,
+        /*n_int=*/200,
+        event_scheme,
+        /*transverse_sampling_scheme=*/"velocity-weighted",
+        /*perfectly_aligned=*/false
+    );
+}
+
+
+void BM_FlowCell_SampleTransverseProfile(benchmark::State& state) {
+    const int number_of_events = static_cast<int>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const FlowCell flow_cell = make_flow_cell("uniform-random");
+
+    for ([[maybe_unused]] auto _ : state) {
+        auto profile = flow_cell.sample_transverse_profile(number_of_events);
+        benchmark::DoNotOptimize(std::get<0>(profile).data());
+    }
+
+    set_throughput(state, state.range(0), 3 * state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_FlowCell_SampleTransverseProfile)->Apply(apply_events_and_threads);
+
+
+void BM_FlowCell_SampleArrivalTimes(benchmark::State& state) {
+    const size_t number_of_events = static_cast<size_t>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const FlowCell flow_cell = make_flow_cell("uniform-random");
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<double> arrival_times = flow_cell.sample_arrival_times(number_of_events, 1.0, 0.0);
+        benchmark::DoNotOptimize(arrival_times.data());
+    }
+
+    set_throughput(state, state.range(0), state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_FlowCell_SampleArrivalTimes)->Apply(apply_events_and_threads);
+
+
+void BM_Distributions_SampleNormal(benchmark::State& state) {
+    const size_t number_of_events = static_cast<size_t>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const Normal distribution(200e-9, 20e-9, 100e-9, 300e-9);
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<double> samples = distribution.sample(number_of_events);
+        benchmark::DoNotOptimize(samples.data());
+    }
+
+    set_throughput(state, state.range(0), state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_Distributions_SampleNormal)->Apply(apply_events_and_threads);
+
+
+void BM_Distributions_SampleLogNormal(benchmark::State& state) {
+    const size_t number_of_events = static_cast<size_t>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const LogNormal distribution(std::log(200e-9), 0.2, 50e-9, 800e-9);
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<double> samples = distribution.sample(number_of_events);
+        benchmark::DoNotOptimize(samples.data());
+    }
+
+    set_throughput(state, state.range(0), state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_Distributions_SampleLogNormal)->Apply(apply_events_and_threads);
+
+}
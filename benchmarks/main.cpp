@@ -0,0 +1,33 @@
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <omp.h>
+
+#ifndef FLOWCYPY_GIT_COMMIT
+#define FLOWCYPY_GIT_COMMIT "unknown"
+#endif
+
+#ifndef FLOWCYPY_VERSION
+#define FLOWCYPY_VERSION "unknown"
+#endif
+
+
+// The commit and the OpenMP configuration are written to the JSON context, so
+// that results of different commits and machines can be told apart when compared.
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    benchmark::AddCustomContext("flowcypy_git_commit", FLOWCYPY_GIT_COMMIT);
+    benchmark::AddCustomContext("flowcypy_version", FLOWCYPY_VERSION);
+    benchmark::AddCustomContext("openmp_max_threads", std::to_string(omp_get_max_threads()));
+    benchmark::AddCustomContext("openmp_num_procs", std::to_string(omp_get_num_procs()));
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
@@ -0,0 +1,244 @@
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <opto_electronics/source/source.h>
+#include <opto_electronics/detector/detector.h>
+#include <opto_electronics/amplifier/amplifier.h>
+#include <opto_electronics/digitizer/digitizer.h>
+#include <opto_electronics/circuits/circuits.h>
+
+#include "benchmark_utils.h"
+
+using namespace flowcypy_benchmarks;
+
+namespace {
+
+constexpr double not_a_number = std::numeric_limits<double>::quiet_NaN();
+
+// Signal length of the event-bound source benchmarks: 0.1 s at 100 MHz.
+constexpr size_t pulse_train_samples = 10'000'000;
+
+// Particle velocity, giving pulses of about 2 us, i.e. 200 samples, through a 10 um waist.
+constexpr double particle_velocity = 5.0;     // [meter / second]
+
+
+Gaussian make_gaussian_source() {
+    return Gaussian(
+        /*wavelength=*/1550e-9,
+        /*rin=*/-120.0,
+        /*optical_power=*/200e-3,
+        /*waist_y=*/10e-6,
+        /*waist_z=*/60e-6,
+        /*polarization=*/0.0
+    );
+}
+
+
+void BM_Source_GenerateMultiDetectorPulses(benchmark::State& state) {
+    const size_t number_of_events = static_cast<size_t>(state.range(0));
+    const size_t number_of_detectors = 2;
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const Gaussian source = make_gaussian_source();
+    const std::vector<double> time = make_time_array(pulse_train_samples);
+    const std::vector<double> centers = make_event_centers(number_of_events, time.back());
+    const std::vector<double> velocities(number_of_events, particle_velocity);
+    const std::vector<double> amplitudes(number_of_events * number_of_detectors, 1e-6);
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<std::vector<double>> signals = source.generate_multi_detector_pulses(
+            velocities, centers, amplitudes, number_of_detectors, time, 0.0
+        );
+        benchmark::DoNotOptimize(signals.data());
+    }
+
+    set_throughput(state, state.range(0), pulse_train_samples * number_of_detectors * sizeof(double));
+}
+BENCHMARK(BM_Source_GenerateMultiDetectorPulses)->Apply(apply_events_and_threads);
+
+
+void BM_Source_AddRinToSignal(benchmark::State& state) {
+    const size_t number_of_samples = static_cast<size_t>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    Gaussian source = make_gaussian_source();
+    source.bandwidth = 10e6;
+
+    std::vector<double> signal(number_of_samples, 1e-3);
+
+    for ([[maybe_unused]] auto _ : state) {
+        source.add_rin_to_signal(signal);
+        benchmark::ClobberMemory();
+    }
+
+    set_throughput(state, state.range(0), state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_Source_AddRinToSignal)->Apply(apply_samples_and_threads);
+
+
+void BM_Source_AddShotNoiseToSignal(benchmark::State& state) {
+    const size_t number_of_samples = static_cast<size_t>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const Gaussian source = make_gaussian_source();
+    std::vector<double> signal(number_of_samples, 1e-3);
+
+    for ([[maybe_unused]] auto _ : state) {
+        source.add_shot_noise_to_signal(signal, time_step);
+        benchmark::ClobberMemory();
+    }
+
+    set_throughput(state, state.range(0), state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_Source_AddShotNoiseToSignal)->Apply(apply_samples_and_threads);
+
+
+void BM_Detector_ApplyDarkCurrentNoise(benchmark::State& state) {
+    const size_t number_of_samples = static_cast<size_t>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const Detector detector(
+        /*phi_angle=*/0.0,
+        /*numerical_aperture=*/0.2,
+        /*cache_numerical_aperture=*/0.0,
+        /*gamma_angle=*/0.0,
+        /*sampling=*/200,
+        /*responsivity=*/1.0,
+        /*dark_current=*/10e-9,
+        /*current_noise_density=*/1e-12,
+        /*bandwidth=*/10e6
+    );
+
+    const std::vector<double> signal(number_of_samples, 1e-6);
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<double> output = detector.apply_dark_current_noise(signal);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    set_throughput(state, state.range(0), state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_Detector_ApplyDarkCurrentNoise)->Apply(apply_samples_and_threads);
+
+
+void BM_Amplifier_Amplify(benchmark::State& state) {
+    const size_t number_of_samples = static_cast<size_t>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const Amplifier amplifier(
+        /*gain=*/1e5,
+        /*bandwidth=*/10e6,
+        /*voltage_noise_density=*/1e-9,
+        /*current_noise_density=*/1e-12
+    );
+
+    const std::vector<double> signal = make_pulse_train(number_of_samples, number_of_samples / 1000);
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<double> output = amplifier.amplify(signal, sampling_rate);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    set_throughput(state, state.range(0), state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_Amplifier_Amplify)->Apply(apply_samples_and_threads);
+
+
+Digitizer make_digitizer(const bool compact_codes) {
+    return Digitizer(
+        /*bandwidth=*/not_a_number,
+        /*sampling_rate=*/sampling_rate,
+        /*bit_depth=*/14,
+        /*min_voltage=*/-0.5,
+        /*max_voltage=*/1.5,
+        /*use_auto_range=*/false,
+        /*output_signed_codes=*/false,
+        /*debug_mode=*/false,
+        /*channel_range_mode=*/ChannelRangeMode::shared,
+        /*compact_codes=*/compact_codes
+    );
+}
+
+
+void BM_Digitizer_ProcessSignal(benchmark::State& state) {
+    const size_t number_of_samples = static_cast<size_t>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    Digitizer digitizer = make_digitizer(false);
+
+    // Quantized samples are fixed points of the quantizer, so every iteration does the same work.
+    std::vector<double> signal = make_pulse_train(number_of_samples, number_of_samples / 1000);
+
+    for ([[maybe_unused]] auto _ : state) {
+        digitizer.process_signal(signal);
+        benchmark::ClobberMemory();
+    }
+
+    set_throughput(state, state.range(0), state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_Digitizer_ProcessSignal)->Apply(apply_samples_and_threads);
+
+
+void BM_Digitizer_GetProcessedCodeDataMap(benchmark::State& state) {
+    const size_t number_of_samples = static_cast<size_t>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const Digitizer digitizer = make_digitizer(true);
+
+    const std::map<std::string, std::vector<double>> data_map = {
+        {"forward", make_pulse_train(number_of_samples, number_of_samples / 1000)},
+        {"side", make_pulse_train(number_of_samples, number_of_samples / 1000)}
+    };
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::map<std::string, DigitizedChannel> codes = digitizer.get_processed_code_data_map(data_map);
+        benchmark::DoNotOptimize(codes);
+    }
+
+    set_throughput(state, 2 * state.range(0), 2 * state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_Digitizer_GetProcessedCodeDataMap)->Apply(apply_samples_and_threads);
+
+
+void run_circuit_benchmark(benchmark::State& state, const BaseCircuit& circuit) {
+    const size_t number_of_samples = static_cast<size_t>(state.range(0));
+    const ScopedThreadCount thread_count(static_cast<int>(state.range(1)));
+
+    const std::vector<double> signal = make_pulse_train(number_of_samples, number_of_samples / 1000);
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<double> output = circuit.process(signal, sampling_rate);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    set_throughput(state, state.range(0), state.range(0) * sizeof(double));
+}
+
+
+void BM_Circuits_ButterworthFft(benchmark::State& state) {
+    run_circuit_benchmark(state, ButterworthLowPassFilter(5e6, 4, 1.0, LowPassImplementation::fft));
+}
+BENCHMARK(BM_Circuits_ButterworthFft)->Apply(apply_samples_and_threads);
+
+
+void BM_Circuits_ButterworthIir(benchmark::State& state) {
+    run_circuit_benchmark(state, ButterworthLowPassFilter(5e6, 4, 1.0, LowPassImplementation::iir));
+}
+BENCHMARK(BM_Circuits_ButterworthIir)->Apply(apply_samples_and_threads);
+
+
+void BM_Circuits_BaselineRestorationServo(benchmark::State& state) {
+    run_circuit_benchmark(state, BaselineRestorationServo(10e-6));
+}
+BENCHMARK(BM_Circuits_BaselineRestorationServo)->Apply(apply_samples_and_threads);
+
+
+void BM_Circuits_SlidingMinimumBaselineCorrection(benchmark::State& state) {
+    run_circuit_benchmark(state, SlidingMinimumBaselineCorrection(10e-6));
+}
+BENCHMARK(BM_Circuits_SlidingMinimumBaselineCorrection)->Apply(apply_samples_and_threads);
+
+}
@@ -0,0 +1,84 @@
+import numpy as np
+import pytest
+
+from FlowCyPy.binary.acquisition_buffer import AcquisitionBuffer
+from FlowCyPy.digital_processing.discriminator import FixedWindow
+from FlowCyPy.opto_electronics.digitizer import Digitizer
+from FlowCyPy.units import ureg
+
+N_POINTS = 1000
+
+
+def make_data_dict() -> dict:
+    signal = np.zeros(N_POINTS)
+    signal[100:120] = 2.0
+    signal[400:420] = 2.0
+
+    return {
+        "Time": np.linspace(0, 1, N_POINTS) * ureg.second,
+        "det1": signal * ureg.volt,
+        "det2": 0.5 * signal * ureg.volt,
+    }
+
+
+def test_buffer_protocol_exposes_channel_major_storage_without_copy():
+    buffer = AcquisitionBuffer.from_dict(make_data_dict())
+
+    array = np.asarray(buffer)
+
+    assert array.shape == (3, N_POINTS)
+    assert buffer.channel_names == ["Time", "det1", "det2"]
+    assert array.strides[0] % 64 == 0
+    assert array.ctypes.data % 64 == 0
+    assert np.allclose(array[1], buffer["det1"])
+
+    buffer["det2"][0] = 42.0
+    assert array[2, 0] == 42.0
+
+
+def test_buffer_rejects_channels_of_different_lengths():
+    with pytest.raises(RuntimeError):
+        AcquisitionBuffer.from_dict(
+            {"Time": np.zeros(10) * ureg.second, "det1": np.zeros(5) * ureg.volt}
+        )
+
+
+def test_digitizer_processes_buffer_in_place_like_data_dict():
+    data_dict = make_data_dict()
+    buffer = AcquisitionBuffer.from_dict(data_dict)
+    view = buffer["det1"]
+
+    digitizer = Digitizer(
+        sampling_rate=1 * ureg.megahertz,
+        bit_depth=8,
+        use_auto_range=True,
+    )
+
+    expected = digitizer.digitize_data_dict(data_dict)
+    digitizer.process_acquisition_buffer(buffer)
+
+    assert np.array_equal(view, np.asarray(expected["det1"], dtype=float))
+    assert np.array_equal(buffer["det2"], np.asarray(expected["det2"], dtype=float))
+    assert np.allclose(buffer["Time"], data_dict["Time"].magnitude)
+
+
+def test_discriminator_runs_on_buffer_like_data_dict():
+    data_dict = make_data_dict()
+
+    discriminator = FixedWindow(
+        trigger_channel="det1",
+        threshold=1.0 * ureg.volt,
+        pre_buffer=5,
+        post_buffer=5,
+    )
+
+    expected = discriminator.run_with_dict(data_dict)
+    output = discriminator.run_with_acquisition_buffer(AcquisitionBuffer.from_dict(data_dict))
+
+    assert np.array_equal(output["segment_id"], expected["segment_id"])
+    assert np.allclose(output["Time"].magnitude, expected["Time"].magnitude)
+    assert np.allclose(output["det2"].magnitude, expected["det2"].magnitude)
+
+
+if __name__ == "__main__":
+    pytest.main(["-W", "error", "-s", __file__])
@@ -0,0 +1,498 @@
+import os
+
+import numpy as np
+import pytest
+
+from FlowCyPy.acquisition_pipeline import (
+    AcquisitionFileReader,
+    AcquisitionPipeline,
+    AcquisitionSweep,
+    EventStatistics,
+    HistogramAxis,
+    is_offload_device_available,
+    replay,
+)
+from FlowCyPy.digital_processing.discriminator import FixedWindow
+from FlowCyPy.digital_processing.peak_locator import GlobalPeakLocator, SlidingWindowPeakLocator
+from FlowCyPy.opto_electronics import circuits
+from FlowCyPy.opto_electronics.amplifier import Amplifier
+from FlowCyPy.opto_electronics.detector import Detector
+from FlowCyPy.opto_electronics.digitizer import Digitizer
+from FlowCyPy.opto_electronics.source import Gaussian
+from FlowCyPy.units import ureg
+from FlowCyPy import set_random_seed, set_threads
+
+
+RUN_TIME = 2 * ureg.millisecond
+
+
+def build_pipeline(block_size: int, threshold=2 * ureg.millivolt, use_auto_range: bool = False, peak_locator=None):
+    source = Gaussian(
+        wavelength=488e-9 * ureg.meter,
+        optical_power=0.2 * ureg.watt,
+        waist_y=10e-6 * ureg.meter,
+        waist_z=30e-6 * ureg.meter,
+        rin=-120.0 * ureg.dB_per_Hz,
+        polarization=0.0 * ureg.radian,
+        bandwidth=10 * ureg.megahertz,
+    )
+
+    detectors = [
+        Detector(
+            phi_angle=angle * ureg.degree,
+            numerical_aperture=0.2,
+            responsivity=1.0 * ureg.ampere / ureg.watt,
+            name=name,
+        )
+        for angle, name in [(0, "forward"), (90, "side")]
+    ]
+
+    amplifier = Amplifier(
+        gain=1e4 * ureg.ohm,
+        bandwidth=200 * ureg.kilohertz,
+        voltage_noise_density=10e-9 * ureg.volt / ureg.hertz**0.5,
+    )
+
+    digitizer = Digitizer(
+        sampling_rate=2 * ureg.megahertz,
+        bandwidth=200 * ureg.kilohertz,
+        bit_depth=12,
+        min_voltage=-5 * ureg.millivolt,
+        max_voltage=30 * ureg.millivolt,
+        use_auto_range=use_auto_range,
+    )
+
+    pipeline = AcquisitionPipeline(
+        source=source,
+        detectors=detectors,
+        amplifier=amplifier,
+        digitizer=digitizer,
+        discriminator=FixedWindow(
+            trigger_channel="forward",
+            threshold=threshold,
+            pre_buffer=20,
+            post_buffer=20,
+        ),
+        circuits=[circuits.BesselLowPass(cutoff_frequency=300 * ureg.kilohertz, order=2, gain=1.0)],
+        peak_locator=peak_locator or GlobalPeakLocator(compute_width=True, compute_area=True),
+    )
+    pipeline.block_size = block_size
+
+    return pipeline
+
+
+@pytest.fixture
+def events():
+    rng = np.random.default_rng(1)
+    number_of_events = 40
+
+    return dict(
+        velocities=np.ones(number_of_events) * ureg.meter / ureg.second,
+        centers=np.sort(rng.uniform(0, RUN_TIME.to("second").magnitude, number_of_events)) * ureg.second,
+        amplitudes=np.column_stack([np.full(number_of_events, 1e-7), np.full(number_of_events, 5e-8)]) * ureg.watt,
+    )
+
+
+def run(block_size: int, events: dict) -> dict:
+    set_random_seed(7)
+    return build_pipeline(block_size).run(run_time=RUN_TIME, **events)
+
+
+def test_output_does_not_depend_on_block_size(events):
+    reference = run(1 << 20, events)
+
+    assert reference["number_of_blocks"] == 1
+    assert len(reference["start_index"]) > 0
+
+    for block_size in (333, 1000):
+        output = run(block_size, events)
+
+        assert output["number_of_blocks"] > 1
+        np.testing.assert_array_equal(output["start_index"], reference["start_index"])
+
+        for channel in ("forward", "side"):
+            np.testing.assert_array_equal(output["segments"][channel], reference["segments"][channel])
+
+            for metric, values in reference["peaks"][channel].items():
+                np.testing.assert_array_equal(output["peaks"][channel][metric], values)
+
+
+def test_auto_range_and_sigma_threshold_do_not_depend_on_block_size(events):
+    outputs = []
+
+    for block_size in (333, 1000):
+        set_random_seed(7)
+        pipeline = build_pipeline(block_size, threshold="3sigma", use_auto_range=True)
+        pipeline.warm_up_samples = 1500
+
+        assert pipeline.warm_up_samples == 1500
+        outputs.append(pipeline.run(run_time=RUN_TIME, **events))
+
+    output, reference = outputs
+
+    assert len(reference["start_index"]) > 0
+    np.testing.assert_array_equal(output["start_index"], reference["start_index"])
+
+    for channel in ("forward", "side"):
+        np.testing.assert_array_equal(output["segments"][channel], reference["segments"][channel])
+
+        for metric, values in reference["peaks"][channel].items():
+            np.testing.assert_array_equal(output["peaks"][channel][metric], values)
+
+
+def test_float32_blocks_match_float64(events):
+    reference = run(1000, events)
+
+    set_random_seed(7)
+    pipeline = build_pipeline(1000)
+    pipeline.precision = "float32"
+    output = pipeline.run(run_time=RUN_TIME, **events)
+
+    assert pipeline.precision == "float32"
+    np.testing.assert_array_equal(output["start_index"], reference["start_index"])
+
+    for channel in ("forward", "side"):
+        np.testing.assert_allclose(
+            np.asarray(output["peaks"][channel]["Height"]),
+            np.asarray(reference["peaks"][channel]["Height"]),
+            rtol=1e-3,
+        )
+
+
+def test_output_does_not_depend_on_thread_settings(events):
+    reference = run(1000, events)
+
+    try:
+        set_threads(number_of_threads=2, grain_sizes={"noise": 0, "digitizer": 1 << 30})
+        output = run(1000, events)
+    finally:
+        set_threads()
+
+    np.testing.assert_array_equal(output["start_index"], reference["start_index"])
+
+    for channel in ("forward", "side"):
+        np.testing.assert_array_equal(output["segments"][channel], reference["segments"][channel])
+
+    with pytest.raises(ValueError):
+        set_threads(grain_sizes={"unknown": 1})
+
+    set_threads()
+
+
+def test_unknown_precision_is_rejected():
+    with pytest.raises(ValueError):
+        build_pipeline(1000).precision = "float16"
+
+
+def test_use_device_requires_an_offload_device():
+    pipeline = build_pipeline(1000)
+
+    assert not pipeline.use_device
+
+    if is_offload_device_available():
+        pipeline.use_device = True
+        assert pipeline.use_device
+    else:
+        with pytest.raises(ValueError):
+            pipeline.use_device = True
+
+
+def test_segments_match_their_start_index(events):
+    output = run(1000, events)
+    segments = output["segments"]
+
+    segment_ids = segments["segment_id"]
+    time = segments["Time"].to("second").magnitude
+
+    assert segment_ids.max() + 1 == len(output["start_index"])
+
+    first_samples = np.searchsorted(segment_ids, np.arange(len(output["start_index"])))
+    np.testing.assert_allclose(time[first_samples] * 2e6, output["start_index"], atol=1e-6)
+
+
+def test_segments_can_be_dropped(events):
+    pipeline = build_pipeline(1000)
+    pipeline.keep_segments = False
+
+    output = pipeline.run(run_time=RUN_TIME, **events)
+
+    assert output["segments"] is None
+    assert output["peaks"]["forward"]["Height"].shape[0] == len(output["start_index"])
+
+
+def build_statistics() -> EventStatistics:
+    code_axis = HistogramAxis(1, 4096, 16, logarithmic=True)
+
+    statistics = EventStatistics(relative_accuracy=0.01)
+    statistics.add_histogram("side", "Height", HistogramAxis(0, 4096, 64))
+    statistics.add_histogram_2d("forward", "Height", code_axis, "side", "Height", code_axis)
+    statistics.set_rate_axis(0 * ureg.second, RUN_TIME, 4)
+
+    return statistics
+
+
+def test_event_statistics_match_the_run_metrics(events):
+    statistics = build_statistics()
+
+    pipeline = build_pipeline(1000)
+    pipeline.event_statistics = statistics
+
+    set_random_seed(7)
+    output = pipeline.run(run_time=RUN_TIME, **events)
+    accumulated = output["statistics"]
+
+    heights = np.asarray(output["peaks"]["side"]["Height"]).ravel()
+    heights = heights[np.isfinite(heights)]
+
+    assert pipeline.event_statistics.number_of_events == 0
+    assert accumulated.number_of_events == len(output["start_index"])
+
+    counts, edges = accumulated.get_histogram(0)
+    np.testing.assert_array_equal(counts, np.histogram(heights, bins=edges)[0])
+
+    summary = accumulated.get_summary("side", "Height")
+    assert summary["count"] == heights.size
+    np.testing.assert_allclose(summary["mean"], heights.mean())
+    np.testing.assert_allclose(summary["variance"], heights.var(ddof=1))
+    np.testing.assert_allclose(accumulated.get_quantile("side", "Height", 0.5), np.median(heights), rtol=0.05)
+
+    rates, _ = accumulated.get_rate()
+    np.testing.assert_allclose((rates.sum() * RUN_TIME / 4).to("dimensionless").magnitude, len(output["start_index"]))
+
+    # Offline accumulation of the same metrics, with labels, then a merge.
+    offline = build_statistics()
+    labels = np.arange(len(output["start_index"])) % 2
+    offline.update(output["peaks"], output["start_index"], labels=labels, padding_value=-1)
+
+    np.testing.assert_array_equal(offline.get_histogram_2d(0)[0], accumulated.get_histogram_2d(0)[0])
+    assert offline.labels == [0, 1]
+    assert sum(offline.get_summary("side", "Height", label=label)["count"] for label in (0, 1)) == heights.size
+
+    offline.merge(accumulated)
+    assert offline.number_of_events == 2 * accumulated.number_of_events
+
+    with pytest.raises(RuntimeError):
+        offline.merge(EventStatistics())
+
+
+def test_event_statistics_skip_the_padding_of_missing_peaks(events):
+    statistics = EventStatistics()
+    statistics.add_histogram("side", "Height", HistogramAxis(-2, 4096, 64))
+
+    # Windows of about 60 samples hold 2 or 3 sliding windows, fewer than the 5 peak slots.
+    locator = SlidingWindowPeakLocator(window_size=20, window_step=20, max_number_of_peaks=5, padding_value=-1)
+
+    pipeline = build_pipeline(1000, peak_locator=locator)
+    pipeline.event_statistics = statistics
+
+    set_random_seed(7)
+    output = pipeline.run(run_time=RUN_TIME, **events)
+    accumulated = output["statistics"]
+
+    index = np.asarray(output["peaks"]["side"]["Index"])
+    heights = np.asarray(output["peaks"]["side"]["Height"])
+    located = heights[index != -1]
+
+    assert np.any(index == -1)
+
+    summary = accumulated.get_summary("side", "Height")
+    assert summary["count"] == located.size
+    assert summary["min"] == located.min()
+    np.testing.assert_allclose(summary["mean"], located.mean())
+
+    counts, edges = accumulated.get_histogram(0)
+    np.testing.assert_array_equal(counts, np.histogram(located, bins=edges)[0])
+
+    # Offline accumulation counts the padding unless told its value.
+    offline = EventStatistics()
+    offline.update(output["peaks"], output["start_index"], padding_value=-1)
+    assert offline.get_summary("side", "Height")["count"] == located.size
+
+    offline.reset()
+    offline.update(output["peaks"], output["start_index"])
+    assert offline.get_summary("side", "Height")["count"] == heights.size
+
+
+def test_event_statistics_do_not_depend_on_the_number_of_threads():
+    rng = np.random.default_rng(5)
+    number_of_events = 50_000
+    peaks = {"side": {"Height": rng.normal(100.0, 7.0, (number_of_events, 2))}}
+    start_index = np.arange(number_of_events) * 10
+
+    summaries = []
+
+    try:
+        for number_of_threads in (1, 2, 3):
+            set_threads(number_of_threads=number_of_threads, grain_sizes={"peak_locator": 0})
+
+            statistics = EventStatistics()
+            statistics.update(peaks, start_index)
+            statistics.update(peaks, start_index)
+            summaries.append(statistics.get_summary("side", "Height"))
+
+    finally:
+        set_threads()
+
+    for summary in summaries[1:]:
+        assert summary == summaries[0]
+
+
+def test_inconsistent_events_are_rejected(events):
+    events["amplitudes"] = events["amplitudes"][:, :1]
+
+    with pytest.raises(RuntimeError):
+        build_pipeline(1000).run(run_time=RUN_TIME, **events)
+
+
+def test_sweep_matches_sequential_runs(events):
+    pipelines = [build_pipeline(1000, threshold * ureg.millivolt) for threshold in (1, 2, 4, 8)]
+
+    set_random_seed(11)
+    sequential = [pipeline.run(run_time=RUN_TIME, **events) for pipeline in pipelines]
+
+    sweep = AcquisitionSweep()
+    events_index = sweep.add_events(**events)
+
+    for pipeline in pipelines:
+        sweep.add_run(pipeline, events_index, RUN_TIME)
+
+    assert sweep.number_of_runs == len(pipelines)
+    assert sweep.number_of_event_sets == 1
+
+    set_random_seed(11)
+    swept = sweep.run()
+
+    for output, reference in zip(swept, sequential):
+        np.testing.assert_array_equal(output["start_index"], reference["start_index"])
+        np.testing.assert_array_equal(output["segments"]["forward"], reference["segments"]["forward"])
+        np.testing.assert_array_equal(output["peaks"]["side"]["Height"], reference["peaks"]["side"]["Height"])
+
+
+def test_sweep_rejects_unknown_event_set():
+    sweep = AcquisitionSweep()
+
+    with pytest.raises(IndexError):
+        sweep.add_run(build_pipeline(1000), 0, RUN_TIME)
+
+
+def test_sweep_rejects_runs_spilling_to_the_same_file(events, tmp_path):
+    first, second = build_pipeline(1000), build_pipeline(1000)
+    first.spill_filename = tmp_path / "run.fcacq"
+    second.spill_filename = tmp_path / "." / "run.fcacq"
+
+    sweep = AcquisitionSweep()
+    events_index = sweep.add_events(**events)
+    sweep.add_run(first, events_index, RUN_TIME)
+    sweep.add_run(second, events_index, RUN_TIME)
+
+    with pytest.raises(ValueError):
+        sweep.run()
+
+    assert not (tmp_path / "run.fcacq").exists()
+
+    sweep.clear()
+    events_index = sweep.add_events(**events)
+    sweep.add_run(first, events_index, RUN_TIME)
+    sweep.add_run(first, events_index, RUN_TIME)
+
+    with pytest.raises(ValueError):
+        sweep.run()
+
+
+def test_spilled_file_holds_the_run(events, tmp_path):
+    pipeline = build_pipeline(1000)
+    pipeline.spill_filename = tmp_path / "run.fcacq"
+
+    set_random_seed(7)
+    output = pipeline.run(run_time=RUN_TIME, **events)
+
+    reader = AcquisitionFileReader(tmp_path / "run.fcacq")
+
+    assert reader.channel_names == ["forward", "side"]
+    assert reader.number_of_samples == output["number_of_samples"]
+    assert reader.number_of_chunks == output["number_of_blocks"]
+    assert reader.code_type == "uint16"
+    np.testing.assert_array_equal(reader.events["start_index"], output["start_index"])
+
+    spill = output["spill"]
+    assert spill["number_of_chunks"] == output["number_of_blocks"]
+    assert spill["number_of_events"] == len(output["start_index"])
+    assert spill["file_size"] == (tmp_path / "run.fcacq").stat().st_size
+
+    for channel in ("forward", "side"):
+        for metric, values in output["peaks"][channel].items():
+            np.testing.assert_array_equal(reader.event_metrics[channel][metric], values)
+
+    segment_ids = output["segments"]["segment_id"]
+
+    for window, start in enumerate(output["start_index"]):
+        length = reader.events["number_of_samples"][window]
+        codes = reader.read_codes("side", start=start, count=length)
+
+        np.testing.assert_array_equal(codes, output["segments"]["side"][segment_ids == window])
+
+
+def test_spilled_file_does_not_depend_on_queue_depth(events, tmp_path):
+    contents = []
+
+    # A depth of 1 stalls the producer and the I/O thread on every block.
+    for queue_depth in (1, 8):
+        pipeline = build_pipeline(333)
+        pipeline.queue_depth = queue_depth
+        pipeline.spill_filename = tmp_path / f"depth_{queue_depth}.fcacq"
+
+        set_random_seed(7)
+        output = pipeline.run(run_time=RUN_TIME, **events)
+
+        assert output["spill"]["number_of_chunks"] == output["number_of_blocks"] > 8
+        contents.append((tmp_path / f"depth_{queue_depth}.fcacq").read_bytes())
+
+    assert contents[0] == contents[1]
+
+
+def test_spill_errors_reach_the_caller(events, tmp_path):
+    pipeline = build_pipeline(333)
+    pipeline.spill_filename = tmp_path / "missing" / "run.fcacq"
+
+    with pytest.raises(RuntimeError):
+        pipeline.run(run_time=RUN_TIME, **events)
+
+
+@pytest.mark.skipif(not os.path.exists("/dev/full"), reason="needs /dev/full")
+def test_io_thread_errors_reach_the_caller(events):
+    # /dev/full opens, but every write fails on the I/O thread.
+    pipeline = build_pipeline(333)
+    pipeline.queue_depth = 1
+    pipeline.spill_filename = "/dev/full"
+
+    with pytest.raises(RuntimeError):
+        pipeline.run(run_time=RUN_TIME, **events)
+
+
+def test_replay_reprocesses_an_archived_run(events, tmp_path):
+    pipeline = build_pipeline(1000)
+    pipeline.spill_filename = tmp_path / "run.fcacq"
+
+    set_random_seed(7)
+    pipeline.run(run_time=RUN_TIME, **events)
+
+    reader = AcquisitionFileReader(tmp_path / "run.fcacq")
+    peak_locator = GlobalPeakLocator(compute_width=True, compute_area=True)
+
+    def replay_with(threshold, block_size=1000):
+        discriminator = FixedWindow(trigger_channel="forward", threshold=threshold, pre_buffer=20, post_buffer=20)
+        return replay(reader, discriminator, peak_locator, block_size=block_size)
+
+    reference = replay_with(2 * ureg.millivolt)
+
+    assert len(reference["start_index"]) > 0
+
+    output = replay_with(2 * ureg.millivolt, block_size=333)
+    np.testing.assert_array_equal(output["start_index"], reference["start_index"])
+    np.testing.assert_array_equal(output["peaks"]["side"]["Height"], reference["peaks"]["side"]["Height"])
+
+    assert len(replay_with(4 * ureg.millivolt)["start_index"]) <= len(reference["start_index"])
+
+
+if __name__ == "__main__":
+    pytest.main(["-W error", __file__])
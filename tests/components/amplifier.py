@@ -1,6 +1,7 @@
 import math
 import numpy as np
 import pytest
+from FlowCyPy.opto_electronics import amplifier as amplifier_module
 from FlowCyPy.opto_electronics.amplifier import Amplifier
 from pint import UnitRegistry
 
@@ -206,5 +207,28 @@ def test_reject_current_noise_density_with_wrong_units():
         )
 
 
+
+def test_seeded_noise_is_reproducible():
+    amplifier = Amplifier(
+        gain=1e6 * ureg.ohm,
+        bandwidth=20e6 * ureg.hertz,
+        voltage_noise_density=4e-9 * ureg.volt / ureg.hertz**0.5,
+        current_noise_density=2e-15 * ureg.ampere / ureg.hertz**0.5,
+    )
+    signal = np.zeros(10_000) * ureg.ampere
+
+    amplifier_module.set_random_seed(1234)
+    first = amplifier.amplify(signal, sampling_rate=None).magnitude
+    second = amplifier.amplify(signal, sampling_rate=None).magnitude
+
+    amplifier_module.set_random_seed(1234)
+    replay = amplifier.amplify(signal, sampling_rate=None).magnitude
+
+    assert amplifier_module.get_random_seed() == 1234
+    np.testing.assert_array_equal(first, replay)
+    assert not np.array_equal(first, second)
+    assert np.std(first) == pytest.approx(amplifier.get_rms_noise().to("volt").magnitude, rel=0.05)
+
+
 if __name__ == "__main__":
     pytest.main(["-s", "-W", "error", __file__])
@@ -0,0 +1,169 @@
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+import pytest
+from pint import UnitRegistry
+
+from FlowCyPy.opto_electronics import circuits
+from FlowCyPy.opto_electronics.amplifier import Amplifier
+
+
+ureg = UnitRegistry()
+
+
+@pytest.mark.parametrize("circuit_class", [circuits.ButterworthLowPass, circuits.BesselLowPass])
+def test_iir_lowpass_preserves_dc_and_attenuates_high_frequency(circuit_class):
+    sampling_rate = 100e6 * ureg.hertz
+    time = np.arange(20_000) / sampling_rate.magnitude
+
+    circuit = circuit_class(
+        cutoff_frequency=1 * ureg.megahertz,
+        order=4,
+        gain=2.0,
+        implementation="iir",
+    )
+
+    assert circuit.implementation == "iir"
+
+    dc_output = circuit.process(np.ones_like(time) * ureg.volt, sampling_rate)
+    assert dc_output.units == ureg.volt
+    assert dc_output.magnitude[-1] == pytest.approx(2.0, rel=1e-9)
+
+    tone = np.sin(2 * np.pi * 20e6 * time) * ureg.volt
+    tone_output = circuit.process(tone, sampling_rate).magnitude
+
+    assert np.max(np.abs(tone_output[10_000:])) < 0.05
+
+
+def test_iir_lowpass_is_causal():
+    sampling_rate = 100e6 * ureg.hertz
+    signal = np.zeros(4096)
+    signal[2048] = 1.0
+
+    circuit = circuits.BesselLowPass(
+        cutoff_frequency=2 * ureg.megahertz,
+        order=4,
+        gain=1.0,
+        implementation="iir",
+    )
+
+    output = circuit.process(signal * ureg.volt, sampling_rate).magnitude
+
+    assert np.all(output[:2048] == 0.0)
+    assert np.sum(output) == pytest.approx(1.0, rel=1e-3)
+
+
+def test_lowpass_implementation_is_validated():
+    with pytest.raises(ValueError):
+        circuits.ButterworthLowPass(
+            cutoff_frequency=1 * ureg.megahertz,
+            order=2,
+            gain=1.0,
+            implementation="analog",
+        )
+
+
+
+def test_sliding_minimum_uses_inclusive_window():
+    sampling_rate = 1 * ureg.megahertz
+    window_in_samples = 25
+    rng = np.random.default_rng(1)
+    signal = rng.normal(size=2_000)
+
+    circuit = circuits.SlidingMinimumBaselineCorrection(window_size=window_in_samples * ureg.microsecond)
+    output = circuit.process(signal * ureg.volt, sampling_rate).magnitude
+
+    expected = np.array([
+        signal[index] - signal[max(0, index - window_in_samples):index + 1].min()
+        for index in range(signal.size)
+    ])
+
+    np.testing.assert_allclose(output, expected, rtol=0, atol=0)
+
+
+def _process_in_chunks(circuit, signal, sampling_rate, chunk_size):
+    circuit.reset()
+    chunks = [
+        circuit.process_chunk(signal[start:start + chunk_size], sampling_rate).magnitude
+        for start in range(0, signal.size, chunk_size)
+    ]
+    return np.concatenate(chunks)
+
+
+@pytest.mark.parametrize(
+    "circuit",
+    [
+        circuits.SlidingMinimumBaselineCorrection(window_size=2 * ureg.microsecond),
+        circuits.SlidingMinimumBaselineCorrection(window_size=-1 * ureg.second),
+        circuits.BaselineRestorationServo(time_constant=5 * ureg.microsecond),
+        circuits.BesselLowPass(cutoff_frequency=2 * ureg.megahertz, order=4, gain=1.5, implementation="iir"),
+        circuits.CircuitChain(
+            [
+                circuits.BaselineRestorationServo(time_constant=5 * ureg.microsecond),
+                circuits.ButterworthLowPass(cutoff_frequency=3 * ureg.megahertz, order=2, gain=1.0, implementation="iir"),
+            ]
+        ),
+    ],
+)
+def test_process_chunk_matches_single_pass(circuit):
+    sampling_rate = 100e6 * ureg.hertz
+    rng = np.random.default_rng(0)
+    signal = rng.normal(size=5_000) + np.linspace(0, 3, 5_000)
+
+    reference = circuit.process(signal * ureg.volt, sampling_rate).magnitude
+    chunked = _process_in_chunks(circuit, signal * ureg.volt, sampling_rate, chunk_size=777)
+
+    np.testing.assert_allclose(chunked, reference, rtol=0, atol=1e-12)
+
+
+def test_process_chunk_requires_iir_lowpass():
+    circuit = circuits.BesselLowPass(cutoff_frequency=2 * ureg.megahertz, order=4, gain=1.0)
+
+    with pytest.raises(RuntimeError):
+        circuit.process_chunk(np.zeros(16) * ureg.volt, 100e6 * ureg.hertz)
+
+
+def test_process_accepts_strided_and_integer_arrays_without_touching_input():
+    sampling_rate = 100e6 * ureg.hertz
+    circuit = circuits.BesselLowPass(cutoff_frequency=2 * ureg.megahertz, order=4, gain=1.0, implementation="iir")
+
+    samples = np.arange(2_000) % 7
+    reference = circuit.process(samples.astype(float) * ureg.volt, sampling_rate).magnitude
+
+    np.testing.assert_array_equal(circuit.process(samples * ureg.volt, sampling_rate).magnitude, reference)
+
+    strided = np.repeat(samples.astype(float), 2)[::2]
+    np.testing.assert_array_equal(circuit.process(strided * ureg.volt, sampling_rate).magnitude, reference)
+
+    signal = samples.astype(float)
+    output = circuit.process_chunk(signal * ureg.volt, sampling_rate).magnitude
+    assert isinstance(output, np.ndarray)
+    np.testing.assert_array_equal(signal, samples)
+
+
+def test_fft_filters_from_concurrent_threads_match_serial_runs():
+    # Circuits and amplifiers each cache their own plans but share the FFTW planner.
+    sampling_rate = 100e6 * ureg.hertz
+    rng = np.random.default_rng(5)
+    signals = [rng.normal(size=1_000 + 37 * index) for index in range(16)]
+
+    def lowpass(signal):
+        circuit = circuits.ButterworthLowPass(cutoff_frequency=1 * ureg.megahertz, order=4, gain=1.0)
+        return circuit.process(signal * ureg.volt, sampling_rate).magnitude
+
+    def amplify(signal):
+        amplifier = Amplifier(gain=1e4 * ureg.ohm, bandwidth=2 * ureg.megahertz)
+        return amplifier.amplify(signal * ureg.ampere, sampling_rate).magnitude
+
+    # Every size is new, so the threads plan concurrently rather than reuse cached plans.
+    tasks = [(function, signal) for signal in signals for function in (lowpass, amplify)]
+
+    with ThreadPoolExecutor(max_workers=8) as executor:
+        outputs = list(executor.map(lambda task: task[0](task[1]), tasks))
+
+    for (function, signal), output in zip(tasks, outputs):
+        np.testing.assert_array_equal(output, function(signal))
+
+
+if __name__ == "__main__":
+    pytest.main(["-W", "error", "-s", __file__])
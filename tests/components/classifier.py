@@ -255,6 +255,68 @@ def test_kmeans_empty_matrix():
         )
 
 
+def test_kmeans_mini_batch_separates_two_blobs():
+    """
+    Mini-batch and full KmeansClassifier runs should both recover two well separated blobs.
+    """
+    number_of_samples_per_blob = 400
+    dataframe = make_two_blob_wide_dataframe(
+        number_of_samples_per_blob=number_of_samples_per_blob,
+        random_seed=321,
+    )
+
+    for classifier in (KmeansClassifier(2), KmeansClassifier(2, max_iterations=50, batch_size=64)):
+        classified = classifier.run(
+            dataframe=dataframe.copy(),
+            features=["Height"],
+            detectors=["forward", "side"],
+            random_state=7,
+        )
+
+        event_labels = (
+            classified["Label"].groupby(level=["SegmentID", "PeakID"]).first().to_numpy()
+        )
+
+        labels_blob_a = event_labels[:number_of_samples_per_blob]
+        labels_blob_b = event_labels[number_of_samples_per_blob:]
+
+        assert np.unique(labels_blob_a).size == 1
+        assert np.unique(labels_blob_b).size == 1
+        assert labels_blob_a[0] != labels_blob_b[0]
+
+
+def test_kmeans_online_assignment_follows_fitted_centroids():
+    """
+    KmeansClassifier.assign should reproduce the warm-up labels, and assign_and_update should track a drifting blob.
+    """
+    random_generator = np.random.default_rng(3)
+
+    warm_up = np.vstack(
+        [
+            random_generator.normal(loc=0.0, scale=0.1, size=(200, 2)),
+            random_generator.normal(loc=5.0, scale=0.1, size=(200, 2)),
+        ]
+    )
+
+    classifier = KmeansClassifier(2)
+    warm_up_labels = classifier.fit(warm_up, random_state=1)
+
+    assert np.array_equal(classifier.assign(warm_up), warm_up_labels)
+    assert classifier.centroids.shape == (2, 2)
+
+    drifted_label = classifier.assign(np.array([[5.0, 5.0]]))[0]
+    classifier.learning_rate = 0.05
+
+    for offset in np.linspace(0.0, 1.0, 20):
+        block = random_generator.normal(loc=5.0 + offset, scale=0.1, size=(50, 2))
+        assert np.all(classifier.assign_and_update(block) == drifted_label)
+
+    assert np.allclose(classifier.centroids[drifted_label], [6.0, 6.0], atol=0.1)
+
+    with pytest.raises(RuntimeError):
+        classifier.assign(np.zeros((3, 4)))
+
+
 def test_dbscan_two_blobs_clustering():
     """
     DBScanClassifier should find two main clusters on a simple two blob dataset.
@@ -340,6 +402,73 @@ def test_dbscan_noise_points_detected():
     assert np.all(noise_labels == -1)
 
 
+def test_dbscan_many_features_and_non_finite_values():
+    """
+    DBScanClassifier should separate blobs in more than four features and label non finite events as noise.
+    """
+    random_generator = np.random.default_rng(11)
+
+    features = ["Height", "Width", "Area"]
+    number_of_samples_per_blob = 60
+
+    blob_a = random_generator.normal(loc=0.0, scale=0.1, size=(number_of_samples_per_blob, 6))
+    blob_b = random_generator.normal(loc=2.0, scale=0.1, size=(number_of_samples_per_blob, 6))
+
+    data_matrix = np.vstack([blob_a, blob_b, np.full((1, 6), np.nan)])
+    data_matrix[0, 3] = np.inf
+
+    dataframe = make_wide_dataframe(
+        data_matrix=data_matrix,
+        features=features,
+        detectors=["forward", "side"],
+    )
+
+    classifier = DBScanClassifier(epsilon=0.6, minimum_samples=5)
+    classified = classifier.run(
+        dataframe=dataframe,
+        features=features,
+        detectors=["forward", "side"],
+    )
+
+    event_labels = (
+        classified["Label"].groupby(level=["SegmentID", "PeakID"]).first().to_numpy()
+    )
+
+    assert event_labels[0] == -1
+    assert event_labels[-1] == -1
+
+    labels_blob_a = event_labels[1:number_of_samples_per_blob]
+    labels_blob_b = event_labels[number_of_samples_per_blob:-1]
+
+    assert np.all(labels_blob_a == 0)
+    assert np.all(labels_blob_b == 1)
+
+
+def test_dbscan_online_assignment_uses_fitted_core_points():
+    """
+    DBScanClassifier.assign should reproduce the warm-up labels and label far away events as noise.
+    """
+    random_generator = np.random.default_rng(8)
+
+    warm_up = np.vstack(
+        [
+            random_generator.normal(loc=0.0, scale=0.2, size=(100, 2)),
+            random_generator.normal(loc=4.0, scale=0.2, size=(100, 2)),
+        ]
+    )
+
+    classifier = DBScanClassifier(epsilon=0.5, minimum_samples=5)
+    warm_up_labels = classifier.fit(warm_up)
+
+    assert np.array_equal(classifier.assign(warm_up), warm_up_labels)
+
+    labels = classifier.assign(np.array([[0.05, -0.05], [4.1, 3.9], [20.0, 20.0]]))
+
+    assert labels[0] == warm_up_labels[0]
+    assert labels[1] == warm_up_labels[-1]
+    assert labels[2] == -1
+
+
 def test_dbscan_repeated_run_is_deterministic():
     """
     DBScanClassifier should be deterministic for the same parameters and data.
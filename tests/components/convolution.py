@@ -0,0 +1,63 @@
+import numpy as np
+import pytest
+
+from FlowCyPy.binary import utils
+
+
+THRESHOLD = utils.fft_convolution_kernel_threshold
+
+
+def reflected_correlation(signal: np.ndarray, kernel: np.ndarray) -> np.ndarray:
+    """Definition of the kernel: indices are mirrored about the end samples without repeating them."""
+    size, width = signal.size, kernel.size
+    indices = np.arange(size)[:, None] + np.arange(width)[None, :] - width // 2
+
+    if size == 1:
+        indices = np.zeros_like(indices)
+    else:
+        period = 2 * size - 2
+        indices = np.mod(indices, period)
+        indices = np.where(indices < size, indices, period - indices)
+
+    return (signal[indices] * kernel).sum(axis=1)
+
+
+def convolve(signal: np.ndarray, kernel: np.ndarray, **kwargs) -> np.ndarray:
+    return np.asarray(utils.convolve_with_reflected_boundaries(signal, kernel, **kwargs))
+
+
+@pytest.mark.parametrize("width", [THRESHOLD - 1, THRESHOLD, THRESHOLD + 1, 4 * THRESHOLD + 3])
+def test_fft_path_matches_direct_path(width):
+    rng = np.random.default_rng(width)
+    signal = rng.normal(size=5_000)
+    kernel = rng.normal(size=width)  # asymmetric, so a flipped kernel would show
+
+    reference = reflected_correlation(signal, kernel)
+    direct = convolve(signal, kernel, fft_threshold=10**9)
+    fft = convolve(signal, kernel, fft_threshold=1)
+    default = convolve(signal, kernel)
+
+    np.testing.assert_allclose(direct, reference, rtol=0, atol=1e-10)
+    np.testing.assert_allclose(fft, direct, rtol=0, atol=1e-10)
+    np.testing.assert_array_equal(default, fft if width >= THRESHOLD else direct)
+
+
+@pytest.mark.parametrize("size", [1, 2, 50])
+def test_kernel_wider_than_the_signal(size):
+    rng = np.random.default_rng(size)
+    signal = rng.normal(size=size)
+    kernel = rng.normal(size=2 * THRESHOLD + 1)
+
+    np.testing.assert_allclose(convolve(signal, kernel, fft_threshold=1), reflected_correlation(signal, kernel), rtol=0, atol=1e-10)
+
+
+def test_empty_inputs_are_rejected():
+    with pytest.raises(RuntimeError):
+        utils.convolve_with_reflected_boundaries([], [1.0])
+
+    with pytest.raises(RuntimeError):
+        utils.convolve_with_reflected_boundaries([1.0], [])
+
+
+if __name__ == "__main__":
+    pytest.main(["-W", "error", "-s", __file__])
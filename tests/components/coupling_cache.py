@@ -0,0 +1,167 @@
+import numpy as np
+import pytest
+
+from FlowCyPy.opto_electronics.coupling_cache import CouplingCache
+from FlowCyPy.units import ureg
+
+
+SETUP_KEY = [633e-9, 0.2, 0.0, 0.0, 0.0, 200.0]
+
+
+def smooth_coupling(diameter, refractive_index, medium_refractive_index):
+    return 1e-20 * (1.0 + (diameter / 1e-6) ** 2) * (refractive_index - medium_refractive_index + 1.0)
+
+
+def fill(cache, diameter, refractive_index, medium_refractive_index, function=smooth_coupling):
+    points = cache.get_required_points(SETUP_KEY, diameter, refractive_index, medium_refractive_index)
+
+    if len(points) > 0:
+        cache.insert_points(SETUP_KEY, points, function(points[:, 0], points[:, 1], points[:, 2]))
+
+    return len(points)
+
+
+@pytest.fixture
+def particles():
+    rng = np.random.default_rng(0)
+    diameter = rng.normal(1.0e-6, 2e-8, 2000) * ureg.meter
+    refractive_index = rng.normal(1.44, 0.005, 2000)
+    medium_refractive_index = np.full(2000, 1.33)
+
+    return diameter, refractive_index, medium_refractive_index
+
+
+def test_interpolation_matches_smooth_coupling(particles):
+    cache = CouplingCache(
+        diameter_step=10 * ureg.nanometer,
+        refractive_index_step=0.002,
+        medium_refractive_index_step=0.01,
+        relative_tolerance=1e-3,
+    )
+
+    diameter, refractive_index, medium_refractive_index = particles
+
+    fill(cache, diameter, refractive_index, medium_refractive_index)
+
+    coupling = cache.interpolate(SETUP_KEY, diameter, refractive_index, medium_refractive_index)
+    expected = smooth_coupling(diameter.to("meter").magnitude, refractive_index, medium_refractive_index)
+
+    assert not np.any(np.isnan(coupling))
+    np.testing.assert_allclose(coupling, expected, rtol=1e-3)
+
+
+def test_filled_cache_requires_no_new_points(particles):
+    cache = CouplingCache(
+        diameter_step=10 * ureg.nanometer,
+        refractive_index_step=0.002,
+        medium_refractive_index_step=0.01,
+    )
+
+    diameter, refractive_index, medium_refractive_index = particles
+
+    first_fill = fill(cache, diameter, refractive_index, medium_refractive_index)
+
+    assert first_fill == cache.number_of_points
+    assert fill(cache, diameter, refractive_index, medium_refractive_index) == 0
+    assert len(cache.get_required_points([450e-9] + SETUP_KEY[1:], diameter, refractive_index, medium_refractive_index)) == first_fill
+
+
+def test_cells_outside_tolerance_are_not_interpolated(particles):
+    cache = CouplingCache(
+        diameter_step=200 * ureg.nanometer,
+        refractive_index_step=0.05,
+        medium_refractive_index_step=0.05,
+        relative_tolerance=1e-6,
+    )
+
+    diameter, refractive_index, medium_refractive_index = particles
+
+    def resonant_coupling(d, n, m):
+        return 1e-20 * (1.5 + np.sin(d / 3e-8))
+
+    fill(cache, diameter, refractive_index, medium_refractive_index, resonant_coupling)
+
+    coupling = cache.interpolate(SETUP_KEY, diameter, refractive_index, medium_refractive_index)
+
+    assert np.all(np.isnan(coupling))
+
+
+def test_unknown_setup_is_not_interpolated(particles):
+    cache = CouplingCache(
+        diameter_step=10 * ureg.nanometer,
+        refractive_index_step=0.002,
+        medium_refractive_index_step=0.01,
+    )
+
+    diameter, refractive_index, medium_refractive_index = particles
+
+    coupling = cache.interpolate(SETUP_KEY, diameter, refractive_index, medium_refractive_index)
+
+    assert np.all(np.isnan(coupling))
+
+
+def test_save_and_load_round_trip(tmp_path, particles):
+    cache = CouplingCache(
+        diameter_step=10 * ureg.nanometer,
+        refractive_index_step=0.002,
+        medium_refractive_index_step=0.01,
+    )
+
+    diameter, refractive_index, medium_refractive_index = particles
+
+    fill(cache, diameter, refractive_index, medium_refractive_index)
+
+    filename = str(tmp_path / "coupling.cache")
+    cache.save(filename)
+
+    loaded = CouplingCache.load(filename)
+
+    assert loaded.number_of_points == cache.number_of_points
+    assert loaded.relative_tolerance == cache.relative_tolerance
+    np.testing.assert_array_equal(
+        loaded.interpolate(SETUP_KEY, diameter, refractive_index, medium_refractive_index),
+        cache.interpolate(SETUP_KEY, diameter, refractive_index, medium_refractive_index),
+    )
+
+
+def test_invalid_grid_step():
+    with pytest.raises(ValueError):
+        CouplingCache(
+            diameter_step=0 * ureg.nanometer,
+            refractive_index_step=0.002,
+            medium_refractive_index_step=0.01,
+        )
+
+
+def test_points_off_the_lattice_are_rejected():
+    cache = CouplingCache(
+        diameter_step=10 * ureg.nanometer,
+        refractive_index_step=0.002,
+        medium_refractive_index_step=0.01,
+    )
+
+    with pytest.raises(ValueError):
+        cache.insert_points(SETUP_KEY, np.array([[1.0001e-6, 1.44, 1.33]]), [1e-20])
+
+
+@pytest.mark.parametrize("value", [np.nan, np.inf, -np.inf, 1e300])
+def test_non_finite_particles_are_rejected(value):
+    cache = CouplingCache(
+        diameter_step=10 * ureg.nanometer,
+        refractive_index_step=0.002,
+        medium_refractive_index_step=0.01,
+    )
+
+    diameter = np.array([1.0e-6, 1.0e-6]) * ureg.meter
+    refractive_index = np.array([1.44, value])
+    medium_refractive_index = np.full(2, 1.33)
+
+    with pytest.raises(ValueError):
+        cache.get_required_points(SETUP_KEY, diameter, refractive_index, medium_refractive_index)
+
+    with pytest.raises(ValueError):
+        cache.interpolate(SETUP_KEY, diameter, refractive_index, medium_refractive_index)
+
+
+if __name__ == "__main__":
+    pytest.main(["-W error", __file__])
@@ -2,6 +2,7 @@ import numpy as np
 import pytest
 
 from PyMieSim.units import ureg
+from FlowCyPy.binary.acquisition_buffer import AcquisitionBuffer
 from FlowCyPy.opto_electronics import Digitizer
 
 
@@ -144,6 +145,26 @@ def test_clip_signal_operates_in_place():
     assert np.allclose(signal.to("volt").magnitude, [-0.5, -0.25, 0.25, 0.5])
 
 
+def test_clip_signal_converts_units_once_per_array():
+    digitizer = Digitizer(
+        sampling_rate=100 * ureg.megahertz,
+        bit_depth=0,
+        min_voltage=-0.5 * ureg.volt,
+        max_voltage=0.5 * ureg.volt,
+    )
+
+    signal = np.linspace(-1000.0, 1000.0, 100_001) * ureg.millivolt
+
+    clipped = digitizer.clip_signal(signal)
+    reference = np.clip(signal.to("volt").magnitude, -0.5, 0.5)
+
+    assert np.allclose(clipped.to("volt").magnitude, reference, rtol=0, atol=1e-15)
+    assert np.array_equal(signal.magnitude, np.linspace(-1000.0, 1000.0, 100_001))
+
+    with pytest.raises(ValueError):
+        digitizer.clip_signal(np.zeros(4) * ureg.second)
+
+
 def test_clip_signal_without_voltage_range_leaves_signal_unchanged():
     digitizer = Digitizer(
         sampling_rate=100 * ureg.megahertz,
@@ -356,6 +377,23 @@ def test_get_time_series():
     assert time_series.to("second").magnitude == pytest.approx([0.0, 0.25, 0.5, 0.75])
 
 
+def test_get_time_axis_matches_time_series():
+    digitizer = Digitizer(
+        sampling_rate=4 * ureg.hertz,
+        bit_depth=8,
+    )
+
+    time_axis = digitizer.get_time_axis(1 * ureg.second)
+
+    assert len(time_axis) == 4
+    assert time_axis.start == 0.0
+    assert time_axis.time_step == pytest.approx(0.25)
+    np.testing.assert_array_equal(
+        time_axis.to_array(),
+        digitizer.get_time_series(1 * ureg.second).to("second").magnitude,
+    )
+
+
 def test_set_channel_voltage_range_accepts_volt_quantities():
     digitizer = Digitizer(
         sampling_rate=100 * ureg.megahertz,
@@ -640,5 +678,169 @@ def test_rejects_unitless_signal():
         digitizer.process_signal(np.array([0.0, 0.5, 1.0]))
 
 
+@pytest.mark.parametrize(
+    "bit_depth, output_signed_codes, expected_dtype",
+    [(8, False, np.uint8), (14, True, np.int16), (14, False, np.uint16), (20, True, np.int32)],
+)
+def test_compact_codes_use_narrowest_dtype(bit_depth, output_signed_codes, expected_dtype):
+    digitizer = Digitizer(
+        sampling_rate=100 * ureg.megahertz,
+        bit_depth=bit_depth,
+        min_voltage=-1.0 * ureg.volt,
+        max_voltage=1.0 * ureg.volt,
+        output_signed_codes=output_signed_codes,
+        compact_codes=True,
+    )
+
+    data_dict = {
+        "Time": np.array([0.0, 1.0, 2.0, 3.0]) * ureg.second,
+        "forward": np.array([-2.0, -0.25, 0.5, 2.0]) * ureg.volt,
+    }
+
+    wide_digitizer = Digitizer(
+        sampling_rate=100 * ureg.megahertz,
+        bit_depth=bit_depth,
+        min_voltage=-1.0 * ureg.volt,
+        max_voltage=1.0 * ureg.volt,
+        output_signed_codes=output_signed_codes,
+    )
+
+    compact = digitizer.digitize_data_dict(data_dict)
+    wide = wide_digitizer.digitize_data_dict(data_dict)
+
+    assert digitizer.code_dtype == np.dtype(expected_dtype).name
+    assert compact["forward"].dtype == expected_dtype
+    assert np.array_equal(compact["forward"], wide["forward"])
+
+
+def test_digitize_data_dict_to_codes_returns_code_to_volt_map():
+    digitizer = Digitizer(
+        sampling_rate=100 * ureg.megahertz,
+        bit_depth=12,
+        min_voltage=-1.0 * ureg.volt,
+        max_voltage=1.0 * ureg.volt,
+        output_signed_codes=True,
+    )
+
+    voltages = np.linspace(-1.0, 1.0, 101)
+    data_dict = {
+        "Time": np.arange(voltages.size) * ureg.second,
+        "forward": voltages * ureg.volt,
+    }
+
+    codes, code_to_volt = digitizer.digitize_data_dict_to_codes(data_dict)
+    scale, offset = code_to_volt["forward"]
+
+    reconstructed = scale.to("volt").magnitude * codes["forward"] + offset.to("volt").magnitude
+
+    assert codes["forward"].dtype == np.int16
+    assert np.max(np.abs(reconstructed - voltages)) <= 0.5 * scale.to("volt").magnitude + 1e-12
+
+
+# Dyadic voltages keep the normalization exact, so the codes land exactly on the half steps.
+HALF_STEP = 2.0**-20
+HALF_CODE_VOLTAGES = np.array([0.0, 0.5 - HALF_STEP, 0.5, 0.5 + HALF_STEP, 1.0])
+
+
+@pytest.mark.parametrize(
+    "output_signed_codes, expected",
+    [
+        (False, [0, 127, 128, 128, 255]),     # 127.5 rounds up
+        (True, [-128, -1, -1, 0, 127]),       # -0.5 rounds away from zero
+    ],
+)
+@pytest.mark.parametrize("compact_codes", [False, True])
+def test_half_codes_round_away_from_zero(output_signed_codes, expected, compact_codes):
+    digitizer = Digitizer(
+        sampling_rate=100 * ureg.megahertz,
+        bit_depth=8,
+        min_voltage=0.0 * ureg.volt,
+        max_voltage=1.0 * ureg.volt,
+        output_signed_codes=output_signed_codes,
+        compact_codes=compact_codes,
+    )
+
+    data_dict = {
+        "Time": np.arange(HALF_CODE_VOLTAGES.size) * ureg.second,
+        "forward": HALF_CODE_VOLTAGES * ureg.volt,
+    }
+
+    np.testing.assert_array_equal(digitizer.digitize_signal(HALF_CODE_VOLTAGES * ureg.volt), expected)
+    np.testing.assert_array_equal(digitizer.digitize_data_dict(data_dict)["forward"], expected)
+    np.testing.assert_array_equal(digitizer.digitize_data_dict_to_codes(data_dict)[0]["forward"], expected)
+
+
+@pytest.mark.parametrize(
+    "output_signed_codes, expected",
+    [
+        (False, [0, 1, 2, 3]),
+        (True, [-2, -1, -1, 1]),
+    ],
+)
+def test_auto_range_codes(output_signed_codes, expected):
+    digitizer = Digitizer(
+        sampling_rate=100 * ureg.megahertz,
+        bit_depth=2,
+        use_auto_range=True,
+        output_signed_codes=output_signed_codes,
+        channel_range_mode="per_channel",
+    )
+
+    # The range is [-1, 3] V, so the codes before rounding are 0, 0.75, 1.5 and 3, shifted by -2 when signed.
+    voltages = np.array([-1.0, 0.0, 1.0, 3.0])
+    data_dict = {
+        "Time": np.arange(voltages.size) * ureg.second,
+        "forward": voltages * ureg.volt,
+        "side": 0.5 * voltages * ureg.volt,
+    }
+
+    codes = digitizer.digitize_data_dict(data_dict)
+
+    np.testing.assert_array_equal(codes["forward"], expected)
+    np.testing.assert_array_equal(codes["side"], expected)
+    np.testing.assert_array_equal(digitizer.process_signal(voltages * ureg.volt), expected)
+
+
+def test_nan_samples_in_float_and_integer_outputs():
+    voltages = np.array([-1.0, np.nan, 0.25, 2.0, np.nan])
+    data_dict = {
+        "Time": np.arange(voltages.size) * ureg.second,
+        "forward": voltages * ureg.volt,
+    }
+
+    clipping = Digitizer(
+        sampling_rate=100 * ureg.megahertz,
+        bit_depth=0,
+        min_voltage=0.0 * ureg.volt,
+        max_voltage=1.0 * ureg.volt,
+    )
+
+    np.testing.assert_array_equal(
+        clipping.digitize_data_dict(data_dict)["forward"].to("volt").magnitude,
+        [0.0, np.nan, 0.25, 1.0, np.nan],
+    )
+
+    digitizing = Digitizer(
+        sampling_rate=100 * ureg.megahertz,
+        bit_depth=2,
+        min_voltage=0.0 * ureg.volt,
+        max_voltage=1.0 * ureg.volt,
+    )
+
+    # Codes held as floating point values keep NaN samples.
+    buffer = AcquisitionBuffer.from_dict(data_dict)
+    digitizing.process_acquisition_buffer(buffer)
+    np.testing.assert_array_equal(buffer["forward"], [0.0, np.nan, 1.0, 3.0, np.nan])
+
+    for output_signed_codes in (False, True):
+        digitizing.output_signed_codes = output_signed_codes
+
+        with pytest.raises(RuntimeError):
+            digitizing.digitize_data_dict(data_dict)
+
+        with pytest.raises(RuntimeError):
+            digitizing.digitize_data_dict_to_codes(data_dict)
+
+
 if __name__ == "__main__":
     pytest.main(["-s", "-W", "error", __file__])
@@ -1,7 +1,15 @@
 import numpy as np
 import pytest
 
-from FlowCyPy.digital_processing.discriminator import DoubleThreshold, FixedWindow
+from FlowCyPy.binary.acquisition_buffer import TimeAxis
+from FlowCyPy.digital_processing.discriminator import (
+    DoubleThreshold,
+    DynamicWindow,
+    FixedWindow,
+    NoiseFloorEstimator,
+    OnlineDiscriminator,
+)
+from FlowCyPy.digital_processing.peak_locator import PulseSupport, SlidingWindowPeakLocator
 from FlowCyPy.units import ureg
 
 N_POINTS = 1000
@@ -11,6 +19,31 @@ def make_time() -> ureg.Quantity:
     return np.linspace(0, 1, N_POINTS) * ureg.second
 
 
+def test_run_with_dict_accepts_time_axis():
+    signal = np.zeros(N_POINTS)
+    signal[100:120] = 2.0
+    signal[600:630] = 3.0
+
+    time_axis = TimeAxis(start=1e-3, time_step=1e-6, number_of_samples=N_POINTS)
+
+    def run(time):
+        discriminator = DynamicWindow(
+            trigger_channel="det1",
+            threshold=1.0 * ureg.volt,
+            pre_buffer=5,
+            post_buffer=5,
+        )
+
+        return discriminator.run_with_dict({"Time": time, "det1": signal * ureg.volt})
+
+    from_axis = run(time_axis)
+    from_array = run(time_axis.to_array() * ureg.second)
+
+    np.testing.assert_array_equal(from_axis["segment_id"], from_array["segment_id"])
+    np.testing.assert_array_equal(from_axis["det1"].magnitude, from_array["det1"].magnitude)
+    np.testing.assert_array_equal(from_axis["Time"].magnitude, from_array["Time"].magnitude)
+
+
 def test_fixed_window_run_with_dict_returns_flat_segmented_dictionary():
     time = make_time()
 
@@ -51,6 +84,80 @@ def test_fixed_window_run_with_dict_returns_flat_segmented_dictionary():
     assert len(output["det1"]) > 0
 
 
+def test_fixed_window_segments_are_exposed_as_offsets_ragged_views_and_matrix():
+    det1 = np.zeros(N_POINTS)
+    det2 = np.arange(N_POINTS, dtype=float)
+    det1[[100, 400, 800]] = 2.0
+
+    discriminator = FixedWindow(
+        trigger_channel="det1",
+        threshold=1.0 * ureg.volt,
+        pre_buffer=2,
+        post_buffer=3,
+    )
+
+    output = discriminator.run_with_dict(
+        {"Time": make_time(), "det1": det1 * ureg.volt, "det2": det2 * ureg.volt}
+    )
+
+    trigger = discriminator.trigger
+    offsets = trigger.segment_offsets
+
+    assert np.array_equal(offsets, [0, 6, 12, 18])
+    assert np.array_equal(trigger.segment_ids, output["segment_id"])
+    assert [len(segment) for segment in trigger.get_segments("det2")] == [6, 6, 6]
+
+    matrix = discriminator.get_segment_matrix("det2")
+
+    assert matrix.shape == (3, 6)
+    assert np.array_equal(
+        matrix.to("volt").magnitude,
+        [np.arange(start - 2, start + 4) for start in (100, 400, 800)],
+    )
+    assert not np.shares_memory(matrix.magnitude, trigger.get_segmented_signal("det2"))
+
+
+def test_segment_arrays_outlive_the_next_run():
+    det1 = np.zeros(N_POINTS)
+    det2 = np.arange(N_POINTS, dtype=float)
+    det1[[100, 400, 800]] = 2.0
+
+    discriminator = FixedWindow(
+        trigger_channel="det1",
+        threshold=1.0 * ureg.volt,
+        pre_buffer=2,
+        post_buffer=3,
+    )
+
+    discriminator.run_with_dict({"Time": make_time(), "det1": det1 * ureg.volt, "det2": det2 * ureg.volt})
+
+    trigger = discriminator.trigger
+    matrix = discriminator.get_segment_matrix("det2").to("volt").magnitude
+    segments = trigger.get_segments("det2")
+    signal = trigger.get_segmented_signal("det2")
+    time = trigger.segmented_time
+    offsets = trigger.segment_offsets
+
+    expected = [np.arange(start - 2, start + 4) for start in (100, 400, 800)]
+
+    # Accessors view the buffers of the run instead of copying them.
+    assert np.shares_memory(signal, trigger.get_segmented_signal("det2"))
+    assert np.shares_memory(signal, segments[1])
+    assert np.shares_memory(time, trigger.segmented_time)
+
+    # A longer second run clears and regrows every trigger vector.
+    det1[:] = 0.0
+    det1[50::50] = 2.0
+    discriminator.run_with_dict({"Time": make_time(), "det1": det1 * ureg.volt, "det2": -det2 * ureg.volt})
+
+    assert len(trigger.segment_offsets) > len(offsets)
+    np.testing.assert_array_equal(matrix, expected)
+    np.testing.assert_array_equal(np.concatenate(segments), np.ravel(expected))
+    np.testing.assert_array_equal(signal, np.ravel(expected))
+    np.testing.assert_array_equal(offsets, [0, 6, 12, 18])
+    assert len(time) == 18
+
+
 def test_double_threshold_run_with_dict_detects_expected_segments():
     time = make_time()
 
@@ -136,6 +243,175 @@ def test_double_threshold_simple_triggering_segments_plateaus():
     assert len(np.unique(output["segment_id"])) == 2
 
 
+def test_double_threshold_keeps_plateau_crossing_chunk_boundary_whole():
+    n_points = 200_000
+    time = np.arange(n_points) * ureg.microsecond
+
+    # The trigger engine scans the signal in chunks of 65536 samples.
+    signal = np.zeros(n_points)
+    signal[65_500:65_600] = 3.0
+
+    discriminator = DoubleThreshold(
+        trigger_channel="det1",
+        threshold=2.0 * ureg.volt,
+        pre_buffer=2,
+        post_buffer=3,
+        debounce_enabled=False,
+        min_window_duration=-1,
+    )
+
+    output = discriminator.run_with_dict({"Time": time, "det1": signal * ureg.volt})
+
+    assert np.array_equal(np.unique(output["segment_id"]), [0])
+    assert len(output["segment_id"]) == 100 + 2 + 3
+
+
+def test_fixed_window_matches_serial_reference_on_long_noisy_trace():
+    n_points = 300_000
+    rng = np.random.default_rng(3)
+    signal = rng.normal(size=n_points)
+
+    pre_buffer, post_buffer, threshold = 4, 6, 2.0
+
+    discriminator = FixedWindow(
+        trigger_channel="det1",
+        threshold=threshold * ureg.volt,
+        pre_buffer=pre_buffer,
+        post_buffer=post_buffer,
+    )
+
+    output = discriminator.run_with_dict(
+        {"Time": np.arange(n_points) * ureg.second, "det1": signal * ureg.volt}
+    )
+
+    crossings = np.flatnonzero((signal[:-1] <= threshold) & (signal[1:] > threshold)) + 1
+    expected_starts, last_end = [], -1
+    for index in crossings:
+        start, end = index - pre_buffer, index + post_buffer
+        if start >= 0 and end < n_points and start > last_end:
+            expected_starts.append(start)
+            last_end = end
+
+    segment_ids = np.asarray(output["segment_id"])
+    starts = output["Time"].magnitude[np.r_[0, np.flatnonzero(np.diff(segment_ids)) + 1]]
+
+    assert np.array_equal(starts, expected_starts)
+
+
+def test_sigma_threshold_matches_median_and_mad_of_trigger_channel():
+    rng = np.random.default_rng(1)
+    signal = rng.normal(loc=0.2, scale=0.5, size=N_POINTS)
+
+    discriminator = FixedWindow(
+        trigger_channel="det1",
+        threshold="3sigma",
+        pre_buffer=2,
+        post_buffer=2,
+    )
+    discriminator.run_with_dict({"Time": make_time(), "det1": signal * ureg.volt})
+
+    median = np.median(signal)
+    sigma = np.median(np.abs(signal - median)) / 0.6745
+
+    assert discriminator.threshold.numeric.to("volt").magnitude == pytest.approx(median + 3 * sigma)
+
+
+def test_noise_floor_estimator_is_independent_of_chunking():
+    rng = np.random.default_rng(2)
+    signal = rng.normal(scale=2.0, size=50_000)
+
+    whole = NoiseFloorEstimator(capacity=4096)
+    whole.add_samples(signal)
+
+    chunked = NoiseFloorEstimator(capacity=4096)
+    for chunk in np.array_split(signal, 37):
+        chunked.add_samples(chunk)
+
+    assert chunked.number_of_samples == signal.size
+    assert chunked.stride == whole.stride > 1
+
+    median, sigma = whole.estimate()
+    assert chunked.estimate() == (median, sigma)
+    assert sigma.to("volt").magnitude == pytest.approx(2.0, rel=0.1)
+
+
+@pytest.mark.parametrize("discriminator_class", [FixedWindow, DynamicWindow, DoubleThreshold])
+def test_online_discriminator_matches_batch_run_across_blocks(discriminator_class):
+    rng = np.random.default_rng(3)
+    n_points = 20_000
+    signal = rng.normal(size=n_points) + 3.0 * ((np.arange(n_points) // 40) % 9 == 0)
+    data = {"Time": np.arange(n_points) * ureg.second, "det1": signal * ureg.volt}
+
+    discriminator = discriminator_class(
+        trigger_channel="det1",
+        threshold=1.5 * ureg.volt,
+        pre_buffer=7,
+        post_buffer=11,
+    )
+
+    online = OnlineDiscriminator(discriminator)
+    output = discriminator.run_with_dict(data)
+
+    bounds = np.sort(rng.choice(np.arange(1, n_points), size=150, replace=False))
+    events = []
+    for begin, end in zip(np.r_[0, bounds], np.r_[bounds, n_points]):
+        online.add_block({key: value[begin:end] for key, value in data.items()})
+        events += online.pop_events()
+
+    online.finish()
+    events += online.pop_events()
+
+    segment_ids = np.asarray(output["segment_id"])
+    assert len(events) == len(np.unique(segment_ids)) > 0
+
+    for event in events:
+        mask = segment_ids == event["segment_id"]
+        assert event["start_index"] == output["Time"].magnitude[mask][0]
+        assert np.array_equal(event["det1"].magnitude, output["det1"].magnitude[mask])
+
+
+def test_run_peak_metrics_matches_peak_locator_on_segmented_output():
+    rng = np.random.default_rng(5)
+    n_points = 5_000
+    pulses = 4.0 * ((np.arange(n_points) // 30) % 11 == 0)
+    data = {
+        "Time": np.arange(n_points) * ureg.second,
+        "det1": (rng.normal(size=n_points) + pulses) * ureg.volt,
+        "det2": (rng.normal(size=n_points) + 2.0 * pulses) * ureg.volt,
+    }
+
+    discriminator = DoubleThreshold(
+        trigger_channel="det1",
+        threshold=2.0 * ureg.volt,
+        lower_threshold=0.5 * ureg.volt,
+        pre_buffer=5,
+        post_buffer=5,
+    )
+
+    peak_locator = SlidingWindowPeakLocator(
+        window_size=8,
+        max_number_of_peaks=3,
+        compute_width=True,
+        compute_area=True,
+        support=PulseSupport(channel="default", threshold=0.5),
+    )
+
+    segmented = discriminator.run_with_dict(data)
+    expected = peak_locator.run(
+        {key: np.asarray(getattr(value, "magnitude", value)) for key, value in segmented.items()},
+        trigger_channel="det1",
+    )
+
+    fused = discriminator.run_peak_metrics(data, peak_locator, trigger_channel="det1")
+
+    assert len(expected) > 0
+    for channel in ("det1", "det2"):
+        for metric in ("Index", "Height", "Width", "Area"):
+            assert fused[channel][metric].shape == (len(expected), 3)
+            for segment_id, segment_metrics in expected.items():
+                np.testing.assert_array_equal(fused[channel][metric][segment_id], segment_metrics[channel][metric])
+
+
 def test_run_with_dict_raises_if_time_missing():
     discriminator = DoubleThreshold(
         trigger_channel="det1",
@@ -0,0 +1,118 @@
+import threading
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+import pytest
+from pint import UnitRegistry
+
+from FlowCyPy.opto_electronics import circuits
+
+
+ureg = UnitRegistry()
+
+SIZES = [64, 1_000, 1_024, 4_097]
+
+
+def lowpass(signal: np.ndarray) -> np.ndarray:
+    circuit = circuits.ButterworthLowPass(cutoff_frequency=1 * ureg.megahertz, order=4, gain=1.0)
+    return circuit.process(signal * ureg.volt, 100e6 * ureg.hertz).magnitude
+
+
+@pytest.fixture
+def empty_plan_cache():
+    circuits.clear_fft_plans()
+    yield
+    circuits.set_fftw_planner("estimate")
+    circuits.clear_fft_plans()
+
+
+def test_cached_plans_match_fresh_plans(empty_plan_cache):
+    rng = np.random.default_rng(2)
+    signals = [rng.normal(size=size) for size in SIZES]
+
+    uncached = []
+
+    for signal in signals:
+        circuits.clear_fft_plans()
+        uncached.append(lowpass(signal))
+
+    for signal in signals:
+        lowpass(signal)
+
+    assert circuits.get_number_of_fft_plans() == 2 * len(SIZES)
+
+    for signal, reference in zip(signals, uncached):
+        np.testing.assert_array_equal(lowpass(signal), reference)
+
+    assert circuits.get_number_of_fft_plans() == 2 * len(SIZES)
+
+
+def test_clear_destroys_every_plan(empty_plan_cache):
+    signal = np.random.default_rng(3).normal(size=300)
+    reference = lowpass(signal)
+
+    circuits.warm_up_fft_plans(512)
+    assert circuits.get_number_of_fft_plans() == 4
+
+    circuits.clear_fft_plans()
+    assert circuits.get_number_of_fft_plans() == 0
+
+    np.testing.assert_array_equal(lowpass(signal), reference)
+    assert circuits.get_number_of_fft_plans() == 2
+
+
+def test_clear_while_filtering_from_other_threads(empty_plan_cache):
+    signal = np.random.default_rng(5).normal(size=4_096)
+    reference = lowpass(signal)
+
+    stop = threading.Event()
+
+    def clear_repeatedly():
+        while not stop.is_set():
+            circuits.clear_fft_plans()
+
+    clearer = threading.Thread(target=clear_repeatedly)
+    clearer.start()
+
+    try:
+        with ThreadPoolExecutor(max_workers=4) as executor:
+            outputs = list(executor.map(lambda _: lowpass(signal), range(64)))
+
+    finally:
+        stop.set()
+        clearer.join()
+
+    for output in outputs:
+        np.testing.assert_array_equal(output, reference)
+
+
+def test_measured_plans_match_estimated_plans(empty_plan_cache):
+    signal = np.random.default_rng(4).normal(size=1_000)
+    reference = lowpass(signal)
+
+    assert circuits.get_fftw_planner() == "estimate"
+
+    circuits.set_fftw_planner("measure")
+    circuits.clear_fft_plans()
+
+    assert circuits.get_fftw_planner() == "measure"
+    np.testing.assert_allclose(lowpass(signal), reference, rtol=0, atol=1e-12)
+
+    with pytest.raises(ValueError):
+        circuits.set_fftw_planner("exhaustive")
+
+
+def test_wisdom_round_trip(empty_plan_cache, tmp_path):
+    filename = tmp_path / "plans.wisdom"
+
+    circuits.set_fftw_planner("measure")
+    circuits.warm_up_fft_plans(2_048)
+
+    assert circuits.export_fftw_wisdom(str(filename))
+    assert filename.stat().st_size > 0
+    assert circuits.import_fftw_wisdom(str(filename))
+    assert not circuits.import_fftw_wisdom(str(tmp_path / "missing.wisdom"))
+
+
+if __name__ == "__main__":
+    pytest.main(["-W", "error", "-s", __file__])
@@ -0,0 +1,96 @@
+import numpy as np
+import pytest
+
+from FlowCyPy.opto_electronics.amplifier import Amplifier
+from FlowCyPy.opto_electronics.detector import Detector
+from FlowCyPy.opto_electronics.opto_electronic_chain import OptoElectronicChain
+from FlowCyPy.opto_electronics.source import Gaussian
+from FlowCyPy.units import ureg
+from FlowCyPy import set_random_seed
+
+
+def build_chain(include_noise: bool, sampling_rate=None):
+    source = Gaussian(
+        wavelength=633e-9 * ureg.meter,
+        optical_power=5e-3 * ureg.watt,
+        waist_y=2.0e-6 * ureg.meter,
+        waist_z=4.0e-6 * ureg.meter,
+        rin=-110.0 * ureg.dB_per_Hz,
+        polarization=0.0 * ureg.radian,
+        bandwidth=10 * ureg.megahertz,
+        include_shot_noise=include_noise,
+        include_rin_noise=include_noise,
+    )
+
+    detectors = [
+        Detector(
+            phi_angle=angle * ureg.degree,
+            numerical_aperture=0.2,
+            responsivity=0.8 * ureg.ampere / ureg.watt,
+            dark_current=1e-9 * ureg.ampere if include_noise else 0 * ureg.ampere,
+            name=name,
+        )
+        for angle, name in [(0, "forward"), (90, "side")]
+    ]
+
+    amplifier = Amplifier(
+        gain=1e4 * ureg.ohm,
+        bandwidth=10 * ureg.megahertz,
+        voltage_noise_density=4e-9 * ureg.volt / ureg.hertz**0.5 if include_noise else 0 * ureg.volt / ureg.hertz**0.5,
+    )
+
+    return OptoElectronicChain(
+        source=source,
+        detectors=detectors,
+        amplifier=amplifier,
+        bandwidth=10 * ureg.megahertz,
+        sampling_rate=sampling_rate,
+    )
+
+
+def build_signal_dict(number_of_samples: int = 4096):
+    time = np.arange(number_of_samples) * 1e-8 * ureg.second
+
+    return {
+        "Time": time,
+        "forward": np.full(number_of_samples, 1e-6) * ureg.watt,
+        "side": np.full(number_of_samples, 2e-6) * ureg.watt,
+    }
+
+
+def test_noiseless_chain_applies_responsivity_and_gain():
+    chain = build_chain(include_noise=False)
+
+    output = chain.process(build_signal_dict())
+
+    assert output["forward"].units == ureg.volt
+    assert np.allclose(output["forward"].magnitude, 1e-6 * 0.8 * 1e4)
+    assert np.allclose(output["side"].magnitude, 2e-6 * 0.8 * 1e4)
+
+
+def test_chain_is_reproducible_for_a_seed():
+    chain = build_chain(include_noise=True, sampling_rate=100 * ureg.megahertz)
+
+    set_random_seed(7)
+    first = chain.process(build_signal_dict())
+
+    set_random_seed(7)
+    second = chain.process(build_signal_dict())
+
+    third = chain.process(build_signal_dict())
+
+    assert np.array_equal(first["side"].magnitude, second["side"].magnitude)
+    assert not np.array_equal(first["side"].magnitude, third["side"].magnitude)
+
+
+def test_chain_requires_every_detector_trace():
+    chain = build_chain(include_noise=False)
+    signal_dict = build_signal_dict()
+    del signal_dict["side"]
+
+    with pytest.raises(RuntimeError):
+        chain.process(signal_dict)
+
+
+if __name__ == "__main__":
+    pytest.main(["-W", "error", "-s", __file__])
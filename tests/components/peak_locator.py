@@ -5,6 +5,7 @@ from FlowCyPy.digital_processing.peak_locator import (
     GlobalPeakLocator,
     SlidingWindowPeakLocator,
     FullWindowSupport,
+    PulseSupport,
 )
 
 # ----------------- HELPER FUNCTIONS -----------------
@@ -113,6 +114,48 @@ def test_sliding_window_empty_signal():
     assert np.all(heights == 0.0) or np.all(np.isnan(heights))
 
 
+def test_sliding_window_overlapping_windows_match_brute_force_maxima():
+    rng = np.random.default_rng(7)
+    signal = rng.normal(size=997)
+    window_size, window_step = 31, 4
+
+    locator = SlidingWindowPeakLocator(
+        window_size=window_size, window_step=window_step, max_number_of_peaks=6
+    )
+
+    result = locator.get_metrics(signal)
+
+    starts = np.arange(0, signal.size, window_step)
+    indices = np.array([start + np.argmax(signal[start:start + window_size]) for start in starts])
+    order = np.argsort(-signal[indices], kind="stable")[:6]
+
+    np.testing.assert_array_equal(result["Index"], indices[order])
+    np.testing.assert_array_equal(result["Height"], signal[indices[order]])
+
+
+def test_prefix_sums_match_sample_by_sample_width_and_area():
+    rng = np.random.default_rng(4)
+    x = np.arange(3000)
+    signal = 5.0 * np.exp(-(((x % 600) - 300) / 120.0) ** 2) + 0.05 * rng.normal(size=x.size)
+
+    locator = SlidingWindowPeakLocator(
+        window_size=200,
+        window_step=50,
+        max_number_of_peaks=4,
+        compute_width=True,
+        compute_area=True,
+        support=PulseSupport(channel="default", threshold=0.05),
+    )
+
+    expected = locator.get_metrics(signal)
+    locator.use_prefix_sums = True
+    result = locator.get_metrics(signal)
+
+    np.testing.assert_array_equal(result["Index"], expected["Index"])
+    np.testing.assert_array_equal(result["Width"], expected["Width"])
+    np.testing.assert_allclose(result["Area"], expected["Area"], rtol=1e-12)
+
+
 def test_sliding_window_rejects_non_1d_input():
     locator = SlidingWindowPeakLocator(window_size=10, support=FullWindowSupport())
     bad_input = np.zeros((10, 10))
@@ -198,10 +241,135 @@ def test_global_peak_supports_peak_to_baseline_mode():
     assert result["Height"][0] == 4.0
 
 
+def test_global_peak_supports_absolute_peak_to_peak_mode():
+    signal = np.array([1.0, 1.0, 1.0, -3.0, 1.0, 1.0])
+    locator = GlobalPeakLocator(
+        polarity="absolute",
+        height_mode="peak_to_peak",
+        baseline_mode="segment_mean",
+    )
+
+    result = locator.get_metrics(signal)
+
+    assert (locator.polarity, locator.height_mode, locator.baseline_mode) == ("absolute", "peak_to_peak", "segment_mean")
+    assert result["Index"][0] == 3
+    assert result["Height"][0] == 4.0
+
+
 def test_global_peak_rejects_invalid_measurement_mode():
     with pytest.raises(RuntimeError):
         GlobalPeakLocator(height_mode="not_a_mode")
 
 
+# === Batched segments ===
+
+
+def test_run_batch_matches_segment_dictionary_run():
+    rng = np.random.default_rng(2)
+    lengths = rng.integers(5, 40, size=50)
+    offsets = np.r_[0, np.cumsum(lengths)]
+    signals = {"det1": rng.normal(size=offsets[-1]), "det2": rng.normal(size=offsets[-1])}
+
+    locator = SlidingWindowPeakLocator(
+        window_size=6, max_number_of_peaks=2, compute_width=True, compute_area=True
+    )
+
+    batch = locator.run_batch(offsets, signals)
+
+    segment_ids = np.repeat(np.arange(lengths.size), lengths)
+    expected = locator.run({"segment_id": segment_ids, "Time": segment_ids, **signals})
+
+    for channel in signals:
+        assert batch[channel]["Height"].shape == (lengths.size, 2)
+        for segment_id, segment_metrics in expected.items():
+            for metric, values in segment_metrics[channel].items():
+                np.testing.assert_array_equal(batch[channel][metric][segment_id], values)
+
+
+def test_run_batch_rejects_offsets_not_covering_signals():
+    locator = GlobalPeakLocator()
+
+    with pytest.raises(RuntimeError):
+        locator.run_batch([0, 5, 9], {"det1": np.zeros(10)})
+
+
+def make_batch(seed: int = 3):
+    rng = np.random.default_rng(seed)
+    # Long and short segments alternate, so a reused workspace shrinks and grows between rows.
+    lengths = np.tile([60, 7, 33, 12, 90, 5], 8)
+    offsets = np.r_[0, np.cumsum(lengths)]
+    signals = {"det1": rng.normal(size=offsets[-1]), "det2": rng.normal(size=offsets[-1])}
+
+    return offsets, signals
+
+
+def build_sliding_locator(**kwargs):
+    return SlidingWindowPeakLocator(window_size=10, max_number_of_peaks=4, padding_value=-7, **kwargs)
+
+
+@pytest.mark.parametrize("compute_width, compute_area", [(False, False), (True, False), (False, True)])
+def test_run_batch_leaves_disabled_columns_out(compute_width, compute_area):
+    offsets, signals = make_batch()
+
+    full = build_sliding_locator(compute_width=True, compute_area=True).run_batch(offsets, signals)
+    batch = build_sliding_locator(compute_width=compute_width, compute_area=compute_area).run_batch(offsets, signals)
+
+    expected_metrics = {"Index", "Height"} | ({"Width"} if compute_width else set()) | ({"Area"} if compute_area else set())
+
+    for channel in signals:
+        assert set(batch[channel]) == expected_metrics
+
+        for metric in expected_metrics:
+            np.testing.assert_array_equal(batch[channel][metric], full[channel][metric])
+
+
+def test_run_batch_pads_the_slots_past_the_located_peaks():
+    offsets, signals = make_batch()
+    lengths = np.diff(offsets)
+
+    batch = build_sliding_locator(compute_width=True, compute_area=True).run_batch(offsets, signals)
+
+    # A sliding window locator finds one peak per window of 10 samples, the last window possibly shorter.
+    number_of_peaks = np.minimum(-(-lengths // 10), 4)
+
+    for channel in signals:
+        for metric in ("Index", "Height", "Width", "Area"):
+            values = batch[channel][metric]
+
+            for row, count in enumerate(number_of_peaks):
+                assert np.all(values[row, count:] == -7)
+
+        index = batch[channel]["Index"]
+        for row, count in enumerate(number_of_peaks):
+            assert np.all(index[row, :count] >= 0)
+
+
+@pytest.mark.parametrize("locator_type", ["sliding", "global"])
+def test_reused_workspace_matches_fresh_workspace(locator_type):
+    offsets, signals = make_batch()
+
+    def build():
+        if locator_type == "sliding":
+            return build_sliding_locator(compute_width=True, compute_area=True)
+
+        return GlobalPeakLocator(
+            compute_width=True, compute_area=True, support=PulseSupport(channel="independent", threshold=0.5)
+        )
+
+    reused = build()
+    batch = reused.run_batch(offsets, signals)
+
+    for channel, signal in signals.items():
+        for row, (start, end) in enumerate(zip(offsets[:-1], offsets[1:])):
+            segment = signal[start:end]
+
+            fresh = build().get_metrics(segment)
+            repeated = reused.get_metrics(segment)
+
+            for metric, values in fresh.items():
+                np.testing.assert_array_equal(repeated[metric], values)
+                np.testing.assert_array_equal(batch[channel][metric][row], values)
+
+
 if __name__ == "__main__":
     pytest.main(["-s", "-W", "error", __file__])
@@ -1,5 +1,6 @@
 import math
 
+import numpy as np
 import pytest
 
 
@@ -243,5 +244,200 @@ def test_asymetric_flat_top_rejects_invalid_waists():
         )
 
 
+def test_gaussian_truncated_pulses_match_dense_evaluation():
+    source = Gaussian(
+        wavelength=532e-9 * ureg.meter,
+        optical_power=1e-3 * ureg.watt,
+        waist_y=2e-6 * ureg.meter,
+        waist_z=4e-6 * ureg.meter,
+    )
+
+    time_array = np.linspace(0.0, 2e-4, 20_001) * ureg.second
+    velocities = np.array([0.5, 1.0, 2.0, 1.5]) * ureg.meter / ureg.second
+    pulse_centers = np.array([1e-6, 5e-5, 5.1e-5, 1.99e-4]) * ureg.second
+    pulse_amplitudes = np.array([1e-3, 2e-3, 5e-4, 1e-3]) * ureg.watt
+
+    arguments = dict(
+        velocities=velocities,
+        pulse_centers=pulse_centers,
+        pulse_amplitudes=pulse_amplitudes,
+        time_array=time_array,
+        base_level=1e-4 * ureg.watt,
+    )
+
+    truncated = source.generate_pulses(**arguments).to("watt").magnitude
+
+    source.pulse_support_cutoff = float("inf")
+    dense = source.generate_pulses(**arguments).to("watt").magnitude
+
+    np.testing.assert_allclose(truncated, dense, rtol=0.0, atol=1e-15)
+
+    with pytest.raises(RuntimeError):
+        source.pulse_support_cutoff = 0.0
+
+
+def test_flat_top_pulses_cover_expected_support():
+    source = FlatTop(
+        wavelength=532e-9 * ureg.meter,
+        optical_power=1e-3 * ureg.watt,
+        waist_y=2e-6 * ureg.meter,
+        waist_z=4e-6 * ureg.meter,
+    )
+
+    time = np.linspace(0.0, 1e-4, 10_001)
+    velocities = np.array([1.0, 2.0])
+    pulse_centers = np.array([2e-5, 7e-5])
+    pulse_amplitudes = np.array([1e-3, 3e-3])
+
+    signal = source.generate_pulses(
+        velocities=velocities * ureg.meter / ureg.second,
+        pulse_centers=pulse_centers * ureg.second,
+        pulse_amplitudes=pulse_amplitudes * ureg.watt,
+        time_array=time * ureg.second,
+        base_level=0.0 * ureg.watt,
+    ).to("watt").magnitude
+
+    widths = 4e-6 / (2.0 * velocities)
+    inside = np.abs(time[:, None] - pulse_centers[None, :]) <= widths[None, :] / 2.0
+    expected = inside.astype(float) @ pulse_amplitudes
+
+    np.testing.assert_allclose(signal, expected, rtol=0.0, atol=1e-18)
+
+
+def test_flat_top_overlapping_pulses_match_dense_sum():
+    source = FlatTop(
+        wavelength=532e-9 * ureg.meter,
+        optical_power=1e-3 * ureg.watt,
+        waist_y=2e-6 * ureg.meter,
+        waist_z=4e-6 * ureg.meter,
+    )
+
+    rng = np.random.default_rng(0)
+    time = np.linspace(0.0, 1e-3, 20_001)
+    velocities = rng.uniform(0.005, 0.05, size=200)
+    pulse_centers = np.sort(rng.uniform(-1e-4, 1.1e-3, size=200))
+    pulse_amplitudes = rng.uniform(1e-4, 1e-3, size=200)
+
+    signal = source.generate_pulses(
+        velocities=velocities * ureg.meter / ureg.second,
+        pulse_centers=pulse_centers * ureg.second,
+        pulse_amplitudes=pulse_amplitudes * ureg.watt,
+        time_array=time * ureg.second,
+        base_level=1e-5 * ureg.watt,
+    ).to("watt").magnitude
+
+    widths = 4e-6 / (2.0 * velocities)
+    inside = np.abs(time[:, None] - pulse_centers[None, :]) <= widths[None, :] / 2.0
+    expected = 1e-5 + inside.astype(float) @ pulse_amplitudes
+
+    assert inside.sum(axis=1).max() > 10
+    np.testing.assert_allclose(signal, expected, rtol=1e-12, atol=1e-18)
+
+
+def test_multi_detector_pulses_match_per_detector_generation():
+    source = Gaussian(
+        wavelength=532e-9 * ureg.meter,
+        optical_power=1e-3 * ureg.watt,
+        waist_y=2e-6 * ureg.meter,
+        waist_z=4e-6 * ureg.meter,
+    )
+
+    time_array = np.linspace(0.0, 1e-4, 10_001) * ureg.second
+    velocities = np.array([0.5, 1.0, 2.0]) * ureg.meter / ureg.second
+    pulse_centers = np.array([1e-5, 5e-5, 8e-5]) * ureg.second
+    amplitude_matrix = np.array(
+        [
+            [1e-3, 2e-3],
+            [5e-4, 0.0],
+            [2e-3, 1e-3],
+        ]
+    ) * ureg.watt
+
+    fused = source.generate_multi_detector_pulses(
+        velocities=velocities,
+        pulse_centers=pulse_centers,
+        pulse_amplitudes=amplitude_matrix,
+        time_array=time_array,
+        base_level=1e-5 * ureg.watt,
+    ).to("watt").magnitude
+
+    assert fused.shape == (2, time_array.size)
+
+    for detector_index in range(2):
+        expected = source.generate_pulses(
+            velocities=velocities,
+            pulse_centers=pulse_centers,
+            pulse_amplitudes=amplitude_matrix[:, detector_index],
+            time_array=time_array,
+            base_level=1e-5 * ureg.watt,
+        ).to("watt").magnitude
+
+        np.testing.assert_allclose(fused[detector_index], expected, rtol=1e-12, atol=1e-18)
+
+
+def test_multi_detector_pulses_wrap_around_the_periodic_window():
+    source = Gaussian(
+        wavelength=532e-9 * ureg.meter,
+        optical_power=1e-3 * ureg.watt,
+        waist_y=2e-6 * ureg.meter,
+        waist_z=4e-6 * ureg.meter,
+    )
+
+    period = 1e-4
+    time_array = np.linspace(0.0, period, 10_001) * ureg.second
+    velocities = np.array([0.5, 1.0]) * ureg.meter / ureg.second
+    pulse_centers = np.array([2e-6, 9.9e-5]) * ureg.second
+    amplitude_matrix = np.array(
+        [
+            [1e-3, 2e-3],
+            [2e-3, 5e-4],
+        ]
+    ) * ureg.watt
+
+    wrapped = source.generate_multi_detector_pulses(
+        velocities=velocities,
+        pulse_centers=pulse_centers,
+        pulse_amplitudes=amplitude_matrix,
+        time_array=time_array,
+        base_level=0.0 * ureg.watt,
+        periodic_window=period * ureg.second,
+    ).to("watt").magnitude
+
+    unwrapped = source.generate_multi_detector_pulses(
+        velocities=velocities,
+        pulse_centers=pulse_centers,
+        pulse_amplitudes=amplitude_matrix,
+        time_array=time_array,
+        base_level=0.0 * ureg.watt,
+    ).to("watt").magnitude
+
+    # The pulse centered near the end leaks into the first samples, and the one near the start into the last.
+    assert np.all(wrapped[:, 0] > unwrapped[:, 0])
+    assert np.all(wrapped[:, -1] > unwrapped[:, -1])
+
+    images = np.concatenate([pulse_centers.magnitude + shift for shift in (-period, 0.0, period)]) * ureg.second
+
+    for detector_index in range(2):
+        expected = source.generate_pulses(
+            velocities=np.tile(velocities.magnitude, 3) * velocities.units,
+            pulse_centers=images,
+            pulse_amplitudes=np.tile(amplitude_matrix[:, detector_index].magnitude, 3) * ureg.watt,
+            time_array=time_array,
+            base_level=0.0 * ureg.watt,
+        ).to("watt").magnitude
+
+        np.testing.assert_allclose(wrapped[detector_index], expected, rtol=1e-12, atol=1e-18)
+
+    with pytest.raises(RuntimeError):
+        source.generate_multi_detector_pulses(
+            velocities=velocities,
+            pulse_centers=pulse_centers,
+            pulse_amplitudes=amplitude_matrix,
+            time_array=time_array,
+            base_level=0.0 * ureg.watt,
+            periodic_window=0.0 * ureg.second,
+        )
+
+
 if __name__ == "__main__":
     pytest.main(["-W", "error", "-s", __file__])
@@ -0,0 +1,85 @@
+# -*- coding: utf-8 -*-
+
+import sys
+import types
+
+import pytest
+
+from FlowCyPy import _core_loader
+
+
+# ----------------- HELPERS -----------------
+
+
+class FakeCore:
+    """Stand in for _flowcypy_core, serving one component of a throwaway package."""
+
+    def __init__(self):
+        self.created = []
+
+    def get_module_names(self) -> list:
+        return ["flowcypy_fake_package.component"]
+
+    def create_module(self, name: str) -> types.ModuleType:
+        self.created.append(name)
+
+        module = types.ModuleType(name)
+        module.value = 42
+
+        return module
+
+
+@pytest.fixture
+def fake_core(monkeypatch):
+    package = types.ModuleType("flowcypy_fake_package")
+    package.__path__ = []
+    monkeypatch.setitem(sys.modules, "flowcypy_fake_package", package)
+
+    # A unified build already has its finder installed; keep it out of the way.
+    finders = [finder for finder in sys.meta_path if isinstance(finder, _core_loader._CoreFinder)]
+    _core_loader.uninstall()
+
+    core = FakeCore()
+
+    yield core
+
+    _core_loader.uninstall()
+    sys.modules.pop("flowcypy_fake_package.component", None)
+    sys.meta_path[:0] = finders
+
+
+# ----------------- UNIT TESTS -----------------
+
+
+def test_components_are_created_on_first_import(fake_core):
+    assert _core_loader.install(fake_core)
+    assert _core_loader.is_unified()
+    assert fake_core.created == []
+
+    from flowcypy_fake_package import component
+    import flowcypy_fake_package.component as same_component
+
+    assert component.value == 42
+    assert component is same_component
+    assert component.__spec__.loader is not None
+    assert fake_core.created == ["flowcypy_fake_package.component"]
+
+
+def test_install_is_idempotent(fake_core):
+    _core_loader.install(fake_core)
+    _core_loader.install(fake_core)
+
+    assert sum(isinstance(finder, _core_loader._CoreFinder) for finder in sys.meta_path) == 1
+
+
+def test_other_modules_are_left_to_the_default_finders(fake_core):
+    _core_loader.install(fake_core)
+
+    with pytest.raises(ImportError):
+        import flowcypy_fake_package.missing  # noqa: F401
+
+    assert fake_core.created == []
+
+
+if __name__ == "__main__":
+    pytest.main(["-W error", __file__])
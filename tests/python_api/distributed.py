@@ -0,0 +1,177 @@
+# -*- coding: utf-8 -*-
+
+import os
+import tempfile
+
+import pandas as pd
+import pytest
+
+from FlowCyPy import distributed, set_random_seed
+from FlowCyPy.opto_electronics import circuits
+from FlowCyPy.workflow import (
+    ureg,
+    Workflow,
+    Detector,
+    FlatTop,
+    peak_locator,
+    discriminator,
+    distributions,
+    populations,
+)
+
+
+# ----------------- HELPERS -----------------
+
+
+class SingleRankCommunicator:
+    """Stand in for a one rank mpi4py communicator, so that no MPI runtime is needed."""
+
+    def Get_size(self) -> int:
+        return 1
+
+    def Get_rank(self) -> int:
+        return 0
+
+    def bcast(self, value, root: int = 0):
+        return value
+
+    def gather(self, value, root: int = 0) -> list:
+        return [value]
+
+
+class WorkerRankCommunicator(SingleRankCommunicator):
+    """Rank 1 of two, receiving what rank 0 broadcasts."""
+
+    def __init__(self, broadcast):
+        self.broadcast = broadcast
+
+    def Get_size(self) -> int:
+        return 2
+
+    def Get_rank(self) -> int:
+        return 1
+
+    def bcast(self, value, root: int = 0):
+        return self.broadcast
+
+
+def build_workflow() -> Workflow:
+    population = populations.SpherePopulation(
+        name="Pop 0",
+        medium_refractive_index=distributions.Delta(1.33),
+        concentration=5e9 * ureg.particle / ureg.milliliter,
+        diameter=distributions.Delta(200 * ureg.nanometer),
+        refractive_index=distributions.Delta(1.44),
+    )
+
+    source = FlatTop(
+        waist_z=10e-6 * ureg.meter,
+        waist_y=60e-6 * ureg.meter,
+        wavelength=405 * ureg.nanometer,
+        optical_power=200 * ureg.milliwatt,
+    )
+
+    return Workflow(
+        wavelength=405 * ureg.nanometer,
+        source=source,
+        optical_power=200 * ureg.milliwatt,
+        sample_volume_flow=80 * ureg.microliter / ureg.minute,
+        sheath_volume_flow=1 * ureg.milliliter / ureg.minute,
+        width=200 * ureg.micrometer,
+        height=100 * ureg.micrometer,
+        population_list=[population],
+        gain=10 * ureg.volt / ureg.ampere,
+        bandwidth=10 * ureg.megahertz,
+        bit_depth=14,
+        sampling_rate=60 * ureg.megahertz,
+        detectors=[
+            Detector(name="side", phi_angle=90 * ureg.degree, numerical_aperture=1.2, responsivity=1 * ureg.ampere / ureg.watt),
+            Detector(name="forward", phi_angle=0 * ureg.degree, numerical_aperture=0.3, responsivity=1 * ureg.ampere / ureg.watt),
+        ],
+        discriminator=discriminator.FixedWindow(trigger_channel="forward", threshold="3sigma", pre_buffer=20, post_buffer=20),
+        peak_locator=peak_locator.GlobalPeakLocator(compute_width=False),
+    )
+
+
+# ----------------- UNIT TESTS -----------------
+
+
+def test_single_rank_runs_every_task_in_order():
+    results = []
+
+    distributed.run_dynamic(
+        SingleRankCommunicator(),
+        number_of_tasks=4,
+        run_task=lambda task_index: task_index ** 2,
+        on_result=lambda task_index, result: results.append((task_index, result)),
+    )
+
+    assert results == [(0, 0), (1, 1), (2, 4), (3, 9)]
+
+
+def test_single_rank_keeps_its_shared_tables(monkeypatch):
+    coupling_cache = object()
+
+    monkeypatch.setenv("FLOWCYPY_FFTW_WISDOM", "wisdom.fftw")
+
+    assert distributed.broadcast_coupling_cache(SingleRankCommunicator(), coupling_cache) is coupling_cache
+    assert distributed.broadcast_fftw_wisdom(SingleRankCommunicator()) == "wisdom.fftw"
+
+
+def test_worker_rank_imports_the_broadcast_wisdom_and_removes_its_file(monkeypatch, tmp_path):
+    imported = []
+
+    def import_fftw_wisdom(filename: str) -> bool:
+        with open(filename, "rb") as file:
+            imported.append(file.read())
+
+        return True
+
+    monkeypatch.setenv("FLOWCYPY_FFTW_WISDOM", "shared.fftw")
+    monkeypatch.setattr(tempfile, "tempdir", str(tmp_path))
+    monkeypatch.setattr(circuits, "import_fftw_wisdom", import_fftw_wisdom)
+
+    assert distributed.broadcast_fftw_wisdom(WorkerRankCommunicator(b"wisdom")) is None
+
+    assert imported == [b"wisdom"]
+    assert list(tmp_path.iterdir()) == []
+    assert "FLOWCYPY_FFTW_WISDOM" not in os.environ
+
+
+def test_single_rank_sweep_matches_a_sweep_without_communicator():
+    # Downstream fields only: every point shares one event set, hence one seeded task.
+    workflow = build_workflow()
+    grid = {"gain": [10 * ureg.volt / ureg.ampere, 20 * ureg.volt / ureg.ampere], "bit_depth": [10, 14]}
+
+    set_random_seed(11)
+    reference = workflow.sweep(run_time=0.2 * ureg.millisecond, grid=grid)
+
+    set_random_seed(11)
+    swept = workflow.sweep(run_time=0.2 * ureg.millisecond, grid=grid, comm=SingleRankCommunicator())
+
+    assert len(swept) == len(reference) == 4
+
+    for (point, record), (reference_point, reference_record) in zip(swept, reference):
+        assert point == reference_point
+        pd.testing.assert_frame_equal(record.event_collection[0].dataframe, reference_record.event_collection[0].dataframe)
+        pd.testing.assert_frame_equal(record.peaks, reference_record.peaks)
+
+
+def test_gathered_profiling_report_is_merged(monkeypatch):
+    report = {
+        "digitizer.process_signal": {
+            "calls": 2, "total_time": 1.0, "min_time": 0.25, "max_time": 0.75,
+            "mean_time": 0.5, "counters": {"samples": 8.0},
+        }
+    }
+
+    monkeypatch.setattr(distributed, "get_profiling_report", lambda: report)
+
+    merged = distributed.gather_profiling_report(SingleRankCommunicator())
+
+    assert merged["digitizer.process_signal"]["calls"] == 2
+    assert merged["digitizer.process_signal"]["mean_time"] == pytest.approx(0.5)
+
+
+if __name__ == "__main__":
+    pytest.main(["-W", "error", __file__])
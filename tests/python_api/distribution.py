@@ -91,5 +91,27 @@ def test_lognormal_properties():
     ), f"LogNormalDistribution: Standard deviation {standard_deviation_size} deviates from expected {expected_std}"
 
 
+def test_seeded_samples_are_reproducible_and_within_cutoffs():
+    """Seeded draws of a truncated distribution repeat exactly and respect the cutoffs."""
+    distribution = dist.Normal(
+        mean=1.0 * ureg.micrometer,
+        standard_deviation=0.5 * ureg.micrometer,
+        low_cutoff=0.8 * ureg.micrometer,
+        high_cutoff=1.5 * ureg.micrometer,
+    )
+
+    dist.set_random_seed(7)
+    first = distribution.sample(10_000)
+    second = distribution.sample(10_000)
+
+    dist.set_random_seed(7)
+    repeated = distribution.sample(10_000)
+
+    assert np.array_equal(first.magnitude, repeated.magnitude)
+    assert not np.array_equal(first.magnitude, second.magnitude)
+    assert np.all(first >= distribution.low_cutoff)
+    assert np.all(first <= distribution.high_cutoff)
+
+
 if __name__ == "__main__":
     pytest.main(["-W error", __file__])
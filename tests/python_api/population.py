@@ -81,5 +81,22 @@ def test_invalid_flow_cell():
         population_0.initialize(invalid_flow_cell)
 
 
+def test_sample_columns_view_one_event_table(populations):
+    """Sampled properties are views of one aligned event table, keyed as before."""
+    samples = populations[0].sample(number_of_samples=1_000)
+
+    assert list(samples.keys()) == ["MediumRefractiveIndex", "RefractiveIndex", "Diameter"]
+
+    bases = {id(quantity.magnitude.base) for quantity in samples.values()}
+    assert len(bases) == 1
+
+    for quantity in samples.values():
+        assert quantity.magnitude.shape == (1_000,)
+        assert quantity.magnitude.ctypes.data % 64 == 0
+
+    assert samples["Diameter"].units == ureg.meter
+    assert samples["MediumRefractiveIndex"].magnitude[0] == pytest.approx(1.33)
+
+
 if __name__ == "__main__":
     pytest.main(["-W error", __file__])
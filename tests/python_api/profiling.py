@@ -0,0 +1,110 @@
+# -*- coding: utf-8 -*-
+
+import json
+import types
+
+import numpy as np
+import pytest
+
+from FlowCyPy import profiling
+from FlowCyPy.opto_electronics import Digitizer
+from FlowCyPy.units import ureg
+
+
+# ----------------- HELPERS -----------------
+
+
+def make_digitizer() -> Digitizer:
+    return Digitizer(
+        sampling_rate=100 * ureg.megahertz,
+        bandwidth=20 * ureg.megahertz,
+        bit_depth=8,
+        min_voltage=-1.0 * ureg.volt,
+        max_voltage=1.0 * ureg.volt,
+        use_auto_range=False,
+    )
+
+
+def make_module(report: dict) -> types.SimpleNamespace:
+    return types.SimpleNamespace(
+        __name__="fake",
+        get_profiling_report=lambda: report,
+    )
+
+
+# ----------------- UNIT TESTS -----------------
+
+
+def test_profile_records_calls_and_samples():
+    digitizer = make_digitizer()
+    signal = np.linspace(-1.0, 1.0, 1000) * ureg.volt
+
+    with profiling.profile() as report:
+        digitizer.process_signal(signal)
+        digitizer.process_signal(signal)
+
+    scope = report["digitizer.process_signal"]
+
+    assert scope["calls"] == 2
+    assert scope["counters"]["samples"] == 2000
+    assert scope["total_time"] >= scope["max_time"] >= scope["min_time"] >= 0.0
+    assert scope["mean_time"] == pytest.approx(scope["total_time"] / 2)
+
+
+def test_profiling_is_disabled_outside_the_block():
+    digitizer = make_digitizer()
+
+    with profiling.profile() as report:
+        pass
+
+    digitizer.process_signal(np.zeros(100) * ureg.volt)
+
+    assert "digitizer.process_signal" not in report
+    assert "digitizer.process_signal" not in profiling.get_profiling_report()
+
+
+def test_reports_of_modules_are_merged(monkeypatch):
+    first = {
+        "source.generate_pulses": {
+            "calls": 1, "total_time": 2.0, "min_time": 2.0, "max_time": 2.0,
+            "counters": {"samples": 10.0, "threads": 4.0},
+        }
+    }
+    second = {
+        "source.generate_pulses": {
+            "calls": 3, "total_time": 3.0, "min_time": 0.5, "max_time": 1.5,
+            "counters": {"samples": 30.0, "threads": 2.0},
+        }
+    }
+
+    monkeypatch.setattr(profiling, "_get_modules", lambda: (make_module(first), make_module(second)))
+
+    scope = profiling.get_profiling_report()["source.generate_pulses"]
+
+    assert scope["calls"] == 4
+    assert scope["total_time"] == pytest.approx(5.0)
+    assert scope["min_time"] == pytest.approx(0.5)
+    assert scope["max_time"] == pytest.approx(2.0)
+    assert scope["mean_time"] == pytest.approx(1.25)
+    assert scope["counters"] == {"samples": 40.0, "threads": 4.0}
+    assert "source.generate_pulses" in profiling.format_profiling_report()
+
+
+def test_write_chrome_trace(tmp_path):
+    digitizer = make_digitizer()
+
+    with profiling.profile(trace=True):
+        digitizer.process_signal(np.zeros(100) * ureg.volt)
+
+    filename = tmp_path / "trace.json"
+    number_of_events = profiling.write_chrome_trace(str(filename))
+
+    events = json.loads(filename.read_text())["traceEvents"]
+
+    assert number_of_events == len(events) >= 1
+    assert all(event["ph"] == "X" and event["dur"] >= 0.0 for event in events)
+    assert "digitizer.process_signal" in {event["name"] for event in events}
+
+
+if __name__ == "__main__":
+    pytest.main(["-W", "error", __file__])
@@ -0,0 +1,116 @@
+# -*- coding: utf-8 -*-
+
+import dataclasses
+
+import numpy as np
+import pytest
+
+from FlowCyPy.stage_cache import StageCache, fingerprint, stage_key
+from FlowCyPy.units import ureg
+
+
+# ----------------- HELPERS -----------------
+
+
+@dataclasses.dataclass
+class Settings:
+    threshold: object
+    channels: list
+
+
+class Component:
+    def __init__(self, gain):
+        self._gain = gain
+
+    @property
+    def gain(self):
+        return self._gain
+
+    @gain.setter
+    def gain(self, value):
+        self._gain = value
+
+    @property
+    def description(self):
+        return object()
+
+
+# ----------------- UNIT TESTS -----------------
+
+
+def test_fingerprint_compares_configuration_by_value():
+    first = Settings(threshold=3 * ureg.millivolt, channels=["A", "B"])
+    second = Settings(threshold=3 * ureg.millivolt, channels=["A", "B"])
+
+    assert first is not second
+    assert fingerprint(first) == fingerprint(second)
+
+    second.threshold = 4 * ureg.millivolt
+    assert fingerprint(first) != fingerprint(second)
+
+    assert fingerprint(3 * ureg.millivolt) != fingerprint(3 * ureg.volt)
+    assert fingerprint(np.arange(4.0)) != fingerprint(np.arange(1.0, 5.0))
+
+
+def test_fingerprint_follows_settable_properties():
+    component = Component(gain=2.0)
+    reference = fingerprint(component)
+
+    component.gain = 3.0
+
+    assert fingerprint(component) != reference
+    assert fingerprint(component) == fingerprint(Component(gain=3.0))
+
+
+def test_fingerprint_excludes_attributes():
+    first = Settings(threshold=1 * ureg.volt, channels=["A"])
+    second = Settings(threshold=2 * ureg.volt, channels=["A"])
+
+    assert fingerprint(first) != fingerprint(second)
+    assert fingerprint(first, exclude=["threshold"]) == fingerprint(second, exclude=["threshold"])
+
+
+def test_fingerprint_handles_cycles():
+    settings = Settings(threshold=None, channels=[])
+    settings.channels.append(settings)
+
+    assert fingerprint(settings) == fingerprint(settings)
+
+
+def test_stage_key_chains_upstream_keys():
+    acquisition_key = stage_key("", 1 * ureg.millisecond)
+    other_acquisition_key = stage_key("", 2 * ureg.millisecond)
+
+    assert stage_key(acquisition_key, "3 sigma") == stage_key(acquisition_key, "3 sigma")
+    assert stage_key(acquisition_key, "3 sigma") != stage_key(acquisition_key, "4 sigma")
+    assert stage_key(acquisition_key, "3 sigma") != stage_key(other_acquisition_key, "3 sigma")
+
+
+def test_stage_cache_reuses_and_evicts_outputs():
+    cache = StageCache(max_entries_per_stage=2)
+    calls = []
+
+    def compute(value):
+        calls.append(value)
+        return value * 10
+
+    assert cache.compute("trigger", "a", lambda: compute(1)) == 10
+    assert cache.compute("trigger", "a", lambda: compute(1)) == 10
+    assert cache.compute("trigger", "b", lambda: compute(2)) == 20
+    assert cache.compute("trigger", "c", lambda: compute(3)) == 30
+    assert cache.compute("trigger", "a", lambda: compute(1)) == 10
+
+    assert calls == [1, 2, 3, 1]
+    assert cache.statistics == {"trigger": {"hits": 1, "misses": 4}}
+    assert len(cache) == 2
+
+    cache.clear()
+    assert len(cache) == 0
+    assert cache.statistics == {}
+
+    with pytest.raises(ValueError):
+        StageCache(max_entries_per_stage=0)
+
+
+if __name__ == "__main__":
+    pytest.main(["-W", "error", __file__])
@@ -0,0 +1,113 @@
+# -*- coding: utf-8 -*-
+
+import os
+import sys
+import threading
+
+import pytest
+
+from FlowCyPy import set_threads
+from FlowCyPy.opto_electronics import source, coupling_cache
+from FlowCyPy.digital_processing import classifier, discriminator, peak_locator
+from FlowCyPy.fluidics import distributions, flow_cell, populations
+
+
+# ----------------- HELPERS -----------------
+
+
+@pytest.fixture
+def default_threads():
+    set_threads()
+    yield
+    set_threads(placement="none")
+
+
+def get_affinity_of_new_thread() -> set:
+    affinity = {}
+    thread = threading.Thread(target=lambda: affinity.update(cpus=os.sched_getaffinity(0)))
+    thread.start()
+    thread.join()
+
+    return affinity["cpus"]
+
+
+# ----------------- UNIT TESTS -----------------
+
+
+def test_loops_shorter_than_two_grains_run_serially(default_threads):
+    set_threads(number_of_threads=4, grain_sizes={"source": 1000})
+
+    assert source.get_grain_size("source") == 1000
+    assert source.get_team_size(0, "source") == 1
+    assert source.get_team_size(1999, "source") == 1
+    assert source.get_team_size(2000, "source") == 2
+    assert source.get_team_size(3999, "source") == 3
+    assert source.get_team_size(1_000_000, "source") == 4
+
+
+def test_zero_grain_size_uses_every_thread(default_threads):
+    set_threads(number_of_threads=3, grain_sizes={"noise": 0})
+
+    assert source.get_team_size(1, "noise") == 3
+
+
+def test_default_grain_sizes_come_back_with_set_threads(default_threads):
+    default = source.get_grain_size("noise")
+
+    set_threads(grain_sizes={"noise": 7})
+    assert source.get_grain_size("noise") == 7
+
+    set_threads()
+    assert source.get_grain_size("noise") == default
+
+
+@pytest.mark.parametrize(
+    "module, component",
+    [
+        (classifier, "classifier"),
+        (discriminator, "discriminator"),
+        (peak_locator, "peak_locator"),
+        (flow_cell, "flow_cell"),
+        (distributions, "flow_cell"),
+        (populations, "flow_cell"),
+        (coupling_cache, "detector"),
+    ],
+)
+def test_settings_reach_every_module_with_parallel_kernels(default_threads, module, component):
+    set_threads(number_of_threads=3, grain_sizes={component: 500})
+
+    assert module.get_number_of_threads() == 3
+    assert module.get_grain_size(component) == 500
+    assert module.get_team_size(1499, component) == 2
+
+
+@pytest.mark.skipif(not sys.platform.startswith("linux"), reason="thread affinity is only set on Linux")
+@pytest.mark.parametrize("placement", ["close", "spread"])
+def test_placement_leaves_the_calling_thread_unpinned(default_threads, placement):
+    process_cpus = os.sched_getaffinity(0)
+
+    set_threads(number_of_threads=2)
+    assert source.pin_threads(placement) == 1
+
+    thread_cpus = source.get_thread_cpus()
+
+    assert set(thread_cpus[0]) == process_cpus
+    assert os.sched_getaffinity(0) == process_cpus
+    assert get_affinity_of_new_thread() == process_cpus
+
+    if len(thread_cpus) > 1:
+        assert len(thread_cpus[1]) == 1
+        assert set(thread_cpus[1]) <= process_cpus
+
+    source.pin_threads("none")
+
+    assert all(set(cpus) == process_cpus for cpus in source.get_thread_cpus())
+
+
+def test_unknown_placement_is_rejected(default_threads):
+    with pytest.raises(ValueError):
+        set_threads(placement="everywhere")
+
+
+if __name__ == "__main__":
+    pytest.main(["-W error", __file__])
@@ -27,6 +27,7 @@ from FlowCyPy.opto_electronics import OptoElectronics
 from FlowCyPy.opto_electronics import circuits
 from FlowCyPy.opto_electronics import source
 from FlowCyPy.run_record import RunRecord
+from FlowCyPy.stage_cache import StageCache
 from FlowCyPy.sub_frames.peaks import PeakDataFrame
 from FlowCyPy.units import ureg
 from tests.python_api.event_collection import make_population_events
@@ -343,6 +344,40 @@ def test_peak_plot_dependencies_are_called_without_rendering(
     assert len(peaks) > 0
 
 
+def test_cached_run_reexecutes_only_changed_stages(flow_cytometer, opto_electronics):
+    cache = StageCache()
+    dynamic_window_discriminator = make_dynamic_window_discriminator()
+
+    digital_processing = DigitalProcessing(
+        discriminator=dynamic_window_discriminator,
+        peak_algorithm=peak_locator.GlobalPeakLocator(),
+    )
+
+    def run():
+        return flow_cytometer.run(
+            run_time=0.05 * ureg.millisecond,
+            opto_electronics=opto_electronics,
+            digital_processing=digital_processing,
+            cache=cache,
+        )
+
+    first_record = run()
+    second_record = run()
+
+    assert second_record.signal.analog is first_record.signal.analog
+    assert second_record.peaks is first_record.peaks
+    assert cache.statistics["acquisition"] == {"hits": 1, "misses": 1}
+    assert cache.statistics["peaks"] == {"hits": 1, "misses": 1}
+
+    dynamic_window_discriminator.threshold = "5 sigma"
+    third_record = run()
+
+    assert third_record.signal.analog is first_record.signal.analog
+    assert cache.statistics["acquisition"] == {"hits": 2, "misses": 1}
+    assert cache.statistics["analog_processing"] == {"hits": 2, "misses": 1}
+    assert cache.statistics["trigger"] == {"hits": 1, "misses": 2}
+
+
 def test_run_record_plot_peak_hist_returns_figure():
     run_record = make_run_record_with_peaks()
 
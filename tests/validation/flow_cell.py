@@ -100,6 +100,18 @@ def test_compute_channel_flow(valid_flowcell):
     assert Q > 0
 
 
+def test_tabulated_velocity_matches_centerline(valid_flowcell):
+    dpdx_ref = valid_flowcell._cpp_dpdx_ref
+    dpdx = dpdx_ref * valid_flowcell._cpp_Q_total / valid_flowcell._cpp_compute_channel_flow(dpdx_ref)
+    u_center = valid_flowcell._cpp_u_center
+
+    velocity = valid_flowcell._cpp_get_velocity(y=0.0, z=0.0, dpdx_local=dpdx)
+    wall_velocity = valid_flowcell._cpp_get_velocity(y=5e-6, z=0.0, dpdx_local=dpdx)
+
+    assert velocity == pytest.approx(u_center, rel=1e-5)
+    assert abs(wall_velocity) < 1e-6 * u_center
+
+
 def test_sample_particles(valid_flowcell):
     n_samples = 1000
     x, y, velocity = valid_flowcell.sample_transverse_profile(n_samples)
@@ -112,6 +124,30 @@ def test_sample_particles(valid_flowcell):
     assert np.all(np.isfinite(velocity))
 
 
+def test_seeded_arrival_times_are_sorted_and_reproducible(valid_flowcell):
+    run_time = 1 * ureg.millisecond
+
+    FlowCyPy.set_random_seed(11)
+    first = valid_flowcell.sample_arrival_times(n_events=10_000, run_time=run_time)
+
+    FlowCyPy.set_random_seed(11)
+    repeated = valid_flowcell.sample_arrival_times(n_events=10_000, run_time=run_time)
+
+    assert len(first) == 10_000
+    assert np.array_equal(first.magnitude, repeated.magnitude)
+    assert np.all(np.diff(first.magnitude) >= 0)
+    assert np.all((first >= 0 * ureg.second) & (first <= run_time))
+
+
+def test_velocity_weighted_positions_stay_in_sample_core(valid_flowcell):
+    x, y, velocity = valid_flowcell.sample_transverse_profile(10_000)
+
+    assert np.all(np.abs(x) <= valid_flowcell.sample.width / 2)
+    assert np.all(np.abs(y) <= valid_flowcell.sample.height / 2)
+    assert np.all(velocity > 0 * velocity.units)
+    assert np.all(velocity <= valid_flowcell.sample.max_flow_speed * (1 + 1e-6))
+
+
 def test_get_sample_volume(valid_flowcell):
     run_time = 10 * ureg.second
     volume = valid_flowcell.get_sample_volume(run_time)
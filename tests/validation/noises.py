@@ -96,6 +96,54 @@ def test_shot_noise(digitizer):
     validate_noise(current_amp, expected_std)
 
 
+@pytest.mark.parametrize("mean_photons", [0.5, 3.0, 30.0])
+def test_low_count_shot_noise_is_poissonian(mean_photons):
+    """
+    In the low count regime the photon count per sample is Poisson distributed.
+    """
+    source = Gaussian(
+        wavelength=1550 * ureg.nanometer,
+        optical_power=1 * ureg.milliwatt,
+        waist_y=1e-6 * ureg.meter,
+        waist_z=1e-6 * ureg.meter,
+        rin=-120.0 * ureg.dB_per_Hz,
+        polarization=0.0 * ureg.radian,
+        include_shot_noise=True,
+        include_rin_noise=False,
+    )
+
+    time_step = 1e-6 * ureg.second
+    watt_to_photon = (time_step / source.photon_energy).to("1 / watt").magnitude
+
+    number_of_samples = 200_000
+    power_signal = np.full(number_of_samples, mean_photons / watt_to_photon) * ureg.watt
+    time_array = np.arange(number_of_samples) * time_step
+
+    noisy_power = source.add_shot_noise_to_signal(power_signal, time_array)
+    photon_counts = noisy_power.to("watt").magnitude * watt_to_photon
+
+    assert np.allclose(photon_counts, np.round(photon_counts), atol=1e-6)
+    assert np.mean(photon_counts) == pytest.approx(mean_photons, rel=0.02)
+    assert np.var(photon_counts) == pytest.approx(mean_photons, rel=0.03)
+
+
+def test_shot_noise_rejects_negative_power():
+    source = Gaussian(
+        wavelength=1550 * ureg.nanometer,
+        optical_power=1 * ureg.milliwatt,
+        waist_y=1e-6 * ureg.meter,
+        waist_z=1e-6 * ureg.meter,
+        rin=-120.0 * ureg.dB_per_Hz,
+        polarization=0.0 * ureg.radian,
+    )
+
+    power_signal = np.array([1e-6, 1e-6, -1e-6, 1e-6]) * ureg.watt
+    time_array = np.arange(4) * 1e-6 * ureg.second
+
+    with pytest.raises(RuntimeError, match="index=2"):
+        source.add_shot_noise_to_signal(power_signal, time_array)
+
+
 def test_dark_current_noise(digitizer):
     """
     Dark current noise is applied by the detector on a current signal.